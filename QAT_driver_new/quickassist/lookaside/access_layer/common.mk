@@ -68,6 +68,15 @@ ifeq ($(DISABLE_STATS), 1)
 EXTRA_CFLAGS += -DDISABLE_STATS
 endif
 
+# The Compression and Symmetric Crypto stats can be compiled out on their own
+ifeq ($(DISABLE_DC_STATS), 1)
+EXTRA_CFLAGS += -DDISABLE_DC_STATS
+endif
+
+ifeq ($(DISABLE_SYM_STATS), 1)
+EXTRA_CFLAGS += -DDISABLE_SYM_STATS
+endif
+
 # Disable NUMA allocation thorough OSAL
 EXTRA_CFLAGS += -DDISABLE_NUMA_ALLOCATION
 
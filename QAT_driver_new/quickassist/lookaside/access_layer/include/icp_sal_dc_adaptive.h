@@ -0,0 +1,246 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ ***************************************************************************
+ * @file icp_sal_dc_adaptive.h
+ *
+ * @defgroup SalDcAdaptive
+ *
+ * @ingroup SalDcAdaptive
+ *
+ * @description
+ *    Adaptive compression level APIs.
+ *    An adaptive compressor keeps one stateless compression session per
+ *    compression level, all initialised up front, and routes every request
+ *    to one of them. The level is lowered when the requests queue up on
+ *    the instance or the offered throughput exceeds a target, and raised
+ *    again once the load drops, provided the higher level achieved a
+ *    better compression ratio on the recent requests. Switching level does
+ *    not touch the device, so the ratio is traded for throughput within a
+ *    request of a load spike.
+ *
+ ***************************************************************************/
+
+#ifndef ICP_SAL_DC_ADAPTIVE_H
+#define ICP_SAL_DC_ADAPTIVE_H
+
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/**
+ * Maximum number of compression levels of an adaptive compressor.
+ */
+#define ICP_SAL_DC_ADAPTIVE_MAX_LEVELS (4)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Adaptive compressor handle.
+ *
+ * @description
+ *      Opaque handle returned by icp_sal_DcAdaptiveCreate().
+ *
+ *****************************************************************************/
+typedef void *icp_sal_dc_adaptive_handle_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Adaptive compressor setup data.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_adaptive_setup_s
+{
+    CpaDcSessionSetupData sessionSetupData;
+    /**< Template of the sessions. It must describe a stateless compression
+     * session, its compLevel is ignored */
+    CpaDcCompLvl levels[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    /**< Compression levels, from the fastest to the highest ratio */
+    Cpa32U numLevels;
+    /**< Number of entries of levels, between 1 and
+     * ICP_SAL_DC_ADAPTIVE_MAX_LEVELS */
+    Cpa32U highWatermark;
+    /**< Number of requests in flight from which the next faster level is
+     * selected */
+    Cpa32U lowWatermark;
+    /**< Number of requests in flight up to which the next higher level may
+     * be selected, lower than highWatermark */
+    Cpa64U targetBytesPerSec;
+    /**< Offered input throughput from which the next faster level is
+     * selected. Zero disables the throughput check */
+    Cpa32U minGainPercent;
+    /**< Output size reduction, in percent, a level must achieve over the
+     * next faster one to be selected again once the load drops */
+    CpaDcCallbackFn callbackFn;
+    /**< Completion callback of the requests, NULL for synchronous
+     * operation */
+} icp_sal_dc_adaptive_setup_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Adaptive compressor statistics.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_adaptive_stats_s
+{
+    Cpa32U numLevels;
+    /**< Number of valid entries in the arrays below */
+    CpaDcCompLvl levels[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    /**< Compression levels, as in the setup data */
+    Cpa64U numRequests[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    /**< Requests submitted at each level */
+    Cpa32U ratioPercent[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    /**< Average output size in percent of the input size at each level,
+     * zero until enough requests have completed */
+    Cpa32U currentLevel;
+    /**< Index of the level the next request is submitted at */
+    Cpa64U bytesPerSec;
+    /**< Last measured offered input throughput */
+} icp_sal_dc_adaptive_stats_t;
+
+/*************************************************************************
+ * @ingroup SalDcAdaptive
+ * @description
+ *    Create an adaptive compressor on a started compression instance.
+ *    One session is initialised per level, starting from the fastest.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  dcInstance        Compression instance handle.
+ * @param[in]  pSetupData        Adaptive compressor setup data.
+ * @param[out] pAdaptiveHandle   Handle of the created compressor.
+ *
+ * @retval CPA_STATUS_SUCCESS         Compressor created
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RESOURCE        Memory allocation failed
+ * @retval CPA_STATUS_FAIL            A session could not be initialised
+ *************************************************************************/
+CpaStatus icp_sal_DcAdaptiveCreate(
+    CpaInstanceHandle dcInstance,
+    const icp_sal_dc_adaptive_setup_t *pSetupData,
+    icp_sal_dc_adaptive_handle_t *pAdaptiveHandle);
+
+/*************************************************************************
+ * @ingroup SalDcAdaptive
+ * @description
+ *    Compress data at the level selected for the current load. The
+ *    parameters and the completion are those of cpaDcCompressData2().
+ *    Requests go to different sessions, so every request must be
+ *    complete: pOpData->flushFlag must be CPA_DC_FLUSH_FINAL.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]     adaptiveHandle   Adaptive compressor handle.
+ * @param[in]     pSrcBuff         Source buffer list.
+ * @param[out]    pDestBuff        Destination buffer list.
+ * @param[in]     pOpData          Request options.
+ * @param[in,out] pResults         Results of the request.
+ * @param[in]     callbackTag      Opaque value passed to the callback.
+ *
+ * @retval CPA_STATUS_SUCCESS         Request submitted or completed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY           Resubmit the request
+ * @retval CPA_STATUS_FAIL            Function failed
+ *************************************************************************/
+CpaStatus icp_sal_DcAdaptiveCompressData2(
+    icp_sal_dc_adaptive_handle_t adaptiveHandle,
+    CpaBufferList *pSrcBuff,
+    CpaBufferList *pDestBuff,
+    CpaDcOpData *pOpData,
+    CpaDcRqResults *pResults,
+    void *callbackTag);
+
+/*************************************************************************
+ * @ingroup SalDcAdaptive
+ * @description
+ *    Get the statistics of an adaptive compressor.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  adaptiveHandle    Adaptive compressor handle.
+ * @param[out] pStats            Statistics.
+ *
+ * @retval CPA_STATUS_SUCCESS         Statistics returned
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ *************************************************************************/
+CpaStatus icp_sal_DcAdaptiveGetStats(
+    icp_sal_dc_adaptive_handle_t adaptiveHandle,
+    icp_sal_dc_adaptive_stats_t *pStats);
+
+/*************************************************************************
+ * @ingroup SalDcAdaptive
+ * @description
+ *    Destroy an adaptive compressor. Its sessions are removed and all
+ *    memory owned by it is released. If a session cannot be removed, the
+ *    error is returned and the compressor is kept so that the call can be
+ *    repeated.
+ *
+ * @assumptions
+ *      No request is outstanding on the compressor.
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] adaptiveHandle     Adaptive compressor handle.
+ *
+ * @retval CPA_STATUS_SUCCESS         Compressor destroyed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY           Requests are still outstanding
+ * @retval CPA_STATUS_FAIL            A session could not be removed
+ *************************************************************************/
+CpaStatus icp_sal_DcAdaptiveDestroy(
+    icp_sal_dc_adaptive_handle_t adaptiveHandle);
+
+#endif /* ICP_SAL_DC_ADAPTIVE_H */
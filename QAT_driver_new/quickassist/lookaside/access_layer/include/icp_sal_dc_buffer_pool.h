@@ -0,0 +1,239 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ ***************************************************************************
+ * @file icp_sal_dc_buffer_pool.h
+ *
+ * @defgroup SalDcBufferPool
+ *
+ * @ingroup SalDcBufferPool
+ *
+ * @description
+ *    Pools of pre-registered pinned buffers for compression requests.
+ *    All the buffers of a pool are allocated when the pool is created,
+ *    together with a single buffer list and the meta data it needs, and
+ *    the physical address of every buffer is looked up once. Acquiring
+ *    and releasing a buffer then costs no allocation and no address
+ *    translation.
+ *
+ *    Buffers are reference counted. A buffer holding source data can be
+ *    passed to several requests in flight at once, every request holding
+ *    its own reference, and goes back to the pool when the last reference
+ *    is released. Free buffers are kept in per-thread shards of the pool,
+ *    so threads acquiring and releasing buffers do not contend with each
+ *    other.
+ *
+ ***************************************************************************/
+
+#ifndef ICP_SAL_DC_BUFFER_POOL_H
+#define ICP_SAL_DC_BUFFER_POOL_H
+
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Buffer pool handle.
+ *
+ *****************************************************************************/
+typedef void *icp_sal_dc_buffer_pool_handle_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Buffer of a pool.
+ *
+ * @description
+ *      The fields are owned by the pool and must not be changed, except
+ *      for the length of the flat buffer of pBufferList, which is reset to
+ *      bufferSize every time the buffer is acquired. The buffer list must
+ *      not be changed while requests using it are in flight.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_buffer_s
+{
+    CpaBufferList *pBufferList;
+    /**< Buffer list made of one flat buffer describing pData, with its
+     * meta data allocated */
+    Cpa8U *pData;
+    /**< Pinned, physically contiguous data of the buffer */
+    CpaPhysicalAddr dataPhysAddr;
+    /**< Physical address of pData, for the data plane API */
+    Cpa32U bufferSize;
+    /**< Size of pData in bytes */
+} icp_sal_dc_buffer_t;
+
+/*************************************************************************
+ * @ingroup SalDcBufferPool
+ * @description
+ *    Create a pool of pinned buffers. The buffers and their meta data are
+ *    allocated on the node of the instance.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  dcInstance        Compression instance the buffers are used
+ *                               with, or CPA_INSTANCE_HANDLE_SINGLE.
+ * @param[in]  bufferSize        Size of every buffer in bytes.
+ * @param[in]  numBuffers        Number of buffers of the pool.
+ * @param[out] pPoolHandle       Handle of the created pool.
+ *
+ * @retval CPA_STATUS_SUCCESS         Pool created
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RESOURCE        Memory allocation failed
+ * @retval CPA_STATUS_RESTARTING      API implementation is restarting
+ *************************************************************************/
+CpaStatus icp_sal_DcBufferPoolCreate(
+    CpaInstanceHandle dcInstance,
+    Cpa32U bufferSize,
+    Cpa32U numBuffers,
+    icp_sal_dc_buffer_pool_handle_t *pPoolHandle);
+
+/*************************************************************************
+ * @ingroup SalDcBufferPool
+ * @description
+ *    Destroy a pool and free its buffers. Every buffer must have been
+ *    released.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      No other thread uses the pool.
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in]  poolHandle        Handle of the pool.
+ *
+ * @retval CPA_STATUS_SUCCESS         Pool destroyed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY           Buffers of the pool are still held,
+ *                                    the pool is left unchanged
+ *************************************************************************/
+CpaStatus icp_sal_DcBufferPoolDestroy(
+    icp_sal_dc_buffer_pool_handle_t poolHandle);
+
+/*************************************************************************
+ * @ingroup SalDcBufferPool
+ * @description
+ *    Acquire a buffer from a pool, holding one reference on it.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  poolHandle        Handle of the pool.
+ * @param[out] ppBuffer          Acquired buffer.
+ *
+ * @retval CPA_STATUS_SUCCESS         Buffer acquired
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY           All the buffers of the pool are held
+ *************************************************************************/
+CpaStatus icp_sal_DcBufferAcquire(icp_sal_dc_buffer_pool_handle_t poolHandle,
+                                  icp_sal_dc_buffer_t **ppBuffer);
+
+/*************************************************************************
+ * @ingroup SalDcBufferPool
+ * @description
+ *    Take one more reference on an acquired buffer, typically before
+ *    passing it to another request.
+ *
+ * @context
+ *      This function may be called from a completion callback.
+ * @assumptions
+ *      The caller holds a reference on the buffer.
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      Yes
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  pBuffer           Buffer.
+ *
+ * @retval CPA_STATUS_SUCCESS         Reference taken
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            The buffer holds no reference
+ *************************************************************************/
+CpaStatus icp_sal_DcBufferRetain(icp_sal_dc_buffer_t *pBuffer);
+
+/*************************************************************************
+ * @ingroup SalDcBufferPool
+ * @description
+ *    Release one reference on a buffer. The buffer goes back to its pool
+ *    when the last reference is released.
+ *
+ * @context
+ *      This function may be called from a completion callback.
+ * @assumptions
+ *      The caller holds a reference on the buffer.
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  pBuffer           Buffer.
+ *
+ * @retval CPA_STATUS_SUCCESS         Reference released
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            The buffer holds no reference
+ *************************************************************************/
+CpaStatus icp_sal_DcBufferRelease(icp_sal_dc_buffer_t *pBuffer);
+
+#endif /* ICP_SAL_DC_BUFFER_POOL_H */
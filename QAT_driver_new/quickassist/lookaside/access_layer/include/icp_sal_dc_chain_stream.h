@@ -0,0 +1,284 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ ***************************************************************************
+ * @file icp_sal_dc_chain_stream.h
+ *
+ * @defgroup SalDcChainStream
+ *
+ * @ingroup SalDcChainStream
+ *
+ * @description
+ *    Streaming compress-then-encrypt APIs.
+ *    A chain stream accepts writes of arbitrary size, cuts them into
+ *    chunks and submits every chunk as one CPA_DC_CHAIN_COMPRESS_THEN_AEAD
+ *    request, so each chunk is deflate compressed and AES-GCM encrypted
+ *    in a single pass through the device. Several chunks are kept in
+ *    flight and the resulting records are handed to the caller in
+ *    submission order. The buffer lists, IV and AAD buffers of the
+ *    requests are owned by the stream and reused for every chunk.
+ *
+ *    Each chunk produces one record:
+ *      - payloadLen, 4 bytes big endian: size of the ciphertext and tag
+ *      - plainLen, 4 bytes big endian: size of the chunk before
+ *        compression
+ *      - flags, 4 bytes big endian: ICP_SAL_DC_CHAIN_STREAM_RECORD_LAST
+ *        on the last record of the stream
+ *      - ciphertext of the raw deflate data of the chunk, complete with a
+ *        final block
+ *      - GCM tag, ICP_SAL_DC_CHAIN_STREAM_TAG_SIZE bytes
+ *
+ *    The GCM nonce of record n (counting from 0) is the IV of the setup
+ *    data with its last 8 bytes XORed with n in big endian. The
+ *    additional authenticated data of the record is n as 8 bytes big
+ *    endian followed by plainLen and flags, so that reordered, replayed
+ *    or truncated records fail authentication. An empty stream produces
+ *    a single record with a plainLen of zero, holding an empty final
+ *    deflate block and flagged as the last record.
+ *
+ ***************************************************************************/
+
+#ifndef ICP_SAL_DC_CHAIN_STREAM_H
+#define ICP_SAL_DC_CHAIN_STREAM_H
+
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/**
+ * Chunk size used when icp_sal_dc_chain_stream_setup_t.chunkSize is zero.
+ */
+#define ICP_SAL_DC_CHAIN_STREAM_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Maximum number of chunks a chain stream can keep in flight.
+ */
+#define ICP_SAL_DC_CHAIN_STREAM_MAX_IN_FLIGHT (64)
+
+/**
+ * Size of the GCM nonce passed in the setup data.
+ */
+#define ICP_SAL_DC_CHAIN_STREAM_IV_SIZE (12)
+
+/**
+ * Size of the GCM tag ending every record.
+ */
+#define ICP_SAL_DC_CHAIN_STREAM_TAG_SIZE (16)
+
+/**
+ * Size of the header starting every record.
+ */
+#define ICP_SAL_DC_CHAIN_STREAM_RECORD_HDR_SIZE (12)
+
+/**
+ * Record flag set on the last record of a stream.
+ */
+#define ICP_SAL_DC_CHAIN_STREAM_RECORD_LAST (0x1)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Chain stream handle.
+ *
+ * @description
+ *      Opaque handle returned by icp_sal_DcChainStreamCreate().
+ *
+ *****************************************************************************/
+typedef void *icp_sal_dc_chain_stream_handle_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Chain stream output function.
+ *
+ * @description
+ *      Called by the stream for every piece of a record that is ready, in
+ *      stream order. pData points into memory owned by the stream and is
+ *      only valid until the function returns. Returning anything other
+ *      than CPA_STATUS_SUCCESS aborts the stream.
+ *
+ * @param[in] pOutputTag     Opaque value from the stream setup data.
+ * @param[in] pData          Record data.
+ * @param[in] dataLen        Number of bytes at pData.
+ *
+ *****************************************************************************/
+typedef CpaStatus (*icp_sal_dc_chain_stream_output_fn_t)(void *pOutputTag,
+                                                         const Cpa8U *pData,
+                                                         Cpa32U dataLen);
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Chain stream setup data.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_chain_stream_setup_s
+{
+    CpaDcCompLvl compLevel;
+    /**< Compression level */
+    CpaDcHuffType huffType;
+    /**< Huffman type */
+    const Cpa8U *pCipherKey;
+    /**< AES key, copied into the stream session */
+    Cpa32U cipherKeyLenInBytes;
+    /**< 16, 24 or 32 */
+    Cpa8U iv[ICP_SAL_DC_CHAIN_STREAM_IV_SIZE];
+    /**< Base GCM nonce of the stream. It must never be reused with the
+     * same key */
+    Cpa32U chunkSize;
+    /**< Number of input bytes per record. Zero selects
+     * ICP_SAL_DC_CHAIN_STREAM_DEFAULT_CHUNK_SIZE */
+    Cpa32U numInFlight;
+    /**< Maximum number of requests in flight, between 1 and
+     * ICP_SAL_DC_CHAIN_STREAM_MAX_IN_FLIGHT */
+    icp_sal_dc_chain_stream_output_fn_t pOutputFn;
+    /**< Function receiving the records */
+    void *pOutputTag;
+    /**< Opaque value passed to pOutputFn */
+} icp_sal_dc_chain_stream_setup_t;
+
+/*************************************************************************
+ * @ingroup SalDcChainStream
+ * @description
+ *    Create a compress-then-encrypt stream on a started compression
+ *    instance supporting CPA_DC_CHAIN_COMPRESS_THEN_AEAD. The stream owns
+ *    a chaining session on the instance and all the pinned buffers it
+ *    needs, sized from the setup data.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      The instance is polled, either by the caller or by the stream itself
+ *      while it waits for completions.
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  dcInstance        Compression instance handle.
+ * @param[in]  pSetupData        Stream setup data.
+ * @param[out] pStreamHandle     Handle of the created stream.
+ *
+ * @retval CPA_STATUS_SUCCESS         Stream created
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_UNSUPPORTED     Chaining is not supported by the
+ *                                    instance
+ * @retval CPA_STATUS_RESOURCE        Memory allocation failed
+ * @retval CPA_STATUS_FAIL            Session could not be initialised
+ *************************************************************************/
+CpaStatus icp_sal_DcChainStreamCreate(
+    CpaInstanceHandle dcInstance,
+    const icp_sal_dc_chain_stream_setup_t *pSetupData,
+    icp_sal_dc_chain_stream_handle_t *pStreamHandle);
+
+/*************************************************************************
+ * @ingroup SalDcChainStream
+ * @description
+ *    Append data to the stream. The data is copied into the stream's
+ *    pinned input chunks and may be reused as soon as the function
+ *    returns. Full chunks are submitted to the instance; the function
+ *    only blocks when all in-flight slots are busy.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] streamHandle       Stream handle.
+ * @param[in] pData              Data to compress and encrypt.
+ * @param[in] dataLen            Number of bytes at pData.
+ *
+ * @retval CPA_STATUS_SUCCESS         Data accepted
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            The stream has failed or is finished
+ *************************************************************************/
+CpaStatus icp_sal_DcChainStreamWrite(
+    icp_sal_dc_chain_stream_handle_t streamHandle,
+    const Cpa8U *pData,
+    Cpa32U dataLen);
+
+/*************************************************************************
+ * @ingroup SalDcChainStream
+ * @description
+ *    Complete the stream. Submits the remaining input as the last record
+ *    and waits for every outstanding request. No further writes are
+ *    accepted afterwards.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in]  streamHandle      Stream handle.
+ * @param[out] pConsumed         Optional, total number of input bytes.
+ * @param[out] pProduced         Optional, total size of the records.
+ *
+ * @retval CPA_STATUS_SUCCESS         Stream completed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            The stream has failed or is finished
+ *************************************************************************/
+CpaStatus icp_sal_DcChainStreamFinish(
+    icp_sal_dc_chain_stream_handle_t streamHandle,
+    Cpa64U *pConsumed,
+    Cpa64U *pProduced);
+
+/*************************************************************************
+ * @ingroup SalDcChainStream
+ * @description
+ *    Destroy a stream. Outstanding requests are waited for, the session is
+ *    removed and all memory owned by the stream is released.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] streamHandle       Stream handle.
+ *
+ * @retval CPA_STATUS_SUCCESS         Stream destroyed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY           The session could not be removed yet,
+ *                                    the stream is left intact
+ * @retval CPA_STATUS_FAIL            The session could not be removed, the
+ *                                    stream is left intact
+ *************************************************************************/
+CpaStatus icp_sal_DcChainStreamDestroy(
+    icp_sal_dc_chain_stream_handle_t streamHandle);
+
+#endif /* ICP_SAL_DC_CHAIN_STREAM_H */
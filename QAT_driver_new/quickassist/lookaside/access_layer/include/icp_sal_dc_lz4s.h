@@ -0,0 +1,186 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ ***************************************************************************
+ * @file icp_sal_dc_lz4s.h
+ *
+ * @defgroup SalDcLZ4S
+ *
+ * @ingroup SalDcLZ4S
+ *
+ * @description
+ *    LZ4s post-processing APIs.
+ *    LZ4s is the sequence format produced by CPA_DC_LZ4S sessions: LZ4
+ *    sequences without the end of block restrictions of the LZ4 block
+ *    format, with a minimum match length of three bytes. These functions
+ *    turn the LZ4s output of one request into a standard LZ4 block or into
+ *    a list of match sequences which can be entropy coded in software, for
+ *    example with ZSTD_compressSequences(). They only read their inputs and
+ *    may run concurrently on any number of worker threads while the device
+ *    compresses the following requests.
+ *
+ *    icp_sal_DcStreamCreate() uses icp_sal_DcLZ4SToLZ4Block() to produce
+ *    LZ4 frames from CPA_DC_LZ4S sessions, running it on the worker
+ *    threads of the library.
+ *
+ ***************************************************************************/
+
+#ifndef ICP_SAL_DC_LZ4S_H
+#define ICP_SAL_DC_LZ4S_H
+
+#include "cpa.h"
+
+/**
+ * Worst case size of an LZ4 block holding srcLen bytes of input.
+ */
+#define ICP_SAL_DC_LZ4_BLOCK_BOUND(srcLen)                                     \
+    ((srcLen) + ((srcLen) / 255) + 16)
+
+/**
+ * Maximum number of sequences produced from srcLen bytes of input,
+ * including the block delimiter.
+ */
+#define ICP_SAL_DC_LZ4S_MAX_SEQUENCES(srcLen) (((srcLen) / 3) + 1)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcLZ4S
+ *      Match sequence.
+ *
+ * @description
+ *      litLength literals followed by a match of matchLength bytes at
+ *      distance offset. The layout is that of ZSTD_Sequence so that an
+ *      array of sequences can be passed to the zstd sequence API with
+ *      explicit block delimiters. The last sequence is the block delimiter:
+ *      offset and matchLength are zero and litLength holds the trailing
+ *      literals.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_sequence_s
+{
+    Cpa32U offset;
+    /**< Match distance in bytes, zero for the block delimiter */
+    Cpa32U litLength;
+    /**< Number of literals preceding the match */
+    Cpa32U matchLength;
+    /**< Match length in bytes, zero for the block delimiter */
+    Cpa32U rep;
+    /**< Repeat offset code, always zero */
+} icp_sal_dc_sequence_t;
+
+/*************************************************************************
+ * @ingroup SalDcLZ4S
+ * @description
+ *    Convert the LZ4s output of a request into an LZ4 block.
+ *    Literals are copied from the uncompressed input, so pSrc must hold
+ *    the data the request consumed. Matches which are shorter than four
+ *    bytes or which violate the LZ4 end of block rules are stored as
+ *    literals. The block does not include the LZ4 frame block size field.
+ *
+ * @context
+ *      This function does not sleep and may be called from any context.
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      Yes
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  pSrc              Uncompressed input of the request.
+ * @param[in]  srcLen            Number of bytes the request consumed.
+ * @param[in]  pLZ4S             LZ4s output of the request.
+ * @param[in]  lz4sLen           Number of bytes the request produced.
+ * @param[out] pDst              LZ4 block. A buffer of
+ *                               ICP_SAL_DC_LZ4_BLOCK_BOUND(srcLen) bytes
+ *                               is always large enough.
+ * @param[in]  dstLen            Size of pDst in bytes.
+ * @param[out] pProduced         Size of the LZ4 block.
+ *
+ * @retval CPA_STATUS_SUCCESS         Block produced
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            Malformed LZ4s data or pDst too small
+ *************************************************************************/
+CpaStatus icp_sal_DcLZ4SToLZ4Block(const Cpa8U *pSrc,
+                                   Cpa32U srcLen,
+                                   const Cpa8U *pLZ4S,
+                                   Cpa32U lz4sLen,
+                                   Cpa8U *pDst,
+                                   Cpa32U dstLen,
+                                   Cpa32U *pProduced);
+
+/*************************************************************************
+ * @ingroup SalDcLZ4S
+ * @description
+ *    Convert the LZ4s output of a request into match sequences, terminated
+ *    by a block delimiter. Literal-only LZ4s sequences are merged into the
+ *    literals of the following match.
+ *
+ * @context
+ *      This function does not sleep and may be called from any context.
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      Yes
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  pLZ4S             LZ4s output of the request.
+ * @param[in]  lz4sLen           Number of bytes the request produced.
+ * @param[in]  srcLen            Number of bytes the request consumed.
+ * @param[out] pSeqs             Sequences. An array of
+ *                               ICP_SAL_DC_LZ4S_MAX_SEQUENCES(srcLen)
+ *                               entries is always large enough.
+ * @param[in]  maxSeqs           Number of entries at pSeqs.
+ * @param[out] pNumSeqs          Number of sequences produced.
+ *
+ * @retval CPA_STATUS_SUCCESS         Sequences produced
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            Malformed LZ4s data or pSeqs too small
+ *************************************************************************/
+CpaStatus icp_sal_DcLZ4SToSequences(const Cpa8U *pLZ4S,
+                                    Cpa32U lz4sLen,
+                                    Cpa32U srcLen,
+                                    icp_sal_dc_sequence_t *pSeqs,
+                                    Cpa32U maxSeqs,
+                                    Cpa32U *pNumSeqs);
+
+#endif /* ICP_SAL_DC_LZ4S_H */
@@ -0,0 +1,167 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ ***************************************************************************
+ * @file icp_sal_dc_par_decomp.h
+ *
+ * @defgroup SalDcParDecomp
+ *
+ * @ingroup SalDcParDecomp
+ *
+ * @description
+ *    Parallel decompression of multi-member gzip data.
+ *    The members of a gzip file are independent deflate streams, so they
+ *    can be decompressed concurrently. The input is scanned for member
+ *    headers and every member is submitted as one stateless request,
+ *    spread over several instances and several requests in flight per
+ *    instance. The output is handed to the caller in member order.
+ *
+ *    The member boundaries are found by looking for gzip headers in the
+ *    compressed data, which can occasionally match inside a member. Such a
+ *    false boundary is detected when the request ending at it looks
+ *    truncated, i.e. it does not end exactly with the final deflate block
+ *    and the member trailer; the two pieces are then merged and
+ *    decompressed again. A decode error fails the call without merging.
+ *
+ ***************************************************************************/
+
+#ifndef ICP_SAL_DC_PAR_DECOMP_H
+#define ICP_SAL_DC_PAR_DECOMP_H
+
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/**
+ * Maximum number of instances used by a parallel decompression.
+ */
+#define ICP_SAL_DC_PAR_MAX_INSTANCES (16)
+
+/**
+ * Maximum number of requests in flight per instance.
+ */
+#define ICP_SAL_DC_PAR_MAX_IN_FLIGHT (16)
+
+/**
+ * Largest member output used when
+ * icp_sal_dc_par_decomp_setup_t.maxMemberSize is zero.
+ */
+#define ICP_SAL_DC_PAR_DEFAULT_MAX_MEMBER_SIZE (64 * 1024 * 1024)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Parallel decompression output function.
+ *
+ * @description
+ *      Called with the decompressed data of every member, in member order.
+ *      pData points into memory owned by the decompressor and is only valid
+ *      until the function returns. Returning anything other than
+ *      CPA_STATUS_SUCCESS aborts the decompression.
+ *
+ * @param[in] pOutputTag     Opaque value from the setup data.
+ * @param[in] pData          Decompressed data.
+ * @param[in] dataLen        Number of bytes at pData.
+ *
+ *****************************************************************************/
+typedef CpaStatus (*icp_sal_dc_par_output_fn_t)(void *pOutputTag,
+                                                const Cpa8U *pData,
+                                                Cpa32U dataLen);
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Parallel decompression setup data.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_par_decomp_setup_s
+{
+    const CpaInstanceHandle *pInstances;
+    /**< Started compression instances the members are spread over */
+    Cpa32U numInstances;
+    /**< Number of entries of pInstances, between 1 and
+     * ICP_SAL_DC_PAR_MAX_INSTANCES */
+    Cpa32U numInFlight;
+    /**< Requests kept in flight per instance, between 1 and
+     * ICP_SAL_DC_PAR_MAX_IN_FLIGHT */
+    Cpa32U maxMemberSize;
+    /**< Largest decompressed size of a member. Zero selects
+     * ICP_SAL_DC_PAR_DEFAULT_MAX_MEMBER_SIZE */
+    icp_sal_dc_par_output_fn_t pOutputFn;
+    /**< Function receiving the decompressed data */
+    void *pOutputTag;
+    /**< Opaque value passed to pOutputFn */
+} icp_sal_dc_par_decomp_setup_t;
+
+/*************************************************************************
+ * @ingroup SalDcParDecomp
+ * @description
+ *    Decompress gzip data made of one or more members. The CRC-32 and the
+ *    size recorded in the trailer of every member are checked. Pinned
+ *    buffers are allocated for the requests in flight, sized from the
+ *    largest member seen, and released before the function returns.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      The instances are not polled by other threads while the function
+ *      runs, it polls them itself.
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  pSetupData        Setup data.
+ * @param[in]  pSrc              Gzip data.
+ * @param[in]  srcLen            Number of bytes at pSrc.
+ * @param[out] pProduced         Optional, total decompressed size.
+ *
+ * @retval CPA_STATUS_SUCCESS         Data decompressed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RESOURCE        Memory allocation failed
+ * @retval CPA_STATUS_UNSUPPORTED     A member is larger than maxMemberSize
+ * @retval CPA_STATUS_FAIL            Invalid data or checksum mismatch
+ *************************************************************************/
+CpaStatus icp_sal_DcParallelDecompress(
+    const icp_sal_dc_par_decomp_setup_t *pSetupData,
+    const Cpa8U *pSrc,
+    Cpa64U srcLen,
+    Cpa64U *pProduced);
+
+#endif /* ICP_SAL_DC_PAR_DECOMP_H */
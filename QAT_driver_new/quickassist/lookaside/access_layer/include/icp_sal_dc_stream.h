@@ -0,0 +1,253 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ ***************************************************************************
+ * @file icp_sal_dc_stream.h
+ *
+ * @defgroup SalDcStream
+ *
+ * @ingroup SalDcStream
+ *
+ * @description
+ *    Streaming compression APIs.
+ *    A stream accepts writes of arbitrary size and emits one complete
+ *    gzip, zlib or LZ4 frame. Input is cut into chunks which are kept in
+ *    flight on the instance concurrently; the compressed output of each
+ *    chunk is handed to the caller in submission order, directly from the
+ *    pinned buffers the stream owns, so no intermediate copy of the
+ *    compressed data is made. Frame headers and footers are produced with
+ *    cpaDcGenerateHeader() and cpaDcGenerateFooter().
+ *
+ ***************************************************************************/
+
+#ifndef ICP_SAL_DC_STREAM_H
+#define ICP_SAL_DC_STREAM_H
+
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/**
+ * Chunk size used when icp_sal_dc_stream_setup_t.chunkSize is zero.
+ */
+#define ICP_SAL_DC_STREAM_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Maximum number of chunks a stream can keep in flight.
+ */
+#define ICP_SAL_DC_STREAM_MAX_IN_FLIGHT (64)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Stream handle.
+ *
+ * @description
+ *      Opaque handle returned by icp_sal_DcStreamCreate().
+ *
+ *****************************************************************************/
+typedef void *icp_sal_dc_stream_handle_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Stream output function.
+ *
+ * @description
+ *      Called by the stream for every piece of the frame that is ready, in
+ *      frame order. pData points into memory owned by the stream and is only
+ *      valid until the function returns. Returning anything other than
+ *      CPA_STATUS_SUCCESS aborts the stream.
+ *
+ * @param[in] pOutputTag     Opaque value from the stream setup data.
+ * @param[in] pData          Frame data.
+ * @param[in] dataLen        Number of bytes at pData.
+ *
+ *****************************************************************************/
+typedef CpaStatus (*icp_sal_dc_stream_output_fn_t)(void *pOutputTag,
+                                                   const Cpa8U *pData,
+                                                   Cpa32U dataLen);
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Stream setup data.
+ *
+ * @description
+ *      The frame format is selected by compType and checksum:
+ *      CPA_DC_DEFLATE with CPA_DC_CRC32 produces a gzip frame,
+ *      CPA_DC_DEFLATE with CPA_DC_ADLER32 produces a zlib frame and
+ *      CPA_DC_LZ4 with CPA_DC_XXHASH32 produces an LZ4 frame.
+ *      CPA_DC_LZ4S with CPA_DC_XXHASH32 also produces an LZ4 frame, built
+ *      in software from the LZ4s output of the device with one independent
+ *      block per chunk and without content checksum. The conversion runs
+ *      on the worker threads of the library, the software verify pool,
+ *      while the device compresses the following chunks.
+ *
+ *****************************************************************************/
+typedef struct icp_sal_dc_stream_setup_s
+{
+    CpaDcCompType compType;
+    /**< CPA_DC_DEFLATE, CPA_DC_LZ4 or CPA_DC_LZ4S */
+    CpaDcChecksum checksum;
+    /**< Frame checksum, see above */
+    CpaDcCompLvl compLevel;
+    /**< Compression level */
+    CpaDcHuffType huffType;
+    /**< Huffman type, deflate only */
+    CpaDcCompLZ4BlockMaxSize lz4BlockMaxSize;
+    /**< Maximum LZ4 block size, LZ4 and LZ4S only. LZ4S streams limit the
+     * chunk size to it */
+    Cpa32U chunkSize;
+    /**< Number of input bytes per request. Zero selects
+     * ICP_SAL_DC_STREAM_DEFAULT_CHUNK_SIZE */
+    Cpa32U numInFlight;
+    /**< Maximum number of requests in flight, between 1 and
+     * ICP_SAL_DC_STREAM_MAX_IN_FLIGHT. LZ4 frames accumulate the content
+     * checksum on the device and are always limited to one */
+    icp_sal_dc_stream_output_fn_t pOutputFn;
+    /**< Function receiving the frame */
+    void *pOutputTag;
+    /**< Opaque value passed to pOutputFn */
+    Cpa32U dstSizePercent;
+    /**< Size of the output buffer of a chunk as a percentage of the chunk
+     * size, e.g. from icp_sal_dc_get_dest_size_hint(). Chunks overflowing
+     * it are continued with a further request, which is transparent to
+     * the caller. Zero sizes the output buffers for the worst case
+     * expansion */
+} icp_sal_dc_stream_setup_t;
+
+/*************************************************************************
+ * @ingroup SalDcStream
+ * @description
+ *    Create a compression stream on a started compression instance.
+ *    The stream owns a stateless session on the instance and all the
+ *    pinned buffers it needs, sized from the setup data.
+ *
+ * @context
+ *      This function may sleep and must not be called in interrupt context.
+ * @assumptions
+ *      The instance is polled, either by the caller or by the stream itself
+ *      while it waits for completions.
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in]  dcInstance        Compression instance handle.
+ * @param[in]  pSetupData        Stream setup data.
+ * @param[out] pStreamHandle     Handle of the created stream.
+ *
+ * @retval CPA_STATUS_SUCCESS         Stream created
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_RESOURCE        Memory allocation failed
+ * @retval CPA_STATUS_FAIL            Session could not be initialised
+ *************************************************************************/
+CpaStatus icp_sal_DcStreamCreate(CpaInstanceHandle dcInstance,
+                                 const icp_sal_dc_stream_setup_t *pSetupData,
+                                 icp_sal_dc_stream_handle_t *pStreamHandle);
+
+/*************************************************************************
+ * @ingroup SalDcStream
+ * @description
+ *    Append data to the stream. The data is copied into the stream's
+ *    pinned input chunks and may be reused as soon as the function
+ *    returns. Full chunks are submitted to the instance; the function
+ *    only blocks when all in-flight slots are busy.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] streamHandle       Stream handle.
+ * @param[in] pData              Data to compress.
+ * @param[in] dataLen            Number of bytes at pData.
+ *
+ * @retval CPA_STATUS_SUCCESS         Data accepted
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            The stream has failed or is finished
+ *************************************************************************/
+CpaStatus icp_sal_DcStreamWrite(icp_sal_dc_stream_handle_t streamHandle,
+                                const Cpa8U *pData,
+                                Cpa32U dataLen);
+
+/*************************************************************************
+ * @ingroup SalDcStream
+ * @description
+ *    Complete the frame. Submits the remaining input as the final request,
+ *    waits for every outstanding request and emits the frame footer.
+ *    No further writes are accepted afterwards.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in]  streamHandle      Stream handle.
+ * @param[out] pConsumed         Optional, total number of input bytes.
+ * @param[out] pProduced         Optional, total size of the frame.
+ *
+ * @retval CPA_STATUS_SUCCESS         Frame completed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ * @retval CPA_STATUS_FAIL            The stream has failed or is finished
+ *************************************************************************/
+CpaStatus icp_sal_DcStreamFinish(icp_sal_dc_stream_handle_t streamHandle,
+                                 Cpa64U *pConsumed,
+                                 Cpa64U *pProduced);
+
+/*************************************************************************
+ * @ingroup SalDcStream
+ * @description
+ *    Destroy a stream. Outstanding requests are waited for, the session is
+ *    removed and all memory owned by the stream is released.
+ *
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] streamHandle       Stream handle.
+ *
+ * @retval CPA_STATUS_SUCCESS         Stream destroyed
+ * @retval CPA_STATUS_INVALID_PARAM   Invalid parameter passed in
+ *************************************************************************/
+CpaStatus icp_sal_DcStreamDestroy(icp_sal_dc_stream_handle_t streamHandle);
+
+#endif /* ICP_SAL_DC_STREAM_H */
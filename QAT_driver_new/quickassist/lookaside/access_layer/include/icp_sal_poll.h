@@ -221,6 +221,59 @@ CpaStatus icp_sal_DcPollInstance(CpaInstanceHandle instanceHandle,
 CpaStatus icp_sal_DcPollDpInstance(CpaInstanceHandle dcInstance,
                                    Cpa32U responseQuota);
 
+/* Defined in cpa_dc_dp.h */
+struct _CpaDcDpOpData;
+
+/*************************************************************************
+  * @ingroup SalPoll
+  * @description
+  *    Poll a compression data plane instance and return the completed
+  *    requests to the caller instead of invoking the callback registered
+  *    with cpaDcDpRegCbFunc. Up to maxResponses completed CpaDcDpOpData
+  *    pointers are written to ppOpData in completion order; the status and
+  *    results of each request are available in its responseStatus and
+  *    results fields.
+  *
+  *    This allows the instance to be drained from an application event
+  *    loop, for example after the descriptor returned by
+  *    icp_sal_DcGetFileDescriptor becomes readable, without a callback
+  *    per response. It can be mixed with icp_sal_DcPollDpInstance on the
+  *    same instance as long as the two are not called concurrently.
+  *
+  *    This polling function should be used with the functions described
+  *    in cpa_dc_dp.h
+  *
+  * @context
+  *      This functions is called from both the user and kernel context
+  *
+  * @assumptions
+  *      None
+  * @sideEffects
+  *      None
+  * @reentrant
+  *      No
+  * @threadSafe
+  *      No
+  *
+  * @param[in] dcInstance         Instance handle.
+  * @param[out] ppOpData          Array of at least maxResponses entries
+  *                               that receives the completed requests.
+  * @param[in] maxResponses       The maximum number of messages that
+  *                               will be read in one polling. Must be
+  *                               greater than zero.
+  * @param[out] pNumResponses     Number of entries written to ppOpData.
+  *
+  * @retval CPA_STATUS_SUCCESS    Successfully polled a ring with data
+  * @retval CPA_STATUS_RETRY      There are no responses on the ring
+  *                               associated with this instance
+  * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+  * @retval CPA_STATUS_FAIL       Indicates a failure
+  *************************************************************************/
+CpaStatus icp_sal_DcPollDpInstanceBatch(CpaInstanceHandle dcInstance,
+                                        struct _CpaDcDpOpData **ppOpData,
+                                        Cpa32U maxResponses,
+                                        Cpa32U *pNumResponses);
+
 /*************************************************************************
  * @ingroup SalPoll
  * @description
@@ -473,6 +473,623 @@ CpaStatus icp_sal_dc_simulate_error(Cpa8U numErrors, Cpa8S dcError);
 CpaStatus icp_sal_cnv_simulate_error(CpaInstanceHandle dcInstance,
                                      CpaDcSessionHandle pSessionHandle);
 
+/*
+ * icp_sal_dc_set_stateful_pipeline_depth
+ *
+ * @description:
+ *  This function sets the number of requests that can be outstanding
+ *  on an asynchronous stateful session. Requests submitted while one
+ *  is in flight are queued in the session instead of being rejected
+ *  with CPA_STATUS_RETRY, and are sent to the device, in order, from
+ *  the completion of the previous request, before its callback is
+ *  invoked. This is a software queue: the device still processes one
+ *  request of the session at a time, so the gain is the removed
+ *  resubmission round trip, not parallel processing.
+ *  If a request does not complete with CPA_DC_OK (for example on
+ *  overflow), the queued requests are not sent: their callbacks are
+ *  invoked with CPA_STATUS_RETRY and consumed/produced set to zero,
+ *  and they must be resubmitted after the condition is handled.
+ *  Zero length requests, and one byte decompression requests, are
+ *  never queued and return CPA_STATUS_RETRY while the session is busy.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ *      as an asynchronous stateful session
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] depth                  Maximum number of outstanding requests,
+ *                                   up to 8. 0 or 1 disables pipelining
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_set_stateful_pipeline_depth(
+    CpaInstanceHandle dcInstance,
+    CpaDcSessionHandle pSessionHandle,
+    Cpa32U depth);
+
+/*
+ * icp_sal_dc_cnv_policy_t
+ *
+ * @description:
+ *  Compress and verify (CnV) policy of a session. The policy applies to
+ *  the stateless compression requests which ask for CnV through
+ *  CpaDcOpData.
+ */
+typedef enum _icp_sal_dc_cnv_policy
+{
+    ICP_SAL_DC_CNV_POLICY_DEVICE = 0,
+    /* Every request is verified by the device (default) */
+    ICP_SAL_DC_CNV_POLICY_SAMPLED,
+    /* One request in sampleInterval is verified by the device, the
+     * others are sent without verification */
+    ICP_SAL_DC_CNV_POLICY_SW_ASYNC
+    /* The requests are sent without device verification and the
+     * produced data is decompressed and compared with the source by a
+     * pool of CPU worker threads before the callback is invoked */
+} icp_sal_dc_cnv_policy_t;
+
+/*
+ * icp_sal_dc_cnv_stats_t
+ *
+ * @description:
+ *  Counters of the compress and verify policy of a session.
+ */
+typedef struct _icp_sal_dc_cnv_stats
+{
+    Cpa64U numDeviceVerified;
+    /* Requests sent with device verification */
+    Cpa64U numNotVerified;
+    /* Requests left unverified: skipped by the sampled policy or not
+     * completed with CPA_DC_OK under the software policy */
+    Cpa64U numSwVerified;
+    /* Requests verified in software */
+    Cpa64U numSwVerifyErrors;
+    /* Requests which failed the software verification. Their callback is
+     * invoked with CPA_STATUS_FAIL and the results status set to
+     * CPA_DC_VERIFY_ERROR */
+} icp_sal_dc_cnv_stats_t;
+
+/*
+ * icp_sal_dc_set_cnv_policy
+ *
+ * @description:
+ *  This function selects how the stateless compression requests of the
+ *  session asking for CnV are verified. Verifying only a sample of the
+ *  requests, or moving the verification to CPU worker threads, frees the
+ *  device time spent on verification. The software verification supports
+ *  Deflate and LZ4 sessions and is only available in user space.
+ *  Requests of a session with CnV error injection enabled or using
+ *  integrityCrcCheck are always verified by the device.
+ *  The policy is kept across cpaDcResetSession.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ *      as a stateless session
+ * @sideEffects
+ *      The first session selecting ICP_SAL_DC_CNV_POLICY_SW_ASYNC starts
+ *      the worker threads, they are stopped when the last such session
+ *      is removed or changes policy
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] policy                 CnV policy
+ * @param[in] sampleInterval         Sampling interval, used with
+ *                                   ICP_SAL_DC_CNV_POLICY_SAMPLED only
+ *
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported policy for this session
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RESOURCE       Worker threads could not be started
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_set_cnv_policy(CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle,
+                                    icp_sal_dc_cnv_policy_t policy,
+                                    Cpa32U sampleInterval);
+
+/*
+ * icp_sal_dc_get_cnv_stats
+ *
+ * @description:
+ *  This function returns the counters of the compress and verify policy
+ *  of a session.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[out] pCnvStats             Policy counters
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_get_cnv_stats(CpaInstanceHandle dcInstance,
+                                   CpaDcSessionHandle pSessionHandle,
+                                   icp_sal_dc_cnv_stats_t *pCnvStats);
+
+/*
+ * icp_sal_dc_precheck_stats_t
+ *
+ * @description:
+ *  Counters of the compressibility pre-check of a session.
+ */
+typedef struct _icp_sal_dc_precheck_stats
+{
+    Cpa64U numChecked;
+    /* Requests whose entropy was estimated */
+    Cpa64U numStored;
+    /* Requests estimated incompressible and stored in software */
+    Cpa64U numAudited;
+    /* Requests estimated incompressible and offloaded anyway to audit
+     * the estimate */
+    Cpa64U numAuditCompressible;
+    /* Audited requests the device compressed by more than 1/32 of their
+     * size, i.e. wrongly stored requests */
+    Cpa64U numMissed;
+    /* Requests estimated compressible the device did not compress by
+     * 1/32 of their size */
+} icp_sal_dc_precheck_stats_t;
+
+/*
+ * icp_sal_dc_set_precheck
+ *
+ * @description:
+ *  This function enables the compressibility pre-check of a stateless
+ *  Deflate compression session. Before a request of at least 4KB is
+ *  offloaded, the byte entropy of 8 samples of 512 bytes spread over the
+ *  source is estimated. When it reaches entropyThreshold, the source is
+ *  written to the destination as deflate stored blocks in software and
+ *  the request is completed inline with dataUncompressed set in the
+ *  results, without using the device.
+ *  The destination must hold the source plus 5 bytes per 65535 bytes for
+ *  a request to be stored, otherwise it is offloaded. Requests using
+ *  integrityCrcCheck are always offloaded.
+ *  The pre-check is only available in user space and is kept across
+ *  cpaDcResetSession.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ *      as a stateless compression session with no, CRC32 or Adler32
+ *      checksum
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] enable                 CPA_TRUE to enable the pre-check,
+ *                                   CPA_FALSE to disable it
+ * @param[in] entropyThreshold       Entropy threshold in thousandths of a
+ *                                   bit per byte, at most 8000. Zero selects
+ *                                   the default of 7800
+ * @param[in] auditInterval          One request in auditInterval estimated
+ *                                   incompressible is offloaded anyway and
+ *                                   its outcome counted, zero disables the
+ *                                   audits
+ *
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported compression or checksum type
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_set_precheck(CpaInstanceHandle dcInstance,
+                                  CpaDcSessionHandle pSessionHandle,
+                                  CpaBoolean enable,
+                                  Cpa32U entropyThreshold,
+                                  Cpa32U auditInterval);
+
+/*
+ * icp_sal_dc_get_precheck_stats
+ *
+ * @description:
+ *  This function returns the counters of the compressibility pre-check of
+ *  a session.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[out] pPrecheckStats        Pre-check counters
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_get_precheck_stats(
+    CpaInstanceHandle dcInstance,
+    CpaDcSessionHandle pSessionHandle,
+    icp_sal_dc_precheck_stats_t *pPrecheckStats);
+
+/*
+ * icp_sal_dc_sizing_stats_t
+ *
+ * @description:
+ *  Counters of the destination sizing feedback of a session.
+ */
+typedef struct _icp_sal_dc_sizing_stats
+{
+    Cpa64U numSamples;
+    /* Completed requests whose compression ratio was recorded */
+    Cpa64U numOverflows;
+    /* Requests which overflowed their destination buffer */
+} icp_sal_dc_sizing_stats_t;
+
+/*
+ * icp_sal_dc_set_dest_sizing
+ *
+ * @description:
+ *  This function enables the destination sizing feedback of a stateless
+ *  compression session. The compression ratio of every request completed
+ *  by the device is recorded, in steps of 1/32, so that
+ *  icp_sal_dc_get_dest_size_hint() can suggest destination buffers much
+ *  smaller than the compress bound. Enabling the feedback clears the
+ *  recorded ratios. It is only available in user space.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ *      as a stateless compression session
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] enable                 CPA_TRUE to record compression ratios
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_set_dest_sizing(CpaInstanceHandle dcInstance,
+                                     CpaDcSessionHandle pSessionHandle,
+                                     CpaBoolean enable);
+
+/*
+ * icp_sal_dc_get_dest_size_hint
+ *
+ * @description:
+ *  This function suggests the destination buffer size of a request of
+ *  srcLen bytes such that, according to the ratios recorded on the
+ *  session, at most overflowPpm requests per million overflow. The
+ *  compress bound is returned until 64 requests have been recorded or when
+ *  the recorded requests expanded.
+ *  A stateless compression request which overflows returns the data
+ *  compressed so far; the caller continues with the unconsumed part of the
+ *  source in a new request, see icp_sal_DcStreamCreate() for a stream
+ *  doing so transparently.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] srcLen                 Size of the source of the request
+ * @param[in] overflowPpm            Accepted overflow probability in parts
+ *                                   per million, at most 1000000
+ * @param[out] pDestLen              Suggested destination size
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_get_dest_size_hint(CpaInstanceHandle dcInstance,
+                                        CpaDcSessionHandle pSessionHandle,
+                                        Cpa32U srcLen,
+                                        Cpa32U overflowPpm,
+                                        Cpa32U *pDestLen);
+
+/*
+ * icp_sal_dc_get_dest_sizing_stats
+ *
+ * @description:
+ *  This function returns the counters of the destination sizing feedback
+ *  of a session.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      Yes
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[out] pSizingStats          Sizing counters
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_get_dest_sizing_stats(
+    CpaInstanceHandle dcInstance,
+    CpaDcSessionHandle pSessionHandle,
+    icp_sal_dc_sizing_stats_t *pSizingStats);
+
+/*
+ * icp_sal_dc_set_inline_threshold
+ *
+ * @description:
+ *  This function sets the size below which the requests of a stateless
+ *  Deflate session are processed on the calling CPU instead of the device.
+ *  Compression requests are written out as a single stored block and
+ *  decompression requests are decoded in software, then completed through
+ *  the callback, or returned synchronously, with the same results and
+ *  checksum semantics as device requests. This saves the ring round trip
+ *  and the polling latency of tiny requests.
+ *  Requests using integrityCrcCheck, zero length requests and requests
+ *  whose destination is too small, or whose compressed data is invalid or
+ *  decompresses to more than 4KB, are still offloaded. The inline path is
+ *  only available in user space and is kept across cpaDcResetSession.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ *      as a stateless Deflate session with no, CRC32 or Adler32 checksum
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] threshold              Requests with fewer source bytes are
+ *                                   processed inline, at most 1024. Zero
+ *                                   disables the inline path
+ *
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported compression or checksum type
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_set_inline_threshold(CpaInstanceHandle dcInstance,
+                                          CpaDcSessionHandle pSessionHandle,
+                                          Cpa32U threshold);
+
+/*
+ * icp_sal_dc_set_dictionary
+ *
+ * @description:
+ *  This function sets the preset dictionary of a stateless Deflate or LZ4
+ *  session, or clears it when pDict is NULL. The dictionary is copied and
+ *  the caller's buffer can be reused on return.
+ *  Decompression requests are processed by the device with the dictionary
+ *  sent ahead of the data of each request. The device has no preset
+ *  history for stateless compression, so compression requests are encoded
+ *  in software and completed before the function returns; the callback is
+ *  invoked from the calling thread.
+ *  Compression on these sessions therefore runs on the CPU and uses fixed
+ *  Huffman codes only for Deflate, or stored blocks when they are smaller.
+ *  It does not reach the throughput of the device and gives a lower ratio
+ *  than its dynamic Huffman codes would on the same matches; the gain
+ *  comes from the matches into the dictionary, mostly on small requests.
+ *  The dict_bench sample in sample_code/micro_bench reports the ratio and
+ *  throughput on 1KB to 4KB requests with and without a dictionary.
+ *  The data is a raw Deflate stream or LZ4 frame data blocks referring to
+ *  the dictionary, as produced by zlib after deflateSetDictionary or by
+ *  LZ4 with a dictionary. cpaDcGenerateHeader sets FDICT and writes the
+ *  Adler-32 of the dictionary as DICTID in Zlib headers, and writes
+ *  dictId in LZ4 frame headers.
+ *  LZ4 sessions must use linked blocks and no accumulated xxHash.
+ *  Decompression buffer lists are limited to 16 buffers and 32 requests
+ *  can be in flight per session. Requests using integrityCrcCheck are
+ *  not supported.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      The session has been initialized via cpaDcInitSession function
+ *      as a stateless session
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] dcInstance             Instance Handle
+ * @param[in] pSessionHandle         Session Handle
+ * @param[in] pDict                  Dictionary, or NULL to clear it
+ * @param[in] dictLen                Dictionary length, up to 32KB for
+ *                                   Deflate and 64KB - 1 for LZ4
+ * @param[in] dictId                 LZ4 dictionary id, ignored for Deflate
+ *
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported session configuration
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RESOURCE       Memory allocation failed
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dc_set_dictionary(CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle,
+                                    const Cpa8U *pDict,
+                                    Cpa32U dictLen,
+                                    Cpa32U dictId);
+
+/*
+ * icp_sal_dp_flush_stats_t
+ *
+ * @description:
+ *  Counters of the doorbell scheduler of a data plane instance. A flush
+ *  updates the ring tail and submits all the requests queued on the
+ *  instance to the device.
+ */
+typedef struct _icp_sal_dp_flush_stats
+{
+    Cpa64U numFlushBatch;
+    /* Flushes triggered by the batch size of the policy */
+    Cpa64U numFlushBudget;
+    /* Flushes triggered by the time budget of the policy */
+    Cpa64U numFlushExplicit;
+    /* Flushes requested by the application with performOpNow or
+     * cpaDcDpPerformOpNow/cpaCySymDpPerformOpNow while a policy was set */
+    Cpa64U numRequestsFlushed;
+    /* Requests submitted by the flushes while a policy was set */
+} icp_sal_dp_flush_stats_t;
+
+/*
+ * icp_sal_dp_set_flush_policy
+ *
+ * @description:
+ *  This function sets the doorbell scheduler of a compression or
+ *  symmetric crypto data plane instance. Requests enqueued with
+ *  performOpNow set to CPA_FALSE are then submitted by the library once
+ *  batchSize requests are queued, or once the oldest queued request has
+ *  waited budgetUs microseconds. The budget is checked on enqueue, by
+ *  icp_sal_DcPollDpInstance/icp_sal_CyPollDpInstance and by
+ *  icp_sal_dp_flush_expired, which can be called from a timer.
+ *  Requests enqueued with performOpNow set to CPA_TRUE are submitted
+ *  immediately as before. A batchSize of 0 disables the scheduler.
+ *  Requests queued under the previous policy are submitted first.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] instanceHandle         Instance Handle
+ * @param[in] batchSize              Number of queued requests triggering
+ *                                   a flush, 0 to disable the scheduler
+ * @param[in] budgetUs               Time budget in microseconds, 0 for
+ *                                   no time limit
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY          Queued requests could not be submitted
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dp_set_flush_policy(CpaInstanceHandle instanceHandle,
+                                      Cpa32U batchSize,
+                                      Cpa32U budgetUs);
+
+/*
+ * icp_sal_dp_get_flush_stats
+ *
+ * @description:
+ *  This function returns the counters of the doorbell scheduler of a
+ *  compression or symmetric crypto data plane instance.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] instanceHandle         Instance Handle
+ * @param[out] pFlushStats           Scheduler counters
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dp_get_flush_stats(CpaInstanceHandle instanceHandle,
+                                     icp_sal_dp_flush_stats_t *pFlushStats);
+
+/*
+ * icp_sal_dp_flush_expired
+ *
+ * @description:
+ *  This function submits the requests queued on a data plane instance if
+ *  the oldest one has exceeded the time budget of the scheduler. It
+ *  lets a timer bound the latency when the instance is neither enqueued
+ *  to nor polled.
+ *
+ * @context
+ *      This function is called from the user process context
+ * @assumptions
+ *      None
+ * @sideEffects
+ *      None
+ * @reentrant
+ *      No
+ * @threadSafe
+ *      No
+ *
+ * @param[in] instanceHandle         Instance Handle
+ *
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_RETRY          Queued requests could not be submitted
+ * @retval CPA_STATUS_SUCCESS        No error
+ *
+ */
+CpaStatus icp_sal_dp_flush_expired(CpaInstanceHandle instanceHandle);
+
 /*
  * icp_sal_ns_cnv_simulate_error
  *
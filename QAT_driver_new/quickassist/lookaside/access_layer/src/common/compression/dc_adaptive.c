@@ -0,0 +1,504 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_adaptive.c
+ *
+ * @ingroup SalDcAdaptive
+ *
+ * @description
+ *      Implementation of the adaptive compression level selection.
+ *
+ *      The load is measured from the number of requests in flight on the
+ *      sessions of the compressor and from the input throughput offered
+ *      over DC_ADAPTIVE_WINDOW_NS windows. The achieved ratio of every
+ *      level comes from the destination sizing histogram of its session
+ *      and is cached every DC_ADAPTIVE_RATIO_REFRESH requests, so that the
+ *      selection does not read the histograms on every request.
+ *      The level moves by one step at a time: down as soon as a watermark
+ *      or the throughput target is crossed, up only when the load is below
+ *      the low watermark and the higher level has paid off. A higher level
+ *      which did not pay off is still retried every DC_ADAPTIVE_PROBE_PERIOD
+ *      requests, so that its ratio follows changes of the data.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "icp_sal_dc_adaptive.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_sizing.h"
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "sal_types_compression.h"
+#include "sal_service_state.h"
+
+/* Length of the throughput measurement window */
+#define DC_ADAPTIVE_WINDOW_NS (10 * 1000 * 1000ULL)
+
+/* Number of requests after which a higher level is retried even though it
+ * did not pay off */
+#define DC_ADAPTIVE_PROBE_PERIOD (1024)
+
+/* Number of requests between two refreshes of the cached ratios, a power
+ * of two */
+#define DC_ADAPTIVE_RATIO_REFRESH (256)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Adaptive compressor descriptor
+ *
+ * @description
+ *      The level and the throughput window are updated without a lock by
+ *      the submitting threads. Concurrent updates may lose a step or a
+ *      window, which only delays the adaptation by a request.
+ *
+ *****************************************************************************/
+typedef struct dc_adaptive_s
+{
+    CpaInstanceHandle dcInstance;
+    CpaDcSessionHandle pSessionHandles[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    CpaDcCompLvl levels[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    OsalAtomic numRequests[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    Cpa32U numLevels;
+    Cpa32U highWatermark;
+    Cpa32U lowWatermark;
+    Cpa32U minGainPercent;
+    Cpa64U targetBytesPerSec;
+    volatile Cpa32U current;
+    /**< Index of the selected level */
+    OsalAtomic probeCount;
+    /**< Requests since the level was last raised */
+    OsalAtomic ratioAge;
+    /**< Requests since the cached ratios were refreshed */
+    volatile Cpa32U ratioPercent[ICP_SAL_DC_ADAPTIVE_MAX_LEVELS];
+    /**< Cached achieved ratio of every level, zero while unknown */
+    OsalAtomic windowBytes;
+    /**< Input bytes submitted in the current window */
+    volatile Cpa64U windowStartNs;
+    volatile Cpa64U bytesPerSec;
+    /**< Input throughput of the last complete window */
+} dc_adaptive_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Release all resources of an adaptive compressor
+ *
+ *****************************************************************************/
+STATIC void dcAdaptiveFree(dc_adaptive_t *pAdaptive)
+{
+    Cpa32U i = 0;
+
+    for (i = 0; i < ICP_SAL_DC_ADAPTIVE_MAX_LEVELS; i++)
+    {
+        LAC_OS_CAFREE(pAdaptive->pSessionHandles[i]);
+    }
+    LAC_OS_FREE(pAdaptive);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Number of requests in flight on the sessions of a compressor
+ *
+ *****************************************************************************/
+STATIC Cpa64U dcAdaptiveInFlight(dc_adaptive_t *pAdaptive)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    Cpa64U inFlight = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; i < pAdaptive->numLevels; i++)
+    {
+        pSessionDesc =
+            DC_SESSION_DESC_FROM_CTX_GET(pAdaptive->pSessionHandles[i]);
+        inFlight += osalAtomicGet(&pSessionDesc->pendingStatelessCbCount);
+    }
+
+    return inFlight;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Account the input of a request in the throughput window
+ *
+ *****************************************************************************/
+STATIC void dcAdaptiveMeasure(dc_adaptive_t *pAdaptive, Cpa64U srcLen)
+{
+    Cpa64U now = osalTimestampGetNs();
+    Cpa64U elapsed = now - pAdaptive->windowStartNs;
+    Cpa64U bytes = 0;
+
+    osalAtomicAdd(srcLen, &pAdaptive->windowBytes);
+    if (elapsed < DC_ADAPTIVE_WINDOW_NS)
+    {
+        return;
+    }
+
+    bytes = osalAtomicGet(&pAdaptive->windowBytes);
+    osalAtomicSet(0, &pAdaptive->windowBytes);
+    pAdaptive->windowStartNs = now;
+    pAdaptive->bytesPerSec = (bytes * 1000000000ULL) / elapsed;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Refresh the cached ratios of the levels
+ *
+ * @description
+ *      Reads the sizing histogram of every level once every
+ *      DC_ADAPTIVE_RATIO_REFRESH requests.
+ *
+ *****************************************************************************/
+STATIC void dcAdaptiveRefreshRatios(dc_adaptive_t *pAdaptive)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    Cpa32U i = 0;
+
+    if (0 != (osalAtomicInc(&pAdaptive->ratioAge) &
+              (DC_ADAPTIVE_RATIO_REFRESH - 1)))
+    {
+        return;
+    }
+
+    for (i = 0; i < pAdaptive->numLevels; i++)
+    {
+        pSessionDesc =
+            DC_SESSION_DESC_FROM_CTX_GET(pAdaptive->pSessionHandles[i]);
+        pAdaptive->ratioPercent[i] = dcSizingRatioPercent(pSessionDesc);
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcAdaptive
+ *      Select the level of the next request
+ *
+ * @retval Index of the selected level
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcAdaptiveSelect(dc_adaptive_t *pAdaptive)
+{
+    Cpa32U current = pAdaptive->current;
+    Cpa32U lowerRatio = 0;
+    Cpa32U higherRatio = 0;
+    Cpa64U inFlight = 0;
+    CpaBoolean overTarget = CPA_FALSE;
+
+    if (1 == pAdaptive->numLevels)
+    {
+        return 0;
+    }
+
+    inFlight = dcAdaptiveInFlight(pAdaptive);
+    overTarget = ((0 != pAdaptive->targetBytesPerSec) &&
+                  (pAdaptive->bytesPerSec > pAdaptive->targetBytesPerSec))
+                     ? CPA_TRUE
+                     : CPA_FALSE;
+
+    if ((current > 0) &&
+        ((inFlight >= pAdaptive->highWatermark) || (CPA_TRUE == overTarget)))
+    {
+        current--;
+    }
+    else if ((current + 1 < pAdaptive->numLevels) &&
+             (inFlight <= pAdaptive->lowWatermark) &&
+             (CPA_FALSE == overTarget))
+    {
+        lowerRatio = pAdaptive->ratioPercent[current];
+        higherRatio = pAdaptive->ratioPercent[current + 1];
+
+        /* Unknown ratios count as a gain so that every level gets sampled */
+        if ((0 == lowerRatio) || (0 == higherRatio) ||
+            (higherRatio * 100 <=
+             lowerRatio * (100 - pAdaptive->minGainPercent)) ||
+            (0 == (osalAtomicInc(&pAdaptive->probeCount) %
+                   DC_ADAPTIVE_PROBE_PERIOD)))
+        {
+            current++;
+            osalAtomicSet(0, &pAdaptive->probeCount);
+        }
+    }
+
+    pAdaptive->current = current;
+
+    return current;
+}
+
+CpaStatus icp_sal_DcAdaptiveCreate(
+    CpaInstanceHandle dcInstance,
+    const icp_sal_dc_adaptive_setup_t *pSetupData,
+    icp_sal_dc_adaptive_handle_t *pAdaptiveHandle)
+{
+    CpaInstanceHandle insHandle = NULL;
+    sal_compression_service_t *pService = NULL;
+    dc_adaptive_t *pAdaptive = NULL;
+    CpaDcSessionSetupData sessionSetupData;
+    Cpa32U sessionSize = 0;
+    Cpa32U contextSize = 0;
+    Cpa32U numInit = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pSetupData);
+    LAC_CHECK_NULL_PARAM(pAdaptiveHandle);
+
+    if (CPA_INSTANCE_HANDLE_SINGLE == dcInstance)
+    {
+        insHandle = dcGetFirstHandle();
+    }
+    else
+    {
+        insHandle = dcInstance;
+    }
+    LAC_CHECK_NULL_PARAM(insHandle);
+    SAL_CHECK_INSTANCE_TYPE(insHandle, SAL_SERVICE_TYPE_COMPRESSION);
+    SAL_RUNNING_CHECK(insHandle);
+    pService = (sal_compression_service_t *)insHandle;
+
+    if ((0 == pSetupData->numLevels) ||
+        (pSetupData->numLevels > ICP_SAL_DC_ADAPTIVE_MAX_LEVELS))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid numLevels value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    if ((CPA_DC_STATELESS != pSetupData->sessionSetupData.sessState) ||
+        (CPA_DC_DIR_COMPRESS != pSetupData->sessionSetupData.sessDirection))
+    {
+        LAC_INVALID_PARAM_LOG("The sessions must be stateless compression "
+                              "sessions");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    if ((pSetupData->lowWatermark >= pSetupData->highWatermark) ||
+        (pSetupData->minGainPercent > 100))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid adaptation thresholds");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    status = LAC_OS_MALLOC(&pAdaptive, sizeof(dc_adaptive_t));
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+    osalMemSet(pAdaptive, 0, sizeof(dc_adaptive_t));
+
+    pAdaptive->dcInstance = insHandle;
+    pAdaptive->numLevels = pSetupData->numLevels;
+    pAdaptive->highWatermark = pSetupData->highWatermark;
+    pAdaptive->lowWatermark = pSetupData->lowWatermark;
+    pAdaptive->minGainPercent = pSetupData->minGainPercent;
+    pAdaptive->targetBytesPerSec = pSetupData->targetBytesPerSec;
+    pAdaptive->windowStartNs = osalTimestampGetNs();
+
+    sessionSetupData = pSetupData->sessionSetupData;
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < pAdaptive->numLevels);
+         i++)
+    {
+        pAdaptive->levels[i] = pSetupData->levels[i];
+        sessionSetupData.compLevel = pSetupData->levels[i];
+
+        status = cpaDcGetSessionSize(
+            insHandle, &sessionSetupData, &sessionSize, &contextSize);
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            status = LAC_OS_CAMALLOC(&pAdaptive->pSessionHandles[i],
+                                     sessionSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            status = cpaDcInitSession(insHandle,
+                                      pAdaptive->pSessionHandles[i],
+                                      &sessionSetupData,
+                                      NULL,
+                                      pSetupData->callbackFn);
+        }
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            numInit++;
+            /* The ratio of every level is taken from its sizing histogram */
+            status = dcSetDestSizing(
+                insHandle, pAdaptive->pSessionHandles[i], CPA_TRUE);
+        }
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to create adaptive compressor");
+        for (i = 0; i < numInit; i++)
+        {
+            cpaDcRemoveSession(insHandle, pAdaptive->pSessionHandles[i]);
+        }
+        dcAdaptiveFree(pAdaptive);
+        return status;
+    }
+
+    *pAdaptiveHandle = pAdaptive;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcAdaptiveCompressData2(
+    icp_sal_dc_adaptive_handle_t adaptiveHandle,
+    CpaBufferList *pSrcBuff,
+    CpaBufferList *pDestBuff,
+    CpaDcOpData *pOpData,
+    CpaDcRqResults *pResults,
+    void *callbackTag)
+{
+    dc_adaptive_t *pAdaptive = (dc_adaptive_t *)adaptiveHandle;
+    Cpa64U srcLen = 0;
+    Cpa32U level = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pAdaptive);
+    LAC_CHECK_NULL_PARAM(pSrcBuff);
+    LAC_CHECK_NULL_PARAM(pOpData);
+
+    if (CPA_DC_FLUSH_FINAL != pOpData->flushFlag)
+    {
+        LAC_INVALID_PARAM_LOG("Adaptive requests must be flushed with "
+                              "CPA_DC_FLUSH_FINAL");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    for (i = 0; i < pSrcBuff->numBuffers; i++)
+    {
+        srcLen += pSrcBuff->pBuffers[i].dataLenInBytes;
+    }
+    dcAdaptiveMeasure(pAdaptive, srcLen);
+    dcAdaptiveRefreshRatios(pAdaptive);
+    level = dcAdaptiveSelect(pAdaptive);
+
+    status = cpaDcCompressData2(pAdaptive->dcInstance,
+                                pAdaptive->pSessionHandles[level],
+                                pSrcBuff,
+                                pDestBuff,
+                                pOpData,
+                                pResults,
+                                callbackTag);
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        osalAtomicInc(&pAdaptive->numRequests[level]);
+    }
+
+    return status;
+}
+
+CpaStatus icp_sal_DcAdaptiveGetStats(
+    icp_sal_dc_adaptive_handle_t adaptiveHandle,
+    icp_sal_dc_adaptive_stats_t *pStats)
+{
+    dc_adaptive_t *pAdaptive = (dc_adaptive_t *)adaptiveHandle;
+    dc_session_desc_t *pSessionDesc = NULL;
+    Cpa32U i = 0;
+
+    LAC_CHECK_NULL_PARAM(pAdaptive);
+    LAC_CHECK_NULL_PARAM(pStats);
+
+    osalMemSet(pStats, 0, sizeof(icp_sal_dc_adaptive_stats_t));
+    pStats->numLevels = pAdaptive->numLevels;
+    for (i = 0; i < pAdaptive->numLevels; i++)
+    {
+        pSessionDesc =
+            DC_SESSION_DESC_FROM_CTX_GET(pAdaptive->pSessionHandles[i]);
+        pStats->levels[i] = pAdaptive->levels[i];
+        pStats->numRequests[i] = osalAtomicGet(&pAdaptive->numRequests[i]);
+        pStats->ratioPercent[i] = dcSizingRatioPercent(pSessionDesc);
+    }
+    pStats->currentLevel = pAdaptive->current;
+    pStats->bytesPerSec = pAdaptive->bytesPerSec;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcAdaptiveDestroy(
+    icp_sal_dc_adaptive_handle_t adaptiveHandle)
+{
+    dc_adaptive_t *pAdaptive = (dc_adaptive_t *)adaptiveHandle;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pAdaptive);
+
+    if (0 != dcAdaptiveInFlight(pAdaptive))
+    {
+        return CPA_STATUS_RETRY;
+    }
+
+    /* Sessions are removed from the last one so that, if a removal fails,
+     * the compressor keeps exactly the sessions still registered with the
+     * instance and the call can be retried */
+    while (0 != pAdaptive->numLevels)
+    {
+        status = cpaDcRemoveSession(
+            pAdaptive->dcInstance,
+            pAdaptive->pSessionHandles[pAdaptive->numLevels - 1]);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            LAC_LOG_ERROR("Failed to remove adaptive session");
+            return status;
+        }
+        pAdaptive->numLevels--;
+        if (pAdaptive->current >= pAdaptive->numLevels)
+        {
+            pAdaptive->current = 0;
+        }
+    }
+
+    dcAdaptiveFree(pAdaptive);
+
+    return CPA_STATUS_SUCCESS;
+}
@@ -0,0 +1,459 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_buffer_pool.c
+ *
+ * @ingroup SalDcBufferPool
+ *
+ * @description
+ *      Implementation of the pools of pre-registered pinned buffers.
+ *
+ *      Every buffer of a pool is an entry holding the public buffer, its
+ *      buffer list, flat buffer and reference count. Free entries are
+ *      linked in SAL_STATS_NUM_SHARDS shards, each with its own lock and
+ *      on its own cache line, and a thread uses the shard given by
+ *      SalStatistics_ShardGet(). A thread only falls back to the other
+ *      shards when its own is empty, so a buffer released in one shard is
+ *      never lost to the others.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "icp_sal_dc_buffer_pool.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "sal_types_compression.h"
+#include "sal_service_state.h"
+#include "sal_statistics.h"
+
+/* Number of shards of the free buffers of a pool */
+#define DC_BUF_POOL_NUM_SHARDS SAL_STATS_NUM_SHARDS
+
+/* Size of a shard, padded to whole cache lines */
+#define DC_BUF_POOL_SHARD_STRIDE                                               \
+    ((sizeof(dc_buf_pool_shard_t) + LAC_64BYTE_ALIGNMENT - 1) &                \
+     ~(LAC_64BYTE_ALIGNMENT - 1))
+
+/* Shard of a pool */
+#define DC_BUF_POOL_SHARD(pPool, index)                                        \
+    ((dc_buf_pool_shard_t *)((Cpa8U *)(pPool)->pShards +                       \
+                             (index)*DC_BUF_POOL_SHARD_STRIDE))
+
+struct dc_buf_pool_s;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Buffer pool entry
+ *
+ *****************************************************************************/
+typedef struct dc_buf_pool_entry_s
+{
+    icp_sal_dc_buffer_t buffer;
+    /**< Public buffer, first so that a buffer pointer is an entry pointer */
+    CpaBufferList bufferList;
+    CpaFlatBuffer flatBuffer;
+    OsalAtomic refCount;
+    /**< Number of references held, zero while the entry is free */
+    struct dc_buf_pool_s *pPool;
+    /**< Pool owning the entry */
+    struct dc_buf_pool_entry_s *pNext;
+    /**< Next free entry of the shard */
+} dc_buf_pool_entry_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Free entries of a shard
+ *
+ *****************************************************************************/
+typedef struct dc_buf_pool_shard_s
+{
+    lac_lock_t lock;
+    dc_buf_pool_entry_t *pHead;
+} dc_buf_pool_shard_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Buffer pool descriptor
+ *
+ *****************************************************************************/
+typedef struct dc_buf_pool_s
+{
+    dc_buf_pool_entry_t *pEntries;
+    Cpa32U numBuffers;
+    Cpa32U bufferSize;
+    void *pShards;
+    /**< DC_BUF_POOL_NUM_SHARDS shards of DC_BUF_POOL_SHARD_STRIDE bytes */
+    Cpa32U numShardsInit;
+    /**< Number of shards with an initialised lock */
+} dc_buf_pool_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Free a pool and the buffers allocated for it
+ *
+ *****************************************************************************/
+STATIC void dcBufPoolFree(dc_buf_pool_t *pPool)
+{
+    Cpa32U i = 0;
+
+    if (NULL != pPool->pEntries)
+    {
+        for (i = 0; i < pPool->numBuffers; i++)
+        {
+            dc_buf_pool_entry_t *pEntry = &pPool->pEntries[i];
+
+            LAC_OS_CAFREE(pEntry->buffer.pData);
+            LAC_OS_CAFREE(pEntry->bufferList.pPrivateMetaData);
+        }
+        LAC_OS_FREE(pPool->pEntries);
+    }
+    for (i = 0; i < pPool->numShardsInit; i++)
+    {
+        LAC_SPINLOCK_DESTROY(&DC_BUF_POOL_SHARD(pPool, i)->lock);
+    }
+    if (NULL != pPool->pShards)
+    {
+        osalMemAlignedFree(pPool->pShards);
+    }
+    LAC_OS_FREE(pPool);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Put a free entry in a shard
+ *
+ *****************************************************************************/
+STATIC void dcBufPoolPush(dc_buf_pool_t *pPool,
+                          Cpa32U shard,
+                          dc_buf_pool_entry_t *pEntry)
+{
+    dc_buf_pool_shard_t *pShard = DC_BUF_POOL_SHARD(pPool, shard);
+
+    LAC_SPINLOCK(&pShard->lock);
+    pEntry->pNext = pShard->pHead;
+    pShard->pHead = pEntry;
+    LAC_SPINUNLOCK(&pShard->lock);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcBufferPool
+ *      Take a free entry from a shard, NULL when the shard is empty
+ *
+ *****************************************************************************/
+STATIC dc_buf_pool_entry_t *dcBufPoolPop(dc_buf_pool_t *pPool, Cpa32U shard)
+{
+    dc_buf_pool_shard_t *pShard = DC_BUF_POOL_SHARD(pPool, shard);
+    dc_buf_pool_entry_t *pEntry = NULL;
+
+    /* Racy peek, an empty shard is skipped without taking its lock */
+    if (NULL == pShard->pHead)
+    {
+        return NULL;
+    }
+
+    LAC_SPINLOCK(&pShard->lock);
+    pEntry = pShard->pHead;
+    if (NULL != pEntry)
+    {
+        pShard->pHead = pEntry->pNext;
+    }
+    LAC_SPINUNLOCK(&pShard->lock);
+
+    return pEntry;
+}
+
+CpaStatus icp_sal_DcBufferPoolCreate(
+    CpaInstanceHandle dcInstance,
+    Cpa32U bufferSize,
+    Cpa32U numBuffers,
+    icp_sal_dc_buffer_pool_handle_t *pPoolHandle)
+{
+    CpaInstanceHandle insHandle = NULL;
+    sal_compression_service_t *pService = NULL;
+    dc_buf_pool_t *pPool = NULL;
+    Cpa32U metaSize = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pPoolHandle);
+
+    if (CPA_INSTANCE_HANDLE_SINGLE == dcInstance)
+    {
+        insHandle = dcGetFirstHandle();
+    }
+    else
+    {
+        insHandle = dcInstance;
+    }
+    LAC_CHECK_NULL_PARAM(insHandle);
+    SAL_CHECK_INSTANCE_TYPE(insHandle, SAL_SERVICE_TYPE_COMPRESSION);
+    SAL_RUNNING_CHECK(insHandle);
+    pService = (sal_compression_service_t *)insHandle;
+
+    if (0 == bufferSize)
+    {
+        LAC_INVALID_PARAM_LOG("Invalid bufferSize value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    if (0 == numBuffers)
+    {
+        LAC_INVALID_PARAM_LOG("Invalid numBuffers value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    status = cpaDcBufferListGetMetaSize(insHandle, 1, &metaSize);
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    status = LAC_OS_MALLOC(&pPool, sizeof(dc_buf_pool_t));
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to allocate buffer pool");
+        return status;
+    }
+    osalMemSet(pPool, 0, sizeof(dc_buf_pool_t));
+    pPool->bufferSize = bufferSize;
+
+    pPool->pShards = osalMemAllocAligned(0,
+                                         DC_BUF_POOL_NUM_SHARDS *
+                                             DC_BUF_POOL_SHARD_STRIDE,
+                                         LAC_64BYTE_ALIGNMENT);
+    if (NULL == pPool->pShards)
+    {
+        status = CPA_STATUS_RESOURCE;
+    }
+    else
+    {
+        osalMemSet(pPool->pShards,
+                   0,
+                   DC_BUF_POOL_NUM_SHARDS * DC_BUF_POOL_SHARD_STRIDE);
+    }
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < DC_BUF_POOL_NUM_SHARDS);
+         i++)
+    {
+        status = LAC_SPINLOCK_INIT(&DC_BUF_POOL_SHARD(pPool, i)->lock);
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            pPool->numShardsInit++;
+        }
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = LAC_OS_MALLOC(&pPool->pEntries,
+                               numBuffers * sizeof(dc_buf_pool_entry_t));
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        osalMemSet(
+            pPool->pEntries, 0, numBuffers * sizeof(dc_buf_pool_entry_t));
+        pPool->numBuffers = numBuffers;
+    }
+
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < numBuffers); i++)
+    {
+        dc_buf_pool_entry_t *pEntry = &pPool->pEntries[i];
+
+        pEntry->pPool = pPool;
+        pEntry->bufferList.numBuffers = 1;
+        pEntry->bufferList.pBuffers = &pEntry->flatBuffer;
+        pEntry->buffer.pBufferList = &pEntry->bufferList;
+        pEntry->buffer.bufferSize = bufferSize;
+
+        status = LAC_OS_CAMALLOC(&pEntry->buffer.pData,
+                                 bufferSize,
+                                 LAC_64BYTE_ALIGNMENT,
+                                 pService->nodeAffinity);
+        if ((CPA_STATUS_SUCCESS == status) && (0 != metaSize))
+        {
+            status = LAC_OS_CAMALLOC(&pEntry->bufferList.pPrivateMetaData,
+                                     metaSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            pEntry->flatBuffer.pData = pEntry->buffer.pData;
+            pEntry->flatBuffer.dataLenInBytes = bufferSize;
+            pEntry->buffer.dataPhysAddr = LAC_OS_VIRT_TO_PHYS_EXTERNAL(
+                pService->generic_service_info, pEntry->buffer.pData);
+            if (0 == pEntry->buffer.dataPhysAddr)
+            {
+                LAC_LOG_ERROR("Unable to get the physical address of a "
+                              "buffer");
+                status = CPA_STATUS_FAIL;
+            }
+        }
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            /* Spread the buffers evenly over the shards */
+            dcBufPoolPush(pPool, i % DC_BUF_POOL_NUM_SHARDS, pEntry);
+        }
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to create buffer pool");
+        dcBufPoolFree(pPool);
+        return status;
+    }
+
+    *pPoolHandle = pPool;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcBufferPoolDestroy(
+    icp_sal_dc_buffer_pool_handle_t poolHandle)
+{
+    dc_buf_pool_t *pPool = (dc_buf_pool_t *)poolHandle;
+    Cpa32U i = 0;
+
+    LAC_CHECK_NULL_PARAM(pPool);
+
+    for (i = 0; i < pPool->numBuffers; i++)
+    {
+        if (0 != osalAtomicGet(&pPool->pEntries[i].refCount))
+        {
+            LAC_LOG_ERROR("Buffers of the pool are still held");
+            return CPA_STATUS_RETRY;
+        }
+    }
+
+    dcBufPoolFree(pPool);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcBufferAcquire(icp_sal_dc_buffer_pool_handle_t poolHandle,
+                                  icp_sal_dc_buffer_t **ppBuffer)
+{
+    dc_buf_pool_t *pPool = (dc_buf_pool_t *)poolHandle;
+    dc_buf_pool_entry_t *pEntry = NULL;
+    Cpa32U shard = 0;
+    Cpa32U i = 0;
+
+    LAC_CHECK_NULL_PARAM(pPool);
+    LAC_CHECK_NULL_PARAM(ppBuffer);
+
+    shard = SalStatistics_ShardGet();
+    pEntry = dcBufPoolPop(pPool, shard);
+
+    /* Steal from the other shards when the own one is empty */
+    for (i = 1; (NULL == pEntry) && (i < DC_BUF_POOL_NUM_SHARDS); i++)
+    {
+        pEntry =
+            dcBufPoolPop(pPool, (shard + i) & (DC_BUF_POOL_NUM_SHARDS - 1));
+    }
+    if (NULL == pEntry)
+    {
+        return CPA_STATUS_RETRY;
+    }
+
+    pEntry->flatBuffer.dataLenInBytes = pPool->bufferSize;
+    osalAtomicSet(1, &pEntry->refCount);
+    *ppBuffer = &pEntry->buffer;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcBufferRetain(icp_sal_dc_buffer_t *pBuffer)
+{
+    dc_buf_pool_entry_t *pEntry = (dc_buf_pool_entry_t *)pBuffer;
+    INT64 refCount = 0;
+
+    LAC_CHECK_NULL_PARAM(pEntry);
+
+    /* A buffer without references is back on a free list and may already
+     * belong to another owner, so it must not be revived */
+    do
+    {
+        refCount = osalAtomicGet(&pEntry->refCount);
+        if (refCount <= 0)
+        {
+            LAC_LOG_ERROR("Buffer retained after its last release");
+            return CPA_STATUS_FAIL;
+        }
+    } while (!__sync_bool_compare_and_swap(
+        &pEntry->refCount, refCount, refCount + 1));
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcBufferRelease(icp_sal_dc_buffer_t *pBuffer)
+{
+    dc_buf_pool_entry_t *pEntry = (dc_buf_pool_entry_t *)pBuffer;
+    INT64 refCount = 0;
+
+    LAC_CHECK_NULL_PARAM(pEntry);
+
+    refCount = osalAtomicDec(&pEntry->refCount);
+    if (refCount < 0)
+    {
+        osalAtomicInc(&pEntry->refCount);
+        LAC_LOG_ERROR("Buffer released more times than acquired");
+        return CPA_STATUS_FAIL;
+    }
+    if (0 == refCount)
+    {
+        dcBufPoolPush(pEntry->pPool, SalStatistics_ShardGet(), pEntry);
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
@@ -0,0 +1,837 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_chain_stream.c
+ *
+ * @ingroup SalDcChainStream
+ *
+ * @description
+ *      Implementation of the streaming compress-then-encrypt pipeline.
+ *
+ *      The stream follows the slot ring of dc_stream.c. Every slot owns the
+ *      source, intermediate and destination buffer lists of one chained
+ *      request together with its pinned IV and AAD, so submitting a chunk
+ *      only rewrites the operation data; the request cookies come from the
+ *      chaining service pools and are returned to them on completion.
+ *      Each chunk is compressed with CPA_DC_FLUSH_FINAL, which makes every
+ *      record independently decryptable and decompressible.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "cpa_dc_chain.h"
+#include "cpa_cy_sym.h"
+#include "icp_sal_poll.h"
+#include "icp_sal_dc_chain_stream.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "sal_types_compression.h"
+#include "sal_service_state.h"
+
+#ifndef ICP_DC_ONLY
+
+/* Number of sessions of a compress-then-encrypt chain */
+#define DC_CHAIN_STREAM_NUM_SESSIONS (2)
+
+/* Size of the AAD of a record, a multiple of the AES block size */
+#define DC_CHAIN_STREAM_AAD_SIZE (16)
+
+/* Size of the pinned IV buffer, padded to the AES block size */
+#define DC_CHAIN_STREAM_IV_BUF_SIZE (16)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Chain stream slot
+ *
+ * @description
+ *      One input chunk and the buffers of the chained request it is
+ *      submitted with.
+ *
+ *****************************************************************************/
+typedef struct dc_chain_stream_slot_s
+{
+    CpaBufferList srcList;
+    CpaFlatBuffer srcFlat;
+    CpaBufferList interList;
+    CpaFlatBuffer interFlat;
+    CpaBufferList dstList;
+    CpaFlatBuffer dstFlat;
+    Cpa8U *pSrcData;
+    /**< Pinned input chunk */
+    Cpa8U *pInterData;
+    /**< Pinned staging area of the device between the two operations */
+    Cpa8U *pDstData;
+    /**< Pinned output buffer, ciphertext followed by the tag */
+    Cpa8U *pIvAad;
+    /**< Pinned IV followed by the AAD */
+    Cpa32U fill;
+    /**< Number of input bytes buffered in the chunk */
+    Cpa32U flags;
+    /**< Record flags */
+    CpaDcOpData2 dcOpData;
+    CpaCySymOpData2 cyOpData;
+    CpaDcChainSubOpData2 subOpData[DC_CHAIN_STREAM_NUM_SESSIONS];
+    CpaDcChainRqVResults results;
+    volatile CpaBoolean inFlight;
+    /**< Set while the request is owned by the instance */
+    volatile CpaStatus cbStatus;
+    /**< Status passed to the completion callback */
+} dc_chain_stream_slot_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Chain stream descriptor
+ *
+ * @description
+ *      Slots are used as a ring: requests are submitted at the tail and
+ *      drained, in order, at the head. The tail slot is the one being
+ *      filled by icp_sal_DcChainStreamWrite and is only submitted once
+ *      more data arrives or the stream is finished, so that the last
+ *      record can be flagged.
+ *
+ *****************************************************************************/
+typedef struct dc_chain_stream_s
+{
+    CpaInstanceHandle dcInstance;
+    CpaDcSessionHandle pSessionHandle;
+    icp_sal_dc_chain_stream_output_fn_t pOutputFn;
+    void *pOutputTag;
+    dc_chain_stream_slot_t *pSlots;
+    Cpa8U iv[ICP_SAL_DC_CHAIN_STREAM_IV_SIZE];
+    Cpa32U numSlots;
+    Cpa32U numInFlight;
+    Cpa32U chunkSize;
+    Cpa32U dstSize;
+    Cpa32U head;
+    Cpa32U tail;
+    Cpa32U numSubmitted;
+    Cpa64U sequence;
+    Cpa64U consumed;
+    Cpa64U produced;
+    CpaBoolean finished;
+    CpaBoolean failed;
+} dc_chain_stream_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Store a 32 bit value in big endian order
+ *
+ *****************************************************************************/
+STATIC void dcChainStreamPutBe32(Cpa8U *pDst, Cpa32U value)
+{
+    pDst[0] = (Cpa8U)(value >> 24);
+    pDst[1] = (Cpa8U)(value >> 16);
+    pDst[2] = (Cpa8U)(value >> 8);
+    pDst[3] = (Cpa8U)value;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Completion callback of the chained requests
+ *
+ *****************************************************************************/
+STATIC void dcChainStreamCallback(void *callbackTag, CpaStatus status)
+{
+    dc_chain_stream_slot_t *pSlot = (dc_chain_stream_slot_t *)callbackTag;
+
+    pSlot->cbStatus = status;
+    pSlot->inFlight = CPA_FALSE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Hand a piece of a record to the caller
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcChainStreamEmit(dc_chain_stream_t *pStream,
+                                   const Cpa8U *pData,
+                                   Cpa32U dataLen)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    status = pStream->pOutputFn(pStream->pOutputTag, pData, dataLen);
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Chain stream output function failed");
+        return CPA_STATUS_FAIL;
+    }
+    pStream->produced += dataLen;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Submit the chunk of a slot as record number pStream->sequence
+ *
+ * @description
+ *      Derives the nonce and AAD of the record and rebuilds the operation
+ *      data in place. A full ring is handled by polling the instance and
+ *      resubmitting.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcChainStreamSubmit(dc_chain_stream_t *pStream,
+                                     dc_chain_stream_slot_t *pSlot)
+{
+    Cpa8U *pIv = pSlot->pIvAad;
+    Cpa8U *pAad = pSlot->pIvAad + DC_CHAIN_STREAM_IV_BUF_SIZE;
+    CpaDcChainOpData2 chainOpData = {0};
+    Cpa64U sequence = pStream->sequence;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    osalMemCopy(pIv, pStream->iv, ICP_SAL_DC_CHAIN_STREAM_IV_SIZE);
+    for (i = 0; i < sizeof(Cpa64U); i++)
+    {
+        pIv[ICP_SAL_DC_CHAIN_STREAM_IV_SIZE - 1 - i] ^=
+            (Cpa8U)(sequence >> (8 * i));
+    }
+
+    dcChainStreamPutBe32(pAad, (Cpa32U)(sequence >> 32));
+    dcChainStreamPutBe32(pAad + 4, (Cpa32U)sequence);
+    dcChainStreamPutBe32(pAad + 8, pSlot->fill);
+    dcChainStreamPutBe32(pAad + 12, pSlot->flags);
+
+    pSlot->srcFlat.dataLenInBytes = pSlot->fill;
+    pSlot->interFlat.dataLenInBytes = pStream->dstSize;
+    pSlot->dstFlat.dataLenInBytes = pStream->dstSize;
+
+    osalMemSet(&pSlot->dcOpData, 0, sizeof(CpaDcOpData2));
+    pSlot->dcOpData.dcOpData.flushFlag = CPA_DC_FLUSH_FINAL;
+    pSlot->dcOpData.dcOpData.compressAndVerify = CPA_TRUE;
+
+    osalMemSet(&pSlot->cyOpData, 0, sizeof(CpaCySymOpData2));
+    pSlot->cyOpData.symOpData.packetType = CPA_CY_SYM_PACKET_TYPE_FULL;
+    /* The cipher length is taken from the compression output */
+    pSlot->cyOpData.symOpData.messageLenToCipherInBytes = 0;
+    pSlot->cyOpData.symOpData.pIv = pIv;
+    pSlot->cyOpData.symOpData.ivLenInBytes = ICP_SAL_DC_CHAIN_STREAM_IV_SIZE;
+    pSlot->cyOpData.symOpData.pAdditionalAuthData = pAad;
+
+    pSlot->subOpData[0].opType = CPA_DC_CHAIN_COMPRESS_DECOMPRESS;
+    pSlot->subOpData[0].pDcOp2 = &pSlot->dcOpData;
+    pSlot->subOpData[1].opType = CPA_DC_CHAIN_SYMMETRIC_CRYPTO;
+    pSlot->subOpData[1].pCySymOp2 = &pSlot->cyOpData;
+
+    chainOpData.testIntegrity = CPA_FALSE;
+    chainOpData.operation = CPA_DC_CHAIN_COMPRESS_THEN_AEAD;
+    chainOpData.numOpDatas = DC_CHAIN_STREAM_NUM_SESSIONS;
+    chainOpData.pChainOpData = pSlot->subOpData;
+
+    osalMemSet(&pSlot->results, 0, sizeof(CpaDcChainRqVResults));
+    pSlot->cbStatus = CPA_STATUS_SUCCESS;
+    pSlot->inFlight = CPA_TRUE;
+
+    do
+    {
+        status = cpaDcChainPerformOp2(pStream->dcInstance,
+                                      pStream->pSessionHandle,
+                                      &pSlot->srcList,
+                                      &pSlot->dstList,
+                                      &pSlot->interList,
+                                      chainOpData,
+                                      &pSlot->results,
+                                      pSlot);
+        if (CPA_STATUS_RETRY == status)
+        {
+            icp_sal_DcPollInstance(pStream->dcInstance, 0);
+            osalYield();
+        }
+    } while (CPA_STATUS_RETRY == status);
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pSlot->inFlight = CPA_FALSE;
+        LAC_LOG_ERROR("Failed to submit chain stream request");
+        return status;
+    }
+
+    pStream->sequence++;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Wait for the request of a slot to complete
+ *
+ *****************************************************************************/
+STATIC void dcChainStreamWait(dc_chain_stream_t *pStream,
+                              dc_chain_stream_slot_t *pSlot)
+{
+    while (CPA_TRUE == pSlot->inFlight)
+    {
+        if (CPA_STATUS_SUCCESS !=
+            icp_sal_DcPollInstance(pStream->dcInstance, 0))
+        {
+            osalYield();
+        }
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Drain the oldest outstanding request
+ *
+ * @description
+ *      Waits for the head request and emits its record. The ciphertext
+ *      cannot be resumed, so any request not completed with CPA_DC_OK,
+ *      including an overflow, fails the stream.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcChainStreamDrainHead(dc_chain_stream_t *pStream)
+{
+    dc_chain_stream_slot_t *pSlot = &pStream->pSlots[pStream->head];
+    CpaDcChainRqResults *pResults = &pSlot->results.chainRqResults;
+    Cpa8U header[ICP_SAL_DC_CHAIN_STREAM_RECORD_HDR_SIZE] = {0};
+    Cpa32U payloadLen = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    dcChainStreamWait(pStream, pSlot);
+
+    if ((CPA_STATUS_SUCCESS != pSlot->cbStatus) ||
+        (CPA_STATUS_SUCCESS != pSlot->results.chainStatus) ||
+        (CPA_DC_OK != pResults->dcStatus) ||
+        (CPA_STATUS_SUCCESS != pResults->cyStatus) ||
+        (pResults->consumed != pSlot->fill))
+    {
+        LAC_LOG_ERROR2("Chain stream request failed, dc status %d cy status "
+                       "%d",
+                       pResults->dcStatus,
+                       pResults->cyStatus);
+        return CPA_STATUS_FAIL;
+    }
+
+    payloadLen = pResults->produced + ICP_SAL_DC_CHAIN_STREAM_TAG_SIZE;
+    if (payloadLen > pStream->dstSize)
+    {
+        LAC_LOG_ERROR("Chain stream record exceeds the output buffer");
+        return CPA_STATUS_FAIL;
+    }
+
+    dcChainStreamPutBe32(header, payloadLen);
+    dcChainStreamPutBe32(header + 4, pSlot->fill);
+    dcChainStreamPutBe32(header + 8, pSlot->flags);
+
+    status = dcChainStreamEmit(pStream, header, sizeof(header));
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcChainStreamEmit(pStream, pSlot->pDstData, payloadLen);
+    }
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    pStream->consumed += pSlot->fill;
+    pSlot->fill = 0;
+    pSlot->flags = 0;
+    pStream->head = (pStream->head + 1) % pStream->numSlots;
+    pStream->numSubmitted--;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Submit the tail slot and move on to the next one
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcChainStreamSubmitTail(dc_chain_stream_t *pStream,
+                                         Cpa32U flags)
+{
+    dc_chain_stream_slot_t *pSlot = &pStream->pSlots[pStream->tail];
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    while (pStream->numSubmitted >= pStream->numInFlight)
+    {
+        status = dcChainStreamDrainHead(pStream);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            return status;
+        }
+    }
+
+    pSlot->flags = flags;
+    status = dcChainStreamSubmit(pStream, pSlot);
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        pStream->numSubmitted++;
+        pStream->tail = (pStream->tail + 1) % pStream->numSlots;
+    }
+
+    return status;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Release all resources of a stream
+ *
+ *****************************************************************************/
+STATIC void dcChainStreamFree(dc_chain_stream_t *pStream)
+{
+    Cpa32U i = 0;
+
+    if (NULL != pStream->pSlots)
+    {
+        for (i = 0; i < pStream->numSlots; i++)
+        {
+            dc_chain_stream_slot_t *pSlot = &pStream->pSlots[i];
+
+            LAC_OS_CAFREE(pSlot->pSrcData);
+            LAC_OS_CAFREE(pSlot->pInterData);
+            LAC_OS_CAFREE(pSlot->pDstData);
+            LAC_OS_CAFREE(pSlot->pIvAad);
+            LAC_OS_CAFREE(pSlot->srcList.pPrivateMetaData);
+            LAC_OS_CAFREE(pSlot->interList.pPrivateMetaData);
+            LAC_OS_CAFREE(pSlot->dstList.pPrivateMetaData);
+        }
+        LAC_OS_FREE(pStream->pSlots);
+    }
+    LAC_OS_CAFREE(pStream->pSessionHandle);
+    /* The key is part of the session, clear the copy of the nonce too */
+    osalMemSet(pStream, 0, sizeof(dc_chain_stream_t));
+    LAC_OS_FREE(pStream);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcChainStream
+ *      Allocate a pinned buffer list with a single flat buffer
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcChainStreamAllocList(CpaBufferList *pList,
+                                        CpaFlatBuffer *pFlat,
+                                        Cpa8U **ppData,
+                                        Cpa32U dataSize,
+                                        Cpa32U metaSize,
+                                        Cpa32U node)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    pList->numBuffers = 1;
+    pList->pBuffers = pFlat;
+
+    status = LAC_OS_CAMALLOC(ppData, dataSize, LAC_64BYTE_ALIGNMENT, node);
+    if ((CPA_STATUS_SUCCESS == status) && (0 != metaSize))
+    {
+        status = LAC_OS_CAMALLOC(&pList->pPrivateMetaData,
+                                 metaSize,
+                                 LAC_64BYTE_ALIGNMENT,
+                                 node);
+    }
+    pFlat->pData = *ppData;
+
+    return status;
+}
+
+CpaStatus icp_sal_DcChainStreamCreate(
+    CpaInstanceHandle dcInstance,
+    const icp_sal_dc_chain_stream_setup_t *pSetupData,
+    icp_sal_dc_chain_stream_handle_t *pStreamHandle)
+{
+    CpaInstanceHandle insHandle = NULL;
+    sal_compression_service_t *pService = NULL;
+    dc_chain_stream_t *pStream = NULL;
+    CpaDcInstanceCapabilities cap = {0};
+    CpaDcSessionSetupData dcSetupData = {0};
+    CpaCySymSessionSetupData cySetupData = {0};
+    CpaDcChainSessionSetupData chainSetupData[DC_CHAIN_STREAM_NUM_SESSIONS];
+    Cpa32U sessionSize = 0;
+    Cpa32U metaSize = 0;
+    Cpa32U minDstSize = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pSetupData);
+    LAC_CHECK_NULL_PARAM(pSetupData->pOutputFn);
+    LAC_CHECK_NULL_PARAM(pSetupData->pCipherKey);
+    LAC_CHECK_NULL_PARAM(pStreamHandle);
+
+    if (CPA_INSTANCE_HANDLE_SINGLE == dcInstance)
+    {
+        insHandle = dcGetFirstHandle();
+    }
+    else
+    {
+        insHandle = dcInstance;
+    }
+    LAC_CHECK_NULL_PARAM(insHandle);
+    SAL_CHECK_INSTANCE_TYPE(insHandle, SAL_SERVICE_TYPE_COMPRESSION);
+    SAL_RUNNING_CHECK(insHandle);
+    pService = (sal_compression_service_t *)insHandle;
+
+    if ((16 != pSetupData->cipherKeyLenInBytes) &&
+        (24 != pSetupData->cipherKeyLenInBytes) &&
+        (32 != pSetupData->cipherKeyLenInBytes))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid AES key length");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if ((0 == pSetupData->numInFlight) ||
+        (pSetupData->numInFlight > ICP_SAL_DC_CHAIN_STREAM_MAX_IN_FLIGHT))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid numInFlight value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL == pService->pDcChainService)
+    {
+        return CPA_STATUS_UNSUPPORTED;
+    }
+    status = cpaDcQueryCapabilities(insHandle, &cap);
+    LAC_CHECK_STATUS(status);
+    if (CPA_FALSE == CPA_BITMAP_BIT_TEST(cap.dcChainCapInfo,
+                                         CPA_DC_CHAIN_COMPRESS_THEN_AEAD))
+    {
+        LAC_UNSUPPORTED_PARAM_LOG(
+            "DC Chain operation COMPRESS_THEN_AEAD not supported");
+        return CPA_STATUS_UNSUPPORTED;
+    }
+
+    status = LAC_OS_MALLOC(&pStream, sizeof(dc_chain_stream_t));
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+    osalMemSet(pStream, 0, sizeof(dc_chain_stream_t));
+
+    pStream->dcInstance = insHandle;
+    pStream->pOutputFn = pSetupData->pOutputFn;
+    pStream->pOutputTag = pSetupData->pOutputTag;
+    osalMemCopy(pStream->iv, pSetupData->iv, ICP_SAL_DC_CHAIN_STREAM_IV_SIZE);
+    pStream->chunkSize = (0 == pSetupData->chunkSize)
+                             ? ICP_SAL_DC_CHAIN_STREAM_DEFAULT_CHUNK_SIZE
+                             : pSetupData->chunkSize;
+    pStream->numInFlight = pSetupData->numInFlight;
+    /* One extra slot is filled while the others are in flight */
+    pStream->numSlots = pStream->numInFlight + 1;
+
+    dcSetupData.compLevel = pSetupData->compLevel;
+    dcSetupData.compType = CPA_DC_DEFLATE;
+    dcSetupData.huffType = pSetupData->huffType;
+    dcSetupData.autoSelectBestHuffmanTree = CPA_DC_ASB_DISABLED;
+    dcSetupData.sessDirection = CPA_DC_DIR_COMPRESS;
+    dcSetupData.sessState = CPA_DC_STATELESS;
+    dcSetupData.checksum = CPA_DC_CRC32;
+
+    cySetupData.sessionPriority = CPA_CY_PRIORITY_NORMAL;
+    cySetupData.symOperation = CPA_CY_SYM_OP_ALGORITHM_CHAINING;
+    cySetupData.algChainOrder = CPA_CY_SYM_ALG_CHAIN_ORDER_CIPHER_THEN_HASH;
+    cySetupData.cipherSetupData.cipherAlgorithm = CPA_CY_SYM_CIPHER_AES_GCM;
+    cySetupData.cipherSetupData.pCipherKey = (Cpa8U *)pSetupData->pCipherKey;
+    cySetupData.cipherSetupData.cipherKeyLenInBytes =
+        pSetupData->cipherKeyLenInBytes;
+    cySetupData.cipherSetupData.cipherDirection =
+        CPA_CY_SYM_CIPHER_DIRECTION_ENCRYPT;
+    cySetupData.hashSetupData.hashAlgorithm = CPA_CY_SYM_HASH_AES_GCM;
+    cySetupData.hashSetupData.hashMode = CPA_CY_SYM_HASH_MODE_AUTH;
+    cySetupData.hashSetupData.digestResultLenInBytes =
+        ICP_SAL_DC_CHAIN_STREAM_TAG_SIZE;
+    cySetupData.hashSetupData.authModeSetupData.aadLenInBytes =
+        DC_CHAIN_STREAM_AAD_SIZE;
+    /* The tag follows the ciphertext in the destination buffer */
+    cySetupData.digestIsAppended = CPA_TRUE;
+
+    chainSetupData[0].sessType = CPA_DC_CHAIN_COMPRESS_DECOMPRESS;
+    chainSetupData[0].pDcSetupData = &dcSetupData;
+    chainSetupData[1].sessType = CPA_DC_CHAIN_SYMMETRIC_CRYPTO;
+    chainSetupData[1].pCySetupData = &cySetupData;
+
+    /* Size the output buffers for the worst case expansion of a chunk
+     * followed by the tag */
+    status = cpaDcDeflateCompressBound(insHandle,
+                                       pSetupData->huffType,
+                                       pStream->chunkSize,
+                                       &pStream->dstSize);
+    minDstSize = (CPA_DC_HT_FULL_DYNAMIC == pSetupData->huffType)
+                     ? pService->comp_device_data.minOutputBuffSizeDynamic
+                     : pService->comp_device_data.minOutputBuffSize;
+    if (pStream->dstSize < minDstSize)
+    {
+        pStream->dstSize = minDstSize;
+    }
+    pStream->dstSize += ICP_SAL_DC_CHAIN_STREAM_TAG_SIZE;
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = cpaDcChainGetSessionSize(insHandle,
+                                          CPA_DC_CHAIN_COMPRESS_THEN_AEAD,
+                                          DC_CHAIN_STREAM_NUM_SESSIONS,
+                                          chainSetupData,
+                                          &sessionSize);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = LAC_OS_CAMALLOC(&pStream->pSessionHandle,
+                                 sessionSize,
+                                 LAC_64BYTE_ALIGNMENT,
+                                 pService->nodeAffinity);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = cpaDcBufferListGetMetaSize(insHandle, 1, &metaSize);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status =
+            LAC_OS_MALLOC(&pStream->pSlots,
+                          pStream->numSlots * sizeof(dc_chain_stream_slot_t));
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        osalMemSet(pStream->pSlots,
+                   0,
+                   pStream->numSlots * sizeof(dc_chain_stream_slot_t));
+    }
+
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < pStream->numSlots);
+         i++)
+    {
+        dc_chain_stream_slot_t *pSlot = &pStream->pSlots[i];
+
+        status = dcChainStreamAllocList(&pSlot->srcList,
+                                        &pSlot->srcFlat,
+                                        &pSlot->pSrcData,
+                                        pStream->chunkSize,
+                                        metaSize,
+                                        pService->nodeAffinity);
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            status = dcChainStreamAllocList(&pSlot->interList,
+                                            &pSlot->interFlat,
+                                            &pSlot->pInterData,
+                                            pStream->dstSize,
+                                            metaSize,
+                                            pService->nodeAffinity);
+        }
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            status = dcChainStreamAllocList(&pSlot->dstList,
+                                            &pSlot->dstFlat,
+                                            &pSlot->pDstData,
+                                            pStream->dstSize,
+                                            metaSize,
+                                            pService->nodeAffinity);
+        }
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            status = LAC_OS_CAMALLOC(&pSlot->pIvAad,
+                                     DC_CHAIN_STREAM_IV_BUF_SIZE +
+                                         DC_CHAIN_STREAM_AAD_SIZE,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = cpaDcChainInitSession(insHandle,
+                                       pStream->pSessionHandle,
+                                       CPA_DC_CHAIN_COMPRESS_THEN_AEAD,
+                                       DC_CHAIN_STREAM_NUM_SESSIONS,
+                                       chainSetupData,
+                                       dcChainStreamCallback);
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to create chain stream");
+        dcChainStreamFree(pStream);
+        return status;
+    }
+
+    *pStreamHandle = pStream;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcChainStreamWrite(
+    icp_sal_dc_chain_stream_handle_t streamHandle,
+    const Cpa8U *pData,
+    Cpa32U dataLen)
+{
+    dc_chain_stream_t *pStream = (dc_chain_stream_t *)streamHandle;
+    dc_chain_stream_slot_t *pSlot = NULL;
+    Cpa32U copyLen = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pStream);
+    if (0 != dataLen)
+    {
+        LAC_CHECK_NULL_PARAM(pData);
+    }
+
+    if ((CPA_TRUE == pStream->failed) || (CPA_TRUE == pStream->finished))
+    {
+        return CPA_STATUS_FAIL;
+    }
+
+    while ((CPA_STATUS_SUCCESS == status) && (0 != dataLen))
+    {
+        pSlot = &pStream->pSlots[pStream->tail];
+
+        /* A full chunk is only submitted once it is known not to be the
+         * last one */
+        if (pSlot->fill == pStream->chunkSize)
+        {
+            status = dcChainStreamSubmitTail(pStream, 0);
+            continue;
+        }
+
+        copyLen = pStream->chunkSize - pSlot->fill;
+        if (copyLen > dataLen)
+        {
+            copyLen = dataLen;
+        }
+        osalMemCopy(pSlot->pSrcData + pSlot->fill, pData, copyLen);
+        pSlot->fill += copyLen;
+        pData += copyLen;
+        dataLen -= copyLen;
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pStream->failed = CPA_TRUE;
+    }
+
+    return status;
+}
+
+CpaStatus icp_sal_DcChainStreamFinish(
+    icp_sal_dc_chain_stream_handle_t streamHandle,
+    Cpa64U *pConsumed,
+    Cpa64U *pProduced)
+{
+    dc_chain_stream_t *pStream = (dc_chain_stream_t *)streamHandle;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pStream);
+
+    if ((CPA_TRUE == pStream->failed) || (CPA_TRUE == pStream->finished))
+    {
+        return CPA_STATUS_FAIL;
+    }
+
+    /* Full chunks are held back until more data arrives, so the tail slot
+     * is only empty here when nothing was written. It is still submitted:
+     * the device turns it into an empty final deflate block, and the
+     * reader always finds a record flagged as the last one */
+    status =
+        dcChainStreamSubmitTail(pStream, ICP_SAL_DC_CHAIN_STREAM_RECORD_LAST);
+
+    while ((CPA_STATUS_SUCCESS == status) && (0 != pStream->numSubmitted))
+    {
+        status = dcChainStreamDrainHead(pStream);
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pStream->failed = CPA_TRUE;
+        return status;
+    }
+
+    pStream->finished = CPA_TRUE;
+    if (NULL != pConsumed)
+    {
+        *pConsumed = pStream->consumed;
+    }
+    if (NULL != pProduced)
+    {
+        *pProduced = pStream->produced;
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcChainStreamDestroy(
+    icp_sal_dc_chain_stream_handle_t streamHandle)
+{
+    dc_chain_stream_t *pStream = (dc_chain_stream_t *)streamHandle;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pStream);
+
+    for (i = 0; i < pStream->numSlots; i++)
+    {
+        dcChainStreamWait(pStream, &pStream->pSlots[i]);
+    }
+
+    status =
+        cpaDcChainRemoveSession(pStream->dcInstance, pStream->pSessionHandle);
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        /* The session is still registered with the instance, keep the
+         * stream so that the caller can retry */
+        LAC_LOG_ERROR("Failed to remove chain stream session");
+        return status;
+    }
+
+    dcChainStreamFree(pStream);
+
+    return status;
+}
+
+#endif /* ICP_DC_ONLY */
@@ -0,0 +1,1353 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_cnv_verify.c
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Implementation of the software compress and verify worker pool.
+ *
+ *      The workers decompress the output of a stateless compression request
+ *      on the CPU and compare it with the consumed source data. Deflate data
+ *      is decoded block by block until the final block or the end of the
+ *      produced data, which covers both CPA_DC_FLUSH_FINAL and
+ *      CPA_DC_FLUSH_FULL requests. LZ4 data is decoded as a sequence of LZ4
+ *      frame data blocks, each preceded by its 4 byte size.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "dc_stats.h"
+#include "dc_cnv_verify.h"
+#include "dc_dict.h"
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "lac_mem_pools.h"
+#include "sal_types_compression.h"
+
+/* Deflate limits from RFC 1951 */
+#define DC_CNV_MAX_BITS (15)
+#define DC_CNV_MAX_LCODES (286)
+#define DC_CNV_MAX_DCODES (30)
+#define DC_CNV_FIX_LCODES (288)
+
+/* Codes of up to DC_CNV_FAST_BITS bits are decoded with a single lookup
+ * of the next input bits, longer codes bit by bit */
+#define DC_CNV_FAST_BITS (10)
+#define DC_CNV_FAST_SIZE (1 << DC_CNV_FAST_BITS)
+#define DC_CNV_FAST_SYM_BITS (9)
+#define DC_CNV_FAST_SYM_MASK ((1 << DC_CNV_FAST_SYM_BITS) - 1)
+
+/* The scratch buffers of a worker grow in steps of this size */
+#define DC_CNV_SCRATCH_ALIGN (64 * 1024)
+
+/* Deflate block types */
+#define DC_CNV_BTYPE_STORED (0)
+#define DC_CNV_BTYPE_FIXED (1)
+#define DC_CNV_BTYPE_DYNAMIC (2)
+
+/* LZ4 block format */
+#define DC_CNV_LZ4_BLOCK_SIZE_BYTES (4)
+#define DC_CNV_LZ4_UNCOMPRESSED_BIT (0x80000000)
+#define DC_CNV_LZ4_MIN_MATCH (4)
+#define DC_CNV_LZ4_RUN_MASK (15)
+
+/* Order of the code length code lengths in a dynamic block header */
+static const Cpa8U dcCnvClenOrder[19] = { 16, 17, 18, 0, 8,  7, 9,
+                                          6,  10, 5,  11, 4, 12, 3,
+                                          13, 2,  14, 1,  15 };
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Canonical Huffman decoding table
+ *
+ * @description
+ *      Lookup table of the short codes, plus the number of codes of each
+ *      length and the symbols ordered by code for the long ones.
+ *
+ *****************************************************************************/
+typedef struct dc_cnv_huffman_s
+{
+    Cpa16U fast[DC_CNV_FAST_SIZE];
+    /**< Code length and symbol of the codes of up to DC_CNV_FAST_BITS bits,
+     * indexed by the next input bits. A zero length means a longer code */
+    Cpa16U count[DC_CNV_MAX_BITS + 1];
+    /**< Number of codes of each length */
+    Cpa16U symbol[DC_CNV_FIX_LCODES];
+    /**< Symbols in canonical code order */
+} dc_cnv_huffman_t;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Software decoder state
+ *
+ *****************************************************************************/
+typedef struct dc_cnv_decoder_s
+{
+    const Cpa8U *pIn;
+    /**< Compressed data */
+    Cpa32U inLen;
+    /**< Length of the compressed data */
+    Cpa32U inPos;
+    /**< Next byte of the compressed data to load into bitBuf */
+    Cpa64U bitBuf;
+    /**< Bits read from the compressed data but not consumed yet */
+    Cpa32U bitCnt;
+    /**< Number of valid bits in bitBuf */
+    Cpa8U *pOut;
+    /**< Decompressed data */
+    Cpa32U outLen;
+    /**< Size of the decompressed data buffer */
+    Cpa32U outPos;
+    /**< Number of bytes decompressed so far */
+    CpaBoolean lastBlock;
+    /**< Set once the final deflate block has been decoded */
+} dc_cnv_decoder_t;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Scratch buffers of a verify worker
+ *
+ * @description
+ *      Reused from one request to the next and only grown, so that a
+ *      worker does not allocate memory per request.
+ *
+ *****************************************************************************/
+typedef struct dc_cnv_scratch_s
+{
+    Cpa8U *pIn;
+    /**< Flat copy of a compressed buffer list */
+    Cpa32U inSize;
+    /**< Size of pIn */
+    Cpa8U *pOut;
+    /**< Decompressed data */
+    Cpa32U outSize;
+    /**< Size of pOut */
+} dc_cnv_scratch_t;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Software worker pool
+ *
+ * @description
+ *      Runs the software verification of CnV requests and the other CPU
+ *      stages of the compression service, such as the LZ4s conversion of
+ *      streams.
+ *
+ *****************************************************************************/
+typedef struct dc_cnv_verify_pool_s
+{
+    OsalMutex queueLock;
+    /**< Protects the work queue */
+    OsalSemaphore workSem;
+    /**< Counts the queued work items and the stop requests */
+    OsalSemaphore exitSem;
+    /**< Posted by each worker when it exits */
+    dc_cnv_work_t *pHead;
+    /**< Oldest queued work item */
+    dc_cnv_work_t *pTail;
+    /**< Newest queued work item */
+    Cpa32U refCount;
+    /**< Number of sessions and streams using the pool */
+    Cpa32U numWorkers;
+    /**< Number of running worker threads */
+    CpaBoolean stopping;
+    /**< Set while the last reference holder joins the workers */
+} dc_cnv_verify_pool_t;
+
+static dc_cnv_verify_pool_t dcCnvVerifyPool;
+
+/* Protects refCount and stopping */
+static OsalAtomic dcCnvVerifyPoolLock = 0;
+
+/* Set on the worker threads of the pool */
+static __thread CpaBoolean dcCnvVerifyIsWorker = CPA_FALSE;
+
+/* Set on a worker whose callback released the last reference of the pool,
+ * the stop does not wait for that worker */
+static __thread CpaBoolean dcCnvVerifyDetached = CPA_FALSE;
+
+/* Decoding tables of the fixed Huffman codes, built on first use */
+static dc_cnv_huffman_t dcCnvFixedLenCode;
+static dc_cnv_huffman_t dcCnvFixedDistCode;
+static OsalAtomic dcCnvFixedReady = 0;
+static OsalAtomic dcCnvFixedLock = 0;
+
+STATIC void dcCnvRefill(dc_cnv_decoder_t *pDec)
+{
+    while ((pDec->bitCnt <= 56) && (pDec->inPos < pDec->inLen))
+    {
+        pDec->bitBuf |= (Cpa64U)pDec->pIn[pDec->inPos++] << pDec->bitCnt;
+        pDec->bitCnt += 8;
+    }
+}
+
+STATIC CpaBoolean dcCnvBits(dc_cnv_decoder_t *pDec, Cpa32U need, Cpa32U *pVal)
+{
+    if (pDec->bitCnt < need)
+    {
+        dcCnvRefill(pDec);
+        if (pDec->bitCnt < need)
+        {
+            return CPA_FALSE;
+        }
+    }
+
+    *pVal = (Cpa32U)(pDec->bitBuf & ((1ULL << need) - 1));
+    pDec->bitBuf >>= need;
+    pDec->bitCnt -= need;
+    return CPA_TRUE;
+}
+
+/* Offset of the first compressed byte not fully consumed, the whole bytes
+ * held in bitBuf are not consumed yet */
+STATIC Cpa32U dcCnvInPos(const dc_cnv_decoder_t *pDec)
+{
+    return pDec->inPos - (pDec->bitCnt >> 3);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Build a canonical Huffman decoding table
+ *
+ * @retval CPA_FALSE        The code lengths are over-subscribed
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcCnvHuffmanBuild(dc_cnv_huffman_t *pHuff,
+                                    const Cpa16U *pLength,
+                                    Cpa32U numSymbols)
+{
+    Cpa16U offs[DC_CNV_MAX_BITS + 1];
+    Cpa32S left = 1;
+    Cpa32U len = 0;
+    Cpa32U sym = 0;
+    Cpa32U code = 0;
+    Cpa32U index = 0;
+    Cpa32U rev = 0;
+    Cpa32U bit = 0;
+    Cpa32U i = 0;
+    Cpa16U entry = 0;
+
+    osalMemSet(pHuff->count, 0, sizeof(pHuff->count));
+    for (sym = 0; sym < numSymbols; sym++)
+    {
+        pHuff->count[pLength[sym]]++;
+    }
+
+    for (len = 1; len <= DC_CNV_MAX_BITS; len++)
+    {
+        left <<= 1;
+        left -= pHuff->count[len];
+        if (left < 0)
+        {
+            return CPA_FALSE;
+        }
+    }
+
+    offs[1] = 0;
+    for (len = 1; len < DC_CNV_MAX_BITS; len++)
+    {
+        offs[len + 1] = offs[len] + pHuff->count[len];
+    }
+
+    for (sym = 0; sym < numSymbols; sym++)
+    {
+        if (0 != pLength[sym])
+        {
+            pHuff->symbol[offs[pLength[sym]]++] = (Cpa16U)sym;
+        }
+    }
+
+    /* Deflate sends the codes most significant bit first, so the lookup
+     * index of a code is its bit reversal, repeated for every value of the
+     * bits that follow it */
+    osalMemSet(pHuff->fast, 0, sizeof(pHuff->fast));
+    code = 0;
+    index = 0;
+    for (len = 1; len <= DC_CNV_FAST_BITS; len++)
+    {
+        for (i = 0; i < pHuff->count[len]; i++)
+        {
+            rev = 0;
+            for (bit = 0; bit < len; bit++)
+            {
+                rev |= ((code >> bit) & 1) << (len - 1 - bit);
+            }
+            entry = (Cpa16U)((len << DC_CNV_FAST_SYM_BITS) |
+                             pHuff->symbol[index]);
+            for (; rev < DC_CNV_FAST_SIZE; rev += 1U << len)
+            {
+                pHuff->fast[rev] = entry;
+            }
+            code++;
+            index++;
+        }
+        code <<= 1;
+    }
+
+    /* Incomplete codes are accepted, unused codes fail when decoded */
+    return CPA_TRUE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Decode one symbol of a code longer than DC_CNV_FAST_BITS bits
+ *
+ * @description
+ *      Walks the canonical code bit by bit on the buffered input bits.
+ *      The caller has refilled bitBuf.
+ *
+ * @retval The decoded symbol or -1 if the data does not match the code
+ *
+ *****************************************************************************/
+STATIC Cpa32S dcCnvDecodeSlow(dc_cnv_decoder_t *pDec,
+                              const dc_cnv_huffman_t *pHuff)
+{
+    Cpa32S code = 0;
+    Cpa32S first = 0;
+    Cpa32S index = 0;
+    Cpa32S count = 0;
+    Cpa32U len = 0;
+
+    for (len = 1; (len <= DC_CNV_MAX_BITS) && (len <= pDec->bitCnt); len++)
+    {
+        code |= (Cpa32S)((pDec->bitBuf >> (len - 1)) & 1);
+        count = pHuff->count[len];
+        if (code - count < first)
+        {
+            pDec->bitBuf >>= len;
+            pDec->bitCnt -= len;
+            return pHuff->symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+
+    return -1;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Decode one symbol
+ *
+ * @retval The decoded symbol or -1 if the data does not match the code
+ *
+ *****************************************************************************/
+STATIC Cpa32S dcCnvDecodeSymbol(dc_cnv_decoder_t *pDec,
+                                const dc_cnv_huffman_t *pHuff)
+{
+    Cpa32U entry = 0;
+    Cpa32U len = 0;
+
+    if (pDec->bitCnt < DC_CNV_MAX_BITS)
+    {
+        dcCnvRefill(pDec);
+    }
+
+    entry = pHuff->fast[pDec->bitBuf & (DC_CNV_FAST_SIZE - 1)];
+    len = entry >> DC_CNV_FAST_SYM_BITS;
+    if (0 == len)
+    {
+        return dcCnvDecodeSlow(pDec, pHuff);
+    }
+    /* Near the end of the input the lookup may match on missing bits */
+    if (len > pDec->bitCnt)
+    {
+        return -1;
+    }
+
+    pDec->bitBuf >>= len;
+    pDec->bitCnt -= len;
+    return (Cpa32S)(entry & DC_CNV_FAST_SYM_MASK);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Copy a match of the sliding window
+ *
+ *****************************************************************************/
+STATIC void dcCnvCopyMatch(Cpa8U *pOut, Cpa32U dist, Cpa32U len)
+{
+    if (dist >= len)
+    {
+        osalMemCopy(pOut, pOut - dist, len);
+        return;
+    }
+    /* The copy overlaps its own output */
+    while (len--)
+    {
+        *pOut = *(pOut - dist);
+        pOut++;
+    }
+}
+
+STATIC CpaBoolean dcCnvInflateStored(dc_cnv_decoder_t *pDec)
+{
+    Cpa32U len = 0;
+
+    /* Discard the remaining bits of the current byte and give the whole
+     * bytes held in the bit buffer back to the input */
+    pDec->inPos = dcCnvInPos(pDec);
+    pDec->bitBuf = 0;
+    pDec->bitCnt = 0;
+
+    if (pDec->inPos + 4 > pDec->inLen)
+    {
+        return CPA_FALSE;
+    }
+    len = pDec->pIn[pDec->inPos] | (pDec->pIn[pDec->inPos + 1] << 8);
+    if ((pDec->pIn[pDec->inPos + 2] != (Cpa8U)~len) ||
+        (pDec->pIn[pDec->inPos + 3] != (Cpa8U)(~len >> 8)))
+    {
+        return CPA_FALSE;
+    }
+    pDec->inPos += 4;
+
+    if ((pDec->inPos + len > pDec->inLen) ||
+        (pDec->outPos + len > pDec->outLen))
+    {
+        return CPA_FALSE;
+    }
+    osalMemCopy(pDec->pOut + pDec->outPos, pDec->pIn + pDec->inPos, len);
+    pDec->inPos += len;
+    pDec->outPos += len;
+    return CPA_TRUE;
+}
+
+STATIC CpaBoolean dcCnvInflateCodes(dc_cnv_decoder_t *pDec,
+                                    const dc_cnv_huffman_t *pLenCode,
+                                    const dc_cnv_huffman_t *pDistCode)
+{
+    Cpa32S symbol = 0;
+    Cpa32U len = 0;
+    Cpa32U dist = 0;
+    Cpa32U extra = 0;
+
+    for (;;)
+    {
+        symbol = dcCnvDecodeSymbol(pDec, pLenCode);
+        if (symbol < 0)
+        {
+            return CPA_FALSE;
+        }
+
+        if (symbol < 256)
+        {
+            if (pDec->outPos >= pDec->outLen)
+            {
+                return CPA_FALSE;
+            }
+            pDec->pOut[pDec->outPos++] = (Cpa8U)symbol;
+        }
+        else if (256 == symbol)
+        {
+            return CPA_TRUE;
+        }
+        else
+        {
+            symbol -= 257;
+            if (symbol >= DC_DEFLATE_NUM_LEN_CODES)
+            {
+                return CPA_FALSE;
+            }
+            if (CPA_TRUE !=
+                dcCnvBits(pDec, dcDeflateLenExtra[symbol], &extra))
+            {
+                return CPA_FALSE;
+            }
+            len = dcDeflateLenBase[symbol] + extra;
+
+            symbol = dcCnvDecodeSymbol(pDec, pDistCode);
+            if ((symbol < 0) || (symbol >= DC_CNV_MAX_DCODES))
+            {
+                return CPA_FALSE;
+            }
+            if (CPA_TRUE !=
+                dcCnvBits(pDec, dcDeflateDistExtra[symbol], &extra))
+            {
+                return CPA_FALSE;
+            }
+            dist = dcDeflateDistBase[symbol] + extra;
+
+            if ((dist > pDec->outPos) || (pDec->outPos + len > pDec->outLen))
+            {
+                return CPA_FALSE;
+            }
+            dcCnvCopyMatch(pDec->pOut + pDec->outPos, dist, len);
+            pDec->outPos += len;
+        }
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Build the decoding tables of the fixed Huffman codes
+ *
+ *****************************************************************************/
+STATIC void dcCnvFixedInit(void)
+{
+    Cpa16U lengths[DC_CNV_FIX_LCODES];
+    Cpa32U sym = 0;
+
+    while (osalAtomicTestAndSet(1, &dcCnvFixedLock))
+        ;
+
+    if (0 != osalAtomicGet(&dcCnvFixedReady))
+    {
+        osalAtomicRelease(&dcCnvFixedLock);
+        return;
+    }
+
+    for (sym = 0; sym < 144; sym++)
+    {
+        lengths[sym] = 8;
+    }
+    for (; sym < 256; sym++)
+    {
+        lengths[sym] = 9;
+    }
+    for (; sym < 280; sym++)
+    {
+        lengths[sym] = 7;
+    }
+    for (; sym < DC_CNV_FIX_LCODES; sym++)
+    {
+        lengths[sym] = 8;
+    }
+    dcCnvHuffmanBuild(&dcCnvFixedLenCode, lengths, DC_CNV_FIX_LCODES);
+
+    for (sym = 0; sym < DC_CNV_MAX_DCODES; sym++)
+    {
+        lengths[sym] = 5;
+    }
+    dcCnvHuffmanBuild(&dcCnvFixedDistCode, lengths, DC_CNV_MAX_DCODES);
+
+    osalAtomicSet(1, &dcCnvFixedReady);
+    osalAtomicRelease(&dcCnvFixedLock);
+}
+
+STATIC CpaBoolean dcCnvInflateFixed(dc_cnv_decoder_t *pDec)
+{
+    if (0 == osalAtomicGet(&dcCnvFixedReady))
+    {
+        dcCnvFixedInit();
+    }
+
+    return dcCnvInflateCodes(pDec, &dcCnvFixedLenCode, &dcCnvFixedDistCode);
+}
+
+STATIC CpaBoolean dcCnvInflateDynamic(dc_cnv_decoder_t *pDec)
+{
+    dc_cnv_huffman_t lenCode;
+    dc_cnv_huffman_t distCode;
+    Cpa16U lengths[DC_CNV_MAX_LCODES + DC_CNV_MAX_DCODES];
+    Cpa32U nlen = 0;
+    Cpa32U ndist = 0;
+    Cpa32U ncode = 0;
+    Cpa32U index = 0;
+    Cpa32U val = 0;
+    Cpa32U repeat = 0;
+    Cpa16U prev = 0;
+    Cpa32S symbol = 0;
+
+    if ((CPA_TRUE != dcCnvBits(pDec, 5, &nlen)) ||
+        (CPA_TRUE != dcCnvBits(pDec, 5, &ndist)) ||
+        (CPA_TRUE != dcCnvBits(pDec, 4, &ncode)))
+    {
+        return CPA_FALSE;
+    }
+    nlen += 257;
+    ndist += 1;
+    ncode += 4;
+    if ((nlen > DC_CNV_MAX_LCODES) || (ndist > DC_CNV_MAX_DCODES))
+    {
+        return CPA_FALSE;
+    }
+
+    /* Code length code */
+    for (index = 0; index < 19; index++)
+    {
+        val = 0;
+        if ((index < ncode) && (CPA_TRUE != dcCnvBits(pDec, 3, &val)))
+        {
+            return CPA_FALSE;
+        }
+        lengths[dcCnvClenOrder[index]] = (Cpa16U)val;
+    }
+    if (CPA_TRUE != dcCnvHuffmanBuild(&lenCode, lengths, 19))
+    {
+        return CPA_FALSE;
+    }
+
+    /* Literal/length and distance code lengths */
+    index = 0;
+    while (index < nlen + ndist)
+    {
+        symbol = dcCnvDecodeSymbol(pDec, &lenCode);
+        if (symbol < 0)
+        {
+            return CPA_FALSE;
+        }
+        if (symbol < 16)
+        {
+            lengths[index++] = (Cpa16U)symbol;
+            continue;
+        }
+
+        prev = 0;
+        if (16 == symbol)
+        {
+            if ((0 == index) || (CPA_TRUE != dcCnvBits(pDec, 2, &repeat)))
+            {
+                return CPA_FALSE;
+            }
+            prev = lengths[index - 1];
+            repeat += 3;
+        }
+        else if (17 == symbol)
+        {
+            if (CPA_TRUE != dcCnvBits(pDec, 3, &repeat))
+            {
+                return CPA_FALSE;
+            }
+            repeat += 3;
+        }
+        else
+        {
+            if (CPA_TRUE != dcCnvBits(pDec, 7, &repeat))
+            {
+                return CPA_FALSE;
+            }
+            repeat += 11;
+        }
+
+        if (index + repeat > nlen + ndist)
+        {
+            return CPA_FALSE;
+        }
+        while (repeat--)
+        {
+            lengths[index++] = prev;
+        }
+    }
+
+    /* The end of block code must be present */
+    if (0 == lengths[256])
+    {
+        return CPA_FALSE;
+    }
+
+    if ((CPA_TRUE != dcCnvHuffmanBuild(&lenCode, lengths, nlen)) ||
+        (CPA_TRUE != dcCnvHuffmanBuild(&distCode, lengths + nlen, ndist)))
+    {
+        return CPA_FALSE;
+    }
+
+    return dcCnvInflateCodes(pDec, &lenCode, &distCode);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Decompress raw deflate data
+ *
+ * @description
+ *      Decodes blocks until the final block or, for data that was not
+ *      flushed with CPA_DC_FLUSH_FINAL, until the end of the input.
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcCnvInflate(dc_cnv_decoder_t *pDec)
+{
+    Cpa32U last = 0;
+    Cpa32U type = 0;
+    CpaBoolean ok = CPA_TRUE;
+
+    while ((CPA_TRUE == ok) && (0 == last))
+    {
+        /* The bits left in the last byte are padding */
+        if (dcCnvInPos(pDec) >= pDec->inLen)
+        {
+            break;
+        }
+        if ((CPA_TRUE != dcCnvBits(pDec, 1, &last)) ||
+            (CPA_TRUE != dcCnvBits(pDec, 2, &type)))
+        {
+            return CPA_FALSE;
+        }
+
+        switch (type)
+        {
+            case DC_CNV_BTYPE_STORED:
+                ok = dcCnvInflateStored(pDec);
+                break;
+            case DC_CNV_BTYPE_FIXED:
+                ok = dcCnvInflateFixed(pDec);
+                break;
+            case DC_CNV_BTYPE_DYNAMIC:
+                ok = dcCnvInflateDynamic(pDec);
+                break;
+            default:
+                ok = CPA_FALSE;
+                break;
+        }
+    }
+
+    if ((CPA_TRUE == ok) && (0 != last))
+    {
+        pDec->lastBlock = CPA_TRUE;
+    }
+
+    return ok;
+}
+
+STATIC CpaBoolean dcCnvLz4DecodeBlock(dc_cnv_decoder_t *pDec, Cpa32U blockEnd)
+{
+    Cpa32U token = 0;
+    Cpa32U len = 0;
+    Cpa32U dist = 0;
+    Cpa8U byte = 0;
+
+    while (pDec->inPos < blockEnd)
+    {
+        token = pDec->pIn[pDec->inPos++];
+
+        /* Literals */
+        len = token >> 4;
+        if (DC_CNV_LZ4_RUN_MASK == len)
+        {
+            do
+            {
+                if (pDec->inPos >= blockEnd)
+                {
+                    return CPA_FALSE;
+                }
+                byte = pDec->pIn[pDec->inPos++];
+                len += byte;
+            } while (0xFF == byte);
+        }
+        if ((len > blockEnd - pDec->inPos) ||
+            (len > pDec->outLen - pDec->outPos))
+        {
+            return CPA_FALSE;
+        }
+        osalMemCopy(pDec->pOut + pDec->outPos, pDec->pIn + pDec->inPos, len);
+        pDec->inPos += len;
+        pDec->outPos += len;
+
+        /* The last sequence of a block has no match */
+        if (pDec->inPos == blockEnd)
+        {
+            break;
+        }
+
+        /* Match */
+        if (pDec->inPos + 2 > blockEnd)
+        {
+            return CPA_FALSE;
+        }
+        dist = pDec->pIn[pDec->inPos] | (pDec->pIn[pDec->inPos + 1] << 8);
+        pDec->inPos += 2;
+
+        len = token & DC_CNV_LZ4_RUN_MASK;
+        if (DC_CNV_LZ4_RUN_MASK == len)
+        {
+            do
+            {
+                if (pDec->inPos >= blockEnd)
+                {
+                    return CPA_FALSE;
+                }
+                byte = pDec->pIn[pDec->inPos++];
+                len += byte;
+            } while (0xFF == byte);
+        }
+        len += DC_CNV_LZ4_MIN_MATCH;
+
+        if ((0 == dist) || (dist > pDec->outPos) ||
+            (len > pDec->outLen - pDec->outPos))
+        {
+            return CPA_FALSE;
+        }
+        dcCnvCopyMatch(pDec->pOut + pDec->outPos, dist, len);
+        pDec->outPos += len;
+    }
+
+    return CPA_TRUE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Decompress LZ4 frame data blocks
+ *
+ * @description
+ *      Decodes the data blocks up to the end of the input or an end mark.
+ *      Matches may refer to the previous blocks, which covers sessions
+ *      producing dependent blocks.
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcCnvLz4Decode(dc_cnv_decoder_t *pDec)
+{
+    Cpa32U blockSize = 0;
+    Cpa32U blockEnd = 0;
+
+    while (pDec->inPos < pDec->inLen)
+    {
+        if (pDec->inPos + DC_CNV_LZ4_BLOCK_SIZE_BYTES > pDec->inLen)
+        {
+            return CPA_FALSE;
+        }
+        blockSize = (Cpa32U)pDec->pIn[pDec->inPos] |
+                    ((Cpa32U)pDec->pIn[pDec->inPos + 1] << 8) |
+                    ((Cpa32U)pDec->pIn[pDec->inPos + 2] << 16) |
+                    ((Cpa32U)pDec->pIn[pDec->inPos + 3] << 24);
+        pDec->inPos += DC_CNV_LZ4_BLOCK_SIZE_BYTES;
+
+        if (0 == blockSize)
+        {
+            break;
+        }
+
+        blockEnd = blockSize & ~DC_CNV_LZ4_UNCOMPRESSED_BIT;
+        if (blockEnd > pDec->inLen - pDec->inPos)
+        {
+            return CPA_FALSE;
+        }
+        blockEnd += pDec->inPos;
+
+        if (blockSize & DC_CNV_LZ4_UNCOMPRESSED_BIT)
+        {
+            if (blockEnd - pDec->inPos > pDec->outLen - pDec->outPos)
+            {
+                return CPA_FALSE;
+            }
+            osalMemCopy(pDec->pOut + pDec->outPos,
+                        pDec->pIn + pDec->inPos,
+                        blockEnd - pDec->inPos);
+            pDec->outPos += blockEnd - pDec->inPos;
+            pDec->inPos = blockEnd;
+        }
+        else if (CPA_TRUE != dcCnvLz4DecodeBlock(pDec, blockEnd))
+        {
+            return CPA_FALSE;
+        }
+    }
+
+    return CPA_TRUE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Copy the first bytes of a buffer list into a flat buffer
+ *
+ *****************************************************************************/
+STATIC void dcCnvCopyFromSgl(Cpa8U *pDst,
+                             const CpaBufferList *pBufferList,
+                             Cpa32U len)
+{
+    Cpa32U i = 0;
+    Cpa32U chunk = 0;
+
+    for (i = 0; (i < pBufferList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pBufferList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        osalMemCopy(pDst, pBufferList->pBuffers[i].pData, chunk);
+        pDst += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Compare a flat buffer with the first bytes of a buffer list
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcCnvCompareSgl(const Cpa8U *pData,
+                                  const CpaBufferList *pBufferList,
+                                  Cpa32U len)
+{
+    Cpa32U i = 0;
+    Cpa32U chunk = 0;
+
+    for (i = 0; (i < pBufferList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pBufferList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        if (0 != memcmp(pData, pBufferList->pBuffers[i].pData, chunk))
+        {
+            return CPA_FALSE;
+        }
+        pData += chunk;
+        len -= chunk;
+    }
+
+    return (0 == len) ? CPA_TRUE : CPA_FALSE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Make a scratch buffer at least len bytes long
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcCnvScratchReserve(Cpa8U **ppBuf, Cpa32U *pSize, Cpa32U len)
+{
+    Cpa32U size = 0;
+
+    if (len <= *pSize)
+    {
+        return CPA_STATUS_SUCCESS;
+    }
+
+    size = (len + DC_CNV_SCRATCH_ALIGN - 1) & ~(DC_CNV_SCRATCH_ALIGN - 1);
+    LAC_OS_FREE(*ppBuf);
+    *pSize = 0;
+    if (CPA_STATUS_SUCCESS != LAC_OS_MALLOC(ppBuf, size))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+    *pSize = size;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Verify the output of a compression request
+ *
+ * @description
+ *      Decompresses the produced data and compares it with the consumed
+ *      source data. The produced data is decoded in place when it sits in
+ *      the first buffer of the destination list, otherwise it is gathered
+ *      into the scratch of the worker.
+ *
+ * @retval CPA_STATUS_SUCCESS       The produced data decompresses to the
+ *                                  consumed data
+ * @retval CPA_STATUS_FAIL          The produced data is not valid
+ * @retval CPA_STATUS_RESOURCE      The scratch buffers could not be allocated
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcCnvVerifyData(dc_compression_cookie_t *pCookie,
+                                 dc_cnv_scratch_t *pScratch)
+{
+    dc_cnv_decoder_t dec;
+    CpaDcRqResults *pResults = pCookie->pResults;
+    const CpaBufferList *pDestBuff = pCookie->pUserDestBuff;
+    CpaBoolean ok = CPA_FALSE;
+
+    osalMemSet(&dec, 0, sizeof(dec));
+
+    if (CPA_STATUS_SUCCESS != dcCnvScratchReserve(&pScratch->pOut,
+                                                  &pScratch->outSize,
+                                                  pResults->consumed))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+
+    if ((0 != pDestBuff->numBuffers) &&
+        (pDestBuff->pBuffers[0].dataLenInBytes >= pResults->produced))
+    {
+        dec.pIn = pDestBuff->pBuffers[0].pData;
+    }
+    else
+    {
+        if (CPA_STATUS_SUCCESS != dcCnvScratchReserve(&pScratch->pIn,
+                                                      &pScratch->inSize,
+                                                      pResults->produced))
+        {
+            return CPA_STATUS_RESOURCE;
+        }
+        dcCnvCopyFromSgl(pScratch->pIn, pDestBuff, pResults->produced);
+        dec.pIn = pScratch->pIn;
+    }
+    dec.inLen = pResults->produced;
+    dec.pOut = pScratch->pOut;
+    dec.outLen = pResults->consumed;
+
+    if (CPA_DC_DEFLATE == pCookie->pSessionDesc->compType)
+    {
+        ok = dcCnvInflate(&dec);
+    }
+    else
+    {
+        ok = dcCnvLz4Decode(&dec);
+    }
+
+    if ((CPA_TRUE == ok) && (dec.outPos == dec.outLen))
+    {
+        ok = dcCnvCompareSgl(dec.pOut, pCookie->pUserSrcBuff, dec.outLen);
+    }
+    else
+    {
+        ok = CPA_FALSE;
+    }
+
+    return (CPA_TRUE == ok) ? CPA_STATUS_SUCCESS : CPA_STATUS_FAIL;
+}
+
+CpaBoolean dcCnvInflateBuffer(const Cpa8U *pIn,
+                              Cpa32U inLen,
+                              Cpa8U *pOut,
+                              Cpa32U outLen,
+                              Cpa32U *pConsumed,
+                              Cpa32U *pProduced)
+{
+    dc_cnv_decoder_t dec;
+
+    osalMemSet(&dec, 0, sizeof(dec));
+    dec.pIn = pIn;
+    dec.inLen = inLen;
+    dec.pOut = pOut;
+    dec.outLen = outLen;
+
+    if ((CPA_TRUE != dcCnvInflate(&dec)) || (CPA_TRUE != dec.lastBlock))
+    {
+        return CPA_FALSE;
+    }
+
+    *pConsumed = dcCnvInPos(&dec);
+    *pProduced = dec.outPos;
+
+    return CPA_TRUE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Verify a request and complete it to the user
+ *
+ *****************************************************************************/
+STATIC void dcCnvVerifyComplete(dc_compression_cookie_t *pCookie,
+                                dc_cnv_scratch_t *pScratch)
+{
+    dc_session_desc_t *pSessionDesc = pCookie->pSessionDesc;
+#ifndef DISABLE_DC_STATS
+    sal_compression_service_t *pService =
+        (sal_compression_service_t *)pCookie->dcInstance;
+#endif
+    CpaDcRqResults *pResults = pCookie->pResults;
+    CpaDcCallbackFn pCbFunc = pSessionDesc->pCompressionCb;
+    void *callbackTag = pCookie->callbackTag;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    status = dcCnvVerifyData(pCookie, pScratch);
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        osalAtomicInc(&pSessionDesc->cnvSwVerified);
+    }
+    else
+    {
+        if (CPA_STATUS_RESOURCE == status)
+        {
+            LAC_LOG_ERROR("Cannot allocate software verify buffers");
+        }
+        else
+        {
+            LAC_LOG_ERROR("Software verify of compressed data failed");
+        }
+        osalAtomicInc(&pSessionDesc->cnvSwErrors);
+        COMPRESSION_STAT_INC(numCompCompletedErrors, pService);
+        pResults->status = CPA_DC_VERIFY_ERROR;
+        status = CPA_STATUS_FAIL;
+    }
+
+    osalAtomicDec(&(pSessionDesc->pendingStatelessCbCount));
+    Lac_MemPoolEntryFree(pCookie);
+
+    if (NULL != pCbFunc)
+    {
+        pCbFunc(callbackTag, status);
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Work function of a request waiting for software verification
+ *
+ *****************************************************************************/
+STATIC void dcCnvVerifyWork(void *pWorkArg, dc_cnv_scratch_t *pScratch)
+{
+    dcCnvVerifyComplete((dc_compression_cookie_t *)pWorkArg, pScratch);
+}
+
+STATIC void dcCnvVerifyWorker(void *pArg)
+{
+    dc_cnv_work_t *pWork = NULL;
+    dc_cnv_scratch_t scratch;
+
+    osalMemSet(&scratch, 0, sizeof(scratch));
+    dcCnvVerifyIsWorker = CPA_TRUE;
+
+    for (;;)
+    {
+        osalSemaphoreWait(&dcCnvVerifyPool.workSem, OSAL_WAIT_FOREVER);
+
+        osalMutexLock(&dcCnvVerifyPool.queueLock, OSAL_WAIT_FOREVER);
+        pWork = dcCnvVerifyPool.pHead;
+        if (NULL != pWork)
+        {
+            dcCnvVerifyPool.pHead = pWork->pNext;
+            if (NULL == dcCnvVerifyPool.pHead)
+            {
+                dcCnvVerifyPool.pTail = NULL;
+            }
+        }
+        osalMutexUnlock(&dcCnvVerifyPool.queueLock);
+
+        /* A post without a queued item asks the worker to exit */
+        if (NULL == pWork)
+        {
+            break;
+        }
+        pWork->pWorkFn(pWork->pWorkArg, &scratch);
+
+        /* The pool may be gone, leave without touching it */
+        if (CPA_TRUE == dcCnvVerifyDetached)
+        {
+            LAC_OS_FREE(scratch.pIn);
+            LAC_OS_FREE(scratch.pOut);
+            return;
+        }
+    }
+
+    LAC_OS_FREE(scratch.pIn);
+    LAC_OS_FREE(scratch.pOut);
+    osalSemaphorePost(&dcCnvVerifyPool.exitSem);
+}
+
+STATIC void dcCnvVerifyPoolStop(void)
+{
+    Cpa32U numWorkers = dcCnvVerifyPool.numWorkers;
+    Cpa32U i = 0;
+
+    /* A worker cannot wait for itself to exit, it leaves the pool once its
+     * callback returns */
+    if ((CPA_TRUE == dcCnvVerifyIsWorker) && (0 != numWorkers))
+    {
+        dcCnvVerifyIsWorker = CPA_FALSE;
+        dcCnvVerifyDetached = CPA_TRUE;
+        numWorkers--;
+    }
+
+    for (i = 0; i < numWorkers; i++)
+    {
+        osalSemaphorePost(&dcCnvVerifyPool.workSem);
+    }
+    for (i = 0; i < numWorkers; i++)
+    {
+        osalSemaphoreWait(&dcCnvVerifyPool.exitSem, OSAL_WAIT_FOREVER);
+    }
+    dcCnvVerifyPool.numWorkers = 0;
+
+    osalSemaphoreDestroy(&dcCnvVerifyPool.exitSem);
+    osalSemaphoreDestroy(&dcCnvVerifyPool.workSem);
+    osalMutexDestroy(&dcCnvVerifyPool.queueLock);
+}
+
+STATIC CpaStatus dcCnvVerifyPoolStart(void)
+{
+    OsalThread thread;
+    Cpa32U i = 0;
+
+    dcCnvVerifyPool.pHead = NULL;
+    dcCnvVerifyPool.pTail = NULL;
+    dcCnvVerifyPool.numWorkers = 0;
+
+    if (OSAL_SUCCESS != osalMutexInit(&dcCnvVerifyPool.queueLock))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+    if (OSAL_SUCCESS != osalSemaphoreInit(&dcCnvVerifyPool.workSem, 0))
+    {
+        osalMutexDestroy(&dcCnvVerifyPool.queueLock);
+        return CPA_STATUS_RESOURCE;
+    }
+    if (OSAL_SUCCESS != osalSemaphoreInit(&dcCnvVerifyPool.exitSem, 0))
+    {
+        osalSemaphoreDestroy(&dcCnvVerifyPool.workSem);
+        osalMutexDestroy(&dcCnvVerifyPool.queueLock);
+        return CPA_STATUS_RESOURCE;
+    }
+
+    for (i = 0; i < DC_CNV_VERIFY_NUM_WORKERS; i++)
+    {
+        if ((OSAL_SUCCESS !=
+             osalThreadCreate(&thread, NULL, dcCnvVerifyWorker, NULL)) ||
+            (OSAL_SUCCESS != osalThreadStart(&thread)))
+        {
+            break;
+        }
+        dcCnvVerifyPool.numWorkers++;
+    }
+
+    if (0 == dcCnvVerifyPool.numWorkers)
+    {
+        LAC_LOG_ERROR("Cannot create the software verify threads");
+        dcCnvVerifyPoolStop();
+        return CPA_STATUS_RESOURCE;
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus dcCnvVerifyPoolGet(void)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    for (;;)
+    {
+        while (osalAtomicTestAndSet(1, &dcCnvVerifyPoolLock))
+            ;
+        if (CPA_TRUE != dcCnvVerifyPool.stopping)
+        {
+            break;
+        }
+        osalAtomicRelease(&dcCnvVerifyPoolLock);
+
+        /* The stopping thread may be waiting for this worker */
+        if (CPA_TRUE == dcCnvVerifyIsWorker)
+        {
+            return CPA_STATUS_RETRY;
+        }
+        osalYield();
+    }
+
+    if (0 == dcCnvVerifyPool.refCount)
+    {
+        status = dcCnvVerifyPoolStart();
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        dcCnvVerifyPool.refCount++;
+    }
+
+    osalAtomicRelease(&dcCnvVerifyPoolLock);
+
+    return status;
+}
+
+void dcCnvVerifyPoolPut(void)
+{
+    CpaBoolean stop = CPA_FALSE;
+
+    while (osalAtomicTestAndSet(1, &dcCnvVerifyPoolLock))
+        ;
+    if ((0 != dcCnvVerifyPool.refCount) && (0 == --dcCnvVerifyPool.refCount))
+    {
+        dcCnvVerifyPool.stopping = CPA_TRUE;
+        stop = CPA_TRUE;
+    }
+    osalAtomicRelease(&dcCnvVerifyPoolLock);
+
+    /* The workers are joined without the lock held, as a worker may be
+     * running a callback which removes a session and releases its own
+     * reference */
+    if (CPA_TRUE == stop)
+    {
+        dcCnvVerifyPoolStop();
+
+        while (osalAtomicTestAndSet(1, &dcCnvVerifyPoolLock))
+            ;
+        dcCnvVerifyPool.stopping = CPA_FALSE;
+        osalAtomicRelease(&dcCnvVerifyPoolLock);
+    }
+}
+
+void dcCnvVerifyPoolSubmit(dc_cnv_work_t *pWork)
+{
+    pWork->pNext = NULL;
+
+    osalMutexLock(&dcCnvVerifyPool.queueLock, OSAL_WAIT_FOREVER);
+    if (NULL == dcCnvVerifyPool.pTail)
+    {
+        dcCnvVerifyPool.pHead = pWork;
+    }
+    else
+    {
+        dcCnvVerifyPool.pTail->pNext = pWork;
+    }
+    dcCnvVerifyPool.pTail = pWork;
+    osalMutexUnlock(&dcCnvVerifyPool.queueLock);
+
+    osalSemaphorePost(&dcCnvVerifyPool.workSem);
+}
+
+void dcCnvVerifyEnqueue(dc_compression_cookie_t *pCookie)
+{
+    pCookie->cnvWork.pWorkFn = dcCnvVerifyWork;
+    pCookie->cnvWork.pWorkArg = pCookie;
+    dcCnvVerifyPoolSubmit(&pCookie->cnvWork);
+}
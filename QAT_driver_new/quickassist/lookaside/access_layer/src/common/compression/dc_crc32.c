@@ -50,6 +50,42 @@
 
 #include "dc_crc32.h"
 
+/* Reflected CRC-32 (0x4C11DB7) polynomial */
+#define DC_CRC32_POLY_REFLECTED 0xEDB88320
+/* x^0 in the reflected representation */
+#define DC_CRC32_X0 0x80000000
+
+/**
+ * @description
+ *     Multiplies two polynomials modulo the reflected CRC-32 polynomial
+ *
+ * @param[in]  a      First polynomial, must not be zero
+ * @param[in]  b      Second polynomial
+ *
+ * @retval Cpa32U     a * b modulo the CRC-32 polynomial
+ */
+STATIC Cpa32U dcCrc32MultModP(Cpa32U a, Cpa32U b)
+{
+    Cpa32U m = DC_CRC32_X0;
+    Cpa32U p = 0;
+
+    for (;;)
+    {
+        if (a & m)
+        {
+            p ^= b;
+            if (0 == (a & (m - 1)))
+            {
+                break;
+            }
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ DC_CRC32_POLY_REFLECTED : b >> 1;
+    }
+
+    return p;
+}
+
 /**
  * @description
  *     Calculates CRC-32 checksum for given Buffer List
@@ -101,9 +137,46 @@ Cpa32U dcCalculateCrc32(CpaBufferList *pBufferList,
             consumedBytes = 0;
         }
         currentCrc =
-            crc32_gzip_refl_by8(currentCrc, pBuffer->pData, computeLength);
+            dcCrc32GzipRefl(currentCrc, pBuffer->pData, computeLength);
         pBuffer++;
     }
 
     return currentCrc;
 }
+
+/**
+ * @description
+ *     Combines the CRC-32 of two adjacent blocks of data
+ *
+ *     Given crc1 of block A and crc2 of block B, both started from a zero
+ *     seed, returns the CRC-32 of A followed by B. The CRC of A is shifted
+ *     over the length of B by multiplying it with x^(8 * len2) modulo the
+ *     CRC polynomial, which costs O(log len2) polynomial multiplications.
+ *
+ * @param[in]  crc1           CRC-32 of the first block
+ * @param[in]  crc2           CRC-32 of the second block
+ * @param[in]  len2           Length of the second block in bytes
+ *
+ * @retval Cpa32U             CRC-32 of the concatenated blocks
+ */
+Cpa32U dcCrc32Combine(Cpa32U crc1, Cpa32U crc2, Cpa64U len2)
+{
+    /* x^(2^3) = x^8, the shift of a single byte */
+    Cpa32U x2n = DC_CRC32_X0 >> LAC_NUM_BITS_IN_BYTE;
+    Cpa32U xn = DC_CRC32_X0;
+
+    while (len2)
+    {
+        if (len2 & 1)
+        {
+            xn = dcCrc32MultModP(x2n, xn);
+        }
+        len2 >>= 1;
+        if (len2)
+        {
+            x2n = dcCrc32MultModP(x2n, x2n);
+        }
+    }
+
+    return dcCrc32MultModP(xn, crc1) ^ crc2;
+}
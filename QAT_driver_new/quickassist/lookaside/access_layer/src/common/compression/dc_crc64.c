@@ -72,8 +72,21 @@
 /* Maximum number of possible byte values */
 #define MAX_NUM_BYTE_VALUES 256
 
-/* CRC lookup table is 256 * 64bit entries */
-#define CRC_LOOKUP_TABLE_SIZE_IN_BYTES MAX_NUM_BYTE_VALUES * sizeof(Cpa64U)
+/* Number of bytes folded per iteration by the slice-by-8 loop */
+#define CRC64_NUM_SLICES 8
+
+/* CRC lookup table is 8 slices of 256 * 64bit entries */
+#define CRC_LOOKUP_TABLE_SIZE_IN_BYTES                                         \
+    (CRC64_NUM_SLICES * MAX_NUM_BYTE_VALUES * sizeof(Cpa64U))
+
+/* Get entry 'index' from lookup table slice 'slice' */
+#define CRC64_TABLE(pTable, slice, index)                                      \
+    ((pTable)[((slice)*MAX_NUM_BYTE_VALUES) + ((index)&BYTE_MASK)])
+
+/* Masks used to reflect the bits of every byte of a 64bit word at once */
+#define REFLECT_1BIT_MASK 0x5555555555555555ULL
+#define REFLECT_2BIT_MASK 0x3333333333333333ULL
+#define REFLECT_4BIT_MASK 0x0F0F0F0F0F0F0F0FULL
 
 /**
  * @description
@@ -126,7 +139,7 @@ Cpa64U dcCalculateCrc64(const CpaBufferList *pBufferList,
             consumedBytes = 0;
         }
         currentCrc =
-            crc64_ecma_norm_by8(currentCrc, pBuffer->pData, computeLength);
+            dcCrc64EcmaNorm(currentCrc, pBuffer->pData, computeLength);
         pBuffer++;
     }
 
@@ -191,6 +204,33 @@ STATIC Cpa64U dcSwReflect64(Cpa64U value)
     return reflectVal;
 }
 
+/**
+ * @description
+ *     Reflect each byte of the 64bit input parameter.
+ *
+ *     Equivalent to calling dcSwReflect8() on all eight bytes of the input,
+ *     but done with three mask and shift steps instead of a loop per bit.
+ *
+ *     Example - 64bit input parameter: 0x00000000000000BE
+ *     Becomes:
+ *     64bit parameter with reflected bytes: 0x000000000000007D
+ *
+ * @param[in]  value       64bit input parameter.
+ * @param[out] reflectVal  64bit output with the bits of every byte reflected.
+ */
+STATIC Cpa64U dcSwReflectBytes64(Cpa64U value)
+{
+    Cpa64U reflectVal = value;
+
+    reflectVal = ((reflectVal >> 1) & REFLECT_1BIT_MASK) |
+                 ((reflectVal & REFLECT_1BIT_MASK) << 1);
+    reflectVal = ((reflectVal >> 2) & REFLECT_2BIT_MASK) |
+                 ((reflectVal & REFLECT_2BIT_MASK) << 2);
+    reflectVal = ((reflectVal >> 4) & REFLECT_4BIT_MASK) |
+                 ((reflectVal & REFLECT_4BIT_MASK) << 4);
+    return reflectVal;
+}
+
 /**
  * @description
  *     Creates a lookup table for CRC64 calculation
@@ -198,6 +238,11 @@ STATIC Cpa64U dcSwReflect64(Cpa64U value)
  *     Function creates a lookup table for a given polynomial. This table is
  *     used to speed up CRC64 calculation at runtime.
  *
+ *     The table holds CRC64_NUM_SLICES slices of 256 entries. Slice 0 is the
+ *     classic byte-at-a-time table, slice n gives the CRC contribution of a
+ *     byte followed by n zero bytes, which allows eight input bytes to be
+ *     folded per iteration (slice-by-8).
+ *
  * @param[in]  crc64Polynomial  CRC64 polynomial used for generating the crc
  *                              look up table.
  * @param[out] pCrcLookupTable  Address of pointer to the crc look up table
@@ -213,6 +258,7 @@ CpaStatus dcGenerateLookupTable(Cpa64U crc64Polynomial,
     Cpa32U j = 0;
     Cpa64U i = 0;
     Cpa64U tableEntry = 0;
+    Cpa64U *pTable = NULL;
 
     /* Allocate the CRC64 lookup table */
     *pCrcLookupTable = NULL;
@@ -247,6 +293,22 @@ CpaStatus dcGenerateLookupTable(Cpa64U crc64Polynomial,
         /* Store result in the lookup table */
         (*pCrcLookupTable)[i] = tableEntry;
     }
+
+    /* Derive the remaining slices from the previous one: shift one more
+     * zero byte through the CRC for each slice */
+    pTable = *pCrcLookupTable;
+    for (j = 1; j < CRC64_NUM_SLICES; j++)
+    {
+        for (i = 0; i < MAX_NUM_BYTE_VALUES; i++)
+        {
+            tableEntry = CRC64_TABLE(pTable, j - 1, i);
+            CRC64_TABLE(pTable, j, i) =
+                (tableEntry << NUM_BITS_PER_BYTE) ^
+                CRC64_TABLE(pTable,
+                            0,
+                            tableEntry >> MOST_SIGNIFICANT_BYTE_BIT_INDEX);
+        }
+    }
     return CPA_STATUS_SUCCESS;
 }
 
@@ -255,7 +317,9 @@ CpaStatus dcGenerateLookupTable(Cpa64U crc64Polynomial,
  *     Calculates CRC-64 checksum for the given flat buffer length
  *
  *     Function calculates the 64bit CRC on the given flat buffer for the
- *     requested length.
+ *     requested length, starting from the value held in pCurrentCrc.
+ *     Eight bytes are folded per iteration using the slice-by-8 lookup
+ *     table, remaining bytes are processed one at a time.
  *
  * @param[in]  pCrcConfig           Pointer to the crc configuration used for
  *                                  calculating the checksum.
@@ -264,8 +328,9 @@ CpaStatus dcGenerateLookupTable(Cpa64U crc64Polynomial,
  * @param[in]  pData                Pointer to data byte array to calculate CRC
  *                                  on.
  * @param[in]  computeLength        Total number of bytes to calculate CRC on.
- * @param[out] pCurrentCrc          Pointer to 64bit long CRC checksum for the
- *                                  given flat buffer length.
+ * @param[in,out] pCurrentCrc       Pointer to 64bit long CRC checksum. Holds
+ *                                  the seed on input and the CRC for the
+ *                                  given flat buffer length on output.
  *
  * @retval CPA_STATUS_SUCCESS       Function executed successfully
  * @retval CPA_STATUS_INVALID_PARAM Invalid parameter passed in
@@ -277,7 +342,8 @@ STATIC CpaStatus dcBufferCalculateCrc64(const CpaCrcControlData *pCrcConfig,
                                         Cpa64U *pCurrentCrc)
 {
     Cpa8U nextByte = 0;
-    Cpa8U position = 0;
+    Cpa64U nextWord = 0;
+    Cpa64U crc = 0;
     Cpa64U i = 0;
 
 #ifdef ICP_PARAM_CHECK
@@ -287,7 +353,35 @@ STATIC CpaStatus dcBufferCalculateCrc64(const CpaCrcControlData *pCrcConfig,
     LAC_CHECK_NULL_PARAM(pCrcLookupTable);
 #endif
 
-    *pCurrentCrc = pCrcConfig->initialValue;
+    crc = *pCurrentCrc;
+    for (; computeLength >= CRC64_NUM_SLICES;
+         computeLength -= CRC64_NUM_SLICES, pData += CRC64_NUM_SLICES)
+    {
+        /* Load the next eight bytes, first byte in the most significant
+         * position as the CRC is processed most significant bit first */
+        nextWord = 0;
+        for (i = 0; i < CRC64_NUM_SLICES; i++)
+        {
+            nextWord = (nextWord << NUM_BITS_PER_BYTE) | pData[i];
+        }
+        if (pCrcConfig->reflectIn)
+        {
+            /* Get the byte reflected values */
+            nextWord = dcSwReflectBytes64(nextWord);
+        }
+        nextWord ^= crc;
+
+        /* Fold all eight bytes with one lookup per slice */
+        crc = CRC64_TABLE(pCrcLookupTable, 7, nextWord >> 56) ^
+              CRC64_TABLE(pCrcLookupTable, 6, nextWord >> 48) ^
+              CRC64_TABLE(pCrcLookupTable, 5, nextWord >> 40) ^
+              CRC64_TABLE(pCrcLookupTable, 4, nextWord >> 32) ^
+              CRC64_TABLE(pCrcLookupTable, 3, nextWord >> 24) ^
+              CRC64_TABLE(pCrcLookupTable, 2, nextWord >> 16) ^
+              CRC64_TABLE(pCrcLookupTable, 1, nextWord >> 8) ^
+              CRC64_TABLE(pCrcLookupTable, 0, nextWord);
+    }
+
     for (i = 0; i < computeLength; i++)
     {
         nextByte = pData[i];
@@ -297,15 +391,14 @@ STATIC CpaStatus dcBufferCalculateCrc64(const CpaCrcControlData *pCrcConfig,
             nextByte = dcSwReflect8(nextByte);
         }
 
-        /* Calculate the position in the lookup table */
-        position =
-            ((*pCurrentCrc >> MOST_SIGNIFICANT_BYTE_BIT_INDEX) ^ nextByte) &
-            BYTE_MASK;
-
         /* Generate the crc using the lookup table position */
-        *pCurrentCrc =
-            (*pCurrentCrc << NUM_BITS_PER_BYTE) ^ pCrcLookupTable[position];
+        crc = (crc << NUM_BITS_PER_BYTE) ^
+              CRC64_TABLE(pCrcLookupTable,
+                          0,
+                          (crc >> MOST_SIGNIFICANT_BYTE_BIT_INDEX) ^ nextByte);
     }
+
+    *pCurrentCrc = crc;
     return CPA_STATUS_SUCCESS;
 }
 
@@ -345,6 +438,8 @@ CpaStatus dcCalculateProgCrc64(const CpaCrcControlData *pCrcConfig,
     CpaFlatBuffer *pBuffer = &pBufferList->pBuffers[0];
     CpaStatus status = CPA_STATUS_SUCCESS;
 
+    /* Seed once, the running CRC then carries over between flat buffers */
+    *pSwCrc = pCrcConfig->initialValue;
     for (i = 0; i < pBufferList->numBuffers; i++)
     {
         flatBufferLength = pBuffer->dataLenInBytes;
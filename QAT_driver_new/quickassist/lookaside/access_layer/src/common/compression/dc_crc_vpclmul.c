@@ -0,0 +1,382 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_crc_vpclmul.c
+ *
+ * @defgroup Dc_DataCompression DC Data Compression
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      VPCLMULQDQ/AVX-512 folding kernels for the fixed CRC-32 and CRC-64
+ *      polynomials, selected at runtime over the PCLMULQDQ by8 kernels.
+ *
+ *      The kernels fold 256 bytes per iteration into four 512-bit
+ *      accumulators, i.e. sixteen independent 128-bit fold chains, reduce
+ *      them to a single 128-bit remainder and hand that remainder plus the
+ *      unaligned tail to the by8 kernel for the final reduction. Fold
+ *      constants are x^n mod P for the fold distance n; for the reflected
+ *      CRC-32 they are bit reflected and taken for n - 1 so that the
+ *      carry-less product lands on the reflected bit positions.
+ *
+ *****************************************************************************/
+
+#include "dc_crc32.h"
+#include "dc_crc64.h"
+
+#if !defined(KERNEL_SPACE) && defined(__x86_64__) &&                          \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8))
+#define DC_CRC_VPCLMUL_SUPPORTED
+#endif
+
+#ifdef DC_CRC_VPCLMUL_SUPPORTED
+#include <immintrin.h>
+
+#define DC_CRC_VPCLMUL_TARGET                                                  \
+    __attribute__((target("avx512f,avx512bw,avx512vl,vpclmulqdq,pclmul")))
+
+/* Bytes folded per iteration of the main loop */
+#define DC_CRC_FOLD_BLOCK_SIZE 256
+/* Size of one 512-bit fold lane group */
+#define DC_CRC_FOLD_ZMM_SIZE 64
+/* Size of one 128-bit fold lane */
+#define DC_CRC_FOLD_XMM_SIZE 16
+
+/* CRC-64 ECMA-182 normal fold constants: high qword x^(d + 64) mod P,
+ * low qword x^d mod P, for d = 2048, 512, 384, 256 and 128 bits */
+#define DC_CRC64_K2048_HI 0x7036B0389F6A0C82ULL
+#define DC_CRC64_K2048_LO 0x7F52691A60DDC70DULL
+#define DC_CRC64_K512_HI 0xDDF4B6981205B83FULL
+#define DC_CRC64_K512_LO 0x5F6843CA540DF020ULL
+#define DC_CRC64_K384_HI 0x4A6B90073EB0AF5AULL
+#define DC_CRC64_K384_LO 0x54819D8713758B2CULL
+#define DC_CRC64_K256_HI 0x44BEF2A201B5200CULL
+#define DC_CRC64_K256_LO 0x571BEE0A227EF92BULL
+#define DC_CRC64_K128_HI 0x4EB938A7D257740EULL
+#define DC_CRC64_K128_LO 0x05F5C3C7EB52FAB6ULL
+
+/* CRC-32 gzip reflected fold constants: low qword reflect(x^(d + 63) mod P),
+ * high qword reflect(x^(d - 1) mod P), for the same fold distances */
+#define DC_CRC32_K2048_HI 0x03F9F86300000000ULL
+#define DC_CRC32_K2048_LO 0x7CC8E1E700000000ULL
+#define DC_CRC32_K512_HI 0xCAD38E8F00000000ULL
+#define DC_CRC32_K512_LO 0x653D982200000000ULL
+#define DC_CRC32_K384_HI 0x2A28386200000000ULL
+#define DC_CRC32_K384_LO 0x69CCFC0D00000000ULL
+#define DC_CRC32_K256_HI 0x01B5FD1D00000000ULL
+#define DC_CRC32_K256_LO 0x9570D49500000000ULL
+#define DC_CRC32_K128_HI 0x9BA54C6F00000000ULL
+#define DC_CRC32_K128_LO 0x65673B4600000000ULL
+
+/* Broadcast a pair of fold constants to the four 128-bit lanes */
+#define DC_CRC_FOLD_CONST(hi, lo)                                              \
+    _mm512_broadcast_i32x4(_mm_set_epi64x((long long)(hi), (long long)(lo)))
+
+/**
+ * @description
+ *     Folds every 128-bit lane of x forward by the distance encoded in k
+ *     and adds the 512 bits of data in d.
+ */
+static inline DC_CRC_VPCLMUL_TARGET __m512i dcCrcFold512(__m512i x,
+                                                         __m512i k,
+                                                         __m512i d)
+{
+    return _mm512_ternarylogic_epi64(_mm512_clmulepi64_epi128(x, k, 0x00),
+                                     _mm512_clmulepi64_epi128(x, k, 0x11),
+                                     d,
+                                     0x96);
+}
+
+/**
+ * @description
+ *     128-bit variant of dcCrcFold512().
+ */
+static inline DC_CRC_VPCLMUL_TARGET __m128i dcCrcFold128(__m128i x,
+                                                         __m128i k,
+                                                         __m128i d)
+{
+    return _mm_ternarylogic_epi64(_mm_clmulepi64_si128(x, k, 0x00),
+                                  _mm_clmulepi64_si128(x, k, 0x11),
+                                  d,
+                                  0x96);
+}
+
+/**
+ * @description
+ *     Folds a buffer of at least DC_CRC_FOLD_BLOCK_SIZE bytes down to a
+ *     128-bit remainder congruent to the buffer modulo the CRC polynomial.
+ *
+ *     For the normal (non reflected) polynomial every 128-bit lane is byte
+ *     swapped on load so that the first byte is the most significant one.
+ *     The initial CRC has already been folded into the first lane by the
+ *     caller through 'init'.
+ *
+ * @param[in]     pData      Pointer to the data
+ * @param[in,out] pLen       Length of the data; the number of tail bytes
+ *                           left after the remainder on return
+ * @param[in]     init       Value xored into the first 128-bit lane
+ * @param[in]     pK         Fold constants for 2048, 512, 384, 256 and 128
+ *                           bits
+ * @param[in]     reflected  Whether the CRC is bit reflected
+ *
+ * @retval __m128i           The 128-bit remainder, in load byte order
+ */
+static inline DC_CRC_VPCLMUL_TARGET __m128i dcCrcFoldBuffer(const Cpa8U *pData,
+                                                            Cpa64U *pLen,
+                                                            __m128i init,
+                                                            const __m512i *pK,
+                                                            CpaBoolean reflected)
+{
+    const __m128i swap128 =
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i swap512 = _mm512_broadcast_i32x4(swap128);
+    Cpa64U len = *pLen;
+    __m512i x0, x1, x2, x3;
+    __m128i a0, a1, a2, a3;
+
+#define DC_CRC_LOAD512(p)                                                      \
+    (reflected ? _mm512_loadu_si512((const void *)(p))                        \
+               : _mm512_shuffle_epi8(_mm512_loadu_si512((const void *)(p)),   \
+                                     swap512))
+#define DC_CRC_LOAD128(p)                                                      \
+    (reflected ? _mm_loadu_si128((const __m128i *)(p))                        \
+               : _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p)),      \
+                                  swap128))
+
+    x0 = _mm512_xor_si512(DC_CRC_LOAD512(pData),
+                          _mm512_inserti32x4(_mm512_setzero_si512(), init, 0));
+    x1 = DC_CRC_LOAD512(pData + DC_CRC_FOLD_ZMM_SIZE);
+    x2 = DC_CRC_LOAD512(pData + 2 * DC_CRC_FOLD_ZMM_SIZE);
+    x3 = DC_CRC_LOAD512(pData + 3 * DC_CRC_FOLD_ZMM_SIZE);
+    pData += DC_CRC_FOLD_BLOCK_SIZE;
+    len -= DC_CRC_FOLD_BLOCK_SIZE;
+
+    /* Four independent fold chains, 256 bytes per iteration */
+    while (len >= DC_CRC_FOLD_BLOCK_SIZE)
+    {
+        x0 = dcCrcFold512(x0, pK[0], DC_CRC_LOAD512(pData));
+        x1 = dcCrcFold512(x1, pK[0], DC_CRC_LOAD512(pData + 64));
+        x2 = dcCrcFold512(x2, pK[0], DC_CRC_LOAD512(pData + 128));
+        x3 = dcCrcFold512(x3, pK[0], DC_CRC_LOAD512(pData + 192));
+        pData += DC_CRC_FOLD_BLOCK_SIZE;
+        len -= DC_CRC_FOLD_BLOCK_SIZE;
+    }
+
+    /* Reduce the four accumulators to one, 64 bytes apart each */
+    x1 = dcCrcFold512(x0, pK[1], x1);
+    x2 = dcCrcFold512(x1, pK[1], x2);
+    x3 = dcCrcFold512(x2, pK[1], x3);
+
+    while (len >= DC_CRC_FOLD_ZMM_SIZE)
+    {
+        x3 = dcCrcFold512(x3, pK[1], DC_CRC_LOAD512(pData));
+        pData += DC_CRC_FOLD_ZMM_SIZE;
+        len -= DC_CRC_FOLD_ZMM_SIZE;
+    }
+
+    /* Reduce the four 128-bit lanes onto the last one */
+    a0 = _mm512_extracti32x4_epi32(x3, 0);
+    a1 = _mm512_extracti32x4_epi32(x3, 1);
+    a2 = _mm512_extracti32x4_epi32(x3, 2);
+    a3 = _mm512_extracti32x4_epi32(x3, 3);
+    a3 = dcCrcFold128(a0, _mm512_castsi512_si128(pK[2]), a3);
+    a3 = dcCrcFold128(a1, _mm512_castsi512_si128(pK[3]), a3);
+    a3 = dcCrcFold128(a2, _mm512_castsi512_si128(pK[4]), a3);
+
+    while (len >= DC_CRC_FOLD_XMM_SIZE)
+    {
+        a3 = dcCrcFold128(
+            a3, _mm512_castsi512_si128(pK[4]), DC_CRC_LOAD128(pData));
+        pData += DC_CRC_FOLD_XMM_SIZE;
+        len -= DC_CRC_FOLD_XMM_SIZE;
+    }
+
+#undef DC_CRC_LOAD512
+#undef DC_CRC_LOAD128
+
+    *pLen = len;
+    return reflected ? a3 : _mm_shuffle_epi8(a3, swap128);
+}
+
+/**
+ * @description
+ *     CRC-32 gzip (reflected, inverted) using VPCLMULQDQ folding.
+ *     Same interface and result as crc32_gzip_refl_by8().
+ */
+STATIC DC_CRC_VPCLMUL_TARGET Cpa32U dcCrc32GzipReflVpclmul(Cpa32U crc,
+                                                           const Cpa8U *pData,
+                                                           Cpa64U len)
+{
+    Cpa8U tail[2 * DC_CRC_FOLD_XMM_SIZE];
+    __m512i k[5];
+    __m128i rem;
+    Cpa64U tailLen = len;
+
+    if (len < DC_CRC_FOLD_BLOCK_SIZE)
+    {
+        return crc32_gzip_refl_by8(crc, pData, len);
+    }
+
+    k[0] = DC_CRC_FOLD_CONST(DC_CRC32_K2048_HI, DC_CRC32_K2048_LO);
+    k[1] = DC_CRC_FOLD_CONST(DC_CRC32_K512_HI, DC_CRC32_K512_LO);
+    k[2] = DC_CRC_FOLD_CONST(DC_CRC32_K384_HI, DC_CRC32_K384_LO);
+    k[3] = DC_CRC_FOLD_CONST(DC_CRC32_K256_HI, DC_CRC32_K256_LO);
+    k[4] = DC_CRC_FOLD_CONST(DC_CRC32_K128_HI, DC_CRC32_K128_LO);
+
+    /* The inverted seed is the initial register value; in the reflected
+     * domain it overlays the first 32 message bits */
+    rem = dcCrcFoldBuffer(
+        pData, &tailLen, _mm_cvtsi32_si128((int)~crc), k, CPA_TRUE);
+
+    /* Finish the remainder and the tail bytes with a zero initial
+     * register, i.e. a seed of ~0 for the inverting by8 kernel */
+    _mm_storeu_si128((__m128i *)tail, rem);
+    osalMemCopy(tail + DC_CRC_FOLD_XMM_SIZE, pData + len - tailLen, tailLen);
+    return crc32_gzip_refl_by8(
+        ~(Cpa32U)0, tail, DC_CRC_FOLD_XMM_SIZE + tailLen);
+}
+
+/**
+ * @description
+ *     CRC-64 ECMA-182 normal (no inversion) using VPCLMULQDQ folding.
+ *     Same interface and result as crc64_ecma_norm_by8().
+ */
+STATIC DC_CRC_VPCLMUL_TARGET Cpa64U dcCrc64EcmaNormVpclmul(Cpa64U crc,
+                                                           const Cpa8U *pData,
+                                                           Cpa64U len)
+{
+    Cpa8U tail[2 * DC_CRC_FOLD_XMM_SIZE];
+    __m512i k[5];
+    __m128i rem;
+    Cpa64U tailLen = len;
+
+    if (len < DC_CRC_FOLD_BLOCK_SIZE)
+    {
+        return crc64_ecma_norm_by8(crc, pData, len);
+    }
+
+    k[0] = DC_CRC_FOLD_CONST(DC_CRC64_K2048_HI, DC_CRC64_K2048_LO);
+    k[1] = DC_CRC_FOLD_CONST(DC_CRC64_K512_HI, DC_CRC64_K512_LO);
+    k[2] = DC_CRC_FOLD_CONST(DC_CRC64_K384_HI, DC_CRC64_K384_LO);
+    k[3] = DC_CRC_FOLD_CONST(DC_CRC64_K256_HI, DC_CRC64_K256_LO);
+    k[4] = DC_CRC_FOLD_CONST(DC_CRC64_K128_HI, DC_CRC64_K128_LO);
+
+    /* The seed overlays the first 64 message bits, which sit in the high
+     * qword of the byte swapped first lane */
+    rem = dcCrcFoldBuffer(
+        pData, &tailLen, _mm_set_epi64x((long long)crc, 0), k, CPA_FALSE);
+
+    _mm_storeu_si128((__m128i *)tail, rem);
+    osalMemCopy(tail + DC_CRC_FOLD_XMM_SIZE, pData + len - tailLen, tailLen);
+    return crc64_ecma_norm_by8(0, tail, DC_CRC_FOLD_XMM_SIZE + tailLen);
+}
+
+/**
+ * @description
+ *     Whether the CPU and OS support the 512-bit folding kernels.
+ */
+STATIC CpaBoolean dcCrcVpclmulAvailable(void)
+{
+    __builtin_cpu_init();
+    return (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512vl") &&
+            __builtin_cpu_supports("vpclmulqdq"))
+               ? CPA_TRUE
+               : CPA_FALSE;
+}
+#endif /* DC_CRC_VPCLMUL_SUPPORTED */
+
+typedef Cpa32U (*dc_crc32_kernel_t)(Cpa32U, const Cpa8U *, Cpa64U);
+typedef Cpa64U (*dc_crc64_kernel_t)(Cpa64U, const Cpa8U *, Cpa64U);
+
+STATIC Cpa32U dcCrc32GzipReflResolve(Cpa32U crc,
+                                     const Cpa8U *pData,
+                                     Cpa64U len);
+STATIC Cpa64U dcCrc64EcmaNormResolve(Cpa64U crc,
+                                     const Cpa8U *pData,
+                                     Cpa64U len);
+
+/* Kernels in use. Start at the resolvers, which replace them with the best
+ * kernel for this CPU on first use; concurrent resolution is harmless since
+ * every thread stores the same pointer. */
+STATIC dc_crc32_kernel_t dcCrc32Kernel = dcCrc32GzipReflResolve;
+STATIC dc_crc64_kernel_t dcCrc64Kernel = dcCrc64EcmaNormResolve;
+
+STATIC Cpa32U dcCrc32GzipReflResolve(Cpa32U crc,
+                                     const Cpa8U *pData,
+                                     Cpa64U len)
+{
+    dc_crc32_kernel_t kernel = crc32_gzip_refl_by8;
+
+#ifdef DC_CRC_VPCLMUL_SUPPORTED
+    if (dcCrcVpclmulAvailable())
+    {
+        kernel = dcCrc32GzipReflVpclmul;
+    }
+#endif
+    dcCrc32Kernel = kernel;
+    return kernel(crc, pData, len);
+}
+
+STATIC Cpa64U dcCrc64EcmaNormResolve(Cpa64U crc,
+                                     const Cpa8U *pData,
+                                     Cpa64U len)
+{
+    dc_crc64_kernel_t kernel = crc64_ecma_norm_by8;
+
+#ifdef DC_CRC_VPCLMUL_SUPPORTED
+    if (dcCrcVpclmulAvailable())
+    {
+        kernel = dcCrc64EcmaNormVpclmul;
+    }
+#endif
+    dcCrc64Kernel = kernel;
+    return kernel(crc, pData, len);
+}
+
+Cpa32U dcCrc32GzipRefl(Cpa32U crc, const Cpa8U *pData, Cpa64U len)
+{
+    return dcCrc32Kernel(crc, pData, len);
+}
+
+Cpa64U dcCrc64EcmaNorm(Cpa64U crc, const Cpa8U *pData, Cpa64U len)
+{
+    return dcCrc64Kernel(crc, pData, len);
+}
@@ -87,6 +87,13 @@
 #include "dc_crc64.h"
 #include "sal_misc_error_stats.h"
 #include "sal_hw_gen.h"
+#ifndef KERNEL_SPACE
+#include "dc_cnv_verify.h"
+#include "dc_precheck.h"
+#include "dc_sizing.h"
+#include "dc_inline.h"
+#endif
+#include "dc_dict.h"
 
 
 STATIC OsalAtomic dcErrorCount[MAX_DC_ERROR_TYPE];
@@ -461,6 +468,12 @@ STATIC void dcHandleIntegrityChecksumsGen4(dc_compression_cookie_t *pCookie,
     }
 }
 
+STATIC void dcStatefulPipelineNext(dc_session_desc_t *pSessionDesc,
+                                   CpaBoolean submitNext,
+                                   CpaDcCallbackFn pCbFunc,
+                                   void *callbackTag,
+                                   CpaStatus cbStatus);
+
 CpaStatus dcCompression_CommonProcessCallback(
     icp_qat_fw_comp_resp_t *pCompRespMsg,
     CpaDcRqResults *pResults)
@@ -483,6 +496,7 @@ CpaStatus dcCompression_CommonProcessCallback(
     dc_request_dir_t compDecomp = DC_COMPRESSION_REQUEST;
     Cpa8U opStatus = ICP_QAT_FW_COMN_STATUS_FLAG_OK;
     Cpa8U hdrFlags = 0;
+    CpaBoolean pipelineContinue = CPA_FALSE;
 
 #ifdef ICP_PARAM_CHECK
     LAC_CHECK_NULL_PARAM(pResults);
@@ -559,20 +573,26 @@ CpaStatus dcCompression_CommonProcessCallback(
             /* Decrement number of stateless pending callbacks for session */
             pSessionDesc->pendingDpStatelessCbCount--;
             pResponse->responseStatus = status;
-            (pService->pDcDpCb)(pResponse);
+            DC_DP_COMPLETE(pService, pResponse);
         }
         else
         {
             if (CPA_FALSE == pCookie->dcChain.isDcChaining)
             {
+                if (NULL != pCookie->pDictWrap)
+                {
+                    dcDictWrapRelease(pSessionDesc, pCookie->pDictWrap);
+                }
+
                 /* Decrement number of pending callbacks for session */
                 if (CPA_DC_STATELESS == pSessionDesc->sessState)
                 {
                     osalAtomicDec(
                         &(pCookie->pSessionDesc->pendingStatelessCbCount));
                 }
-                else if (0 != osalAtomicGet(
-                                  &pCookie->pSessionDesc->pendingStatefulCbCount))
+                else if ((pSessionDesc->statefulPipelineDepth <= 1) &&
+                         (0 != osalAtomicGet(&pCookie->pSessionDesc
+                                                  ->pendingStatefulCbCount)))
                 {
                     osalAtomicDec(&(pCookie->pSessionDesc->pendingStatefulCbCount));
                 }
@@ -583,7 +603,13 @@ CpaStatus dcCompression_CommonProcessCallback(
                     Lac_MemPoolEntryFree(pCookie);
                     pCookie = NULL;
                 }
-                if (NULL != pCbFunc)
+                if ((CPA_DC_STATEFUL == pSessionDesc->sessState) &&
+                    (pSessionDesc->statefulPipelineDepth > 1))
+                {
+                    dcStatefulPipelineNext(
+                        pSessionDesc, CPA_FALSE, pCbFunc, callbackTag, status);
+                }
+                else if (NULL != pCbFunc)
                 {
                     pCbFunc(callbackTag, status);
                 }
@@ -872,20 +898,49 @@ CpaStatus dcCompression_CommonProcessCallback(
         /* Decrement number of stateless pending callbacks for session */
         pSessionDesc->pendingDpStatelessCbCount--;
         status = pResponse->responseStatus;
-        (pService->pDcDpCb)(pResponse);
+        DC_DP_COMPLETE(pService, pResponse);
     }
     else
     {
         if (CPA_FALSE == pCookie->dcChain.isDcChaining)
         {
+            if (NULL != pCookie->pDictWrap)
+            {
+                /* Strip the dictionary from the results */
+                dcDictRequestComplete(
+                    pSessionDesc, pCookie->pDictWrap, pResults);
+            }
+#ifndef KERNEL_SPACE
+            if (DC_PRECHECK_NONE != pCookie->precheck)
+            {
+                dcPrecheckComplete(pSessionDesc, pCookie->precheck, pResults);
+            }
+            if ((CPA_TRUE == pSessionDesc->sizingEnabled) &&
+                (DC_COMPRESSION_REQUEST == compDecomp))
+            {
+                dcSizingRecord(pSessionDesc, pResults);
+            }
+            if (CPA_TRUE == pCookie->cnvSwVerify)
+            {
+                if ((CPA_STATUS_SUCCESS == status) &&
+                    (CPA_DC_OK == pResults->status))
+                {
+                    /* The verify pool completes the request to the user */
+                    dcCnvVerifyEnqueue(pCookie);
+                    return status;
+                }
+                osalAtomicInc(&pSessionDesc->cnvNotVerified);
+            }
+#endif
             /* Decrement number of pending callbacks for session */
             if (CPA_DC_STATELESS == pSessionDesc->sessState)
             {
                 osalAtomicDec(
                     &(pCookie->pSessionDesc->pendingStatelessCbCount));
             }
-            else if (0 != osalAtomicGet(
-                              &pCookie->pSessionDesc->pendingStatefulCbCount))
+            else if ((pSessionDesc->statefulPipelineDepth <= 1) &&
+                     (0 != osalAtomicGet(
+                               &pCookie->pSessionDesc->pendingStatefulCbCount)))
             {
                 osalAtomicDec(&(pCookie->pSessionDesc->pendingStatefulCbCount));
             }
@@ -897,7 +952,23 @@ CpaStatus dcCompression_CommonProcessCallback(
                 pCookie = NULL;
             }
 
-            if (NULL != pCbFunc)
+            /* The results may be released by the callback, so decide now
+             * whether the queued stateful requests can follow this one */
+            pipelineContinue = ((CPA_STATUS_SUCCESS == status) &&
+                                (CPA_DC_OK == pResults->status))
+                                   ? CPA_TRUE
+                                   : CPA_FALSE;
+
+            if ((CPA_DC_STATEFUL == pSessionDesc->sessState) &&
+                (pSessionDesc->statefulPipelineDepth > 1))
+            {
+                dcStatefulPipelineNext(pSessionDesc,
+                                       pipelineContinue,
+                                       pCbFunc,
+                                       callbackTag,
+                                       status);
+            }
+            else if (NULL != pCbFunc)
             {
                 pCbFunc(callbackTag, status);
             }
@@ -974,7 +1045,7 @@ CpaStatus dcCompression_SwRespMsgCallback(lac_memblk_bucket_t *pBucket)
     dc_compression_cookie_t *pCookie = NULL;
     CpaDcCallbackFn pCbFunc = NULL;
     CpaStatus status = CPA_STATUS_RETRY;
-#ifndef DISABLE_STATS
+#ifndef DISABLE_DC_STATS
     sal_compression_service_t *pService = NULL;
 #endif
 
@@ -992,7 +1063,7 @@ CpaStatus dcCompression_SwRespMsgCallback(lac_memblk_bucket_t *pBucket)
                                               sizeof(lac_mem_blk_t));
         LAC_LOG_DEBUG1("DC dummy response index = %llx", pCurrentBlk->opaque);
 
-#ifndef DISABLE_STATS
+#ifndef DISABLE_DC_STATS
         pService = (sal_compression_service_t *)(pCookie->dcInstance);
         /* extract fields from request data struct */
         if (DC_COMPRESSION_REQUEST == pCookie->compDecomp)
@@ -1008,12 +1079,28 @@ CpaStatus dcCompression_SwRespMsgCallback(lac_memblk_bucket_t *pBucket)
         {
             osalAtomicDec(&(pCookie->pSessionDesc->pendingStatelessCbCount));
         }
-        else
+        else if (pCookie->pSessionDesc->statefulPipelineDepth <= 1)
         {
             osalAtomicDec(&(pCookie->pSessionDesc->pendingStatefulCbCount));
         }
+        if (NULL != pCookie->pDictWrap)
+        {
+            dcDictWrapRelease(pCookie->pSessionDesc, pCookie->pDictWrap);
+        }
         pCbFunc = pCookie->pSessionDesc->pCompressionCb;
-        pCbFunc(pCookie->callbackTag, CPA_STATUS_FAIL);
+        if ((CPA_DC_STATEFUL == pCookie->pSessionDesc->sessState) &&
+            (pCookie->pSessionDesc->statefulPipelineDepth > 1))
+        {
+            dcStatefulPipelineNext(pCookie->pSessionDesc,
+                                   CPA_FALSE,
+                                   pCbFunc,
+                                   pCookie->callbackTag,
+                                   CPA_STATUS_FAIL);
+        }
+        else
+        {
+            pCbFunc(pCookie->callbackTag, CPA_STATUS_FAIL);
+        }
         Lac_MemPoolEntryFree(pCookie);
     }
 
@@ -1445,6 +1532,9 @@ CpaStatus dcCreateRequest(dc_compression_cookie_t *pCookie,
 #endif
     pCookie->pUserSrcBuff = NULL;
     pCookie->pUserDestBuff = NULL;
+    pCookie->cnvSwVerify = CPA_FALSE;
+    pCookie->pDictWrap = NULL;
+    pCookie->precheck = DC_PRECHECK_NONE;
 
     /* Extract flush flag from either the opData or from the
      * parameter. Opdata have been introduce with APIs
@@ -1810,6 +1900,197 @@ STATIC CpaStatus dcSendRequest(dc_compression_cookie_t *pCookie,
     return status;
 }
 
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Apply the CnV policy of the session to a request
+ *
+ * @description
+ *      Decides whether a stateless compression request asking for CnV is
+ *      verified by the device, left unverified by the sampled policy or
+ *      verified in software once it has completed. The policy counter of
+ *      the session matching the decision is returned rather than updated,
+ *      so that only requests which are sent get counted.
+ *
+ * @param[in]   pSessionDesc        Pointer to the session descriptor
+ * @param[in]   pOpData             Pointer to request information structure
+ * @param[in]   compDecomp          Direction of the operation
+ * @param[in]   cnvMode             CNV Mode requested by the API
+ * @param[out]  pSwVerify           Set when the request is verified in
+ *                                  software
+ * @param[out]  ppCounter           Policy counter to increment once the
+ *                                  request is sent, or NULL
+ *
+ * @retval The CNV Mode to send the request with
+ *
+ *****************************************************************************/
+STATIC dc_cnv_mode_t dcCnvPolicyApply(dc_session_desc_t *pSessionDesc,
+                                      CpaDcOpData *pOpData,
+                                      dc_request_dir_t compDecomp,
+                                      dc_cnv_mode_t cnvMode,
+                                      CpaBoolean *pSwVerify,
+                                      OsalAtomic **ppCounter)
+{
+    Cpa64U count = 0;
+
+    *pSwVerify = CPA_FALSE;
+    *ppCounter = NULL;
+
+    if ((DC_COMPRESSION_REQUEST != compDecomp) || (DC_NO_CNV == cnvMode) ||
+        (CPA_DC_STATELESS != pSessionDesc->sessState))
+    {
+        return cnvMode;
+    }
+
+    /* Error injection and end to end integrity CRCs rely on the device
+     * verification */
+    if ((DC_CNV_POLICY_DEVICE == pSessionDesc->cnvPolicy) ||
+        (ICP_QAT_FW_COMP_CNV_DFX == pSessionDesc->cnvErrorInjection) ||
+        ((NULL != pOpData) && (CPA_TRUE == pOpData->integrityCrcCheck)))
+    {
+        *ppCounter = &pSessionDesc->cnvDeviceVerified;
+        return cnvMode;
+    }
+
+    if (DC_CNV_POLICY_SAMPLED == pSessionDesc->cnvPolicy)
+    {
+        count = osalAtomicInc(&pSessionDesc->cnvSampleCount);
+        if (0 == (count % pSessionDesc->cnvSampleInterval))
+        {
+            *ppCounter = &pSessionDesc->cnvDeviceVerified;
+            return cnvMode;
+        }
+        *ppCounter = &pSessionDesc->cnvNotVerified;
+        return DC_NO_CNV;
+    }
+
+    *pSwVerify = CPA_TRUE;
+    return DC_NO_CNV;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Compress a request of a dictionary session
+ *
+ * @description
+ *      The device has no preset history for stateless compression, so the
+ *      request is encoded in software against the session dictionary and
+ *      completed before returning, as zero length requests are.
+ *
+ * @param[in]   pService            Pointer to the compression service
+ * @param[in]   pSessionDesc        Pointer to the session descriptor
+ * @param[in]   pSrcBuff            Pointer to data buffer for compression
+ * @param[in]   pDestBuff           Pointer to buffer space for data after
+ *                                  compression
+ * @param[in]   pResults            Pointer to results structure
+ * @param[in]   flushFlag           Indicates the type of flush to be
+ *                                  performed
+ * @param[in]   callbackTag         Pointer to the callback tag
+ *
+ * @retval CPA_STATUS_SUCCESS       Function executed successfully
+ * @retval CPA_STATUS_RESOURCE      Resource error
+ * @retval CPA_STATUS_RETRY         The session dictionary was cleared
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcDictCompressData(sal_compression_service_t *pService,
+                                    dc_session_desc_t *pSessionDesc,
+                                    CpaBufferList *pSrcBuff,
+                                    CpaBufferList *pDestBuff,
+                                    CpaDcRqResults *pResults,
+                                    CpaDcFlush flushFlag,
+                                    void *callbackTag)
+{
+    CpaDcCallbackFn pCbFunc = pSessionDesc->pCompressionCb;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+    struct dc_dict_s *pDict = NULL;
+
+    /* The request is pending while it is encoded, so that dcSetDictionary
+     * does not free the dictionary under it. The session lock orders the
+     * count against the dictionary swap. */
+    while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
+        ;
+    osalAtomicInc(&(pSessionDesc->pendingStatelessCbCount));
+    pDict = pSessionDesc->pDict;
+    osalAtomicRelease(&pSessionDesc->sessionLock);
+
+    if (NULL == pDict)
+    {
+        /* The dictionary was cleared since the request was routed here */
+        status = CPA_STATUS_RETRY;
+    }
+    else
+    {
+        status = dcDictCompress(
+            pSessionDesc, pSrcBuff, pDestBuff, pResults, flushFlag);
+    }
+    osalAtomicDec(&(pSessionDesc->pendingStatelessCbCount));
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        COMPRESSION_STAT_INC(numCompRequestsErrors, pService);
+        return status;
+    }
+
+    /* Stateless overflow is a valid compression outcome */
+    COMPRESSION_STAT_INC(numCompRequests, pService);
+    COMPRESSION_STAT_INC(numCompCompleted, pService);
+
+    if ((NULL != pCbFunc) && (LacSync_GenWakeupSyncCaller != pCbFunc))
+    {
+        pCbFunc(callbackTag, CPA_STATUS_SUCCESS);
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+#ifndef KERNEL_SPACE
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Complete a request processed in software
+ *
+ * @description
+ *      The results of the request have been filled in on the CPU, by the
+ *      inline path of small requests or by the compressibility pre-check,
+ *      without going to the device. The request is completed inline; the
+ *      synchronous wrapper is woken up through its callback like a device
+ *      response would.
+ *
+ * @param[in]   pService            Pointer to the compression service
+ * @param[in]   pSessionDesc        Pointer to the session descriptor
+ * @param[in]   callbackTag         Pointer to the callback tag
+ * @param[in]   compDecomp          Direction of the operation
+ *
+ * @retval CPA_STATUS_SUCCESS       Function executed successfully
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcSwCompleteRequest(sal_compression_service_t *pService,
+                                     dc_session_desc_t *pSessionDesc,
+                                     void *callbackTag,
+                                     dc_request_dir_t compDecomp)
+{
+    CpaDcCallbackFn pCbFunc = pSessionDesc->pCompressionCb;
+
+    if (DC_COMPRESSION_REQUEST == compDecomp)
+    {
+        COMPRESSION_STAT_INC(numCompRequests, pService);
+        COMPRESSION_STAT_INC(numCompCompleted, pService);
+    }
+    else
+    {
+        COMPRESSION_STAT_INC(numDecompRequests, pService);
+        COMPRESSION_STAT_INC(numDecompCompleted, pService);
+    }
+
+    if (NULL != pCbFunc)
+    {
+        pCbFunc(callbackTag, CPA_STATUS_SUCCESS);
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+#endif
+
 /**
  *****************************************************************************
  * @ingroup Dc_DataCompression
@@ -1862,6 +2143,32 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
 {
     CpaStatus status = CPA_STATUS_SUCCESS;
     dc_compression_cookie_t *pCookie = NULL;
+    CpaBoolean swVerify = CPA_FALSE;
+    OsalAtomic *pCnvCounter = NULL;
+    void *pDictWrap = NULL;
+#ifndef KERNEL_SPACE
+    dc_precheck_result_t precheck = DC_PRECHECK_NONE;
+#endif
+
+    if (NULL != pSessionDesc->pDict)
+    {
+        if ((NULL != pOpData) && (CPA_TRUE == pOpData->integrityCrcCheck))
+        {
+            LAC_INVALID_PARAM_LOG("Integrity CRCs are not supported with "
+                                  "a dictionary");
+            return CPA_STATUS_UNSUPPORTED;
+        }
+        if (DC_COMPRESSION_REQUEST == compDecomp)
+        {
+            return dcDictCompressData(pService,
+                                      pSessionDesc,
+                                      pSrcBuff,
+                                      pDestBuff,
+                                      pResults,
+                                      flushFlag,
+                                      callbackTag);
+        }
+    }
 
     if ((LacSync_GenWakeupSyncCaller == pSessionDesc->pCompressionCb) &&
         isAsyncMode == CPA_TRUE)
@@ -1925,6 +2232,33 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
         return status;
     }
 
+#ifndef KERNEL_SPACE
+    if (CPA_TRUE == dcInlineProcess(pSessionDesc,
+                                    pSrcBuff,
+                                    pDestBuff,
+                                    pResults,
+                                    flushFlag,
+                                    pOpData,
+                                    compDecomp))
+    {
+        return dcSwCompleteRequest(
+            pService, pSessionDesc, callbackTag, compDecomp);
+    }
+
+    if (DC_COMPRESSION_REQUEST == compDecomp)
+    {
+        precheck =
+            dcPrecheckApply(pSessionDesc, pSrcBuff, pDestBuff, pOpData);
+        if (DC_PRECHECK_INCOMPRESSIBLE == precheck)
+        {
+            dcPrecheckStore(
+                pSessionDesc, pSrcBuff, pDestBuff, pResults, flushFlag);
+            return dcSwCompleteRequest(
+                pService, pSessionDesc, callbackTag, compDecomp);
+        }
+    }
+#endif
+
     /* Allocate the compression cookie
      * The memory is freed in callback or in sendRequest if an error occurs
      */
@@ -1935,6 +2269,12 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
         if (NULL == pCookie)
         {
             LAC_LOG_ERROR("Cannot get mem pool entry for compression");
+            if (CPA_DC_STATEFUL == pSessionDesc->sessState)
+            {
+                /* Release the in-flight slot taken by the caller, as the
+                 * error path below does for a request that was not sent */
+                osalAtomicDec(&(pSessionDesc->pendingStatefulCbCount));
+            }
             status = CPA_STATUS_RESOURCE;
             return status;
         }
@@ -1945,11 +2285,35 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
         }
     } while ((void *)CPA_STATUS_RETRY == pCookie);
 
+    if (NULL != pSessionDesc->pDict)
+    {
+        /* Send the dictionary ahead of the data */
+        status = dcDictWrapRequest(pSessionDesc,
+                                   pSrcBuff,
+                                   pDestBuff,
+                                   pResults,
+                                   &pSrcBuff,
+                                   &pDestBuff,
+                                   &pDictWrap);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            Lac_MemPoolEntryFree(pCookie);
+            return status;
+        }
+    }
+
     if (CPA_STATUS_SUCCESS == status)
     {
         /* Initialize the isDcChaining cookie parameter */
         pCookie->dcChain.isDcChaining = CPA_FALSE;
 
+        cnvMode = dcCnvPolicyApply(pSessionDesc,
+                                   pOpData,
+                                   compDecomp,
+                                   cnvMode,
+                                   &swVerify,
+                                   &pCnvCounter);
+
         status = dcCreateRequest(pCookie,
                                  pService,
                                  pSessionDesc,
@@ -1962,6 +2326,11 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
                                  callbackTag,
                                  compDecomp,
                                  cnvMode);
+        pCookie->cnvSwVerify = swVerify;
+        pCookie->pDictWrap = pDictWrap;
+#ifndef KERNEL_SPACE
+        pCookie->precheck = precheck;
+#endif
     }
 
     if (CPA_STATUS_SUCCESS == status)
@@ -1971,7 +2340,16 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
         {
             osalAtomicInc(&(pSessionDesc->pendingStatelessCbCount));
         }
+        /* Count the request against the CnV policy once it is built */
+        if (NULL != pCnvCounter)
+        {
+            osalAtomicInc(pCnvCounter);
+        }
         status = dcSendRequest(pCookie, pService, pSessionDesc, compDecomp);
+        if ((CPA_STATUS_SUCCESS != status) && (NULL != pCnvCounter))
+        {
+            osalAtomicDec(pCnvCounter);
+        }
     }
 
     if (CPA_STATUS_SUCCESS == status)
@@ -2006,6 +2384,11 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
             osalAtomicDec(&(pSessionDesc->pendingStatefulCbCount));
         }
 
+        if (NULL != pDictWrap)
+        {
+            dcDictWrapRelease(pSessionDesc, pDictWrap);
+        }
+
         /* Free the memory pool */
         if (NULL != pCookie)
         {
@@ -2017,6 +2400,192 @@ STATIC CpaStatus dcCompDecompData(sal_compression_service_t *pService,
     return status;
 }
 
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Queue a stateful request behind the in-flight one
+ *
+ * @description
+ *      Called with the session lock held when a stateful request is already
+ *      in flight on the session. If the session is pipelined and has room,
+ *      the request is queued and will be sent when the previous request of
+ *      the session completes. Requests that may be completed in software
+ *      from the state of the previous request are never queued.
+ *
+ * @retval CPA_STATUS_SUCCESS       Request queued
+ * @retval CPA_STATUS_RETRY         Request cannot be accepted now
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcStatefulPipelineQueue(dc_session_desc_t *pSessionDesc,
+                                         CpaInstanceHandle dcInstance,
+                                         CpaDcSessionHandle pSessionHandle,
+                                         CpaBufferList *pSrcBuff,
+                                         CpaBufferList *pDestBuff,
+                                         CpaDcRqResults *pResults,
+                                         CpaDcFlush flushFlag,
+                                         CpaDcOpData *pOpData,
+                                         void *callbackTag,
+                                         dc_request_dir_t compDecomp,
+                                         Cpa64U srcBuffSize)
+{
+    dc_stateful_pending_req_t *pReq = NULL;
+
+    if (pSessionDesc->statefulPipelineDepth <= 1)
+    {
+        LAC_LOG_ERROR("Only one in-flight stateful request supported");
+        return CPA_STATUS_RETRY;
+    }
+
+    /* Requests that the submit functions may complete in software from the
+     * state registers of the previous request (zero length, and one byte
+     * decompression requests on gen2 devices) cannot be queued, as a queued
+     * request is sent straight to dcCompDecompData */
+    if ((0 == srcBuffSize) ||
+        ((1 == srcBuffSize) && (DC_DECOMPRESSION_REQUEST == compDecomp)) ||
+        (pSessionDesc->pipelineCount + 1 >=
+         pSessionDesc->statefulPipelineDepth))
+    {
+        LAC_LOG_DEBUG("No room for another request on the stateful session");
+        return CPA_STATUS_RETRY;
+    }
+
+    pReq = &pSessionDesc->pipelineQueue[(pSessionDesc->pipelineHead +
+                                         pSessionDesc->pipelineCount) %
+                                        DC_STATEFUL_PIPELINE_MAX_DEPTH];
+    pReq->dcInstance = dcInstance;
+    pReq->pSessionHandle = pSessionHandle;
+    pReq->pSrcBuff = pSrcBuff;
+    pReq->pDestBuff = pDestBuff;
+    pReq->pResults = pResults;
+    pReq->pOpData = pOpData;
+    pReq->callbackTag = callbackTag;
+    pReq->flushFlag = flushFlag;
+    pReq->compDecomp = compDecomp;
+    pSessionDesc->pipelineCount++;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Complete the in-flight request of a pipelined stateful session
+ *
+ * @description
+ *      Called from the completion path of the in-flight stateful request of
+ *      a pipelined session. If submitNext is set, the oldest queued request
+ *      is sent first and inherits the in-flight slot of the session, so the
+ *      device is not left idle while the application runs its callback.
+ *      The callback of the completed request is invoked next. Otherwise, or
+ *      if sending fails, the queued requests are then completed with
+ *      consumed and produced set to zero so that the application can
+ *      resubmit them in order.
+ *
+ * @param[in]   pSessionDesc        Pointer to the session descriptor
+ * @param[in]   submitNext          Whether the previous request completed
+ *                                  with CPA_DC_OK
+ * @param[in]   pCbFunc             Callback of the completed request
+ * @param[in]   callbackTag         Callback tag of the completed request
+ * @param[in]   cbStatus            Status passed to pCbFunc
+ *
+ *****************************************************************************/
+STATIC void dcStatefulPipelineNext(dc_session_desc_t *pSessionDesc,
+                                   CpaBoolean submitNext,
+                                   CpaDcCallbackFn pCbFunc,
+                                   void *callbackTag,
+                                   CpaStatus cbStatus)
+{
+    dc_stateful_pending_req_t cancelled[DC_STATEFUL_PIPELINE_MAX_DEPTH];
+    dc_stateful_pending_req_t req;
+    CpaStatus status = CPA_STATUS_RETRY;
+    dc_cnv_mode_t cnvMode = DC_NO_CNV;
+    Cpa32U numCancelled = 0;
+    Cpa32U i = 0;
+
+    while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
+        ;
+
+    if ((CPA_TRUE == submitNext) && (0 != pSessionDesc->pipelineCount))
+    {
+        req = pSessionDesc->pipelineQueue[pSessionDesc->pipelineHead];
+        pSessionDesc->pipelineHead =
+            (pSessionDesc->pipelineHead + 1) % DC_STATEFUL_PIPELINE_MAX_DEPTH;
+        pSessionDesc->pipelineCount--;
+        osalAtomicRelease(&pSessionDesc->sessionLock);
+
+        if ((DC_COMPRESSION_REQUEST == req.compDecomp) &&
+            (NULL != req.pOpData))
+        {
+            if (CPA_TRUE == req.pOpData->compressAndVerifyAndRecover)
+            {
+                cnvMode = DC_CNVNR;
+            }
+            else if (CPA_TRUE == req.pOpData->compressAndVerify)
+            {
+                cnvMode = DC_CNV;
+            }
+        }
+
+        /* The in-flight count of the session is carried over to this
+         * request, dcCompDecompData releases it if sending fails */
+        status = dcCompDecompData(
+            (sal_compression_service_t *)req.dcInstance,
+            pSessionDesc,
+            req.dcInstance,
+            req.pSessionHandle,
+            req.pSrcBuff,
+            req.pDestBuff,
+            req.pResults,
+            req.flushFlag,
+            req.pOpData,
+            req.callbackTag,
+            req.compDecomp,
+            CPA_TRUE,
+            cnvMode);
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            if (NULL != pCbFunc)
+            {
+                pCbFunc(callbackTag, cbStatus);
+            }
+            return;
+        }
+
+        cancelled[numCancelled++] = req;
+
+        while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
+            ;
+    }
+    else
+    {
+        osalAtomicDec(&(pSessionDesc->pendingStatefulCbCount));
+        status = CPA_STATUS_RETRY;
+    }
+
+    while (0 != pSessionDesc->pipelineCount)
+    {
+        cancelled[numCancelled++] =
+            pSessionDesc->pipelineQueue[pSessionDesc->pipelineHead];
+        pSessionDesc->pipelineHead =
+            (pSessionDesc->pipelineHead + 1) % DC_STATEFUL_PIPELINE_MAX_DEPTH;
+        pSessionDesc->pipelineCount--;
+    }
+    osalAtomicRelease(&pSessionDesc->sessionLock);
+
+    if (NULL != pCbFunc)
+    {
+        pCbFunc(callbackTag, cbStatus);
+    }
+
+    for (i = 0; i < numCancelled; i++)
+    {
+        cancelled[i].pResults->consumed = 0;
+        cancelled[i].pResults->produced = 0;
+        pSessionDesc->pCompressionCb(cancelled[i].callbackTag,
+                                     (0 == i) ? status : CPA_STATUS_RETRY);
+    }
+}
+
 /**
  *****************************************************************************
  * @ingroup Dc_DataCompression
@@ -2520,12 +3089,23 @@ CpaStatus cpaDcCompressData2(CpaInstanceHandle dcInstance,
         while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
             ;
 
-        /* Check if there is already one in-flight stateful request */
+        /* Check if there is already one in-flight stateful request, if so
+         * the request can only be queued on a pipelined session */
         if (0 != osalAtomicGet(&(pSessionDesc->pendingStatefulCbCount)))
         {
-            LAC_LOG_ERROR("Only one in-flight stateful request supported");
+            CpaStatus status = dcStatefulPipelineQueue(pSessionDesc,
+                                                       insHandle,
+                                                       pSessionHandle,
+                                                       pSrcBuff,
+                                                       pDestBuff,
+                                                       pResults,
+                                                       pOpData->flushFlag,
+                                                       pOpData,
+                                                       callbackTag,
+                                                       DC_COMPRESSION_REQUEST,
+                                                       srcBuffSize);
             osalAtomicRelease(&pSessionDesc->sessionLock);
-            return CPA_STATUS_RETRY;
+            return status;
         }
 
         if (0 == srcBuffSize)
@@ -2671,12 +3251,23 @@ CpaStatus cpaDcDecompressData(CpaInstanceHandle dcInstance,
         while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
             ;
 
-        /* Check if there is already one in-flight stateful request */
+        /* Check if there is already one in-flight stateful request, if so
+         * the request can only be queued on a pipelined session */
         if (0 != osalAtomicGet(&(pSessionDesc->pendingStatefulCbCount)))
         {
-            LAC_LOG_ERROR("Only one in-flight stateful request supported");
+            CpaStatus status = dcStatefulPipelineQueue(pSessionDesc,
+                                                       insHandle,
+                                                       pSessionHandle,
+                                                       pSrcBuff,
+                                                       pDestBuff,
+                                                       pResults,
+                                                       flushFlag,
+                                                       NULL,
+                                                       callbackTag,
+                                                       DC_DECOMPRESSION_REQUEST,
+                                                       srcBuffSize);
             osalAtomicRelease(&pSessionDesc->sessionLock);
-            return CPA_STATUS_RETRY;
+            return status;
         }
 
         /* Gen 4 handle 0 len requests in FW */
@@ -2824,12 +3415,23 @@ CpaStatus cpaDcDecompressData2(CpaInstanceHandle dcInstance,
         while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
             ;
 
-        /* Check if there is already one in-flight stateful request */
+        /* Check if there is already one in-flight stateful request, if so
+         * the request can only be queued on a pipelined session */
         if (0 != osalAtomicGet(&(pSessionDesc->pendingStatefulCbCount)))
         {
-            LAC_LOG_ERROR("Only one in-flight stateful request supported");
+            CpaStatus status = dcStatefulPipelineQueue(pSessionDesc,
+                                                       insHandle,
+                                                       pSessionHandle,
+                                                       pSrcBuff,
+                                                       pDestBuff,
+                                                       pResults,
+                                                       pOpData->flushFlag,
+                                                       pOpData,
+                                                       callbackTag,
+                                                       DC_DECOMPRESSION_REQUEST,
+                                                       srcBuffSize);
             osalAtomicRelease(&pSessionDesc->sessionLock);
-            return CPA_STATUS_RETRY;
+            return status;
         }
 
         /* Gen 4 handle 0 len requests in FW */
@@ -0,0 +1,1478 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_dict.c
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Implementation of the preset dictionary support of stateless
+ *      sessions.
+ *
+ *      Decompression requests are processed by the device. The dictionary
+ *      is kept in pinned memory behind the header of a non-final deflate
+ *      stored block or of an uncompressed LZ4 block, and that prefix is
+ *      chained in front of the source data of each request, so the
+ *      dictionary is in the history of the device when it reaches the user
+ *      data. The dictionary produced again by the device is written to a
+ *      discard buffer shared by all the requests of the session.
+ *
+ *      Compression requests are encoded in software with a greedy hash
+ *      chain match finder which looks up both the input and a chain index
+ *      of the dictionary built when the dictionary is set. Deflate data is
+ *      written as a fixed Huffman block, or as stored blocks when that is
+ *      smaller. LZ4 data is written as dependent LZ4 frame data blocks.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "dc_dict.h"
+#include "dc_crc32.h"
+#include "dc_header_cksum_lz4.h"
+#include "icp_buffer_desc.h"
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "sal_types_compression.h"
+
+/* Hash index of the match finder */
+#define DC_DICT_HASH_BITS (12)
+#define DC_DICT_HASH_SIZE (1 << DC_DICT_HASH_BITS)
+#define DC_DICT_HASH_SHIFT (32 - DC_DICT_HASH_BITS)
+#define DC_DICT_HASH_MULT (2654435761U)
+#define DC_DICT_NO_POS (-1)
+
+/* Number of chain entries examined per position */
+#define DC_DICT_MAX_PROBES (32)
+
+/* Deflate limits from RFC 1951 */
+#define DC_DICT_DEFLATE_MIN_MATCH (3)
+#define DC_DICT_DEFLATE_MAX_MATCH (258)
+#define DC_DICT_DEFLATE_MAX_DIST (32768)
+#define DC_DICT_DEFLATE_EOB (256)
+#define DC_DICT_STORED_MAX_LEN (65535)
+#define DC_DICT_STORED_HDR_SIZE (5)
+
+/* LZ4 block format */
+#define DC_DICT_LZ4_MIN_MATCH (4)
+#define DC_DICT_LZ4_MAX_DIST (65535)
+#define DC_DICT_LZ4_LAST_LITERALS (5)
+#define DC_DICT_LZ4_MF_LIMIT (12)
+#define DC_DICT_LZ4_RUN_MASK (15)
+#define DC_DICT_LZ4_BLOCK_HDR_SIZE (4)
+#define DC_DICT_LZ4_UNCOMPRESSED_BIT (0x80000000)
+#define DC_DICT_LZ4_BLOCK_CKSUM_SIZE (4)
+#define DC_DICT_LZ4_64K_SHIFT (16)
+
+#ifndef KERNEL_SPACE
+/* Hash index of dcDictDeflateBuffer, grown with the input up to the size
+ * of the largest inline request */
+#define DC_DICT_BUFFER_MIN_HASH_BITS (6)
+#define DC_DICT_BUFFER_MAX_HASH_BITS (9)
+
+/* Input chain of dcDictDeflateBuffer, older positions are not matched */
+#define DC_DICT_BUFFER_RING_SIZE (1024)
+#endif
+
+/* Adler-32 modulus and largest number of bytes summed before a modulo */
+#define DC_DICT_ADLER32_BASE (65521)
+#define DC_DICT_ADLER32_NMAX (5552)
+
+/* Base lengths of the deflate length codes 257..285 */
+const Cpa16U dcDeflateLenBase[DC_DEFLATE_NUM_LEN_CODES] = {
+    3,  4,  5,  6,  7,  8,  9,  10,  11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const Cpa8U dcDeflateLenExtra[DC_DEFLATE_NUM_LEN_CODES] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+/* Base offsets of the deflate distance codes 0..29 */
+const Cpa16U dcDeflateDistBase[DC_DEFLATE_NUM_DIST_CODES] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577 };
+const Cpa8U dcDeflateDistExtra[DC_DEFLATE_NUM_DIST_CODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Buffer lists of a decompression request on a dictionary session
+ *
+ *****************************************************************************/
+typedef struct dc_dict_wrap_s
+{
+    CpaBufferList srcList;
+    /**< Dictionary prefix followed by the user source buffers */
+    CpaBufferList destList;
+    /**< Discard buffer followed by the user destination buffers */
+    CpaFlatBuffer srcBuffers[DC_DICT_MAX_USER_BUFFERS + 1];
+    /**< Flat buffers of srcList */
+    CpaFlatBuffer destBuffers[DC_DICT_MAX_USER_BUFFERS + 1];
+    /**< Flat buffers of destList */
+    CpaBufferList *pUserDestBuff;
+    /**< User destination buffer list */
+    Cpa32U seedChecksum;
+    /**< Checksum the user data of the request starts from */
+    Cpa32U index;
+    /**< Index of the wrapper in the dictionary */
+} dc_dict_wrap_t;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Preset dictionary of a session
+ *
+ *****************************************************************************/
+typedef struct dc_dict_s
+{
+    Cpa8U *pPrefix;
+    /**< Pinned block header, dictionary and LZ4 block checksum */
+    Cpa32U prefixLen;
+    /**< Length of the prefix */
+    const Cpa8U *pDict;
+    /**< Dictionary, within the prefix */
+    Cpa32U dictLen;
+    /**< Length of the dictionary */
+    Cpa32U dictId;
+    /**< Dictionary id */
+    Cpa8U *pDiscard;
+    /**< Pinned buffer receiving the decompressed dictionary */
+    Cpa32S head[DC_DICT_HASH_SIZE];
+    /**< Most recent dictionary position of each hash, copied as the
+     * starting head table of every request */
+    Cpa32S *pPrev;
+    /**< Previous dictionary position with the same hash */
+    Cpa8U *pScratch;
+    /**< Encoder scratch reused by the requests of the session */
+    Cpa32U scratchSize;
+    /**< Size of pScratch */
+    OsalAtomic scratchLock;
+    /**< Held by the request using pScratch */
+    dc_dict_wrap_t *pWraps;
+    /**< Decompression request wrappers */
+    Cpa8U *pMeta;
+    /**< Pinned private metadata of the wrapper buffer lists */
+    Cpa32U freeWraps[DC_DICT_MAX_IN_FLIGHT];
+    /**< Stack of free wrapper indexes */
+    Cpa32U numFreeWraps;
+    /**< Number of free wrappers */
+    OsalAtomic wrapLock;
+    /**< Protects the free wrapper stack */
+} dc_dict_t;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Software encoder state
+ *
+ *****************************************************************************/
+typedef struct dc_dict_encoder_s
+{
+    const dc_dict_t *pDict;
+    /**< Dictionary, NULL when encoding without one */
+    Cpa32U dictLen;
+    /**< Length of the dictionary, 0 without one */
+    const Cpa8U *pIn;
+    /**< Input data */
+    Cpa32U inLen;
+    /**< Length of the input data */
+    Cpa32S *pHead;
+    /**< Most recent position of each hash. Positions below the dictionary
+     * length are dictionary positions, the input follows the dictionary */
+    Cpa32U hashShift;
+    /**< 32 minus the number of bits of the pHead index */
+    Cpa32S *pPrev;
+    /**< Previous position with the same hash of each input position,
+     * indexed modulo prevMask + 1 */
+    Cpa32U prevMask;
+    /**< Mask of the input position chain */
+    Cpa32U minMatch;
+    /**< Shortest match of the format */
+    Cpa32U maxDist;
+    /**< Largest match distance of the format */
+    Cpa8U *pOut;
+    /**< Output data */
+    Cpa32U outLen;
+    /**< Size of the output buffer */
+    Cpa32U outPos;
+    /**< Number of bytes written */
+    Cpa32U bitBuf;
+    /**< Bits not written yet */
+    Cpa32U bitCnt;
+    /**< Number of valid bits in bitBuf */
+    CpaBoolean overflow;
+    /**< Set when the output did not fit */
+} dc_dict_encoder_t;
+
+STATIC INLINE void dcDictWrite32(Cpa8U *p, Cpa32U val)
+{
+    p[0] = (Cpa8U)val;
+    p[1] = (Cpa8U)(val >> 8);
+    p[2] = (Cpa8U)(val >> 16);
+    p[3] = (Cpa8U)(val >> 24);
+}
+
+STATIC Cpa32U dcDictAdler32(Cpa32U adler, const Cpa8U *pData, Cpa32U len)
+{
+    Cpa32U s1 = adler & 0xFFFF;
+    Cpa32U s2 = adler >> 16;
+    Cpa32U n = 0;
+
+    while (len > 0)
+    {
+        n = (len < DC_DICT_ADLER32_NMAX) ? len : DC_DICT_ADLER32_NMAX;
+        len -= n;
+        while (n--)
+        {
+            s1 += *pData++;
+            s2 += s1;
+        }
+        s1 %= DC_DICT_ADLER32_BASE;
+        s2 %= DC_DICT_ADLER32_BASE;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+Cpa32U dcDictChecksumSgl(CpaDcChecksum checksumType,
+                         CpaBufferList *pBufferList,
+                         Cpa32U len,
+                         Cpa32U seed)
+{
+    dc_xxh32_state_t xxh;
+    Cpa32U checksum = seed;
+    Cpa32U chunk = 0;
+    Cpa32U i = 0;
+
+    if (CPA_DC_CRC32 == checksumType)
+    {
+        return dcCalculateCrc32(pBufferList, len, seed);
+    }
+
+    dcXxh32Init(&xxh, 0);
+    for (i = 0; (i < pBufferList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pBufferList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        if (CPA_DC_ADLER32 == checksumType)
+        {
+            checksum = dcDictAdler32(
+                checksum, pBufferList->pBuffers[i].pData, chunk);
+        }
+        else
+        {
+            dcXxh32Update(&xxh, pBufferList->pBuffers[i].pData, chunk);
+        }
+        len -= chunk;
+    }
+
+    if (CPA_DC_XXHASH32 == checksumType)
+    {
+        checksum = dcXxh32Digest(&xxh);
+    }
+    return checksum;
+}
+
+STATIC INLINE Cpa32U dcDictHash(const Cpa8U *p,
+                                Cpa32U minMatch,
+                                Cpa32U hashShift)
+{
+    Cpa32U val = (Cpa32U)p[0] | ((Cpa32U)p[1] << 8) | ((Cpa32U)p[2] << 16);
+
+    if (DC_DICT_LZ4_MIN_MATCH == minMatch)
+    {
+        val |= (Cpa32U)p[3] << 24;
+    }
+    return (val * DC_DICT_HASH_MULT) >> hashShift;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Length of a match within the input
+ *
+ *****************************************************************************/
+STATIC INLINE Cpa32U dcDictMatchLen(const Cpa8U *pA,
+                                    const Cpa8U *pB,
+                                    Cpa32U limit)
+{
+    Cpa32U len = 0;
+
+    while ((len < limit) && (pA[len] == pB[len]))
+    {
+        len++;
+    }
+    return len;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Find the longest match for an input position
+ *
+ * @description
+ *      Walks the hash chain of the position, through the earlier input
+ *      positions and then the dictionary positions. A dictionary match may
+ *      run past the end of the dictionary into the start of the input.
+ *
+ * @param[in]   pEnc        Encoder state
+ * @param[in]   pos         Input position, at least minMatch bytes before
+ *                          the end of the input
+ * @param[in]   limit       Longest match allowed
+ * @param[out]  pDist       Distance of the match
+ *
+ * @retval Length of the match, 0 if none
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcDictFindMatch(const dc_dict_encoder_t *pEnc,
+                              Cpa32U pos,
+                              Cpa32U limit,
+                              Cpa32U *pDist)
+{
+    const dc_dict_t *pDict = pEnc->pDict;
+    const Cpa8U *pCur = pEnc->pIn + pos;
+    Cpa32U cur = pEnc->dictLen + pos;
+    Cpa32U best = 0;
+    Cpa32U len = 0;
+    Cpa32U dist = 0;
+    Cpa32U tail = 0;
+    Cpa32U probes = 0;
+    Cpa32S cand =
+        pEnc->pHead[dcDictHash(pCur, pEnc->minMatch, pEnc->hashShift)];
+    Cpa32S next = DC_DICT_NO_POS;
+
+    for (probes = 0; (probes < DC_DICT_MAX_PROBES) && (cand >= 0); probes++)
+    {
+        dist = cur - (Cpa32U)cand;
+        if ((0 == dist) || (dist > pEnc->maxDist))
+        {
+            break;
+        }
+        if ((Cpa32U)cand >= pEnc->dictLen)
+        {
+            len = dcDictMatchLen(pCur - dist, pCur, limit);
+            next = pEnc->pPrev[((Cpa32U)cand - pEnc->dictLen) &
+                               pEnc->prevMask];
+        }
+        else
+        {
+            tail = pEnc->dictLen - (Cpa32U)cand;
+            len = dcDictMatchLen(
+                pDict->pDict + cand, pCur, (tail < limit) ? tail : limit);
+            if ((len == tail) && (len < limit))
+            {
+                /* The match continues from the start of the input */
+                len += dcDictMatchLen(pEnc->pIn, pCur + len, limit - len);
+            }
+            next = pDict->pPrev[cand];
+        }
+        if (len > best)
+        {
+            best = len;
+            *pDist = dist;
+            if (len == limit)
+            {
+                break;
+            }
+        }
+        if (next >= cand)
+        {
+            /* Entry overwritten by a more recent position */
+            break;
+        }
+        cand = next;
+    }
+
+    return (best >= pEnc->minMatch) ? best : 0;
+}
+
+STATIC INLINE void dcDictInsert(dc_dict_encoder_t *pEnc, Cpa32U pos)
+{
+    Cpa32U hash = 0;
+
+    if (pos + pEnc->minMatch <= pEnc->inLen)
+    {
+        hash = dcDictHash(pEnc->pIn + pos, pEnc->minMatch, pEnc->hashShift);
+        pEnc->pPrev[pos & pEnc->prevMask] = pEnc->pHead[hash];
+        pEnc->pHead[hash] = (Cpa32S)(pEnc->dictLen + pos);
+    }
+}
+
+STATIC void dcDictPutBits(dc_dict_encoder_t *pEnc, Cpa32U val, Cpa32U n)
+{
+    pEnc->bitBuf |= val << pEnc->bitCnt;
+    pEnc->bitCnt += n;
+    while (pEnc->bitCnt >= 8)
+    {
+        if (pEnc->outPos >= pEnc->outLen)
+        {
+            pEnc->overflow = CPA_TRUE;
+            pEnc->bitCnt = 0;
+            pEnc->bitBuf = 0;
+            return;
+        }
+        pEnc->pOut[pEnc->outPos++] = (Cpa8U)pEnc->bitBuf;
+        pEnc->bitBuf >>= 8;
+        pEnc->bitCnt -= 8;
+    }
+}
+
+STATIC void dcDictFlushBits(dc_dict_encoder_t *pEnc)
+{
+    if (0 != pEnc->bitCnt)
+    {
+        dcDictPutBits(pEnc, 0, 8 - pEnc->bitCnt);
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Write a Huffman code, most significant bit first
+ *
+ *****************************************************************************/
+STATIC void dcDictPutCode(dc_dict_encoder_t *pEnc, Cpa32U code, Cpa32U len)
+{
+    Cpa32U rev = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        rev = (rev << 1) | ((code >> i) & 1);
+    }
+    dcDictPutBits(pEnc, rev, len);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Write a literal/length symbol with the fixed Huffman code
+ *
+ *****************************************************************************/
+STATIC void dcDictPutFixedSymbol(dc_dict_encoder_t *pEnc, Cpa32U sym)
+{
+    if (sym < 144)
+    {
+        dcDictPutCode(pEnc, 0x30 + sym, 8);
+    }
+    else if (sym < 256)
+    {
+        dcDictPutCode(pEnc, 0x190 + (sym - 144), 9);
+    }
+    else if (sym < 280)
+    {
+        dcDictPutCode(pEnc, sym - 256, 7);
+    }
+    else
+    {
+        dcDictPutCode(pEnc, 0xC0 + (sym - 280), 8);
+    }
+}
+
+STATIC void dcDictPutFixedMatch(dc_dict_encoder_t *pEnc,
+                                Cpa32U len,
+                                Cpa32U dist)
+{
+    Cpa32U code = 0;
+
+    while ((code + 1 < DC_DEFLATE_NUM_LEN_CODES) &&
+           (dcDeflateLenBase[code + 1] <= len))
+    {
+        code++;
+    }
+    dcDictPutFixedSymbol(pEnc, 257 + code);
+    dcDictPutBits(pEnc, len - dcDeflateLenBase[code], dcDeflateLenExtra[code]);
+
+    code = 0;
+    while ((code + 1 < DC_DEFLATE_NUM_DIST_CODES) &&
+           (dcDeflateDistBase[code + 1] <= dist))
+    {
+        code++;
+    }
+    dcDictPutCode(pEnc, code, 5);
+    dcDictPutBits(
+        pEnc, dist - dcDeflateDistBase[code], dcDeflateDistExtra[code]);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Encode the input as one fixed Huffman deflate block
+ *
+ *****************************************************************************/
+STATIC void dcDictDeflateFixed(dc_dict_encoder_t *pEnc, CpaBoolean final)
+{
+    Cpa32U pos = 0;
+    Cpa32U len = 0;
+    Cpa32U dist = 0;
+    Cpa32U limit = 0;
+
+    dcDictPutBits(pEnc, (CPA_TRUE == final) ? 1 : 0, 1);
+    dcDictPutBits(pEnc, 1, 2);
+
+    while ((pos < pEnc->inLen) && (CPA_FALSE == pEnc->overflow))
+    {
+        len = 0;
+        if (pos + DC_DICT_DEFLATE_MIN_MATCH <= pEnc->inLen)
+        {
+            limit = pEnc->inLen - pos;
+            if (limit > DC_DICT_DEFLATE_MAX_MATCH)
+            {
+                limit = DC_DICT_DEFLATE_MAX_MATCH;
+            }
+            len = dcDictFindMatch(pEnc, pos, limit, &dist);
+        }
+
+        if (0 != len)
+        {
+            dcDictPutFixedMatch(pEnc, len, dist);
+            while (len--)
+            {
+                dcDictInsert(pEnc, pos++);
+            }
+        }
+        else
+        {
+            dcDictPutFixedSymbol(pEnc, pEnc->pIn[pos]);
+            dcDictInsert(pEnc, pos++);
+        }
+    }
+
+    dcDictPutFixedSymbol(pEnc, DC_DICT_DEFLATE_EOB);
+
+    if (CPA_TRUE != final)
+    {
+        /* Empty stored block to end on a byte boundary, as the device does
+         * for CPA_DC_FLUSH_FULL */
+        dcDictPutBits(pEnc, 0, 3);
+        dcDictFlushBits(pEnc);
+        dcDictPutBits(pEnc, 0, 16);
+        dcDictPutBits(pEnc, 0xFFFF, 16);
+    }
+    dcDictFlushBits(pEnc);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Encode the input as deflate stored blocks
+ *
+ *****************************************************************************/
+STATIC void dcDictDeflateStored(dc_dict_encoder_t *pEnc, CpaBoolean final)
+{
+    Cpa32U pos = 0;
+    Cpa32U len = 0;
+    Cpa8U *pOut = NULL;
+
+    pEnc->outPos = 0;
+    do
+    {
+        len = pEnc->inLen - pos;
+        if (len > DC_DICT_STORED_MAX_LEN)
+        {
+            len = DC_DICT_STORED_MAX_LEN;
+        }
+        if (pEnc->outPos + DC_DICT_STORED_HDR_SIZE + len > pEnc->outLen)
+        {
+            pEnc->overflow = CPA_TRUE;
+            return;
+        }
+        pOut = pEnc->pOut + pEnc->outPos;
+        pOut[0] =
+            ((CPA_TRUE == final) && (pos + len == pEnc->inLen)) ? 1 : 0;
+        pOut[1] = (Cpa8U)len;
+        pOut[2] = (Cpa8U)(len >> 8);
+        pOut[3] = (Cpa8U)~len;
+        pOut[4] = (Cpa8U)(~len >> 8);
+        osalMemCopy(pOut + DC_DICT_STORED_HDR_SIZE, pEnc->pIn + pos, len);
+        pEnc->outPos += DC_DICT_STORED_HDR_SIZE + len;
+        pos += len;
+    } while (pos < pEnc->inLen);
+
+    pEnc->overflow = CPA_FALSE;
+}
+
+STATIC void dcDictLz4PutLength(dc_dict_encoder_t *pEnc, Cpa32U len)
+{
+    while ((len >= 0xFF) && (pEnc->outPos < pEnc->outLen))
+    {
+        pEnc->pOut[pEnc->outPos++] = 0xFF;
+        len -= 0xFF;
+    }
+    if (pEnc->outPos < pEnc->outLen)
+    {
+        pEnc->pOut[pEnc->outPos++] = (Cpa8U)len;
+    }
+    else
+    {
+        pEnc->overflow = CPA_TRUE;
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Write an LZ4 sequence, with no match for the last one of a block
+ *
+ *****************************************************************************/
+STATIC void dcDictLz4PutSequence(dc_dict_encoder_t *pEnc,
+                                 Cpa32U anchor,
+                                 Cpa32U litLen,
+                                 Cpa32U matchLen,
+                                 Cpa32U dist)
+{
+    Cpa32U token = 0;
+
+    if (pEnc->outPos + 1 + litLen + 2 > pEnc->outLen)
+    {
+        pEnc->overflow = CPA_TRUE;
+        return;
+    }
+
+    token = ((litLen < DC_DICT_LZ4_RUN_MASK) ? litLen : DC_DICT_LZ4_RUN_MASK)
+            << 4;
+    if (0 != matchLen)
+    {
+        matchLen -= DC_DICT_LZ4_MIN_MATCH;
+        token |= (matchLen < DC_DICT_LZ4_RUN_MASK) ? matchLen
+                                                    : DC_DICT_LZ4_RUN_MASK;
+    }
+    pEnc->pOut[pEnc->outPos++] = (Cpa8U)token;
+
+    if (litLen >= DC_DICT_LZ4_RUN_MASK)
+    {
+        dcDictLz4PutLength(pEnc, litLen - DC_DICT_LZ4_RUN_MASK);
+    }
+    if (pEnc->outPos + litLen + 2 > pEnc->outLen)
+    {
+        pEnc->overflow = CPA_TRUE;
+        return;
+    }
+    osalMemCopy(pEnc->pOut + pEnc->outPos, pEnc->pIn + anchor, litLen);
+    pEnc->outPos += litLen;
+
+    if (0 != dist)
+    {
+        pEnc->pOut[pEnc->outPos++] = (Cpa8U)dist;
+        pEnc->pOut[pEnc->outPos++] = (Cpa8U)(dist >> 8);
+        if (matchLen >= DC_DICT_LZ4_RUN_MASK)
+        {
+            dcDictLz4PutLength(pEnc, matchLen - DC_DICT_LZ4_RUN_MASK);
+        }
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Encode the input as LZ4 frame data blocks
+ *
+ *****************************************************************************/
+STATIC void dcDictLz4Encode(dc_dict_encoder_t *pEnc,
+                            Cpa32U blockMaxSize,
+                            CpaBoolean blockChecksum)
+{
+    dc_xxh32_state_t xxh;
+    Cpa32U blockStart = 0;
+    Cpa32U blockEnd = 0;
+    Cpa32U hdrPos = 0;
+    Cpa32U pos = 0;
+    Cpa32U anchor = 0;
+    Cpa32U len = 0;
+    Cpa32U dist = 0;
+    Cpa32U blockSize = 0;
+
+    for (blockStart = 0; blockStart < pEnc->inLen; blockStart = blockEnd)
+    {
+        blockEnd = pEnc->inLen - blockStart;
+        blockEnd = blockStart +
+                   ((blockEnd < blockMaxSize) ? blockEnd : blockMaxSize);
+        blockSize = blockEnd - blockStart;
+
+        if (pEnc->outPos + DC_DICT_LZ4_BLOCK_HDR_SIZE > pEnc->outLen)
+        {
+            pEnc->overflow = CPA_TRUE;
+            return;
+        }
+        hdrPos = pEnc->outPos;
+        pEnc->outPos += DC_DICT_LZ4_BLOCK_HDR_SIZE;
+
+        pos = blockStart;
+        anchor = blockStart;
+        while ((pos + DC_DICT_LZ4_MF_LIMIT <= blockEnd) &&
+               (CPA_FALSE == pEnc->overflow))
+        {
+            len = dcDictFindMatch(
+                pEnc, pos, blockEnd - DC_DICT_LZ4_LAST_LITERALS - pos, &dist);
+            if (0 == len)
+            {
+                dcDictInsert(pEnc, pos++);
+                continue;
+            }
+            dcDictLz4PutSequence(pEnc, anchor, pos - anchor, len, dist);
+            while (len--)
+            {
+                dcDictInsert(pEnc, pos++);
+            }
+            anchor = pos;
+        }
+        while (pos < blockEnd)
+        {
+            dcDictInsert(pEnc, pos++);
+        }
+        if (CPA_FALSE == pEnc->overflow)
+        {
+            dcDictLz4PutSequence(pEnc, anchor, blockEnd - anchor, 0, 0);
+        }
+
+        if ((CPA_TRUE == pEnc->overflow) ||
+            (pEnc->outPos - hdrPos - DC_DICT_LZ4_BLOCK_HDR_SIZE >= blockSize))
+        {
+            /* Store the block uncompressed */
+            if (hdrPos + DC_DICT_LZ4_BLOCK_HDR_SIZE + blockSize >
+                pEnc->outLen)
+            {
+                pEnc->overflow = CPA_TRUE;
+                return;
+            }
+            pEnc->overflow = CPA_FALSE;
+            dcDictWrite32(pEnc->pOut + hdrPos,
+                          blockSize | DC_DICT_LZ4_UNCOMPRESSED_BIT);
+            osalMemCopy(pEnc->pOut + hdrPos + DC_DICT_LZ4_BLOCK_HDR_SIZE,
+                        pEnc->pIn + blockStart,
+                        blockSize);
+            pEnc->outPos = hdrPos + DC_DICT_LZ4_BLOCK_HDR_SIZE + blockSize;
+        }
+        else
+        {
+            dcDictWrite32(pEnc->pOut + hdrPos,
+                          pEnc->outPos - hdrPos - DC_DICT_LZ4_BLOCK_HDR_SIZE);
+        }
+
+        if (CPA_TRUE == blockChecksum)
+        {
+            if (pEnc->outPos + DC_DICT_LZ4_BLOCK_CKSUM_SIZE > pEnc->outLen)
+            {
+                pEnc->overflow = CPA_TRUE;
+                return;
+            }
+            dcXxh32Init(&xxh, 0);
+            dcXxh32Update(&xxh,
+                          pEnc->pOut + hdrPos + DC_DICT_LZ4_BLOCK_HDR_SIZE,
+                          pEnc->outPos - hdrPos - DC_DICT_LZ4_BLOCK_HDR_SIZE);
+            dcDictWrite32(pEnc->pOut + pEnc->outPos, dcXxh32Digest(&xxh));
+            pEnc->outPos += DC_DICT_LZ4_BLOCK_CKSUM_SIZE;
+        }
+    }
+}
+
+STATIC Cpa32U dcDictSglLength(const CpaBufferList *pBufferList)
+{
+    Cpa64U len = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; i < pBufferList->numBuffers; i++)
+    {
+        len += pBufferList->pBuffers[i].dataLenInBytes;
+    }
+    return (len > 0xFFFFFFFF) ? 0xFFFFFFFF : (Cpa32U)len;
+}
+
+STATIC void dcDictCopyFromSgl(Cpa8U *pDst,
+                              const CpaBufferList *pBufferList,
+                              Cpa32U len)
+{
+    Cpa32U i = 0;
+    Cpa32U chunk = 0;
+
+    for (i = 0; (i < pBufferList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pBufferList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        osalMemCopy(pDst, pBufferList->pBuffers[i].pData, chunk);
+        pDst += chunk;
+        len -= chunk;
+    }
+}
+
+STATIC void dcDictCopyToSgl(CpaBufferList *pBufferList,
+                            const Cpa8U *pSrc,
+                            Cpa32U len)
+{
+    Cpa32U i = 0;
+    Cpa32U chunk = 0;
+
+    for (i = 0; (i < pBufferList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pBufferList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        osalMemCopy(pBufferList->pBuffers[i].pData, pSrc, chunk);
+        pSrc += chunk;
+        len -= chunk;
+    }
+}
+
+#ifndef KERNEL_SPACE
+/* Match finder tables of dcDictDeflateBuffer. The chain entries are
+ * written before they are read, only the hash heads in use are reset. */
+static __thread Cpa32S dcDictBufferHead[1 << DC_DICT_BUFFER_MAX_HASH_BITS];
+static __thread Cpa32S dcDictBufferPrev[DC_DICT_BUFFER_RING_SIZE];
+
+Cpa32U dcDictDeflateBuffer(const Cpa8U *pIn,
+                           Cpa32U inLen,
+                           Cpa8U *pOut,
+                           Cpa32U outLen,
+                           CpaBoolean final)
+{
+    dc_dict_encoder_t enc;
+    Cpa32U hashBits = DC_DICT_BUFFER_MIN_HASH_BITS;
+    Cpa32U i = 0;
+
+    while (((1U << hashBits) < inLen) &&
+           (hashBits < DC_DICT_BUFFER_MAX_HASH_BITS))
+    {
+        hashBits++;
+    }
+
+    osalMemSet(&enc, 0, sizeof(enc));
+    enc.pIn = pIn;
+    enc.inLen = inLen;
+    enc.pHead = dcDictBufferHead;
+    enc.hashShift = 32 - hashBits;
+    enc.pPrev = dcDictBufferPrev;
+    enc.prevMask = DC_DICT_BUFFER_RING_SIZE - 1;
+    enc.minMatch = DC_DICT_DEFLATE_MIN_MATCH;
+    enc.maxDist = DC_DICT_DEFLATE_MAX_DIST;
+    enc.pOut = pOut;
+    enc.outLen = outLen;
+
+    for (i = 0; i < (1U << hashBits); i++)
+    {
+        dcDictBufferHead[i] = DC_DICT_NO_POS;
+    }
+
+    dcDictDeflateFixed(&enc, final);
+
+    return (CPA_TRUE == enc.overflow) ? 0 : enc.outPos;
+}
+#endif
+
+CpaStatus dcDictCompress(dc_session_desc_t *pSessionDesc,
+                         CpaBufferList *pSrcBuff,
+                         CpaBufferList *pDestBuff,
+                         CpaDcRqResults *pResults,
+                         CpaDcFlush flushFlag)
+{
+    dc_dict_encoder_t enc;
+    dc_dict_t *pDict = pSessionDesc->pDict;
+    CpaBoolean final = (CPA_DC_FLUSH_FINAL == flushFlag) ? CPA_TRUE : CPA_FALSE;
+    CpaBoolean ownScratch = CPA_FALSE;
+    Cpa8U *pFlatIn = NULL;
+    Cpa8U *pScratch = NULL;
+    Cpa32U inLen = dcDictSglLength(pSrcBuff);
+    Cpa32U destLen = dcDictSglLength(pDestBuff);
+    Cpa32U blockMaxSize = 0;
+    Cpa32U numBlocks = 0;
+    Cpa32U ringSize = 1;
+    Cpa32U scratchSize = 0;
+    Cpa32U seed = 0;
+
+    osalMemSet(&enc, 0, sizeof(enc));
+    enc.pDict = pDict;
+    enc.dictLen = pDict->dictLen;
+    enc.inLen = inLen;
+
+    if (CPA_DC_DEFLATE == pSessionDesc->compType)
+    {
+        enc.minMatch = DC_DICT_DEFLATE_MIN_MATCH;
+        enc.maxDist = DC_DICT_DEFLATE_MAX_DIST;
+        enc.outLen = inLen +
+                     DC_DICT_STORED_HDR_SIZE *
+                         (inLen / DC_DICT_STORED_MAX_LEN + 1);
+    }
+    else
+    {
+        blockMaxSize = 1U << (DC_DICT_LZ4_64K_SHIFT +
+                              2 * (Cpa32U)pSessionDesc->lz4BlockMaxSize);
+        numBlocks = (inLen + blockMaxSize - 1) / blockMaxSize;
+        enc.minMatch = DC_DICT_LZ4_MIN_MATCH;
+        enc.maxDist = DC_DICT_LZ4_MAX_DIST;
+        enc.outLen = inLen + (DC_DICT_LZ4_BLOCK_HDR_SIZE +
+                              DC_DICT_LZ4_BLOCK_CKSUM_SIZE) *
+                                 numBlocks;
+    }
+
+    /* The input chain only needs to cover the match window */
+    while ((ringSize < inLen) && (ringSize <= enc.maxDist))
+    {
+        ringSize <<= 1;
+    }
+    enc.prevMask = ringSize - 1;
+
+    /* One scratch area: hash heads, chain, output and, when the source is
+     * scattered, a flat copy of the input. The session scratch is used
+     * unless another request of the session holds it. */
+    scratchSize = sizeof(Cpa32S) * (DC_DICT_HASH_SIZE + ringSize) +
+                  enc.outLen + ((pSrcBuff->numBuffers > 1) ? inLen : 0);
+    if (0 == osalAtomicTestAndSet(1, &pDict->scratchLock))
+    {
+        ownScratch = CPA_TRUE;
+        if (scratchSize > pDict->scratchSize)
+        {
+            LAC_OS_FREE(pDict->pScratch);
+            pDict->scratchSize = 0;
+            if (CPA_STATUS_SUCCESS !=
+                LAC_OS_MALLOC(&pDict->pScratch, scratchSize))
+            {
+                osalAtomicRelease(&pDict->scratchLock);
+                return CPA_STATUS_RESOURCE;
+            }
+            pDict->scratchSize = scratchSize;
+        }
+        pScratch = pDict->pScratch;
+    }
+    else if (CPA_STATUS_SUCCESS != LAC_OS_MALLOC(&pScratch, scratchSize))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+    enc.pHead = (Cpa32S *)pScratch;
+    enc.hashShift = DC_DICT_HASH_SHIFT;
+    enc.pPrev = enc.pHead + DC_DICT_HASH_SIZE;
+    enc.pOut = (Cpa8U *)(enc.pPrev + ringSize);
+
+    /* The chains of the dictionary positions are prebuilt, the input
+     * positions are linked in front of them */
+    osalMemCopy(enc.pHead, pDict->head, sizeof(pDict->head));
+
+    if (pSrcBuff->numBuffers > 1)
+    {
+        pFlatIn = enc.pOut + enc.outLen;
+        dcDictCopyFromSgl(pFlatIn, pSrcBuff, inLen);
+        enc.pIn = pFlatIn;
+    }
+    else
+    {
+        enc.pIn = pSrcBuff->pBuffers[0].pData;
+    }
+
+    if (CPA_DC_DEFLATE == pSessionDesc->compType)
+    {
+        dcDictDeflateFixed(&enc, final);
+        if ((CPA_TRUE == enc.overflow) || (enc.outPos > enc.outLen))
+        {
+            dcDictDeflateStored(&enc, final);
+        }
+    }
+    else
+    {
+        dcDictLz4Encode(
+            &enc, blockMaxSize, pSessionDesc->lz4BlockChecksum);
+    }
+
+    if ((CPA_TRUE == enc.overflow) || (enc.outPos > destLen))
+    {
+        pResults->status = CPA_DC_OVERFLOW;
+        pResults->consumed = 0;
+        pResults->produced = 0;
+    }
+    else
+    {
+        dcDictCopyToSgl(pDestBuff, enc.pOut, enc.outPos);
+
+        if ((CPA_DC_STATELESS == pSessionDesc->sessState) &&
+            (DC_REQUEST_SUBSEQUENT == pSessionDesc->requestType) &&
+            (CPA_DC_XXHASH32 != pSessionDesc->checksumType))
+        {
+            seed = pResults->checksum;
+        }
+        else
+        {
+            seed = (CPA_DC_ADLER32 == pSessionDesc->checksumType)
+                       ? DC_DEFAULT_ADLER32
+                       : DC_DEFAULT_CRC;
+        }
+        pResults->checksum = dcDictChecksumSgl(
+            pSessionDesc->checksumType, pSrcBuff, inLen, seed);
+        pResults->status = CPA_DC_OK;
+        pResults->consumed = inLen;
+        pResults->produced = enc.outPos;
+        pSessionDesc->requestType =
+            (CPA_TRUE == final) ? DC_REQUEST_FIRST : DC_REQUEST_SUBSEQUENT;
+    }
+
+    if (CPA_TRUE == ownScratch)
+    {
+        osalAtomicRelease(&pDict->scratchLock);
+    }
+    else
+    {
+        LAC_OS_FREE(pScratch);
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus dcDictWrapRequest(dc_session_desc_t *pSessionDesc,
+                            CpaBufferList *pSrcBuff,
+                            CpaBufferList *pDestBuff,
+                            CpaDcRqResults *pResults,
+                            CpaBufferList **ppSrcBuff,
+                            CpaBufferList **ppDestBuff,
+                            void **ppWrap)
+{
+    dc_dict_t *pDict = pSessionDesc->pDict;
+    dc_dict_wrap_t *pWrap = NULL;
+    Cpa32U i = 0;
+
+    if ((pSrcBuff->numBuffers > DC_DICT_MAX_USER_BUFFERS) ||
+        (pDestBuff->numBuffers > DC_DICT_MAX_USER_BUFFERS))
+    {
+        LAC_INVALID_PARAM_LOG1("Dictionary sessions support up to %d "
+                               "buffers per buffer list",
+                               DC_DICT_MAX_USER_BUFFERS);
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    while (osalAtomicTestAndSet(1, &pDict->wrapLock))
+        ;
+    if (0 != pDict->numFreeWraps)
+    {
+        pWrap = &pDict->pWraps[pDict->freeWraps[--pDict->numFreeWraps]];
+    }
+    osalAtomicRelease(&pDict->wrapLock);
+
+    if (NULL == pWrap)
+    {
+        return CPA_STATUS_RETRY;
+    }
+
+    pWrap->srcBuffers[0].pData = pDict->pPrefix;
+    pWrap->srcBuffers[0].dataLenInBytes = pDict->prefixLen;
+    for (i = 0; i < pSrcBuff->numBuffers; i++)
+    {
+        pWrap->srcBuffers[i + 1] = pSrcBuff->pBuffers[i];
+    }
+    pWrap->srcList.numBuffers = pSrcBuff->numBuffers + 1;
+
+    pWrap->destBuffers[0].pData = pDict->pDiscard;
+    pWrap->destBuffers[0].dataLenInBytes = pDict->dictLen;
+    for (i = 0; i < pDestBuff->numBuffers; i++)
+    {
+        pWrap->destBuffers[i + 1] = pDestBuff->pBuffers[i];
+    }
+    pWrap->destList.numBuffers = pDestBuff->numBuffers + 1;
+
+    pWrap->pUserDestBuff = pDestBuff;
+    if ((DC_REQUEST_SUBSEQUENT == pSessionDesc->requestType) &&
+        (CPA_DC_XXHASH32 != pSessionDesc->checksumType))
+    {
+        pWrap->seedChecksum = pResults->checksum;
+    }
+    else
+    {
+        pWrap->seedChecksum = (CPA_DC_ADLER32 == pSessionDesc->checksumType)
+                                  ? DC_DEFAULT_ADLER32
+                                  : DC_DEFAULT_CRC;
+    }
+
+    *ppSrcBuff = &pWrap->srcList;
+    *ppDestBuff = &pWrap->destList;
+    *ppWrap = pWrap;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+void dcDictWrapRelease(dc_session_desc_t *pSessionDesc, void *pWrap)
+{
+    dc_dict_t *pDict = pSessionDesc->pDict;
+
+    while (osalAtomicTestAndSet(1, &pDict->wrapLock))
+        ;
+    pDict->freeWraps[pDict->numFreeWraps++] = ((dc_dict_wrap_t *)pWrap)->index;
+    osalAtomicRelease(&pDict->wrapLock);
+}
+
+void dcDictRequestComplete(dc_session_desc_t *pSessionDesc,
+                           void *pWrap,
+                           CpaDcRqResults *pResults)
+{
+    const dc_dict_t *pDict = pSessionDesc->pDict;
+    dc_dict_wrap_t *pDictWrap = (dc_dict_wrap_t *)pWrap;
+
+    pResults->consumed = (pResults->consumed > pDict->prefixLen)
+                             ? pResults->consumed - pDict->prefixLen
+                             : 0;
+    pResults->produced = (pResults->produced > pDict->dictLen)
+                             ? pResults->produced - pDict->dictLen
+                             : 0;
+
+    /* The device checksum covers the dictionary */
+    pResults->checksum = dcDictChecksumSgl(pSessionDesc->checksumType,
+                                           pDictWrap->pUserDestBuff,
+                                           pResults->produced,
+                                           pDictWrap->seedChecksum);
+
+    dcDictWrapRelease(pSessionDesc, pWrap);
+}
+
+STATIC void dcDictDestroy(dc_dict_t *pDict)
+{
+    LAC_OS_CAFREE(pDict->pPrefix);
+    LAC_OS_CAFREE(pDict->pDiscard);
+    LAC_OS_CAFREE(pDict->pMeta);
+    LAC_OS_FREE(pDict->pPrev);
+    LAC_OS_FREE(pDict->pWraps);
+    LAC_OS_FREE(pDict->pScratch);
+    LAC_OS_FREE(pDict);
+}
+
+Cpa32U dcDictGetId(const dc_session_desc_t *pSessionDesc)
+{
+    return pSessionDesc->pDict->dictId;
+}
+
+void dcDictFree(dc_session_desc_t *pSessionDesc)
+{
+    if (NULL != pSessionDesc->pDict)
+    {
+        dcDictDestroy(pSessionDesc->pDict);
+        pSessionDesc->pDict = NULL;
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Allocate the decompression request wrappers of a dictionary
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcDictWrapsCreate(dc_dict_t *pDict, Cpa32U node)
+{
+    Cpa32U metaSize = 0;
+    Cpa32U i = 0;
+
+    /* Same size as cpaDcBufferListGetMetaSize, rounded to keep the
+     * descriptors of each list aligned */
+    metaSize = sizeof(icp_buffer_list_desc_t) +
+               sizeof(icp_flat_buffer_desc_t) *
+                   (DC_DICT_MAX_USER_BUFFERS + 2) +
+               ICP_DESCRIPTOR_ALIGNMENT_BYTES;
+    metaSize = LAC_ALIGN_POW2_ROUNDUP(metaSize, LAC_64BYTE_ALIGNMENT);
+
+    if ((CPA_STATUS_SUCCESS !=
+         LAC_OS_MALLOC(&pDict->pWraps,
+                       sizeof(dc_dict_wrap_t) * DC_DICT_MAX_IN_FLIGHT)) ||
+        (CPA_STATUS_SUCCESS !=
+         LAC_OS_CAMALLOC(&pDict->pMeta,
+                         2 * metaSize * DC_DICT_MAX_IN_FLIGHT,
+                         LAC_64BYTE_ALIGNMENT,
+                         node)))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+
+    for (i = 0; i < DC_DICT_MAX_IN_FLIGHT; i++)
+    {
+        dc_dict_wrap_t *pWrap = &pDict->pWraps[i];
+
+        osalMemSet(pWrap, 0, sizeof(*pWrap));
+        pWrap->srcList.pBuffers = pWrap->srcBuffers;
+        pWrap->srcList.pPrivateMetaData = pDict->pMeta + 2 * i * metaSize;
+        pWrap->destList.pBuffers = pWrap->destBuffers;
+        pWrap->destList.pPrivateMetaData =
+            pDict->pMeta + (2 * i + 1) * metaSize;
+        pWrap->index = i;
+        pDict->freeWraps[i] = i;
+    }
+    pDict->numFreeWraps = DC_DICT_MAX_IN_FLIGHT;
+    osalAtomicSet(0, &pDict->wrapLock);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Create a dictionary for a session
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcDictCreate(dc_session_desc_t *pSessionDesc,
+                              Cpa32U node,
+                              const Cpa8U *pDict,
+                              Cpa32U dictLen,
+                              Cpa32U dictId,
+                              dc_dict_t **ppDict)
+{
+    dc_dict_t *pNewDict = NULL;
+    dc_xxh32_state_t xxh;
+    Cpa32U hdrLen = 0;
+    Cpa32U trailerLen = 0;
+    Cpa32U minMatch = 0;
+    Cpa32U hash = 0;
+    Cpa32U i = 0;
+
+    if (CPA_STATUS_SUCCESS != LAC_OS_MALLOC(&pNewDict, sizeof(dc_dict_t)))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+    osalMemSet(pNewDict, 0, sizeof(dc_dict_t));
+
+    if (CPA_DC_DEFLATE == pSessionDesc->compType)
+    {
+        hdrLen = DC_DICT_STORED_HDR_SIZE;
+        minMatch = DC_DICT_DEFLATE_MIN_MATCH;
+    }
+    else
+    {
+        hdrLen = DC_DICT_LZ4_BLOCK_HDR_SIZE;
+        trailerLen = (CPA_TRUE == pSessionDesc->lz4BlockChecksum)
+                         ? DC_DICT_LZ4_BLOCK_CKSUM_SIZE
+                         : 0;
+        minMatch = DC_DICT_LZ4_MIN_MATCH;
+    }
+    pNewDict->prefixLen = hdrLen + dictLen + trailerLen;
+    pNewDict->dictLen = dictLen;
+
+    if ((CPA_STATUS_SUCCESS != LAC_OS_CAMALLOC(&pNewDict->pPrefix,
+                                               pNewDict->prefixLen,
+                                               LAC_64BYTE_ALIGNMENT,
+                                               node)) ||
+        (CPA_STATUS_SUCCESS != LAC_OS_CAMALLOC(&pNewDict->pDiscard,
+                                               dictLen,
+                                               LAC_64BYTE_ALIGNMENT,
+                                               node)) ||
+        (CPA_STATUS_SUCCESS !=
+         LAC_OS_MALLOC(&pNewDict->pPrev, sizeof(Cpa32S) * dictLen)) ||
+        (CPA_STATUS_SUCCESS != dcDictWrapsCreate(pNewDict, node)))
+    {
+        dcDictDestroy(pNewDict);
+        return CPA_STATUS_RESOURCE;
+    }
+
+    osalMemCopy(pNewDict->pPrefix + hdrLen, pDict, dictLen);
+    pNewDict->pDict = pNewDict->pPrefix + hdrLen;
+
+    if (CPA_DC_DEFLATE == pSessionDesc->compType)
+    {
+        /* Non-final stored block holding the dictionary */
+        pNewDict->pPrefix[0] = 0;
+        pNewDict->pPrefix[1] = (Cpa8U)dictLen;
+        pNewDict->pPrefix[2] = (Cpa8U)(dictLen >> 8);
+        pNewDict->pPrefix[3] = (Cpa8U)~dictLen;
+        pNewDict->pPrefix[4] = (Cpa8U)(~dictLen >> 8);
+        pNewDict->dictId = dcDictAdler32(DC_DEFAULT_ADLER32, pDict, dictLen);
+    }
+    else
+    {
+        /* Uncompressed block holding the dictionary */
+        dcDictWrite32(pNewDict->pPrefix,
+                      dictLen | DC_DICT_LZ4_UNCOMPRESSED_BIT);
+        if (0 != trailerLen)
+        {
+            dcXxh32Init(&xxh, 0);
+            dcXxh32Update(&xxh, pDict, dictLen);
+            dcDictWrite32(pNewDict->pPrefix + hdrLen + dictLen,
+                          dcXxh32Digest(&xxh));
+        }
+        pNewDict->dictId = dictId;
+    }
+
+    /* Index the dictionary, the most recent position heads each chain */
+    for (i = 0; i < DC_DICT_HASH_SIZE; i++)
+    {
+        pNewDict->head[i] = DC_DICT_NO_POS;
+    }
+    for (i = 0; i < dictLen; i++)
+    {
+        pNewDict->pPrev[i] = DC_DICT_NO_POS;
+        if (i + minMatch <= dictLen)
+        {
+            hash = dcDictHash(
+                pNewDict->pDict + i, minMatch, DC_DICT_HASH_SHIFT);
+            pNewDict->pPrev[i] = pNewDict->head[hash];
+            pNewDict->head[hash] = (Cpa32S)i;
+        }
+    }
+
+    *ppDict = pNewDict;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus dcSetDictionary(CpaInstanceHandle dcInstance,
+                          CpaDcSessionHandle pSessionHandle,
+                          const Cpa8U *pDict,
+                          Cpa32U dictLen,
+                          Cpa32U dictId)
+{
+    CpaInstanceHandle insHandle = NULL;
+    sal_compression_service_t *pService = NULL;
+    dc_session_desc_t *pSessionDesc = NULL;
+    dc_dict_t *pNewDict = NULL;
+    dc_dict_t *pOldDict = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    if (CPA_INSTANCE_HANDLE_SINGLE == dcInstance)
+    {
+        insHandle = dcGetFirstHandle();
+    }
+    else
+    {
+        insHandle = dcInstance;
+    }
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(insHandle);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+    SAL_CHECK_INSTANCE_TYPE(insHandle, SAL_SERVICE_TYPE_COMPRESSION);
+#endif
+    pService = (sal_compression_service_t *)insHandle;
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if (NULL != pDict)
+    {
+        if ((CPA_DC_STATELESS != pSessionDesc->sessState) ||
+            (CPA_TRUE == pSessionDesc->isDcDp))
+        {
+            LAC_INVALID_PARAM_LOG("Dictionaries require a stateless "
+                                  "session");
+            return CPA_STATUS_INVALID_PARAM;
+        }
+
+#ifdef CNV_STRICT_MODE
+        /* Software compression is not verified by the device */
+        if (CPA_DC_DIR_DECOMPRESS != pSessionDesc->sessDirection)
+        {
+            LAC_INVALID_PARAM_LOG("Only device verified compression "
+                                  "allowed");
+            return CPA_STATUS_UNSUPPORTED;
+        }
+#endif
+
+        if (CPA_DC_DEFLATE == pSessionDesc->compType)
+        {
+            LAC_CHECK_PARAM_RANGE(dictLen, 1, DC_DICT_MAX_DEFLATE_SIZE + 1);
+        }
+        else if (CPA_DC_LZ4 == pSessionDesc->compType)
+        {
+            LAC_CHECK_PARAM_RANGE(dictLen, 1, DC_DICT_MAX_LZ4_SIZE + 1);
+
+            /* The data refers to the dictionary as a previous block and
+             * the content checksum is computed per request */
+            if ((CPA_TRUE == pSessionDesc->lz4BlockIndependence) ||
+                (CPA_TRUE == pSessionDesc->accumulateXXHash))
+            {
+                LAC_INVALID_PARAM_LOG("LZ4 dictionaries require linked "
+                                      "blocks and no accumulated xxHash");
+                return CPA_STATUS_UNSUPPORTED;
+            }
+        }
+        else
+        {
+            LAC_INVALID_PARAM_LOG("Dictionaries support Deflate and LZ4");
+            return CPA_STATUS_UNSUPPORTED;
+        }
+    }
+
+    if (NULL != pDict)
+    {
+        status = dcDictCreate(pSessionDesc,
+                              pService->nodeAffinity,
+                              pDict,
+                              dictLen,
+                              dictId,
+                              &pNewDict);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            return status;
+        }
+    }
+
+    /* Software compressed requests are counted as pending under the
+     * session lock while they are encoded, so the check also covers
+     * requests using the old dictionary on other threads */
+    while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
+        ;
+    if (0 != osalAtomicGet(&(pSessionDesc->pendingStatelessCbCount)))
+    {
+        osalAtomicRelease(&pSessionDesc->sessionLock);
+        if (NULL != pNewDict)
+        {
+            dcDictDestroy(pNewDict);
+        }
+        return CPA_STATUS_RETRY;
+    }
+    pOldDict = pSessionDesc->pDict;
+    pSessionDesc->pDict = pNewDict;
+    osalAtomicRelease(&pSessionDesc->sessionLock);
+
+    if (NULL != pOldDict)
+    {
+        dcDictDestroy(pOldDict);
+    }
+
+    return status;
+}
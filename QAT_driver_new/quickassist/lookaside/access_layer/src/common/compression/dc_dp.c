@@ -586,6 +586,7 @@ CpaStatus cpaDcDpEnqueueOp(CpaDcDpOpData *pOpData,
 {
     icp_qat_fw_comp_req_t *pCurrentQatMsg = NULL;
     icp_comms_trans_handle trans_handle = NULL;
+    sal_compression_service_t *pService = NULL;
     dc_session_desc_t *pSessionDesc = NULL;
     CpaStatus status = CPA_STATUS_SUCCESS;
 #ifdef ICP_DC_DYN_NOT_SUPPORTED
@@ -618,8 +619,8 @@ CpaStatus cpaDcDpEnqueueOp(CpaDcDpOpData *pOpData,
     /* Check if SAL is initialised otherwise return an error */
     SAL_RUNNING_CHECK(pOpData->dcInstance);
 
-    trans_handle = ((sal_compression_service_t *)pOpData->dcInstance)
-                       ->trans_handle_compression_tx;
+    pService = (sal_compression_service_t *)pOpData->dcInstance;
+    trans_handle = pService->trans_handle_compression_tx;
 
     if (pOpData->pSessionHandle)
     {
@@ -686,14 +687,21 @@ CpaStatus cpaDcDpEnqueueOp(CpaDcDpOpData *pOpData,
         pSessionDesc->pendingDpStatelessCbCount++;
     }
 
-    if (CPA_TRUE == performOpNow)
+    if (CPA_TRUE == SalDpFlush_Queued(&pService->dcDpFlush, 1, performOpNow))
     {
         status = icp_adf_updateQueueTail(trans_handle);
-        if (CPA_STATUS_RETRY == status && pOpData->pSessionHandle)
+        if (CPA_STATUS_SUCCESS == status)
         {
-            pSessionDesc->pendingDpStatelessCbCount--;
+            SalDpFlush_Done(&pService->dcDpFlush);
+        }
+        if (CPA_TRUE == performOpNow)
+        {
+            if (CPA_STATUS_RETRY == status && pOpData->pSessionHandle)
+            {
+                pSessionDesc->pendingDpStatelessCbCount--;
+            }
+            return status;
         }
-        return status;
     }
 
     return CPA_STATUS_SUCCESS;
@@ -707,6 +715,7 @@ CpaStatus cpaDcDpEnqueueOpBatch(const Cpa32U numberRequests,
     icp_qat_fw_comp_req_t *pNsRefQatMsg = NULL;
     icp_comms_trans_handle trans_handle = NULL;
     dc_session_desc_t *pSessionDesc = NULL;
+    sal_compression_service_t *pService = NULL;
     Cpa32U i = 0;
     CpaStatus status = CPA_STATUS_SUCCESS;
 #ifdef ICP_DC_DYN_NOT_SUPPORTED
@@ -715,8 +724,6 @@ CpaStatus cpaDcDpEnqueueOpBatch(const Cpa32U numberRequests,
 #ifdef ICP_PARAM_CHECK
     CpaDcSessionDir sessDirection;
 
-    sal_compression_service_t *pService = NULL;
-
     LAC_CHECK_NULL_PARAM(pOpData);
     LAC_CHECK_NULL_PARAM(pOpData[0]);
     LAC_CHECK_NULL_PARAM(pOpData[0]->dcInstance);
@@ -875,17 +882,26 @@ CpaStatus cpaDcDpEnqueueOpBatch(const Cpa32U numberRequests,
         pSessionDesc->pendingDpStatelessCbCount += numberRequests;
     }
 
-    if (CPA_TRUE == performOpNow)
+    pService = (sal_compression_service_t *)pOpData[0]->dcInstance;
+    if (CPA_TRUE ==
+        SalDpFlush_Queued(&pService->dcDpFlush, numberRequests, performOpNow))
     {
         status = icp_adf_updateQueueTail(trans_handle);
-        if (CPA_STATUS_RETRY == status)
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            SalDpFlush_Done(&pService->dcDpFlush);
+        }
+        if (CPA_TRUE == performOpNow)
         {
-            if (pSessionDesc)
+            if (CPA_STATUS_RETRY == status)
             {
-                pSessionDesc->pendingDpStatelessCbCount -= numberRequests;
+                if (pSessionDesc)
+                {
+                    pSessionDesc->pendingDpStatelessCbCount -= numberRequests;
+                }
             }
+            return status;
         }
-        return status;
     }
 
     return CPA_STATUS_SUCCESS;
@@ -895,6 +911,7 @@ CpaStatus icp_sal_DcPollDpInstance(CpaInstanceHandle dcInstance,
                                    Cpa32U responseQuota)
 {
     icp_comms_trans_handle trans_handle = NULL;
+    sal_compression_service_t *pService = NULL;
 
 #ifdef ICP_TRACE
     LAC_LOG2("Called with params (0x%lx, %d)\n",
@@ -910,15 +927,69 @@ CpaStatus icp_sal_DcPollDpInstance(CpaInstanceHandle dcInstance,
     /* Check if SAL is initialised otherwise return an error */
     SAL_RUNNING_CHECK(dcInstance);
 
-    trans_handle =
-        ((sal_compression_service_t *)dcInstance)->trans_handle_compression_rx;
+    pService = (sal_compression_service_t *)dcInstance;
+    SalDpFlush_FlushExpired(&pService->dcDpFlush,
+                            pService->trans_handle_compression_tx);
+
+    trans_handle = pService->trans_handle_compression_rx;
 
     return icp_adf_pollQueue(trans_handle, responseQuota);
 }
 
+CpaStatus icp_sal_DcPollDpInstanceBatch(CpaInstanceHandle dcInstance,
+                                        CpaDcDpOpData **ppOpData,
+                                        Cpa32U maxResponses,
+                                        Cpa32U *pNumResponses)
+{
+    sal_compression_service_t *pService = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+#ifdef ICP_TRACE
+    LAC_LOG4("Called with params (0x%lx, 0x%lx, %d, 0x%lx)\n",
+             (LAC_ARCH_UINT)dcInstance,
+             (LAC_ARCH_UINT)ppOpData,
+             maxResponses,
+             (LAC_ARCH_UINT)pNumResponses);
+#endif
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_INSTANCE_HANDLE(dcInstance);
+    SAL_CHECK_INSTANCE_TYPE(dcInstance, SAL_SERVICE_TYPE_COMPRESSION);
+    LAC_CHECK_NULL_PARAM(ppOpData);
+    LAC_CHECK_NULL_PARAM(pNumResponses);
+    if (0 == maxResponses)
+    {
+        LAC_INVALID_PARAM_LOG("maxResponses must be greater than zero");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+#endif
+
+    /* Check if SAL is initialised otherwise return an error */
+    SAL_RUNNING_CHECK(dcInstance);
+
+    pService = (sal_compression_service_t *)dcInstance;
+    SalDpFlush_FlushExpired(&pService->dcDpFlush,
+                            pService->trans_handle_compression_tx);
+
+    /* Each response read from the ring completes at most one request, so
+     * limiting the quota to maxResponses bounds the number of entries
+     * written to the caller's array */
+    pService->dcDpCqCount = 0;
+    pService->ppDcDpCqEntries = ppOpData;
+
+    status =
+        icp_adf_pollQueue(pService->trans_handle_compression_rx, maxResponses);
+
+    pService->ppDcDpCqEntries = NULL;
+    *pNumResponses = pService->dcDpCqCount;
+
+    return status;
+}
+
 CpaStatus cpaDcDpPerformOpNow(CpaInstanceHandle dcInstance)
 {
     icp_comms_trans_handle trans_handle = NULL;
+    sal_compression_service_t *pService = NULL;
 
 #ifdef ICP_TRACE
     LAC_LOG1("Called with params (0x%lx)\n", (LAC_ARCH_UINT)dcInstance);
@@ -932,12 +1003,16 @@ CpaStatus cpaDcDpPerformOpNow(CpaInstanceHandle dcInstance)
     /* Check if SAL is initialised otherwise return an error */
     SAL_RUNNING_CHECK(dcInstance);
 
-    trans_handle =
-        ((sal_compression_service_t *)dcInstance)->trans_handle_compression_tx;
+    pService = (sal_compression_service_t *)dcInstance;
+    trans_handle = pService->trans_handle_compression_tx;
 
     if (CPA_TRUE == icp_adf_queueDataToSend(trans_handle))
     {
-        icp_adf_updateQueueTail(trans_handle);
+        SalDpFlush_Explicit(&pService->dcDpFlush);
+        if (CPA_STATUS_SUCCESS == icp_adf_updateQueueTail(trans_handle))
+        {
+            SalDpFlush_Done(&pService->dcDpFlush);
+        }
     }
 
     return CPA_STATUS_SUCCESS;
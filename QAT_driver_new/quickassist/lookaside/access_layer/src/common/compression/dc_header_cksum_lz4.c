@@ -59,9 +59,34 @@ static const Cpa32U XXHASH_PRIME32_C = 0xC2B2AE3DU;
 static const Cpa32U XXHASH_PRIME32_D = 0x27D4EB2FU;
 static const Cpa32U XXHASH_PRIME32_E = 0x165667B1U;
 
-#define XXH32_STRIP_SIZE 16
+#define XXH32_STRIP_SIZE DC_XXH32_STRIPE_SIZE
 #define ROTATE_LEFT_32(n, d) ((n << d) | (n >> (-d & 31)))
 
+STATIC INLINE Cpa32U dc_hdr_cksum_read32(const Cpa8U *ptr)
+{
+    return (Cpa32U)ptr[0] | ((Cpa32U)ptr[1] << 8) | ((Cpa32U)ptr[2] << 16) |
+           ((Cpa32U)ptr[3] << 24);
+}
+
+STATIC INLINE Cpa32U dc_hdr_cksum_round(Cpa32U acc, Cpa32U input)
+{
+    acc += input * XXHASH_PRIME32_B;
+    acc = ROTATE_LEFT_32(acc, 13);
+    return acc * XXHASH_PRIME32_A;
+}
+
+STATIC void dc_hdr_cksum_stripe(dc_xxh32_state_t *pState, const Cpa8U *ptr)
+{
+    pState->acc[0] =
+        dc_hdr_cksum_round(pState->acc[0], dc_hdr_cksum_read32(ptr));
+    pState->acc[1] =
+        dc_hdr_cksum_round(pState->acc[1], dc_hdr_cksum_read32(ptr + 4));
+    pState->acc[2] =
+        dc_hdr_cksum_round(pState->acc[2], dc_hdr_cksum_read32(ptr + 8));
+    pState->acc[3] =
+        dc_hdr_cksum_round(pState->acc[3], dc_hdr_cksum_read32(ptr + 12));
+}
+
 STATIC Cpa32U dc_hdr_cksum_finalise(Cpa32U xxHash32)
 {
     xxHash32 = xxHash32 ^ (xxHash32 >> 15);
@@ -81,7 +106,7 @@ STATIC Cpa32U dc_hdr_cksum_consume_remaining(Cpa32U xxHash32Accumulator,
      * we have less than 4 bytes left in the buffer */
     while (remainingBytes >= 4)
     {
-        xxHash32Accumulator += *(Cpa32U *)ptr * XXHASH_PRIME32_C;
+        xxHash32Accumulator += dc_hdr_cksum_read32(ptr) * XXHASH_PRIME32_C;
         xxHash32Accumulator =
             ROTATE_LEFT_32(xxHash32Accumulator, 17) * XXHASH_PRIME32_D;
         ptr += 4;
@@ -99,6 +124,70 @@ STATIC Cpa32U dc_hdr_cksum_consume_remaining(Cpa32U xxHash32Accumulator,
     return dc_hdr_cksum_finalise(xxHash32Accumulator);
 }
 
+void dcXxh32Init(dc_xxh32_state_t *pState, Cpa32U seed)
+{
+    osalMemSet(pState, 0, sizeof(*pState));
+    pState->seed = seed;
+    pState->acc[0] = seed + XXHASH_PRIME32_A + XXHASH_PRIME32_B;
+    pState->acc[1] = seed + XXHASH_PRIME32_B;
+    pState->acc[2] = seed;
+    pState->acc[3] = seed - XXHASH_PRIME32_A;
+}
+
+void dcXxh32Update(dc_xxh32_state_t *pState, const Cpa8U *pData, Cpa32U len)
+{
+    Cpa32U fill = 0;
+
+    pState->totalLen += len;
+
+    if (0 != pState->memSize)
+    {
+        fill = XXH32_STRIP_SIZE - pState->memSize;
+        if (len < fill)
+        {
+            osalMemCopy(pState->mem + pState->memSize, pData, len);
+            pState->memSize += len;
+            return;
+        }
+        osalMemCopy(pState->mem + pState->memSize, pData, fill);
+        dc_hdr_cksum_stripe(pState, pState->mem);
+        pData += fill;
+        len -= fill;
+        pState->memSize = 0;
+    }
+
+    while (len >= XXH32_STRIP_SIZE)
+    {
+        dc_hdr_cksum_stripe(pState, pData);
+        pData += XXH32_STRIP_SIZE;
+        len -= XXH32_STRIP_SIZE;
+    }
+
+    osalMemCopy(pState->mem, pData, len);
+    pState->memSize = len;
+}
+
+Cpa32U dcXxh32Digest(const dc_xxh32_state_t *pState)
+{
+    Cpa32U xxHash32Accumulator = 0;
+
+    if (pState->totalLen >= XXH32_STRIP_SIZE)
+    {
+        xxHash32Accumulator = ROTATE_LEFT_32(pState->acc[0], 1) +
+                              ROTATE_LEFT_32(pState->acc[1], 7) +
+                              ROTATE_LEFT_32(pState->acc[2], 12) +
+                              ROTATE_LEFT_32(pState->acc[3], 18);
+    }
+    else
+    {
+        xxHash32Accumulator = pState->seed + XXHASH_PRIME32_E;
+    }
+    xxHash32Accumulator += (Cpa32U)pState->totalLen;
+
+    return dc_hdr_cksum_consume_remaining(
+        xxHash32Accumulator, pState->mem, pState->memSize);
+}
+
 /*Calculate the XXH32 on a block of data */
 STATIC CpaStatus dc_hdr_cksum_calculate(const Cpa8U *xxH32input,
                                         Cpa32U dataLength,
@@ -106,16 +195,21 @@ STATIC CpaStatus dc_hdr_cksum_calculate(const Cpa8U *xxH32input,
                                         Cpa32U *result)
 {
     Cpa32U xxHash32Accumulator = 0;
+    dc_xxh32_state_t state;
 #ifdef ICP_PARAM_CHECK
     /* Check for null parameters */
     LAC_CHECK_NULL_PARAM(xxH32input);
     LAC_CHECK_NULL_PARAM(result);
 #endif
 
-    if (dataLength < XXH32_STRIP_SIZE)
-        xxHash32Accumulator = seed + XXHASH_PRIME32_E;
-    else /* TODO: Add support for input buffer >= 16. */
-        return CPA_STATUS_FAIL;
+    if (dataLength >= XXH32_STRIP_SIZE)
+    {
+        dcXxh32Init(&state, seed);
+        dcXxh32Update(&state, xxH32input, dataLength);
+        *result = dcXxh32Digest(&state);
+        return CPA_STATUS_SUCCESS;
+    }
+    xxHash32Accumulator = seed + XXHASH_PRIME32_E;
 
     /* Add data length to accumulator */
     xxHash32Accumulator += (Cpa32U)dataLength;
@@ -64,6 +64,7 @@
 #include "dc_header_footer_lz4.h"
 #include "dc_session.h"
 #include "dc_datapath.h"
+#include "dc_dict.h"
 
 
 CpaStatus cpaDcGenerateHeader(CpaDcSessionHandle pSessionHandle,
@@ -143,7 +144,9 @@ CpaStatus cpaDcGenerateHeader(CpaDcSessionHandle pSessionHandle,
             Cpa16U header = 0, level = 0;
 
 #ifdef ICP_PARAM_CHECK
-            if (pDestBuff->dataLenInBytes < DC_ZLIB_HEADER_SIZE)
+            if (pDestBuff->dataLenInBytes <
+                DC_ZLIB_HEADER_SIZE +
+                    ((NULL != pSessionDesc->pDict) ? DC_ZLIB_DICTID_SIZE : 0))
             {
                 LAC_INVALID_PARAM_LOG("The dataLenInBytes of the dest buffer "
                                       "is too small");
@@ -180,6 +183,12 @@ CpaStatus cpaDcGenerateHeader(CpaDcSessionHandle pSessionHandle,
             /* Bits 6 - 7: FLEVEL, compression level */
             header |= level << DC_ZLIB_FLEVEL_OFFSET;
 
+            /* Bit 5: FDICT, preset dictionary */
+            if (NULL != pSessionDesc->pDict)
+            {
+                header |= DC_ZLIB_FDICT;
+            }
+
             /* The header has to be a multiple of 31 */
             header += DC_ZLIB_HEADER_OFFSET - (header % DC_ZLIB_HEADER_OFFSET);
 
@@ -188,6 +197,19 @@ CpaStatus cpaDcGenerateHeader(CpaDcSessionHandle pSessionHandle,
 
             /* Set to the number of bytes added to the buffer */
             *count = DC_ZLIB_HEADER_SIZE;
+
+            /* DICTID: Adler-32 of the dictionary, most significant byte
+             * first */
+            if (NULL != pSessionDesc->pDict)
+            {
+                Cpa32U dictId = dcDictGetId(pSessionDesc);
+
+                pDest[2] = (Cpa8U)(dictId >> 24);
+                pDest[3] = (Cpa8U)(dictId >> 16);
+                pDest[4] = (Cpa8U)(dictId >> 8);
+                pDest[5] = (Cpa8U)dictId;
+                *count += DC_ZLIB_DICTID_SIZE;
+            }
         }
 
         /* If deflate but no checksum required */
@@ -199,10 +221,22 @@ CpaStatus cpaDcGenerateHeader(CpaDcSessionHandle pSessionHandle,
     else if (CPA_DC_LZ4 == pSessionDesc->compType)
     {
         CpaStatus ret;
-        ret = dc_lz4_generate_header(pDestBuff,
-                                     pSessionDesc->lz4BlockMaxSize,
-                                     pSessionDesc->lz4BlockIndependence,
-                                     count);
+        if (NULL != pSessionDesc->pDict)
+        {
+            ret = dc_lz4_generate_header_dict(
+                pDestBuff,
+                pSessionDesc->lz4BlockMaxSize,
+                pSessionDesc->lz4BlockIndependence,
+                dcDictGetId(pSessionDesc),
+                count);
+        }
+        else
+        {
+            ret = dc_lz4_generate_header(pDestBuff,
+                                         pSessionDesc->lz4BlockMaxSize,
+                                         pSessionDesc->lz4BlockIndependence,
+                                         count);
+        }
         if (CPA_STATUS_SUCCESS != ret)
             return ret;
     }
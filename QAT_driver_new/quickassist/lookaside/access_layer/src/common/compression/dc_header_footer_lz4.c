@@ -105,10 +105,19 @@ typedef Cpa8U static_assert_lz4_header_size
 typedef Cpa8U static_assert_lz4_footer_size
     [(sizeof(lz4_footer_t) == DC_LZ4_FOOTER_SIZE) ? 1 : -1];
 
-CpaStatus dc_lz4_generate_header(const CpaFlatBuffer *dest_buff,
-                                 const CpaDcCompLZ4BlockMaxSize max_block_size,
-                                 const CpaBoolean block_indep,
-                                 Cpa32U *count)
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Generate an LZ4 frame header with or without the content checksum
+ *      flag.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dc_lz4_generate_header_common(
+    const CpaFlatBuffer *dest_buff,
+    const CpaDcCompLZ4BlockMaxSize max_block_size,
+    const CpaBoolean block_indep,
+    const CpaBoolean cnt_cksum,
+    Cpa32U *count)
 {
     CpaStatus status = CPA_STATUS_SUCCESS;
     lz4_hdr_t *header_ptr;
@@ -136,7 +145,7 @@ CpaStatus dc_lz4_generate_header(const CpaFlatBuffer *dest_buff,
     header_ptr->magic = DC_LZ4_FH_ID;
     header_ptr->bit_field.version = DC_LZ4_FH_FLG_VERSION;
     header_ptr->bit_field.blk_indep = block_indep;
-    header_ptr->bit_field.cnt_cksum = 1;
+    header_ptr->bit_field.cnt_cksum = (CPA_TRUE == cnt_cksum) ? 1 : 0;
     header_ptr->blk_maxsize = max_block_size + DC_LZ4_FH_MAX_BLK_SIZE_ENUM_MIN;
 
     status = dc_hdr_cksum(&header_ptr->addr,
@@ -151,6 +160,86 @@ CpaStatus dc_lz4_generate_header(const CpaFlatBuffer *dest_buff,
     return CPA_STATUS_SUCCESS;
 }
 
+CpaStatus dc_lz4_generate_header(const CpaFlatBuffer *dest_buff,
+                                 const CpaDcCompLZ4BlockMaxSize max_block_size,
+                                 const CpaBoolean block_indep,
+                                 Cpa32U *count)
+{
+    return dc_lz4_generate_header_common(
+        dest_buff, max_block_size, block_indep, CPA_TRUE, count);
+}
+
+CpaStatus dc_lz4_generate_header_no_cksum(
+    const CpaFlatBuffer *dest_buff,
+    const CpaDcCompLZ4BlockMaxSize max_block_size,
+    const CpaBoolean block_indep,
+    Cpa32U *count)
+{
+    return dc_lz4_generate_header_common(
+        dest_buff, max_block_size, block_indep, CPA_FALSE, count);
+}
+
+CpaStatus dc_lz4_generate_header_dict(
+    const CpaFlatBuffer *dest_buff,
+    const CpaDcCompLZ4BlockMaxSize max_block_size,
+    const CpaBoolean block_indep,
+    const Cpa32U dict_id,
+    Cpa32U *count)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+    lz4_hdr_t *header_ptr;
+    Cpa8U *dict_id_ptr;
+    Cpa8U hdr_cksum = 0;
+
+    /* Check parameters */
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_PARAM_RANGE(block_indep, 0, 2);
+    LAC_CHECK_NULL_PARAM(dest_buff);
+    LAC_CHECK_NULL_PARAM(dest_buff->pData);
+    LAC_CHECK_NULL_PARAM(count);
+    LAC_CHECK_PARAM_RANGE(max_block_size,
+                          CPA_DC_LZ4_MAX_BLOCK_SIZE_64K,
+                          CPA_DC_LZ4_MAX_BLOCK_SIZE_4M + 1);
+    if (dest_buff->dataLenInBytes < DC_LZ4_HEADER_SIZE + DC_LZ4_DICT_ID_SIZE)
+    {
+        LAC_INVALID_PARAM_LOG("The dataLenInBytes of the dest buffer "
+                              "is too small");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+#endif
+
+    osalMemSet(dest_buff->pData, 0, DC_LZ4_HEADER_SIZE + DC_LZ4_DICT_ID_SIZE);
+    header_ptr = (lz4_hdr_t *)dest_buff->pData;
+
+    header_ptr->magic = DC_LZ4_FH_ID;
+    header_ptr->bit_field.version = DC_LZ4_FH_FLG_VERSION;
+    header_ptr->bit_field.blk_indep = block_indep;
+    header_ptr->bit_field.cnt_cksum = 1;
+    header_ptr->bit_field.dict_id = 1;
+    header_ptr->blk_maxsize = max_block_size + DC_LZ4_FH_MAX_BLK_SIZE_ENUM_MIN;
+
+    /* The dictionary id follows the BD byte, little endian */
+    dict_id_ptr = &header_ptr->hdr_cksum;
+    dict_id_ptr[0] = (Cpa8U)dict_id;
+    dict_id_ptr[1] = (Cpa8U)(dict_id >> 8);
+    dict_id_ptr[2] = (Cpa8U)(dict_id >> 16);
+    dict_id_ptr[3] = (Cpa8U)(dict_id >> 24);
+
+    status = dc_hdr_cksum(&header_ptr->addr,
+                          (Cpa32U)(&header_ptr->hdr_cksum - &header_ptr->addr) +
+                              DC_LZ4_DICT_ID_SIZE,
+                          &hdr_cksum);
+
+    if (status != CPA_STATUS_SUCCESS)
+        return CPA_STATUS_FAIL;
+
+    dict_id_ptr[DC_LZ4_DICT_ID_SIZE] = hdr_cksum;
+
+    *count = (Cpa32U)(DC_LZ4_HEADER_SIZE + DC_LZ4_DICT_ID_SIZE);
+
+    return CPA_STATUS_SUCCESS;
+}
+
 CpaStatus dc_lz4_generate_footer(const CpaFlatBuffer *dest_buff,
                                  const CpaDcRqResults *pRes)
 {
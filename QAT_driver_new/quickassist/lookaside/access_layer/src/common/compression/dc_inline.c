@@ -0,0 +1,429 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_inline.c
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Implementation of the inline processing of small stateless requests.
+ *
+ *      A device round trip costs more than compressing a few tens of bytes
+ *      on the CPU. Compression uses the fixed Huffman encoder of the
+ *      dictionary sessions and falls back to a stored block when that does
+ *      not save space, as for random data. Decompression uses the table
+ *      driven inflater of the compress and verify pool. Both work in place
+ *      on buffer lists of a single flat buffer, the usual case for small
+ *      requests, and through per-thread copies otherwise.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "dc_dict.h"
+#include "dc_cnv_verify.h"
+#include "dc_precheck.h"
+#include "dc_inline.h"
+#include "lac_common.h"
+
+/* Deflate stored block header */
+#define DC_INLINE_STORED_HDR_SIZE (5)
+
+/* Flat copies of the buffer lists split across several buffers */
+static __thread Cpa8U dcInlineInCopy[DC_INLINE_MAX_THRESHOLD];
+static __thread Cpa8U dcInlineOutCopy[DC_INLINE_MAX_OUTPUT];
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Total length of a buffer list, saturated to 32 bits
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcInlineSglLength(const CpaBufferList *pList)
+{
+    Cpa64U len = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; i < pList->numBuffers; i++)
+    {
+        len += pList->pBuffers[i].dataLenInBytes;
+    }
+    return (len > 0xFFFFFFFF) ? 0xFFFFFFFF : (Cpa32U)len;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      First buffer of a buffer list if it holds the first len bytes
+ *
+ *****************************************************************************/
+STATIC Cpa8U *dcInlineFlat(const CpaBufferList *pList, Cpa32U len)
+{
+    if ((0 != pList->numBuffers) && (pList->pBuffers[0].dataLenInBytes >= len))
+    {
+        return pList->pBuffers[0].pData;
+    }
+    return NULL;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Copy the first bytes of a buffer list to a flat buffer
+ *
+ *****************************************************************************/
+STATIC void dcInlineCopyFromSgl(Cpa8U *pDst,
+                                const CpaBufferList *pList,
+                                Cpa32U len)
+{
+    Cpa32U chunk = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; (i < pList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        osalMemCopy(pDst, pList->pBuffers[i].pData, chunk);
+        pDst += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Copy a flat buffer to the start of a buffer list
+ *
+ *****************************************************************************/
+STATIC void dcInlineCopyToSgl(CpaBufferList *pList,
+                              const Cpa8U *pSrc,
+                              Cpa32U len)
+{
+    Cpa32U chunk = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; (i < pList->numBuffers) && (len > 0); i++)
+    {
+        chunk = pList->pBuffers[i].dataLenInBytes;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        osalMemCopy(pList->pBuffers[i].pData, pSrc, chunk);
+        pSrc += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Checksum of the uncompressed data of a request
+ *
+ *****************************************************************************/
+STATIC void dcInlineChecksum(const dc_session_desc_t *pSessionDesc,
+                             CpaBufferList *pList,
+                             Cpa32U len,
+                             CpaDcRqResults *pResults)
+{
+    Cpa32U seed = 0;
+
+    if (CPA_DC_NONE == pSessionDesc->checksumType)
+    {
+        return;
+    }
+    if (DC_REQUEST_SUBSEQUENT == pSessionDesc->requestType)
+    {
+        seed = pResults->checksum;
+    }
+    else
+    {
+        seed = (CPA_DC_ADLER32 == pSessionDesc->checksumType)
+                   ? DC_DEFAULT_ADLER32
+                   : DC_DEFAULT_CRC;
+    }
+    pResults->checksum =
+        dcDictChecksumSgl(pSessionDesc->checksumType, pList, len, seed);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Compress a small request
+ *
+ * @description
+ *      The fixed Huffman output is only kept when it is shorter than the
+ *      source, so it always beats a stored block of the same data. When
+ *      it is not, the stored block overwrites what the encoder wrote to
+ *      the destination.
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcInlineCompress(dc_session_desc_t *pSessionDesc,
+                                   CpaBufferList *pSrcBuff,
+                                   CpaBufferList *pDestBuff,
+                                   CpaDcRqResults *pResults,
+                                   CpaDcFlush flushFlag,
+                                   Cpa32U srcLen)
+{
+    Cpa32U destLen = dcInlineSglLength(pDestBuff);
+    Cpa32U outLen = (destLen < srcLen) ? destLen : srcLen;
+    const Cpa8U *pIn = dcInlineFlat(pSrcBuff, srcLen);
+    Cpa8U *pOut = dcInlineFlat(pDestBuff, outLen);
+    Cpa32U produced = 0;
+
+    if (NULL == pIn)
+    {
+        dcInlineCopyFromSgl(dcInlineInCopy, pSrcBuff, srcLen);
+        pIn = dcInlineInCopy;
+    }
+    if (NULL == pOut)
+    {
+        pOut = dcInlineOutCopy;
+    }
+    produced = dcDictDeflateBuffer(
+        pIn,
+        srcLen,
+        pOut,
+        outLen,
+        (CPA_DC_FLUSH_FINAL == flushFlag) ? CPA_TRUE : CPA_FALSE);
+
+    if (0 == produced)
+    {
+        if (srcLen + DC_INLINE_STORED_HDR_SIZE > destLen)
+        {
+            /* Let the device report the overflow */
+            return CPA_FALSE;
+        }
+        /* Sets the request type of the session */
+        dcPrecheckStore(pSessionDesc, pSrcBuff, pDestBuff, pResults, flushFlag);
+        return CPA_TRUE;
+    }
+
+    if (dcInlineOutCopy == pOut)
+    {
+        dcInlineCopyToSgl(pDestBuff, dcInlineOutCopy, produced);
+    }
+    dcInlineChecksum(pSessionDesc, pSrcBuff, srcLen, pResults);
+    pResults->status = CPA_DC_OK;
+    pResults->consumed = srcLen;
+    pResults->produced = produced;
+    pResults->endOfLastBlock = CPA_FALSE;
+    pResults->dataUncompressed = CPA_FALSE;
+
+    return CPA_TRUE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Decompress a small request
+ *
+ * @description
+ *      When the data cannot be inflated here, the device run of the
+ *      request overwrites what was written to the destination.
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcInlineDecompress(dc_session_desc_t *pSessionDesc,
+                                     CpaBufferList *pSrcBuff,
+                                     CpaBufferList *pDestBuff,
+                                     CpaDcRqResults *pResults,
+                                     Cpa32U srcLen)
+{
+    Cpa32U destLen = dcInlineSglLength(pDestBuff);
+    Cpa32U outLen =
+        (destLen < DC_INLINE_MAX_OUTPUT) ? destLen : DC_INLINE_MAX_OUTPUT;
+    const Cpa8U *pIn = dcInlineFlat(pSrcBuff, srcLen);
+    Cpa8U *pOut = dcInlineFlat(pDestBuff, outLen);
+    Cpa32U consumed = 0;
+    Cpa32U produced = 0;
+
+    if (NULL == pIn)
+    {
+        dcInlineCopyFromSgl(dcInlineInCopy, pSrcBuff, srcLen);
+        pIn = dcInlineInCopy;
+    }
+    if (NULL == pOut)
+    {
+        pOut = dcInlineOutCopy;
+    }
+
+    if (CPA_TRUE != dcCnvInflateBuffer(
+                        pIn, srcLen, pOut, outLen, &consumed, &produced))
+    {
+        /* Let the device report the error or the overflow */
+        return CPA_FALSE;
+    }
+
+    if (dcInlineOutCopy == pOut)
+    {
+        dcInlineCopyToSgl(pDestBuff, dcInlineOutCopy, produced);
+    }
+    dcInlineChecksum(pSessionDesc, pDestBuff, produced, pResults);
+    pResults->status = CPA_DC_OK;
+    pResults->consumed = consumed;
+    pResults->produced = produced;
+    pResults->endOfLastBlock = CPA_TRUE;
+    pResults->dataUncompressed = CPA_FALSE;
+
+    return CPA_TRUE;
+}
+
+CpaStatus dcSetInlineThreshold(CpaInstanceHandle dcInstance,
+                               CpaDcSessionHandle pSessionHandle,
+                               Cpa32U threshold)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if (threshold > DC_INLINE_MAX_THRESHOLD)
+    {
+        LAC_INVALID_PARAM_LOG("Invalid inline threshold");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (0 != threshold)
+    {
+        if ((CPA_DC_STATELESS != pSessionDesc->sessState) ||
+            (CPA_TRUE == pSessionDesc->isDcDp))
+        {
+            LAC_INVALID_PARAM_LOG("Inline processing requires a stateless "
+                                  "session");
+            return CPA_STATUS_INVALID_PARAM;
+        }
+        if ((CPA_DC_DEFLATE != pSessionDesc->compType) ||
+            ((CPA_DC_NONE != pSessionDesc->checksumType) &&
+             (CPA_DC_CRC32 != pSessionDesc->checksumType) &&
+             (CPA_DC_ADLER32 != pSessionDesc->checksumType)))
+        {
+            LAC_INVALID_PARAM_LOG("Inline processing supports Deflate with "
+                                  "no, CRC32 or Adler32 checksum");
+            return CPA_STATUS_UNSUPPORTED;
+        }
+    }
+
+    if (0 != osalAtomicGet(&(pSessionDesc->pendingStatelessCbCount)))
+    {
+        return CPA_STATUS_RETRY;
+    }
+
+    pSessionDesc->inlineThreshold = threshold;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaBoolean dcInlineProcess(dc_session_desc_t *pSessionDesc,
+                           CpaBufferList *pSrcBuff,
+                           CpaBufferList *pDestBuff,
+                           CpaDcRqResults *pResults,
+                           CpaDcFlush flushFlag,
+                           const CpaDcOpData *pOpData,
+                           dc_request_dir_t compDecomp)
+{
+    Cpa32U srcLen = 0;
+
+    if (0 == pSessionDesc->inlineThreshold)
+    {
+        return CPA_FALSE;
+    }
+
+    /* End to end integrity CRCs are produced by the device */
+    if ((NULL != pOpData) && (CPA_TRUE == pOpData->integrityCrcCheck))
+    {
+        return CPA_FALSE;
+    }
+
+    /* Zero length requests keep the empty block produced by the device */
+    srcLen = dcInlineSglLength(pSrcBuff);
+    if ((0 == srcLen) || (srcLen >= pSessionDesc->inlineThreshold))
+    {
+        return CPA_FALSE;
+    }
+
+    if (DC_COMPRESSION_REQUEST == compDecomp)
+    {
+        if (CPA_TRUE != dcInlineCompress(pSessionDesc,
+                                         pSrcBuff,
+                                         pDestBuff,
+                                         pResults,
+                                         flushFlag,
+                                         srcLen))
+        {
+            return CPA_FALSE;
+        }
+    }
+    else if (CPA_TRUE != dcInlineDecompress(pSessionDesc,
+                                            pSrcBuff,
+                                            pDestBuff,
+                                            pResults,
+                                            srcLen))
+    {
+        return CPA_FALSE;
+    }
+    pSessionDesc->requestType = (CPA_DC_FLUSH_FINAL == flushFlag)
+                                    ? DC_REQUEST_FIRST
+                                    : DC_REQUEST_SUBSEQUENT;
+
+    return CPA_TRUE;
+}
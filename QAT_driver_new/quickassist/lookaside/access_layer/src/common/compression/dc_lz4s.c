@@ -0,0 +1,453 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_lz4s.c
+ *
+ * @ingroup SalDcLZ4S
+ *
+ * @description
+ *      Software post-processing of LZ4s data.
+ *
+ *      An LZ4s sequence has the layout of an LZ4 sequence: a token holding
+ *      the literal and match length nibbles, the literal length extension,
+ *      the literals, a 16 bit little endian offset and the match length
+ *      extension. The match length is stored minus two and a zero match
+ *      length marks a sequence without a match, whose offset is ignored.
+ *      The last sequence of a request stops after its literals.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "icp_sal_dc_lz4s.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "lac_common.h"
+
+/* Number of bits of the match length in a sequence token */
+#define DC_LZ4S_ML_BITS (4)
+#define DC_LZ4S_ML_MASK ((1U << DC_LZ4S_ML_BITS) - 1)
+#define DC_LZ4S_RUN_MASK DC_LZ4S_ML_MASK
+
+/* Bias of the LZ4s match length field */
+#define DC_LZ4S_MATCH_BIAS (2)
+
+/* Size of the offset field of a sequence */
+#define DC_LZ4S_OFFSET_SIZE (2)
+
+/* Minimum match length of the LZ4 block format */
+#define DC_LZ4_MIN_MATCH (4)
+
+/* The last match of an LZ4 block must start at least this many bytes
+ * before the end of the block */
+#define DC_LZ4_MF_LIMIT (12)
+
+/* The last bytes of an LZ4 block are always literals */
+#define DC_LZ4_LAST_LITERALS (5)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcLZ4S
+ *      Decoded LZ4s sequence
+ *
+ *****************************************************************************/
+typedef struct dc_lz4s_seq_s
+{
+    Cpa32U litLength;
+    Cpa32U matchLength;
+    /**< Zero if the sequence has no match */
+    Cpa32U offset;
+} dc_lz4s_seq_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcLZ4S
+ *      Read a length extension
+ *
+ * @description
+ *      Adds the extension bytes following a saturated length nibble to
+ *      *pLength. Lengths larger than limit can not describe the data of
+ *      the request and are rejected.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcLZ4SReadLength(const Cpa8U **ppIn,
+                                  const Cpa8U *pEnd,
+                                  Cpa32U limit,
+                                  Cpa32U *pLength)
+{
+    const Cpa8U *pIn = *ppIn;
+    Cpa32U length = *pLength;
+    Cpa8U byte = 0;
+
+    do
+    {
+        if ((pIn >= pEnd) || (length > limit))
+        {
+            return CPA_STATUS_FAIL;
+        }
+        byte = *pIn++;
+        length += byte;
+    } while (0xFF == byte);
+
+    *ppIn = pIn;
+    *pLength = length;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcLZ4S
+ *      Decode the next LZ4s sequence
+ *
+ * @description
+ *      Reads the sequence at *ppIn and advances *ppIn past it. The last
+ *      sequence of the data is returned without a match.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcLZ4SNextSeq(const Cpa8U **ppIn,
+                               const Cpa8U *pEnd,
+                               Cpa32U srcLen,
+                               dc_lz4s_seq_t *pSeq)
+{
+    const Cpa8U *pIn = *ppIn;
+    Cpa32U token = *pIn++;
+    Cpa32U length = token >> DC_LZ4S_ML_BITS;
+
+    if (DC_LZ4S_RUN_MASK == length)
+    {
+        if (CPA_STATUS_SUCCESS !=
+            dcLZ4SReadLength(&pIn, pEnd, srcLen, &length))
+        {
+            return CPA_STATUS_FAIL;
+        }
+    }
+    if (length > (Cpa32U)(pEnd - pIn))
+    {
+        return CPA_STATUS_FAIL;
+    }
+    /* The literals are taken from the uncompressed data */
+    pIn += length;
+    pSeq->litLength = length;
+    pSeq->matchLength = 0;
+    pSeq->offset = 0;
+
+    if (pIn == pEnd)
+    {
+        *ppIn = pIn;
+        return CPA_STATUS_SUCCESS;
+    }
+
+    if ((Cpa32U)(pEnd - pIn) < DC_LZ4S_OFFSET_SIZE)
+    {
+        return CPA_STATUS_FAIL;
+    }
+    pSeq->offset = (Cpa32U)pIn[0] | ((Cpa32U)pIn[1] << 8);
+    pIn += DC_LZ4S_OFFSET_SIZE;
+
+    length = token & DC_LZ4S_ML_MASK;
+    if (DC_LZ4S_ML_MASK == length)
+    {
+        if (CPA_STATUS_SUCCESS !=
+            dcLZ4SReadLength(&pIn, pEnd, srcLen, &length))
+        {
+            return CPA_STATUS_FAIL;
+        }
+    }
+    if (0 != length)
+    {
+        pSeq->matchLength = length + DC_LZ4S_MATCH_BIAS;
+    }
+
+    *ppIn = pIn;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcLZ4S
+ *      Write a length extension
+ *
+ *****************************************************************************/
+STATIC Cpa8U *dcLZ4WriteLength(Cpa8U *pOut, Cpa32U length)
+{
+    while (length >= 0xFF)
+    {
+        *pOut++ = 0xFF;
+        length -= 0xFF;
+    }
+    *pOut++ = (Cpa8U)length;
+
+    return pOut;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcLZ4S
+ *      Write an LZ4 sequence
+ *
+ * @description
+ *      A zero matchLength writes the last sequence of the block, which
+ *      only holds literals.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcLZ4WriteSeq(Cpa8U **ppOut,
+                               const Cpa8U *pOutEnd,
+                               const Cpa8U *pLiterals,
+                               Cpa32U litLength,
+                               Cpa32U offset,
+                               Cpa32U matchLength)
+{
+    Cpa8U *pOut = *ppOut;
+    Cpa8U *pToken = NULL;
+    Cpa32U token = 0;
+    Cpa64U needed = 0;
+
+    needed = 1 + (litLength / 0xFF) + 1 + (Cpa64U)litLength +
+             DC_LZ4S_OFFSET_SIZE + (matchLength / 0xFF) + 1;
+    if (needed > (Cpa64U)(pOutEnd - pOut))
+    {
+        return CPA_STATUS_FAIL;
+    }
+
+    pToken = pOut++;
+    if (litLength >= DC_LZ4S_RUN_MASK)
+    {
+        token = DC_LZ4S_RUN_MASK << DC_LZ4S_ML_BITS;
+        pOut = dcLZ4WriteLength(pOut, litLength - DC_LZ4S_RUN_MASK);
+    }
+    else
+    {
+        token = litLength << DC_LZ4S_ML_BITS;
+    }
+    memcpy(pOut, pLiterals, litLength);
+    pOut += litLength;
+
+    if (0 != matchLength)
+    {
+        *pOut++ = (Cpa8U)offset;
+        *pOut++ = (Cpa8U)(offset >> 8);
+        matchLength -= DC_LZ4_MIN_MATCH;
+        if (matchLength >= DC_LZ4S_ML_MASK)
+        {
+            token |= DC_LZ4S_ML_MASK;
+            pOut = dcLZ4WriteLength(pOut, matchLength - DC_LZ4S_ML_MASK);
+        }
+        else
+        {
+            token |= matchLength;
+        }
+    }
+    *pToken = (Cpa8U)token;
+    *ppOut = pOut;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcLZ4SToLZ4Block(const Cpa8U *pSrc,
+                                   Cpa32U srcLen,
+                                   const Cpa8U *pLZ4S,
+                                   Cpa32U lz4sLen,
+                                   Cpa8U *pDst,
+                                   Cpa32U dstLen,
+                                   Cpa32U *pProduced)
+{
+    const Cpa8U *pIn = pLZ4S;
+    const Cpa8U *pInEnd = NULL;
+    Cpa8U *pOut = pDst;
+    const Cpa8U *pOutEnd = NULL;
+    dc_lz4s_seq_t seq = {0};
+    Cpa32U pos = 0;
+    Cpa32U litStart = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pDst);
+    LAC_CHECK_NULL_PARAM(pProduced);
+    if (0 != srcLen)
+    {
+        LAC_CHECK_NULL_PARAM(pSrc);
+        LAC_CHECK_NULL_PARAM(pLZ4S);
+    }
+    pInEnd = pLZ4S + lz4sLen;
+    pOutEnd = pDst + dstLen;
+
+    while ((CPA_STATUS_SUCCESS == status) && (pIn < pInEnd))
+    {
+        status = dcLZ4SNextSeq(&pIn, pInEnd, srcLen, &seq);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            break;
+        }
+        if (seq.litLength > srcLen - pos)
+        {
+            status = CPA_STATUS_FAIL;
+            break;
+        }
+        pos += seq.litLength;
+        if (0 == seq.matchLength)
+        {
+            continue;
+        }
+        if ((0 == seq.offset) || (seq.offset > pos) ||
+            (seq.matchLength > srcLen - pos))
+        {
+            status = CPA_STATUS_FAIL;
+            break;
+        }
+        /* Matches the LZ4 format can not express stay literals */
+        if ((seq.matchLength >= DC_LZ4_MIN_MATCH) &&
+            (pos + DC_LZ4_MF_LIMIT <= srcLen) &&
+            (pos + seq.matchLength + DC_LZ4_LAST_LITERALS <= srcLen))
+        {
+            status = dcLZ4WriteSeq(&pOut,
+                                   pOutEnd,
+                                   pSrc + litStart,
+                                   pos - litStart,
+                                   seq.offset,
+                                   seq.matchLength);
+            litStart = pos + seq.matchLength;
+        }
+        pos += seq.matchLength;
+    }
+
+    if ((CPA_STATUS_SUCCESS == status) && (pos != srcLen))
+    {
+        status = CPA_STATUS_FAIL;
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcLZ4WriteSeq(
+            &pOut, pOutEnd, pSrc + litStart, srcLen - litStart, 0, 0);
+    }
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to convert LZ4s data to an LZ4 block");
+        return status;
+    }
+
+    *pProduced = (Cpa32U)(pOut - pDst);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcLZ4SToSequences(const Cpa8U *pLZ4S,
+                                    Cpa32U lz4sLen,
+                                    Cpa32U srcLen,
+                                    icp_sal_dc_sequence_t *pSeqs,
+                                    Cpa32U maxSeqs,
+                                    Cpa32U *pNumSeqs)
+{
+    const Cpa8U *pIn = pLZ4S;
+    const Cpa8U *pInEnd = NULL;
+    dc_lz4s_seq_t seq = {0};
+    Cpa32U pos = 0;
+    Cpa32U literals = 0;
+    Cpa32U numSeqs = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pSeqs);
+    LAC_CHECK_NULL_PARAM(pNumSeqs);
+    if (0 != srcLen)
+    {
+        LAC_CHECK_NULL_PARAM(pLZ4S);
+    }
+    if (0 == maxSeqs)
+    {
+        LAC_INVALID_PARAM_LOG("Invalid maxSeqs value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    pInEnd = pLZ4S + lz4sLen;
+
+    while ((CPA_STATUS_SUCCESS == status) && (pIn < pInEnd))
+    {
+        status = dcLZ4SNextSeq(&pIn, pInEnd, srcLen, &seq);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            break;
+        }
+        if (seq.litLength > srcLen - pos)
+        {
+            status = CPA_STATUS_FAIL;
+            break;
+        }
+        pos += seq.litLength;
+        literals += seq.litLength;
+        if (0 == seq.matchLength)
+        {
+            continue;
+        }
+        /* One entry is kept for the block delimiter */
+        if ((0 == seq.offset) || (seq.offset > pos) ||
+            (seq.matchLength > srcLen - pos) || (numSeqs + 1 >= maxSeqs))
+        {
+            status = CPA_STATUS_FAIL;
+            break;
+        }
+        pSeqs[numSeqs].offset = seq.offset;
+        pSeqs[numSeqs].litLength = literals;
+        pSeqs[numSeqs].matchLength = seq.matchLength;
+        pSeqs[numSeqs].rep = 0;
+        numSeqs++;
+        literals = 0;
+        pos += seq.matchLength;
+    }
+
+    if ((CPA_STATUS_SUCCESS != status) || (pos != srcLen))
+    {
+        LAC_LOG_ERROR("Failed to convert LZ4s data to sequences");
+        return CPA_STATUS_FAIL;
+    }
+
+    pSeqs[numSeqs].offset = 0;
+    pSeqs[numSeqs].litLength = literals;
+    pSeqs[numSeqs].matchLength = 0;
+    pSeqs[numSeqs].rep = 0;
+    *pNumSeqs = numSeqs + 1;
+
+    return CPA_STATUS_SUCCESS;
+}
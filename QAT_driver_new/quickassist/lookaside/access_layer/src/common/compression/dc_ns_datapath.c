@@ -434,7 +434,7 @@ void dcNsCompression_ProcessCallback(void *pRespMsg)
         if (isDcDp)
         {
             pDpOpData->responseStatus = status;
-            (pService->pDcDpCb)(pDpOpData);
+            DC_DP_COMPLETE(pService, pDpOpData);
         }
         else
         {
@@ -686,7 +686,7 @@ void dcNsCompression_ProcessCallback(void *pRespMsg)
 
     if (isDcDp)
     {
-        (pService->pDcDpCb)(pDpOpData);
+        DC_DP_COMPLETE(pService, pDpOpData);
     }
     else
     {
@@ -0,0 +1,900 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_par_decomp.c
+ *
+ * @ingroup SalDcParDecomp
+ *
+ * @description
+ *      Implementation of the parallel multi-member gzip decompression.
+ *
+ *      The input is first split at every offset holding a plausible gzip
+ *      member header. Members are then submitted in order to a ring of
+ *      slots, each slot bound to one instance, and drained in order at the
+ *      head of the ring. A member is accepted when its request consumed the
+ *      whole deflate data up to the trailer, ended with the final block and
+ *      produced the size recorded in the trailer; its CRC-32 is then
+ *      checked against the trailer. A member whose result looks truncated
+ *      is taken as cut by a false boundary: the outstanding requests are
+ *      waited for, the member is merged with the next one and the ring
+ *      restarts from it. Decode errors can not be caused by a truncation
+ *      and fail the decompression at once, so corrupt input is not
+ *      decompressed again member after member. The destination of a
+ *      request is sized from the trailer, so no worst case output buffer
+ *      is needed.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "icp_sal_poll.h"
+#include "icp_sal_dc_par_decomp.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "sal_types_compression.h"
+#include "sal_service_state.h"
+
+/* Gzip header fields from RFC 1952 */
+#define DC_PAR_GZIP_ID1 (0x1F)
+#define DC_PAR_GZIP_ID2 (0x8B)
+#define DC_PAR_GZIP_CM_DEFLATE (8)
+#define DC_PAR_GZIP_FHCRC (0x02)
+#define DC_PAR_GZIP_FEXTRA (0x04)
+#define DC_PAR_GZIP_FNAME (0x08)
+#define DC_PAR_GZIP_FCOMMENT (0x10)
+#define DC_PAR_GZIP_FRESERVED (0xE0)
+#define DC_PAR_GZIP_OS_UNKNOWN (255)
+#define DC_PAR_GZIP_OS_MAX (13)
+
+/* Size of the fixed part of a gzip header */
+#define DC_PAR_GZIP_HDR_SIZE (10)
+
+/* Size of a gzip trailer: CRC-32 and input size */
+#define DC_PAR_GZIP_TRAILER_SIZE (8)
+
+/* Smallest member: header, empty fixed Huffman block and trailer */
+#define DC_PAR_MIN_MEMBER_SIZE                                                 \
+    (DC_PAR_GZIP_HDR_SIZE + 2 + DC_PAR_GZIP_TRAILER_SIZE)
+
+/* Largest optional header field accepted */
+#define DC_PAR_MAX_HDR_SIZE (64 * 1024)
+
+/* Smallest destination buffer of a request */
+#define DC_PAR_MIN_DST_SIZE (64)
+
+/* Initial capacity of the member boundary array */
+#define DC_PAR_INIT_BOUNDS (64)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Decompression slot
+ *
+ *****************************************************************************/
+typedef struct dc_par_slot_s
+{
+    CpaBufferList srcList;
+    CpaFlatBuffer srcFlat;
+    CpaBufferList dstList;
+    CpaFlatBuffer dstFlat;
+    Cpa8U *pSrcData;
+    /**< Pinned deflate data of the member */
+    Cpa8U *pDstData;
+    /**< Pinned decompressed data of the member */
+    Cpa32U srcSize;
+    /**< Size of pSrcData */
+    Cpa32U dstSize;
+    /**< Size of pDstData */
+    Cpa32U instance;
+    /**< Index of the instance the slot submits to */
+    Cpa32U deflateLen;
+    /**< Length of the deflate data of the member */
+    Cpa32U expectedCrc;
+    /**< CRC-32 recorded in the member trailer */
+    Cpa32U expectedSize;
+    /**< Size recorded in the member trailer */
+    CpaBoolean submitted;
+    /**< Cleared when the bounds of the member are not valid */
+    CpaBoolean tooLarge;
+    /**< The trailer records more than maxMemberSize bytes */
+    CpaDcOpData opData;
+    CpaDcRqResults results;
+    volatile CpaBoolean inFlight;
+    /**< Set while the request is owned by the instance */
+    volatile CpaStatus cbStatus;
+    /**< Status passed to the completion callback */
+} dc_par_slot_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Parallel decompression descriptor
+ *
+ *****************************************************************************/
+typedef struct dc_par_s
+{
+    CpaInstanceHandle instances[ICP_SAL_DC_PAR_MAX_INSTANCES];
+    CpaDcSessionHandle pSessionHandles[ICP_SAL_DC_PAR_MAX_INSTANCES];
+    Cpa32U numInstances;
+    dc_par_slot_t *pSlots;
+    Cpa32U numSlots;
+    Cpa64U *pBounds;
+    /**< Offsets of the member headers followed by the input length */
+    Cpa32U numMembers;
+    Cpa32U boundsSize;
+    /**< Number of entries allocated in pBounds */
+    const Cpa8U *pSrc;
+    Cpa64U srcLen;
+    Cpa32U maxMemberSize;
+    icp_sal_dc_par_output_fn_t pOutputFn;
+    void *pOutputTag;
+    Cpa64U produced;
+} dc_par_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Completion callback of the decompression requests
+ *
+ *****************************************************************************/
+STATIC void dcParCallback(void *callbackTag, CpaStatus status)
+{
+    dc_par_slot_t *pSlot = (dc_par_slot_t *)callbackTag;
+
+    pSlot->cbStatus = status;
+    pSlot->inFlight = CPA_FALSE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Read a little endian 32 bit value
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcParGetLe32(const Cpa8U *p)
+{
+    return (Cpa32U)p[0] | ((Cpa32U)p[1] << 8) | ((Cpa32U)p[2] << 16) |
+           ((Cpa32U)p[3] << 24);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Parse a gzip member header
+ *
+ * @description
+ *      Candidate headers found by the scan must also carry extra flags and
+ *      an operating system value defined by RFC 1952, which makes matches
+ *      inside compressed data rarer.
+ *
+ * @retval Length of the header, zero if pData does not hold a valid one
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcParHeaderLength(const Cpa8U *pData,
+                                Cpa64U avail,
+                                CpaBoolean strict)
+{
+    Cpa64U pos = DC_PAR_GZIP_HDR_SIZE;
+    Cpa8U flags = 0;
+
+    if ((avail < DC_PAR_GZIP_HDR_SIZE) || (DC_PAR_GZIP_ID1 != pData[0]) ||
+        (DC_PAR_GZIP_ID2 != pData[1]) ||
+        (DC_PAR_GZIP_CM_DEFLATE != pData[2]) ||
+        (0 != (pData[3] & DC_PAR_GZIP_FRESERVED)))
+    {
+        return 0;
+    }
+    if ((CPA_TRUE == strict) &&
+        (((0 != pData[8]) && (2 != pData[8]) && (4 != pData[8])) ||
+         ((pData[9] > DC_PAR_GZIP_OS_MAX) &&
+          (DC_PAR_GZIP_OS_UNKNOWN != pData[9]))))
+    {
+        return 0;
+    }
+    if (avail > DC_PAR_MAX_HDR_SIZE)
+    {
+        avail = DC_PAR_MAX_HDR_SIZE;
+    }
+
+    flags = pData[3];
+    if (0 != (flags & DC_PAR_GZIP_FEXTRA))
+    {
+        if (pos + 2 > avail)
+        {
+            return 0;
+        }
+        pos += 2 + (pData[pos] | (pData[pos + 1] << 8));
+    }
+    if (0 != (flags & DC_PAR_GZIP_FNAME))
+    {
+        while ((pos < avail) && (0 != pData[pos]))
+        {
+            pos++;
+        }
+        pos++;
+    }
+    if (0 != (flags & DC_PAR_GZIP_FCOMMENT))
+    {
+        while ((pos < avail) && (0 != pData[pos]))
+        {
+            pos++;
+        }
+        pos++;
+    }
+    if (0 != (flags & DC_PAR_GZIP_FHCRC))
+    {
+        pos += 2;
+    }
+
+    return (pos > avail) ? 0 : (Cpa32U)pos;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Append a member boundary
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcParAddBound(dc_par_t *pPar, Cpa64U offset)
+{
+    Cpa64U *pBounds = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    if (pPar->numMembers + 1 >= pPar->boundsSize)
+    {
+        status = LAC_OS_MALLOC(&pBounds,
+                               2 * pPar->boundsSize * sizeof(Cpa64U));
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            return status;
+        }
+        osalMemCopy(
+            pBounds, pPar->pBounds, pPar->boundsSize * sizeof(Cpa64U));
+        LAC_OS_FREE(pPar->pBounds);
+        pPar->pBounds = pBounds;
+        pPar->boundsSize *= 2;
+    }
+    pPar->pBounds[pPar->numMembers++] = offset;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Split the input at the candidate member headers
+ *
+ * @description
+ *      On return pBounds holds numMembers start offsets followed by the
+ *      input length.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcParScan(dc_par_t *pPar)
+{
+    const Cpa8U *pHit = NULL;
+    Cpa64U pos = 0;
+    Cpa64U last = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    if (0 == dcParHeaderLength(pPar->pSrc, pPar->srcLen, CPA_FALSE))
+    {
+        LAC_LOG_ERROR("Input does not start with a gzip header");
+        return CPA_STATUS_FAIL;
+    }
+    status = dcParAddBound(pPar, 0);
+
+    pos = DC_PAR_MIN_MEMBER_SIZE;
+    while ((CPA_STATUS_SUCCESS == status) &&
+           (pos + DC_PAR_MIN_MEMBER_SIZE <= pPar->srcLen))
+    {
+        pHit = memchr(pPar->pSrc + pos,
+                      DC_PAR_GZIP_ID1,
+                      pPar->srcLen - DC_PAR_MIN_MEMBER_SIZE + 1 - pos);
+        if (NULL == pHit)
+        {
+            break;
+        }
+        pos = pHit - pPar->pSrc;
+        if ((pos >= last + DC_PAR_MIN_MEMBER_SIZE) &&
+            (0 != dcParHeaderLength(pHit, pPar->srcLen - pos, CPA_TRUE)))
+        {
+            status = dcParAddBound(pPar, pos);
+            last = pos;
+        }
+        pos++;
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        /* Closing bound, not counted as a member */
+        status = dcParAddBound(pPar, pPar->srcLen);
+        pPar->numMembers--;
+    }
+
+    return status;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Poll all the instances once
+ *
+ *****************************************************************************/
+STATIC void dcParPoll(dc_par_t *pPar)
+{
+    CpaBoolean progress = CPA_FALSE;
+    Cpa32U i = 0;
+
+    for (i = 0; i < pPar->numInstances; i++)
+    {
+        if (CPA_STATUS_SUCCESS ==
+            icp_sal_DcPollInstance(pPar->instances[i], 0))
+        {
+            progress = CPA_TRUE;
+        }
+    }
+    if (CPA_FALSE == progress)
+    {
+        osalYield();
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Wait for the request of a slot to complete
+ *
+ *****************************************************************************/
+STATIC void dcParWait(dc_par_t *pPar, dc_par_slot_t *pSlot)
+{
+    while (CPA_TRUE == pSlot->inFlight)
+    {
+        dcParPoll(pPar);
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Make sure a pinned slot buffer holds at least size bytes
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcParReserve(dc_par_t *pPar,
+                              Cpa32U instance,
+                              Cpa8U **ppData,
+                              Cpa32U *pSize,
+                              Cpa32U size)
+{
+    sal_compression_service_t *pService =
+        (sal_compression_service_t *)pPar->instances[instance];
+
+    if (size <= *pSize)
+    {
+        return CPA_STATUS_SUCCESS;
+    }
+
+    LAC_OS_CAFREE(*ppData);
+    *pSize = 0;
+    if (CPA_STATUS_SUCCESS != LAC_OS_CAMALLOC(ppData,
+                                              size,
+                                              LAC_64BYTE_ALIGNMENT,
+                                              pService->nodeAffinity))
+    {
+        return CPA_STATUS_RESOURCE;
+    }
+    *pSize = size;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Submit a member from a slot
+ *
+ * @description
+ *      A member whose bounds can not hold a member is not submitted; it is
+ *      rejected when it reaches the head of the ring.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcParSubmit(dc_par_t *pPar,
+                             dc_par_slot_t *pSlot,
+                             Cpa32U member)
+{
+    const Cpa8U *pMember = pPar->pSrc + pPar->pBounds[member];
+    Cpa64U memberLen = pPar->pBounds[member + 1] - pPar->pBounds[member];
+    Cpa32U hdrLen = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    pSlot->submitted = CPA_FALSE;
+    pSlot->tooLarge = CPA_FALSE;
+    osalMemSet(&pSlot->results, 0, sizeof(CpaDcRqResults));
+
+    hdrLen = dcParHeaderLength(pMember, memberLen, CPA_FALSE);
+    if ((0 == hdrLen) ||
+        (memberLen < (Cpa64U)hdrLen + DC_PAR_GZIP_TRAILER_SIZE + 1) ||
+        (memberLen - hdrLen - DC_PAR_GZIP_TRAILER_SIZE > 0xFFFFFFFF))
+    {
+        return CPA_STATUS_SUCCESS;
+    }
+    pSlot->deflateLen =
+        (Cpa32U)(memberLen - hdrLen - DC_PAR_GZIP_TRAILER_SIZE);
+    pSlot->expectedCrc =
+        dcParGetLe32(pMember + memberLen - DC_PAR_GZIP_TRAILER_SIZE);
+    pSlot->expectedSize = dcParGetLe32(pMember + memberLen - 4);
+    if (pSlot->expectedSize > pPar->maxMemberSize)
+    {
+        pSlot->tooLarge = CPA_TRUE;
+        return CPA_STATUS_SUCCESS;
+    }
+
+    status = dcParReserve(pPar,
+                          pSlot->instance,
+                          &pSlot->pSrcData,
+                          &pSlot->srcSize,
+                          pSlot->deflateLen);
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcParReserve(pPar,
+                              pSlot->instance,
+                              &pSlot->pDstData,
+                              &pSlot->dstSize,
+                              (pSlot->expectedSize < DC_PAR_MIN_DST_SIZE)
+                                  ? DC_PAR_MIN_DST_SIZE
+                                  : pSlot->expectedSize);
+    }
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    osalMemCopy(pSlot->pSrcData, pMember + hdrLen, pSlot->deflateLen);
+    pSlot->srcFlat.pData = pSlot->pSrcData;
+    pSlot->srcFlat.dataLenInBytes = pSlot->deflateLen;
+    pSlot->dstFlat.pData = pSlot->pDstData;
+    pSlot->dstFlat.dataLenInBytes = pSlot->dstSize;
+
+    osalMemSet(&pSlot->opData, 0, sizeof(CpaDcOpData));
+    pSlot->opData.flushFlag = CPA_DC_FLUSH_FINAL;
+
+    pSlot->cbStatus = CPA_STATUS_SUCCESS;
+    pSlot->inFlight = CPA_TRUE;
+
+    do
+    {
+        status = cpaDcDecompressData2(pPar->instances[pSlot->instance],
+                                      pPar->pSessionHandles[pSlot->instance],
+                                      &pSlot->srcList,
+                                      &pSlot->dstList,
+                                      &pSlot->opData,
+                                      &pSlot->results,
+                                      pSlot);
+        if (CPA_STATUS_RETRY == status)
+        {
+            dcParPoll(pPar);
+        }
+    } while (CPA_STATUS_RETRY == status);
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pSlot->inFlight = CPA_FALSE;
+        LAC_LOG_ERROR("Failed to submit decompression request");
+        return status;
+    }
+    pSlot->submitted = CPA_TRUE;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Check that a completed request decompressed exactly one member
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcParMemberComplete(const dc_par_slot_t *pSlot)
+{
+    const CpaDcRqResults *pResults = &pSlot->results;
+
+    return ((CPA_TRUE == pSlot->submitted) &&
+            (CPA_STATUS_SUCCESS == pSlot->cbStatus) &&
+            (CPA_DC_OK == pResults->status) &&
+            (CPA_TRUE == pResults->endOfLastBlock) &&
+            (pResults->consumed == pSlot->deflateLen) &&
+            (pResults->produced == pSlot->expectedSize))
+               ? CPA_TRUE
+               : CPA_FALSE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Check whether a failed member may have been cut by a false boundary
+ *
+ * @description
+ *      A cut member runs out of input before its final block, or carries
+ *      a trailer read from the middle of the deflate data: the request is
+ *      then not submitted because of the recorded size, overflows the
+ *      destination sized from it or stops before the end of the input.
+ *
+ *****************************************************************************/
+STATIC CpaBoolean dcParMemberTruncated(const dc_par_slot_t *pSlot)
+{
+    const CpaDcRqResults *pResults = &pSlot->results;
+
+    if (CPA_TRUE != pSlot->submitted)
+    {
+        return CPA_TRUE;
+    }
+    if (CPA_STATUS_SUCCESS != pSlot->cbStatus)
+    {
+        return CPA_FALSE;
+    }
+    if (CPA_DC_INCOMPLETE_FILE_ERR == pResults->status)
+    {
+        return CPA_TRUE;
+    }
+    if ((CPA_DC_OK != pResults->status) &&
+        (CPA_DC_OVERFLOW != pResults->status))
+    {
+        return CPA_FALSE;
+    }
+
+    return ((CPA_TRUE != pResults->endOfLastBlock) ||
+            (pResults->consumed != pSlot->deflateLen))
+               ? CPA_TRUE
+               : CPA_FALSE;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Wait for all outstanding requests without processing their results
+ *
+ *****************************************************************************/
+STATIC void dcParQuiesce(dc_par_t *pPar)
+{
+    Cpa32U i = 0;
+
+    for (i = 0; i < pPar->numSlots; i++)
+    {
+        dcParWait(pPar, &pPar->pSlots[i]);
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Decompress all the members
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcParRun(dc_par_t *pPar)
+{
+    dc_par_slot_t *pSlot = NULL;
+    Cpa32U head = 0;
+    Cpa32U next = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    while (head < pPar->numMembers)
+    {
+        while ((next < pPar->numMembers) && (next - head < pPar->numSlots))
+        {
+            status =
+                dcParSubmit(pPar, &pPar->pSlots[next % pPar->numSlots], next);
+            if (CPA_STATUS_SUCCESS != status)
+            {
+                return status;
+            }
+            next++;
+        }
+
+        pSlot = &pPar->pSlots[head % pPar->numSlots];
+        dcParWait(pPar, pSlot);
+
+        if (CPA_TRUE != dcParMemberComplete(pSlot))
+        {
+            if ((head + 1 == pPar->numMembers) ||
+                (CPA_TRUE != dcParMemberTruncated(pSlot)))
+            {
+                LAC_LOG_ERROR("Invalid gzip member");
+                return (CPA_TRUE == pSlot->tooLarge) ? CPA_STATUS_UNSUPPORTED
+                                                     : CPA_STATUS_FAIL;
+            }
+
+            /* The next boundary was inside this member */
+            dcParQuiesce(pPar);
+            memmove(&pPar->pBounds[head + 1],
+                    &pPar->pBounds[head + 2],
+                    (pPar->numMembers - head - 1) * sizeof(Cpa64U));
+            pPar->numMembers--;
+            next = head;
+            continue;
+        }
+
+        if (pSlot->results.checksum != pSlot->expectedCrc)
+        {
+            LAC_LOG_ERROR("Gzip member CRC mismatch");
+            return CPA_STATUS_FAIL;
+        }
+
+        if (0 != pSlot->results.produced)
+        {
+            status = pPar->pOutputFn(
+                pPar->pOutputTag, pSlot->pDstData, pSlot->results.produced);
+            if (CPA_STATUS_SUCCESS != status)
+            {
+                LAC_LOG_ERROR("Output function failed");
+                return CPA_STATUS_FAIL;
+            }
+            pPar->produced += pSlot->results.produced;
+        }
+        head++;
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Release all resources of a parallel decompression
+ *
+ *****************************************************************************/
+STATIC void dcParFree(dc_par_t *pPar)
+{
+    Cpa32U i = 0;
+
+    if (NULL != pPar->pSlots)
+    {
+        dcParQuiesce(pPar);
+        for (i = 0; i < pPar->numSlots; i++)
+        {
+            dc_par_slot_t *pSlot = &pPar->pSlots[i];
+
+            LAC_OS_CAFREE(pSlot->pSrcData);
+            LAC_OS_CAFREE(pSlot->pDstData);
+            LAC_OS_CAFREE(pSlot->srcList.pPrivateMetaData);
+            LAC_OS_CAFREE(pSlot->dstList.pPrivateMetaData);
+        }
+        LAC_OS_FREE(pPar->pSlots);
+    }
+    for (i = 0; i < pPar->numInstances; i++)
+    {
+        if (NULL != pPar->pSessionHandles[i])
+        {
+            cpaDcRemoveSession(pPar->instances[i], pPar->pSessionHandles[i]);
+            LAC_OS_CAFREE(pPar->pSessionHandles[i]);
+        }
+    }
+    if (NULL != pPar->pBounds)
+    {
+        LAC_OS_FREE(pPar->pBounds);
+    }
+    LAC_OS_FREE(pPar);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcParDecomp
+ *      Initialise the decompression session of an instance
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcParInitSession(dc_par_t *pPar, Cpa32U instance)
+{
+    CpaInstanceHandle insHandle = pPar->instances[instance];
+    sal_compression_service_t *pService =
+        (sal_compression_service_t *)insHandle;
+    CpaDcSessionSetupData sd;
+    CpaDcSessionHandle pSessionHandle = NULL;
+    Cpa32U sessionSize = 0;
+    Cpa32U contextSize = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    osalMemSet(&sd, 0, sizeof(sd));
+    sd.compLevel = CPA_DC_L1;
+    sd.compType = CPA_DC_DEFLATE;
+    sd.huffType = CPA_DC_HT_FULL_DYNAMIC;
+    sd.sessDirection = CPA_DC_DIR_DECOMPRESS;
+    sd.sessState = CPA_DC_STATELESS;
+    sd.checksum = CPA_DC_CRC32;
+
+    status = cpaDcGetSessionSize(insHandle, &sd, &sessionSize, &contextSize);
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = LAC_OS_CAMALLOC(&pSessionHandle,
+                                 sessionSize,
+                                 LAC_64BYTE_ALIGNMENT,
+                                 pService->nodeAffinity);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = cpaDcInitSession(
+            insHandle, pSessionHandle, &sd, NULL, dcParCallback);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            LAC_OS_CAFREE(pSessionHandle);
+        }
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        pPar->pSessionHandles[instance] = pSessionHandle;
+    }
+
+    return status;
+}
+
+CpaStatus icp_sal_DcParallelDecompress(
+    const icp_sal_dc_par_decomp_setup_t *pSetupData,
+    const Cpa8U *pSrc,
+    Cpa64U srcLen,
+    Cpa64U *pProduced)
+{
+    dc_par_t *pPar = NULL;
+    sal_compression_service_t *pService = NULL;
+    Cpa32U metaSize = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pSetupData);
+    LAC_CHECK_NULL_PARAM(pSetupData->pInstances);
+    LAC_CHECK_NULL_PARAM(pSetupData->pOutputFn);
+    LAC_CHECK_NULL_PARAM(pSrc);
+
+    if ((0 == pSetupData->numInstances) ||
+        (pSetupData->numInstances > ICP_SAL_DC_PAR_MAX_INSTANCES))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid numInstances value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    if ((0 == pSetupData->numInFlight) ||
+        (pSetupData->numInFlight > ICP_SAL_DC_PAR_MAX_IN_FLIGHT))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid numInFlight value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    for (i = 0; i < pSetupData->numInstances; i++)
+    {
+        LAC_CHECK_NULL_PARAM(pSetupData->pInstances[i]);
+        SAL_CHECK_INSTANCE_TYPE(pSetupData->pInstances[i],
+                                SAL_SERVICE_TYPE_COMPRESSION);
+        SAL_RUNNING_CHECK(pSetupData->pInstances[i]);
+    }
+
+    status = LAC_OS_MALLOC(&pPar, sizeof(dc_par_t));
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+    osalMemSet(pPar, 0, sizeof(dc_par_t));
+
+    pPar->numInstances = pSetupData->numInstances;
+    pPar->numSlots = pSetupData->numInstances * pSetupData->numInFlight;
+    pPar->pSrc = pSrc;
+    pPar->srcLen = srcLen;
+    pPar->maxMemberSize = (0 == pSetupData->maxMemberSize)
+                              ? ICP_SAL_DC_PAR_DEFAULT_MAX_MEMBER_SIZE
+                              : pSetupData->maxMemberSize;
+    pPar->pOutputFn = pSetupData->pOutputFn;
+    pPar->pOutputTag = pSetupData->pOutputTag;
+    for (i = 0; i < pPar->numInstances; i++)
+    {
+        pPar->instances[i] = pSetupData->pInstances[i];
+    }
+
+    pPar->boundsSize = DC_PAR_INIT_BOUNDS;
+    status = LAC_OS_MALLOC(&pPar->pBounds, pPar->boundsSize * sizeof(Cpa64U));
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcParScan(pPar);
+    }
+
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < pPar->numInstances);
+         i++)
+    {
+        status = dcParInitSession(pPar, i);
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = LAC_OS_MALLOC(&pPar->pSlots,
+                               pPar->numSlots * sizeof(dc_par_slot_t));
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        osalMemSet(pPar->pSlots, 0, pPar->numSlots * sizeof(dc_par_slot_t));
+    }
+
+    /* Consecutive members go to consecutive instances */
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < pPar->numSlots); i++)
+    {
+        dc_par_slot_t *pSlot = &pPar->pSlots[i];
+
+        pSlot->instance = i % pPar->numInstances;
+        pSlot->srcList.numBuffers = 1;
+        pSlot->srcList.pBuffers = &pSlot->srcFlat;
+        pSlot->dstList.numBuffers = 1;
+        pSlot->dstList.pBuffers = &pSlot->dstFlat;
+        pService =
+            (sal_compression_service_t *)pPar->instances[pSlot->instance];
+
+        status = cpaDcBufferListGetMetaSize(
+            pPar->instances[pSlot->instance], 1, &metaSize);
+        if ((CPA_STATUS_SUCCESS == status) && (0 != metaSize))
+        {
+            status = LAC_OS_CAMALLOC(&pSlot->srcList.pPrivateMetaData,
+                                     metaSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+        if ((CPA_STATUS_SUCCESS == status) && (0 != metaSize))
+        {
+            status = LAC_OS_CAMALLOC(&pSlot->dstList.pPrivateMetaData,
+                                     metaSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcParRun(pPar);
+    }
+
+    if ((CPA_STATUS_SUCCESS == status) && (NULL != pProduced))
+    {
+        *pProduced = pPar->produced;
+    }
+
+    dcParFree(pPar);
+
+    return status;
+}
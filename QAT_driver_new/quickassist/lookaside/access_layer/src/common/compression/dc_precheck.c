@@ -0,0 +1,585 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_precheck.c
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Implementation of the compressibility pre-check.
+ *
+ *      The order-0 entropy of DC_PRECHECK_NUM_SAMPLES samples spread over
+ *      the source is computed in fixed point, so the estimate costs a few
+ *      thousand byte loads whatever the request size. The histogram is
+ *      split in four interleaved tables so that consecutive bytes of equal
+ *      value do not serialise on the same counter.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "dc_dict.h"
+#include "dc_precheck.h"
+#include "lac_common.h"
+
+/* Number of interleaved histogram tables */
+#define DC_PRECHECK_NUM_HIST (4)
+
+/* Number of fractional bits of the fixed point logarithms */
+#define DC_PRECHECK_LOG2_FRAC_BITS (16)
+
+/* A request is considered compressed when it saves at least
+ * 1 / 2^DC_PRECHECK_MIN_SAVING_SHIFT of its size */
+#define DC_PRECHECK_MIN_SAVING_SHIFT (5)
+
+/* Deflate stored block header and largest stored block */
+#define DC_PRECHECK_STORED_HDR_SIZE (5)
+#define DC_PRECHECK_STORED_MAX_LEN (0xFFFF)
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Buffer list cursor
+ *
+ *****************************************************************************/
+typedef struct dc_precheck_cursor_s
+{
+    const CpaBufferList *pList;
+    Cpa32U index;
+    /**< Current flat buffer */
+    Cpa32U offset;
+    /**< Offset in the current flat buffer */
+} dc_precheck_cursor_t;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Total length of a buffer list, saturated to 32 bits
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcPrecheckSglLength(const CpaBufferList *pList)
+{
+    Cpa64U len = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; i < pList->numBuffers; i++)
+    {
+        len += pList->pBuffers[i].dataLenInBytes;
+    }
+    return (len > 0xFFFFFFFF) ? 0xFFFFFFFF : (Cpa32U)len;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Base 2 logarithm of x in fixed point
+ *
+ * @description
+ *      Computes the integer part from the position of the leading bit and
+ *      the fractional bits by repeated squaring of the normalised mantissa.
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcPrecheckLog2(Cpa32U x)
+{
+    Cpa32U result = 0;
+    Cpa32U msb = 0;
+    Cpa64U mantissa = 0;
+    Cpa32U i = 0;
+
+    if (x <= 1)
+    {
+        return 0;
+    }
+
+    while ((x >> msb) > 1)
+    {
+        msb++;
+    }
+    result = msb << DC_PRECHECK_LOG2_FRAC_BITS;
+
+    /* Mantissa in [1, 2) with 31 fractional bits */
+    mantissa = ((Cpa64U)x << 31) >> msb;
+    for (i = 0; i < DC_PRECHECK_LOG2_FRAC_BITS; i++)
+    {
+        mantissa = (mantissa * mantissa) >> 31;
+        if (mantissa >= (1ULL << 32))
+        {
+            mantissa >>= 1;
+            result |= 1U << (DC_PRECHECK_LOG2_FRAC_BITS - 1 - i);
+        }
+    }
+
+    return result;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Add bytes to the histogram
+ *
+ *****************************************************************************/
+STATIC void dcPrecheckHistogram(Cpa16U pHist[DC_PRECHECK_NUM_HIST][256],
+                                const Cpa8U *pData,
+                                Cpa32U len)
+{
+    Cpa32U i = 0;
+
+    for (i = 0; i + DC_PRECHECK_NUM_HIST <= len; i += DC_PRECHECK_NUM_HIST)
+    {
+        pHist[0][pData[i]]++;
+        pHist[1][pData[i + 1]]++;
+        pHist[2][pData[i + 2]]++;
+        pHist[3][pData[i + 3]]++;
+    }
+    for (; i < len; i++)
+    {
+        pHist[0][pData[i]]++;
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Estimate the entropy of a buffer list
+ *
+ * @description
+ *      Samples DC_PRECHECK_NUM_SAMPLES windows evenly spaced over the data,
+ *      or the whole data when it is smaller than the samples, and returns
+ *      the order-0 entropy of the sampled bytes.
+ *
+ * @retval Entropy in thousandths of a bit per byte
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcPrecheckEntropy(const CpaBufferList *pSrcBuff, Cpa32U srcLen)
+{
+    Cpa16U hist[DC_PRECHECK_NUM_HIST][256];
+    const CpaFlatBuffer *pFlat = NULL;
+    Cpa64U sum = 0;
+    Cpa64U bufStart = 0;
+    Cpa32U stride = DC_PRECHECK_SAMPLE_SIZE;
+    Cpa32U total = 0;
+    Cpa32U count = 0;
+    Cpa32U pos = 0;
+    Cpa32U remaining = 0;
+    Cpa32U chunk = 0;
+    Cpa32U index = 0;
+    Cpa32U s = 0;
+    Cpa32U i = 0;
+
+    osalMemSet(hist, 0, sizeof(hist));
+
+    if (srcLen > DC_PRECHECK_NUM_SAMPLES * DC_PRECHECK_SAMPLE_SIZE)
+    {
+        stride = (srcLen - DC_PRECHECK_SAMPLE_SIZE) /
+                 (DC_PRECHECK_NUM_SAMPLES - 1);
+    }
+
+    /* Sample starts are increasing, so the buffer list is walked once */
+    for (s = 0; (s < DC_PRECHECK_NUM_SAMPLES) && (s * stride < srcLen); s++)
+    {
+        pos = s * stride;
+        remaining = srcLen - pos;
+        if (remaining > DC_PRECHECK_SAMPLE_SIZE)
+        {
+            remaining = DC_PRECHECK_SAMPLE_SIZE;
+        }
+        while ((remaining > 0) && (index < pSrcBuff->numBuffers))
+        {
+            pFlat = &pSrcBuff->pBuffers[index];
+            if (pos >= bufStart + pFlat->dataLenInBytes)
+            {
+                bufStart += pFlat->dataLenInBytes;
+                index++;
+                continue;
+            }
+            chunk = (Cpa32U)(bufStart + pFlat->dataLenInBytes - pos);
+            if (chunk > remaining)
+            {
+                chunk = remaining;
+            }
+            dcPrecheckHistogram(
+                hist, pFlat->pData + (pos - bufStart), chunk);
+            total += chunk;
+            pos += chunk;
+            remaining -= chunk;
+        }
+    }
+
+    if (0 == total)
+    {
+        return 0;
+    }
+
+    /* H = log2(n) - sum(c * log2(c)) / n */
+    for (i = 0; i < 256; i++)
+    {
+        count = (Cpa32U)hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+        if (0 != count)
+        {
+            sum += (Cpa64U)count * dcPrecheckLog2(count);
+        }
+    }
+    sum = (Cpa64U)total * dcPrecheckLog2(total) - sum;
+
+    return (Cpa32U)((sum * 1000 / total) >> DC_PRECHECK_LOG2_FRAC_BITS);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Copy bytes between two buffer list cursors
+ *
+ * @description
+ *      A NULL source cursor copies from pData instead.
+ *
+ *****************************************************************************/
+STATIC void dcPrecheckCopy(dc_precheck_cursor_t *pDst,
+                           dc_precheck_cursor_t *pSrc,
+                           const Cpa8U *pData,
+                           Cpa32U len)
+{
+    const CpaFlatBuffer *pDstFlat = NULL;
+    const CpaFlatBuffer *pSrcFlat = NULL;
+    Cpa32U chunk = 0;
+
+    while (len > 0)
+    {
+        pDstFlat = &pDst->pList->pBuffers[pDst->index];
+        if (pDst->offset == pDstFlat->dataLenInBytes)
+        {
+            pDst->index++;
+            pDst->offset = 0;
+            continue;
+        }
+        chunk = pDstFlat->dataLenInBytes - pDst->offset;
+
+        if (NULL != pSrc)
+        {
+            pSrcFlat = &pSrc->pList->pBuffers[pSrc->index];
+            if (pSrc->offset == pSrcFlat->dataLenInBytes)
+            {
+                pSrc->index++;
+                pSrc->offset = 0;
+                continue;
+            }
+            if (chunk > pSrcFlat->dataLenInBytes - pSrc->offset)
+            {
+                chunk = pSrcFlat->dataLenInBytes - pSrc->offset;
+            }
+            pData = pSrcFlat->pData + pSrc->offset;
+        }
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+
+        osalMemCopy(pDstFlat->pData + pDst->offset, pData, chunk);
+        pDst->offset += chunk;
+        if (NULL != pSrc)
+        {
+            pSrc->offset += chunk;
+        }
+        else
+        {
+            pData += chunk;
+        }
+        len -= chunk;
+    }
+}
+
+CpaStatus dcSetPrecheck(CpaInstanceHandle dcInstance,
+                        CpaDcSessionHandle pSessionHandle,
+                        CpaBoolean enable,
+                        Cpa32U threshold,
+                        Cpa32U auditInterval)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if (threshold > DC_PRECHECK_MAX_THRESHOLD)
+    {
+        LAC_INVALID_PARAM_LOG("Invalid pre-check threshold");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (CPA_TRUE == enable)
+    {
+        if ((CPA_DC_STATELESS != pSessionDesc->sessState) ||
+            (CPA_DC_DIR_DECOMPRESS == pSessionDesc->sessDirection) ||
+            (CPA_TRUE == pSessionDesc->isDcDp))
+        {
+            LAC_INVALID_PARAM_LOG("Pre-check requires a stateless "
+                                  "compression session");
+            return CPA_STATUS_INVALID_PARAM;
+        }
+        if ((CPA_DC_DEFLATE != pSessionDesc->compType) ||
+            ((CPA_DC_NONE != pSessionDesc->checksumType) &&
+             (CPA_DC_CRC32 != pSessionDesc->checksumType) &&
+             (CPA_DC_ADLER32 != pSessionDesc->checksumType)))
+        {
+            LAC_INVALID_PARAM_LOG("Pre-check supports Deflate with no, "
+                                  "CRC32 or Adler32 checksum");
+            return CPA_STATUS_UNSUPPORTED;
+        }
+    }
+
+    if (0 != osalAtomicGet(&(pSessionDesc->pendingStatelessCbCount)))
+    {
+        return CPA_STATUS_RETRY;
+    }
+
+    if (CPA_TRUE == enable)
+    {
+        pSessionDesc->precheckThreshold =
+            (0 == threshold) ? DC_PRECHECK_DEFAULT_THRESHOLD : threshold;
+    }
+    else
+    {
+        pSessionDesc->precheckThreshold = 0;
+    }
+    pSessionDesc->precheckAuditInterval = auditInterval;
+    osalAtomicSet(0, &pSessionDesc->precheckAuditCount);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus dcGetPrecheckStats(CpaInstanceHandle dcInstance,
+                             CpaDcSessionHandle pSessionHandle,
+                             Cpa64U *pChecked,
+                             Cpa64U *pStored,
+                             Cpa64U *pAudited,
+                             Cpa64U *pAuditCompressible,
+                             Cpa64U *pMissed)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+    LAC_CHECK_NULL_PARAM(pChecked);
+    LAC_CHECK_NULL_PARAM(pStored);
+    LAC_CHECK_NULL_PARAM(pAudited);
+    LAC_CHECK_NULL_PARAM(pAuditCompressible);
+    LAC_CHECK_NULL_PARAM(pMissed);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    *pChecked = osalAtomicGet(&pSessionDesc->precheckChecked);
+    *pStored = osalAtomicGet(&pSessionDesc->precheckStored);
+    *pAudited = osalAtomicGet(&pSessionDesc->precheckAudited);
+    *pAuditCompressible =
+        osalAtomicGet(&pSessionDesc->precheckAuditCompressible);
+    *pMissed = osalAtomicGet(&pSessionDesc->precheckMissed);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+dc_precheck_result_t dcPrecheckApply(dc_session_desc_t *pSessionDesc,
+                                     const CpaBufferList *pSrcBuff,
+                                     const CpaBufferList *pDestBuff,
+                                     const CpaDcOpData *pOpData)
+{
+    Cpa32U srcLen = 0;
+    Cpa32U storedLen = 0;
+    Cpa64U count = 0;
+
+    if (0 == pSessionDesc->precheckThreshold)
+    {
+        return DC_PRECHECK_NONE;
+    }
+
+    /* End to end integrity CRCs are produced by the device */
+    if ((NULL != pOpData) && (CPA_TRUE == pOpData->integrityCrcCheck))
+    {
+        return DC_PRECHECK_NONE;
+    }
+
+    srcLen = dcPrecheckSglLength(pSrcBuff);
+    if ((srcLen < DC_PRECHECK_MIN_SIZE) || (0xFFFFFFFF == srcLen))
+    {
+        return DC_PRECHECK_NONE;
+    }
+
+    osalAtomicInc(&pSessionDesc->precheckChecked);
+    if (dcPrecheckEntropy(pSrcBuff, srcLen) <
+        pSessionDesc->precheckThreshold)
+    {
+        return DC_PRECHECK_COMPRESSIBLE;
+    }
+
+    if (0 != pSessionDesc->precheckAuditInterval)
+    {
+        count = osalAtomicInc(&pSessionDesc->precheckAuditCount);
+        if (0 == (count % pSessionDesc->precheckAuditInterval))
+        {
+            osalAtomicInc(&pSessionDesc->precheckAudited);
+            return DC_PRECHECK_AUDIT;
+        }
+    }
+
+    /* Let the device report the overflow if the stored blocks do not fit */
+    storedLen = srcLen + DC_PRECHECK_STORED_HDR_SIZE *
+                             ((srcLen + DC_PRECHECK_STORED_MAX_LEN - 1) /
+                              DC_PRECHECK_STORED_MAX_LEN);
+    if ((storedLen < srcLen) || (storedLen > dcPrecheckSglLength(pDestBuff)))
+    {
+        return DC_PRECHECK_COMPRESSIBLE;
+    }
+
+    osalAtomicInc(&pSessionDesc->precheckStored);
+    return DC_PRECHECK_INCOMPRESSIBLE;
+}
+
+void dcPrecheckStore(dc_session_desc_t *pSessionDesc,
+                     CpaBufferList *pSrcBuff,
+                     CpaBufferList *pDestBuff,
+                     CpaDcRqResults *pResults,
+                     CpaDcFlush flushFlag)
+{
+    dc_precheck_cursor_t src = {0};
+    dc_precheck_cursor_t dst = {0};
+    Cpa8U header[DC_PRECHECK_STORED_HDR_SIZE] = {0};
+    Cpa32U srcLen = dcPrecheckSglLength(pSrcBuff);
+    Cpa32U pos = 0;
+    Cpa32U len = 0;
+    Cpa32U produced = 0;
+    Cpa32U seed = 0;
+
+    src.pList = pSrcBuff;
+    dst.pList = pDestBuff;
+
+    while (pos < srcLen)
+    {
+        len = srcLen - pos;
+        if (len > DC_PRECHECK_STORED_MAX_LEN)
+        {
+            len = DC_PRECHECK_STORED_MAX_LEN;
+        }
+        header[0] =
+            ((CPA_DC_FLUSH_FINAL == flushFlag) && (pos + len == srcLen)) ? 1
+                                                                          : 0;
+        header[1] = (Cpa8U)len;
+        header[2] = (Cpa8U)(len >> 8);
+        header[3] = (Cpa8U)~len;
+        header[4] = (Cpa8U)(~len >> 8);
+        dcPrecheckCopy(&dst, NULL, header, DC_PRECHECK_STORED_HDR_SIZE);
+        dcPrecheckCopy(&dst, &src, NULL, len);
+        produced += DC_PRECHECK_STORED_HDR_SIZE + len;
+        pos += len;
+    }
+
+    if (CPA_DC_NONE != pSessionDesc->checksumType)
+    {
+        if (DC_REQUEST_SUBSEQUENT == pSessionDesc->requestType)
+        {
+            seed = pResults->checksum;
+        }
+        else
+        {
+            seed = (CPA_DC_ADLER32 == pSessionDesc->checksumType)
+                       ? DC_DEFAULT_ADLER32
+                       : DC_DEFAULT_CRC;
+        }
+        pResults->checksum = dcDictChecksumSgl(
+            pSessionDesc->checksumType, pSrcBuff, srcLen, seed);
+    }
+    pResults->status = CPA_DC_OK;
+    pResults->consumed = srcLen;
+    pResults->produced = produced;
+    pResults->endOfLastBlock = CPA_FALSE;
+    pResults->dataUncompressed = CPA_TRUE;
+    pSessionDesc->requestType = (CPA_DC_FLUSH_FINAL == flushFlag)
+                                    ? DC_REQUEST_FIRST
+                                    : DC_REQUEST_SUBSEQUENT;
+}
+
+void dcPrecheckComplete(dc_session_desc_t *pSessionDesc,
+                        dc_precheck_result_t precheck,
+                        const CpaDcRqResults *pResults)
+{
+    CpaBoolean compressed = CPA_FALSE;
+
+    if (CPA_DC_OK != pResults->status)
+    {
+        return;
+    }
+
+    compressed = (pResults->produced <
+                  pResults->consumed -
+                      (pResults->consumed >> DC_PRECHECK_MIN_SAVING_SHIFT))
+                     ? CPA_TRUE
+                     : CPA_FALSE;
+
+    if ((DC_PRECHECK_COMPRESSIBLE == precheck) && (CPA_FALSE == compressed))
+    {
+        osalAtomicInc(&pSessionDesc->precheckMissed);
+    }
+    else if ((DC_PRECHECK_AUDIT == precheck) && (CPA_TRUE == compressed))
+    {
+        osalAtomicInc(&pSessionDesc->precheckAuditCompressible);
+    }
+}
@@ -73,6 +73,10 @@
 #include "sal_qat_cmn_msg.h"
 #include "sal_hw_gen.h"
 #include "dc_crc64.h"
+#ifndef KERNEL_SPACE
+#include "dc_cnv_verify.h"
+#endif
+#include "dc_dict.h"
 
 
 #ifdef ICP_PARAM_CHECK
@@ -989,6 +993,7 @@ CpaStatus dcInitSession(CpaInstanceHandle dcInstance,
     Cpa8U dcCmdId = ICP_QAT_FW_COMP_CMD_STATIC;
     icp_qat_fw_comn_flags cmnRequestFlags = 0;
     icp_qat_fw_ext_serv_specif_flags extServiceCmdFlags = 0;
+    Cpa32U i = 0;
 
     cmnRequestFlags = ICP_QAT_FW_COMN_FLAGS_BUILD(
         DC_DEFAULT_QAT_PTR_TYPE, QAT_COMN_CD_FLD_TYPE_16BYTE_DATA);
@@ -1266,6 +1271,44 @@ CpaStatus dcInitSession(CpaInstanceHandle dcInstance,
     osalAtomicSet(0, &pSessionDesc->pendingStatefulCbCount);
     pSessionDesc->pendingDpStatelessCbCount = 0;
 
+    /* Stateful requests are not pipelined until requested */
+    pSessionDesc->statefulPipelineDepth = 0;
+    pSessionDesc->pipelineHead = 0;
+    pSessionDesc->pipelineCount = 0;
+
+    /* CnV requests are verified by the device until requested otherwise */
+    pSessionDesc->cnvPolicy = DC_CNV_POLICY_DEVICE;
+    pSessionDesc->cnvSampleInterval = 0;
+    osalAtomicSet(0, &pSessionDesc->cnvSampleCount);
+    osalAtomicSet(0, &pSessionDesc->cnvDeviceVerified);
+    osalAtomicSet(0, &pSessionDesc->cnvNotVerified);
+    osalAtomicSet(0, &pSessionDesc->cnvSwVerified);
+    osalAtomicSet(0, &pSessionDesc->cnvSwErrors);
+
+    /* No preset dictionary until one is set */
+    pSessionDesc->pDict = NULL;
+
+    /* Every request is offloaded until a pre-check is configured */
+    pSessionDesc->precheckThreshold = 0;
+    pSessionDesc->precheckAuditInterval = 0;
+    osalAtomicSet(0, &pSessionDesc->precheckAuditCount);
+    osalAtomicSet(0, &pSessionDesc->precheckChecked);
+    osalAtomicSet(0, &pSessionDesc->precheckStored);
+    osalAtomicSet(0, &pSessionDesc->precheckAudited);
+    osalAtomicSet(0, &pSessionDesc->precheckAuditCompressible);
+    osalAtomicSet(0, &pSessionDesc->precheckMissed);
+
+    /* Compression ratios are only recorded once sizing is enabled */
+    pSessionDesc->sizingEnabled = CPA_FALSE;
+    for (i = 0; i < DC_SIZING_NUM_BUCKETS; i++)
+    {
+        osalAtomicSet(0, &pSessionDesc->sizingHist[i]);
+    }
+    osalAtomicSet(0, &pSessionDesc->sizingOverflows);
+
+    /* Every request goes to the device until an inline threshold is set */
+    pSessionDesc->inlineThreshold = 0;
+
     if (CPA_DC_DIR_DECOMPRESS != pSessionData->sessDirection)
     {
         if (isDcGen2x(pService) &&
@@ -1761,6 +1804,21 @@ CpaStatus cpaDcRemoveSession(const CpaInstanceHandle dcInstance,
         LAC_OS_FREE(pSessionDesc->crcConfig.pCrcLookupTable);
     }
 
+#ifndef KERNEL_SPACE
+    /* Release the software verify pool once no request can reach it */
+    if ((CPA_STATUS_SUCCESS == status) &&
+        (DC_CNV_POLICY_SW_ASYNC == pSessionDesc->cnvPolicy))
+    {
+        pSessionDesc->cnvPolicy = DC_CNV_POLICY_DEVICE;
+        dcCnvVerifyPoolPut();
+    }
+#endif
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        dcDictFree(pSessionDesc);
+    }
+
     return status;
 }
 
@@ -1876,6 +1934,187 @@ CpaStatus dcSetCnvError(CpaInstanceHandle dcInstance,
     return CPA_STATUS_SUCCESS;
 }
 
+CpaStatus dcSetStatefulPipelineDepth(CpaInstanceHandle dcInstance,
+                                     CpaDcSessionHandle pSessionHandle,
+                                     Cpa32U depth)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if ((CPA_DC_STATEFUL != pSessionDesc->sessState) ||
+        (CPA_TRUE == pSessionDesc->isDcDp))
+    {
+        LAC_INVALID_PARAM_LOG("Pipelining requires a stateful session");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (depth > DC_STATEFUL_PIPELINE_MAX_DEPTH)
+    {
+        LAC_INVALID_PARAM_LOG1("Pipeline depth must not exceed %d",
+                               DC_STATEFUL_PIPELINE_MAX_DEPTH);
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    /* Synchronous sessions block on each request, there is nothing to
+     * pipeline */
+    if (LacSync_GenWakeupSyncCaller == pSessionDesc->pCompressionCb)
+    {
+        LAC_INVALID_PARAM_LOG("Pipelining requires an asynchronous session");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    while (osalAtomicTestAndSet(1, &pSessionDesc->sessionLock))
+        ;
+
+    if (0 != osalAtomicGet(&(pSessionDesc->pendingStatefulCbCount)))
+    {
+        status = CPA_STATUS_RETRY;
+    }
+    else
+    {
+        pSessionDesc->statefulPipelineDepth = depth;
+    }
+
+    osalAtomicRelease(&pSessionDesc->sessionLock);
+
+    return status;
+}
+
+CpaStatus dcSetCnvPolicy(CpaInstanceHandle dcInstance,
+                         CpaDcSessionHandle pSessionHandle,
+                         dc_cnv_policy_t policy,
+                         Cpa32U sampleInterval)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if ((DC_CNV_POLICY_DEVICE != policy) &&
+        (DC_CNV_POLICY_SAMPLED != policy) &&
+        (DC_CNV_POLICY_SW_ASYNC != policy))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid CnV policy");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (DC_CNV_POLICY_DEVICE != policy)
+    {
+#ifdef CNV_STRICT_MODE
+        LAC_INVALID_PARAM_LOG("Only device verification allowed");
+        return CPA_STATUS_UNSUPPORTED;
+#endif
+        if ((CPA_DC_STATELESS != pSessionDesc->sessState) ||
+            (CPA_DC_DIR_DECOMPRESS == pSessionDesc->sessDirection) ||
+            (CPA_TRUE == pSessionDesc->isDcDp))
+        {
+            LAC_INVALID_PARAM_LOG("CnV policy requires a stateless "
+                                  "compression session");
+            return CPA_STATUS_INVALID_PARAM;
+        }
+    }
+
+    if ((DC_CNV_POLICY_SAMPLED == policy) && (0 == sampleInterval))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid CnV sample interval");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (DC_CNV_POLICY_SW_ASYNC == policy)
+    {
+#ifdef KERNEL_SPACE
+        LAC_LOG_ERROR("Software verify not supported in kernel space");
+        return CPA_STATUS_UNSUPPORTED;
+#else
+        if ((CPA_DC_DEFLATE != pSessionDesc->compType) &&
+            (CPA_DC_LZ4 != pSessionDesc->compType))
+        {
+            LAC_INVALID_PARAM_LOG("Software verify supports Deflate and LZ4");
+            return CPA_STATUS_UNSUPPORTED;
+        }
+#endif
+    }
+
+    if (0 != osalAtomicGet(&(pSessionDesc->pendingStatelessCbCount)))
+    {
+        return CPA_STATUS_RETRY;
+    }
+
+#ifndef KERNEL_SPACE
+    if ((DC_CNV_POLICY_SW_ASYNC == policy) &&
+        (DC_CNV_POLICY_SW_ASYNC != pSessionDesc->cnvPolicy))
+    {
+        status = dcCnvVerifyPoolGet();
+    }
+    else if ((DC_CNV_POLICY_SW_ASYNC != policy) &&
+             (DC_CNV_POLICY_SW_ASYNC == pSessionDesc->cnvPolicy))
+    {
+        dcCnvVerifyPoolPut();
+    }
+#endif
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        pSessionDesc->cnvPolicy = policy;
+        pSessionDesc->cnvSampleInterval = sampleInterval;
+        osalAtomicSet(0, &pSessionDesc->cnvSampleCount);
+    }
+
+    return status;
+}
+
+CpaStatus dcGetCnvPolicyStats(CpaInstanceHandle dcInstance,
+                              CpaDcSessionHandle pSessionHandle,
+                              Cpa64U *pDeviceVerified,
+                              Cpa64U *pNotVerified,
+                              Cpa64U *pSwVerified,
+                              Cpa64U *pSwErrors)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+    LAC_CHECK_NULL_PARAM(pDeviceVerified);
+    LAC_CHECK_NULL_PARAM(pNotVerified);
+    LAC_CHECK_NULL_PARAM(pSwVerified);
+    LAC_CHECK_NULL_PARAM(pSwErrors);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    *pDeviceVerified = osalAtomicGet(&pSessionDesc->cnvDeviceVerified);
+    *pNotVerified = osalAtomicGet(&pSessionDesc->cnvNotVerified);
+    *pSwVerified = osalAtomicGet(&pSessionDesc->cnvSwVerified);
+    *pSwErrors = osalAtomicGet(&pSessionDesc->cnvSwErrors);
+
+    return CPA_STATUS_SUCCESS;
+}
+
 CpaStatus cpaDcUpdateSession(const CpaInstanceHandle dcInstance,
                              CpaDcSessionHandle pSessionHandle,
                              CpaDcSessionUpdateData *pSessionUpdateData)
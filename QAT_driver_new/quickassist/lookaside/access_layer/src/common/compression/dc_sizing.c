@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_sizing.c
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Implementation of the destination buffer sizing feedback.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_sizing.h"
+#include "lac_common.h"
+#include "sal_types_compression.h"
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Worst case destination size of a request
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcSizingBound(CpaInstanceHandle dcInstance,
+                               dc_session_desc_t *pSessionDesc,
+                               Cpa32U srcLen,
+                               Cpa32U *pDestLen)
+{
+    if (CPA_DC_LZ4 == pSessionDesc->compType)
+    {
+        return cpaDcLZ4CompressBound(dcInstance, srcLen, pDestLen);
+    }
+    if (CPA_DC_LZ4S == pSessionDesc->compType)
+    {
+        return cpaDcLZ4SCompressBound(dcInstance, srcLen, pDestLen);
+    }
+    return cpaDcDeflateCompressBound(
+        dcInstance, pSessionDesc->huffType, srcLen, pDestLen);
+}
+
+CpaStatus dcSetDestSizing(CpaInstanceHandle dcInstance,
+                          CpaDcSessionHandle pSessionHandle,
+                          CpaBoolean enable)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    Cpa32U i = 0;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if ((CPA_TRUE == enable) &&
+        ((CPA_DC_STATELESS != pSessionDesc->sessState) ||
+         (CPA_DC_DIR_DECOMPRESS == pSessionDesc->sessDirection)))
+    {
+        LAC_INVALID_PARAM_LOG("Destination sizing requires a stateless "
+                              "compression session");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if ((CPA_TRUE == enable) && (CPA_FALSE == pSessionDesc->sizingEnabled))
+    {
+        for (i = 0; i < DC_SIZING_NUM_BUCKETS; i++)
+        {
+            osalAtomicSet(0, &pSessionDesc->sizingHist[i]);
+        }
+        osalAtomicSet(0, &pSessionDesc->sizingOverflows);
+    }
+    pSessionDesc->sizingEnabled = enable;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus dcGetDestSizeHint(CpaInstanceHandle dcInstance,
+                            CpaDcSessionHandle pSessionHandle,
+                            Cpa32U srcLen,
+                            Cpa32U overflowPpm,
+                            Cpa32U *pDestLen)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    sal_compression_service_t *pService = NULL;
+    Cpa64U hist[DC_SIZING_NUM_BUCKETS];
+    Cpa64U samples = 0;
+    Cpa64U allowed = 0;
+    Cpa64U tail = 0;
+    Cpa64U destLen = 0;
+    Cpa32U bound = 0;
+    Cpa32U minDestLen = 0;
+    Cpa32U b = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+    LAC_CHECK_NULL_PARAM(pDestLen);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    if (overflowPpm > 1000000)
+    {
+        LAC_INVALID_PARAM_LOG("Invalid overflow probability");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if (CPA_INSTANCE_HANDLE_SINGLE == dcInstance)
+    {
+        dcInstance = dcGetFirstHandle();
+        LAC_CHECK_NULL_PARAM(dcInstance);
+    }
+    pService = (sal_compression_service_t *)dcInstance;
+
+    status = dcSizingBound(dcInstance, pSessionDesc, srcLen, &bound);
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+    *pDestLen = bound;
+
+    /* Snapshot the histogram, it keeps moving under load */
+    for (b = 0; b < DC_SIZING_NUM_BUCKETS; b++)
+    {
+        hist[b] = osalAtomicGet(&pSessionDesc->sizingHist[b]);
+        samples += hist[b];
+    }
+    if (samples < DC_SIZING_MIN_SAMPLES)
+    {
+        return CPA_STATUS_SUCCESS;
+    }
+
+    /* Lowest bucket leaving at most the accepted share of requests above */
+    allowed = samples * overflowPpm / 1000000;
+    b = DC_SIZING_NUM_BUCKETS - 1;
+    while ((b > 0) && (tail + hist[b] <= allowed))
+    {
+        tail += hist[b];
+        b--;
+    }
+    if ((DC_SIZING_NUM_BUCKETS - 1) == b)
+    {
+        /* Requests expanded beyond the histogram range */
+        return CPA_STATUS_SUCCESS;
+    }
+
+    destLen = (Cpa64U)srcLen * (b + 1);
+    destLen = ((destLen + (1 << DC_SIZING_RATIO_SHIFT) - 1) >>
+               DC_SIZING_RATIO_SHIFT) +
+              DC_SIZING_SLACK;
+
+    minDestLen = (CPA_DC_HT_FULL_DYNAMIC == pSessionDesc->huffType)
+                     ? pService->comp_device_data.minOutputBuffSizeDynamic
+                     : pService->comp_device_data.minOutputBuffSize;
+    if (destLen < minDestLen)
+    {
+        destLen = minDestLen;
+    }
+    if (destLen < bound)
+    {
+        *pDestLen = (Cpa32U)destLen;
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus dcGetDestSizingStats(CpaInstanceHandle dcInstance,
+                               CpaDcSessionHandle pSessionHandle,
+                               Cpa64U *pSamples,
+                               Cpa64U *pOverflows)
+{
+    dc_session_desc_t *pSessionDesc = NULL;
+    Cpa32U b = 0;
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(dcInstance);
+    LAC_CHECK_NULL_PARAM(pSessionHandle);
+    LAC_CHECK_NULL_PARAM(pSamples);
+    LAC_CHECK_NULL_PARAM(pOverflows);
+#endif
+
+    pSessionDesc = DC_SESSION_DESC_FROM_CTX_GET(pSessionHandle);
+
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSessionDesc);
+#endif
+
+    *pSamples = 0;
+    for (b = 0; b < DC_SIZING_NUM_BUCKETS; b++)
+    {
+        *pSamples += osalAtomicGet(&pSessionDesc->sizingHist[b]);
+    }
+    *pOverflows = osalAtomicGet(&pSessionDesc->sizingOverflows);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+void dcSizingRecord(dc_session_desc_t *pSessionDesc,
+                    const CpaDcRqResults *pResults)
+{
+    Cpa64U bucket = 0;
+
+    if (CPA_DC_OVERFLOW == pResults->status)
+    {
+        osalAtomicInc(&pSessionDesc->sizingOverflows);
+        return;
+    }
+    if ((CPA_DC_OK != pResults->status) || (0 == pResults->consumed))
+    {
+        return;
+    }
+
+    /* Bucket b holds produced <= consumed * (b + 1) / 32 */
+    bucket = (((Cpa64U)pResults->produced << DC_SIZING_RATIO_SHIFT) +
+              pResults->consumed - 1) /
+             pResults->consumed;
+    bucket = (bucket > 0) ? bucket - 1 : 0;
+    if (bucket >= DC_SIZING_NUM_BUCKETS)
+    {
+        bucket = DC_SIZING_NUM_BUCKETS - 1;
+    }
+    osalAtomicInc(&pSessionDesc->sizingHist[bucket]);
+}
+
+Cpa32U dcSizingRatioPercent(dc_session_desc_t *pSessionDesc)
+{
+    Cpa64U samples = 0;
+    Cpa64U sum = 0;
+    Cpa64U count = 0;
+    Cpa32U b = 0;
+
+    for (b = 0; b < DC_SIZING_NUM_BUCKETS; b++)
+    {
+        count = osalAtomicGet(&pSessionDesc->sizingHist[b]);
+        samples += count;
+        /* Middle of the bucket, in 1/64 */
+        sum += count * (2 * b + 1);
+    }
+    if (samples < DC_SIZING_MIN_SAMPLES)
+    {
+        return 0;
+    }
+
+    return (Cpa32U)((sum * 100) /
+                    (samples << (DC_SIZING_RATIO_SHIFT + 1)));
+}
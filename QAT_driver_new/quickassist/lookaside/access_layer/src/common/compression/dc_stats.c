@@ -73,25 +73,13 @@
 
 CpaStatus dcStatsInit(sal_compression_service_t *pService)
 {
-    CpaStatus status = CPA_STATUS_SUCCESS;
-
-    status = LAC_OS_MALLOC(&(pService->pCompStatsArr),
-                           COMPRESSION_NUM_STATS * sizeof(OsalAtomic));
-
-    if (CPA_STATUS_SUCCESS == status)
-    {
-        COMPRESSION_STATS_RESET(pService);
-    }
-
-    return status;
+    return SalStatistics_ShardedAlloc(&(pService->pCompStatsArr),
+                                      COMPRESSION_NUM_STATS);
 }
 
 void dcStatsFree(sal_compression_service_t *pService)
 {
-    if (NULL != pService->pCompStatsArr)
-    {
-        LAC_OS_FREE(pService->pCompStatsArr);
-    }
+    SalStatistics_ShardedFree(&(pService->pCompStatsArr));
 }
 
 void dcStatsReset(sal_compression_service_t *pService)
@@ -0,0 +1,1052 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_stream.c
+ *
+ * @ingroup SalDcStream
+ *
+ * @description
+ *      Implementation of the streaming frame writer.
+ *
+ *      The input is split into chunks which are compressed as independent
+ *      stateless requests flushed with CPA_DC_FLUSH_FULL, so the produced
+ *      deflate data of consecutive chunks can be concatenated and several
+ *      chunks can be in flight at once. The last chunk is submitted with
+ *      CPA_DC_FLUSH_FINAL. Every chunk starts from the default checksum seed
+ *      and the per-chunk CRC-32/Adler-32 values are combined in software
+ *      when the chunks are drained in order. For LZ4 the content xxHash is
+ *      accumulated by the device across the session, which requires the
+ *      chunks to be processed in order, hence only one request is kept in
+ *      flight for LZ4 streams.
+ *
+ *      LZ4S streams produce LZ4 frames as well. Every chunk is compressed
+ *      into LZ4s data with CPA_DC_FLUSH_FINAL. Its completion hands the
+ *      chunk to the software worker pool of dc_cnv_verify.c, which converts
+ *      it into one independent LZ4 block while the following chunks are
+ *      still being compressed by the device and the earlier blocks are
+ *      being emitted. The content checksum can not be accumulated by the
+ *      device for LZ4s, so these frames are generated without it.
+ *
+ *****************************************************************************/
+
+/*
+ *******************************************************************************
+ * Include public/global header files
+ *******************************************************************************
+ */
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "icp_sal_poll.h"
+#include "icp_sal_dc_stream.h"
+#include "icp_sal_dc_lz4s.h"
+
+/*
+ *******************************************************************************
+ * Include private header files
+ *******************************************************************************
+ */
+#include "dc_session.h"
+#include "dc_datapath.h"
+#include "dc_cnv_verify.h"
+#include "dc_crc32.h"
+#include "dc_header_footer.h"
+#include "dc_header_footer_lz4.h"
+#include "lac_common.h"
+#include "lac_mem.h"
+#include "sal_types_compression.h"
+#include "sal_service_state.h"
+
+/* Largest frame header or footer generated by the stream */
+#define DC_STREAM_MAX_HDR_FTR_SIZE (16)
+
+/* Modulus of the Adler-32 sums */
+#define DC_STREAM_ADLER32_BASE (65521)
+
+/* Empty final deflate block with fixed Huffman codes */
+#define DC_STREAM_EMPTY_DEFLATE_BLOCK_SIZE (2)
+static const Cpa8U
+    dcStreamEmptyDeflateBlock[DC_STREAM_EMPTY_DEFLATE_BLOCK_SIZE] = {0x03,
+                                                                     0x00};
+
+/* xxHash32 of zero bytes with a zero seed */
+#define DC_STREAM_XXHASH32_EMPTY (0x02CC5D05)
+
+/* Size of the block size field and of the end mark of LZ4 frames */
+#define DC_STREAM_LZ4_BLOCK_HDR_SIZE (4)
+
+/* Flag of the block size field marking an uncompressed LZ4 block */
+#define DC_STREAM_LZ4_BLOCK_UNCOMPRESSED (0x80000000U)
+
+/* Size of CPA_DC_LZ4_MAX_BLOCK_SIZE_64K, every larger size is four times
+ * the previous one */
+#define DC_STREAM_LZ4_MIN_BLOCK_SIZE (64 * 1024)
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Stream slot
+ *
+ * @description
+ *      One input chunk and the output buffer it is compressed into.
+ *
+ *****************************************************************************/
+typedef struct dc_stream_slot_s
+{
+    struct dc_stream_s *pStream;
+    /**< Stream owning the slot */
+    CpaBufferList srcList;
+    CpaFlatBuffer srcFlat;
+    CpaBufferList dstList;
+    CpaFlatBuffer dstFlat;
+    Cpa8U *pSrcData;
+    /**< Pinned input chunk */
+    Cpa8U *pDstData;
+    /**< Pinned output buffer */
+    Cpa8U *pBlockData;
+    /**< LZ4 block converted from the LZ4s output, LZ4S streams only */
+    Cpa32U blockLen;
+    /**< Size of the block including its size field */
+    CpaStatus convStatus;
+    /**< Status of the LZ4s conversion */
+    dc_cnv_work_t convWork;
+    /**< LZ4s conversion by the worker pool */
+    Cpa32U fill;
+    /**< Number of input bytes buffered in the chunk */
+    Cpa32U offset;
+    /**< Number of input bytes of the chunk already compressed */
+    CpaDcFlush flushFlag;
+    CpaDcOpData opData;
+    CpaDcRqResults results;
+    CpaBoolean inFlight;
+    /**< Set while the request is owned by the instance or, for LZ4S
+     * streams, by the worker pool. Cleared with a release store once the
+     * results, status and block are written, and read with an acquire
+     * load by the draining thread */
+    CpaStatus cbStatus;
+    /**< Status passed to the completion callback */
+} dc_stream_slot_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Stream descriptor
+ *
+ * @description
+ *      Slots are used as a ring: requests are submitted at the tail and
+ *      drained, in order, at the head. The tail slot is the one being
+ *      filled by icp_sal_DcStreamWrite and is only submitted once more data
+ *      arrives or the stream is finished, so the final request is never
+ *      empty.
+ *
+ *****************************************************************************/
+typedef struct dc_stream_s
+{
+    CpaInstanceHandle dcInstance;
+    CpaDcSessionHandle pSessionHandle;
+    CpaDcSessionSetupData sessionSetupData;
+    icp_sal_dc_stream_output_fn_t pOutputFn;
+    void *pOutputTag;
+    dc_stream_slot_t *pSlots;
+    Cpa32U blockDataSize;
+    Cpa32U numSlots;
+    Cpa32U numInFlight;
+    Cpa32U chunkSize;
+    Cpa32U dstSize;
+    Cpa32U head;
+    Cpa32U tail;
+    Cpa32U numSubmitted;
+    Cpa32U checksum;
+    CpaDcCompLZ4BlockMaxSize lz4BlockMaxSize;
+    Cpa64U consumed;
+    Cpa64U produced;
+    CpaBoolean headerDone;
+    CpaBoolean finished;
+    CpaBoolean failed;
+    CpaBoolean poolRef;
+    /**< Set while the stream holds a reference on the worker pool */
+} dc_stream_t;
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Combine the Adler-32 of two adjacent blocks of data
+ *
+ * @param[in]  adler1      Adler-32 of the first block
+ * @param[in]  adler2      Adler-32 of the second block
+ * @param[in]  len2        Length of the second block in bytes
+ *
+ * @retval Cpa32U          Adler-32 of the concatenated blocks
+ *
+ *****************************************************************************/
+STATIC Cpa32U dcStreamAdler32Combine(Cpa32U adler1, Cpa32U adler2, Cpa64U len2)
+{
+    Cpa32U rem = (Cpa32U)(len2 % DC_STREAM_ADLER32_BASE);
+    Cpa32U sum1 = adler1 & 0xFFFF;
+    Cpa32U sum2 = (Cpa32U)(((Cpa64U)rem * sum1) % DC_STREAM_ADLER32_BASE);
+
+    sum1 += (adler2 & 0xFFFF) + DC_STREAM_ADLER32_BASE - 1;
+    sum2 += ((adler1 >> 16) & 0xFFFF) + ((adler2 >> 16) & 0xFFFF) +
+            DC_STREAM_ADLER32_BASE - rem;
+    if (sum1 >= DC_STREAM_ADLER32_BASE)
+    {
+        sum1 -= DC_STREAM_ADLER32_BASE;
+    }
+    if (sum1 >= DC_STREAM_ADLER32_BASE)
+    {
+        sum1 -= DC_STREAM_ADLER32_BASE;
+    }
+    if (sum2 >= (DC_STREAM_ADLER32_BASE << 1))
+    {
+        sum2 -= (DC_STREAM_ADLER32_BASE << 1);
+    }
+    if (sum2 >= DC_STREAM_ADLER32_BASE)
+    {
+        sum2 -= DC_STREAM_ADLER32_BASE;
+    }
+
+    return sum1 | (sum2 << 16);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Convert the LZ4s output of a request into an LZ4 block
+ *
+ * @description
+ *      Runs on a thread of the worker pool. Data which does not shrink is
+ *      stored as an uncompressed block. Clearing inFlight hands the slot
+ *      back to the thread draining the stream; the release store makes the
+ *      block, its length and convStatus visible to it first.
+ *
+ *****************************************************************************/
+STATIC void dcStreamConvertLZ4S(void *pWorkArg,
+                                struct dc_cnv_scratch_s *pScratch)
+{
+    dc_stream_slot_t *pSlot = (dc_stream_slot_t *)pWorkArg;
+    dc_stream_t *pStream = pSlot->pStream;
+    const Cpa8U *pSrc = pSlot->pSrcData + pSlot->offset;
+    Cpa32U srcLen = pSlot->results.consumed;
+    Cpa8U *pBlock = pSlot->pBlockData + DC_STREAM_LZ4_BLOCK_HDR_SIZE;
+    Cpa32U blockLen = 0;
+    Cpa32U blockHdr = 0;
+
+    pSlot->convStatus = icp_sal_DcLZ4SToLZ4Block(
+        pSrc,
+        srcLen,
+        pSlot->pDstData,
+        pSlot->results.produced,
+        pBlock,
+        pStream->blockDataSize - DC_STREAM_LZ4_BLOCK_HDR_SIZE,
+        &blockLen);
+    if (CPA_STATUS_SUCCESS == pSlot->convStatus)
+    {
+        if (blockLen >= srcLen)
+        {
+            blockLen = srcLen;
+            blockHdr = srcLen | DC_STREAM_LZ4_BLOCK_UNCOMPRESSED;
+            osalMemCopy(pBlock, pSrc, srcLen);
+        }
+        else
+        {
+            blockHdr = blockLen;
+        }
+        pSlot->pBlockData[0] = (Cpa8U)blockHdr;
+        pSlot->pBlockData[1] = (Cpa8U)(blockHdr >> 8);
+        pSlot->pBlockData[2] = (Cpa8U)(blockHdr >> 16);
+        pSlot->pBlockData[3] = (Cpa8U)(blockHdr >> 24);
+        pSlot->blockLen = DC_STREAM_LZ4_BLOCK_HDR_SIZE + blockLen;
+    }
+
+    __atomic_store_n(&pSlot->inFlight, CPA_FALSE, __ATOMIC_RELEASE);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Completion callback of the stream requests
+ *
+ * @description
+ *      The LZ4s output of a successful request is passed on to the worker
+ *      pool, so that the thread polling the instance keeps submitting and
+ *      draining while it is converted.
+ *
+ *****************************************************************************/
+STATIC void dcStreamCallback(void *callbackTag, CpaStatus status)
+{
+    dc_stream_slot_t *pSlot = (dc_stream_slot_t *)callbackTag;
+
+    pSlot->cbStatus = status;
+    if ((CPA_TRUE == pSlot->pStream->poolRef) &&
+        (CPA_STATUS_SUCCESS == status) &&
+        ((CPA_DC_OK == pSlot->results.status) ||
+         (CPA_DC_OVERFLOW == pSlot->results.status)))
+    {
+        dcCnvVerifyPoolSubmit(&pSlot->convWork);
+        return;
+    }
+    /* Publishes cbStatus and the results to the draining thread */
+    __atomic_store_n(&pSlot->inFlight, CPA_FALSE, __ATOMIC_RELEASE);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Hand a piece of the frame to the caller
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcStreamEmit(dc_stream_t *pStream,
+                              const Cpa8U *pData,
+                              Cpa32U dataLen)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    if (0 == dataLen)
+    {
+        return CPA_STATUS_SUCCESS;
+    }
+
+    status = pStream->pOutputFn(pStream->pOutputTag, pData, dataLen);
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Stream output function failed");
+        return CPA_STATUS_FAIL;
+    }
+    pStream->produced += dataLen;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Generate and emit the frame header
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcStreamEmitHeader(dc_stream_t *pStream)
+{
+    Cpa8U header[DC_STREAM_MAX_HDR_FTR_SIZE] = {0};
+    CpaFlatBuffer headerFlat = {0};
+    Cpa32U count = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    headerFlat.pData = header;
+    headerFlat.dataLenInBytes = sizeof(header);
+
+    if (CPA_DC_LZ4S == pStream->sessionSetupData.compType)
+    {
+        status = dc_lz4_generate_header_no_cksum(
+            &headerFlat, pStream->lz4BlockMaxSize, CPA_TRUE, &count);
+    }
+    else
+    {
+        status =
+            cpaDcGenerateHeader(pStream->pSessionHandle, &headerFlat, &count);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcStreamEmit(pStream, header, count);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        pStream->headerDone = CPA_TRUE;
+    }
+
+    return status;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Submit the unprocessed part of a slot to the instance
+ *
+ * @description
+ *      A full ring is handled by polling the instance and resubmitting.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcStreamSubmit(dc_stream_t *pStream, dc_stream_slot_t *pSlot)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    pSlot->srcFlat.pData = pSlot->pSrcData + pSlot->offset;
+    pSlot->srcFlat.dataLenInBytes = pSlot->fill - pSlot->offset;
+    pSlot->dstFlat.pData = pSlot->pDstData;
+    pSlot->dstFlat.dataLenInBytes = pStream->dstSize;
+
+    osalMemSet(&pSlot->results, 0, sizeof(CpaDcRqResults));
+    /* Every chunk starts from the default seed so that the chunk checksums
+     * are independent of the completion order */
+    if (CPA_DC_ADLER32 == pStream->sessionSetupData.checksum)
+    {
+        pSlot->results.checksum = DC_DEFAULT_ADLER32;
+    }
+    else if (CPA_DC_CRC32 == pStream->sessionSetupData.checksum)
+    {
+        pSlot->results.checksum = DC_DEFAULT_CRC;
+    }
+
+    osalMemSet(&pSlot->opData, 0, sizeof(CpaDcOpData));
+    pSlot->opData.flushFlag = pSlot->flushFlag;
+    pSlot->opData.compressAndVerify = CPA_TRUE;
+
+    pSlot->cbStatus = CPA_STATUS_SUCCESS;
+    pSlot->inFlight = CPA_TRUE;
+
+    do
+    {
+        status = cpaDcCompressData2(pStream->dcInstance,
+                                    pStream->pSessionHandle,
+                                    &pSlot->srcList,
+                                    &pSlot->dstList,
+                                    &pSlot->opData,
+                                    &pSlot->results,
+                                    pSlot);
+        if (CPA_STATUS_RETRY == status)
+        {
+            icp_sal_DcPollInstance(pStream->dcInstance, 0);
+            osalYield();
+        }
+    } while (CPA_STATUS_RETRY == status);
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pSlot->inFlight = CPA_FALSE;
+        LAC_LOG_ERROR("Failed to submit stream request");
+    }
+
+    return status;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Wait for the request of a slot to complete
+ *
+ *****************************************************************************/
+STATIC void dcStreamWait(dc_stream_t *pStream, dc_stream_slot_t *pSlot)
+{
+    while (CPA_TRUE == __atomic_load_n(&pSlot->inFlight, __ATOMIC_ACQUIRE))
+    {
+        if (CPA_STATUS_SUCCESS !=
+            icp_sal_DcPollInstance(pStream->dcInstance, 0))
+        {
+            osalYield();
+        }
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Drain the oldest outstanding request
+ *
+ * @description
+ *      Waits for the head request, emits its output and folds its checksum
+ *      into the frame checksum. If the request overflowed, the remainder of
+ *      the chunk is resubmitted from the same slot and the head is kept, so
+ *      that the output order is preserved.
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcStreamDrainHead(dc_stream_t *pStream)
+{
+    dc_stream_slot_t *pSlot = &pStream->pSlots[pStream->head];
+    CpaDcRqResults *pResults = &pSlot->results;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    dcStreamWait(pStream, pSlot);
+
+    if ((CPA_STATUS_SUCCESS != pSlot->cbStatus) ||
+        ((CPA_DC_OK != pResults->status) &&
+         (CPA_DC_OVERFLOW != pResults->status)))
+    {
+        LAC_LOG_ERROR1("Stream request failed with status %d",
+                       pResults->status);
+        return CPA_STATUS_FAIL;
+    }
+
+    if ((0 == pResults->consumed) && (0 == pResults->produced))
+    {
+        LAC_LOG_ERROR("Stream request made no progress");
+        return CPA_STATUS_FAIL;
+    }
+
+    if (CPA_DC_LZ4S == pStream->sessionSetupData.compType)
+    {
+        status = pSlot->convStatus;
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            LAC_LOG_ERROR("Failed to convert LZ4s data to an LZ4 block");
+        }
+        else
+        {
+            status =
+                dcStreamEmit(pStream, pSlot->pBlockData, pSlot->blockLen);
+        }
+    }
+    else
+    {
+        status = dcStreamEmit(pStream, pSlot->pDstData, pResults->produced);
+    }
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    if (CPA_DC_CRC32 == pStream->sessionSetupData.checksum)
+    {
+        pStream->checksum = dcCrc32Combine(
+            pStream->checksum, pResults->checksum, pResults->consumed);
+    }
+    else if (CPA_DC_ADLER32 == pStream->sessionSetupData.checksum)
+    {
+        pStream->checksum = dcStreamAdler32Combine(
+            pStream->checksum, pResults->checksum, pResults->consumed);
+    }
+    else if (CPA_DC_LZ4 == pStream->sessionSetupData.compType)
+    {
+        /* Accumulated by the device */
+        pStream->checksum = pResults->checksum;
+    }
+    pStream->consumed += pResults->consumed;
+    pSlot->offset += pResults->consumed;
+
+    if (pSlot->offset < pSlot->fill)
+    {
+        return dcStreamSubmit(pStream, pSlot);
+    }
+
+    pSlot->fill = 0;
+    pSlot->offset = 0;
+    pStream->head = (pStream->head + 1) % pStream->numSlots;
+    pStream->numSubmitted--;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Submit the tail slot and move on to the next one
+ *
+ *****************************************************************************/
+STATIC CpaStatus dcStreamSubmitTail(dc_stream_t *pStream, CpaDcFlush flushFlag)
+{
+    dc_stream_slot_t *pSlot = &pStream->pSlots[pStream->tail];
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    while (pStream->numSubmitted >= pStream->numInFlight)
+    {
+        status = dcStreamDrainHead(pStream);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            return status;
+        }
+    }
+
+    pSlot->flushFlag = flushFlag;
+    status = dcStreamSubmit(pStream, pSlot);
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        pStream->numSubmitted++;
+        pStream->tail = (pStream->tail + 1) % pStream->numSlots;
+    }
+
+    return status;
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Wait for all outstanding requests without processing their results
+ *
+ *****************************************************************************/
+STATIC void dcStreamQuiesce(dc_stream_t *pStream)
+{
+    Cpa32U i = 0;
+
+    for (i = 0; i < pStream->numSlots; i++)
+    {
+        dcStreamWait(pStream, &pStream->pSlots[i]);
+    }
+}
+
+/**
+ *****************************************************************************
+ * @ingroup SalDcStream
+ *      Release all resources of a stream
+ *
+ *****************************************************************************/
+STATIC void dcStreamFree(dc_stream_t *pStream)
+{
+    Cpa32U i = 0;
+
+    if (NULL != pStream->pSlots)
+    {
+        for (i = 0; i < pStream->numSlots; i++)
+        {
+            dc_stream_slot_t *pSlot = &pStream->pSlots[i];
+
+            LAC_OS_CAFREE(pSlot->pSrcData);
+            LAC_OS_CAFREE(pSlot->pDstData);
+            LAC_OS_CAFREE(pSlot->srcList.pPrivateMetaData);
+            LAC_OS_CAFREE(pSlot->dstList.pPrivateMetaData);
+            if (NULL != pSlot->pBlockData)
+            {
+                LAC_OS_FREE(pSlot->pBlockData);
+            }
+        }
+        LAC_OS_FREE(pStream->pSlots);
+    }
+    if (CPA_TRUE == pStream->poolRef)
+    {
+        dcCnvVerifyPoolPut();
+    }
+    LAC_OS_CAFREE(pStream->pSessionHandle);
+    LAC_OS_FREE(pStream);
+}
+
+CpaStatus icp_sal_DcStreamCreate(CpaInstanceHandle dcInstance,
+                                 const icp_sal_dc_stream_setup_t *pSetupData,
+                                 icp_sal_dc_stream_handle_t *pStreamHandle)
+{
+    CpaInstanceHandle insHandle = NULL;
+    sal_compression_service_t *pService = NULL;
+    dc_stream_t *pStream = NULL;
+    CpaDcSessionSetupData *pSd = NULL;
+    Cpa32U sessionSize = 0;
+    Cpa32U contextSize = 0;
+    Cpa32U metaSize = 0;
+    Cpa32U minDstSize = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pSetupData);
+    LAC_CHECK_NULL_PARAM(pSetupData->pOutputFn);
+    LAC_CHECK_NULL_PARAM(pStreamHandle);
+
+    if (CPA_INSTANCE_HANDLE_SINGLE == dcInstance)
+    {
+        insHandle = dcGetFirstHandle();
+    }
+    else
+    {
+        insHandle = dcInstance;
+    }
+    LAC_CHECK_NULL_PARAM(insHandle);
+    SAL_CHECK_INSTANCE_TYPE(insHandle, SAL_SERVICE_TYPE_COMPRESSION);
+    SAL_RUNNING_CHECK(insHandle);
+    pService = (sal_compression_service_t *)insHandle;
+
+    if (!(((CPA_DC_DEFLATE == pSetupData->compType) &&
+           ((CPA_DC_CRC32 == pSetupData->checksum) ||
+            (CPA_DC_ADLER32 == pSetupData->checksum))) ||
+          (((CPA_DC_LZ4 == pSetupData->compType) ||
+            (CPA_DC_LZ4S == pSetupData->compType)) &&
+           (CPA_DC_XXHASH32 == pSetupData->checksum))))
+    {
+        LAC_INVALID_PARAM_LOG("Unsupported frame format");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if ((0 == pSetupData->numInFlight) ||
+        (pSetupData->numInFlight > ICP_SAL_DC_STREAM_MAX_IN_FLIGHT))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid numInFlight value");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    if ((CPA_DC_LZ4S == pSetupData->compType) &&
+        ((pSetupData->lz4BlockMaxSize < CPA_DC_LZ4_MAX_BLOCK_SIZE_64K) ||
+         (pSetupData->lz4BlockMaxSize > CPA_DC_LZ4_MAX_BLOCK_SIZE_4M)))
+    {
+        LAC_INVALID_PARAM_LOG("Invalid LZ4 Block Max Size value.");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    status = LAC_OS_MALLOC(&pStream, sizeof(dc_stream_t));
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+    osalMemSet(pStream, 0, sizeof(dc_stream_t));
+
+    pStream->dcInstance = insHandle;
+    pStream->pOutputFn = pSetupData->pOutputFn;
+    pStream->pOutputTag = pSetupData->pOutputTag;
+    pStream->chunkSize = (0 == pSetupData->chunkSize)
+                             ? ICP_SAL_DC_STREAM_DEFAULT_CHUNK_SIZE
+                             : pSetupData->chunkSize;
+    pStream->lz4BlockMaxSize = pSetupData->lz4BlockMaxSize;
+    if ((CPA_DC_LZ4S == pSetupData->compType) &&
+        (pStream->chunkSize > (DC_STREAM_LZ4_MIN_BLOCK_SIZE
+                               << (2 * pSetupData->lz4BlockMaxSize))))
+    {
+        /* Every chunk becomes one LZ4 block */
+        pStream->chunkSize = DC_STREAM_LZ4_MIN_BLOCK_SIZE
+                             << (2 * pSetupData->lz4BlockMaxSize);
+    }
+    pStream->numInFlight = (CPA_DC_LZ4 == pSetupData->compType)
+                               ? 1
+                               : pSetupData->numInFlight;
+    /* One extra slot is filled while the others are in flight */
+    pStream->numSlots = pStream->numInFlight + 1;
+    pStream->checksum = (CPA_DC_ADLER32 == pSetupData->checksum)
+                            ? DC_DEFAULT_ADLER32
+                            : DC_DEFAULT_CRC;
+
+    pSd = &pStream->sessionSetupData;
+    pSd->compLevel = pSetupData->compLevel;
+    pSd->compType = pSetupData->compType;
+    pSd->huffType = pSetupData->huffType;
+    pSd->autoSelectBestHuffmanTree = CPA_DC_ASB_ENABLED;
+    pSd->sessDirection = CPA_DC_DIR_COMPRESS;
+    pSd->sessState = CPA_DC_STATELESS;
+    pSd->checksum = pSetupData->checksum;
+    if (CPA_DC_LZ4 == pSetupData->compType)
+    {
+        pSd->lz4BlockMaxSize = pSetupData->lz4BlockMaxSize;
+        pSd->lz4BlockIndependence = CPA_TRUE;
+        pSd->accumulateXXHash = CPA_TRUE;
+    }
+    else if (CPA_DC_LZ4S == pSetupData->compType)
+    {
+        /* Shorter matches can not be expressed in LZ4 blocks */
+        pSd->minMatch = CPA_DC_MIN_4_BYTE_MATCH;
+    }
+
+    /* Size the output buffers for the worst case expansion of a chunk */
+    if (CPA_DC_LZ4 == pSetupData->compType)
+    {
+        status = cpaDcLZ4CompressBound(
+            insHandle, pStream->chunkSize, &pStream->dstSize);
+    }
+    else if (CPA_DC_LZ4S == pSetupData->compType)
+    {
+        status = cpaDcLZ4SCompressBound(
+            insHandle, pStream->chunkSize, &pStream->dstSize);
+    }
+    else
+    {
+        status = cpaDcDeflateCompressBound(insHandle,
+                                           pSetupData->huffType,
+                                           pStream->chunkSize,
+                                           &pStream->dstSize);
+    }
+    if ((0 != pSetupData->dstSizePercent) &&
+        (((Cpa64U)pStream->chunkSize * pSetupData->dstSizePercent) / 100 <
+         pStream->dstSize))
+    {
+        /* Trade the pinned memory of the worst case for overflows */
+        pStream->dstSize =
+            ((Cpa64U)pStream->chunkSize * pSetupData->dstSizePercent) / 100;
+    }
+    minDstSize = (CPA_DC_HT_FULL_DYNAMIC == pSetupData->huffType)
+                     ? pService->comp_device_data.minOutputBuffSizeDynamic
+                     : pService->comp_device_data.minOutputBuffSize;
+    if (pStream->dstSize < minDstSize)
+    {
+        pStream->dstSize = minDstSize;
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status =
+            cpaDcGetSessionSize(insHandle, pSd, &sessionSize, &contextSize);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = LAC_OS_CAMALLOC(&pStream->pSessionHandle,
+                                 sessionSize,
+                                 LAC_64BYTE_ALIGNMENT,
+                                 pService->nodeAffinity);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = cpaDcBufferListGetMetaSize(insHandle, 1, &metaSize);
+    }
+    if ((CPA_STATUS_SUCCESS == status) &&
+        (CPA_DC_LZ4S == pSetupData->compType))
+    {
+        pStream->blockDataSize = DC_STREAM_LZ4_BLOCK_HDR_SIZE +
+                                 ICP_SAL_DC_LZ4_BLOCK_BOUND(pStream->chunkSize);
+        status = dcCnvVerifyPoolGet();
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            pStream->poolRef = CPA_TRUE;
+        }
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = LAC_OS_MALLOC(&pStream->pSlots,
+                               pStream->numSlots * sizeof(dc_stream_slot_t));
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        osalMemSet(pStream->pSlots,
+                   0,
+                   pStream->numSlots * sizeof(dc_stream_slot_t));
+    }
+
+    for (i = 0; (CPA_STATUS_SUCCESS == status) && (i < pStream->numSlots);
+         i++)
+    {
+        dc_stream_slot_t *pSlot = &pStream->pSlots[i];
+
+        pSlot->pStream = pStream;
+        pSlot->convWork.pWorkFn = dcStreamConvertLZ4S;
+        pSlot->convWork.pWorkArg = pSlot;
+        pSlot->srcList.numBuffers = 1;
+        pSlot->srcList.pBuffers = &pSlot->srcFlat;
+        pSlot->dstList.numBuffers = 1;
+        pSlot->dstList.pBuffers = &pSlot->dstFlat;
+
+        status = LAC_OS_CAMALLOC(&pSlot->pSrcData,
+                                 pStream->chunkSize,
+                                 LAC_64BYTE_ALIGNMENT,
+                                 pService->nodeAffinity);
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            status = LAC_OS_CAMALLOC(&pSlot->pDstData,
+                                     pStream->dstSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+        if ((CPA_STATUS_SUCCESS == status) && (0 != metaSize))
+        {
+            status = LAC_OS_CAMALLOC(&pSlot->srcList.pPrivateMetaData,
+                                     metaSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+        if ((CPA_STATUS_SUCCESS == status) && (0 != metaSize))
+        {
+            status = LAC_OS_CAMALLOC(&pSlot->dstList.pPrivateMetaData,
+                                     metaSize,
+                                     LAC_64BYTE_ALIGNMENT,
+                                     pService->nodeAffinity);
+        }
+        if ((CPA_STATUS_SUCCESS == status) && (0 != pStream->blockDataSize))
+        {
+            status =
+                LAC_OS_MALLOC(&pSlot->pBlockData, pStream->blockDataSize);
+        }
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = cpaDcInitSession(
+            insHandle, pStream->pSessionHandle, pSd, NULL, dcStreamCallback);
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to create compression stream");
+        dcStreamFree(pStream);
+        return status;
+    }
+
+    *pStreamHandle = pStream;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcStreamWrite(icp_sal_dc_stream_handle_t streamHandle,
+                                const Cpa8U *pData,
+                                Cpa32U dataLen)
+{
+    dc_stream_t *pStream = (dc_stream_t *)streamHandle;
+    dc_stream_slot_t *pSlot = NULL;
+    Cpa32U copyLen = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pStream);
+    if (0 != dataLen)
+    {
+        LAC_CHECK_NULL_PARAM(pData);
+    }
+
+    if ((CPA_TRUE == pStream->failed) || (CPA_TRUE == pStream->finished))
+    {
+        return CPA_STATUS_FAIL;
+    }
+
+    if (CPA_FALSE == pStream->headerDone)
+    {
+        status = dcStreamEmitHeader(pStream);
+    }
+
+    while ((CPA_STATUS_SUCCESS == status) && (0 != dataLen))
+    {
+        pSlot = &pStream->pSlots[pStream->tail];
+
+        /* A full chunk is only submitted once it is known not to be the
+         * last one */
+        if (pSlot->fill == pStream->chunkSize)
+        {
+            /* LZ4s chunks are converted into independent blocks */
+            status = dcStreamSubmitTail(
+                pStream,
+                (CPA_DC_LZ4S == pStream->sessionSetupData.compType)
+                    ? CPA_DC_FLUSH_FINAL
+                    : CPA_DC_FLUSH_FULL);
+            continue;
+        }
+
+        copyLen = pStream->chunkSize - pSlot->fill;
+        if (copyLen > dataLen)
+        {
+            copyLen = dataLen;
+        }
+        osalMemCopy(pSlot->pSrcData + pSlot->fill, pData, copyLen);
+        pSlot->fill += copyLen;
+        pData += copyLen;
+        dataLen -= copyLen;
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pStream->failed = CPA_TRUE;
+    }
+
+    return status;
+}
+
+CpaStatus icp_sal_DcStreamFinish(icp_sal_dc_stream_handle_t streamHandle,
+                                 Cpa64U *pConsumed,
+                                 Cpa64U *pProduced)
+{
+    dc_stream_t *pStream = (dc_stream_t *)streamHandle;
+    Cpa8U footer[DC_STREAM_MAX_HDR_FTR_SIZE] = {0};
+    CpaFlatBuffer footerFlat = {0};
+    CpaDcRqResults footerResults = {0};
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pStream);
+
+    if ((CPA_TRUE == pStream->failed) || (CPA_TRUE == pStream->finished))
+    {
+        return CPA_STATUS_FAIL;
+    }
+
+    if (CPA_FALSE == pStream->headerDone)
+    {
+        status = dcStreamEmitHeader(pStream);
+    }
+
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        if (0 != pStream->pSlots[pStream->tail].fill)
+        {
+            status = dcStreamSubmitTail(pStream, CPA_DC_FLUSH_FINAL);
+        }
+        else if (CPA_DC_DEFLATE == pStream->sessionSetupData.compType)
+        {
+            /* Stateless sessions do not accept empty requests, close the
+             * empty deflate stream in software */
+            status = dcStreamEmit(pStream,
+                                  dcStreamEmptyDeflateBlock,
+                                  DC_STREAM_EMPTY_DEFLATE_BLOCK_SIZE);
+        }
+        else if (CPA_DC_LZ4 == pStream->sessionSetupData.compType)
+        {
+            pStream->checksum = DC_STREAM_XXHASH32_EMPTY;
+        }
+    }
+
+    while ((CPA_STATUS_SUCCESS == status) && (0 != pStream->numSubmitted))
+    {
+        status = dcStreamDrainHead(pStream);
+    }
+
+    if ((CPA_STATUS_SUCCESS == status) &&
+        (CPA_DC_LZ4S == pStream->sessionSetupData.compType))
+    {
+        /* End mark only, the frame has no content checksum */
+        footerResults.produced = DC_STREAM_LZ4_BLOCK_HDR_SIZE;
+    }
+    else if (CPA_STATUS_SUCCESS == status)
+    {
+        footerFlat.pData = footer;
+        footerFlat.dataLenInBytes = sizeof(footer);
+        footerResults.checksum = pStream->checksum;
+        status = cpaDcGenerateFooter(
+            pStream->pSessionHandle, &footerFlat, &footerResults);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = dcStreamEmit(pStream, footer, footerResults.produced);
+    }
+
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        pStream->failed = CPA_TRUE;
+        return status;
+    }
+
+    pStream->finished = CPA_TRUE;
+    if (NULL != pConsumed)
+    {
+        *pConsumed = pStream->consumed;
+    }
+    if (NULL != pProduced)
+    {
+        *pProduced = pStream->produced;
+    }
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_DcStreamDestroy(icp_sal_dc_stream_handle_t streamHandle)
+{
+    dc_stream_t *pStream = (dc_stream_t *)streamHandle;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pStream);
+
+    dcStreamQuiesce(pStream);
+
+    status = cpaDcRemoveSession(pStream->dcInstance, pStream->pSessionHandle);
+    if (CPA_STATUS_SUCCESS != status)
+    {
+        LAC_LOG_ERROR("Failed to remove stream session");
+    }
+
+    dcStreamFree(pStream);
+
+    return status;
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_cnv_verify.h
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Definition of the software compress and verify worker pool. Stateless
+ *      compression requests of sessions using the asynchronous software
+ *      verify CnV policy are sent without device verification; their
+ *      completions are handed to the pool which decompresses the produced
+ *      data on the CPU and compares it with the source before invoking the
+ *      user callback. The same workers run the other CPU stages of the
+ *      compression service, such as the conversion of the LZ4s output of
+ *      streams, submitted as dc_cnv_work_t items.
+ *
+ *****************************************************************************/
+#ifndef DC_CNV_VERIFY_H_
+#define DC_CNV_VERIFY_H_
+
+#include "cpa_types.h"
+#include "dc_datapath.h"
+
+/* Number of worker threads of the software verify pool */
+#define DC_CNV_VERIFY_NUM_WORKERS (4)
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Take a reference on the software verify pool
+ *
+ * @description
+ *      Starts the worker threads on the first reference. Every session
+ *      using the asynchronous software verify policy and every LZ4S stream
+ *      holds one reference.
+ *
+ * @retval CPA_STATUS_SUCCESS       The pool is running
+ * @retval CPA_STATUS_RETRY         Called from a verify callback while the
+ *                                  pool is being stopped
+ * @retval CPA_STATUS_RESOURCE      The worker threads could not be created
+ *
+ *****************************************************************************/
+CpaStatus dcCnvVerifyPoolGet(void);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Release a reference on the software verify pool
+ *
+ * @description
+ *      Stops the worker threads when the last reference is released. The
+ *      caller guarantees no request of its session is waiting in the pool.
+ *      May be called from a callback invoked by the pool.
+ *
+ *****************************************************************************/
+void dcCnvVerifyPoolPut(void);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Queue a work item on the software worker pool
+ *
+ * @description
+ *      The caller holds a reference on the pool and keeps pWork alive until
+ *      its work function has run. Items are started in submission order.
+ *
+ * @param[in]   pWork           Work item, pWorkFn and pWorkArg set
+ *
+ *****************************************************************************/
+void dcCnvVerifyPoolSubmit(dc_cnv_work_t *pWork);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Hand a completed request to the software verify pool
+ *
+ * @description
+ *      Called from the response path once the results of a successful
+ *      stateless compression request are final. The pool owns the cookie
+ *      from then on: it verifies the produced data, updates the results,
+ *      releases the pending callback count of the session, frees the cookie
+ *      and invokes the user callback.
+ *
+ * @param[in]   pCookie         Cookie of the completed request
+ *
+ *****************************************************************************/
+void dcCnvVerifyEnqueue(dc_compression_cookie_t *pCookie);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Decompress raw deflate data in software
+ *
+ * @description
+ *      Decodes the blocks of pIn up to and including the final block.
+ *
+ * @param[in]   pIn             Compressed data
+ * @param[in]   inLen           Length of the compressed data
+ * @param[out]  pOut            Decompressed data
+ * @param[in]   outLen          Size of the decompressed data buffer
+ * @param[out]  pConsumed       Number of compressed bytes up to the end of
+ *                              the final block
+ * @param[out]  pProduced       Number of decompressed bytes
+ *
+ * @retval CPA_TRUE             The final block was decoded
+ * @retval CPA_FALSE            The data is invalid, truncated or does not
+ *                              fit in pOut
+ *
+ *****************************************************************************/
+CpaBoolean dcCnvInflateBuffer(const Cpa8U *pIn,
+                              Cpa32U inLen,
+                              Cpa8U *pOut,
+                              Cpa32U outLen,
+                              Cpa32U *pConsumed,
+                              Cpa32U *pProduced);
+
+#endif /* DC_CNV_VERIFY_H_ */
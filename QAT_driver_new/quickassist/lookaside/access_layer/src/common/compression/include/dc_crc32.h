@@ -57,6 +57,22 @@ extern Cpa32U crc32_gzip_refl_by8(Cpa32U initial_crc,
                                   const Cpa8U *buffer,
                                   Cpa64U buffer_length);
 
+/**
+ * @description
+ *     Calculates CRC-32 checksum for given buffer with the fastest kernel
+ *     supported by the CPU.
+ *
+ *     Uses the VPCLMULQDQ/AVX-512 folding kernel when available, otherwise
+ *     crc32_gzip_refl_by8(). The selection is made on first use.
+ *
+ * @param[in]  crc            Initial CRC-32 value (used for multi-segment calc)
+ * @param[in]  pData          Pointer to data byte array to calculate CRC on
+ * @param[in]  len            Length of data array
+ *
+ * @retval Cpa32U             32bit long CRC checksum for given buffer
+ */
+Cpa32U dcCrc32GzipRefl(Cpa32U crc, const Cpa8U *pData, Cpa64U len);
+
 /**
  * @description
  *     Helper function to calculate CRC32 checksum on a buffer list.
@@ -79,4 +95,17 @@ Cpa32U dcCalculateCrc32(CpaBufferList *pBufferList,
                         Cpa32U consumedBytes,
                         const Cpa32U seedChecksum);
 
+/**
+ * @description
+ *     Combines the CRC-32 of two adjacent blocks of data
+ *
+ * @param[in]  crc1           CRC-32 of the first block
+ * @param[in]  crc2           CRC-32 of the second block
+ * @param[in]  len2           Length of the second block in bytes
+ *
+ * @retval Cpa32U             CRC-32 of the first block followed by the
+ *                            second one
+ */
+Cpa32U dcCrc32Combine(Cpa32U crc1, Cpa32U crc2, Cpa64U len2);
+
 #endif /* end of DC_CRC32_H_ */
@@ -57,6 +57,22 @@ extern Cpa64U crc64_ecma_norm_by8(Cpa64U initial_crc,
                                   const Cpa8U *buffer,
                                   Cpa64U buffer_length);
 
+/**
+ * @description
+ *     Calculates CRC-64 ECMA-182 checksum for given buffer with the fastest
+ *     kernel supported by the CPU.
+ *
+ *     Uses the VPCLMULQDQ/AVX-512 folding kernel when available, otherwise
+ *     crc64_ecma_norm_by8(). The selection is made on first use.
+ *
+ * @param[in]  crc            Initial CRC-64 value (used for multi-segment calc)
+ * @param[in]  pData          Pointer to data byte array to calculate CRC on
+ * @param[in]  len            Length of data array
+ *
+ * @retval Cpa64U             64bit long CRC checksum for given buffer
+ */
+Cpa64U dcCrc64EcmaNorm(Cpa64U crc, const Cpa8U *pData, Cpa64U len);
+
 /**
  * @description
  *     Helper function to calculate CRC64 checksum on a buffer list.
@@ -112,6 +112,23 @@
  * align the results field with the API struct  */
 #define DC_API_ALIGNMENT_OFFSET (offsetof(CpaDcDpOpData, results))
 
+/* Hand a completed DcDp request back to the application: store it in the
+ * completion array when a batch poll is in progress, otherwise invoke the
+ * registered callback */
+#define DC_DP_COMPLETE(pService, pOpData)                                      \
+    do                                                                         \
+    {                                                                          \
+        if (NULL != (pService)->ppDcDpCqEntries)                               \
+        {                                                                      \
+            (pService)->ppDcDpCqEntries[(pService)->dcDpCqCount++] =           \
+                (pOpData);                                                     \
+        }                                                                      \
+        else                                                                   \
+        {                                                                      \
+            ((pService)->pDcDpCb)(pOpData);                                    \
+        }                                                                      \
+    } while (0)
+
 /* Mask used to check the CompressAndVerify capability bit */
 #define DC_CNV_EXTENDED_CAPABILITY (0x01)
 
@@ -152,6 +169,19 @@ typedef enum dc_opdata_type_e
     /**< Refer to the API definition for CpaDcOpData2 format */
 } dc_opdata_type_t;
 
+/* Outcome of the compressibility pre-check of a compression request */
+typedef enum dc_precheck_result_e
+{
+    DC_PRECHECK_NONE = 0,
+    /**< The request was not checked */
+    DC_PRECHECK_COMPRESSIBLE,
+    /**< Estimated compressible, offloaded */
+    DC_PRECHECK_AUDIT,
+    /**< Estimated incompressible, offloaded to audit the estimate */
+    DC_PRECHECK_INCOMPRESSIBLE
+    /**< Estimated incompressible, stored in software */
+} dc_precheck_result_t;
+
 typedef struct dc_opdata_ext_s
 {
     dc_opdata_type_t opDataType;
@@ -160,6 +190,29 @@ typedef struct dc_opdata_ext_s
     /**< Pointer to the OpData structure being used */
 } dc_opdata_ext_t;
 
+struct dc_cnv_scratch_s;
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Work item of the software worker pool
+ *
+ * @description
+ *      Embedded in the object it processes, so that queueing work does not
+ *      allocate. pWorkFn runs on a worker thread and is passed the scratch
+ *      buffers of that worker.
+ *
+ *****************************************************************************/
+typedef struct dc_cnv_work_s
+{
+    struct dc_cnv_work_s *pNext;
+    /**< Next item waiting in the pool */
+    void (*pWorkFn)(void *pWorkArg, struct dc_cnv_scratch_s *pScratch);
+    /**< Function run by the worker */
+    void *pWorkArg;
+    /**< Argument passed to pWorkFn */
+} dc_cnv_work_t;
+
 /**
 *******************************************************************************
 * @ingroup cpaDc Data Compression
@@ -177,6 +230,16 @@ typedef struct dc_opdata_ext_s
 *****************************************************************************/
 typedef struct dc_compression_cookie_s
 {
+    /* The cookie is laid out in 64 byte lines. The first line is the
+     * unused prefix shared with CpaDcDpOpData, so that the response
+     * callback finds dcInstance and pSessionHandle at the same offsets
+     * before it knows which API sent the request. The fields read on
+     * completion follow them and fill the next line and the start of the
+     * one after; the rest of the CPU fields are only used on submission
+     * or on the less common paths. The request is only touched on
+     * submission and the firmware writes the data integrity CRCs, so each
+     * sits on lines of its own. See sample_code/micro_bench/cookie_bench.c
+     */
     Cpa8U dcReqParamsBuffer[DC_API_ALIGNMENT_OFFSET];
     /**< Memory block  - was previously reserved for request parameters.
      * Now size maintained so following members align with API struct,
@@ -189,41 +252,53 @@ typedef struct dc_compression_cookie_s
     CpaDcSessionHandle pSessionHandle;
     /**< Pointer to the session handle. It is either a real address or a
      * special value used to identify requests coming from the NS API. */
-    icp_qat_fw_comp_req_t request;
-    /**< Compression request */
     void *callbackTag;
     /**< Opaque data supplied by the client */
     dc_session_desc_t *pSessionDesc;
     /**< Pointer to the session descriptor */
-    CpaDcFlush flushFlag;
-    /**< Flush flag */
     CpaDcOpData *pDcOpData;
     /**< struct containing flags and CRC related data for this session */
     CpaDcRqResults *pResults;
     /**< Pointer to result buffer holding consumed and produced data */
-    Cpa32U srcTotalDataLenInBytes;
-    /**< Total length of the source data */
-    Cpa32U dstTotalDataLenInBytes;
-    /**< Total length of the destination data */
+    CpaDcCallbackFn pCbFunc;
+    /**< Callback function defined for the traditional sessionless API */
     dc_request_dir_t compDecomp;
     /**< Used to know whether the request is compression or decompression.
      * Useful when defining the session as combined */
-#ifdef ICP_DC_ERROR_SIMULATION
-    CpaDcReqStatus dcErrorToSimulate;
-/**< Dc error inject simulation */
-#endif
+    CpaDcFlush flushFlag;
+    /**< Flush flag */
+    dc_chain_info_t dcChain;
+    /**< DC Chain info if DC used as part of a DC Chain operation. */
+    CpaBoolean cnvSwVerify;
+    /**< Set when the produced data is verified in software before the
+     * user callback is invoked */
+    dc_precheck_result_t precheck;
+    /**< Compressibility pre-check outcome, accounted on completion */
+    void *pDictWrap;
+    /**< Dictionary buffer lists of a decompression request on a dictionary
+     * session, NULL otherwise */
     CpaBufferList *pUserSrcBuff;
     /**< virtual userspace ptr to source SGL */
     CpaBufferList *pUserDestBuff;
     /**< virtual userspace ptr to destination SGL */
-    CpaDcCallbackFn pCbFunc;
-    /**< Callback function defined for the traditional sessionless API */
+    Cpa32U srcTotalDataLenInBytes;
+    /**< Total length of the source data */
+    Cpa32U dstTotalDataLenInBytes;
+    /**< Total length of the destination data */
     CpaDcChecksum checksumType;
     /**< Type of checksum */
-    dc_integrity_crc_fw_t dataIntegrityCrcs;
-    /**< Data integrity table */
-    dc_chain_info_t dcChain;
-    /**< DC Chain info if DC used as part of a DC Chain operation. */
+    dc_cnv_work_t cnvWork;
+    /**< Software verification of the request by the worker pool */
+#ifdef ICP_DC_ERROR_SIMULATION
+    CpaDcReqStatus dcErrorToSimulate;
+/**< Dc error inject simulation */
+#endif
+    icp_qat_fw_comp_req_t request
+        __attribute__((aligned(LAC_64BYTE_ALIGNMENT)));
+    /**< Compression request */
+    dc_integrity_crc_fw_t dataIntegrityCrcs
+        __attribute__((aligned(LAC_64BYTE_ALIGNMENT)));
+    /**< Data integrity table, written by the firmware */
 } dc_compression_cookie_t;
 
 /**
@@ -0,0 +1,278 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_dict.h
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Definition of the preset dictionary support of stateless sessions.
+ *
+ *      The dictionary is stored once per session in pinned memory, prefixed
+ *      with the header of a deflate stored block or of an uncompressed LZ4
+ *      block. Decompression requests are sent to the device with that
+ *      prefix chained in front of the source data and a shared discard
+ *      buffer chained in front of the destination, so the device sees the
+ *      dictionary as history. The device has no preset history for
+ *      stateless compression, so the compression requests of a dictionary
+ *      session are encoded in software against the dictionary.
+ *
+ *****************************************************************************/
+#ifndef DC_DICT_H_
+#define DC_DICT_H_
+
+#include "cpa_types.h"
+#include "cpa_dc.h"
+#include "dc_session.h"
+
+/* Largest deflate dictionary, the size of the deflate window */
+#define DC_DICT_MAX_DEFLATE_SIZE (32 * 1024)
+
+/* Largest LZ4 dictionary, the largest LZ4 match offset */
+#define DC_DICT_MAX_LZ4_SIZE (64 * 1024 - 1)
+
+/* Largest number of buffers in a user buffer list of a decompression
+ * request on a dictionary session */
+#define DC_DICT_MAX_USER_BUFFERS (16)
+
+/* Number of decompression requests in flight on a dictionary session */
+#define DC_DICT_MAX_IN_FLIGHT (32)
+
+/* Number of deflate length codes (257..285) and distance codes (0..29) */
+#define DC_DEFLATE_NUM_LEN_CODES (29)
+#define DC_DEFLATE_NUM_DIST_CODES (30)
+
+/* Base values and extra bits of the deflate length and distance codes,
+ * shared by the software encoder and decoders */
+extern const Cpa16U dcDeflateLenBase[DC_DEFLATE_NUM_LEN_CODES];
+extern const Cpa8U dcDeflateLenExtra[DC_DEFLATE_NUM_LEN_CODES];
+extern const Cpa16U dcDeflateDistBase[DC_DEFLATE_NUM_DIST_CODES];
+extern const Cpa8U dcDeflateDistExtra[DC_DEFLATE_NUM_DIST_CODES];
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Set or clear the preset dictionary of a session
+ *
+ * @description
+ *      Copies the dictionary into pinned memory and indexes it for the
+ *      software encoder. A NULL dictionary clears it. For deflate the
+ *      dictionary id is the Adler-32 of the dictionary, as written in the
+ *      DICTID field of a zlib header; for LZ4 it is the caller's id.
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       pDict            Dictionary, or NULL to clear it
+ * @param[in]       dictLen          Length of the dictionary
+ * @param[in]       dictId           LZ4 dictionary id, ignored for deflate
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_RESOURCE       Memory allocation failed
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported session configuration
+ *****************************************************************************/
+CpaStatus dcSetDictionary(CpaInstanceHandle dcInstance,
+                          CpaDcSessionHandle pSessionHandle,
+                          const Cpa8U *pDict,
+                          Cpa32U dictLen,
+                          Cpa32U dictId);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Release the dictionary of a session
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ *
+ *****************************************************************************/
+void dcDictFree(dc_session_desc_t *pSessionDesc);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Dictionary id of a session
+ *
+ * @description
+ *      Returns the id written in the frame header of the compressed data.
+ *
+ * @param[in]       pSessionDesc     Pointer to a session descriptor with a
+ *                                   dictionary
+ *
+ *****************************************************************************/
+Cpa32U dcDictGetId(const dc_session_desc_t *pSessionDesc);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Checksum of the first bytes of a buffer list
+ *
+ * @description
+ *      Computes the checksum of the session type over len bytes of the
+ *      buffer list, continuing from seed for CRC-32 and Adler-32. Also used
+ *      by the other requests completed in software.
+ *
+ * @param[in]       checksumType     CPA_DC_CRC32, CPA_DC_ADLER32 or
+ *                                   CPA_DC_XXHASH32
+ * @param[in]       pBufferList      Buffer list
+ * @param[in]       len              Number of bytes to checksum
+ * @param[in]       seed             Initial CRC-32 or Adler-32 value
+ *
+ * @retval The checksum
+ *****************************************************************************/
+Cpa32U dcDictChecksumSgl(CpaDcChecksum checksumType,
+                         CpaBufferList *pBufferList,
+                         Cpa32U len,
+                         Cpa32U seed);
+
+#ifndef KERNEL_SPACE
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Deflate a flat buffer in software
+ *
+ * @description
+ *      Encodes the buffer as one fixed Huffman block with the match finder
+ *      of the dictionary encoder, without a dictionary. A block which is
+ *      not final is followed by an empty stored block, as the device
+ *      writes for CPA_DC_FLUSH_FULL. The match finder tables are per
+ *      thread and sized for inline requests: positions more than 1KB
+ *      back are not matched. User space only.
+ *
+ * @param[in]       pIn              Input data
+ * @param[in]       inLen            Length of the input data
+ * @param[out]      pOut             Output buffer
+ * @param[in]       outLen           Size of the output buffer
+ * @param[in]       final            Set BFINAL on the block
+ *
+ * @retval Number of bytes written, 0 if the output did not fit
+ *****************************************************************************/
+Cpa32U dcDictDeflateBuffer(const Cpa8U *pIn,
+                           Cpa32U inLen,
+                           Cpa8U *pOut,
+                           Cpa32U outLen,
+                           CpaBoolean final);
+#endif
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Compress a request of a dictionary session in software
+ *
+ * @description
+ *      Encodes the source data against the dictionary and fills in the
+ *      results, including the checksum, as the device would.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pSrcBuff         Source buffer list
+ * @param[out]      pDestBuff        Destination buffer list
+ * @param[in,out]   pResults         Results of the request
+ * @param[in]       flushFlag        Flush flag of the request
+ *
+ * @retval CPA_STATUS_SUCCESS        Request completed, see pResults->status
+ * @retval CPA_STATUS_RESOURCE       Memory allocation failed
+ *****************************************************************************/
+CpaStatus dcDictCompress(dc_session_desc_t *pSessionDesc,
+                         CpaBufferList *pSrcBuff,
+                         CpaBufferList *pDestBuff,
+                         CpaDcRqResults *pResults,
+                         CpaDcFlush flushFlag);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Chain the dictionary in front of a decompression request
+ *
+ * @description
+ *      Returns buffer lists with the dictionary prefix in front of the
+ *      source and the discard buffer in front of the destination. The
+ *      wrapper returned in ppWrap is released by dcDictRequestComplete or
+ *      dcDictWrapRelease.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pSrcBuff         User source buffer list
+ * @param[in]       pDestBuff        User destination buffer list
+ * @param[in]       pResults         Results of the request
+ * @param[out]      ppSrcBuff        Source buffer list to send
+ * @param[out]      ppDestBuff       Destination buffer list to send
+ * @param[out]      ppWrap           Wrapper of the request
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_RETRY          All the wrappers are in use
+ * @retval CPA_STATUS_INVALID_PARAM  Too many buffers in a buffer list
+ *****************************************************************************/
+CpaStatus dcDictWrapRequest(dc_session_desc_t *pSessionDesc,
+                            CpaBufferList *pSrcBuff,
+                            CpaBufferList *pDestBuff,
+                            CpaDcRqResults *pResults,
+                            CpaBufferList **ppSrcBuff,
+                            CpaBufferList **ppDestBuff,
+                            void **ppWrap);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Complete a decompression request of a dictionary session
+ *
+ * @description
+ *      Removes the dictionary from the consumed and produced byte counts,
+ *      recomputes the checksum over the user data and releases the
+ *      wrapper.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pWrap            Wrapper of the request
+ * @param[in,out]   pResults         Results of the request
+ *
+ *****************************************************************************/
+void dcDictRequestComplete(dc_session_desc_t *pSessionDesc,
+                           void *pWrap,
+                           CpaDcRqResults *pResults);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Release the wrapper of a request which was not completed
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pWrap            Wrapper of the request
+ *
+ *****************************************************************************/
+void dcDictWrapRelease(dc_session_desc_t *pSessionDesc, void *pWrap);
+
+#endif /* DC_DICT_H_ */
@@ -54,4 +54,51 @@ CpaStatus dc_hdr_cksum(const void *xxH32input,
                        const Cpa32U dataLength,
                        Cpa8U *checksum);
 
+#define DC_XXH32_STRIPE_SIZE 16
+
+/**
+ * @description
+ *     Streaming xxhash32 state
+ */
+typedef struct dc_xxh32_state_s
+{
+    Cpa32U acc[4];
+    /**< Stripe accumulators */
+    Cpa32U seed;
+    /**< Seed of the hash */
+    Cpa64U totalLen;
+    /**< Number of bytes hashed */
+    Cpa8U mem[DC_XXH32_STRIPE_SIZE];
+    /**< Bytes of an incomplete stripe */
+    Cpa32U memSize;
+    /**< Number of bytes in mem */
+} dc_xxh32_state_t;
+
+/**
+ * @description
+ *     Initialise a streaming xxhash32 state
+ *
+ * @param[out] pState           State to initialise.
+ * @param[in] seed              Seed of the hash.
+ */
+void dcXxh32Init(dc_xxh32_state_t *pState, Cpa32U seed);
+
+/**
+ * @description
+ *     Add data to a streaming xxhash32 state
+ *
+ * @param[in,out] pState        State of the hash.
+ * @param[in] pData             Data to hash.
+ * @param[in] len               Length in bytes of the data.
+ */
+void dcXxh32Update(dc_xxh32_state_t *pState, const Cpa8U *pData, Cpa32U len);
+
+/**
+ * @description
+ *     Return the xxhash32 of the data added to a state
+ *
+ * @param[in] pState            State of the hash.
+ */
+Cpa32U dcXxh32Digest(const dc_xxh32_state_t *pState);
+
 #endif /* end of DC_HEADER_CKSUM_LZ4_H */
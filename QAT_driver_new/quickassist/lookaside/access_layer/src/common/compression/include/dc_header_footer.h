@@ -62,6 +62,10 @@
 #define DC_ZLIB_FLEVEL_OFFSET (6)
 #define DC_ZLIB_HEADER_OFFSET (31)
 
+/* FDICT flag of the Zlib FLG byte and size of the DICTID that follows */
+#define DC_ZLIB_FDICT (0x20)
+#define DC_ZLIB_DICTID_SIZE (4)
+
 /* Compression level for Zlib */
 #define DC_ZLIB_LEVEL_0 (0)
 #define DC_ZLIB_LEVEL_1 (1)
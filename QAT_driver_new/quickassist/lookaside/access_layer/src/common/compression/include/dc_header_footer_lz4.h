@@ -55,6 +55,9 @@
 #define DC_LZ4_HEADER_SIZE 7
 #define DC_LZ4_FOOTER_SIZE 8
 
+/* Size of the optional dictionary id of the LZ4 frame descriptor */
+#define DC_LZ4_DICT_ID_SIZE 4
+
 /* Values used to build the headers for LZ4 */
 #define DC_LZ4_FH_ID 0x184D2204U
 #define DC_LZ4_FH_FLG_VERSION 0x1
@@ -93,6 +96,60 @@ CpaStatus dc_lz4_generate_header(const CpaFlatBuffer *dest_buff,
                                  const CpaBoolean block_indep,
                                  Cpa32U *count);
 
+/**
+ *****************************************************************************
+ * @ingroup dc_lz4_generate_header_no_cksum
+ *      Generate the LZ4 Header of a frame without content checksum.
+ *
+ * @description
+ *      This function generates the LZ4 compression header with the
+ *      content checksum flag cleared, for frames whose content checksum is
+ *      not available, such as frames built from LZ4s data.
+ *
+ * @param[in]       dest_buff        Pointer to the destination buffer the
+ *                                   LZ4 header will be written to.
+ * @param[in]       max_block_size   LZ4 Maximum block size.
+ * @param[in]       block_indep      LZ4 block independence value.
+ * @param[in,out]   count            Pointer to counter that stores
+ *                                   amount of generated bytes.
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully.
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in.
+ *****************************************************************************/
+CpaStatus dc_lz4_generate_header_no_cksum(
+    const CpaFlatBuffer *dest_buff,
+    const CpaDcCompLZ4BlockMaxSize max_block_size,
+    const CpaBoolean block_indep,
+    Cpa32U *count);
+
+/**
+ *****************************************************************************
+ * @ingroup dc_lz4_generate_header_dict
+ *      Generate the LZ4 Header of a frame using a dictionary.
+ *
+ * @description
+ *      This function generates the LZ4 compression header with the
+ *      dictionary id flag set and the dictionary id in the frame
+ *      descriptor.
+ *
+ * @param[in]       dest_buff        Pointer to the destination buffer the
+ *                                   LZ4 header will be written to.
+ * @param[in]       max_block_size   LZ4 Maximum block size.
+ * @param[in]       block_indep      LZ4 block independence value.
+ * @param[in]       dict_id          Dictionary id.
+ * @param[in,out]   count            Pointer to counter that stores
+ *                                   amount of generated bytes.
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully.
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in.
+ *****************************************************************************/
+CpaStatus dc_lz4_generate_header_dict(
+    const CpaFlatBuffer *dest_buff,
+    const CpaDcCompLZ4BlockMaxSize max_block_size,
+    const CpaBoolean block_indep,
+    const Cpa32U dict_id,
+    Cpa32U *count);
+
 /**
  *****************************************************************************
  * @ingroup dc_lz4_generate_footer
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_inline.h
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Definition of the inline processing of small stateless requests.
+ *      Requests below the inline threshold of their session are compressed
+ *      into a fixed Huffman or stored deflate block, or decompressed, on
+ *      the calling CPU and completed without a device round trip.
+ *
+ *****************************************************************************/
+#ifndef DC_INLINE_H_
+#define DC_INLINE_H_
+
+#include "cpa_types.h"
+#include "dc_session.h"
+
+/* Largest inline threshold of a session */
+#define DC_INLINE_MAX_THRESHOLD (1024)
+
+/* Largest output of a request decompressed inline */
+#define DC_INLINE_MAX_OUTPUT (4096)
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Set the inline threshold of a session
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       threshold        Requests with fewer source bytes are
+ *                                   processed inline, zero disables the
+ *                                   inline path
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported session
+ *****************************************************************************/
+CpaStatus dcSetInlineThreshold(CpaInstanceHandle dcInstance,
+                               CpaDcSessionHandle pSessionHandle,
+                               Cpa32U threshold);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Process a small request inline
+ *
+ * @description
+ *      Fills in the destination and the results of the request, including
+ *      the checksum, as the device would. Requests which can not be
+ *      completed on the CPU are left untouched for the device: sources at
+ *      or above the threshold, integrity CRC requests, destinations too
+ *      small and compressed data which is invalid, truncated or expands
+ *      beyond DC_INLINE_MAX_OUTPUT bytes.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pSrcBuff         Source buffer list
+ * @param[out]      pDestBuff        Destination buffer list
+ * @param[in,out]   pResults         Results of the request
+ * @param[in]       flushFlag        Flush flag of the request
+ * @param[in]       pOpData          Request options, may be NULL
+ * @param[in]       compDecomp       Direction of the request
+ *
+ * @retval CPA_TRUE                  The request has been completed
+ * @retval CPA_FALSE                 The request must be offloaded
+ *****************************************************************************/
+CpaBoolean dcInlineProcess(dc_session_desc_t *pSessionDesc,
+                           CpaBufferList *pSrcBuff,
+                           CpaBufferList *pDestBuff,
+                           CpaDcRqResults *pResults,
+                           CpaDcFlush flushFlag,
+                           const CpaDcOpData *pOpData,
+                           dc_request_dir_t compDecomp);
+
+#endif /* DC_INLINE_H_ */
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_precheck.h
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Definition of the compressibility pre-check of stateless compression
+ *      sessions. The byte entropy of a few samples of the source is
+ *      estimated before a request is offloaded; requests above the
+ *      threshold of the session are encoded as deflate stored blocks in
+ *      software and completed inline, saving the device time and the PCIe
+ *      bandwidth spent on data which does not compress.
+ *
+ *****************************************************************************/
+#ifndef DC_PRECHECK_H_
+#define DC_PRECHECK_H_
+
+#include "cpa_types.h"
+#include "dc_session.h"
+#include "dc_datapath.h"
+
+/* Requests smaller than this are always offloaded */
+#define DC_PRECHECK_MIN_SIZE (4 * 1024)
+
+/* Number and size of the samples the entropy is estimated on */
+#define DC_PRECHECK_NUM_SAMPLES (8)
+#define DC_PRECHECK_SAMPLE_SIZE (512)
+
+/* Threshold used when the pre-check is enabled with a zero threshold, in
+ * thousandths of a bit per byte */
+#define DC_PRECHECK_DEFAULT_THRESHOLD (7800)
+
+/* Largest threshold, the entropy of uniformly distributed bytes */
+#define DC_PRECHECK_MAX_THRESHOLD (8000)
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Configure the compressibility pre-check of a session
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       enable           CPA_TRUE to enable the pre-check
+ * @param[in]       threshold        Entropy threshold in thousandths of a
+ *                                   bit per byte, zero selects
+ *                                   DC_PRECHECK_DEFAULT_THRESHOLD
+ * @param[in]       auditInterval    One request in auditInterval estimated
+ *                                   incompressible is offloaded anyway,
+ *                                   zero disables audits
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported session
+ *****************************************************************************/
+CpaStatus dcSetPrecheck(CpaInstanceHandle dcInstance,
+                        CpaDcSessionHandle pSessionHandle,
+                        CpaBoolean enable,
+                        Cpa32U threshold,
+                        Cpa32U auditInterval);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Get the compressibility pre-check counters of a session
+ *
+ * @param[in]       dcInstance           Instance Handle
+ * @param[in]       pSessionHandle       Pointer to a session handle
+ * @param[out]      pChecked             Requests estimated
+ * @param[out]      pStored              Requests stored in software
+ * @param[out]      pAudited             Requests audited on the device
+ * @param[out]      pAuditCompressible   Audited requests the device
+ *                                       compressed
+ * @param[out]      pMissed              Requests estimated compressible
+ *                                       the device did not compress
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ *****************************************************************************/
+CpaStatus dcGetPrecheckStats(CpaInstanceHandle dcInstance,
+                             CpaDcSessionHandle pSessionHandle,
+                             Cpa64U *pChecked,
+                             Cpa64U *pStored,
+                             Cpa64U *pAudited,
+                             Cpa64U *pAuditCompressible,
+                             Cpa64U *pMissed);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Estimate the compressibility of a request
+ *
+ * @description
+ *      Called for the compression requests of sessions with the pre-check
+ *      enabled. DC_PRECHECK_INCOMPRESSIBLE is only returned when the
+ *      destination can hold the stored blocks.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pSrcBuff         Source buffer list
+ * @param[in]       pDestBuff        Destination buffer list
+ * @param[in]       pOpData          Request options, may be NULL
+ *
+ * @retval The pre-check outcome of the request
+ *****************************************************************************/
+dc_precheck_result_t dcPrecheckApply(dc_session_desc_t *pSessionDesc,
+                                     const CpaBufferList *pSrcBuff,
+                                     const CpaBufferList *pDestBuff,
+                                     const CpaDcOpData *pOpData);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Store a request in software
+ *
+ * @description
+ *      Copies the source into deflate stored blocks in the destination and
+ *      fills in the results, including the checksum, as the device would.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pSrcBuff         Source buffer list
+ * @param[out]      pDestBuff        Destination buffer list
+ * @param[in,out]   pResults         Results of the request
+ * @param[in]       flushFlag        Flush flag of the request
+ *****************************************************************************/
+void dcPrecheckStore(dc_session_desc_t *pSessionDesc,
+                     CpaBufferList *pSrcBuff,
+                     CpaBufferList *pDestBuff,
+                     CpaDcRqResults *pResults,
+                     CpaDcFlush flushFlag);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Account the completion of a pre-checked request
+ *
+ * @description
+ *      Compares the outcome of an offloaded request with its estimate.
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       precheck         Pre-check outcome of the request
+ * @param[in]       pResults         Results of the request
+ *****************************************************************************/
+void dcPrecheckComplete(dc_session_desc_t *pSessionDesc,
+                        dc_precheck_result_t precheck,
+                        const CpaDcRqResults *pResults);
+
+#endif /* DC_PRECHECK_H_ */
@@ -125,6 +125,29 @@ typedef enum dc_request_dir_e
     DC_DECOMPRESSION_REQUEST
 } dc_request_dir_t;
 
+/* Maximum number of outstanding requests on a pipelined stateful session */
+#define DC_STATEFUL_PIPELINE_MAX_DEPTH (8)
+
+/* Number of compression ratio buckets of the destination sizing histogram,
+ * bucket b counts the requests which produced at most (b + 1) / 32 of
+ * their input. The last bucket also counts the requests which expanded
+ * further */
+#define DC_SIZING_NUM_BUCKETS (64)
+
+/* Stateful request waiting for the previous request of its session */
+typedef struct dc_stateful_pending_req_s
+{
+    CpaInstanceHandle dcInstance;
+    CpaDcSessionHandle pSessionHandle;
+    CpaBufferList *pSrcBuff;
+    CpaBufferList *pDestBuff;
+    CpaDcRqResults *pResults;
+    CpaDcOpData *pOpData;
+    void *callbackTag;
+    CpaDcFlush flushFlag;
+    dc_request_dir_t compDecomp;
+} dc_stateful_pending_req_t;
+
 /* Type of the compression request */
 typedef enum dc_request_type_e
 {
@@ -237,6 +260,19 @@ typedef struct dc_crc_config_s
     /**< Lookup table to speed up crc calculation at runtime */
 } dc_crc_config_t;
 
+/* Compress and verify policy of a session, applies to the stateless
+ * compression requests asking for CnV. The values match
+ * icp_sal_dc_cnv_policy_t */
+typedef enum dc_cnv_policy_e
+{
+    DC_CNV_POLICY_DEVICE = 0,
+    /**< Every request is verified by the device */
+    DC_CNV_POLICY_SAMPLED,
+    /**< One request in cnvSampleInterval is verified by the device */
+    DC_CNV_POLICY_SW_ASYNC
+    /**< The requests are verified in software by a worker pool */
+} dc_cnv_policy_t;
+
 /* Session descriptor structure for compression */
 typedef struct dc_session_desc_s
 {
@@ -315,6 +351,65 @@ typedef struct dc_session_desc_s
      * depends on the previous ones and must be decompressed sequentially */
     dc_crc_config_t crcConfig;
     /**< Configuration data for crc operation */
+    Cpa32U statefulPipelineDepth;
+    /**< Maximum number of outstanding requests on a stateful session. Only
+     * one of them is on the device, the others wait in pipelineQueue and are
+     * submitted from the completion of the previous request. 0 and 1 keep
+     * the single in-flight request behaviour */
+    Cpa32U pipelineHead;
+    /**< Index of the oldest request in pipelineQueue */
+    Cpa32U pipelineCount;
+    /**< Number of requests in pipelineQueue, protected by sessionLock */
+    dc_stateful_pending_req_t pipelineQueue[DC_STATEFUL_PIPELINE_MAX_DEPTH];
+    /**< Stateful requests waiting for the in-flight request */
+    dc_cnv_policy_t cnvPolicy;
+    /**< How the stateless compression requests asking for CnV are
+     * verified */
+    Cpa32U cnvSampleInterval;
+    /**< With DC_CNV_POLICY_SAMPLED, one request in cnvSampleInterval is
+     * verified by the device */
+    OsalAtomic cnvSampleCount;
+    /**< Number of requests seen by the sampled policy */
+    OsalAtomic cnvDeviceVerified;
+    /**< Number of requests sent with device CnV */
+    OsalAtomic cnvNotVerified;
+    /**< Number of requests the policy left unverified */
+    OsalAtomic cnvSwVerified;
+    /**< Number of requests verified in software */
+    OsalAtomic cnvSwErrors;
+    /**< Number of requests which failed the software verification */
+    struct dc_dict_s *pDict;
+    /**< Preset dictionary of a stateless session, NULL if none */
+    Cpa32U precheckThreshold;
+    /**< Sampled entropy, in thousandths of a bit per byte, from which the
+     * stateless compression requests are stored in software instead of
+     * being offloaded. Zero disables the compressibility pre-check */
+    Cpa32U precheckAuditInterval;
+    /**< One request in precheckAuditInterval estimated incompressible is
+     * offloaded anyway to measure the estimator, zero disables audits */
+    OsalAtomic precheckAuditCount;
+    /**< Number of requests estimated incompressible */
+    OsalAtomic precheckChecked;
+    /**< Number of requests whose compressibility was estimated */
+    OsalAtomic precheckStored;
+    /**< Number of requests stored in software */
+    OsalAtomic precheckAudited;
+    /**< Number of requests estimated incompressible and offloaded */
+    OsalAtomic precheckAuditCompressible;
+    /**< Number of audited requests the device compressed */
+    OsalAtomic precheckMissed;
+    /**< Number of requests estimated compressible the device could not
+     * compress */
+    CpaBoolean sizingEnabled;
+    /**< Record the compression ratio of the stateless compression requests
+     * to suggest destination buffer sizes */
+    OsalAtomic sizingHist[DC_SIZING_NUM_BUCKETS];
+    /**< Number of completed requests per compression ratio bucket */
+    OsalAtomic sizingOverflows;
+    /**< Number of requests which overflowed their destination buffer */
+    Cpa32U inlineThreshold;
+    /**< Stateless requests with fewer source bytes are processed on the
+     * CPU without a device round trip. Zero disables the inline path */
 } dc_session_desc_t;
 
 /**
@@ -421,6 +516,86 @@ CpaStatus dcGetSessionSize(CpaInstanceHandle dcInstance,
 CpaStatus dcSetCnvError(CpaInstanceHandle dcInstance,
                         CpaDcSessionHandle pSessionHandle);
 
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Set the stateful pipeline depth of a session
+ *
+ * @description
+ *      Allows up to depth requests to be outstanding on an asynchronous
+ *      stateful session. The device still processes the requests of the
+ *      session one at a time; the requests submitted while one is in flight
+ *      are queued in the session and sent from the completion of the
+ *      previous request. If a request does not complete with CPA_DC_OK, the
+ *      queued requests are not sent and complete with CPA_STATUS_RETRY.
+ *      The setting is kept across cpaDcResetSession.
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       depth            Maximum number of outstanding requests,
+ *                                   0 or 1 disables pipelining
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ *****************************************************************************/
+CpaStatus dcSetStatefulPipelineDepth(CpaInstanceHandle dcInstance,
+                                     CpaDcSessionHandle pSessionHandle,
+                                     Cpa32U depth);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Set the compress and verify policy of a session
+ *
+ * @description
+ *      Selects how the stateless compression requests of the session which
+ *      ask for CnV are verified: by the device, by the device for one
+ *      request in sampleInterval only, or by a pool of CPU worker threads
+ *      once the request has completed without device verification. The
+ *      policy is kept across cpaDcResetSession. Requests of a session with
+ *      CnV error injection enabled or using integrityCrcCheck are always
+ *      verified by the device.
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       policy           CnV policy
+ * @param[in]       sampleInterval   Sampling interval for
+ *                                   DC_CNV_POLICY_SAMPLED, ignored otherwise
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_RETRY          Requests are pending on the session
+ * @retval CPA_STATUS_RESOURCE       The software verify pool cannot start
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ * @retval CPA_STATUS_UNSUPPORTED    Unsupported policy for this session
+ *****************************************************************************/
+CpaStatus dcSetCnvPolicy(CpaInstanceHandle dcInstance,
+                         CpaDcSessionHandle pSessionHandle,
+                         dc_cnv_policy_t policy,
+                         Cpa32U sampleInterval);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Get the compress and verify policy counters of a session
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[out]      pDeviceVerified  Requests sent with device CnV
+ * @param[out]      pNotVerified     Requests the policy left unverified
+ * @param[out]      pSwVerified      Requests verified in software
+ * @param[out]      pSwErrors        Requests failing software verification
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ *****************************************************************************/
+CpaStatus dcGetCnvPolicyStats(CpaInstanceHandle dcInstance,
+                              CpaDcSessionHandle pSessionHandle,
+                              Cpa64U *pDeviceVerified,
+                              Cpa64U *pNotVerified,
+                              Cpa64U *pSwVerified,
+                              Cpa64U *pSwErrors);
+
 #ifdef ICP_PARAM_CHECK
 /**
  *****************************************************************************
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dc_sizing.h
+ *
+ * @ingroup Dc_DataCompression
+ *
+ * @description
+ *      Definition of the destination buffer sizing feedback of stateless
+ *      compression sessions. The compression ratio of the completed
+ *      requests is recorded in a histogram from which the destination size
+ *      meeting a given overflow probability is derived, so that callers do
+ *      not have to reserve the worst case compress bound for every request.
+ *
+ *****************************************************************************/
+#ifndef DC_SIZING_H_
+#define DC_SIZING_H_
+
+#include "cpa_types.h"
+#include "dc_session.h"
+
+/* Fixed point shift of the compression ratio buckets */
+#define DC_SIZING_RATIO_SHIFT (5)
+
+/* Number of completed requests below which the compress bound is
+ * suggested */
+#define DC_SIZING_MIN_SAMPLES (64)
+
+/* Bytes added to the suggested size for the block headers and the end of
+ * block symbol of short requests */
+#define DC_SIZING_SLACK (64)
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Enable or disable the destination sizing feedback of a session
+ *
+ * @description
+ *      Enabling the feedback clears the recorded compression ratios.
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       enable           CPA_TRUE to record compression ratios
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ *****************************************************************************/
+CpaStatus dcSetDestSizing(CpaInstanceHandle dcInstance,
+                          CpaDcSessionHandle pSessionHandle,
+                          CpaBoolean enable);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Suggest a destination buffer size
+ *
+ * @description
+ *      Returns the smallest destination size which the recorded requests
+ *      of the session would have overflowed with a probability of at most
+ *      overflowPpm parts per million. The compress bound is returned until
+ *      DC_SIZING_MIN_SAMPLES requests have completed.
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[in]       srcLen           Size of the source of the request
+ * @param[in]       overflowPpm      Accepted overflow probability in parts
+ *                                   per million
+ * @param[out]      pDestLen         Suggested destination size
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ *****************************************************************************/
+CpaStatus dcGetDestSizeHint(CpaInstanceHandle dcInstance,
+                            CpaDcSessionHandle pSessionHandle,
+                            Cpa32U srcLen,
+                            Cpa32U overflowPpm,
+                            Cpa32U *pDestLen);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Get the destination sizing counters of a session
+ *
+ * @param[in]       dcInstance       Instance Handle
+ * @param[in]       pSessionHandle   Pointer to a session handle
+ * @param[out]      pSamples         Requests whose ratio was recorded
+ * @param[out]      pOverflows       Requests which overflowed
+ *
+ * @retval CPA_STATUS_SUCCESS        Function executed successfully
+ * @retval CPA_STATUS_INVALID_PARAM  Invalid parameter passed in
+ *****************************************************************************/
+CpaStatus dcGetDestSizingStats(CpaInstanceHandle dcInstance,
+                               CpaDcSessionHandle pSessionHandle,
+                               Cpa64U *pSamples,
+                               Cpa64U *pOverflows);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Record the outcome of a stateless compression request
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ * @param[in]       pResults         Results of the request
+ *****************************************************************************/
+void dcSizingRecord(dc_session_desc_t *pSessionDesc,
+                    const CpaDcRqResults *pResults);
+
+/**
+ *****************************************************************************
+ * @ingroup Dc_DataCompression
+ *      Average compression ratio of a session
+ *
+ * @param[in]       pSessionDesc     Pointer to the session descriptor
+ *
+ * @retval Average output size in percent of the input size, zero until
+ *         DC_SIZING_MIN_SAMPLES requests have been recorded
+ *****************************************************************************/
+Cpa32U dcSizingRatioPercent(dc_session_desc_t *pSessionDesc);
+
+#endif /* DC_SIZING_H_ */
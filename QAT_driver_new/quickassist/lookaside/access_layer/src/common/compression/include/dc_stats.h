@@ -51,45 +51,39 @@
 /* Number of Compression statistics */
 #define COMPRESSION_NUM_STATS (sizeof(CpaDcStats) / sizeof(Cpa64U))
 
-#ifndef DISABLE_STATS
-/* Macro to increment a Compression stat (derives offset into array of
- * atomics) */
+/* The Compression stats are compiled out with all the stats, or on their
+ * own with DISABLE_DC_STATS */
+#if defined(DISABLE_STATS) && !defined(DISABLE_DC_STATS)
+#define DISABLE_DC_STATS
+#endif
+
+#ifndef DISABLE_DC_STATS
+/* Macro to increment a Compression stat in the shard of the calling thread
+ * (derives offset into array of atomics) */
 #define COMPRESSION_STAT_INC(statistic, pService)                              \
     do                                                                         \
     {                                                                          \
         if (CPA_TRUE == pService->generic_service_info.stats->bDcStatsEnabled) \
         {                                                                      \
-            osalAtomicInc(                                                     \
-                &pService->pCompStatsArr[offsetof(CpaDcStats, statistic) /     \
-                                         sizeof(Cpa64U)]);                     \
+            SAL_STATS_SHARDED_INC(pService->pCompStatsArr,                     \
+                                  COMPRESSION_NUM_STATS,                       \
+                                  offsetof(CpaDcStats, statistic) /            \
+                                      sizeof(Cpa64U));                         \
         }                                                                      \
     } while (0)
 #else
 #define COMPRESSION_STAT_INC(statistic, pService)
 #endif
 
-/* Macro to get all Compression stats (from internal array of atomics) */
+/* Macro to get all Compression stats (sums the shards of the internal
+ * array of atomics) */
 #define COMPRESSION_STATS_GET(compStats, pService)                             \
-    do                                                                         \
-    {                                                                          \
-        int i;                                                                 \
-        for (i = 0; i < COMPRESSION_NUM_STATS; i++)                            \
-        {                                                                      \
-            ((Cpa64U *)compStats)[i] =                                         \
-                osalAtomicGet(&pService->pCompStatsArr[i]);                    \
-        }                                                                      \
-    } while (0)
+    SalStatistics_ShardedGet(                                                  \
+        pService->pCompStatsArr, COMPRESSION_NUM_STATS, (Cpa64U *)compStats)
 
 /* Macro to reset all Compression stats */
 #define COMPRESSION_STATS_RESET(pService)                                      \
-    do                                                                         \
-    {                                                                          \
-        int i;                                                                 \
-        for (i = 0; i < COMPRESSION_NUM_STATS; i++)                            \
-        {                                                                      \
-            osalAtomicSet(0, &pService->pCompStatsArr[i]);                     \
-        }                                                                      \
-    } while (0)
+    SalStatistics_ShardedReset(pService->pCompStatsArr, COMPRESSION_NUM_STATS)
 
 /**
 *******************************************************************************
@@ -120,7 +120,11 @@
 * @retval None
 *
 *****************************************************************************/
-#ifndef DISABLE_STATS
+#if defined(DISABLE_STATS) && !defined(DISABLE_SYM_STATS)
+#define DISABLE_SYM_STATS
+#endif
+
+#ifndef DISABLE_SYM_STATS
 #define LAC_SYM_STAT_INC(statistic, instanceHandle)                            \
     LacSym_StatsInc(offsetof(CpaCySymStats64, statistic), instanceHandle)
 #else
@@ -162,7 +162,7 @@ STATIC void LacSymCb_ProcessCallbackInternal(lac_sym_bulk_cookie_t *pCookie,
     CpaCySymOp operationType = CPA_CY_SYM_OP_NONE;
     CpaStatus dequeueStatus = CPA_STATUS_SUCCESS;
 
-#ifndef DISABLE_STATS
+#ifndef DISABLE_SYM_STATS
     CpaInstanceHandle instanceHandle = CPA_INSTANCE_HANDLE_SINGLE;
     /* NOTE: cookie pointer validated in previous function */
     instanceHandle = pCookie->instanceHandle;
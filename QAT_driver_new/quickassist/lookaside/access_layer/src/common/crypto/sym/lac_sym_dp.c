@@ -1093,6 +1093,7 @@ CpaStatus cpaCySymDpEnqueueOp(CpaCySymDpOpData *pRequest,
 {
     icp_qat_fw_la_bulk_req_t *pCurrentQatMsg = NULL;
     icp_comms_trans_handle trans_handle = NULL;
+    sal_crypto_service_t *pService = NULL;
     lac_session_desc_t *pSessionDesc = NULL;
     write_ringMsgFunc_t callFunc;
     CpaStatus status = CPA_STATUS_SUCCESS;
@@ -1112,8 +1113,8 @@ CpaStatus cpaCySymDpEnqueueOp(CpaCySymDpOpData *pRequest,
     }
 #endif
 
-    trans_handle =
-        ((sal_crypto_service_t *)pRequest->instanceHandle)->trans_handle_sym_tx;
+    pService = (sal_crypto_service_t *)pRequest->instanceHandle;
+    trans_handle = pService->trans_handle_sym_tx;
 
     pSessionDesc = LAC_SYM_SESSION_DESC_FROM_CTX_GET(pRequest->sessionCtx);
 
@@ -1134,14 +1135,21 @@ CpaStatus cpaCySymDpEnqueueOp(CpaCySymDpOpData *pRequest,
 
     pSessionDesc->u.pendingDpCbCount++;
 
-    if (CPA_TRUE == performOpNow)
+    if (CPA_TRUE == SalDpFlush_Queued(&pService->symDpFlush, 1, performOpNow))
     {
         status = SalQatMsg_updateQueueTail(trans_handle);
-        if (CPA_STATUS_RETRY == status)
+        if (CPA_STATUS_SUCCESS == status)
         {
-            pSessionDesc->u.pendingDpCbCount--;
+            SalDpFlush_Done(&pService->symDpFlush);
+        }
+        if (CPA_TRUE == performOpNow)
+        {
+            if (CPA_STATUS_RETRY == status)
+            {
+                pSessionDesc->u.pendingDpCbCount--;
+            }
+            return status;
         }
-        return status;
     }
 
     return CPA_STATUS_SUCCESS;
@@ -1150,6 +1158,7 @@ CpaStatus cpaCySymDpEnqueueOp(CpaCySymDpOpData *pRequest,
 CpaStatus cpaCySymDpPerformOpNow(const CpaInstanceHandle instanceHandle)
 {
     icp_comms_trans_handle trans_handle = NULL;
+    sal_crypto_service_t *pService = NULL;
 
 #ifdef ICP_TRACE
     LAC_LOG1("Called with param (0x%lx)\n", (LAC_ARCH_UINT)instanceHandle);
@@ -1165,12 +1174,16 @@ CpaStatus cpaCySymDpPerformOpNow(const CpaInstanceHandle instanceHandle)
     /* Check if SAL is initialised otherwise return an error */
     SAL_RUNNING_CHECK(instanceHandle);
 
-    trans_handle =
-        ((sal_crypto_service_t *)instanceHandle)->trans_handle_sym_tx;
+    pService = (sal_crypto_service_t *)instanceHandle;
+    trans_handle = pService->trans_handle_sym_tx;
 
     if (CPA_TRUE == icp_adf_queueDataToSend(trans_handle))
     {
-        SalQatMsg_updateQueueTail(trans_handle);
+        SalDpFlush_Explicit(&pService->symDpFlush);
+        if (CPA_STATUS_SUCCESS == SalQatMsg_updateQueueTail(trans_handle))
+        {
+            SalDpFlush_Done(&pService->symDpFlush);
+        }
     }
 
     return CPA_STATUS_SUCCESS;
@@ -1184,13 +1197,10 @@ CpaStatus cpaCySymDpEnqueueOpBatch(const Cpa32U numberRequests,
     icp_comms_trans_handle trans_handle = NULL;
     lac_session_desc_t *pSessionDesc = NULL;
     write_ringMsgFunc_t callFunc;
+    sal_crypto_service_t *pService = NULL;
     Cpa32U i = 0;
     CpaStatus status = CPA_STATUS_SUCCESS;
 
-#ifdef ICP_PARAM_CHECK
-    sal_crypto_service_t *pService = NULL;
-#endif
-
 #ifdef ICP_TRACE
     LAC_LOG3("Called with params (%d, 0x%lx, %d)\n",
              numberRequests,
@@ -1255,14 +1265,23 @@ CpaStatus cpaCySymDpEnqueueOpBatch(const Cpa32U numberRequests,
         pSessionDesc->u.pendingDpCbCount++;
     }
 
-    if (CPA_TRUE == performOpNow)
+    pService = (sal_crypto_service_t *)pRequests[0]->instanceHandle;
+    if (CPA_TRUE ==
+        SalDpFlush_Queued(&pService->symDpFlush, numberRequests, performOpNow))
     {
         status = SalQatMsg_updateQueueTail(trans_handle);
-        if (CPA_STATUS_RETRY == status)
+        if (CPA_STATUS_SUCCESS == status)
         {
-            pSessionDesc->u.pendingDpCbCount -= numberRequests;
+            SalDpFlush_Done(&pService->symDpFlush);
+        }
+        if (CPA_TRUE == performOpNow)
+        {
+            if (CPA_STATUS_RETRY == status)
+            {
+                pSessionDesc->u.pendingDpCbCount -= numberRequests;
+            }
+            return status;
         }
-        return status;
     }
 
     return CPA_STATUS_SUCCESS;
@@ -1272,6 +1291,7 @@ CpaStatus icp_sal_CyPollDpInstance(const CpaInstanceHandle instanceHandle,
                                    const Cpa32U responseQuota)
 {
     icp_comms_trans_handle trans_handle = NULL;
+    sal_crypto_service_t *pService = NULL;
 
 #ifdef ICP_PARAM_CHECK
     LAC_CHECK_INSTANCE_HANDLE(instanceHandle);
@@ -1283,8 +1303,11 @@ CpaStatus icp_sal_CyPollDpInstance(const CpaInstanceHandle instanceHandle,
     /* Check if SAL is initialised otherwise return an error */
     SAL_RUNNING_CHECK(instanceHandle);
 
-    trans_handle =
-        ((sal_crypto_service_t *)instanceHandle)->trans_handle_sym_rx;
+    pService = (sal_crypto_service_t *)instanceHandle;
+    SalDpFlush_FlushExpired(&pService->symDpFlush,
+                            pService->trans_handle_sym_tx);
+
+    trans_handle = pService->trans_handle_sym_rx;
 
     return icp_adf_pollQueue(trans_handle, responseQuota);
 }
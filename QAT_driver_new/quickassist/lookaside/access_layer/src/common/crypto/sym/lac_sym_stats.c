@@ -71,36 +71,24 @@
 
 CpaStatus LacSym_StatsInit(CpaInstanceHandle instanceHandle)
 {
-    CpaStatus status = CPA_STATUS_SUCCESS;
     sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
 
-    status = LAC_OS_MALLOC(&(pService->pLacSymStatsArr),
-                           LAC_SYM_NUM_STATS * sizeof(OsalAtomic));
-
-    if (CPA_STATUS_SUCCESS == status)
-    {
-        LAC_OS_BZERO(
-            (void *)LAC_CONST_VOLATILE_PTR_CAST(pService->pLacSymStatsArr),
-            LAC_SYM_NUM_STATS * sizeof(OsalAtomic));
-    }
-    return status;
+    return SalStatistics_ShardedAlloc(&(pService->pLacSymStatsArr),
+                                      LAC_SYM_NUM_STATS);
 }
 
 void LacSym_StatsFree(CpaInstanceHandle instanceHandle)
 {
     sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
-    if (NULL != pService->pLacSymStatsArr)
-    {
-        LAC_OS_FREE(pService->pLacSymStatsArr);
-    }
+
+    SalStatistics_ShardedFree(&(pService->pLacSymStatsArr));
 }
 
 void LacSym_StatsReset(CpaInstanceHandle instanceHandle)
 {
     sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
 
-    LAC_OS_BZERO((void *)LAC_CONST_VOLATILE_PTR_CAST(pService->pLacSymStatsArr),
-                 LAC_SYM_NUM_STATS * sizeof(OsalAtomic));
+    SalStatistics_ShardedReset(pService->pLacSymStatsArr, LAC_SYM_NUM_STATS);
 }
 
 void LacSym_StatsInc(Cpa32U offset, CpaInstanceHandle instanceHandle)
@@ -108,7 +96,10 @@ void LacSym_StatsInc(Cpa32U offset, CpaInstanceHandle instanceHandle)
     sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
     if (CPA_TRUE == pService->generic_service_info.stats->bSymStatsEnabled)
     {
-        osalAtomicInc(&pService->pLacSymStatsArr[offset / sizeof(Cpa64U)]);
+        /* Only the shard of the calling thread is written */
+        SAL_STATS_SHARDED_INC(pService->pLacSymStatsArr,
+                              LAC_SYM_NUM_STATS,
+                              offset / sizeof(Cpa64U));
     }
 }
 
@@ -116,29 +107,28 @@ void LacSym_Stats32CopyGet(CpaInstanceHandle instanceHandle,
                            struct _CpaCySymStats *const pSymStats)
 {
     int i = 0;
+    Cpa64U stats[LAC_SYM_NUM_STATS];
     sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
     LAC_ENSURE(NULL != instanceHandle, "invalid handle\n");
     LAC_ENSURE_NOT_NULL(pSymStats);
 
+    SalStatistics_ShardedGet(
+        pService->pLacSymStatsArr, LAC_SYM_NUM_STATS, stats);
     for (i = 0; i < LAC_SYM_NUM_STATS; i++)
     {
-        ((Cpa32U *)pSymStats)[i] =
-            (Cpa32U)osalAtomicGet(&pService->pLacSymStatsArr[i]);
+        ((Cpa32U *)pSymStats)[i] = (Cpa32U)stats[i];
     }
 }
 
 void LacSym_Stats64CopyGet(CpaInstanceHandle instanceHandle,
                            CpaCySymStats64 *const pSymStats)
 {
-    int i = 0;
     sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
     LAC_ENSURE(NULL != instanceHandle, "invalid handle\n");
     LAC_ENSURE_NOT_NULL(pSymStats);
 
-    for (i = 0; i < LAC_SYM_NUM_STATS; i++)
-    {
-        ((Cpa64U *)pSymStats)[i] = osalAtomicGet(&pService->pLacSymStatsArr[i]);
-    }
+    SalStatistics_ShardedGet(
+        pService->pLacSymStatsArr, LAC_SYM_NUM_STATS, (Cpa64U *)pSymStats);
 }
 
 void LacSym_StatsShow(CpaInstanceHandle instanceHandle)
@@ -823,6 +823,9 @@ CpaStatus SalCtrl_CompressionInit(icp_accel_dev_t *device,
     pCompressionService->compression_mem_pool = LAC_MEM_POOL_INIT_POOL_ID;
     pCompressionService->trans_handle_compression_tx = NULL;
     pCompressionService->trans_handle_compression_rx = NULL;
+    pCompressionService->ppDcDpCqEntries = NULL;
+    pCompressionService->dcDpCqCount = 0;
+    SalDpFlush_Init(&pCompressionService->dcDpFlush);
     pCompressionService->debug_file = NULL;
 
 
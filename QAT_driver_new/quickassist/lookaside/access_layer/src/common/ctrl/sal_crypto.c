@@ -1806,6 +1806,8 @@ STATIC CpaStatus SalCtrl_SymInit(icp_accel_dev_t *device,
      * (Hash, Cipher, Algorithm-Chaining) (returns void)*/
     LacSymCb_CallbacksRegister();
 
+    SalDpFlush_Init(&pCryptoService->symDpFlush);
+
     qatHmacMode = (Cpa32U)Sal_Strtoul(adfGetParam, NULL, SAL_CFG_BASE_DEC);
     switch (qatHmacMode)
     {
@@ -108,6 +108,26 @@ typedef struct
     volatile pointer_t top;
 } lock_free_stack_t;
 
+#define LAC_MEM_POOL_NUM_SHARDS 16
+/**< @ingroup LacMemPool
+ * Number of shards of the free blocks of a pool, a power of 2 */
+
+/**< @ingroup LacMemPool
+ *     This structure holds the free blocks of a pool used by a group of
+ * threads. Each shard fills a cache line of its own so threads allocating
+ * and freeing blocks in different shards do not contend.
+ */
+typedef union lac_mem_pool_shard_u {
+    struct
+    {
+        lock_free_stack_t stack;
+        /**< free blocks of the shard */
+        volatile long availBlks;
+        /**< blocks freed to the shard minus blocks allocated from it */
+    };
+    Cpa8U pad[LAC_64BYTE_ALIGNMENT];
+} lac_mem_pool_shard_t;
+
 typedef LAC_ARCH_UINT lac_memory_pool_id_t;
 /**< @ingroup LacMemPool
  *   Pool ID type to be used by all clients */
@@ -154,7 +174,9 @@ typedef struct lac_memblk_bucket_s
  */
 typedef struct lac_mem_pool_hdr_s
 {
-    lock_free_stack_t stack;
+    lac_mem_pool_shard_t shards[LAC_MEM_POOL_NUM_SHARDS];
+    /**< free blocks, a thread uses the shard of SalStatistics_ShardGet() and
+     * takes the blocks of another shard when its own is empty */
     char poolName[LAC_MEM_POOLS_NAME_SIZE]; /*16 bytes of a pool name */
     /**< up to 16 bytes of a pool name */
     unsigned int numElementsInPool;
@@ -165,8 +187,6 @@ typedef struct lac_mem_pool_hdr_s
     /**< block alignment in bytes */
     lac_mem_blk_t **trackBlks;
     /* An array of mem block pointers to track the allocated entries in pool */
-    volatile size_t availBlks;
-    /* Number of blocks available for allocation in this pool */
     CpaBoolean active;
     /* Indicate the pool is available for allocation */
     OsalAtomic sync;
@@ -323,7 +343,9 @@ void Lac_MemPoolEntryFree(void *entry);
 /**
  *******************************************************************************
  * @ingroup LacMemPool
- * This function returns the number of available entries in a particular pool
+ * This function returns the number of available entries in a particular pool.
+ * The count is summed over the shards of the pool, so it is only exact when
+ * no block is being allocated or freed concurrently.
  *
  * @blocking
  *      No
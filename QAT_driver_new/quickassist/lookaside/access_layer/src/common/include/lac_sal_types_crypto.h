@@ -57,6 +57,7 @@
 #include "lac_sal_types.h"
 #include "icp_adf_transport.h"
 #include "lac_mem_pools.h"
+#include "sal_dp_flush.h"
 
 #define LAC_PKE_FLOW_ID_TAG 0xFFFFFFFC
 
@@ -152,6 +153,9 @@ typedef struct sal_crypto_service_s
     CpaCySymDpCbFunc pSymDpCb;
     /**< Sym DP Callback */
 
+    sal_dp_flush_t symDpFlush;
+    /**< Doorbell scheduler of the Sym DP API */
+
     lac_sym_qat_hash_defs_t **pLacHashLookupDefs;
     /**< table of pointers to standard defined information for all hash
          algorithms. We support an extra hash algo that is not exported by
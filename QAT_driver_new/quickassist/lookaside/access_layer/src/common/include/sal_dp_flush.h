@@ -0,0 +1,251 @@
+/***************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file sal_dp_flush.h
+ *
+ * @ingroup SalDpFlush
+ *
+ * @description
+ *     Doorbell scheduler of the data plane APIs. When a policy is set on an
+ *     instance, requests enqueued with performOpNow set to CPA_FALSE are
+ *     left on the ring until either batchSize requests are queued or the
+ *     oldest queued request has waited budgetNs, at which point the ring
+ *     tail is updated by the library. The budget is checked on enqueue, on
+ *     poll and from icp_sal_dp_flush_expired.
+ *
+ *****************************************************************************/
+
+#ifndef SAL_DP_FLUSH_H
+#define SAL_DP_FLUSH_H
+
+#include "cpa.h"
+#include "Osal.h"
+#include "icp_adf_transport.h"
+#include "icp_adf_transport_dp.h"
+
+/**
+ *****************************************************************************
+ * @ingroup SalDpFlush
+ *      Doorbell scheduler state of a data plane instance
+ *
+ * @description
+ *      Policy, pending requests and flush counters. Accessed without locks,
+ *      the data plane APIs of an instance are not thread safe.
+ *
+ *****************************************************************************/
+typedef struct sal_dp_flush_s
+{
+    Cpa32U batchSize;
+    /**< Number of queued requests triggering a flush, 0 when the policy
+     * is disabled */
+    Cpa32U numQueued;
+    /**< Requests written to the ring since the last flush */
+    Cpa64U budgetNs;
+    /**< Time after which the queued requests are flushed, 0 for none */
+    Cpa64U firstQueuedNs;
+    /**< Timestamp of the oldest request not flushed yet */
+    Cpa64U numFlushBatch;
+    /**< Flushes triggered by batchSize */
+    Cpa64U numFlushBudget;
+    /**< Flushes triggered by budgetNs */
+    Cpa64U numFlushExplicit;
+    /**< Flushes requested by the application through performOpNow or
+     * the PerformOpNow functions */
+    Cpa64U numRequestsFlushed;
+    /**< Requests submitted to the device by the flushes */
+} sal_dp_flush_t;
+
+/**
+ ***************************************************************************
+ * @ingroup SalDpFlush
+ *
+ * @description Reset the policy and the counters of a scheduler.
+ *
+ * @param[in] pFlush       pointer to the scheduler state
+ *
+ ***************************************************************************/
+static inline void SalDpFlush_Init(sal_dp_flush_t *pFlush)
+{
+    osalMemSet(pFlush, 0, sizeof(sal_dp_flush_t));
+}
+
+/**
+ ***************************************************************************
+ * @ingroup SalDpFlush
+ *
+ * @description Account for requests written to the ring and return whether
+ * the ring tail has to be updated now. With no policy set this is
+ * performOpNow.
+ *
+ * @param[in] pFlush       pointer to the scheduler state
+ * @param[in] numRequests  number of requests written to the ring
+ * @param[in] performOpNow value passed by the application
+ *
+ ***************************************************************************/
+static inline CpaBoolean SalDpFlush_Queued(sal_dp_flush_t *pFlush,
+                                           Cpa32U numRequests,
+                                           CpaBoolean performOpNow)
+{
+    Cpa64U now = 0;
+
+    if (0 == pFlush->batchSize)
+    {
+        return performOpNow;
+    }
+
+    if (CPA_TRUE == performOpNow)
+    {
+        pFlush->numQueued += numRequests;
+        pFlush->numFlushExplicit++;
+        return CPA_TRUE;
+    }
+
+    if (0 != pFlush->budgetNs)
+    {
+        now = osalTimestampGetNs();
+        if (0 == pFlush->numQueued)
+        {
+            pFlush->firstQueuedNs = now;
+        }
+    }
+    pFlush->numQueued += numRequests;
+
+    if (pFlush->numQueued >= pFlush->batchSize)
+    {
+        pFlush->numFlushBatch++;
+        return CPA_TRUE;
+    }
+    if ((0 != pFlush->budgetNs) &&
+        (now - pFlush->firstQueuedNs >= pFlush->budgetNs))
+    {
+        pFlush->numFlushBudget++;
+        return CPA_TRUE;
+    }
+
+    return CPA_FALSE;
+}
+
+/**
+ ***************************************************************************
+ * @ingroup SalDpFlush
+ *
+ * @description Return whether the queued requests have exceeded the time
+ * budget and have to be flushed.
+ *
+ * @param[in] pFlush       pointer to the scheduler state
+ *
+ ***************************************************************************/
+static inline CpaBoolean SalDpFlush_Expired(sal_dp_flush_t *pFlush)
+{
+    if ((0 == pFlush->numQueued) || (0 == pFlush->budgetNs))
+    {
+        return CPA_FALSE;
+    }
+    if (osalTimestampGetNs() - pFlush->firstQueuedNs < pFlush->budgetNs)
+    {
+        return CPA_FALSE;
+    }
+    pFlush->numFlushBudget++;
+    return CPA_TRUE;
+}
+
+/**
+ ***************************************************************************
+ * @ingroup SalDpFlush
+ *
+ * @description Account for an application requested flush of the ring.
+ *
+ * @param[in] pFlush       pointer to the scheduler state
+ *
+ ***************************************************************************/
+static inline void SalDpFlush_Explicit(sal_dp_flush_t *pFlush)
+{
+    if (0 != pFlush->numQueued)
+    {
+        pFlush->numFlushExplicit++;
+    }
+}
+
+/**
+ ***************************************************************************
+ * @ingroup SalDpFlush
+ *
+ * @description Record that the ring tail has been updated. When the update
+ * fails the requests stay queued and are flushed on the next trigger.
+ *
+ * @param[in] pFlush       pointer to the scheduler state
+ *
+ ***************************************************************************/
+static inline void SalDpFlush_Done(sal_dp_flush_t *pFlush)
+{
+    pFlush->numRequestsFlushed += pFlush->numQueued;
+    pFlush->numQueued = 0;
+}
+
+/**
+ ***************************************************************************
+ * @ingroup SalDpFlush
+ *
+ * @description Update the ring tail if the queued requests have exceeded
+ * the time budget. Called from the poll functions and from
+ * icp_sal_dp_flush_expired.
+ *
+ * @param[in] pFlush       pointer to the scheduler state
+ * @param[in] trans_handle request ring of the instance
+ *
+ ***************************************************************************/
+static inline CpaStatus SalDpFlush_FlushExpired(
+    sal_dp_flush_t *pFlush,
+    icp_comms_trans_handle trans_handle)
+{
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    if (CPA_TRUE == SalDpFlush_Expired(pFlush))
+    {
+        status = icp_adf_updateQueueTail(trans_handle);
+        if (CPA_STATUS_SUCCESS == status)
+        {
+            SalDpFlush_Done(pFlush);
+        }
+    }
+
+    return status;
+}
+
+#endif /* SAL_DP_FLUSH_H */
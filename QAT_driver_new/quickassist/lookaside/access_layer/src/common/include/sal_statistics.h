@@ -49,6 +49,10 @@
 #ifndef SAL_STATISTICS_H
 #define SAL_STATISTICS_H
 
+#ifdef KERNEL_SPACE
+#include <linux/smp.h>
+#endif
+
 /*
  * Config values names for statistics
  */
@@ -94,6 +98,19 @@
 #define SAL_STATISTICS_STRING_OFF "0"
 /**< String representing the value for disabled statistics */
 
+#define SAL_STATS_NUM_SHARDS (16)
+/**< Number of shards of a sharded statistics array, a power of 2 */
+#define SAL_STATS_SHARD_MASK (SAL_STATS_NUM_SHARDS - 1)
+/**< Mask of a shard index */
+#define SAL_STATS_SHARD_ASSIGNED (0x80000000)
+/**< Set in the shard index of a thread once it has been assigned */
+#define SAL_STATS_PER_CACHE_LINE (64 / sizeof(OsalAtomic))
+/**< Number of counters in a cache line */
+#define SAL_STATS_SHARD_STRIDE(numStats)                                       \
+    (((numStats) + SAL_STATS_PER_CACHE_LINE - 1) &                             \
+     ~(SAL_STATS_PER_CACHE_LINE - 1))
+/**< Number of counters of a shard, padded to whole cache lines */
+
 /**
 *****************************************************************************
 * @ingroup SalStats
@@ -164,6 +181,109 @@ CpaStatus SalStatistics_InitStatisticsCollection(icp_accel_dev_t *device);
  ******************************************************************************/
 CpaStatus SalStatistics_CleanStatisticsCollection(icp_accel_dev_t *device);
 
+/**
+ ******************************************************************************
+ * @ingroup SalStats
+ *
+ * @description
+ *      Allocates a sharded statistics array and sets it to 0.
+ *
+ *      A sharded array holds SAL_STATS_NUM_SHARDS copies of the counters of
+ *      a service, each starting on its own cache line. A thread increments
+ *      the counters of its own shard only, so threads submitting and
+ *      polling on different cores do not bounce the counter cache lines
+ *      between them. The value of a counter is the sum over the shards.
+ *
+ * @param[out] ppStats            Where to store the array
+ * @param[in]  numStats           Number of counters of the service
+ *
+ * @retval  CPA_STATUS_SUCCESS          Operation successful
+ * @retval  CPA_STATUS_RESOURCE         Memory alloc failed
+ *
+ ******************************************************************************/
+CpaStatus SalStatistics_ShardedAlloc(OsalAtomic **ppStats, Cpa32U numStats);
+
+/**
+ ******************************************************************************
+ * @ingroup SalStats
+ *
+ * @description
+ *      Frees a sharded statistics array.
+ *
+ * @param[in,out] ppStats         Array to free, set to NULL
+ *
+ ******************************************************************************/
+void SalStatistics_ShardedFree(OsalAtomic **ppStats);
+
+/**
+ ******************************************************************************
+ * @ingroup SalStats
+ *
+ * @description
+ *      Sets all the counters of a sharded statistics array to 0.
+ *
+ * @param[in]  pStats             Sharded array
+ * @param[in]  numStats           Number of counters of the service
+ *
+ ******************************************************************************/
+void SalStatistics_ShardedReset(OsalAtomic *pStats, Cpa32U numStats);
+
+/**
+ ******************************************************************************
+ * @ingroup SalStats
+ *
+ * @description
+ *      Reads all the counters of a sharded statistics array, summing each
+ *      counter over the shards.
+ *
+ * @param[in]  pStats             Sharded array
+ * @param[in]  numStats           Number of counters of the service
+ * @param[out] pValues            Array of numStats values
+ *
+ ******************************************************************************/
+void SalStatistics_ShardedGet(OsalAtomic *pStats,
+                              Cpa32U numStats,
+                              Cpa64U *pValues);
+
+/**
+ ******************************************************************************
+ * @ingroup SalStats
+ *
+ * @description
+ *      Assigns a shard to the calling thread, round robin over the shards.
+ *
+ * @retval  The shard index of the thread, with SAL_STATS_SHARD_ASSIGNED set
+ *
+ ******************************************************************************/
+Cpa32U SalStatistics_ShardAssign(void);
+
+#ifndef KERNEL_SPACE
+extern __thread Cpa32U salStatsThreadShard;
+/**< Shard index of the calling thread, 0 until assigned */
+
+/* Shard of the calling thread */
+static inline Cpa32U SalStatistics_ShardGet(void)
+{
+    Cpa32U shard = salStatsThreadShard;
+
+    if (0 == shard)
+    {
+        shard = SalStatistics_ShardAssign();
+    }
+    return shard & SAL_STATS_SHARD_MASK;
+}
+#else
+/* Shard of the current CPU, a preempted thread may update another CPU's
+ * shard, which stays correct as the counters are atomic */
+#define SalStatistics_ShardGet() (raw_smp_processor_id() & SAL_STATS_SHARD_MASK)
+#endif
+
+/* Increment a counter of a sharded statistics array */
+#define SAL_STATS_SHARDED_INC(pStats, numStats, index)                         \
+    osalAtomicInc(&(pStats)[SalStatistics_ShardGet() *                         \
+                                SAL_STATS_SHARD_STRIDE(numStats) +             \
+                            (index)])
+
 #if defined(COUNTERS) && !defined(DISABLE_STATS)
 /* Type of the RSA request */
 typedef enum
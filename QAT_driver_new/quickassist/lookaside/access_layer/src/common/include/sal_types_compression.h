@@ -54,6 +54,7 @@
 #include "icp_buffer_desc.h"
 
 #include "lac_mem_pools.h"
+#include "sal_dp_flush.h"
 #include "icp_adf_transport.h"
 #include "lac_sym_qat_hash_defs_lookup.h"
 #include "lac_sym_qat_constants_table.h"
@@ -212,6 +213,14 @@ typedef struct sal_compression_service_s
     /* Callback function defined for the DcDp API compression session */
     CpaDcDpCallbackFn pDcDpCb;
 
+    /* Completion array filled by icp_sal_DcPollDpInstanceBatch in place of
+     * calling pDcDpCb, NULL outside of a batch poll */
+    CpaDcDpOpData **ppDcDpCqEntries;
+    Cpa32U dcDpCqCount;
+
+    /* Doorbell scheduler of the DcDp API */
+    sal_dp_flush_t dcDpFlush;
+
     /* Config info */
     Cpa16U acceleratorNum;
     Cpa16U bankNum;
@@ -86,6 +86,61 @@ static inline void push(lock_free_stack_t *stack, lac_mem_blk_t *val)
         &stack->top.atomic, old_top.atomic, new_top.atomic));
 }
 
+/* Pushes the chain of blocks from first to last linked through pNext */
+static inline void push_list(lock_free_stack_t *stack,
+                             lac_mem_blk_t *first,
+                             lac_mem_blk_t *last)
+{
+    pointer_t new_top;
+    pointer_t old_top;
+
+    do
+    {
+        old_top.atomic = stack->top.atomic;
+        last->pNext = old_top.ptr;
+        new_top.ptr = first;
+        new_top.ctr = old_top.ctr + 1;
+    } while (!__sync_bool_compare_and_swap(
+        &stack->top.atomic, old_top.atomic, new_top.atomic));
+}
+
+/* Makes the chain of blocks starting at first the content of the stack,
+ * only if the stack is empty. Returns false when it is not. */
+static inline bool set_if_empty(lock_free_stack_t *stack, lac_mem_blk_t *first)
+{
+    pointer_t new_top;
+    pointer_t old_top;
+
+    old_top.atomic = stack->top.atomic;
+    if (NULL != old_top.ptr)
+        return false;
+
+    new_top.ptr = first;
+    new_top.ctr = old_top.ctr + 1;
+    return __sync_bool_compare_and_swap(
+        &stack->top.atomic, old_top.atomic, new_top.atomic);
+}
+
+/* Empties the stack, returning its blocks linked through pNext */
+static inline lac_mem_blk_t *pop_all(lock_free_stack_t *stack)
+{
+    pointer_t old_top;
+    pointer_t new_top;
+
+    do
+    {
+        old_top.atomic = stack->top.atomic;
+        if (NULL == old_top.ptr)
+            return NULL;
+
+        new_top.ptr = NULL;
+        new_top.ctr = old_top.ctr + 1;
+    } while (!__sync_bool_compare_and_swap(
+        &stack->top.atomic, old_top.atomic, new_top.atomic));
+
+    return old_top.ptr;
+}
+
 static inline lock_free_stack_t init_stack(void)
 {
     lock_free_stack_t stack = {.top.atomic = 0};
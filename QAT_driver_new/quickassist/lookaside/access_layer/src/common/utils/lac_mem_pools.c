@@ -55,6 +55,7 @@
 #include "lac_mem_pools.h"
 #include "lac_mem.h"
 #include "lac_common.h"
+#include "sal_statistics.h"
 #include "cpa_dc.h"
 #include "dc_session.h"
 #include "dc_datapath.h"
@@ -89,6 +90,11 @@ LAC_DECLARE_HIGHEST_BIT_OF(lac_mem_blk_t);
  ******************************************************************************/
 void Lac_MemPoolCleanUpInternal(lac_mem_pool_hdr_t *pPoolID);
 
+/* Shard of the calling thread */
+#define LAC_MEM_POOL_SHARD(pPoolID)                                            \
+    (&(pPoolID)->shards[SalStatistics_ShardGet() &                             \
+                        (LAC_MEM_POOL_NUM_SHARDS - 1)])
+
 static inline Cpa32U Lac_MemPoolGetElementRealSize(Cpa32U blkSizeInBytes,
                                                    Cpa32U blkAlignmentInBytes)
 {
@@ -116,6 +122,7 @@ CpaStatus Lac_MemPoolCreate(
     unsigned int poolSearch = 0;
     unsigned int counter = 0;
     lac_mem_blk_t *pMemBlkCurrent = NULL;
+    lac_mem_pool_shard_t *pShard = NULL;
 
     void *pMemBlk = NULL;
 
@@ -136,13 +143,15 @@ CpaStatus Lac_MemPoolCreate(
         }
     }
 
-    /* Allocate a Pool header */
-    if (CPA_STATUS_SUCCESS !=
-        LAC_OS_MALLOC(&lac_mem_pools[poolSearch], sizeof(lac_mem_pool_hdr_t)))
+    /* Allocate a Pool header, aligned so every shard owns a cache line */
+    lac_mem_pools[poolSearch] = osalMemAllocAligned(
+        0, sizeof(lac_mem_pool_hdr_t), LAC_64BYTE_ALIGNMENT);
+    if (NULL == lac_mem_pools[poolSearch])
     {
         LAC_LOG_ERROR("Unable to allocate memory for creation of the pool");
         return CPA_STATUS_RESOURCE; /*Error*/
     }
+    osalMemSet(lac_mem_pools[poolSearch], 0, sizeof(lac_mem_pool_hdr_t));
 
 
     /* Copy in Pool Name */
@@ -155,7 +164,7 @@ CpaStatus Lac_MemPoolCreate(
     }
     else
     {
-        LAC_OS_FREE(lac_mem_pools[poolSearch]);
+        osalMemAlignedFree(lac_mem_pools[poolSearch]);
         lac_mem_pools[poolSearch] = NULL;
         LAC_LOG_ERROR("Invalid Pool Name pointer");
         return CPA_STATUS_INVALID_PARAM; /*Error*/
@@ -168,7 +177,7 @@ CpaStatus Lac_MemPoolCreate(
             LAC_OS_MALLOC(&(lac_mem_pools[poolSearch]->trackBlks),
                           (sizeof(lac_mem_blk_t *) * numElementsInPool)))
         {
-            LAC_OS_FREE(lac_mem_pools[poolSearch]);
+            osalMemAlignedFree(lac_mem_pools[poolSearch]);
             lac_mem_pools[poolSearch] = NULL;
             LAC_LOG_ERROR(
                 "Unable to allocate memory for tracking memory blocks");
@@ -180,8 +189,11 @@ CpaStatus Lac_MemPoolCreate(
         lac_mem_pools[poolSearch]->trackBlks = NULL;
     }
 
-    lac_mem_pools[poolSearch]->availBlks = 0;
-    lac_mem_pools[poolSearch]->stack = init_stack();
+    for (counter = 0; counter < LAC_MEM_POOL_NUM_SHARDS; counter++)
+    {
+        lac_mem_pools[poolSearch]->shards[counter].stack = init_stack();
+        lac_mem_pools[poolSearch]->shards[counter].availBlks = 0;
+    }
 
     /* Calculate alignment needed for allocation   */
     for (counter = 0; counter < numElementsInPool; counter++)
@@ -225,7 +237,11 @@ CpaStatus Lac_MemPoolCreate(
         pMemBlkCurrent->isInUse = CPA_FALSE;
         pMemBlkCurrent->pNext = NULL;
 
-        push(&lac_mem_pools[poolSearch]->stack, pMemBlkCurrent);
+        /* Spread the blocks evenly over the shards */
+        pShard = &lac_mem_pools[poolSearch]
+                      ->shards[counter & (LAC_MEM_POOL_NUM_SHARDS - 1)];
+        push(&pShard->stack, pMemBlkCurrent);
+        pShard->availBlks++;
 
         /* Store allocated memory pointer */
         if (lac_mem_pools[poolSearch]->trackBlks != NULL)
@@ -233,7 +249,6 @@ CpaStatus Lac_MemPoolCreate(
             (lac_mem_pools[poolSearch]->trackBlks[counter]) =
                 (lac_mem_blk_t *)pMemBlkCurrent;
         }
-        __sync_add_and_fetch(&lac_mem_pools[poolSearch]->availBlks, 1);
     }
 
     /* Set Pool details in the header */
@@ -277,9 +292,57 @@ void Lac_MemPoolDisable(lac_memory_pool_id_t poolID)
     return;
 }
 
+/**
+ *******************************************************************************
+ * @ingroup LacMemPool
+ * Refills an empty shard with all the free blocks of another shard, taken in
+ * a single operation, and returns one of them.
+ ******************************************************************************/
+STATIC lac_mem_blk_t *Lac_MemPoolSteal(lac_mem_pool_hdr_t *pPoolID,
+                                       lac_mem_pool_shard_t *pShard)
+{
+    Cpa32U index = (Cpa32U)(pShard - pPoolID->shards);
+    Cpa32U i = 0;
+    lac_mem_blk_t *pFirst = NULL;
+    lac_mem_blk_t *pLast = NULL;
+
+    for (i = 1; (i < LAC_MEM_POOL_NUM_SHARDS) && (NULL == pFirst); i++)
+    {
+        lac_mem_pool_shard_t *pVictim =
+            &pPoolID->shards[(index + i) & (LAC_MEM_POOL_NUM_SHARDS - 1)];
+
+        /* Racy peek, an empty shard is skipped without a CAS */
+        if (NULL != top(&pVictim->stack))
+        {
+            pFirst = pop_all(&pVictim->stack);
+        }
+    }
+    if (NULL == pFirst)
+    {
+        return NULL;
+    }
+
+    /* Keep the first block, the others refill the shard of the thread.
+     * The shard is normally still empty and takes the chain as it is;
+     * walking it to its last block would touch every block twice. The
+     * free counts are left alone, only their sum is meaningful. */
+    if ((NULL != pFirst->pNext) &&
+        !set_if_empty(&pShard->stack, pFirst->pNext))
+    {
+        pLast = pFirst->pNext;
+        while (NULL != pLast->pNext)
+        {
+            pLast = pLast->pNext;
+        }
+        push_list(&pShard->stack, pFirst->pNext, pLast);
+    }
+    return pFirst;
+}
+
 void *Lac_MemPoolEntryAlloc(lac_memory_pool_id_t poolID)
 {
     lac_mem_pool_hdr_t *pPoolID = (lac_mem_pool_hdr_t *)poolID;
+    lac_mem_pool_shard_t *pShard = NULL;
     lac_mem_blk_t *pMemBlkCurrent = NULL;
 
 #ifdef ICP_DEBUG
@@ -294,13 +357,18 @@ void *Lac_MemPoolEntryAlloc(lac_memory_pool_id_t poolID)
     if (unlikely(pPoolID->active == CPA_FALSE))
         return NULL;
 
-    /* Remove block from pool */
-    pMemBlkCurrent = pop(&pPoolID->stack);
+    /* Remove block from the shard of the thread */
+    pShard = LAC_MEM_POOL_SHARD(pPoolID);
+    pMemBlkCurrent = pop(&pShard->stack);
     if (NULL == pMemBlkCurrent)
     {
-        return (void *)CPA_STATUS_RETRY;
+        pMemBlkCurrent = Lac_MemPoolSteal(pPoolID, pShard);
+        if (NULL == pMemBlkCurrent)
+        {
+            return (void *)CPA_STATUS_RETRY;
+        }
     }
-    __sync_sub_and_fetch(&pPoolID->availBlks, 1);
+    __sync_sub_and_fetch(&pShard->availBlks, 1);
     pMemBlkCurrent->isInUse = CPA_TRUE;
     return (void *)((LAC_ARCH_UINT)(pMemBlkCurrent) + sizeof(lac_mem_blk_t));
 }
@@ -308,6 +376,7 @@ void *Lac_MemPoolEntryAlloc(lac_memory_pool_id_t poolID)
 void Lac_MemPoolEntryFree(void *pEntry)
 {
     lac_mem_blk_t *pMemBlk = NULL;
+    lac_mem_pool_shard_t *pShard = NULL;
 
 #ifdef ICP_DEBUG
     /* Explicitly NULL pointer check */
@@ -321,8 +390,9 @@ void Lac_MemPoolEntryFree(void *pEntry)
     pMemBlk = (lac_mem_blk_t *)((LAC_ARCH_UINT)pEntry - sizeof(lac_mem_blk_t));
     pMemBlk->isInUse = CPA_FALSE;
 
-    push(&pMemBlk->pPoolID->stack, pMemBlk);
-    __sync_add_and_fetch(&pMemBlk->pPoolID->availBlks, 1);
+    pShard = LAC_MEM_POOL_SHARD(pMemBlk->pPoolID);
+    push(&pShard->stack, pMemBlk);
+    __sync_add_and_fetch(&pShard->availBlks, 1);
 }
 
 void Lac_MemPoolDestroy(lac_memory_pool_id_t poolID)
@@ -358,14 +428,17 @@ void Lac_MemPoolCleanUpInternal(lac_mem_pool_hdr_t *pPoolID)
 
     if (pPoolID->trackBlks == NULL)
     {
-        pCurrentBlk = pop(&pPoolID->stack);
-
-        while (pCurrentBlk != NULL)
+        for (count = 0; count < LAC_MEM_POOL_NUM_SHARDS; count++)
         {
-            /* Free Data Blocks */
-            pFreePtr = pCurrentBlk->pMemAllocPtr;
-            pCurrentBlk = pop(&pPoolID->stack);
-            LAC_OS_CAFREE(pFreePtr);
+            pCurrentBlk = pop_all(&pPoolID->shards[count].stack);
+
+            while (pCurrentBlk != NULL)
+            {
+                /* Free Data Blocks */
+                pFreePtr = pCurrentBlk->pMemAllocPtr;
+                pCurrentBlk = pCurrentBlk->pNext;
+                LAC_OS_CAFREE(pFreePtr);
+            }
         }
     }
     else
@@ -377,18 +450,27 @@ void Lac_MemPoolCleanUpInternal(lac_mem_pool_hdr_t *pPoolID)
         }
         LAC_OS_FREE(pPoolID->trackBlks);
     }
-    LAC_OS_FREE(pPoolID);
+    osalMemAlignedFree(pPoolID);
 }
 
 unsigned int Lac_MemPoolAvailableEntries(lac_memory_pool_id_t poolID)
 {
     lac_mem_pool_hdr_t *pPoolID = (lac_mem_pool_hdr_t *)poolID;
+    long availBlks = 0;
+    Cpa32U i = 0;
+
     if (pPoolID == NULL)
     {
         LAC_LOG_ERROR("Invalid Pool ID");
         return 0;
     }
-    return pPoolID->availBlks;
+    /* A shard goes negative when its threads free fewer blocks than they
+     * allocate, only the sum is meaningful */
+    for (i = 0; i < LAC_MEM_POOL_NUM_SHARDS; i++)
+    {
+        availBlks += pPoolID->shards[i].availBlks;
+    }
+    return availBlks < 0 ? 0 : (unsigned int)availBlks;
 }
 
 void Lac_MemPoolStatsShow(void)
@@ -409,13 +491,14 @@ void Lac_MemPoolStatsShow(void)
                            " No. Elements in Pool:  %10u \n" BORDER
                            " Element Size in Bytes: %10u \n" BORDER
                            " Alignment in Bytes:    %10u \n" BORDER
-                           " No. Available Blocks:  %10zu \n" SEPARATOR,
+                           " No. Available Blocks:  %10u \n" SEPARATOR,
                     lac_mem_pools[index]->poolName,
                     lac_mem_pools[index]->active ? "TRUE" : "FALSE",
                     lac_mem_pools[index]->numElementsInPool,
                     lac_mem_pools[index]->blkSizeInBytes,
                     lac_mem_pools[index]->blkAlignmentInBytes,
-                    lac_mem_pools[index]->availBlks);
+                    Lac_MemPoolAvailableEntries(
+                        (lac_memory_pool_id_t)lac_mem_pools[index]));
         }
         index++;
     }
@@ -465,6 +548,7 @@ CpaStatus Lac_MemPoolInitSymCookiesPhyAddr(lac_memory_pool_id_t poolID,
     lac_mem_pool_hdr_t *pPoolID = (lac_mem_pool_hdr_t *)poolID;
     lac_sym_cookie_t *pSymCookie = NULL;
     lac_mem_blk_t *pCurrentBlk = NULL;
+    Cpa32U count = 0;
 
     if (NULL == pPoolID)
     {
@@ -474,19 +558,22 @@ CpaStatus Lac_MemPoolInitSymCookiesPhyAddr(lac_memory_pool_id_t poolID,
 
     if (pPoolID->trackBlks == NULL)
     {
-        pCurrentBlk = top(&pPoolID->stack);
-
-        while (pCurrentBlk != NULL)
+        for (count = 0; count < LAC_MEM_POOL_NUM_SHARDS; count++)
         {
-            pSymCookie = (lac_sym_cookie_t *)((LAC_ARCH_UINT)(pCurrentBlk) +
-                                              sizeof(lac_mem_blk_t));
-            pCurrentBlk = pCurrentBlk->pNext;
-            Lac_MemPoolInitSymCookies(pSymCookie, instanceHandle);
+            pCurrentBlk = top(&pPoolID->shards[count].stack);
+
+            while (pCurrentBlk != NULL)
+            {
+                pSymCookie =
+                    (lac_sym_cookie_t *)((LAC_ARCH_UINT)(pCurrentBlk) +
+                                         sizeof(lac_mem_blk_t));
+                pCurrentBlk = pCurrentBlk->pNext;
+                Lac_MemPoolInitSymCookies(pSymCookie, instanceHandle);
+            }
         }
     }
     else
     {
-        Cpa32U count = 0;
 
         for (count = 0; count < pPoolID->numElementsInPool; count++)
         {
@@ -505,6 +592,7 @@ CpaStatus Lac_MemPoolInitAsymCookies(lac_memory_pool_id_t poolID,
     lac_mem_pool_hdr_t *pPoolID = (lac_mem_pool_hdr_t *)poolID;
     lac_mem_blk_t *pCurrentBlk = NULL;
     Cpa8U *pAsymReq = NULL;
+    Cpa32U count = 0;
 
     if (NULL == pPoolID)
     {
@@ -514,19 +602,21 @@ CpaStatus Lac_MemPoolInitAsymCookies(lac_memory_pool_id_t poolID,
 
     if (pPoolID->trackBlks == NULL)
     {
-        pCurrentBlk = top(&pPoolID->stack);
-
-        while (pCurrentBlk != NULL)
+        for (count = 0; count < LAC_MEM_POOL_NUM_SHARDS; count++)
         {
-            pAsymReq =
-                (Cpa8U *)((LAC_ARCH_UINT)(pCurrentBlk) + sizeof(lac_mem_blk_t));
-            pCurrentBlk = pCurrentBlk->pNext;
-            LacPke_InitAsymRequest(pAsymReq, instanceHandle);
+            pCurrentBlk = top(&pPoolID->shards[count].stack);
+
+            while (pCurrentBlk != NULL)
+            {
+                pAsymReq = (Cpa8U *)((LAC_ARCH_UINT)(pCurrentBlk) +
+                                     sizeof(lac_mem_blk_t));
+                pCurrentBlk = pCurrentBlk->pNext;
+                LacPke_InitAsymRequest(pAsymReq, instanceHandle);
+            }
         }
     }
     else
     {
-        Cpa32U count = 0;
 
         for (count = 0; count < pPoolID->numElementsInPool; count++)
         {
@@ -70,7 +70,8 @@ static OsalAtomic lac_sw_resp_num_pools_busy = ATOMIC_INIT(0);
 void LacSwResp_IncNumPoolsBusy(lac_memory_pool_id_t poolID)
 {
     lac_mem_pool_hdr_t *pPoolID = (lac_mem_pool_hdr_t *)poolID;
-    if (pPoolID && pPoolID->availBlks != pPoolID->numElementsInPool)
+    if (pPoolID &&
+        Lac_MemPoolAvailableEntries(poolID) != pPoolID->numElementsInPool)
     {
         osalAtomicInc(&lac_sw_resp_num_pools_busy);
     }
@@ -104,7 +105,8 @@ lac_memblk_bucket_t *LacSwResp_MemBlkBucketCreate(lac_mem_pool_hdr_t *pPoolID)
     Cpa32U numBlksUsed = 0;
     Cpa64U seq = ICP_ADF_INVALID_SEND_SEQ;
 
-    numBlksUsed = pPoolID->numElementsInPool - pPoolID->availBlks;
+    numBlksUsed = pPoolID->numElementsInPool -
+                  Lac_MemPoolAvailableEntries((lac_memory_pool_id_t)pPoolID);
 
     if (0 == numBlksUsed)
     {
@@ -143,9 +145,8 @@ lac_memblk_bucket_t *LacSwResp_MemBlkBucketCreate(lac_mem_pool_hdr_t *pPoolID)
         opaque = pCurrentBlk->opaque;
         if (ICP_ADF_INVALID_SEND_SEQ == opaque)
         {
-            pCurrentBlk->isInUse = CPA_FALSE;
-            push(&pCurrentBlk->pPoolID->stack, pCurrentBlk);
-            __sync_add_and_fetch(&pCurrentBlk->pPoolID->availBlks, 1);
+            Lac_MemPoolEntryFree((void *)((LAC_ARCH_UINT)pCurrentBlk +
+                                          sizeof(lac_mem_blk_t)));
             continue;
         }
         pBucket->numBlksInRing++;
@@ -206,6 +207,7 @@ CpaStatus LacSwResp_GenResp(lac_memory_pool_id_t lac_mem_pool,
     CpaStatus status = CPA_STATUS_RETRY;
     lac_mem_pool_hdr_t *pPoolID = (lac_mem_pool_hdr_t *)lac_mem_pool;
     lac_memblk_bucket_t *pBucket;
+    unsigned int availBlks = 0;
 
     if (NULL == pPoolID || CPA_TRUE == pPoolID->active)
     {
@@ -215,13 +217,14 @@ CpaStatus LacSwResp_GenResp(lac_memory_pool_id_t lac_mem_pool,
 
     if (Lac_MemPoolTestAndGet(lac_mem_pool))
     {
-        if (pPoolID->numElementsInPool < pPoolID->availBlks)
+        availBlks = Lac_MemPoolAvailableEntries(lac_mem_pool);
+        if (pPoolID->numElementsInPool < availBlks)
         {
             LAC_LOG_ERROR("Invalid availBlks!");
             return CPA_STATUS_FATAL;
         }
 
-        if (pPoolID->numElementsInPool == pPoolID->availBlks)
+        if (pPoolID->numElementsInPool == availBlks)
         {
             return CPA_STATUS_RETRY;
         }
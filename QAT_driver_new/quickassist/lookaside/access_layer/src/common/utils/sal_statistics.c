@@ -238,6 +238,79 @@ CpaStatus SalStatistics_InitStatisticsCollection(icp_accel_dev_t *device)
     return status;
 }
 
+#ifndef KERNEL_SPACE
+__thread Cpa32U salStatsThreadShard = 0;
+#endif
+
+/* Next shard handed out to a thread */
+STATIC OsalAtomic salStatsNextShard = 0;
+
+Cpa32U SalStatistics_ShardAssign(void)
+{
+    Cpa32U shard = (Cpa32U)osalAtomicInc(&salStatsNextShard);
+
+    shard = (shard & SAL_STATS_SHARD_MASK) | SAL_STATS_SHARD_ASSIGNED;
+#ifndef KERNEL_SPACE
+    salStatsThreadShard = shard;
+#endif
+    return shard;
+}
+
+CpaStatus SalStatistics_ShardedAlloc(OsalAtomic **ppStats, Cpa32U numStats)
+{
+    Cpa32U size =
+        SAL_STATS_NUM_SHARDS * SAL_STATS_SHARD_STRIDE(numStats) *
+        sizeof(OsalAtomic);
+
+    *ppStats = osalMemAllocAligned(0, size, LAC_64BYTE_ALIGNMENT);
+    if (NULL == *ppStats)
+    {
+        LAC_LOG_ERROR("Failed to allocate statistics");
+        return CPA_STATUS_RESOURCE;
+    }
+
+    SalStatistics_ShardedReset(*ppStats, numStats);
+    return CPA_STATUS_SUCCESS;
+}
+
+void SalStatistics_ShardedFree(OsalAtomic **ppStats)
+{
+    if (NULL != *ppStats)
+    {
+        osalMemAlignedFree((void *)*ppStats);
+        *ppStats = NULL;
+    }
+}
+
+void SalStatistics_ShardedReset(OsalAtomic *pStats, Cpa32U numStats)
+{
+    Cpa32U i = 0;
+
+    for (i = 0; i < SAL_STATS_NUM_SHARDS * SAL_STATS_SHARD_STRIDE(numStats);
+         i++)
+    {
+        osalAtomicSet(0, &pStats[i]);
+    }
+}
+
+void SalStatistics_ShardedGet(OsalAtomic *pStats,
+                              Cpa32U numStats,
+                              Cpa64U *pValues)
+{
+    Cpa32U stride = SAL_STATS_SHARD_STRIDE(numStats);
+    Cpa32U shard = 0;
+    Cpa32U i = 0;
+
+    for (i = 0; i < numStats; i++)
+    {
+        pValues[i] = 0;
+        for (shard = 0; shard < SAL_STATS_NUM_SHARDS; shard++)
+        {
+            pValues[i] += osalAtomicGet(&pStats[shard * stride + i]);
+        }
+    }
+}
+
 /* @ingroup SalStats */
 CpaStatus SalStatistics_CleanStatisticsCollection(icp_accel_dev_t *device)
 {
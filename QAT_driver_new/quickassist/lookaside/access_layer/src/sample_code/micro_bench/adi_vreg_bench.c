@@ -0,0 +1,711 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file adi_vreg_bench.c
+ *
+ * @description
+ *     Equivalence and cost of the gen4 ADI vreg translation of
+ *     adf_gen4_adi_hal.c. The driver source is built in user space on the
+ *     empty kernel headers generated by the Makefile and the shims below;
+ *     ADF_CSR_RD and ADF_CSR_WR go to fake ETR and misc BARs held in u32
+ *     arrays and log every register access.
+ *
+ *     The switch that translated the trapped accesses before the vreg
+ *     table is kept below as gen4_adi_mmio_rw32_switch. For banks 0, 17
+ *     and 63, every byte position of the first 16KB of the ETR BAR and
+ *     the aliases of the ADF_VQAT_* positions above it and above 4GB are
+ *     read and written through both, in each of the reset status, PASID
+ *     and reset complete states the RPRESETCTL and RPRESETSTS handling
+ *     depends on. Accesses of other than 4 bytes are checked on the
+ *     ADF_VQAT_* positions. The return code, the value read, the ADI
+ *     state and the register accesses must be identical.
+ *
+ *     The cost per trap is then measured for reads and writes of the
+ *     ring vregs in random order and for rejected positions.
+ *
+ *     Usage: adi_vreg_bench
+ *
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stdbool.h>
+#include "micro_bench.h"
+
+/* Kernel shims for the driver source. Under USER_SPACE
+ * adf_accel_devices.h only keeps its definitions shared with user space,
+ * the kernel types the ADI code uses are provided here. */
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int32_t s32;
+typedef uint64_t phys_addr_t;
+typedef uint64_t resource_size_t;
+
+#define __iomem
+#define __packed __attribute__((__packed__))
+#define BIT(nr) (1UL << (nr))
+#define GENMASK(h, l) (((~0UL) << (l)) & (~0UL >> (63 - (h))))
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+#define PAGE_SHIFT 12
+#define PCI_MSIX_ENTRY_CTRL_MASKBIT 0x1
+#define GFP_KERNEL 0
+#define kzalloc(size, flags) calloc(1, (size))
+#define kfree(ptr) free(ptr)
+#define WARN_ON(cond) (!!(cond))
+#define dev_dbg(dev, ...) ((void)(dev))
+#define dev_err(dev, ...) ((void)(dev))
+#define EXPORT_SYMBOL_GPL(sym)
+
+static inline int fls(unsigned int x)
+{
+    return x ? 32 - __builtin_clz(x) : 0;
+}
+
+struct device
+{
+    int unused;
+};
+
+struct mutex
+{
+    int unused;
+};
+
+struct msi_msg
+{
+    u32 address_lo;
+    u32 address_hi;
+    u32 data;
+};
+
+struct adf_bar
+{
+    resource_size_t base_addr;
+    void __iomem *virt_addr;
+    resource_size_t size;
+} __packed;
+
+struct adf_accel_dev;
+
+struct adf_hw_device_data
+{
+    u32 (*get_misc_bar_id)(struct adf_hw_device_data *self);
+    u32 (*get_etr_bar_id)(struct adf_hw_device_data *self);
+    int (*ring_pair_reset)(struct adf_accel_dev *accel_dev, u32 bank_nr);
+    u8 num_banks;
+};
+
+struct adf_accel_dev
+{
+    struct adf_hw_device_data *hw_device;
+    struct adf_bar bars[2];
+    struct device dev;
+};
+
+#define GET_DEV(accel_dev) ((accel_dev)->dev)
+#define GET_BARS(accel_dev) ((accel_dev)->bars)
+
+#define ADI_BENCH_ETR_BAR 0
+#define ADI_BENCH_MISC_BAR 1
+/* Up to the ring CSRs of the last bank */
+#define ADI_BENCH_ETR_SIZE 0x180000
+/* Up to the end of the MSI-X routing table */
+#define ADI_BENCH_MISC_SIZE 0x410000
+#define ADI_BENCH_NUM_BANKS 64
+#define ADI_BENCH_MAX_ACCESSES 8
+
+/* One register access made while serving a trapped vreg access */
+typedef struct adi_bench_access_s
+{
+    const void *base;
+    u32 offset;
+    u32 val;
+    bool isWrite;
+} adi_bench_access_t;
+
+static u32 adiBenchEtr[ADI_BENCH_ETR_SIZE / sizeof(u32)];
+static u32 adiBenchMisc[ADI_BENCH_MISC_SIZE / sizeof(u32)];
+static adi_bench_access_t adiBenchLog[ADI_BENCH_MAX_ACCESSES];
+static u32 adiBenchLogLen;
+static bool adiBenchLogging;
+
+static inline void adiBenchLogAccess(const void *base,
+                                     size_t offset,
+                                     u32 val,
+                                     bool isWrite)
+{
+    if (!adiBenchLogging)
+    {
+        return;
+    }
+    if (adiBenchLogLen < ADI_BENCH_MAX_ACCESSES)
+    {
+        adiBenchLog[adiBenchLogLen].base = base;
+        adiBenchLog[adiBenchLogLen].offset = (u32)offset;
+        adiBenchLog[adiBenchLogLen].val = val;
+        adiBenchLog[adiBenchLogLen].isWrite = isWrite;
+    }
+    adiBenchLogLen++;
+}
+
+static inline u32 adiBenchCsrRead(void *base, size_t offset)
+{
+    u32 val = *(volatile u32 *)((u8 *)base + offset);
+
+    adiBenchLogAccess(base, offset, val, false);
+    return val;
+}
+
+static inline void adiBenchCsrWrite(void *base, size_t offset, u32 val)
+{
+    *(volatile u32 *)((u8 *)base + offset) = val;
+    adiBenchLogAccess(base, offset, val, true);
+}
+
+#define ADF_CSR_RD(csr_base, csr_offset)                                       \
+    adiBenchCsrRead((csr_base), (csr_offset))
+#define ADF_CSR_WR(csr_base, csr_offset, val)                                  \
+    adiBenchCsrWrite((csr_base), (csr_offset), (val))
+
+static inline void adf_csr_fetch_and_and(void __iomem *csr,
+                                         size_t offs,
+                                         unsigned long mask)
+{
+    ADF_CSR_WR(csr, offs, ADF_CSR_RD(csr, offs) & mask);
+}
+
+static inline void adf_csr_fetch_and_or(void __iomem *csr,
+                                        size_t offs,
+                                        unsigned long mask)
+{
+    ADF_CSR_WR(csr, offs, ADF_CSR_RD(csr, offs) | mask);
+}
+
+/* Only the register layout is needed from these */
+#define ADF_TRANSPORT_INTRN_H
+#define ADF_VDCM_IOV_H
+#define ADF_VDCM_CAPS_H
+
+#include "adf_gen4_adi_hal.c"
+
+/* gen4_adi_mmio_rw32() as it was before the vreg table, unchanged apart
+ * from its name */
+static int gen4_adi_mmio_rw32_switch(struct adf_adi_ep *adi, u64 pos,
+			      void *buf, unsigned int len, bool is_write)
+{
+	struct adf_accel_dev *accel_dev;
+	struct adi_priv_data *priv;
+	void __iomem *base_addr;
+	u32 offset = 0;
+	u32 pasid_val;
+
+	if (!adi || !adi->parent || !adi->hw_priv || !buf)
+		return -EINVAL;
+
+	accel_dev = adi->parent;
+	priv = adi->hw_priv;
+
+	dev_dbg(&GET_DEV(accel_dev),
+		"%s: ETR %s %d bytes at vreg offset@0x%llx\n",
+		__func__, is_write ? "write" : "read", len, pos);
+
+	if (len != 4)
+		return -EINVAL;
+
+	if (!priv->etr_bar || !priv->etr_bar->virt_addr)
+		return -EINVAL;
+
+	base_addr = priv->etr_bar->virt_addr;
+	switch (pos) {
+	case ADF_VQAT_R0_CONFIG:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_CONFIG_GEN4);
+		break;
+	case ADF_VQAT_R1_CONFIG:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_CONFIG_GEN4 + 4);
+		break;
+	case ADF_VQAT_R0_LBASE:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_LBASE_GEN4);
+		break;
+	case ADF_VQAT_R1_LBASE:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_LBASE_GEN4 + 4);
+		break;
+	case ADF_VQAT_R0_UBASE:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_UBASE_GEN4);
+		break;
+	case ADF_VQAT_R1_UBASE:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_UBASE_GEN4 + 4);
+		break;
+	case ADF_VQAT_R0_HEAD:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_HEAD);
+		break;
+	case ADF_VQAT_R1_HEAD:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_HEAD + 4);
+		break;
+	case ADF_VQAT_R0_TAIL:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_TAIL);
+		break;
+	case ADF_VQAT_R1_TAIL:
+		offset = GEN4_CSR_OFFSET(adi->bank_idx,
+					 ADF_RING_CSR_RING_TAIL + 4);
+		break;
+	case ADF_VQAT_RPRESETCTL:
+		offset = ADF_WQM_CSR_RPRESETCTL(adi->bank_idx);
+
+		/* TODO: we need to translate guest pasid value to host pasid
+		 * value when rpresetctl register is enabled for pasid level
+		 * reset
+		 */
+		if (is_write) {
+			if (ADF_GET_RPRESETCTL_VALUE(*(u32 *)buf) ==
+			    PASID_LEVEL_RESET) {
+				dev_dbg(&GET_DEV(accel_dev),
+					"%s: unsupported pasid level reset\n",
+					__func__);
+				return -EINVAL;
+			}
+
+			if (adi->reset_complete) {
+				if (ADF_GET_RPRESETCTL_VALUE(*(u32 *)buf) ==
+				    RING_LEVEL_RESET)
+					adi->reset_complete = false;
+			} else {
+				if (ADF_GET_RPRESETCTL_VALUE(*(u32 *)buf) ==
+				    RING_LEVEL_ABORT)
+					break;
+				return -EINVAL;
+			}
+		}
+		break;
+	case ADF_VQAT_RPRESETSTS:
+		offset = ADF_WQM_CSR_RPRESETSTS(adi->bank_idx);
+
+		/* Assume rp reset complete when rpresetsts register
+		 * bit#0 is set and write rpresetsts register bit#0 as 1
+		 */
+		if (is_write) {
+			if (ADF_CSR_RD(base_addr, offset) &
+			    ADF_WQM_CSR_RPRESETSTS_MASK &&
+			    *(u32 *)buf == ADF_WQM_CSR_RPRESETSTS_MASK)
+				adi->reset_complete = true;
+		}
+		break;
+	default:
+		dev_dbg(&GET_DEV(accel_dev),
+			"%s: unsupported register access on adi %d\n",
+			__func__, adi->adi_idx);
+		return -EINVAL;
+	}
+
+	dev_dbg(&GET_DEV(accel_dev),
+		"%s: base_addr = %llx, translated offset = 0x%x\n",
+		__func__, (u64)base_addr, offset);
+
+	if (is_write)
+		ADF_CSR_WR(base_addr, offset, *(u32 *)buf);
+	else
+		*(u32 *)buf = ADF_CSR_RD(base_addr, offset);
+
+	/* After rpresetsts bit#0 is set, restore pasid value */
+	if (is_write && pos == ADF_VQAT_RPRESETSTS) {
+		pasid_val = ADF_CSR_RD(base_addr,
+				       ADF_WQM_CSR_PASIDCTL(adi->bank_idx));
+
+		if (!ADF_GET_PASIDCTL_PASID_VALUE(pasid_val) && adi->pasid > 0)
+			if (hal_rp_set_pasid(adi, adi->pasid))
+				return -EINVAL;
+	}
+
+	return (int)len;
+}
+
+typedef int (*adi_bench_rw_t)(struct adf_adi_ep *adi,
+                              u64 pos,
+                              void *buf,
+                              unsigned int len,
+                              bool is_write);
+
+/* State the RPRESETCTL and RPRESETSTS handling depends on */
+typedef struct adi_bench_state_s
+{
+    bool resetComplete;
+    bool resetDone;
+    u32 hwPasid;
+    u32 pasid;
+} adi_bench_state_t;
+
+/* Everything a trapped access can change */
+typedef struct adi_bench_outcome_s
+{
+    int ret;
+    u32 buf;
+    bool resetComplete;
+    u32 pasid;
+    u32 numAccesses;
+    adi_bench_access_t accesses[ADI_BENCH_MAX_ACCESSES];
+} adi_bench_outcome_t;
+
+static const u64 adiBenchVregs[] = {
+    ADF_VQAT_R0_CONFIG, ADF_VQAT_R1_CONFIG, ADF_VQAT_R0_LBASE,
+    ADF_VQAT_R1_LBASE,  ADF_VQAT_R0_UBASE,  ADF_VQAT_R1_UBASE,
+    ADF_VQAT_R0_HEAD,   ADF_VQAT_R1_HEAD,   ADF_VQAT_R0_TAIL,
+    ADF_VQAT_R1_TAIL,   ADF_VQAT_RPRESETCTL, ADF_VQAT_RPRESETSTS};
+/* The first ADI_BENCH_NUM_RING_VREGS entries have no write handling */
+#define ADI_BENCH_NUM_RING_VREGS 10
+#define ADI_BENCH_NUM_VREGS ARRAY_SIZE(adiBenchVregs)
+
+/* Bytes of the ETR BAR swept at every position */
+#define ADI_BENCH_SWEEP 0x4000
+
+static const u32 adiBenchWriteVals[] = {0, 1, 2, 3, 5, 0xffffffff};
+static const unsigned int adiBenchBadLens[] = {0, 1, 2, 8};
+
+static inline u32 adiBenchResetValue(u32 offset)
+{
+    return offset * 2654435761U;
+}
+
+static bool adiBenchIsVreg(u64 pos)
+{
+    u32 i;
+
+    for (i = 0; i < ADI_BENCH_NUM_VREGS; i++)
+    {
+        if (adiBenchVregs[i] == pos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static u32 adiBenchMiscBarId(struct adf_hw_device_data *self)
+{
+    return ADI_BENCH_MISC_BAR;
+}
+
+static u32 adiBenchEtrBarId(struct adf_hw_device_data *self)
+{
+    return ADI_BENCH_ETR_BAR;
+}
+
+static void adiBenchApply(struct adf_adi_ep *pAdi,
+                          const adi_bench_state_t *pState)
+{
+    u32 sts = ADF_WQM_CSR_RPRESETSTS(pAdi->bank_idx);
+    u32 pasidCtl = ADF_WQM_CSR_PASIDCTL(pAdi->bank_idx);
+
+    pAdi->reset_complete = pState->resetComplete;
+    pAdi->pasid = pState->pasid;
+    adiBenchEtr[sts / sizeof(u32)] =
+        (adiBenchResetValue(sts) & ~ADF_WQM_CSR_RPRESETSTS_MASK) |
+        (pState->resetDone ? ADF_WQM_CSR_RPRESETSTS_MASK : 0);
+    adiBenchEtr[pasidCtl / sizeof(u32)] =
+        (adiBenchResetValue(pasidCtl) & ~ADF_PASIDCTL_PASID_MASK) |
+        pState->hwPasid;
+}
+
+static void adiBenchRun(adi_bench_rw_t rw,
+                        struct adf_adi_ep *pAdi,
+                        const adi_bench_state_t *pState,
+                        u64 pos,
+                        unsigned int len,
+                        bool isWrite,
+                        u32 val,
+                        adi_bench_outcome_t *pOut)
+{
+    u32 buf[2] = {val, val};
+    u32 i;
+
+    adiBenchApply(pAdi, pState);
+    adiBenchLogLen = 0;
+    adiBenchLogging = true;
+    pOut->ret = rw(pAdi, pos, buf, len, isWrite);
+    adiBenchLogging = false;
+
+    pOut->buf = buf[0];
+    pOut->resetComplete = pAdi->reset_complete;
+    pOut->pasid = pAdi->pasid;
+    pOut->numAccesses = adiBenchLogLen;
+    for (i = 0; i < adiBenchLogLen && i < ADI_BENCH_MAX_ACCESSES; i++)
+    {
+        pOut->accesses[i] = adiBenchLog[i];
+        /* Put the register back for the next access */
+        if (adiBenchLog[i].isWrite && adiBenchLog[i].base == adiBenchEtr)
+        {
+            adiBenchEtr[adiBenchLog[i].offset / sizeof(u32)] =
+                adiBenchResetValue(adiBenchLog[i].offset);
+        }
+    }
+}
+
+static bool adiBenchSame(const adi_bench_outcome_t *pA,
+                         const adi_bench_outcome_t *pB)
+{
+    u32 i;
+
+    if (pA->ret != pB->ret || pA->buf != pB->buf ||
+        pA->resetComplete != pB->resetComplete || pA->pasid != pB->pasid ||
+        pA->numAccesses != pB->numAccesses ||
+        pA->numAccesses > ADI_BENCH_MAX_ACCESSES)
+    {
+        return false;
+    }
+    for (i = 0; i < pA->numAccesses; i++)
+    {
+        if (pA->accesses[i].base != pB->accesses[i].base ||
+            pA->accesses[i].offset != pB->accesses[i].offset ||
+            pA->accesses[i].val != pB->accesses[i].val ||
+            pA->accesses[i].isWrite != pB->accesses[i].isWrite)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Compares one access through the switch and the table in every state,
+ * returns the number of mismatches */
+static u32 adiBenchCompare(struct adf_adi_ep *pAdi,
+                           u64 pos,
+                           unsigned int len,
+                           u64 *pCompared,
+                           u64 *pAccepted)
+{
+    adi_bench_outcome_t before;
+    adi_bench_outcome_t after;
+    adi_bench_state_t state;
+    u32 mismatches = 0;
+    u32 s, v;
+
+    for (s = 0; s < 16; s++)
+    {
+        state.resetComplete = s & 1;
+        state.resetDone = (s >> 1) & 1;
+        state.hwPasid = (s & 4) ? 0x55 : 0;
+        state.pasid = (s & 8) ? 7 : 0;
+        for (v = 0; v <= ARRAY_SIZE(adiBenchWriteVals); v++)
+        {
+            bool isWrite = v < ARRAY_SIZE(adiBenchWriteVals);
+            u32 val = isWrite ? adiBenchWriteVals[v] : 0xa5a5a5a5;
+
+            memset(&before, 0, sizeof(before));
+            memset(&after, 0, sizeof(after));
+            adiBenchRun(gen4_adi_mmio_rw32_switch, pAdi, &state, pos, len,
+                        isWrite, val, &before);
+            adiBenchRun(gen4_adi_mmio_rw32, pAdi, &state, pos, len,
+                        isWrite, val, &after);
+            (*pCompared)++;
+            if (before.ret >= 0)
+            {
+                (*pAccepted)++;
+            }
+            if (!adiBenchSame(&before, &after))
+            {
+                if (mismatches++ < 4)
+                {
+                    printf("Mismatch: bank %u pos 0x%llx len %u %s 0x%x "
+                           "state %u: switch %d, table %d\n",
+                           pAdi->bank_idx, (unsigned long long)pos, len,
+                           isWrite ? "write" : "read", val, s, before.ret,
+                           after.ret);
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+static double adiBenchTrapNs(adi_bench_rw_t rw,
+                             struct adf_adi_ep *pAdi,
+                             const u64 *pPositions,
+                             bool isWrite)
+{
+    mb_result_t res;
+    u32 i = 0;
+    u32 buf = 0;
+    int sum = 0;
+
+    MB_MEASURE(res, 1024, {
+        sum += rw(pAdi, pPositions[i++ & 1023], &buf, 4, isWrite);
+    });
+    MB_KEEP(sum);
+    return mbNsPerOp(&res);
+}
+
+int main(int argc, char **argv)
+{
+    static const u32 banks[] = {0, 17, 63};
+    struct adf_hw_device_data hwData;
+    struct adf_accel_dev accelDev;
+    struct adf_adi_ep adi;
+    struct adf_adi_ops *pOps = NULL;
+    static u64 ringPositions[1024];
+    static u64 badPositions[1024];
+    u64 compared = 0;
+    u64 accepted = 0;
+    u32 mismatches = 0;
+    u32 b, i, l;
+    u64 pos;
+
+    if (argc > 1)
+    {
+        printf("Usage: adi_vreg_bench\n");
+        return 1;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(adiBenchEtr); i++)
+    {
+        adiBenchEtr[i] = adiBenchResetValue(i * sizeof(u32));
+    }
+    for (i = 0; i <= ADI_BENCH_NUM_BANKS; i++)
+    {
+        adiBenchMisc[ADF_4XXX_MSIX_RTTABLE_OFFSET(i) / sizeof(u32)] = i;
+    }
+
+    memset(&hwData, 0, sizeof(hwData));
+    hwData.get_misc_bar_id = adiBenchMiscBarId;
+    hwData.get_etr_bar_id = adiBenchEtrBarId;
+    hwData.num_banks = ADI_BENCH_NUM_BANKS;
+    memset(&accelDev, 0, sizeof(accelDev));
+    accelDev.hw_device = &hwData;
+    accelDev.bars[ADI_BENCH_ETR_BAR].virt_addr = adiBenchEtr;
+    accelDev.bars[ADI_BENCH_ETR_BAR].size = ADI_BENCH_ETR_SIZE;
+    accelDev.bars[ADI_BENCH_MISC_BAR].virt_addr = adiBenchMisc;
+    accelDev.bars[ADI_BENCH_MISC_BAR].size = ADI_BENCH_MISC_SIZE;
+    gen4_init_adi_ops(&pOps);
+
+    for (b = 0; b < ARRAY_SIZE(banks); b++)
+    {
+        memset(&adi, 0, sizeof(adi));
+        adi.parent = &accelDev;
+        adi.bank_idx = banks[b];
+        adi.adi_idx = banks[b];
+        if (pOps->init(&adi))
+        {
+            printf("ADI init failed for bank %u\n", banks[b]);
+            return 1;
+        }
+
+        for (pos = 0; pos < ADI_BENCH_SWEEP; pos++)
+        {
+            mismatches += adiBenchCompare(&adi, pos, 4, &compared, &accepted);
+        }
+        for (i = 0; i < ADI_BENCH_NUM_VREGS; i++)
+        {
+            /* Positions sharing the slot of a vreg */
+            mismatches += adiBenchCompare(&adi,
+                                          adiBenchVregs[i] + ADI_BENCH_SWEEP,
+                                          4,
+                                          &compared,
+                                          &accepted);
+            mismatches += adiBenchCompare(&adi,
+                                          adiBenchVregs[i] + 0x10000,
+                                          4,
+                                          &compared,
+                                          &accepted);
+            mismatches += adiBenchCompare(&adi,
+                                          adiBenchVregs[i] | (1ULL << 32),
+                                          4,
+                                          &compared,
+                                          &accepted);
+            for (l = 0; l < ARRAY_SIZE(adiBenchBadLens); l++)
+            {
+                mismatches += adiBenchCompare(&adi,
+                                              adiBenchVregs[i],
+                                              adiBenchBadLens[l],
+                                              &compared,
+                                              &accepted);
+            }
+        }
+        if (b + 1 < ARRAY_SIZE(banks))
+        {
+            pOps->destroy(&adi);
+        }
+    }
+
+    printf("%llu accesses compared, %llu accepted, %u mismatches\n",
+           (unsigned long long)compared, (unsigned long long)accepted,
+           mismatches);
+    if (mismatches)
+    {
+        return 1;
+    }
+
+    /* The ADI of the last bank is kept for the timing */
+    srand(1);
+    for (i = 0; i < 1024; i++)
+    {
+        ringPositions[i] = adiBenchVregs[rand() % ADI_BENCH_NUM_RING_VREGS];
+        do
+        {
+            pos = (u64)(rand() % ADI_BENCH_SWEEP) & ~3ULL;
+        } while (adiBenchIsVreg(pos));
+        badPositions[i] = pos;
+    }
+
+    printf("\n%8s | %10s | %10s\n", "trap", "switch ns", "table ns");
+    printf("%8s | %10.1f | %10.1f\n",
+           "read",
+           adiBenchTrapNs(gen4_adi_mmio_rw32_switch, &adi, ringPositions,
+                          false),
+           adiBenchTrapNs(gen4_adi_mmio_rw32, &adi, ringPositions, false));
+    printf("%8s | %10.1f | %10.1f\n",
+           "write",
+           adiBenchTrapNs(gen4_adi_mmio_rw32_switch, &adi, ringPositions,
+                          true),
+           adiBenchTrapNs(gen4_adi_mmio_rw32, &adi, ringPositions, true));
+    printf("%8s | %10.1f | %10.1f\n",
+           "rejected",
+           adiBenchTrapNs(gen4_adi_mmio_rw32_switch, &adi, badPositions,
+                          false),
+           adiBenchTrapNs(gen4_adi_mmio_rw32, &adi, badPositions, false));
+
+    pOps->destroy(&adi);
+    return 0;
+}
@@ -0,0 +1,365 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file cookie_bench.c
+ *
+ * @description
+ *     Cache misses of the completion of a compression request, for the
+ *     current layout of dc_compression_cookie_t and the layout it had
+ *     before its fields were grouped by access pattern.
+ *
+ *     A batch of cookies is prepared as on submission, the lines of the
+ *     data integrity CRC block are flushed as the device write would
+ *     invalidate them, then every cookie is completed in random order,
+ *     reading the fields that dcCompression_CommonProcessCallback reads on
+ *     the traditional API path. The batch is larger than the L2 cache, so
+ *     the lines of a cookie are cold when it completes.
+ *
+ *     L1D and last level cache read misses are counted with
+ *     perf_event_open where the kernel exposes the counters; the number
+ *     of lines read per completion is computed from the layout.
+ *
+ *****************************************************************************/
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "micro_bench.h"
+#include "cpa.h"
+#include "lac_common.h"
+#include "dc_session.h"
+#include "dc_datapath.h"
+
+#define COOKIE_BENCH_COOKIES 8192
+#define COOKIE_BENCH_ROUNDS 20
+#define COOKIE_BENCH_LINE LAC_64BYTE_ALIGNMENT
+
+/* dc_compression_cookie_t before its fields were grouped */
+typedef struct dc_cookie_before_s
+{
+    Cpa8U dcReqParamsBuffer[DC_API_ALIGNMENT_OFFSET];
+    CpaDcRqResults reserved;
+    CpaInstanceHandle dcInstance;
+    CpaDcSessionHandle pSessionHandle;
+    icp_qat_fw_comp_req_t request;
+    void *callbackTag;
+    dc_session_desc_t *pSessionDesc;
+    CpaDcFlush flushFlag;
+    CpaDcOpData *pDcOpData;
+    CpaDcRqResults *pResults;
+    Cpa32U srcTotalDataLenInBytes;
+    Cpa32U dstTotalDataLenInBytes;
+    dc_request_dir_t compDecomp;
+    CpaBufferList *pUserSrcBuff;
+    CpaBufferList *pUserDestBuff;
+    CpaDcCallbackFn pCbFunc;
+    CpaDcChecksum checksumType;
+    dc_integrity_crc_fw_t dataIntegrityCrcs;
+    dc_chain_info_t dcChain;
+    CpaBoolean cnvSwVerify;
+    dc_cnv_work_t cnvWork;
+    void *pDictWrap;
+    dc_precheck_result_t precheck;
+} dc_cookie_before_t;
+
+/* Bit of every line spanned by a field */
+#define COOKIE_BENCH_LINES(type, field)                                        \
+    (((2ULL << ((offsetof(type, field) + sizeof(((type *)0)->field) - 1) /     \
+                COOKIE_BENCH_LINE)) -                                          \
+      1) &                                                                     \
+     ~((1ULL << (offsetof(type, field) / COOKIE_BENCH_LINE)) - 1))
+
+/* Lines read by a completion */
+#define COOKIE_BENCH_READ_LINES(type)                                          \
+    (COOKIE_BENCH_LINES(type, dcInstance) |                                    \
+     COOKIE_BENCH_LINES(type, pSessionHandle) |                                \
+     COOKIE_BENCH_LINES(type, callbackTag) |                                   \
+     COOKIE_BENCH_LINES(type, pSessionDesc) |                                  \
+     COOKIE_BENCH_LINES(type, compDecomp) |                                    \
+     COOKIE_BENCH_LINES(type, pDcOpData) |                                     \
+     COOKIE_BENCH_LINES(type, pResults) |                                      \
+     COOKIE_BENCH_LINES(type, flushFlag) |                                     \
+     COOKIE_BENCH_LINES(type, dcChain.isDcChaining) |                          \
+     COOKIE_BENCH_LINES(type, pDictWrap) |                                     \
+     COOKIE_BENCH_LINES(type, precheck) |                                      \
+     COOKIE_BENCH_LINES(type, cnvSwVerify))
+
+/* Lines the CPU writes on submission, besides the request */
+#define COOKIE_BENCH_CPU_LINES(type)                                           \
+    (COOKIE_BENCH_READ_LINES(type) | COOKIE_BENCH_LINES(type, pCbFunc) |       \
+     COOKIE_BENCH_LINES(type, pUserSrcBuff) |                                  \
+     COOKIE_BENCH_LINES(type, pUserDestBuff) |                                 \
+     COOKIE_BENCH_LINES(type, srcTotalDataLenInBytes) |                        \
+     COOKIE_BENCH_LINES(type, dstTotalDataLenInBytes) |                        \
+     COOKIE_BENCH_LINES(type, checksumType))
+
+/* Fills the cookie as dcCreateRequest, flushes the lines the device
+ * writes */
+#define COOKIE_BENCH_SUBMIT(type, pCookie, i)                                  \
+    do                                                                         \
+    {                                                                          \
+        Cpa8U *pCrc_ = (Cpa8U *)&(pCookie)->dataIntegrityCrcs;                 \
+        Cpa32U off_;                                                           \
+        (pCookie)->dcInstance = (CpaInstanceHandle)(uintptr_t)(i);             \
+        (pCookie)->pSessionHandle = (CpaDcSessionHandle)(uintptr_t)(i);        \
+        (pCookie)->callbackTag = (void *)(uintptr_t)(i);                       \
+        (pCookie)->pSessionDesc = (dc_session_desc_t *)(uintptr_t)(i);         \
+        (pCookie)->compDecomp = DC_COMPRESSION_REQUEST;                        \
+        (pCookie)->pDcOpData = NULL;                                           \
+        (pCookie)->pResults = (CpaDcRqResults *)(uintptr_t)(i);                \
+        (pCookie)->flushFlag = CPA_DC_FLUSH_FINAL;                             \
+        (pCookie)->dcChain.isDcChaining = CPA_FALSE;                           \
+        (pCookie)->pDictWrap = NULL;                                           \
+        (pCookie)->precheck = DC_PRECHECK_NONE;                                \
+        (pCookie)->cnvSwVerify = CPA_FALSE;                                    \
+        (pCookie)->pCbFunc = NULL;                                             \
+        (pCookie)->pUserSrcBuff = NULL;                                        \
+        (pCookie)->pUserDestBuff = NULL;                                       \
+        (pCookie)->srcTotalDataLenInBytes = (Cpa32U)(i);                       \
+        (pCookie)->dstTotalDataLenInBytes = (Cpa32U)(i);                       \
+        (pCookie)->checksumType = CPA_DC_CRC32;                                \
+        memset(&(pCookie)->request, (int)(i), sizeof((pCookie)->request));     \
+        for (off_ = 0; off_ < sizeof((pCookie)->dataIntegrityCrcs);            \
+             off_ += COOKIE_BENCH_LINE)                                        \
+        {                                                                      \
+            _mm_clflush(pCrc_ + off_);                                         \
+        }                                                                      \
+        _mm_clflush(pCrc_ + sizeof((pCookie)->dataIntegrityCrcs) - 1);         \
+    } while (0)
+
+/* Reads the fields of the cookie read on completion */
+#define COOKIE_BENCH_COMPLETE(pCookie)                                         \
+    ((uintptr_t)(pCookie)->dcInstance + (uintptr_t)(pCookie)->pSessionHandle + \
+     (uintptr_t)(pCookie)->callbackTag + (uintptr_t)(pCookie)->pSessionDesc +  \
+     (uintptr_t)(pCookie)->compDecomp + (uintptr_t)(pCookie)->pDcOpData +      \
+     (uintptr_t)(pCookie)->pResults + (uintptr_t)(pCookie)->flushFlag +        \
+     (uintptr_t)(pCookie)->dcChain.isDcChaining +                              \
+     (uintptr_t)(pCookie)->pDictWrap + (uintptr_t)(pCookie)->precheck +        \
+     (uintptr_t)(pCookie)->cnvSwVerify)
+
+/* Counters of the completion loop, -1 where not available */
+typedef struct cookie_bench_counters_s
+{
+    int fd[2];
+    uint64_t value[2];
+} cookie_bench_counters_t;
+
+static int cookieBenchOpen(Cpa32U cache)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void cookieBenchStart(cookie_bench_counters_t *pCounters)
+{
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (pCounters->fd[i] >= 0)
+        {
+            ioctl(pCounters->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+static void cookieBenchStop(cookie_bench_counters_t *pCounters)
+{
+    uint64_t value;
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (pCounters->fd[i] >= 0)
+        {
+            ioctl(pCounters->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (sizeof(value) == read(pCounters->fd[i], &value, sizeof(value)))
+            {
+                pCounters->value[i] = value;
+            }
+            ioctl(pCounters->fd[i], PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+}
+
+static Cpa32U cookieBenchOrder[COOKIE_BENCH_COOKIES];
+
+/* Random permutation of the cookies, the completion order */
+static void cookieBenchShuffle(void)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    Cpa32U i;
+    Cpa32U j;
+    Cpa32U tmp;
+
+    for (i = 0; i < COOKIE_BENCH_COOKIES; i++)
+    {
+        cookieBenchOrder[i] = i;
+    }
+    for (i = COOKIE_BENCH_COOKIES - 1; i > 0; i--)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        j = (Cpa32U)(state % (i + 1));
+        tmp = cookieBenchOrder[i];
+        cookieBenchOrder[i] = cookieBenchOrder[j];
+        cookieBenchOrder[j] = tmp;
+    }
+}
+
+/*
+ * Runs the submit and complete rounds on cookies of the given type laid
+ * out as by Lac_MemPoolCreate: 64 byte aligned, with the block header of
+ * the pool in front of each.
+ */
+#define COOKIE_BENCH_RUN(type, name)                                           \
+    do                                                                         \
+    {                                                                          \
+        const size_t stride_ =                                                 \
+            LAC_ALIGN_POW2_ROUNDUP(sizeof(type), COOKIE_BENCH_LINE) +          \
+            COOKIE_BENCH_LINE;                                                 \
+        Cpa8U *pMem_ = NULL;                                                   \
+        uint64_t ns_ = 0;                                                      \
+        uint64_t start_;                                                       \
+        uintptr_t sum_ = 0;                                                    \
+        Cpa32U r_;                                                             \
+        Cpa32U i_;                                                             \
+        if (0 != posix_memalign((void **)&pMem_,                               \
+                                COOKIE_BENCH_LINE,                             \
+                                stride_ * COOKIE_BENCH_COOKIES))               \
+        {                                                                      \
+            return 1;                                                          \
+        }                                                                      \
+        counters.value[0] = counters.value[1] = 0;                             \
+        for (r_ = 0; r_ < COOKIE_BENCH_ROUNDS; r_++)                           \
+        {                                                                      \
+            uint64_t l1_ = counters.value[0];                                  \
+            uint64_t ll_ = counters.value[1];                                  \
+            for (i_ = 0; i_ < COOKIE_BENCH_COOKIES; i_++)                      \
+            {                                                                  \
+                type *pCookie_ =                                               \
+                    (type *)(pMem_ + i_ * stride_ + COOKIE_BENCH_LINE);        \
+                COOKIE_BENCH_SUBMIT(type, pCookie_, i_ + 1);                   \
+            }                                                                  \
+            start_ = mbNowNs();                                                \
+            cookieBenchStart(&counters);                                       \
+            for (i_ = 0; i_ < COOKIE_BENCH_COOKIES; i_++)                      \
+            {                                                                  \
+                type *pCookie_ =                                               \
+                    (type *)(pMem_ + cookieBenchOrder[i_] * stride_ +          \
+                             COOKIE_BENCH_LINE);                               \
+                sum_ += COOKIE_BENCH_COMPLETE(pCookie_);                       \
+            }                                                                  \
+            cookieBenchStop(&counters);                                        \
+            ns_ += mbNowNs() - start_;                                         \
+            counters.value[0] += l1_;                                          \
+            counters.value[1] += ll_;                                          \
+        }                                                                      \
+        MB_KEEP(sum_);                                                         \
+        free(pMem_);                                                           \
+        printf("%-7s | %5zu | %10d | %10d | %8.1f | ",                        \
+               name,                                                           \
+               sizeof(type),                                                   \
+               __builtin_popcountll(COOKIE_BENCH_READ_LINES(type)),            \
+               __builtin_popcountll(COOKIE_BENCH_LINES(type, request)),        \
+               (double)ns_ / (COOKIE_BENCH_ROUNDS * COOKIE_BENCH_COOKIES));    \
+        cookieBenchPrintMisses(&counters);                                     \
+        printf(" | %s\n",                                                      \
+               (COOKIE_BENCH_LINES(type, dataIntegrityCrcs) &                  \
+                COOKIE_BENCH_CPU_LINES(type))                                  \
+                   ? "yes"                                                     \
+                   : "no");                                                    \
+    } while (0)
+
+static void cookieBenchPrintMisses(const cookie_bench_counters_t *pCounters)
+{
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (pCounters->fd[i] < 0)
+        {
+            printf("%s%8s", i ? " | " : "", "n/a");
+        }
+        else
+        {
+            printf("%s%8.2f",
+                   i ? " | " : "",
+                   (double)pCounters->value[i] /
+                       (COOKIE_BENCH_ROUNDS * COOKIE_BENCH_COOKIES));
+        }
+    }
+}
+
+int main(void)
+{
+    cookie_bench_counters_t counters;
+
+    counters.fd[0] = cookieBenchOpen(PERF_COUNT_HW_CACHE_L1D);
+    counters.fd[1] = cookieBenchOpen(PERF_COUNT_HW_CACHE_LL);
+    if ((counters.fd[0] < 0) || (counters.fd[1] < 0))
+    {
+        printf("Cache miss counters not available, misses shown as n/a\n\n");
+    }
+    cookieBenchShuffle();
+
+    printf("%-7s | %5s | %10s | %10s | %8s | %8s | %8s | %s\n",
+           "layout",
+           "size",
+           "read lines",
+           "req lines",
+           "ns",
+           "L1D miss",
+           "LLC miss",
+           "CRC line shared");
+    COOKIE_BENCH_RUN(dc_cookie_before_t, "before");
+    COOKIE_BENCH_RUN(dc_compression_cookie_t, "current");
+    return 0;
+}
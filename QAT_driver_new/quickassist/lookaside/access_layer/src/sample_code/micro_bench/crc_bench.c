@@ -0,0 +1,187 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file crc_bench.c
+ *
+ * @description
+ *     Software checksum kernels used on the compression completion path:
+ *       - crc32_gzip_refl_by8 / crc64_ecma_norm_by8, the PCLMULQDQ kernels
+ *       - dcCrc32GzipRefl / dcCrc64EcmaNorm, the runtime dispatched kernels
+ *         (VPCLMULQDQ/AVX-512 folding when the CPU has it)
+ *       - dcCalculateProgCrc64, the slice-by-8 programmable CRC-64,
+ *         against a byte-at-a-time table loop as used before
+ *     Results of the kernels being compared are cross checked.
+ *
+ *     Usage: crc_bench [max buffer size in bytes]
+ *
+ *****************************************************************************/
+
+#include "micro_bench.h"
+#include "dc_crc32.h"
+#include "dc_crc64.h"
+
+#define CRC_BENCH_MAX_SIZE (1024 * 1024)
+#define CRC_BENCH_BATCH 16
+#define CRC_ECMA_POLY 0x42F0E1EBA9EA3693ULL
+
+/* Byte-at-a-time programmable CRC-64, the loop slice-by-8 replaced */
+static uint64_t crcBenchByteLoop(const uint64_t *pTable,
+                                 const uint8_t *pData,
+                                 uint64_t len,
+                                 uint64_t crc)
+{
+    uint64_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        crc = (crc << 8) ^ pTable[((crc >> 56) ^ pData[i]) & 0xFF];
+    }
+    return crc;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint64_t sizes[] = {
+        64, 256, 1024, 4096, 16384, 65536, 262144, 1048576};
+    uint64_t maxSize = CRC_BENCH_MAX_SIZE;
+    uint8_t *pData = NULL;
+    Cpa64U *pTable = NULL;
+    CpaCrcControlData crcConfig = {0};
+    CpaFlatBuffer flatBuffer;
+    CpaBufferList bufferList;
+    mb_result_t r32old, r32new, r64old, r64new, rProgOld, rProgNew;
+    uint32_t c32old = 0, c32new = 0;
+    uint64_t c64old = 0, c64new = 0, cProgOld = 0, cProgNew = 0;
+    unsigned int i;
+    uint64_t j;
+    int mismatch = 0;
+
+    if (argc > 1)
+    {
+        maxSize = strtoull(argv[1], NULL, 0);
+    }
+
+    pData = malloc(CRC_BENCH_MAX_SIZE);
+    if (NULL == pData)
+    {
+        return 1;
+    }
+    for (j = 0; j < CRC_BENCH_MAX_SIZE; j++)
+    {
+        pData[j] = (uint8_t)(j * 2654435761U >> 13);
+    }
+    if (CPA_STATUS_SUCCESS != dcGenerateLookupTable(CRC_ECMA_POLY, &pTable))
+    {
+        free(pData);
+        return 1;
+    }
+    crcConfig.polynomial = CRC_ECMA_POLY;
+    bufferList.numBuffers = 1;
+    bufferList.pBuffers = &flatBuffer;
+    flatBuffer.pData = pData;
+
+    printf("%8s | %-21s | %-21s | %-21s\n",
+           "bytes",
+           "crc32 by8 -> disp",
+           "crc64 by8 -> disp",
+           "prog64 byte -> sl8");
+    printf("%8s | %-21s | %-21s | %-21s\n", "", "GB/s", "GB/s", "GB/s");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        const uint64_t len = sizes[i];
+
+        if (len > maxSize || len > CRC_BENCH_MAX_SIZE)
+        {
+            break;
+        }
+        flatBuffer.dataLenInBytes = (Cpa32U)len;
+
+        MB_MEASURE(r32old, CRC_BENCH_BATCH,
+                   c32old = crc32_gzip_refl_by8(c32old, pData, len));
+        MB_MEASURE(r32new, CRC_BENCH_BATCH,
+                   c32new = dcCrc32GzipRefl(c32new, pData, len));
+        MB_MEASURE(r64old, CRC_BENCH_BATCH,
+                   c64old = crc64_ecma_norm_by8(c64old, pData, len));
+        MB_MEASURE(r64new, CRC_BENCH_BATCH,
+                   c64new = dcCrc64EcmaNorm(c64new, pData, len));
+        MB_MEASURE(rProgOld, 1,
+                   cProgOld = crcBenchByteLoop(pTable, pData, len, cProgOld));
+        MB_MEASURE(rProgNew, 1, {
+            crcConfig.initialValue = cProgNew;
+            dcCalculateProgCrc64(
+                &crcConfig, pTable, &bufferList, (Cpa32U)len, &cProgNew);
+        });
+
+        /* Same seed, same data: the compared kernels must agree */
+        if (crc32_gzip_refl_by8(1, pData, len) !=
+                dcCrc32GzipRefl(1, pData, len) ||
+            crc64_ecma_norm_by8(1, pData, len) !=
+                dcCrc64EcmaNorm(1, pData, len))
+        {
+            mismatch = 1;
+        }
+        crcConfig.initialValue = 1;
+        dcCalculateProgCrc64(
+            &crcConfig, pTable, &bufferList, (Cpa32U)len, &cProgNew);
+        if (crcBenchByteLoop(pTable, pData, len, 1) != cProgNew)
+        {
+            mismatch = 1;
+        }
+
+        printf("%8llu | %8.2f -> %8.2f   | %8.2f -> %8.2f   | "
+               "%8.2f -> %8.2f\n",
+               (unsigned long long)len,
+               mbGBps(&r32old, len),
+               mbGBps(&r32new, len),
+               mbGBps(&r64old, len),
+               mbGBps(&r64new, len),
+               mbGBps(&rProgOld, len),
+               mbGBps(&rProgNew, len));
+    }
+    MB_KEEP(c32old + c32new);
+    MB_KEEP(c64old + c64new + cProgOld + cProgNew);
+
+    if (mismatch)
+    {
+        printf("ERROR: kernel results differ\n");
+    }
+    LAC_OS_FREE(pTable);
+    free(pData);
+    return mismatch;
+}
@@ -0,0 +1,389 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file dict_bench.c
+ *
+ * @description
+ *     Compression ratio and throughput of Deflate sessions with a preset
+ *     dictionary, on 1KB, 2KB and 4KB slices of a corpus. The first 32KB
+ *     of the corpus are the dictionary and the slices are cut from the
+ *     data after it. Every slice is compressed on its own as a stateless
+ *     request by:
+ *       - dict: dcDictCompress on a session with the dictionary, the
+ *         software encoder every compression of such a session runs
+ *       - no dict: the same encoder with a one byte dictionary, which
+ *         leaves it nothing to match
+ *       - zlib -1: zlib at level 1 without the dictionary, standing in for
+ *         the dynamic Huffman output of the device on a session without one
+ *       - zlib -1 dict: zlib at level 1 with the dictionary
+ *     The ratio is the input size over the output size. The output of the
+ *     dictionary encoder is inflated by zlib with the dictionary and
+ *     compared with the slice.
+ *
+ *     The dictionary is held in pinned memory from the usdm driver
+ *     emulation of usdm_emu.c, so no driver or device is needed.
+ *
+ *     Without a file argument synthetic JSON log records are used. Pass a
+ *     file of a corpus, e.g. Silesia, to report on real data.
+ *
+ *     Usage: dict_bench [file]
+ *
+ *****************************************************************************/
+
+#include <zlib.h>
+#include "micro_bench.h"
+#include "usdm_emu.h"
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "lac_common.h"
+#include "lac_sal_types.h"
+#include "sal_types_compression.h"
+#include "dc_session.h"
+#include "dc_dict.h"
+
+#define DICT_BENCH_DICT_LEN (32 * 1024)
+#define DICT_BENCH_MAX_SLICES 256
+#define DICT_BENCH_SYNTH_LEN (2 * 1024 * 1024)
+/* Room for a stored block of the largest slice */
+#define DICT_BENCH_OUT_SIZE (8 * 1024)
+
+/* Encoder under test, see the file description */
+typedef enum dict_bench_coder_e
+{
+    DICT_BENCH_DICT = 0,
+    DICT_BENCH_NO_DICT,
+    DICT_BENCH_ZLIB,
+    DICT_BENCH_ZLIB_DICT,
+    DICT_BENCH_CODERS
+} dict_bench_coder_t;
+
+static const char *dictBenchCoderNames[DICT_BENCH_CODERS] = {
+    "dict", "no dict", "zlib -1", "zlib -1 dict"};
+
+/* Session of the software encoder */
+typedef struct dict_bench_session_s
+{
+    dc_session_desc_t desc;
+    LAC_ARCH_UINT handle;
+} dict_bench_session_t;
+
+/* State shared by the slices of a run */
+typedef struct dict_bench_ctx_s
+{
+    const Cpa8U *pDict;
+    dict_bench_session_t *pSession[2];
+    z_stream zs;
+    Cpa8U out[DICT_BENCH_OUT_SIZE];
+    Cpa8U check[DICT_BENCH_OUT_SIZE];
+} dict_bench_ctx_t;
+
+static Cpa8U *dictBenchSynth(size_t *pLen)
+{
+    static const char *levels[] = {"INFO", "WARN", "ERROR", "DEBUG"};
+    static const char *services[] = {
+        "auth", "billing", "gateway", "inventory", "search", "storage"};
+    static const char *messages[] = {"request completed",
+                                     "cache miss, loading from backend",
+                                     "user session refreshed",
+                                     "retrying upstream call",
+                                     "payload validation failed",
+                                     "connection pool exhausted"};
+    Cpa8U *pData = malloc(DICT_BENCH_SYNTH_LEN + 512);
+    size_t len = 0;
+    unsigned int t = 1700000000;
+
+    if (NULL == pData)
+    {
+        return NULL;
+    }
+    srand(1);
+    while (len < DICT_BENCH_SYNTH_LEN)
+    {
+        t += rand() % 3;
+        len += snprintf((char *)pData + len,
+                        512,
+                        "{\"timestamp\":%u,\"level\":\"%s\",\"service\":\"%s\","
+                        "\"user_id\":%d,\"latency_ms\":%d,\"message\":\"%s\","
+                        "\"trace\":\"%08x%08x\"}\n",
+                        t,
+                        levels[rand() % 4],
+                        services[rand() % 6],
+                        rand() % 100000,
+                        rand() % 2000,
+                        messages[rand() % 6],
+                        (unsigned int)rand(),
+                        (unsigned int)rand());
+    }
+    *pLen = len;
+    return pData;
+}
+
+static Cpa8U *dictBenchLoad(const char *pPath, size_t *pLen)
+{
+    FILE *pFile = fopen(pPath, "rb");
+    Cpa8U *pData = NULL;
+    long size;
+
+    if (NULL == pFile)
+    {
+        return NULL;
+    }
+    fseek(pFile, 0, SEEK_END);
+    size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    if (size > 0)
+    {
+        pData = malloc(size);
+    }
+    if (NULL != pData)
+    {
+        *pLen = fread(pData, 1, size, pFile);
+    }
+    fclose(pFile);
+    return pData;
+}
+
+static dict_bench_session_t *
+dictBenchSession(sal_compression_service_t *pService,
+                 const Cpa8U *pDict,
+                 Cpa32U dictLen)
+{
+    dict_bench_session_t *pSession = calloc(1, sizeof(*pSession));
+
+    if (NULL == pSession)
+    {
+        return NULL;
+    }
+    pSession->desc.compType = CPA_DC_DEFLATE;
+    pSession->desc.sessState = CPA_DC_STATELESS;
+    pSession->desc.sessDirection = CPA_DC_DIR_COMBINED;
+    pSession->desc.checksumType = CPA_DC_CRC32;
+    pSession->desc.requestType = DC_REQUEST_FIRST;
+    pSession->handle = (LAC_ARCH_UINT)&pSession->desc;
+    if (CPA_STATUS_SUCCESS !=
+        dcSetDictionary(pService, &pSession->handle, pDict, dictLen, 0))
+    {
+        free(pSession);
+        return NULL;
+    }
+    return pSession;
+}
+
+/* Compresses one slice, returns the output length or 0 on failure */
+static Cpa32U dictBenchCompress(dict_bench_ctx_t *pCtx,
+                                dict_bench_coder_t coder,
+                                const Cpa8U *pSlice,
+                                Cpa32U len)
+{
+    CpaFlatBuffer srcFlat;
+    CpaFlatBuffer dstFlat;
+    CpaBufferList src;
+    CpaBufferList dst;
+    CpaDcRqResults results;
+    z_stream *pZs = &pCtx->zs;
+
+    if (DICT_BENCH_ZLIB <= coder)
+    {
+        deflateReset(pZs);
+        if (DICT_BENCH_ZLIB_DICT == coder)
+        {
+            deflateSetDictionary(pZs, pCtx->pDict, DICT_BENCH_DICT_LEN);
+        }
+        pZs->next_in = (Bytef *)pSlice;
+        pZs->avail_in = len;
+        pZs->next_out = pCtx->out;
+        pZs->avail_out = sizeof(pCtx->out);
+        if (Z_STREAM_END != deflate(pZs, Z_FINISH))
+        {
+            return 0;
+        }
+        return (Cpa32U)pZs->total_out;
+    }
+
+    srcFlat.pData = (Cpa8U *)pSlice;
+    srcFlat.dataLenInBytes = len;
+    dstFlat.pData = pCtx->out;
+    dstFlat.dataLenInBytes = sizeof(pCtx->out);
+    memset(&src, 0, sizeof(src));
+    memset(&dst, 0, sizeof(dst));
+    src.numBuffers = 1;
+    src.pBuffers = &srcFlat;
+    dst.numBuffers = 1;
+    dst.pBuffers = &dstFlat;
+    memset(&results, 0, sizeof(results));
+    if ((CPA_STATUS_SUCCESS !=
+         dcDictCompress(&pCtx->pSession[coder]->desc,
+                        &src,
+                        &dst,
+                        &results,
+                        CPA_DC_FLUSH_FINAL)) ||
+        (CPA_DC_OK != results.status))
+    {
+        return 0;
+    }
+    return results.produced;
+}
+
+/* Inflates the output of the dictionary encoder and compares it */
+static int dictBenchCheck(dict_bench_ctx_t *pCtx,
+                          Cpa32U outLen,
+                          const Cpa8U *pSlice,
+                          Cpa32U len)
+{
+    z_stream zs;
+    int ret;
+
+    memset(&zs, 0, sizeof(zs));
+    if (Z_OK != inflateInit2(&zs, -15))
+    {
+        return -1;
+    }
+    inflateSetDictionary(&zs, pCtx->pDict, DICT_BENCH_DICT_LEN);
+    zs.next_in = pCtx->out;
+    zs.avail_in = outLen;
+    zs.next_out = pCtx->check;
+    zs.avail_out = sizeof(pCtx->check);
+    ret = inflate(&zs, Z_FINISH);
+    inflateEnd(&zs);
+    if ((Z_STREAM_END != ret) || (zs.total_out != len) ||
+        (0 != memcmp(pCtx->check, pSlice, len)))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static const Cpa32U sliceSizes[] = {1024, 2048, 4096};
+    static dict_bench_ctx_t ctx;
+    sal_compression_service_t service;
+    Cpa8U *pData = NULL;
+    size_t dataLen = 0;
+    unsigned int s;
+    unsigned int c;
+
+    if (argc > 2)
+    {
+        printf("Usage: dict_bench [file]\n");
+        return 1;
+    }
+    pData = (argc > 1) ? dictBenchLoad(argv[1], &dataLen)
+                       : dictBenchSynth(&dataLen);
+    if ((NULL == pData) ||
+        (dataLen < DICT_BENCH_DICT_LEN + sliceSizes[0]))
+    {
+        printf("Cannot read %s or shorter than %u bytes\n",
+               (argc > 1) ? argv[1] : "synthetic data",
+               DICT_BENCH_DICT_LEN + sliceSizes[0]);
+        return 1;
+    }
+    if (0 != usdmEmuInit(NULL))
+    {
+        printf("usdm emulation failed\n");
+        return 1;
+    }
+
+    memset(&service, 0, sizeof(service));
+    service.generic_service_info.type = SAL_SERVICE_TYPE_COMPRESSION;
+    ctx.pDict = pData;
+    ctx.pSession[DICT_BENCH_DICT] =
+        dictBenchSession(&service, pData, DICT_BENCH_DICT_LEN);
+    ctx.pSession[DICT_BENCH_NO_DICT] = dictBenchSession(&service, pData, 1);
+    if ((NULL == ctx.pSession[DICT_BENCH_DICT]) ||
+        (NULL == ctx.pSession[DICT_BENCH_NO_DICT]) ||
+        (Z_OK != deflateInit2(&ctx.zs, 1, Z_DEFLATED, -15, 8,
+                              Z_DEFAULT_STRATEGY)))
+    {
+        printf("Session setup failed\n");
+        return 1;
+    }
+
+    printf("%6s | %12s | %6s | %8s\n", "slice", "encoder", "ratio", "MB/s");
+    for (s = 0; s < sizeof(sliceSizes) / sizeof(sliceSizes[0]); s++)
+    {
+        Cpa32U len = sliceSizes[s];
+        Cpa32U numSlices = (dataLen - DICT_BENCH_DICT_LEN) / len;
+        const Cpa8U *pSlices = pData + DICT_BENCH_DICT_LEN;
+
+        if (numSlices > DICT_BENCH_MAX_SLICES)
+        {
+            numSlices = DICT_BENCH_MAX_SLICES;
+        }
+        if (0 == numSlices)
+        {
+            continue;
+        }
+        for (c = 0; c < DICT_BENCH_CODERS; c++)
+        {
+            Cpa64U outTotal = 0;
+            Cpa32U outLen = 0;
+            Cpa32U i = 0;
+            mb_result_t res;
+
+            for (i = 0; i < numSlices; i++)
+            {
+                outLen = dictBenchCompress(&ctx, c, pSlices + i * len, len);
+                if ((0 == outLen) ||
+                    ((DICT_BENCH_DICT == c) &&
+                     (0 != dictBenchCheck(&ctx, outLen, pSlices + i * len,
+                                          len))))
+                {
+                    printf("%s failed on slice %u of %u bytes\n",
+                           dictBenchCoderNames[c], i, len);
+                    return 1;
+                }
+                outTotal += outLen;
+            }
+            i = 0;
+            MB_MEASURE(res, numSlices, {
+                MB_KEEP(dictBenchCompress(&ctx, c, pSlices + i * len, len));
+                i = (i + 1 == numSlices) ? 0 : i + 1;
+            });
+            printf("%6u | %12s | %6.2f | %8.1f\n",
+                   len,
+                   dictBenchCoderNames[c],
+                   (double)numSlices * len / (double)outTotal,
+                   mbGBps(&res, len) * 1000.0);
+        }
+    }
+
+    deflateEnd(&ctx.zs);
+    return 0;
+}
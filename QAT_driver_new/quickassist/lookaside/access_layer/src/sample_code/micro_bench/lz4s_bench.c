@@ -0,0 +1,920 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file lz4s_bench.c
+ *
+ * @description
+ *     LZ4 frames from CPA_DC_LZ4S streams, icp_sal_DcStream* with the LZ4s
+ *     output of every chunk converted into an LZ4 block on the worker
+ *     threads of the library, against LZ4 in software on the calling
+ *     thread. The instance is emulated: the cpaDc calls made by the stream
+ *     are redirected with the linker's --wrap option to engine threads
+ *     which produce the LZ4s sequences a device would. The emulated engines
+ *     and the software LZ4 encoder share one greedy match finder, in the
+ *     manner of LZ4_compress_default, so both produce the same matches and
+ *     the difference in time is that of the pipeline.
+ *     Three measurements are made:
+ *       - software: LZ4 blocks of the chunk size encoded in sequence
+ *       - convert: icp_sal_DcLZ4SToLZ4Block alone on one thread, the CPU
+ *         cost of the post-processing for each byte a real device
+ *         compresses
+ *       - stream: the end to end throughput of an LZ4S stream against the
+ *         number of engines of the emulated instance
+ *     The frames of the stream are decoded and compared with the source.
+ *     On a host with fewer cores than engines plus worker threads the
+ *     stream rows measure the scheduler rather than the pipeline.
+ *
+ *     Without a file argument synthetic text is used. Pass a file of a
+ *     corpus, e.g. Silesia, to report on real data.
+ *
+ *     Usage: lz4s_bench [file]
+ *
+ *****************************************************************************/
+
+#include <pthread.h>
+#include "micro_bench.h"
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "icp_sal_poll.h"
+#include "icp_sal_dc_lz4s.h"
+#include "icp_sal_dc_stream.h"
+#include "lac_common.h"
+#include "lac_sal_types.h"
+#include "sal_service_state.h"
+#include "sal_types_compression.h"
+
+#define LZ4S_BENCH_SYNTH_LEN (32 * 1024 * 1024)
+#define LZ4S_BENCH_CHUNK_SIZE (64 * 1024)
+#define LZ4S_BENCH_IN_FLIGHT 16
+#define LZ4S_BENCH_WRITE_SIZE (1024 * 1024)
+#define LZ4S_BENCH_MAX_ENGINES 8
+#define LZ4S_BENCH_REPEATS 3
+
+/* Match finder */
+#define LZ4S_BENCH_HASH_BITS 12
+#define LZ4S_BENCH_MIN_MATCH 4
+#define LZ4S_BENCH_MAX_DIST 65535
+/* Match length bias of the LZ4s and LZ4 sequence formats */
+#define LZ4S_BENCH_LZ4S_BIAS 2
+#define LZ4S_BENCH_LZ4_BIAS 4
+/* End of block rules of the LZ4 block format */
+#define LZ4S_BENCH_LZ4_MF_LIMIT 12
+#define LZ4S_BENCH_LZ4_LAST_LITERALS 5
+
+/* LZ4 frame format */
+#define LZ4S_BENCH_FRAME_MAGIC 0x184D2204U
+#define LZ4S_BENCH_FLG_CONTENT_SIZE 0x08
+#define LZ4S_BENCH_FLG_BLOCK_CKSUM 0x10
+#define LZ4S_BENCH_FLG_CONTENT_CKSUM 0x04
+#define LZ4S_BENCH_FLG_DICT_ID 0x01
+#define LZ4S_BENCH_BLOCK_UNCOMPRESSED 0x80000000U
+
+/* Request queued to the emulated instance */
+typedef struct lz4s_bench_req_s
+{
+    struct lz4s_bench_req_s *pNext;
+    CpaDcCallbackFn pCbFn;
+    void *pCbTag;
+    CpaBufferList *pSrc;
+    CpaBufferList *pDst;
+    CpaDcRqResults *pResults;
+} lz4s_bench_req_t;
+
+/* Emulated instance, the service must come first as it is the handle */
+typedef struct lz4s_bench_instance_s
+{
+    sal_compression_service_t service;
+    pthread_t threads[LZ4S_BENCH_MAX_ENGINES];
+    Cpa32U numEngines;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    lz4s_bench_req_t *pQueue;
+    lz4s_bench_req_t **ppQueueTail;
+    lz4s_bench_req_t *pDone;
+    lz4s_bench_req_t **ppDoneTail;
+    int stop;
+} lz4s_bench_instance_t;
+
+typedef struct lz4s_bench_out_s
+{
+    Cpa8U *pData;
+    Cpa64U size;
+    Cpa64U len;
+} lz4s_bench_out_t;
+
+static lz4s_bench_instance_t lz4sBenchInstance;
+static uint64_t lz4sBenchRandState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t lz4sBenchRand(void)
+{
+    lz4sBenchRandState ^= lz4sBenchRandState << 13;
+    lz4sBenchRandState ^= lz4sBenchRandState >> 7;
+    lz4sBenchRandState ^= lz4sBenchRandState << 17;
+    return lz4sBenchRandState;
+}
+
+/* Words drawn from a small vocabulary */
+static void lz4sBenchFillText(Cpa8U *pData, size_t len)
+{
+    static const char *words[] = { "the ",     "device ",  "request ",
+                                   "buffer ",  "session ", "of ",
+                                   "and ",     "stream ",  "compress ",
+                                   "data ",    "to ",      "instance\n" };
+    size_t pos = 0;
+    size_t wlen;
+    const char *pWord;
+
+    while (pos < len)
+    {
+        pWord = words[lz4sBenchRand() % (sizeof(words) / sizeof(*words))];
+        wlen = strlen(pWord);
+        if (wlen > len - pos)
+        {
+            wlen = len - pos;
+        }
+        memcpy(pData + pos, pWord, wlen);
+        pos += wlen;
+    }
+}
+
+static Cpa8U *lz4sBenchLoad(const char *pPath, size_t *pLen)
+{
+    FILE *pFile = fopen(pPath, "rb");
+    Cpa8U *pData = NULL;
+    long size;
+
+    if (NULL == pFile)
+    {
+        return NULL;
+    }
+    fseek(pFile, 0, SEEK_END);
+    size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    if (size > 0)
+    {
+        pData = malloc(size);
+    }
+    if (NULL != pData)
+    {
+        *pLen = fread(pData, 1, size, pFile);
+    }
+    fclose(pFile);
+    return pData;
+}
+
+static inline Cpa32U lz4sBenchRead32(const Cpa8U *p)
+{
+    Cpa32U v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static Cpa8U *lz4sBenchWriteLength(Cpa8U *pOut, Cpa32U length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        *pOut++ = 255;
+    }
+    *pOut++ = (Cpa8U)length;
+    return pOut;
+}
+
+/*
+ * Writes a sequence of litLen literals followed by a match, or the last
+ * literals of the data when matchLen is zero. bias is the match length
+ * bias of the format.
+ */
+static Cpa8U *lz4sBenchWriteSeq(Cpa8U *pOut,
+                                const Cpa8U *pLit,
+                                Cpa32U litLen,
+                                Cpa32U offset,
+                                Cpa32U matchLen,
+                                Cpa32U bias)
+{
+    Cpa8U *pToken = pOut++;
+    Cpa32U mlCode = (0 == matchLen) ? 0 : matchLen - bias;
+
+    *pToken = (Cpa8U)(((litLen < 15) ? litLen : 15) << 4);
+    if (litLen >= 15)
+    {
+        pOut = lz4sBenchWriteLength(pOut, litLen - 15);
+    }
+    memcpy(pOut, pLit, litLen);
+    pOut += litLen;
+    if (0 == matchLen)
+    {
+        return pOut;
+    }
+    *pOut++ = (Cpa8U)offset;
+    *pOut++ = (Cpa8U)(offset >> 8);
+    *pToken |= (Cpa8U)((mlCode < 15) ? mlCode : 15);
+    if (mlCode >= 15)
+    {
+        pOut = lz4sBenchWriteLength(pOut, mlCode - 15);
+    }
+    return pOut;
+}
+
+/*
+ * Greedy single probe match finder. Produces LZ4s sequences, as the
+ * device does, or an LZ4 block when lz4Block is set, which also applies
+ * the end of block rules of the LZ4 format. Returns the output length.
+ */
+static Cpa32U lz4sBenchEncode(const Cpa8U *pSrc,
+                              Cpa32U srcLen,
+                              Cpa8U *pDst,
+                              int lz4Block)
+{
+    static __thread Cpa32U table[1U << LZ4S_BENCH_HASH_BITS];
+    Cpa32U bias = lz4Block ? LZ4S_BENCH_LZ4_BIAS : LZ4S_BENCH_LZ4S_BIAS;
+    Cpa32U matchLimit =
+        lz4Block ? srcLen - LZ4S_BENCH_LZ4_LAST_LITERALS : srcLen;
+    Cpa32U limit = lz4Block ? LZ4S_BENCH_LZ4_MF_LIMIT : LZ4S_BENCH_MIN_MATCH;
+    Cpa8U *pOut = pDst;
+    Cpa32U anchor = 0;
+    Cpa32U pos = 0;
+    Cpa32U cand;
+    Cpa32U len;
+    Cpa32U h;
+
+    /* Positions are stored plus one so that zero is empty */
+    memset(table, 0, sizeof(table));
+    if (srcLen > limit)
+    {
+        limit = srcLen - limit;
+        while (pos < limit)
+        {
+            h = (lz4sBenchRead32(pSrc + pos) * 2654435761U) >>
+                (32 - LZ4S_BENCH_HASH_BITS);
+            cand = table[h];
+            table[h] = pos + 1;
+            if ((0 == cand) || (pos - (cand - 1) > LZ4S_BENCH_MAX_DIST) ||
+                (lz4sBenchRead32(pSrc + cand - 1) !=
+                 lz4sBenchRead32(pSrc + pos)))
+            {
+                pos++;
+                continue;
+            }
+            cand--;
+            len = LZ4S_BENCH_MIN_MATCH;
+            while ((pos + len < matchLimit) &&
+                   (pSrc[cand + len] == pSrc[pos + len]))
+            {
+                len++;
+            }
+            pOut = lz4sBenchWriteSeq(pOut,
+                                     pSrc + anchor,
+                                     pos - anchor,
+                                     pos - cand,
+                                     len,
+                                     bias);
+            pos += len;
+            anchor = pos;
+        }
+    }
+    pOut = lz4sBenchWriteSeq(
+        pOut, pSrc + anchor, srcLen - anchor, 0, 0, bias);
+    return (Cpa32U)(pOut - pDst);
+}
+
+/* Decodes an LZ4 block, returns the output length or -1 */
+static long lz4sBenchDecodeBlock(const Cpa8U *pIn,
+                                 Cpa32U inLen,
+                                 Cpa8U *pOut,
+                                 Cpa32U outSize)
+{
+    const Cpa8U *pEnd = pIn + inLen;
+    Cpa32U out = 0;
+    Cpa32U len;
+    Cpa32U offset;
+    Cpa8U token;
+    Cpa8U byte;
+
+    while (pIn < pEnd)
+    {
+        token = *pIn++;
+        len = token >> 4;
+        if (15 == len)
+        {
+            do
+            {
+                if (pIn >= pEnd)
+                {
+                    return -1;
+                }
+                byte = *pIn++;
+                len += byte;
+            } while (255 == byte);
+        }
+        if ((len > (Cpa32U)(pEnd - pIn)) || (len > outSize - out))
+        {
+            return -1;
+        }
+        memcpy(pOut + out, pIn, len);
+        pIn += len;
+        out += len;
+        if (pIn == pEnd)
+        {
+            break;
+        }
+        if (pEnd - pIn < 2)
+        {
+            return -1;
+        }
+        offset = pIn[0] | (pIn[1] << 8);
+        pIn += 2;
+        len = token & 15;
+        if (15 == len)
+        {
+            do
+            {
+                if (pIn >= pEnd)
+                {
+                    return -1;
+                }
+                byte = *pIn++;
+                len += byte;
+            } while (255 == byte);
+        }
+        len += LZ4S_BENCH_LZ4_BIAS;
+        if ((0 == offset) || (offset > out) || (len > outSize - out))
+        {
+            return -1;
+        }
+        /* Byte by byte as the match may overlap its own output */
+        for (; len > 0; len--, out++)
+        {
+            pOut[out] = pOut[out - offset];
+        }
+    }
+    return out;
+}
+
+/* Decodes an LZ4 frame, returns the output length or -1 */
+static long lz4sBenchDecodeFrame(const Cpa8U *pIn,
+                                 Cpa64U inLen,
+                                 Cpa8U *pOut,
+                                 Cpa64U outSize)
+{
+    const Cpa8U *pEnd = pIn + inLen;
+    Cpa64U out = 0;
+    Cpa32U blockSize;
+    Cpa8U flg;
+    long len;
+
+    if ((inLen < 7) || (LZ4S_BENCH_FRAME_MAGIC != lz4sBenchRead32(pIn)))
+    {
+        return -1;
+    }
+    flg = pIn[4];
+    /* Magic, FLG, BD, optional fields and the header checksum */
+    pIn += 7;
+    pIn += (flg & LZ4S_BENCH_FLG_CONTENT_SIZE) ? 8 : 0;
+    pIn += (flg & LZ4S_BENCH_FLG_DICT_ID) ? 4 : 0;
+    for (;;)
+    {
+        if (pEnd - pIn < 4)
+        {
+            return -1;
+        }
+        blockSize = lz4sBenchRead32(pIn);
+        pIn += 4;
+        if (0 == blockSize)
+        {
+            break;
+        }
+        if ((blockSize & ~LZ4S_BENCH_BLOCK_UNCOMPRESSED) >
+            (Cpa64U)(pEnd - pIn))
+        {
+            return -1;
+        }
+        if (blockSize & LZ4S_BENCH_BLOCK_UNCOMPRESSED)
+        {
+            blockSize &= ~LZ4S_BENCH_BLOCK_UNCOMPRESSED;
+            if (blockSize > outSize - out)
+            {
+                return -1;
+            }
+            memcpy(pOut + out, pIn, blockSize);
+            len = blockSize;
+        }
+        else
+        {
+            len = lz4sBenchDecodeBlock(
+                pIn, blockSize, pOut + out, (Cpa32U)(outSize - out));
+            if (len < 0)
+            {
+                return -1;
+            }
+        }
+        pIn += blockSize;
+        pIn += (flg & LZ4S_BENCH_FLG_BLOCK_CKSUM) ? 4 : 0;
+        out += len;
+    }
+    pIn += (flg & LZ4S_BENCH_FLG_CONTENT_CKSUM) ? 4 : 0;
+    return (pIn == pEnd) ? (long)out : -1;
+}
+
+/* Compresses the requests of the emulated instance into LZ4s */
+static void *lz4sBenchEngineThread(void *pArg)
+{
+    lz4s_bench_instance_t *pInst = pArg;
+    lz4s_bench_req_t *pReq;
+    CpaDcRqResults *pResults;
+    Cpa32U srcLen;
+
+    pthread_mutex_lock(&pInst->lock);
+    for (;;)
+    {
+        while ((NULL == pInst->pQueue) && (0 == pInst->stop))
+        {
+            pthread_cond_wait(&pInst->cond, &pInst->lock);
+        }
+        if (NULL == pInst->pQueue)
+        {
+            break;
+        }
+        pReq = pInst->pQueue;
+        pInst->pQueue = pReq->pNext;
+        if (NULL == pInst->pQueue)
+        {
+            pInst->ppQueueTail = &pInst->pQueue;
+        }
+        pthread_mutex_unlock(&pInst->lock);
+
+        /* The destination is sized by the wrapped bound function */
+        srcLen = pReq->pSrc->pBuffers[0].dataLenInBytes;
+        pResults = pReq->pResults;
+        pResults->produced = lz4sBenchEncode(
+            pReq->pSrc->pBuffers[0].pData,
+            srcLen,
+            pReq->pDst->pBuffers[0].pData,
+            0);
+        pResults->consumed = srcLen;
+        pResults->endOfLastBlock = CPA_TRUE;
+        pResults->status = CPA_DC_OK;
+
+        pthread_mutex_lock(&pInst->lock);
+        pReq->pNext = NULL;
+        *pInst->ppDoneTail = pReq;
+        pInst->ppDoneTail = &pReq->pNext;
+    }
+    pthread_mutex_unlock(&pInst->lock);
+    return NULL;
+}
+
+static int lz4sBenchStart(Cpa32U numEngines)
+{
+    lz4s_bench_instance_t *pInst = &lz4sBenchInstance;
+    Cpa32U i;
+
+    memset(pInst, 0, sizeof(*pInst));
+    pInst->service.generic_service_info.type = SAL_SERVICE_TYPE_COMPRESSION;
+    pInst->service.generic_service_info.state = SAL_SERVICE_STATE_RUNNING;
+    pInst->ppQueueTail = &pInst->pQueue;
+    pInst->ppDoneTail = &pInst->pDone;
+    pthread_mutex_init(&pInst->lock, NULL);
+    pthread_cond_init(&pInst->cond, NULL);
+    for (i = 0; i < numEngines; i++)
+    {
+        if (0 != pthread_create(
+                     &pInst->threads[i], NULL, lz4sBenchEngineThread, pInst))
+        {
+            break;
+        }
+    }
+    pInst->numEngines = i;
+    return (i == numEngines) ? 0 : -1;
+}
+
+static void lz4sBenchStop(void)
+{
+    lz4s_bench_instance_t *pInst = &lz4sBenchInstance;
+    Cpa32U i;
+
+    pthread_mutex_lock(&pInst->lock);
+    pInst->stop = 1;
+    pthread_cond_broadcast(&pInst->cond);
+    pthread_mutex_unlock(&pInst->lock);
+    for (i = 0; i < pInst->numEngines; i++)
+    {
+        pthread_join(pInst->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pInst->cond);
+    pthread_mutex_destroy(&pInst->lock);
+}
+
+/*
+ * Replacements of the device and memory functions called by the
+ * stream, selected with -Wl,--wrap=<symbol>
+ */
+void *__wrap_qaeMemAllocNUMA(size_t size, int node, size_t alignment)
+{
+    void *pMem = NULL;
+
+    (void)node;
+    return (0 == posix_memalign(&pMem, alignment, size)) ? pMem : NULL;
+}
+
+void __wrap_qaeMemFreeNUMA(void **ptr)
+{
+    free(*ptr);
+    *ptr = NULL;
+}
+
+CpaStatus __wrap_cpaDcLZ4SCompressBound(const CpaInstanceHandle dcInstance,
+                                        Cpa32U inputSize,
+                                        Cpa32U *outputSize)
+{
+    (void)dcInstance;
+    /* A token and a length extension byte for every 255 literals */
+    *outputSize = inputSize + inputSize / 255 + 16;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcGetSessionSize(CpaInstanceHandle dcInstance,
+                                     CpaDcSessionSetupData *pSessionData,
+                                     Cpa32U *pSessionSize,
+                                     Cpa32U *pContextSize)
+{
+    (void)dcInstance;
+    (void)pSessionData;
+    *pSessionSize = sizeof(CpaDcCallbackFn);
+    *pContextSize = 0;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcInitSession(CpaInstanceHandle dcInstance,
+                                  CpaDcSessionHandle pSessionHandle,
+                                  CpaDcSessionSetupData *pSessionData,
+                                  CpaBufferList *pContextBuffer,
+                                  CpaDcCallbackFn callbackFn)
+{
+    (void)dcInstance;
+    (void)pSessionData;
+    (void)pContextBuffer;
+    *(CpaDcCallbackFn *)pSessionHandle = callbackFn;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcRemoveSession(const CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle)
+{
+    (void)dcInstance;
+    (void)pSessionHandle;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcBufferListGetMetaSize(const CpaInstanceHandle instance,
+                                            Cpa32U numBuffers,
+                                            Cpa32U *pSizeInBytes)
+{
+    (void)instance;
+    (void)numBuffers;
+    *pSizeInBytes = 0;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcCompressData2(CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle,
+                                    CpaBufferList *pSrcBuff,
+                                    CpaBufferList *pDestBuff,
+                                    CpaDcOpData *pOpData,
+                                    CpaDcRqResults *pResults,
+                                    void *callbackTag)
+{
+    lz4s_bench_instance_t *pInst = (lz4s_bench_instance_t *)dcInstance;
+    lz4s_bench_req_t *pReq = malloc(sizeof(*pReq));
+
+    (void)pOpData;
+    if (NULL == pReq)
+    {
+        return CPA_STATUS_RETRY;
+    }
+    pReq->pNext = NULL;
+    pReq->pCbFn = *(CpaDcCallbackFn *)pSessionHandle;
+    pReq->pCbTag = callbackTag;
+    pReq->pSrc = pSrcBuff;
+    pReq->pDst = pDestBuff;
+    pReq->pResults = pResults;
+
+    pthread_mutex_lock(&pInst->lock);
+    *pInst->ppQueueTail = pReq;
+    pInst->ppQueueTail = &pReq->pNext;
+    pthread_cond_signal(&pInst->cond);
+    pthread_mutex_unlock(&pInst->lock);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_icp_sal_DcPollInstance(CpaInstanceHandle instanceHandle,
+                                        Cpa32U response_quota)
+{
+    lz4s_bench_instance_t *pInst = (lz4s_bench_instance_t *)instanceHandle;
+    lz4s_bench_req_t *pReq;
+    lz4s_bench_req_t *pNext;
+
+    (void)response_quota;
+    pthread_mutex_lock(&pInst->lock);
+    pReq = pInst->pDone;
+    pInst->pDone = NULL;
+    pInst->ppDoneTail = &pInst->pDone;
+    pthread_mutex_unlock(&pInst->lock);
+
+    if (NULL == pReq)
+    {
+        return CPA_STATUS_RETRY;
+    }
+    for (; NULL != pReq; pReq = pNext)
+    {
+        pNext = pReq->pNext;
+        pReq->pCbFn(pReq->pCbTag, CPA_STATUS_SUCCESS);
+        free(pReq);
+    }
+    return CPA_STATUS_SUCCESS;
+}
+
+static CpaStatus lz4sBenchOutput(void *pOutputTag,
+                                 const Cpa8U *pData,
+                                 Cpa32U dataLen)
+{
+    lz4s_bench_out_t *pOut = pOutputTag;
+
+    if (pOut->len + dataLen > pOut->size)
+    {
+        return CPA_STATUS_FAIL;
+    }
+    memcpy(pOut->pData + pOut->len, pData, dataLen);
+    pOut->len += dataLen;
+    return CPA_STATUS_SUCCESS;
+}
+
+/* Compresses the source through an LZ4S stream, returns its status */
+static CpaStatus lz4sBenchStream(Cpa32U numEngines,
+                                 const Cpa8U *pSrc,
+                                 size_t srcLen,
+                                 lz4s_bench_out_t *pOut,
+                                 uint64_t *pNs)
+{
+    icp_sal_dc_stream_setup_t setup;
+    icp_sal_dc_stream_handle_t stream = NULL;
+    CpaStatus status;
+    uint64_t start;
+    size_t pos;
+    Cpa32U len;
+
+    if (0 != lz4sBenchStart(numEngines))
+    {
+        lz4sBenchStop();
+        return CPA_STATUS_FAIL;
+    }
+    memset(&setup, 0, sizeof(setup));
+    setup.compType = CPA_DC_LZ4S;
+    setup.checksum = CPA_DC_XXHASH32;
+    setup.compLevel = CPA_DC_L1;
+    setup.lz4BlockMaxSize = CPA_DC_LZ4_MAX_BLOCK_SIZE_64K;
+    setup.chunkSize = LZ4S_BENCH_CHUNK_SIZE;
+    setup.numInFlight = LZ4S_BENCH_IN_FLIGHT;
+    setup.pOutputFn = lz4sBenchOutput;
+    setup.pOutputTag = pOut;
+    pOut->len = 0;
+
+    start = mbNowNs();
+    status = icp_sal_DcStreamCreate(&lz4sBenchInstance, &setup, &stream);
+    for (pos = 0; (CPA_STATUS_SUCCESS == status) && (pos < srcLen);
+         pos += len)
+    {
+        len = (srcLen - pos < LZ4S_BENCH_WRITE_SIZE) ? srcLen - pos
+                                                     : LZ4S_BENCH_WRITE_SIZE;
+        status = icp_sal_DcStreamWrite(stream, pSrc + pos, len);
+    }
+    if (CPA_STATUS_SUCCESS == status)
+    {
+        status = icp_sal_DcStreamFinish(stream, NULL, NULL);
+    }
+    if (NULL != stream)
+    {
+        icp_sal_DcStreamDestroy(stream);
+    }
+    *pNs = mbNowNs() - start;
+
+    lz4sBenchStop();
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    static const Cpa32U engineCounts[] = { 1, 2, 4, 8 };
+    Cpa32U numChunks;
+    size_t srcLen = LZ4S_BENCH_SYNTH_LEN;
+    size_t bound;
+    Cpa8U *pSrc;
+    Cpa8U *pCheck;
+    Cpa8U *pLZ4S;
+    Cpa32U *pLZ4SLen;
+    lz4s_bench_out_t out;
+    Cpa64U outLen;
+    uint64_t start;
+    uint64_t ns;
+    uint64_t best;
+    CpaStatus status;
+    Cpa32U blockLen;
+    Cpa32U chunkLen;
+    Cpa32U i;
+    Cpa32U r;
+
+    if (argc > 2)
+    {
+        printf("Usage: lz4s_bench [file]\n");
+        return 1;
+    }
+    if (argc > 1)
+    {
+        pSrc = lz4sBenchLoad(argv[1], &srcLen);
+    }
+    else
+    {
+        pSrc = malloc(srcLen);
+        if (NULL != pSrc)
+        {
+            lz4sBenchFillText(pSrc, srcLen);
+        }
+    }
+    if ((NULL == pSrc) || (0 == srcLen))
+    {
+        printf("Cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    numChunks = (srcLen + LZ4S_BENCH_CHUNK_SIZE - 1) / LZ4S_BENCH_CHUNK_SIZE;
+    bound = (size_t)numChunks *
+            (ICP_SAL_DC_LZ4_BLOCK_BOUND(LZ4S_BENCH_CHUNK_SIZE) + 4) + 64;
+    out.size = bound;
+    out.pData = malloc(bound);
+    pCheck = malloc(srcLen);
+    pLZ4S = malloc(bound);
+    pLZ4SLen = malloc(numChunks * sizeof(*pLZ4SLen));
+    if ((NULL == out.pData) || (NULL == pCheck) || (NULL == pLZ4S) ||
+        (NULL == pLZ4SLen))
+    {
+        return 1;
+    }
+    printf("%zu bytes in chunks of %u KB, %u requests in flight\n\n",
+           srcLen,
+           LZ4S_BENCH_CHUNK_SIZE / 1024,
+           LZ4S_BENCH_IN_FLIGHT);
+    printf("%-10s | %7s | %9s | %8s | %5s\n",
+           "mode",
+           "engines",
+           "ms",
+           "MB/s",
+           "ratio");
+
+    /* Software LZ4, one block per chunk with its size field */
+    best = UINT64_MAX;
+    outLen = 0;
+    for (r = 0; r < LZ4S_BENCH_REPEATS; r++)
+    {
+        start = mbNowNs();
+        outLen = 0;
+        for (i = 0; i < numChunks; i++)
+        {
+            chunkLen = (i + 1 < numChunks)
+                           ? LZ4S_BENCH_CHUNK_SIZE
+                           : srcLen - (size_t)i * LZ4S_BENCH_CHUNK_SIZE;
+            blockLen = lz4sBenchEncode(pSrc + (size_t)i * LZ4S_BENCH_CHUNK_SIZE,
+                                       chunkLen,
+                                       out.pData + outLen + 4,
+                                       1);
+            memcpy(out.pData + outLen, &blockLen, sizeof(blockLen));
+            outLen += 4 + blockLen;
+        }
+        ns = mbNowNs() - start;
+        best = (ns < best) ? ns : best;
+    }
+    printf("%-10s | %7s | %9.1f | %8.1f | %5.2f\n",
+           "software",
+           "-",
+           best / 1e6,
+           srcLen * 1e3 / best,
+           (double)srcLen / outLen);
+
+    /* Post-processing alone, on LZ4s prepared for every chunk */
+    outLen = 0;
+    for (i = 0; i < numChunks; i++)
+    {
+        chunkLen = (i + 1 < numChunks)
+                       ? LZ4S_BENCH_CHUNK_SIZE
+                       : srcLen - (size_t)i * LZ4S_BENCH_CHUNK_SIZE;
+        pLZ4SLen[i] = lz4sBenchEncode(pSrc + (size_t)i * LZ4S_BENCH_CHUNK_SIZE,
+                                      chunkLen,
+                                      pLZ4S + outLen,
+                                      0);
+        outLen += pLZ4SLen[i];
+    }
+    best = UINT64_MAX;
+    for (r = 0; r < LZ4S_BENCH_REPEATS; r++)
+    {
+        Cpa64U lz4sPos = 0;
+
+        start = mbNowNs();
+        outLen = 0;
+        for (i = 0; i < numChunks; i++)
+        {
+            chunkLen = (i + 1 < numChunks)
+                           ? LZ4S_BENCH_CHUNK_SIZE
+                           : srcLen - (size_t)i * LZ4S_BENCH_CHUNK_SIZE;
+            if (CPA_STATUS_SUCCESS !=
+                icp_sal_DcLZ4SToLZ4Block(
+                    pSrc + (size_t)i * LZ4S_BENCH_CHUNK_SIZE,
+                    chunkLen,
+                    pLZ4S + lz4sPos,
+                    pLZ4SLen[i],
+                    out.pData,
+                    ICP_SAL_DC_LZ4_BLOCK_BOUND(LZ4S_BENCH_CHUNK_SIZE),
+                    &blockLen))
+            {
+                printf("LZ4s conversion failed on chunk %u\n", i);
+                return 1;
+            }
+            lz4sPos += pLZ4SLen[i];
+            outLen += 4 + blockLen;
+        }
+        ns = mbNowNs() - start;
+        best = (ns < best) ? ns : best;
+    }
+    printf("%-10s | %7s | %9.1f | %8.1f | %5.2f\n",
+           "convert",
+           "-",
+           best / 1e6,
+           srcLen * 1e3 / best,
+           (double)srcLen / outLen);
+
+    for (i = 0; i < sizeof(engineCounts) / sizeof(engineCounts[0]); i++)
+    {
+        best = UINT64_MAX;
+        for (r = 0; r < LZ4S_BENCH_REPEATS; r++)
+        {
+            status = lz4sBenchStream(engineCounts[i], pSrc, srcLen, &out, &ns);
+            if ((CPA_STATUS_SUCCESS != status) ||
+                (lz4sBenchDecodeFrame(out.pData, out.len, pCheck, srcLen) !=
+                 (long)srcLen) ||
+                (0 != memcmp(pCheck, pSrc, srcLen)))
+            {
+                printf("LZ4S stream failed, status %d\n", status);
+                return 1;
+            }
+            best = (ns < best) ? ns : best;
+        }
+        printf("%-10s | %7u | %9.1f | %8.1f | %5.2f\n",
+               "stream",
+               engineCounts[i],
+               best / 1e6,
+               srcLen * 1e3 / best,
+               (double)srcLen / out.len);
+    }
+
+    free(pLZ4SLen);
+    free(pLZ4S);
+    free(pCheck);
+    free(out.pData);
+    free(pSrc);
+    return 0;
+}
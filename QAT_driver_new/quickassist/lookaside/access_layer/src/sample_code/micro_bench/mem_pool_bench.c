@@ -0,0 +1,346 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file mem_pool_bench.c
+ *
+ * @description
+ *     Contention of Lac_MemPoolEntryAlloc and Lac_MemPoolEntryFree with 1
+ *     to 64 threads. The sharded pool of the library is compared with a
+ *     single lock-free stack and shared free count, as every pool used
+ *     before the free lists were sharded:
+ *       - local: each thread allocates a batch of blocks and frees it
+ *       - handoff: threads work in pairs, one allocating blocks and the
+ *         other freeing them, as a request cookie allocated on submit and
+ *         freed by the polling thread
+ *
+ *     The blocks come from qaeMemAllocNUMA on slabs of the usdm driver
+ *     emulation of usdm_emu.c, so no driver or device is needed.
+ *
+ *     Usage: mem_pool_bench [driver|hugetlb|thp]
+ *
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "micro_bench.h"
+#include "usdm_emu.h"
+#include "cpa.h"
+#include "lac_common.h"
+#include "lac_mem_pools.h"
+#include "lac_lock_free_stack.h"
+
+#define POOL_BENCH_MAX_THREADS 64
+#define POOL_BENCH_BATCH 16
+#define POOL_BENCH_RING 64
+#define POOL_BENCH_BLOCKS 4096
+/* Size of a compression request cookie */
+#define POOL_BENCH_BLOCK_SIZE 384
+
+/* Pool header before sharding: one stack and one count for all threads */
+typedef struct pool_bench_global_s
+{
+    lock_free_stack_t stack;
+    volatile size_t availBlks;
+    CpaBoolean active;
+} __attribute__((aligned(LAC_64BYTE_ALIGNMENT))) pool_bench_global_t;
+
+static pool_bench_global_t poolBenchGlobal;
+static lac_memory_pool_id_t poolBenchPool = LAC_MEM_POOL_INIT_POOL_ID;
+static int poolBenchSharded = 1;
+static volatile int poolBenchStop = 0;
+
+static void *poolBenchAlloc(void)
+{
+    lac_mem_blk_t *pBlk = NULL;
+
+    if (poolBenchSharded)
+    {
+        return Lac_MemPoolEntryAlloc(poolBenchPool);
+    }
+
+    /* Lac_MemPoolEntryAlloc before sharding */
+    if (unlikely(poolBenchGlobal.active == CPA_FALSE))
+        return NULL;
+    pBlk = pop(&poolBenchGlobal.stack);
+    if (NULL == pBlk)
+        return (void *)CPA_STATUS_RETRY;
+    __sync_sub_and_fetch(&poolBenchGlobal.availBlks, 1);
+    pBlk->isInUse = CPA_TRUE;
+    return (void *)((LAC_ARCH_UINT)pBlk + sizeof(lac_mem_blk_t));
+}
+
+static void poolBenchFree(void *pEntry)
+{
+    lac_mem_blk_t *pBlk = NULL;
+
+    if (poolBenchSharded)
+    {
+        Lac_MemPoolEntryFree(pEntry);
+        return;
+    }
+
+    /* Lac_MemPoolEntryFree before sharding */
+    pBlk = (lac_mem_blk_t *)((LAC_ARCH_UINT)pEntry - sizeof(lac_mem_blk_t));
+    pBlk->isInUse = CPA_FALSE;
+    push(&poolBenchGlobal.stack, pBlk);
+    __sync_add_and_fetch(&poolBenchGlobal.availBlks, 1);
+}
+
+static int poolBenchValid(void *pEntry)
+{
+    return (NULL != pEntry) && ((void *)CPA_STATUS_RETRY != pEntry);
+}
+
+/* Moves every block of the pool to the single stack */
+static void poolBenchGlobalInit(void)
+{
+    void *pEntry;
+
+    poolBenchGlobal.stack = init_stack();
+    poolBenchGlobal.availBlks = 0;
+    poolBenchGlobal.active = CPA_TRUE;
+    while (poolBenchValid(pEntry = Lac_MemPoolEntryAlloc(poolBenchPool)))
+    {
+        poolBenchSharded = 0;
+        poolBenchFree(pEntry);
+    }
+}
+
+/* Returns the blocks of the single stack to the pool */
+static void poolBenchGlobalRelease(void)
+{
+    void *pEntry;
+
+    poolBenchSharded = 0;
+    while (poolBenchValid(pEntry = poolBenchAlloc()))
+    {
+        Lac_MemPoolEntryFree(pEntry);
+    }
+    poolBenchSharded = 1;
+}
+
+/* Single producer, single consumer ring of blocks to free */
+typedef struct pool_bench_ring_s
+{
+    void *volatile slot[POOL_BENCH_RING];
+    volatile uint64_t head;
+    volatile uint64_t tail;
+} pool_bench_ring_t;
+
+typedef struct pool_bench_worker_s
+{
+    pthread_t thread;
+    pool_bench_ring_t *pRing;
+    int producer;
+    uint64_t ops;
+} __attribute__((aligned(LAC_64BYTE_ALIGNMENT))) pool_bench_worker_t;
+
+static void *poolBenchLocal(void *pArg)
+{
+    pool_bench_worker_t *pWorker = pArg;
+    void *entries[POOL_BENCH_BATCH];
+    int n;
+    int i;
+
+    while (0 == poolBenchStop)
+    {
+        for (n = 0; n < POOL_BENCH_BATCH; n++)
+        {
+            entries[n] = poolBenchAlloc();
+            if (!poolBenchValid(entries[n]))
+            {
+                break;
+            }
+        }
+        for (i = 0; i < n; i++)
+        {
+            poolBenchFree(entries[i]);
+        }
+        pWorker->ops += n;
+    }
+    return NULL;
+}
+
+static void *poolBenchHandoff(void *pArg)
+{
+    pool_bench_worker_t *pWorker = pArg;
+    pool_bench_ring_t *pRing = pWorker->pRing;
+    void *pEntry;
+
+    while (0 == poolBenchStop)
+    {
+        if (pWorker->producer)
+        {
+            if (pRing->head - pRing->tail == POOL_BENCH_RING)
+            {
+                sched_yield();
+                continue;
+            }
+            pEntry = poolBenchAlloc();
+            if (!poolBenchValid(pEntry))
+            {
+                sched_yield();
+                continue;
+            }
+            pRing->slot[pRing->head % POOL_BENCH_RING] = pEntry;
+            __sync_synchronize();
+            pRing->head++;
+        }
+        else
+        {
+            if (pRing->tail == pRing->head)
+            {
+                sched_yield();
+                continue;
+            }
+            pEntry = pRing->slot[pRing->tail % POOL_BENCH_RING];
+            __sync_synchronize();
+            pRing->tail++;
+            poolBenchFree(pEntry);
+            pWorker->ops++;
+        }
+    }
+    return NULL;
+}
+
+/* Aggregate alloc and free pairs per microsecond of numThreads threads */
+static double poolBenchRun(int numThreads, void *(*pFunc)(void *))
+{
+    static pool_bench_worker_t workers[POOL_BENCH_MAX_THREADS];
+    static pool_bench_ring_t rings[POOL_BENCH_MAX_THREADS / 2];
+    uint64_t start;
+    uint64_t ops = 0;
+    void *pEntry;
+    int i;
+
+    memset(workers, 0, sizeof(workers));
+    memset(rings, 0, sizeof(rings));
+    poolBenchStop = 0;
+    start = mbNowNs();
+    for (i = 0; i < numThreads; i++)
+    {
+        workers[i].pRing = &rings[i / 2];
+        workers[i].producer = (0 == (i & 1));
+        pthread_create(&workers[i].thread, NULL, pFunc, &workers[i]);
+    }
+    while (mbNowNs() - start < MB_MIN_RUN_NS)
+    {
+        usleep(1000);
+    }
+    poolBenchStop = 1;
+    for (i = 0; i < numThreads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        ops += workers[i].ops;
+    }
+
+    /* Blocks still in flight between a pair */
+    for (i = 0; i < numThreads / 2; i++)
+    {
+        while (rings[i].tail != rings[i].head)
+        {
+            pEntry = rings[i].slot[rings[i].tail++ % POOL_BENCH_RING];
+            poolBenchFree(pEntry);
+        }
+    }
+    return (double)ops * 1000.0 / (double)(mbNowNs() - start);
+}
+
+int main(int argc, char **argv)
+{
+    static const int threads[] = { 1, 2, 4, 8, 16, 32, 64 };
+    static const char *poolNames[] = { "sharded", "single" };
+    double local;
+    unsigned int t;
+    int p;
+
+    if (0 != usdmEmuInit((argc > 1) ? argv[1] : NULL))
+    {
+        printf("Usage: mem_pool_bench [driver|hugetlb|thp]\n");
+        return 1;
+    }
+
+    if (CPA_STATUS_SUCCESS != Lac_MemPoolCreate(&poolBenchPool,
+                                                "bench",
+                                                POOL_BENCH_BLOCKS,
+                                                POOL_BENCH_BLOCK_SIZE,
+                                                LAC_64BYTE_ALIGNMENT,
+                                                CPA_FALSE,
+                                                0))
+    {
+        printf("Pool creation failed\n");
+        return 1;
+    }
+
+    printf("%-7s | %7s | %18s | %18s\n",
+           "pool",
+           "threads",
+           "local pairs/us",
+           "handoff pairs/us");
+    for (p = 0; p < 2; p++)
+    {
+        if (1 == p)
+        {
+            poolBenchGlobalInit();
+        }
+        for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+        {
+            local = poolBenchRun(threads[t], poolBenchLocal);
+            if (threads[t] < 2)
+            {
+                printf("%-7s | %7d | %18.2f | %18s\n",
+                       poolNames[p],
+                       threads[t],
+                       local,
+                       "-");
+                continue;
+            }
+            printf("%-7s | %7d | %18.2f | %18.2f\n",
+                   poolNames[p],
+                   threads[t],
+                   local,
+                   poolBenchRun(threads[t], poolBenchHandoff));
+        }
+    }
+    poolBenchGlobalRelease();
+
+    Lac_MemPoolDestroy(poolBenchPool);
+    return 0;
+}
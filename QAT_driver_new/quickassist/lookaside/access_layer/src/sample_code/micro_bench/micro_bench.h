@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file micro_bench.h
+ *
+ * @description
+ *     Timing and reporting helpers shared by the micro-benchmarks.
+ *
+ *****************************************************************************/
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <x86intrin.h>
+
+/* Minimum run time of a measured loop, in nanoseconds */
+#define MB_MIN_RUN_NS 200000000ULL
+
+static inline uint64_t mbNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t mbCycles(void)
+{
+    return __rdtsc();
+}
+
+/* Result of a measured loop */
+typedef struct mb_result_s
+{
+    uint64_t iterations;
+    uint64_t ns;
+    uint64_t cycles;
+} mb_result_t;
+
+/*
+ * Runs 'body' in batches of 'batch' iterations until at least
+ * MB_MIN_RUN_NS have elapsed and stores the totals in 'res'.
+ */
+#define MB_MEASURE(res, batch, body)                                           \
+    do                                                                         \
+    {                                                                          \
+        uint64_t mbStartNs_ = mbNowNs();                                       \
+        uint64_t mbStartCy_ = mbCycles();                                      \
+        uint64_t mbIter_ = 0;                                                  \
+        uint64_t mbI_ = 0;                                                     \
+        do                                                                     \
+        {                                                                      \
+            for (mbI_ = 0; mbI_ < (batch); mbI_++)                             \
+            {                                                                  \
+                body;                                                          \
+            }                                                                  \
+            mbIter_ += (batch);                                                \
+        } while (mbNowNs() - mbStartNs_ < MB_MIN_RUN_NS);                      \
+        (res).cycles = mbCycles() - mbStartCy_;                                \
+        (res).ns = mbNowNs() - mbStartNs_;                                     \
+        (res).iterations = mbIter_;                                            \
+    } while (0)
+
+static inline double mbNsPerOp(const mb_result_t *pRes)
+{
+    return (double)pRes->ns / (double)pRes->iterations;
+}
+
+static inline double mbCyclesPerOp(const mb_result_t *pRes)
+{
+    return (double)pRes->cycles / (double)pRes->iterations;
+}
+
+/* Throughput in GB/s for 'bytes' processed per iteration */
+static inline double mbGBps(const mb_result_t *pRes, uint64_t bytes)
+{
+    return (double)bytes * (double)pRes->iterations / (double)pRes->ns;
+}
+
+/* Keeps the compiler from discarding a computed value */
+#define MB_KEEP(v) __asm__ __volatile__("" : : "r"(v) : "memory")
+
+#endif /* MICRO_BENCH_H */
@@ -0,0 +1,594 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file par_decomp_bench.c
+ *
+ * @description
+ *     Parallel multi-member gzip decompression, icp_sal_DcParallelDecompress,
+ *     on emulated instances. The instance handles are fake compression
+ *     services whose requests are decompressed by one zlib thread each,
+ *     reporting the results a device would; the cpaDc calls made by the
+ *     front-end are redirected to them with the linker's --wrap option.
+ *     Three runs are made:
+ *       - scaling: throughput against the number of instances
+ *       - false boundaries: stored members holding a gzip header in their
+ *         data, which must be merged back with the member they cut
+ *       - corrupt: an invalid block type in the first member, which must
+ *         fail after the requests of one ring, not after merging every
+ *         following member into it
+ *     The output of the good runs is compared with the source data.
+ *
+ *     Usage: par_decomp_bench [members] [member size in KB]
+ *
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <zlib.h>
+#include "micro_bench.h"
+#include "cpa.h"
+#include "cpa_dc.h"
+#include "icp_sal_poll.h"
+#include "icp_sal_dc_par_decomp.h"
+#include "lac_common.h"
+#include "lac_sal_types.h"
+#include "sal_service_state.h"
+#include "sal_types_compression.h"
+
+#define PAR_BENCH_MEMBERS 64
+#define PAR_BENCH_MEMBER_KB 1024
+#define PAR_BENCH_IN_FLIGHT 2
+#define PAR_BENCH_REPEATS 3
+
+/* Gzip header written into the data of the false boundary members */
+static const Cpa8U parBenchFakeHeader[] = { 0x1F, 0x8B, 0x08, 0x00, 0x00,
+                                            0x00, 0x00, 0x00, 0x00, 0x03 };
+
+/* Request queued to an emulated instance */
+typedef struct par_bench_req_s
+{
+    struct par_bench_req_s *pNext;
+    CpaDcCallbackFn pCbFn;
+    void *pCbTag;
+    CpaBufferList *pSrc;
+    CpaBufferList *pDst;
+    CpaDcRqResults *pResults;
+} par_bench_req_t;
+
+/* Emulated instance, the service must come first as it is the handle */
+typedef struct par_bench_engine_s
+{
+    sal_compression_service_t service;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    par_bench_req_t *pQueue;
+    par_bench_req_t **ppQueueTail;
+    par_bench_req_t *pDone;
+    par_bench_req_t **ppDoneTail;
+    int stop;
+} par_bench_engine_t;
+
+typedef struct par_bench_out_s
+{
+    Cpa8U *pData;
+    Cpa64U size;
+    Cpa64U len;
+} par_bench_out_t;
+
+static par_bench_engine_t parBenchEngines[ICP_SAL_DC_PAR_MAX_INSTANCES];
+static volatile Cpa64U parBenchSubmitted = 0;
+static uint64_t parBenchRandState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t parBenchRand(void)
+{
+    parBenchRandState ^= parBenchRandState << 13;
+    parBenchRandState ^= parBenchRandState >> 7;
+    parBenchRandState ^= parBenchRandState << 17;
+    return parBenchRandState;
+}
+
+/* Words drawn from a small vocabulary, compresses about 3:1 */
+static void parBenchFillText(Cpa8U *pData, size_t len)
+{
+    static const char *words[] = { "the ",     "device ",  "request ",
+                                   "buffer ",  "session ", "of ",
+                                   "and ",     "stream ",  "compress ",
+                                   "data ",    "to ",      "instance\n" };
+    size_t pos = 0;
+    size_t wlen;
+    const char *pWord;
+
+    while (pos < len)
+    {
+        pWord = words[parBenchRand() % (sizeof(words) / sizeof(*words))];
+        wlen = strlen(pWord);
+        if (wlen > len - pos)
+        {
+            wlen = len - pos;
+        }
+        memcpy(pData + pos, pWord, wlen);
+        pos += wlen;
+    }
+}
+
+/* Decompresses the requests of one emulated instance */
+static void *parBenchEngineThread(void *pArg)
+{
+    par_bench_engine_t *pEngine = pArg;
+    par_bench_req_t *pReq;
+    CpaDcRqResults *pResults;
+    z_stream strm;
+    int ret;
+
+    memset(&strm, 0, sizeof(strm));
+    inflateInit2(&strm, -MAX_WBITS);
+
+    pthread_mutex_lock(&pEngine->lock);
+    for (;;)
+    {
+        while ((NULL == pEngine->pQueue) && (0 == pEngine->stop))
+        {
+            pthread_cond_wait(&pEngine->cond, &pEngine->lock);
+        }
+        if (NULL == pEngine->pQueue)
+        {
+            break;
+        }
+        pReq = pEngine->pQueue;
+        pEngine->pQueue = pReq->pNext;
+        if (NULL == pEngine->pQueue)
+        {
+            pEngine->ppQueueTail = &pEngine->pQueue;
+        }
+        pthread_mutex_unlock(&pEngine->lock);
+
+        inflateReset(&strm);
+        strm.next_in = pReq->pSrc->pBuffers[0].pData;
+        strm.avail_in = pReq->pSrc->pBuffers[0].dataLenInBytes;
+        strm.next_out = pReq->pDst->pBuffers[0].pData;
+        strm.avail_out = pReq->pDst->pBuffers[0].dataLenInBytes;
+        ret = inflate(&strm, Z_FINISH);
+
+        pResults = pReq->pResults;
+        pResults->consumed = strm.total_in;
+        pResults->produced = strm.total_out;
+        pResults->checksum = crc32(
+            0, pReq->pDst->pBuffers[0].pData, (uInt)strm.total_out);
+        pResults->endOfLastBlock = (Z_STREAM_END == ret) ? CPA_TRUE
+                                                         : CPA_FALSE;
+        if (Z_STREAM_END == ret)
+        {
+            pResults->status = CPA_DC_OK;
+        }
+        else if (Z_DATA_ERROR == ret)
+        {
+            pResults->status = CPA_DC_INVALID_CODE;
+        }
+        else if (0 == strm.avail_out)
+        {
+            pResults->status = CPA_DC_OVERFLOW;
+        }
+        else
+        {
+            /* No final block in a CPA_DC_FLUSH_FINAL request */
+            pResults->status = CPA_DC_INCOMPLETE_FILE_ERR;
+        }
+
+        pthread_mutex_lock(&pEngine->lock);
+        pReq->pNext = NULL;
+        *pEngine->ppDoneTail = pReq;
+        pEngine->ppDoneTail = &pReq->pNext;
+    }
+    pthread_mutex_unlock(&pEngine->lock);
+
+    inflateEnd(&strm);
+    return NULL;
+}
+
+static int parBenchStart(Cpa32U numEngines, CpaInstanceHandle *pInstances)
+{
+    par_bench_engine_t *pEngine;
+    Cpa32U i;
+
+    for (i = 0; i < numEngines; i++)
+    {
+        pEngine = &parBenchEngines[i];
+        memset(pEngine, 0, sizeof(*pEngine));
+        pEngine->service.generic_service_info.type = SAL_SERVICE_TYPE_COMPRESSION;
+        pEngine->service.generic_service_info.state = SAL_SERVICE_STATE_RUNNING;
+        pEngine->ppQueueTail = &pEngine->pQueue;
+        pEngine->ppDoneTail = &pEngine->pDone;
+        pthread_mutex_init(&pEngine->lock, NULL);
+        pthread_cond_init(&pEngine->cond, NULL);
+        if (0 != pthread_create(
+                     &pEngine->thread, NULL, parBenchEngineThread, pEngine))
+        {
+            return -1;
+        }
+        pInstances[i] = pEngine;
+    }
+    return 0;
+}
+
+static void parBenchStop(Cpa32U numEngines)
+{
+    par_bench_engine_t *pEngine;
+    Cpa32U i;
+
+    for (i = 0; i < numEngines; i++)
+    {
+        pEngine = &parBenchEngines[i];
+        pthread_mutex_lock(&pEngine->lock);
+        pEngine->stop = 1;
+        pthread_cond_signal(&pEngine->cond);
+        pthread_mutex_unlock(&pEngine->lock);
+        pthread_join(pEngine->thread, NULL);
+        pthread_cond_destroy(&pEngine->cond);
+        pthread_mutex_destroy(&pEngine->lock);
+    }
+}
+
+/*
+ * Replacements of the device and memory functions called by the
+ * front-end, selected with -Wl,--wrap=<symbol>
+ */
+void *__wrap_qaeMemAllocNUMA(size_t size, int node, size_t alignment)
+{
+    void *pMem = NULL;
+
+    (void)node;
+    return (0 == posix_memalign(&pMem, alignment, size)) ? pMem : NULL;
+}
+
+void __wrap_qaeMemFreeNUMA(void **ptr)
+{
+    free(*ptr);
+    *ptr = NULL;
+}
+
+CpaStatus __wrap_cpaDcGetSessionSize(CpaInstanceHandle dcInstance,
+                                     CpaDcSessionSetupData *pSessionData,
+                                     Cpa32U *pSessionSize,
+                                     Cpa32U *pContextSize)
+{
+    (void)dcInstance;
+    (void)pSessionData;
+    *pSessionSize = sizeof(CpaDcCallbackFn);
+    *pContextSize = 0;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcInitSession(CpaInstanceHandle dcInstance,
+                                  CpaDcSessionHandle pSessionHandle,
+                                  CpaDcSessionSetupData *pSessionData,
+                                  CpaBufferList *pContextBuffer,
+                                  CpaDcCallbackFn callbackFn)
+{
+    (void)dcInstance;
+    (void)pSessionData;
+    (void)pContextBuffer;
+    *(CpaDcCallbackFn *)pSessionHandle = callbackFn;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcRemoveSession(const CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle)
+{
+    (void)dcInstance;
+    (void)pSessionHandle;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcBufferListGetMetaSize(const CpaInstanceHandle instance,
+                                            Cpa32U numBuffers,
+                                            Cpa32U *pSizeInBytes)
+{
+    (void)instance;
+    (void)numBuffers;
+    *pSizeInBytes = 0;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_cpaDcDecompressData2(CpaInstanceHandle dcInstance,
+                                      CpaDcSessionHandle pSessionHandle,
+                                      CpaBufferList *pSrcBuff,
+                                      CpaBufferList *pDestBuff,
+                                      CpaDcOpData *pOpData,
+                                      CpaDcRqResults *pResults,
+                                      void *callbackTag)
+{
+    par_bench_engine_t *pEngine = (par_bench_engine_t *)dcInstance;
+    par_bench_req_t *pReq = malloc(sizeof(*pReq));
+
+    (void)pOpData;
+    if (NULL == pReq)
+    {
+        return CPA_STATUS_RETRY;
+    }
+    pReq->pNext = NULL;
+    pReq->pCbFn = *(CpaDcCallbackFn *)pSessionHandle;
+    pReq->pCbTag = callbackTag;
+    pReq->pSrc = pSrcBuff;
+    pReq->pDst = pDestBuff;
+    pReq->pResults = pResults;
+    parBenchSubmitted++;
+
+    pthread_mutex_lock(&pEngine->lock);
+    *pEngine->ppQueueTail = pReq;
+    pEngine->ppQueueTail = &pReq->pNext;
+    pthread_cond_signal(&pEngine->cond);
+    pthread_mutex_unlock(&pEngine->lock);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus __wrap_icp_sal_DcPollInstance(CpaInstanceHandle instanceHandle,
+                                        Cpa32U response_quota)
+{
+    par_bench_engine_t *pEngine = (par_bench_engine_t *)instanceHandle;
+    par_bench_req_t *pReq;
+    par_bench_req_t *pNext;
+
+    (void)response_quota;
+    pthread_mutex_lock(&pEngine->lock);
+    pReq = pEngine->pDone;
+    pEngine->pDone = NULL;
+    pEngine->ppDoneTail = &pEngine->pDone;
+    pthread_mutex_unlock(&pEngine->lock);
+
+    if (NULL == pReq)
+    {
+        return CPA_STATUS_RETRY;
+    }
+    for (; NULL != pReq; pReq = pNext)
+    {
+        pNext = pReq->pNext;
+        pReq->pCbFn(pReq->pCbTag, CPA_STATUS_SUCCESS);
+        free(pReq);
+    }
+    return CPA_STATUS_SUCCESS;
+}
+
+static CpaStatus parBenchOutput(void *pOutputTag,
+                                const Cpa8U *pData,
+                                Cpa32U dataLen)
+{
+    par_bench_out_t *pOut = pOutputTag;
+
+    if (pOut->len + dataLen > pOut->size)
+    {
+        return CPA_STATUS_FAIL;
+    }
+    memcpy(pOut->pData + pOut->len, pData, dataLen);
+    pOut->len += dataLen;
+    return CPA_STATUS_SUCCESS;
+}
+
+/* Gzips every member of the source on its own, returns the archive size */
+static size_t parBenchGzip(const Cpa8U *pSrc,
+                           size_t memberLen,
+                           Cpa32U members,
+                           int level,
+                           Cpa8U *pDst,
+                           size_t dstSize)
+{
+    z_stream strm;
+    size_t len = 0;
+    Cpa32U i;
+
+    for (i = 0; i < members; i++)
+    {
+        memset(&strm, 0, sizeof(strm));
+        if (Z_OK != deflateInit2(&strm,
+                                 level,
+                                 Z_DEFLATED,
+                                 MAX_WBITS + 16,
+                                 8,
+                                 Z_DEFAULT_STRATEGY))
+        {
+            return 0;
+        }
+        strm.next_in = (Bytef *)(pSrc + (size_t)i * memberLen);
+        strm.avail_in = memberLen;
+        strm.next_out = pDst + len;
+        strm.avail_out = dstSize - len;
+        if (Z_STREAM_END != deflate(&strm, Z_FINISH))
+        {
+            deflateEnd(&strm);
+            return 0;
+        }
+        len += strm.total_out;
+        deflateEnd(&strm);
+    }
+    return len;
+}
+
+/* Runs one decompression, returns its status and time */
+static CpaStatus parBenchRun(Cpa32U numEngines,
+                             const Cpa8U *pArchive,
+                             size_t archiveLen,
+                             par_bench_out_t *pOut,
+                             uint64_t *pNs)
+{
+    CpaInstanceHandle instances[ICP_SAL_DC_PAR_MAX_INSTANCES];
+    icp_sal_dc_par_decomp_setup_t setup;
+    Cpa64U produced = 0;
+    uint64_t start;
+    CpaStatus status;
+
+    if (0 != parBenchStart(numEngines, instances))
+    {
+        return CPA_STATUS_FAIL;
+    }
+    memset(&setup, 0, sizeof(setup));
+    setup.pInstances = instances;
+    setup.numInstances = numEngines;
+    setup.numInFlight = PAR_BENCH_IN_FLIGHT;
+    setup.pOutputFn = parBenchOutput;
+    setup.pOutputTag = pOut;
+    pOut->len = 0;
+
+    start = mbNowNs();
+    status = icp_sal_DcParallelDecompress(
+        &setup, pArchive, archiveLen, &produced);
+    *pNs = mbNowNs() - start;
+
+    parBenchStop(numEngines);
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    static const Cpa32U engineCounts[] = { 1, 2, 4, 8, 16 };
+    Cpa32U members = PAR_BENCH_MEMBERS;
+    size_t memberLen = PAR_BENCH_MEMBER_KB * 1024;
+    size_t srcLen;
+    size_t archiveSize;
+    size_t archiveLen;
+    Cpa8U *pSrc;
+    Cpa8U *pArchive;
+    par_bench_out_t out;
+    uint64_t ns;
+    uint64_t best;
+    double baseNs = 0;
+    CpaStatus status;
+    Cpa32U i;
+    Cpa32U r;
+
+    if (argc > 1)
+    {
+        members = strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2)
+    {
+        memberLen = strtoull(argv[2], NULL, 0) * 1024;
+    }
+    if ((0 == members) || (memberLen < 2 * sizeof(parBenchFakeHeader)))
+    {
+        printf("Usage: par_decomp_bench [members] [member size in KB]\n");
+        return 1;
+    }
+
+    srcLen = members * memberLen;
+    archiveSize = compressBound(srcLen) + members * 64;
+    pSrc = malloc(srcLen);
+    pArchive = malloc(archiveSize);
+    out.size = srcLen;
+    out.pData = malloc(srcLen);
+    if ((NULL == pSrc) || (NULL == pArchive) || (NULL == out.pData))
+    {
+        return 1;
+    }
+
+    parBenchFillText(pSrc, srcLen);
+    archiveLen =
+        parBenchGzip(pSrc, memberLen, members, 6, pArchive, archiveSize);
+    printf("%u members of %zu KB, %zu bytes of gzip, %u requests in flight "
+           "per instance\n\n",
+           members,
+           memberLen / 1024,
+           archiveLen,
+           PAR_BENCH_IN_FLIGHT);
+
+    printf("%-10s | %9s | %8s | %7s\n", "instances", "ms", "MB/s", "speedup");
+    for (i = 0; i < sizeof(engineCounts) / sizeof(engineCounts[0]); i++)
+    {
+        best = UINT64_MAX;
+        for (r = 0; r < PAR_BENCH_REPEATS; r++)
+        {
+            status = parBenchRun(
+                engineCounts[i], pArchive, archiveLen, &out, &ns);
+            if ((CPA_STATUS_SUCCESS != status) || (out.len != srcLen) ||
+                (0 != memcmp(out.pData, pSrc, srcLen)))
+            {
+                printf("Decompression failed, status %d\n", status);
+                return 1;
+            }
+            best = (ns < best) ? ns : best;
+        }
+        if (0 == i)
+        {
+            baseNs = (double)best;
+        }
+        printf("%-10u | %9.1f | %8.1f | %7.2f\n",
+               engineCounts[i],
+               best / 1e6,
+               srcLen * 1e3 / best,
+               baseNs / best);
+    }
+
+    /* A gzip header in the middle of every stored member */
+    for (i = 0; i < members; i++)
+    {
+        memcpy(pSrc + i * memberLen + memberLen / 2,
+               parBenchFakeHeader,
+               sizeof(parBenchFakeHeader));
+    }
+    archiveLen =
+        parBenchGzip(pSrc, memberLen, members, 0, pArchive, archiveSize);
+    parBenchSubmitted = 0;
+    status = parBenchRun(4, pArchive, archiveLen, &out, &ns);
+    printf("\nfalse boundaries | status %d, output %s, %llu requests for "
+           "%u members, %.1f ms\n",
+           status,
+           ((out.len == srcLen) && (0 == memcmp(out.pData, pSrc, srcLen)))
+               ? "matches"
+               : "differs",
+           (unsigned long long)parBenchSubmitted,
+           members,
+           ns / 1e6);
+
+    /* Invalid block type (BTYPE 11) in the first block of the first member */
+    archiveLen =
+        parBenchGzip(pSrc, memberLen, members, 6, pArchive, archiveSize);
+    pArchive[10] |= 0x06;
+    parBenchSubmitted = 0;
+    status = parBenchRun(4, pArchive, archiveLen, &out, &ns);
+    printf("corrupt          | status %d, %llu requests for %u members, "
+           "%.1f ms\n",
+           status,
+           (unsigned long long)parBenchSubmitted,
+           members,
+           ns / 1e6);
+
+    free(out.pData);
+    free(pArchive);
+    free(pSrc);
+    return 0;
+}
@@ -0,0 +1,407 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file precheck_bench.c
+ *
+ * @description
+ *     Accuracy and cost of the compressibility pre-check. Every data set is
+ *     cut into requests which are estimated by dcPrecheckApply at several
+ *     entropy thresholds. The actual outcome of each request is taken from
+ *     zlib at level 1, standing in for the device, with the saving
+ *     dcPrecheckComplete requires of a compressed request. A false store
+ *     is a compressible request kept in software, a miss an incompressible
+ *     request offloaded.
+ *
+ *     Without file arguments synthetic data sets are used. Pass the files
+ *     of a corpus, e.g. Silesia, to report on real data.
+ *
+ *     Usage: precheck_bench [request size in bytes] [file ...]
+ *
+ *****************************************************************************/
+
+#include <zlib.h>
+#include "micro_bench.h"
+#include "cpa.h"
+#include "lac_common.h"
+#include "dc_session.h"
+#include "dc_precheck.h"
+
+#define PRECHECK_BENCH_REQUEST_SIZE (64 * 1024)
+#define PRECHECK_BENCH_SYNTH_SIZE (16 * 1024 * 1024)
+#define PRECHECK_BENCH_BATCH 16
+
+/* Saving required of a compressed request, as in dcPrecheckComplete */
+#define PRECHECK_BENCH_MIN_SAVING_SHIFT 5
+
+static const Cpa32U precheckBenchThresholds[] = {
+    7000, 7500, DC_PRECHECK_DEFAULT_THRESHOLD, 7900, 7950
+};
+#define PRECHECK_BENCH_NUM_THRESHOLDS                                          \
+    (sizeof(precheckBenchThresholds) / sizeof(precheckBenchThresholds[0]))
+
+typedef struct precheck_bench_set_s
+{
+    const char *pName;
+    Cpa8U *pData;
+    size_t len;
+} precheck_bench_set_t;
+
+static uint64_t precheckBenchRandState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t precheckBenchRand(void)
+{
+    precheckBenchRandState ^= precheckBenchRandState << 13;
+    precheckBenchRandState ^= precheckBenchRandState >> 7;
+    precheckBenchRandState ^= precheckBenchRandState << 17;
+    return precheckBenchRandState;
+}
+
+/* Words drawn from a small vocabulary, compresses well */
+static void precheckBenchFillText(Cpa8U *pData, size_t len)
+{
+    static const char *words[] = { "the ",     "device ",  "request ",
+                                   "buffer ",  "session ", "of ",
+                                   "and ",     "stream ",  "compress ",
+                                   "data ",    "to ",      "instance\n" };
+    size_t pos = 0;
+    size_t wlen;
+    const char *pWord;
+
+    while (pos < len)
+    {
+        pWord = words[precheckBenchRand() % (sizeof(words) / sizeof(*words))];
+        wlen = strlen(pWord);
+        if (wlen > len - pos)
+        {
+            wlen = len - pos;
+        }
+        memcpy(pData + pos, pWord, wlen);
+        pos += wlen;
+    }
+}
+
+/* Uniformly distributed bytes, as in encrypted data */
+static void precheckBenchFillRandom(Cpa8U *pData, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        pData[i] = (Cpa8U)precheckBenchRand();
+    }
+}
+
+/* Seven bit random bytes: the order-0 entropy is high, yet Huffman coding
+ * alone saves an eighth */
+static void precheckBenchFill7Bit(Cpa8U *pData, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        pData[i] = (Cpa8U)(precheckBenchRand() & 0x7F);
+    }
+}
+
+/* Requests alternating between text and random halves */
+static void precheckBenchFillMixed(Cpa8U *pData, size_t len, size_t reqSize)
+{
+    size_t pos;
+    size_t half = reqSize / 2;
+
+    for (pos = 0; pos < len; pos += half)
+    {
+        if (half > len - pos)
+        {
+            half = len - pos;
+        }
+        if (0 == (pos / half) % 2)
+        {
+            precheckBenchFillText(pData + pos, half);
+        }
+        else
+        {
+            precheckBenchFillRandom(pData + pos, half);
+        }
+    }
+}
+
+/* Text compressed by zlib, as in already compressed files */
+static size_t precheckBenchFillDeflated(Cpa8U *pData, size_t len)
+{
+    uLongf outLen = len;
+    Cpa8U *pText = malloc(len * 4);
+
+    if (NULL == pText)
+    {
+        return 0;
+    }
+    precheckBenchFillText(pText, len * 4);
+    if (Z_OK != compress2(pData, &outLen, pText, len * 4, 9))
+    {
+        outLen = 0;
+    }
+    free(pText);
+    return outLen;
+}
+
+static int precheckBenchLoad(precheck_bench_set_t *pSet, const char *pPath)
+{
+    FILE *pFile = fopen(pPath, "rb");
+    long size;
+
+    if (NULL == pFile)
+    {
+        return -1;
+    }
+    fseek(pFile, 0, SEEK_END);
+    size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pSet->pName = pPath;
+    pSet->pData = malloc(size > 0 ? size : 1);
+    pSet->len = 0;
+    if ((NULL != pSet->pData) && (size > 0))
+    {
+        pSet->len = fread(pSet->pData, 1, size, pFile);
+    }
+    fclose(pFile);
+    return (NULL == pSet->pData) ? -1 : 0;
+}
+
+/* Whether zlib saves the required fraction of a request */
+static CpaBoolean precheckBenchCompressible(const Cpa8U *pData,
+                                           size_t len,
+                                           Cpa8U *pOut,
+                                           size_t outSize)
+{
+    uLongf outLen = outSize;
+
+    if (Z_OK != compress2(pOut, &outLen, pData, len, 1))
+    {
+        return CPA_FALSE;
+    }
+    return (outLen < len - (len >> PRECHECK_BENCH_MIN_SAVING_SHIFT))
+               ? CPA_TRUE
+               : CPA_FALSE;
+}
+
+static void precheckBenchRun(const precheck_bench_set_t *pSet,
+                             size_t reqSize,
+                             dc_session_desc_t *pSessionDesc,
+                             Cpa8U *pOut,
+                             size_t outSize,
+                             CpaBufferList *pDstList)
+{
+    CpaFlatBuffer srcFlat;
+    CpaBufferList srcList;
+    dc_precheck_result_t result = DC_PRECHECK_NONE;
+    CpaBoolean *pTruth = NULL;
+    uint64_t numReq = pSet->len / reqSize;
+    uint64_t compressible = 0;
+    uint64_t stored, falseStored, missed;
+    mb_result_t res;
+    uint64_t r;
+    unsigned int t;
+
+    if (0 == numReq)
+    {
+        printf("%-16s | shorter than one request\n", pSet->pName);
+        return;
+    }
+    pTruth = calloc(numReq, sizeof(*pTruth));
+    if (NULL == pTruth)
+    {
+        return;
+    }
+    for (r = 0; r < numReq; r++)
+    {
+        pTruth[r] = precheckBenchCompressible(
+            pSet->pData + r * reqSize, reqSize, pOut, outSize);
+        compressible += pTruth[r];
+    }
+
+    srcList.numBuffers = 1;
+    srcList.pBuffers = &srcFlat;
+    srcFlat.dataLenInBytes = reqSize;
+
+    for (t = 0; t < PRECHECK_BENCH_NUM_THRESHOLDS; t++)
+    {
+        pSessionDesc->precheckThreshold = precheckBenchThresholds[t];
+        stored = 0;
+        falseStored = 0;
+        missed = 0;
+        for (r = 0; r < numReq; r++)
+        {
+            srcFlat.pData = pSet->pData + r * reqSize;
+            result =
+                dcPrecheckApply(pSessionDesc, &srcList, pDstList, NULL);
+            if (DC_PRECHECK_INCOMPRESSIBLE == result)
+            {
+                stored++;
+                falseStored += pTruth[r];
+            }
+            else if (CPA_FALSE == pTruth[r])
+            {
+                missed++;
+            }
+        }
+
+        printf("%-16s | %5u | %7llu | %7llu | %7llu | %7llu | %7llu | "
+               "%6.2f%%\n",
+               pSet->pName,
+               precheckBenchThresholds[t],
+               (unsigned long long)numReq,
+               (unsigned long long)(numReq - compressible),
+               (unsigned long long)stored,
+               (unsigned long long)falseStored,
+               (unsigned long long)missed,
+               100.0 * (double)(numReq - falseStored - missed) /
+                   (double)numReq);
+    }
+
+    /* The cost does not depend on the outcome */
+    pSessionDesc->precheckThreshold = DC_PRECHECK_DEFAULT_THRESHOLD;
+    r = 0;
+    MB_MEASURE(res, PRECHECK_BENCH_BATCH, {
+        srcFlat.pData = pSet->pData + (r++ % numReq) * reqSize;
+        result = dcPrecheckApply(pSessionDesc, &srcList, pDstList, NULL);
+        MB_KEEP(result);
+    });
+    printf("%-16s | estimate %.0f ns/request, %.2f GB/s of request data\n",
+           pSet->pName,
+           mbNsPerOp(&res),
+           mbGBps(&res, reqSize));
+
+    free(pTruth);
+}
+
+int main(int argc, char **argv)
+{
+    precheck_bench_set_t sets[5];
+    unsigned int numSets = 0;
+    size_t reqSize = PRECHECK_BENCH_REQUEST_SIZE;
+    size_t outSize;
+    dc_session_desc_t *pSessionDesc = NULL;
+    CpaFlatBuffer dstFlat;
+    CpaBufferList dstList;
+    Cpa8U *pOut = NULL;
+    int i;
+
+    if (argc > 1)
+    {
+        reqSize = strtoull(argv[1], NULL, 0);
+    }
+    if (reqSize < DC_PRECHECK_MIN_SIZE)
+    {
+        reqSize = DC_PRECHECK_MIN_SIZE;
+    }
+    outSize = compressBound(reqSize);
+
+    pSessionDesc = calloc(1, sizeof(*pSessionDesc));
+    pOut = malloc(outSize);
+    if ((NULL == pSessionDesc) || (NULL == pOut))
+    {
+        return 1;
+    }
+    /* No audits, every estimate is acted on */
+    pSessionDesc->precheckAuditInterval = 0;
+
+    /* Large enough for the stored blocks of any request */
+    dstList.numBuffers = 1;
+    dstList.pBuffers = &dstFlat;
+    dstFlat.pData = pOut;
+    dstFlat.dataLenInBytes = outSize;
+
+    if (argc > 2)
+    {
+        for (i = 2; i < argc && numSets < sizeof(sets) / sizeof(*sets);
+             i++)
+        {
+            if (0 != precheckBenchLoad(&sets[numSets], argv[i]))
+            {
+                printf("Cannot read %s\n", argv[i]);
+                return 1;
+            }
+            numSets++;
+        }
+    }
+    else
+    {
+        for (i = 0; i < 5; i++)
+        {
+            sets[i].pData = malloc(PRECHECK_BENCH_SYNTH_SIZE);
+            sets[i].len = PRECHECK_BENCH_SYNTH_SIZE;
+            if (NULL == sets[i].pData)
+            {
+                return 1;
+            }
+        }
+        sets[0].pName = "text";
+        precheckBenchFillText(sets[0].pData, sets[0].len);
+        sets[1].pName = "random";
+        precheckBenchFillRandom(sets[1].pData, sets[1].len);
+        sets[2].pName = "7 bit random";
+        precheckBenchFill7Bit(sets[2].pData, sets[2].len);
+        sets[3].pName = "mixed halves";
+        precheckBenchFillMixed(sets[3].pData, sets[3].len, reqSize);
+        sets[4].pName = "deflated";
+        sets[4].len = precheckBenchFillDeflated(sets[4].pData, sets[4].len);
+        numSets = 5;
+    }
+
+    printf("%-16s | %5s | %7s | %7s | %7s | %7s | %7s | %s\n",
+           "data set",
+           "thr",
+           "reqs",
+           "incomp",
+           "stored",
+           "f.store",
+           "missed",
+           "accuracy");
+    for (i = 0; i < (int)numSets; i++)
+    {
+        precheckBenchRun(
+            &sets[i], reqSize, pSessionDesc, pOut, outSize, &dstList);
+        free(sets[i].pData);
+    }
+
+    free(pOut);
+    free(pSessionDesc);
+    return 0;
+}
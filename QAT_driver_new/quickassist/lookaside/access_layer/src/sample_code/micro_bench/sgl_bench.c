@@ -0,0 +1,211 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file sgl_bench.c
+ *
+ * @description
+ *     Cost of translating the buffers of one scatter gather list to
+ *     physical addresses, for lists of 1, 16 and 256 entries:
+ *       - walk: a walk of the usdm page table per buffer, as
+ *         qaeVirtToPhysNUMA did before the translation cache
+ *       - cold: qaeVirtToPhysNUMA with the translation caches invalidated
+ *         before each list, as after a slab free
+ *       - cached: qaeVirtToPhysNUMA with the cache warm
+ *       - desc: LacBuffDesc_BufferListDescWrite, which translates the
+ *         metadata and every buffer of the list
+ *
+ *     The buffers come from qaeMemAllocNUMA on slabs of the usdm driver
+ *     emulation of usdm_emu.c, so no driver or device is needed. Unless
+ *     the library uses huge pages itself, the cache holds 4KB pages:
+ *     lists spanning more pages than it has entries miss on every pass.
+ *
+ *     Usage: sgl_bench [driver|hugetlb|thp]
+ *
+ *****************************************************************************/
+
+#include "micro_bench.h"
+#include "usdm_emu.h"
+#include "cpa.h"
+#include "lac_common.h"
+#include "lac_sal_types.h"
+#include "lac_buffer_desc.h"
+#include "qae_mem.h"
+
+#define SGL_BENCH_MAX_BUFFERS 256
+
+/* Scatter gather list with its buffers */
+typedef struct sgl_bench_list_s
+{
+    CpaBufferList list;
+    CpaFlatBuffer flat[SGL_BENCH_MAX_BUFFERS];
+} sgl_bench_list_t;
+
+static int sglBenchSetup(sgl_bench_list_t *pSgl,
+                         Cpa32U numBuffers,
+                         Cpa32U bufferSize)
+{
+    Cpa32U metaSize = sizeof(icp_buffer_list_desc_t) +
+                      sizeof(icp_flat_buffer_desc_t) * (numBuffers + 1) +
+                      ICP_DESCRIPTOR_ALIGNMENT_BYTES;
+    Cpa32U i;
+
+    memset(pSgl, 0, sizeof(*pSgl));
+    pSgl->list.numBuffers = numBuffers;
+    pSgl->list.pBuffers = pSgl->flat;
+    pSgl->list.pPrivateMetaData = qaeMemAllocNUMA(metaSize, 0, 64);
+    if (NULL == pSgl->list.pPrivateMetaData)
+    {
+        return -1;
+    }
+    for (i = 0; i < numBuffers; i++)
+    {
+        pSgl->flat[i].dataLenInBytes = bufferSize;
+        pSgl->flat[i].pData = qaeMemAllocNUMA(bufferSize, 0, 64);
+        if (NULL == pSgl->flat[i].pData)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void sglBenchTeardown(sgl_bench_list_t *pSgl)
+{
+    Cpa32U i;
+
+    for (i = 0; i < pSgl->list.numBuffers; i++)
+    {
+        qaeMemFreeNonZeroNUMA((void **)&pSgl->flat[i].pData);
+    }
+    qaeMemFreeNonZeroNUMA(&pSgl->list.pPrivateMetaData);
+}
+
+static uint64_t sglBenchWalk(const sgl_bench_list_t *pSgl)
+{
+    uint64_t sum = 0;
+    Cpa32U i;
+
+    for (i = 0; i < pSgl->list.numBuffers; i++)
+    {
+        sum += usdmEmuPageTableLookup(pSgl->flat[i].pData);
+    }
+    return sum;
+}
+
+static uint64_t sglBenchTranslate(const sgl_bench_list_t *pSgl)
+{
+    uint64_t sum = 0;
+    Cpa32U i;
+
+    for (i = 0; i < pSgl->list.numBuffers; i++)
+    {
+        sum += qaeVirtToPhysNUMA(pSgl->flat[i].pData);
+    }
+    return sum;
+}
+
+int main(int argc, char **argv)
+{
+    static const Cpa32U entries[] = { 1, 16, 256 };
+    static const Cpa32U bufferSizes[] = { 512, 4096 };
+    static sgl_bench_list_t sgl;
+    sal_service_t service;
+    Cpa64U descPhys = 0;
+    mb_result_t walk;
+    mb_result_t cold;
+    mb_result_t cached;
+    mb_result_t desc;
+    unsigned int e;
+    unsigned int s;
+
+    if (0 != usdmEmuInit((argc > 1) ? argv[1] : NULL))
+    {
+        printf("Usage: sgl_bench [driver|hugetlb|thp]\n");
+        return 1;
+    }
+
+    /* Translations through qaeVirtToPhysNUMA */
+    memset(&service, 0, sizeof(service));
+
+    printf("%7s | %6s | %10s | %10s | %10s | %10s\n",
+           "entries",
+           "buffer",
+           "walk ns",
+           "cold ns",
+           "cached ns",
+           "desc ns");
+    for (s = 0; s < sizeof(bufferSizes) / sizeof(bufferSizes[0]); s++)
+    {
+        for (e = 0; e < sizeof(entries) / sizeof(entries[0]); e++)
+        {
+            if (0 != sglBenchSetup(&sgl, entries[e], bufferSizes[s]))
+            {
+                printf("Allocation failed\n");
+                return 1;
+            }
+            if (0 == sglBenchTranslate(&sgl))
+            {
+                printf("Translation failed\n");
+                return 1;
+            }
+
+            MB_MEASURE(walk, 64, MB_KEEP(sglBenchWalk(&sgl)));
+            MB_MEASURE(cold, 64, {
+                usdmEmuInvalidateTranslations();
+                MB_KEEP(sglBenchTranslate(&sgl));
+            });
+            MB_MEASURE(cached, 64, MB_KEEP(sglBenchTranslate(&sgl)));
+            MB_MEASURE(desc, 64, {
+                LacBuffDesc_BufferListDescWrite(
+                    &sgl.list, &descPhys, CPA_FALSE, &service);
+                MB_KEEP(descPhys);
+            });
+
+            printf("%7u | %6u | %10.1f | %10.1f | %10.1f | %10.1f\n",
+                   entries[e],
+                   bufferSizes[s],
+                   mbNsPerOp(&walk),
+                   mbNsPerOp(&cold),
+                   mbNsPerOp(&cached),
+                   mbNsPerOp(&desc));
+            sglBenchTeardown(&sgl);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file stats_bench.c
+ *
+ * @description
+ *     Cost of the compression request counters when several threads submit
+ *     on the same instance. Each simulated request increments a submit and
+ *     a completion counter, as the data path does, either in one shared
+ *     counter array (the layout used before) or through the per thread
+ *     shards of SAL_STATS_SHARDED_INC. The summed totals are checked.
+ *
+ *     Usage: stats_bench [max threads] [requests per thread]
+ *
+ *****************************************************************************/
+
+#include <pthread.h>
+#include "micro_bench.h"
+#include "cpa.h"
+#include "lac_common.h"
+#include "sal_statistics.h"
+
+#define STATS_BENCH_NUM_STATS 24
+#define STATS_BENCH_SUBMIT 0
+#define STATS_BENCH_COMPLETED 2
+#define STATS_BENCH_MAX_THREADS 64
+#define STATS_BENCH_REQUESTS (2 * 1000 * 1000)
+
+typedef struct stats_bench_ctx_s
+{
+    OsalAtomic *pStats;
+    CpaBoolean sharded;
+    uint64_t requests;
+    pthread_barrier_t *pBarrier;
+} stats_bench_ctx_t;
+
+static void *statsBenchThread(void *pArg)
+{
+    stats_bench_ctx_t *pCtx = pArg;
+    uint64_t i;
+
+    pthread_barrier_wait(pCtx->pBarrier);
+    if (CPA_TRUE == pCtx->sharded)
+    {
+        for (i = 0; i < pCtx->requests; i++)
+        {
+            SAL_STATS_SHARDED_INC(
+                pCtx->pStats, STATS_BENCH_NUM_STATS, STATS_BENCH_SUBMIT);
+            SAL_STATS_SHARDED_INC(
+                pCtx->pStats, STATS_BENCH_NUM_STATS, STATS_BENCH_COMPLETED);
+        }
+    }
+    else
+    {
+        for (i = 0; i < pCtx->requests; i++)
+        {
+            osalAtomicInc(&pCtx->pStats[STATS_BENCH_SUBMIT]);
+            osalAtomicInc(&pCtx->pStats[STATS_BENCH_COMPLETED]);
+        }
+    }
+    pthread_barrier_wait(pCtx->pBarrier);
+    return NULL;
+}
+
+/* Runs one configuration and returns the nanoseconds per request */
+static double statsBenchRun(OsalAtomic *pStats,
+                            CpaBoolean sharded,
+                            unsigned int numThreads,
+                            uint64_t requests)
+{
+    pthread_t threads[STATS_BENCH_MAX_THREADS];
+    stats_bench_ctx_t ctx;
+    pthread_barrier_t barrier;
+    uint64_t startNs;
+    uint64_t ns;
+    unsigned int i;
+
+    ctx.pStats = pStats;
+    ctx.sharded = sharded;
+    ctx.requests = requests;
+    ctx.pBarrier = &barrier;
+    pthread_barrier_init(&barrier, NULL, numThreads + 1);
+    for (i = 0; i < numThreads; i++)
+    {
+        pthread_create(&threads[i], NULL, statsBenchThread, &ctx);
+    }
+    pthread_barrier_wait(&barrier);
+    startNs = mbNowNs();
+    pthread_barrier_wait(&barrier);
+    ns = mbNowNs() - startNs;
+    for (i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    return (double)ns / (double)(requests * numThreads);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int maxThreads = 16;
+    uint64_t requests = STATS_BENCH_REQUESTS;
+    OsalAtomic *pShared = NULL;
+    OsalAtomic *pSharded = NULL;
+    Cpa64U totals[STATS_BENCH_NUM_STATS];
+    unsigned int numThreads;
+    unsigned int i;
+    double nsShared, nsSharded;
+    int mismatch = 0;
+
+    if (argc > 1)
+    {
+        maxThreads = (unsigned int)strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2)
+    {
+        requests = strtoull(argv[2], NULL, 0);
+    }
+    if ((0 == maxThreads) || (maxThreads > STATS_BENCH_MAX_THREADS))
+    {
+        maxThreads = STATS_BENCH_MAX_THREADS;
+    }
+
+    pShared = osalMemAllocAligned(
+        0, STATS_BENCH_NUM_STATS * sizeof(OsalAtomic), LAC_64BYTE_ALIGNMENT);
+    if ((NULL == pShared) ||
+        (CPA_STATUS_SUCCESS !=
+         SalStatistics_ShardedAlloc(&pSharded, STATS_BENCH_NUM_STATS)))
+    {
+        return 1;
+    }
+
+    printf("%8s | %-12s | %-12s | %s\n",
+           "threads", "shared", "sharded", "speedup");
+    printf("%8s | %-12s | %-12s |\n", "", "ns/request", "ns/request");
+    for (numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        for (i = 0; i < STATS_BENCH_NUM_STATS; i++)
+        {
+            osalAtomicSet(0, &pShared[i]);
+        }
+        SalStatistics_ShardedReset(pSharded, STATS_BENCH_NUM_STATS);
+
+        nsShared = statsBenchRun(pShared, CPA_FALSE, numThreads, requests);
+        nsSharded = statsBenchRun(pSharded, CPA_TRUE, numThreads, requests);
+
+        SalStatistics_ShardedGet(pSharded, STATS_BENCH_NUM_STATS, totals);
+        if ((totals[STATS_BENCH_SUBMIT] != requests * numThreads) ||
+            (totals[STATS_BENCH_COMPLETED] != requests * numThreads) ||
+            ((uint64_t)osalAtomicGet(&pShared[STATS_BENCH_SUBMIT]) !=
+             requests * numThreads))
+        {
+            mismatch = 1;
+        }
+
+        printf("%8u | %12.2f | %12.2f | %6.2fx\n",
+               numThreads,
+               nsShared,
+               nsSharded,
+               nsShared / nsSharded);
+    }
+
+    if (mismatch)
+    {
+        printf("ERROR: counter totals differ from the request count\n");
+    }
+    SalStatistics_ShardedFree(&pSharded);
+    osalMemAlignedFree((void *)pShared);
+    return mismatch;
+}
@@ -0,0 +1,308 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file usdm_alloc_bench.c
+ *
+ * @description
+ *     Cost of qaeMemAllocNUMA and qaeMemFreeNonZeroNUMA, comparing the size
+ *     class caches (node 0) with the bitmap slab allocator, which still
+ *     serves node 7 and above:
+ *       - batches of allocations then frees of one size
+ *       - the same with thousands of mixed size objects live and holes
+ *         left between them
+ *       - objects allocated by one thread and freed by another
+ *       - several threads allocating and freeing at once
+ *
+ *     The slabs normally come from the usdm kernel driver. In the hugetlb
+ *     and thp modes they come from anonymous huge pages through the driver
+ *     emulation of usdm_emu.c, so no driver, device or root access is
+ *     needed.
+ *
+ *     Usage: usdm_alloc_bench [driver|hugetlb|thp]
+ *
+ *****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "micro_bench.h"
+#include "usdm_emu.h"
+#include "qae_mem.h"
+#include "qae_mem_utils.h"
+
+#define ALLOC_BENCH_BATCH 64
+#define ALLOC_BENCH_LIVE 4096
+#define ALLOC_BENCH_XFER 200000
+#define ALLOC_BENCH_RING 256
+#define ALLOC_BENCH_MAX_THREADS 8
+
+/* First node served by the bitmap allocator only */
+#define ALLOC_BENCH_BITMAP_NODE 7
+
+static uint64_t allocBenchRandState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t allocBenchRand(void)
+{
+    allocBenchRandState ^= allocBenchRandState << 13;
+    allocBenchRandState ^= allocBenchRandState >> 7;
+    allocBenchRandState ^= allocBenchRandState << 17;
+    return allocBenchRandState;
+}
+
+/* Allocates a batch of objects then frees it */
+static void allocBenchBatch(size_t size, int node)
+{
+    void *ptrs[ALLOC_BENCH_BATCH];
+    int i;
+
+    for (i = 0; i < ALLOC_BENCH_BATCH; i++)
+    {
+        ptrs[i] = qaeMemAllocNUMA(size, node, 64);
+        MB_KEEP(ptrs[i]);
+    }
+    for (i = 0; i < ALLOC_BENCH_BATCH; i++)
+    {
+        qaeMemFreeNonZeroNUMA(&ptrs[i]);
+    }
+}
+
+/* Leaves ALLOC_BENCH_LIVE mixed size objects live, one in two freed */
+static void allocBenchFragment(void **ptrs, int node)
+{
+    int i;
+
+    for (i = 0; i < 2 * ALLOC_BENCH_LIVE; i++)
+    {
+        ptrs[i] = qaeMemAllocNUMA(
+            (size_t)1024 << (allocBenchRand() % 7), node, 64);
+    }
+    for (i = 0; i < 2 * ALLOC_BENCH_LIVE; i += 2)
+    {
+        qaeMemFreeNonZeroNUMA(&ptrs[i]);
+    }
+}
+
+static void allocBenchRelease(void **ptrs)
+{
+    int i;
+
+    for (i = 0; i < 2 * ALLOC_BENCH_LIVE; i++)
+    {
+        if (NULL != ptrs[i])
+        {
+            qaeMemFreeNonZeroNUMA(&ptrs[i]);
+        }
+    }
+}
+
+/* Single producer, single consumer ring of objects to free */
+typedef struct alloc_bench_xfer_s
+{
+    void *volatile ring[ALLOC_BENCH_RING];
+    volatile uint64_t head;
+    volatile uint64_t tail;
+    int node;
+} alloc_bench_xfer_t;
+
+static void *allocBenchFreer(void *pArg)
+{
+    alloc_bench_xfer_t *pXfer = pArg;
+    void *p;
+    uint64_t n;
+
+    for (n = 0; n < ALLOC_BENCH_XFER; n++)
+    {
+        while (pXfer->tail == pXfer->head)
+        {
+            sched_yield();
+        }
+        p = pXfer->ring[pXfer->tail % ALLOC_BENCH_RING];
+        __sync_synchronize();
+        pXfer->tail++;
+        qaeMemFreeNonZeroNUMA(&p);
+    }
+    return NULL;
+}
+
+static double allocBenchCrossThread(int node)
+{
+    alloc_bench_xfer_t xfer;
+    pthread_t thread;
+    uint64_t start;
+    uint64_t n;
+    void *p;
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.node = node;
+    start = mbNowNs();
+    if (0 != pthread_create(&thread, NULL, allocBenchFreer, &xfer))
+    {
+        return 0;
+    }
+    for (n = 0; n < ALLOC_BENCH_XFER; n++)
+    {
+        p = qaeMemAllocNUMA(4096, node, 64);
+        while (xfer.head - xfer.tail == ALLOC_BENCH_RING)
+        {
+            sched_yield();
+        }
+        xfer.ring[xfer.head % ALLOC_BENCH_RING] = p;
+        __sync_synchronize();
+        xfer.head++;
+    }
+    pthread_join(thread, NULL);
+    return (double)(mbNowNs() - start) / ALLOC_BENCH_XFER;
+}
+
+typedef struct alloc_bench_worker_s
+{
+    pthread_t thread;
+    int node;
+    uint64_t ops;
+} alloc_bench_worker_t;
+
+static volatile int allocBenchStop = 0;
+
+static void *allocBenchWorker(void *pArg)
+{
+    alloc_bench_worker_t *pWorker = pArg;
+
+    while (0 == allocBenchStop)
+    {
+        allocBenchBatch(4096, pWorker->node);
+        pWorker->ops += ALLOC_BENCH_BATCH;
+    }
+    return NULL;
+}
+
+/* Aggregate alloc and free pairs per microsecond of numThreads threads */
+static double allocBenchThreads(int numThreads, int node)
+{
+    alloc_bench_worker_t workers[ALLOC_BENCH_MAX_THREADS];
+    uint64_t start;
+    uint64_t ops = 0;
+    int i;
+
+    allocBenchStop = 0;
+    start = mbNowNs();
+    for (i = 0; i < numThreads; i++)
+    {
+        workers[i].node = node;
+        workers[i].ops = 0;
+        pthread_create(&workers[i].thread, NULL, allocBenchWorker, &workers[i]);
+    }
+    while (mbNowNs() - start < MB_MIN_RUN_NS)
+    {
+        usleep(1000);
+    }
+    allocBenchStop = 1;
+    for (i = 0; i < numThreads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        ops += workers[i].ops;
+    }
+    return (double)ops * 1000.0 / (double)(mbNowNs() - start);
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t sizes[] = { 64, 1024, 4096, 16384, 65536, 262144 };
+    static const int nodes[] = { 0, ALLOC_BENCH_BITMAP_NODE };
+    static const char *nodeNames[] = { "size class", "bitmap" };
+    static void *live[2 * ALLOC_BENCH_LIVE];
+    mb_result_t res;
+    double fresh;
+    unsigned int s;
+    int n;
+    int t;
+
+    if (0 != usdmEmuInit((argc > 1) ? argv[1] : NULL))
+    {
+        printf("Usage: usdm_alloc_bench [driver|hugetlb|thp]\n");
+        return 1;
+    }
+
+    printf("%-10s | %7s | %12s | %12s\n",
+           "allocator",
+           "size",
+           "ns/pair",
+           "fragmented");
+    for (n = 0; n < 2; n++)
+    {
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            /* First run carves the slabs */
+            allocBenchBatch(sizes[s], nodes[n]);
+            MB_MEASURE(res, 1, allocBenchBatch(sizes[s], nodes[n]));
+            fresh = mbNsPerOp(&res) / ALLOC_BENCH_BATCH;
+
+            allocBenchFragment(live, nodes[n]);
+            MB_MEASURE(res, 1, allocBenchBatch(sizes[s], nodes[n]));
+            allocBenchRelease(live);
+
+            printf("%-10s | %7zu | %12.1f | %12.1f\n",
+                   nodeNames[n],
+                   sizes[s],
+                   fresh,
+                   mbNsPerOp(&res) / ALLOC_BENCH_BATCH);
+        }
+    }
+
+    printf("\n%-10s | %s\n", "allocator", "ns per 4KB object freed by "
+                                          "another thread");
+    for (n = 0; n < 2; n++)
+    {
+        printf("%-10s | %.1f\n", nodeNames[n], allocBenchCrossThread(nodes[n]));
+    }
+
+    printf("\n%-10s | %7s | %s\n", "allocator", "threads", "Mpairs/s");
+    for (n = 0; n < 2; n++)
+    {
+        for (t = 1; t <= ALLOC_BENCH_MAX_THREADS; t *= 2)
+        {
+            printf("%-10s | %7d | %.2f\n",
+                   nodeNames[n],
+                   t,
+                   allocBenchThreads(t, nodes[n]));
+        }
+    }
+
+    qaeMemDestroy();
+    return 0;
+}
@@ -0,0 +1,370 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file usdm_emu.c
+ *
+ * @description
+ *     Emulation of the usdm kernel driver for the micro-benchmarks of
+ *     libusdm_drv. open, ioctl and mmap are redirected with the linker's
+ *     --wrap option; the calls made on the usdm device are served from
+ *     anonymous 2MB huge pages (MAP_HUGETLB, or madvised transparent huge
+ *     pages) with made up physical addresses, in the layout the driver
+ *     gives its slabs. The library code runs unchanged, so no driver,
+ *     device or root access is needed. Every other call is passed on.
+ *     It also exposes the library's page table to benchmarks that cannot
+ *     include the usdm internal headers next to the OSAL ones.
+ *
+ *****************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "micro_bench.h"
+#include "usdm_emu.h"
+#include "qae_mem.h"
+#include "qae_mem_utils_common.h"
+
+#define USDM_EMU_DEV "/dev/usdm_drv"
+#define USDM_EMU_HUGE_SIZE (2 * 1024 * 1024)
+#define USDM_EMU_PHYS_BASE (1ULL << 36)
+#define USDM_EMU_MAX_SLABS 4096
+
+typedef enum usdm_emu_mode_e
+{
+    USDM_EMU_DRIVER = 0,
+    USDM_EMU_HUGETLB,
+    USDM_EMU_THP
+} usdm_emu_mode_t;
+
+/* Slab handed out by the emulated driver */
+typedef struct usdm_emu_slab_s
+{
+    uint64_t phy;
+    void *pCtrl;
+    /**< Control block, the start of the data for small slabs */
+    void *pData;
+    size_t len;
+} usdm_emu_slab_t;
+
+static usdm_emu_mode_t usdmEmuMode = USDM_EMU_DRIVER;
+static usdm_emu_slab_t usdmEmuSlabs[USDM_EMU_MAX_SLABS];
+static pthread_mutex_t usdmEmuLock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t usdmEmuNextPhy = USDM_EMU_PHYS_BASE;
+static int usdmEmuFd = -1;
+int __real_open(const char *pPath, int flags, ...);
+int __real_ioctl(int fd, unsigned long request, ...);
+void *__real_mmap(
+    void *pAddr, size_t len, int prot, int flags, int fd, off_t offset);
+
+/* Zeroed anonymous memory of len bytes on 2MB huge pages */
+static void *usdmEmuMapHuge(size_t len)
+{
+    uint8_t *pMem;
+    uint8_t *pAligned;
+
+    if (USDM_EMU_HUGETLB == usdmEmuMode)
+    {
+        pMem = __real_mmap(NULL,
+                           len,
+                           PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                               MAP_POPULATE,
+                           -1,
+                           0);
+        return (MAP_FAILED == pMem) ? NULL : pMem;
+    }
+
+    /* Transparent huge pages need a 2MB aligned range */
+    pMem = __real_mmap(NULL,
+                       len + USDM_EMU_HUGE_SIZE,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+    if (MAP_FAILED == pMem)
+    {
+        return NULL;
+    }
+    pAligned = (uint8_t *)(((uintptr_t)pMem + USDM_EMU_HUGE_SIZE - 1) &
+                           ~(uintptr_t)(USDM_EMU_HUGE_SIZE - 1));
+    if (pAligned != pMem)
+    {
+        munmap(pMem, pAligned - pMem);
+    }
+    munmap(pAligned + len, pMem + USDM_EMU_HUGE_SIZE - pAligned);
+    madvise(pAligned, len, MADV_HUGEPAGE);
+    memset(pAligned, 0, len);
+    return pAligned;
+}
+
+/* DEV_MEM_IOC_MEMALLOC: the layout userMemAlloc gives a slab */
+static int usdmEmuSlabAlloc(dev_mem_info_t *pInfo)
+{
+    usdm_emu_slab_t *pSlab = NULL;
+    dev_mem_info_t *pCtrl;
+    size_t len;
+    int i;
+
+    len = (pInfo->size + USDM_EMU_HUGE_SIZE - 1) &
+          ~(size_t)(USDM_EMU_HUGE_SIZE - 1);
+
+    pthread_mutex_lock(&usdmEmuLock);
+    for (i = 0; i < USDM_EMU_MAX_SLABS; i++)
+    {
+        if (0 == usdmEmuSlabs[i].phy)
+        {
+            pSlab = &usdmEmuSlabs[i];
+            pSlab->phy = usdmEmuNextPhy;
+            usdmEmuNextPhy += len;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&usdmEmuLock);
+    if (NULL == pSlab)
+    {
+        return -ENOMEM;
+    }
+
+    pSlab->len = len;
+    pSlab->pData = usdmEmuMapHuge(len);
+    pSlab->pCtrl = pSlab->pData;
+    if ((NULL != pSlab->pData) && (SMALL != pInfo->type))
+    {
+        /* Large slabs have their control block on a page of its own */
+        pSlab->pCtrl = __real_mmap(NULL,
+                                   getpagesize(),
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS,
+                                   -1,
+                                   0);
+        if (MAP_FAILED == pSlab->pCtrl)
+        {
+            munmap(pSlab->pData, len);
+            pSlab->pData = NULL;
+        }
+    }
+    if (NULL == pSlab->pData)
+    {
+        pSlab->phy = 0;
+        return -ENOMEM;
+    }
+
+    pCtrl = pSlab->pCtrl;
+    pCtrl->nodeId = pInfo->nodeId;
+    pCtrl->size = len;
+    pCtrl->type = pInfo->type;
+    pCtrl->phy_addr = pSlab->phy;
+    memcpy(pInfo, pCtrl, sizeof(*pInfo));
+    return 0;
+}
+
+static usdm_emu_slab_t *usdmEmuSlabFind(uint64_t phy)
+{
+    int i;
+
+    for (i = 0; i < USDM_EMU_MAX_SLABS; i++)
+    {
+        if (phy == usdmEmuSlabs[i].phy)
+        {
+            return &usdmEmuSlabs[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Replacements of the system calls made by libusdm_drv, selected with
+ * -Wl,--wrap=<symbol>. Only the usdm device is emulated.
+ */
+int __wrap_open(const char *pPath, int flags, ...)
+{
+    va_list args;
+    mode_t mode = 0;
+    int fd;
+
+    if (0 != (flags & O_CREAT))
+    {
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+    if ((USDM_EMU_DRIVER == usdmEmuMode) ||
+        (0 != strcmp(pPath, USDM_EMU_DEV)))
+    {
+        return __real_open(pPath, flags, mode);
+    }
+    fd = __real_open("/dev/null", O_RDWR);
+    usdmEmuFd = fd;
+    return fd;
+}
+
+int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+    usdm_emu_slab_t *pSlab;
+    dev_mem_info_t *pInfo;
+    va_list args;
+    void *pArg;
+    int i;
+
+    va_start(args, request);
+    pArg = va_arg(args, void *);
+    va_end(args);
+
+    if ((USDM_EMU_DRIVER == usdmEmuMode) || (fd != usdmEmuFd))
+    {
+        return __real_ioctl(fd, request, pArg);
+    }
+
+    switch (request)
+    {
+        case DEV_MEM_IOC_MEMALLOC:
+            return usdmEmuSlabAlloc(pArg);
+        case DEV_MEM_IOC_MEMFREE:
+            /* The library has unmapped the slab already */
+            pInfo = pArg;
+            pthread_mutex_lock(&usdmEmuLock);
+            pSlab = usdmEmuSlabFind(pInfo->phy_addr);
+            if (NULL != pSlab)
+            {
+                pSlab->phy = 0;
+            }
+            pthread_mutex_unlock(&usdmEmuLock);
+            return (NULL == pSlab) ? -EIO : 0;
+        case DEV_MEM_IOC_RELEASE:
+            pthread_mutex_lock(&usdmEmuLock);
+            for (i = 0; i < USDM_EMU_MAX_SLABS; i++)
+            {
+                pSlab = &usdmEmuSlabs[i];
+                if (0 != pSlab->phy)
+                {
+                    if (pSlab->pCtrl != pSlab->pData)
+                    {
+                        munmap(pSlab->pCtrl, getpagesize());
+                    }
+                    munmap(pSlab->pData, pSlab->len);
+                    pSlab->phy = 0;
+                }
+            }
+            pthread_mutex_unlock(&usdmEmuLock);
+            return 0;
+        case DEV_MEM_IOC_GET_NUM_HPT:
+            /* No hugetlbfs pages reserved for the library */
+            *(uint32_t *)pArg = 0;
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+void *__wrap_mmap(
+    void *pAddr, size_t len, int prot, int flags, int fd, off_t offset)
+{
+    usdm_emu_slab_t *pSlab;
+    void *pMem = MAP_FAILED;
+
+    if ((USDM_EMU_DRIVER == usdmEmuMode) || (fd != usdmEmuFd))
+    {
+        return __real_mmap(pAddr, len, prot, flags, fd, offset);
+    }
+
+    /* A page sized mapping is the control block, as in the driver */
+    pthread_mutex_lock(&usdmEmuLock);
+    pSlab = usdmEmuSlabFind((uint64_t)offset);
+    if (NULL != pSlab)
+    {
+        pMem = ((size_t)getpagesize() == len) ? pSlab->pCtrl : pSlab->pData;
+    }
+    pthread_mutex_unlock(&usdmEmuLock);
+    return pMem;
+}
+
+int usdmEmuInit(const char *pMode)
+{
+    void *pProbe;
+
+    if ((NULL == pMode) || (0 == strcmp(pMode, "hugetlb")))
+    {
+        usdmEmuMode = USDM_EMU_HUGETLB;
+        pProbe = usdmEmuMapHuge(USDM_EMU_HUGE_SIZE);
+        if (NULL == pProbe)
+        {
+            printf("No 2MB hugetlb pages reserved, using transparent huge "
+                   "pages\n");
+            usdmEmuMode = USDM_EMU_THP;
+        }
+        else
+        {
+            munmap(pProbe, USDM_EMU_HUGE_SIZE);
+        }
+    }
+    else if (0 == strcmp(pMode, "thp"))
+    {
+        usdmEmuMode = USDM_EMU_THP;
+    }
+    else if (0 == strcmp(pMode, "driver"))
+    {
+        usdmEmuMode = USDM_EMU_DRIVER;
+    }
+    else
+    {
+        return -1;
+    }
+
+    printf("Slabs from %s\n\n",
+           (USDM_EMU_DRIVER == usdmEmuMode)
+               ? "the usdm driver"
+               : (USDM_EMU_HUGETLB == usdmEmuMode)
+                     ? "anonymous hugetlb pages"
+                     : "anonymous transparent huge pages");
+    return 0;
+}
+
+uint64_t usdmEmuPageTableLookup(void *pVirt)
+{
+    return load_addr_fptr(&g_page_table, pVirt);
+}
+
+void usdmEmuInvalidateTranslations(void)
+{
+    __qae_v2p_invalidate();
+}
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file usdm_emu.h
+ *
+ * @description
+ *     Emulation of the usdm kernel driver for the micro-benchmarks of
+ *     libusdm_drv, see usdm_emu.c. A benchmark using it is linked with
+ *     usdm_emu.c and -Wl,--wrap=open,--wrap=ioctl,--wrap=mmap.
+ *
+ *****************************************************************************/
+#ifndef USDM_EMU_H
+#define USDM_EMU_H
+
+#include <stdint.h>
+
+/*
+ * Selects where the slabs come from: "driver" for the usdm driver,
+ * "hugetlb" or "thp" for the emulation. NULL selects hugetlb, which falls
+ * back to thp when no huge pages are reserved. Must be called before the
+ * first allocation. Returns -1 for an unknown mode.
+ */
+int usdmEmuInit(const char *pMode);
+
+/*
+ * Physical address of pVirt read from the usdm page table, bypassing the
+ * per-thread translation cache of qaeVirtToPhysNUMA.
+ */
+uint64_t usdmEmuPageTableLookup(void *pVirt);
+
+/* Invalidates the translation caches of all the threads */
+void usdmEmuInvalidateTranslations(void);
+
+#endif /* USDM_EMU_H */
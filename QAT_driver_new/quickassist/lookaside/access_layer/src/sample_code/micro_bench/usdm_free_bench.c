@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+
+/**
+ *****************************************************************************
+ * @file usdm_free_bench.c
+ *
+ * @description
+ *     Latency of qaeMemFreeNUMA, which zeroes the block before releasing
+ *     it, against qaeMemFreeNonZeroNUMA by block size. The difference is
+ *     the cost of the secure free. The byte at a time volatile loop the
+ *     zeroing used before is timed on the same blocks for reference.
+ *     Every block is written before it is freed, as a used buffer would
+ *     be. Blocks larger than a slab, such as 3MB, are not zeroed by the
+ *     library: they go back to the driver, which hands out zeroed memory.
+ *
+ *     The slabs come from the usdm kernel driver or, in the hugetlb and
+ *     thp modes, from anonymous huge pages through the driver emulation
+ *     of usdm_emu.c.
+ *
+ *     Usage: usdm_free_bench [driver|hugetlb|thp]
+ *
+ *****************************************************************************/
+
+#include "micro_bench.h"
+#include "usdm_emu.h"
+#include "qae_mem.h"
+#include "qae_mem_utils.h"
+
+#define FREE_BENCH_MIN_ITERATIONS 16
+
+/* Byte at a time volatile zeroing, as qae_memzero did before */
+static void freeBenchByteLoop(void *ptr, size_t count)
+{
+    volatile unsigned char *volatile dstPtr = ptr;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        dstPtr[i] = 0;
+    }
+}
+
+/* Mean latency of one free call, in nanoseconds */
+static double freeBenchFree(size_t size, int secure)
+{
+    uint64_t total = 0;
+    uint64_t iterations = 0;
+    uint64_t start;
+    uint64_t t;
+    void *p;
+
+    start = mbNowNs();
+    while ((iterations < FREE_BENCH_MIN_ITERATIONS) ||
+           (mbNowNs() - start < MB_MIN_RUN_NS))
+    {
+        p = qaeMemAllocNUMA(size, 0, 64);
+        if (NULL == p)
+        {
+            return 0;
+        }
+        memset(p, 0xA5, size);
+        t = mbNowNs();
+        if (secure)
+        {
+            qaeMemFreeNUMA(&p);
+        }
+        else
+        {
+            qaeMemFreeNonZeroNUMA(&p);
+        }
+        total += mbNowNs() - t;
+        iterations++;
+    }
+    return (double)total / (double)iterations;
+}
+
+/* Mean time of the byte loop over a block, in nanoseconds */
+static double freeBenchByteLoopTime(size_t size)
+{
+    mb_result_t res;
+    void *p = qaeMemAllocNUMA(size, 0, 64);
+
+    if (NULL == p)
+    {
+        return 0;
+    }
+    memset(p, 0xA5, size);
+    MB_MEASURE(res, 1, freeBenchByteLoop(p, size));
+    qaeMemFreeNonZeroNUMA(&p);
+    return mbNsPerOp(&res);
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t sizes[] = { 1024,
+                                    4096,
+                                    65536,
+                                    262144,
+                                    1024 * 1024,
+                                    3 * 1024 * 1024 };
+    double secure;
+    double plain;
+    double byteLoop;
+    char rate[16];
+    unsigned int s;
+
+    if (0 != usdmEmuInit((argc > 1) ? argv[1] : NULL))
+    {
+        printf("Usage: usdm_free_bench [driver|hugetlb|thp]\n");
+        return 1;
+    }
+
+    printf("%9s | %12s | %12s | %12s | %8s | %12s\n",
+           "size",
+           "secure ns",
+           "non-zero ns",
+           "zeroing ns",
+           "GB/s",
+           "byte loop ns");
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        secure = freeBenchFree(sizes[s], 1);
+        plain = freeBenchFree(sizes[s], 0);
+        byteLoop = freeBenchByteLoopTime(sizes[s]);
+        /* No rate where the difference is within the timing noise */
+        if (secure - plain > secure / 4)
+        {
+            snprintf(rate, sizeof(rate), "%.2f", sizes[s] / (secure - plain));
+        }
+        else
+        {
+            snprintf(rate, sizeof(rate), "-");
+        }
+        printf("%9zu | %12.0f | %12.0f | %12.0f | %8s | %12.0f\n",
+               sizes[s],
+               secure,
+               plain,
+               (secure > plain) ? secure - plain : 0.0,
+               rate,
+               byteLoop);
+    }
+
+    qaeMemDestroy();
+    return 0;
+}
@@ -79,6 +79,8 @@ static inline void printThreadDetails(single_thread_test_data_t *testSetup)
     __attribute__((unused));
 CpaStatus setDcPollingInterval(Cpa64U pollingInterval);
 CpaStatus printDcPollingInterval(void);
+CpaStatus setDcDpBatchPoll(Cpa32U maxResponses);
+CpaStatus setDcDpFlushPolicy(Cpa32U batchSize, Cpa32U budgetUs);
 void dcDpPerformance(single_thread_test_data_t *testSetup);
 
 /*****************************************************************************
@@ -109,14 +111,64 @@ CpaStatus printDcPollingInterval(void)
 }
 EXPORT_SYMBOL(printDcPollingInterval);
 
+static CpaStatus dcDpPollBatch(CpaInstanceHandle instanceHandle,
+                               Cpa32U responseQuota);
+
+/*****************************************************************************
+ * @ingroup sampleCompressionDpPerf
+ *
+ * @description
+ * Select how data plane responses are polled. With maxResponses set to 0,
+ * icp_sal_DcPollDpInstance invokes the registered callback per response.
+ * Otherwise icp_sal_DcPollDpInstanceBatch returns up to maxResponses
+ * completed requests per poll, which are processed without a callback.
+ * ***************************************************************************/
+CpaStatus setDcDpBatchPoll(Cpa32U maxResponses)
+{
+    if (maxResponses > DC_DP_MAX_BATCH_POLL)
+    {
+        PRINT_ERR("Batch poll size %u exceeds %u\n",
+                  maxResponses,
+                  DC_DP_MAX_BATCH_POLL);
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    dcDpBatchPoll_g = maxResponses;
+    dcDpPollFunc_g =
+        (0 == maxResponses) ? icp_sal_DcPollDpInstance : dcDpPollBatch;
+    return CPA_STATUS_SUCCESS;
+}
+EXPORT_SYMBOL(setDcDpBatchPoll);
+
+/*****************************************************************************
+ * @ingroup sampleCompressionDpPerf
+ *
+ * @description
+ * Set the doorbell flush policy of the data plane instances. With batchSize
+ * set, the enqueue tests leave the ring tail updates to the library, which
+ * flushes after batchSize requests or once the oldest queued request has
+ * waited budgetUs microseconds. 0 keeps the flushes of the test.
+ * ***************************************************************************/
+CpaStatus setDcDpFlushPolicy(Cpa32U batchSize, Cpa32U budgetUs)
+{
+    if ((0 == batchSize) && (0 != budgetUs))
+    {
+        PRINT_ERR("A flush time budget requires a flush batch size\n");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    dcDpFlushBatchSize_g = batchSize;
+    dcDpFlushBudgetUs_g = budgetUs;
+    return CPA_STATUS_SUCCESS;
+}
+EXPORT_SYMBOL(setDcDpFlushPolicy);
+
 /**
  *****************************************************************************
  * @ingroup sampleCompressionDpPerf
  *
  * @description
- *  Callback function after a call to the DC API
+ *  Process the response of a DC data plane request
  ******************************************************************************/
-static void dcDpCallbackFunction(CpaDcDpOpData *pOpData)
+static inline void dcDpProcessResponse(CpaDcDpOpData *pOpData)
 {
     CpaDcRqResults *pResults = &(pOpData->results);
 
@@ -199,6 +251,75 @@ static void dcDpCallbackFunction(CpaDcDpOpData *pOpData)
     }
 }
 
+/**
+ *****************************************************************************
+ * @ingroup sampleCompressionDpPerf
+ *
+ * @description
+ *  Callback function after a call to the DC API
+ ******************************************************************************/
+static void dcDpCallbackFunction(CpaDcDpOpData *pOpData)
+{
+    dcDpProcessResponse(pOpData);
+}
+
+/**
+ *****************************************************************************
+ * @ingroup sampleCompressionDpPerf
+ *
+ * @description
+ *  Poll the instance for up to dcDpBatchPoll_g responses and process them
+ *  in place of the callback. The response quota of the regular poll
+ *  function is replaced by the batch size.
+ ******************************************************************************/
+static CpaStatus dcDpPollBatch(CpaInstanceHandle instanceHandle,
+                               Cpa32U responseQuota)
+{
+    CpaDcDpOpData *pOpData[DC_DP_MAX_BATCH_POLL];
+    Cpa32U numResponses = 0;
+    Cpa32U i = 0;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    status = icp_sal_DcPollDpInstanceBatch(
+        instanceHandle, pOpData, dcDpBatchPoll_g, &numResponses);
+    for (i = 0; i < numResponses; i++)
+    {
+        dcDpProcessResponse(pOpData[i]);
+    }
+    return status;
+}
+
+#ifdef USER_SPACE
+/**
+ *****************************************************************************
+ * @ingroup sampleCompressionDpPerf
+ *
+ * @description
+ *  Print the doorbell flushes of the instance since pStart was read
+ ******************************************************************************/
+static void dcDpPrintFlushStats(CpaInstanceHandle instanceHandle,
+                                const icp_sal_dp_flush_stats_t *pStart)
+{
+    icp_sal_dp_flush_stats_t flushStats = {0};
+
+    if (CPA_STATUS_SUCCESS !=
+        icp_sal_dp_get_flush_stats(instanceHandle, &flushStats))
+    {
+        return;
+    }
+    PRINT("Doorbell flushes: batch %llu, budget %llu, explicit %llu, "
+          "requests %llu\n",
+          (unsigned long long)(flushStats.numFlushBatch -
+                               pStart->numFlushBatch),
+          (unsigned long long)(flushStats.numFlushBudget -
+                               pStart->numFlushBudget),
+          (unsigned long long)(flushStats.numFlushExplicit -
+                               pStart->numFlushExplicit),
+          (unsigned long long)(flushStats.numRequestsFlushed -
+                               pStart->numRequestsFlushed));
+}
+#endif
+
 /**
  *****************************************************************************
  * @ingroup sampleCompressionDpPerf
@@ -432,7 +553,7 @@ static CpaStatus compressCorpusPreDecomp(compression_test_params_t *setup,
                 if (CPA_STATUS_RETRY == status)
                 {
                     setup->performanceStats->retries++;
-                    icp_sal_DcPollDpInstance(setup->dcInstanceHandle, 0);
+                    dcDpPollFunc_g(setup->dcInstanceHandle, 0);
                     AVOID_SOFTLOCKUP;
                 }
                 if (perfData->threadReturnStatus == CPA_STATUS_FAIL)
@@ -462,7 +583,7 @@ static CpaStatus compressCorpusPreDecomp(compression_test_params_t *setup,
             }
             if (++submittedOps == OPERATIONS_POLLING_INTERVAL)
             {
-                icp_sal_DcPollDpInstance(setup->dcInstanceHandle, 0);
+                dcDpPollFunc_g(setup->dcInstanceHandle, 0);
             }
         } /* End of number of buffers Loop */
     }     /* End of number of Files Loop*/
@@ -545,7 +666,7 @@ static CpaStatus performDcDpBatchOp(compression_test_params_t *setup,
                     if (CPA_STATUS_RETRY == status)
                     {
                         setup->performanceStats->retries++;
-                        icp_sal_DcPollDpInstance(setup->dcInstanceHandle, 0);
+                        dcDpPollFunc_g(setup->dcInstanceHandle, 0);
                         AVOID_SOFTLOCKUP;
                     }
                     if (perfData->threadReturnStatus == CPA_STATUS_FAIL)
@@ -586,8 +707,10 @@ static CpaStatus performDcDpBatchOp(compression_test_params_t *setup,
                 }
                 if (++submittedOps == OPERATIONS_POLLING_INTERVAL)
                 {
-                    coo_poll_dp_dc(
-                        perfData, setup->dcInstanceHandle, &pollStatus);
+                    coo_poll(perfData,
+                             dcDpPollFunc_g,
+                             setup->dcInstanceHandle,
+                             &pollStatus);
                 }
             } /* End of number of buffers Loop */
             if (CPA_STATUS_SUCCESS != status)
@@ -745,8 +868,19 @@ static CpaStatus performDcDpEnqueueOp(compression_test_params_t *setup,
                  * submit the last buffer of the current corpus file then
                  * enqueue and perform the enqueued operations now.
                  */
-                if (++numOps % setup->numRequests == 0 ||
-                    j + 1 == setup->numberOfBuffers[i])
+                if (0 != dcDpFlushBatchSize_g)
+                {
+                    /* The library flushes, only the last request of the
+                     * run is submitted straight away */
+                    ++numOps;
+                    performOpNowFlag =
+                        (numLoops + 1 == compressLoops && i + 1 == numFiles &&
+                         j + 1 == setup->numberOfBuffers[i])
+                            ? CPA_TRUE
+                            : CPA_FALSE;
+                }
+                else if (++numOps % setup->numRequests == 0 ||
+                         j + 1 == setup->numberOfBuffers[i])
                 {
                     performOpNowFlag = CPA_TRUE;
                 }
@@ -794,8 +928,10 @@ static CpaStatus performDcDpEnqueueOp(compression_test_params_t *setup,
                     if (CPA_STATUS_RETRY == status)
                     {
                         setup->performanceStats->retries++;
-                        coo_poll_dp_dc(
-                            perfData, setup->dcInstanceHandle, &pollStatus);
+                        coo_poll(perfData,
+                                 dcDpPollFunc_g,
+                                 setup->dcInstanceHandle,
+                                 &pollStatus);
                         nextPoll = numOps2 + dcPollingInterval_g;
                         AVOID_SOFTLOCKUP;
                     }
@@ -895,8 +1031,7 @@ static CpaStatus performDcDpEnqueueOp(compression_test_params_t *setup,
                              * completes
                              * and dcPerformCallback() increments
                              * perfData->responses */
-                            icp_sal_DcPollDpInstance(setup->dcInstanceHandle,
-                                                     0);
+                            dcDpPollFunc_g(setup->dcInstanceHandle, 0);
                         }
                     }
                 }
@@ -918,8 +1053,10 @@ static CpaStatus performDcDpEnqueueOp(compression_test_params_t *setup,
                 if ((numOps2 == nextPoll) ||
                     (numOps % OPERATIONS_POLLING_INTERVAL == 0))
                 {
-                    coo_poll_dp_dc(
-                        perfData, setup->dcInstanceHandle, &pollStatus);
+                    coo_poll(perfData,
+                             dcDpPollFunc_g,
+                             setup->dcInstanceHandle,
+                             &pollStatus);
                     if (CPA_STATUS_FAIL == pollStatus)
 
                     {
@@ -1252,6 +1389,10 @@ static CpaStatus dcDpPerform(compression_test_params_t *setup)
     CpaPhysFlatBuffer ***cmpFlatBuffArray = NULL;
     Cpa32U numFiles = 0;
     const corpus_file_t *fileArray = NULL;
+#ifdef USER_SPACE
+    /* Doorbell flush counters before the test */
+    icp_sal_dp_flush_stats_t flushStats = {0};
+#endif
 
     if (NULL == setup)
     {
@@ -1847,7 +1988,30 @@ static CpaStatus dcDpPerform(compression_test_params_t *setup)
         perfData->responses = 0;
     }
 
+#ifdef USER_SPACE
+    if (0 != dcDpFlushBatchSize_g)
+    {
+        icp_sal_dp_get_flush_stats(setup->dcInstanceHandle, &flushStats);
+        status = icp_sal_dp_set_flush_policy(setup->dcInstanceHandle,
+                                             dcDpFlushBatchSize_g,
+                                             dcDpFlushBudgetUs_g);
+        if (CPA_STATUS_SUCCESS != status)
+        {
+            PRINT_ERR("Unable to set the flush policy, status = %d\n",
+                      status);
+            status = CPA_STATUS_FAIL;
+            goto exit;
+        }
+    }
+#endif
     status = PerformOp(setup, compressionOpData, decompressionOpData, perfData);
+#ifdef USER_SPACE
+    if (0 != dcDpFlushBatchSize_g)
+    {
+        dcDpPrintFlushStats(setup->dcInstanceHandle, &flushStats);
+        icp_sal_dp_set_flush_policy(setup->dcInstanceHandle, 0, 0);
+    }
+#endif
 #ifdef LATENCY_CODE
     if ((latency_enable) && (latency_debug))
     {
@@ -56,6 +56,9 @@
 #include "cpa_dc_dp.h"
 #include "cpa_sample_code_dc_perf.h"
 
+/* maximum number of responses returned by one batch poll */
+#define DC_DP_MAX_BATCH_POLL 128
+
 /* step back for the dynamic algorithm */
 #define DP_BACKOFF_STEP_BACK 20
 /* step forward for the dynamic algorithm */
@@ -105,4 +108,42 @@ CpaStatus setupDcDpTest(CpaDcCompType algorithm,
                         Cpa32U numRequests,
                         Cpa32U numLoops);
 
+/**
+ * *****************************************************************************
+ *  @ingroup compressionThreads
+ *  setDcDpBatchPoll
+ *
+ *  @description
+ *      Selects icp_sal_DcPollDpInstanceBatch to poll the data plane
+ *      instances, returning up to maxResponses completed requests per
+ *      poll without invoking the callback. 0 restores the callback based
+ *      icp_sal_DcPollDpInstance.
+ *  @threadSafe
+ *      No
+ *
+ *  @param[in]  maxResponses    Responses per poll, up to
+ *                              DC_DP_MAX_BATCH_POLL
+ ******************************************************************************/
+CpaStatus setDcDpBatchPoll(Cpa32U maxResponses);
+
+/**
+ * *****************************************************************************
+ *  @ingroup compressionThreads
+ *  setDcDpFlushPolicy
+ *
+ *  @description
+ *      Sets the doorbell flush policy applied to the data plane instances
+ *      with icp_sal_dp_set_flush_policy during the enqueue tests. The
+ *      tests then enqueue with performOpNow set to CPA_FALSE, except for
+ *      the last request, and print the flushes by reason. Only used in
+ *      user space.
+ *  @threadSafe
+ *      No
+ *
+ *  @param[in]  batchSize       Queued requests triggering a flush, 0 to
+ *                              keep the flushes of the test
+ *  @param[in]  budgetUs        Time budget in microseconds, 0 for none
+ ******************************************************************************/
+CpaStatus setDcDpFlushPolicy(Cpa32U batchSize, Cpa32U budgetUs);
+
 #endif /* CPA_SAMPLE_CODE_DC_DP_H_ */
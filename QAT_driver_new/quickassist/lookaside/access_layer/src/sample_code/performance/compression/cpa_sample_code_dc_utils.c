@@ -79,6 +79,18 @@ static Cpa32U setupCnVRequestFlag = CNV_FLAG_DEFAULT;
 
 Cpa32U dcPollingInterval_g = OPERATIONS_POLLING_INTERVAL;
 EXPORT_SYMBOL(dcPollingInterval_g);
+/* Responses per batch poll of a data plane instance, 0 for callbacks */
+Cpa32U dcDpBatchPoll_g = 0;
+EXPORT_SYMBOL(dcDpBatchPoll_g);
+/* Function polling the data plane instances */
+CpaStatus (*dcDpPollFunc_g)(CpaInstanceHandle, Cpa32U) =
+    icp_sal_DcPollDpInstance;
+EXPORT_SYMBOL(dcDpPollFunc_g);
+/* Doorbell flush policy of the data plane instances, 0 to leave it off */
+Cpa32U dcDpFlushBatchSize_g = 0;
+EXPORT_SYMBOL(dcDpFlushBatchSize_g);
+Cpa32U dcDpFlushBudgetUs_g = 0;
+EXPORT_SYMBOL(dcDpFlushBudgetUs_g);
 CpaBoolean gUseStatefulLite = CPA_FALSE;
 EXPORT_SYMBOL(gUseStatefulLite);
 CpaDcChecksum gChecksum = CPA_DC_NONE;
@@ -1147,11 +1159,11 @@ CpaStatus dcDpPollNumOperationsRetries(perf_data_t *pPerfData,
 
     while (pPerfData->responses != numOperations)
     {
-        coo_poll_dp_dc(pPerfData, instanceHandle, &status);
+        coo_poll(pPerfData, dcDpPollFunc_g, instanceHandle, &status);
         /* in case when polling is used to process request's response
            which is not handled by coo measurement */
         if (CPA_STATUS_FAIL == status)
-            status = icp_sal_DcPollDpInstance(instanceHandle, 0);
+            status = dcDpPollFunc_g(instanceHandle, 0);
         if (CPA_STATUS_FAIL == status)
         {
             PRINT_ERR("Error polling instance\n");
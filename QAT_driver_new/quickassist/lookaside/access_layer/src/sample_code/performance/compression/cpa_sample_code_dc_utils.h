@@ -88,6 +88,10 @@
 #define OPERATIONS_POLLING_INTERVAL (10)
 
 extern Cpa32U dcPollingInterval_g;
+extern Cpa32U dcDpBatchPoll_g;
+extern CpaStatus (*dcDpPollFunc_g)(CpaInstanceHandle, Cpa32U);
+extern Cpa32U dcDpFlushBatchSize_g;
+extern Cpa32U dcDpFlushBudgetUs_g;
 extern CpaBoolean gUseStatefulLite;
 extern CpaDcChecksum gChecksum;
 extern CpaDcAutoSelectBest gAutoSelectBestMode;
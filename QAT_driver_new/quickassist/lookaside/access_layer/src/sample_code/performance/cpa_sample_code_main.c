@@ -137,7 +137,10 @@ option_t optArray[MAX_NUMOPT] = {
     {"getOffloadCost", 0},
     {"includeLZ4", DEFAULT_INCLUDE_LZ4},
     {"compOnly", 0},
-    {"verboseOutput", 1}};
+    {"verboseOutput", 1},
+    {"dcDpBatchPoll", 0},
+    {"dcDpFlushBatch", 0},
+    {"dcDpFlushBudgetUs", 0}};
 
 #define SIGN_OF_LIFE_OPT_ARRAY_POS (0)
 #define RUN_TEST_OPT_ARRAY_POS (1)
@@ -152,6 +155,9 @@ option_t optArray[MAX_NUMOPT] = {
 #define GET_LATENCY_POS (10)
 #define GET_OFFLOAD_COST_POS (11)
 #define RUN_LZ4_TEST_POS (12)
+#define DC_DP_BATCH_POLL_POS (15)
+#define DC_DP_FLUSH_BATCH_POS (16)
+#define DC_DP_FLUSH_BUDGET_POS (17)
 
 #else /* #ifdef USER_SPACE */
 
@@ -350,6 +356,16 @@ int main(int argc, char *argv[])
     computeLatency = optArray[GET_LATENCY_POS].optValue;
     computeOffloadCost = optArray[GET_OFFLOAD_COST_POS].optValue;
     includeLZ4 = optArray[RUN_LZ4_TEST_POS].optValue;
+#ifdef INCLUDE_COMPRESSION
+    if ((CPA_STATUS_SUCCESS !=
+         setDcDpBatchPoll(optArray[DC_DP_BATCH_POLL_POS].optValue)) ||
+        (CPA_STATUS_SUCCESS !=
+         setDcDpFlushPolicy(optArray[DC_DP_FLUSH_BATCH_POS].optValue,
+                            optArray[DC_DP_FLUSH_BUDGET_POS].optValue)))
+    {
+        return 0;
+    }
+#endif
 
 #ifndef LATENCY_CODE
     /* If Latency support is not compiled in and the user asks
@@ -79,6 +79,10 @@
 #include "lac_sal.h"
 #include "lac_sal_ctrl.h"
 #include "dc_session.h"
+#include "dc_dict.h"
+#include "dc_precheck.h"
+#include "dc_sizing.h"
+#include "dc_inline.h"
 #include "dc_ns_datapath.h"
 
 static OsalMutex sync_lock;
@@ -326,6 +330,219 @@ CpaStatus icp_sal_cnv_simulate_error(CpaInstanceHandle dcInstance,
     return dcSetCnvError(dcInstance, pSessionHandle);
 }
 
+CpaStatus icp_sal_dc_set_stateful_pipeline_depth(
+    CpaInstanceHandle dcInstance,
+    CpaDcSessionHandle pSessionHandle,
+    Cpa32U depth)
+{
+    return dcSetStatefulPipelineDepth(dcInstance, pSessionHandle, depth);
+}
+
+CpaStatus icp_sal_dc_set_cnv_policy(CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle,
+                                    icp_sal_dc_cnv_policy_t policy,
+                                    Cpa32U sampleInterval)
+{
+    return dcSetCnvPolicy(
+        dcInstance, pSessionHandle, (dc_cnv_policy_t)policy, sampleInterval);
+}
+
+CpaStatus icp_sal_dc_get_cnv_stats(CpaInstanceHandle dcInstance,
+                                   CpaDcSessionHandle pSessionHandle,
+                                   icp_sal_dc_cnv_stats_t *pCnvStats)
+{
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pCnvStats);
+#endif
+    return dcGetCnvPolicyStats(dcInstance,
+                               pSessionHandle,
+                               &pCnvStats->numDeviceVerified,
+                               &pCnvStats->numNotVerified,
+                               &pCnvStats->numSwVerified,
+                               &pCnvStats->numSwVerifyErrors);
+}
+
+CpaStatus icp_sal_dc_set_precheck(CpaInstanceHandle dcInstance,
+                                  CpaDcSessionHandle pSessionHandle,
+                                  CpaBoolean enable,
+                                  Cpa32U entropyThreshold,
+                                  Cpa32U auditInterval)
+{
+    return dcSetPrecheck(dcInstance,
+                         pSessionHandle,
+                         enable,
+                         entropyThreshold,
+                         auditInterval);
+}
+
+CpaStatus icp_sal_dc_get_precheck_stats(
+    CpaInstanceHandle dcInstance,
+    CpaDcSessionHandle pSessionHandle,
+    icp_sal_dc_precheck_stats_t *pPrecheckStats)
+{
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pPrecheckStats);
+#endif
+    return dcGetPrecheckStats(dcInstance,
+                              pSessionHandle,
+                              &pPrecheckStats->numChecked,
+                              &pPrecheckStats->numStored,
+                              &pPrecheckStats->numAudited,
+                              &pPrecheckStats->numAuditCompressible,
+                              &pPrecheckStats->numMissed);
+}
+
+CpaStatus icp_sal_dc_set_dest_sizing(CpaInstanceHandle dcInstance,
+                                     CpaDcSessionHandle pSessionHandle,
+                                     CpaBoolean enable)
+{
+    return dcSetDestSizing(dcInstance, pSessionHandle, enable);
+}
+
+CpaStatus icp_sal_dc_get_dest_size_hint(CpaInstanceHandle dcInstance,
+                                        CpaDcSessionHandle pSessionHandle,
+                                        Cpa32U srcLen,
+                                        Cpa32U overflowPpm,
+                                        Cpa32U *pDestLen)
+{
+    return dcGetDestSizeHint(
+        dcInstance, pSessionHandle, srcLen, overflowPpm, pDestLen);
+}
+
+CpaStatus icp_sal_dc_get_dest_sizing_stats(
+    CpaInstanceHandle dcInstance,
+    CpaDcSessionHandle pSessionHandle,
+    icp_sal_dc_sizing_stats_t *pSizingStats)
+{
+#ifdef ICP_PARAM_CHECK
+    LAC_CHECK_NULL_PARAM(pSizingStats);
+#endif
+    return dcGetDestSizingStats(dcInstance,
+                                pSessionHandle,
+                                &pSizingStats->numSamples,
+                                &pSizingStats->numOverflows);
+}
+
+CpaStatus icp_sal_dc_set_inline_threshold(CpaInstanceHandle dcInstance,
+                                          CpaDcSessionHandle pSessionHandle,
+                                          Cpa32U threshold)
+{
+    return dcSetInlineThreshold(dcInstance, pSessionHandle, threshold);
+}
+
+CpaStatus icp_sal_dc_set_dictionary(CpaInstanceHandle dcInstance,
+                                    CpaDcSessionHandle pSessionHandle,
+                                    const Cpa8U *pDict,
+                                    Cpa32U dictLen,
+                                    Cpa32U dictId)
+{
+    return dcSetDictionary(
+        dcInstance, pSessionHandle, pDict, dictLen, dictId);
+}
+
+/*
+ * salDpFlushGet
+ * Return the doorbell scheduler and the request ring of a data plane
+ * instance
+ */
+STATIC CpaStatus salDpFlushGet(CpaInstanceHandle instanceHandle,
+                               sal_dp_flush_t **ppFlush,
+                               icp_comms_trans_handle *pTransHandle)
+{
+    sal_service_t *pGenericService = (sal_service_t *)instanceHandle;
+
+    LAC_CHECK_NULL_PARAM(instanceHandle);
+
+    if (SAL_SERVICE_TYPE_COMPRESSION == pGenericService->type)
+    {
+        sal_compression_service_t *pService =
+            (sal_compression_service_t *)instanceHandle;
+
+        *ppFlush = &pService->dcDpFlush;
+        *pTransHandle = pService->trans_handle_compression_tx;
+        return CPA_STATUS_SUCCESS;
+    }
+#ifndef ICP_DC_ONLY
+    if ((SAL_SERVICE_TYPE_CRYPTO == pGenericService->type) ||
+        (SAL_SERVICE_TYPE_CRYPTO_SYM == pGenericService->type))
+    {
+        sal_crypto_service_t *pService = (sal_crypto_service_t *)instanceHandle;
+
+        *ppFlush = &pService->symDpFlush;
+        *pTransHandle = pService->trans_handle_sym_tx;
+        return CPA_STATUS_SUCCESS;
+    }
+#endif
+
+    LAC_INVALID_PARAM_LOG("Instance handle type is incorrect");
+    return CPA_STATUS_INVALID_PARAM;
+}
+
+CpaStatus icp_sal_dp_set_flush_policy(CpaInstanceHandle instanceHandle,
+                                      Cpa32U batchSize,
+                                      Cpa32U budgetUs)
+{
+    sal_dp_flush_t *pFlush = NULL;
+    icp_comms_trans_handle trans_handle = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    status = salDpFlushGet(instanceHandle, &pFlush, &trans_handle);
+    LAC_CHECK_STATUS(status);
+
+    if ((0 == batchSize) && (0 != budgetUs))
+    {
+        LAC_INVALID_PARAM_LOG("A time budget requires a batch size");
+        return CPA_STATUS_INVALID_PARAM;
+    }
+
+    /* Submit the requests queued under the previous policy */
+    if ((0 != pFlush->numQueued) &&
+        (CPA_TRUE == icp_adf_queueDataToSend(trans_handle)))
+    {
+        status = icp_adf_updateQueueTail(trans_handle);
+        LAC_CHECK_STATUS(status);
+        SalDpFlush_Explicit(pFlush);
+    }
+    SalDpFlush_Done(pFlush);
+
+    pFlush->batchSize = batchSize;
+    pFlush->budgetNs = (Cpa64U)budgetUs * 1000;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_dp_get_flush_stats(CpaInstanceHandle instanceHandle,
+                                     icp_sal_dp_flush_stats_t *pFlushStats)
+{
+    sal_dp_flush_t *pFlush = NULL;
+    icp_comms_trans_handle trans_handle = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    LAC_CHECK_NULL_PARAM(pFlushStats);
+
+    status = salDpFlushGet(instanceHandle, &pFlush, &trans_handle);
+    LAC_CHECK_STATUS(status);
+
+    pFlushStats->numFlushBatch = pFlush->numFlushBatch;
+    pFlushStats->numFlushBudget = pFlush->numFlushBudget;
+    pFlushStats->numFlushExplicit = pFlush->numFlushExplicit;
+    pFlushStats->numRequestsFlushed = pFlush->numRequestsFlushed;
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_dp_flush_expired(CpaInstanceHandle instanceHandle)
+{
+    sal_dp_flush_t *pFlush = NULL;
+    icp_comms_trans_handle trans_handle = NULL;
+    CpaStatus status = CPA_STATUS_SUCCESS;
+
+    status = salDpFlushGet(instanceHandle, &pFlush, &trans_handle);
+    LAC_CHECK_STATUS(status);
+
+    return SalDpFlush_FlushExpired(pFlush, trans_handle);
+}
+
 CpaStatus icp_sal_ns_cnv_simulate_error(CpaInstanceHandle dcInstance)
 {
     return dcNsEnableCnvErrorInj(dcInstance, CPA_TRUE);
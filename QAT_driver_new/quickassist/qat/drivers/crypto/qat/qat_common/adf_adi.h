@@ -47,10 +47,31 @@ struct adf_adi_info {
 	struct adf_adi_ep *adis;
 };
 
+#define ADI_VREG_TABLE_SIZE	32
+#define ADI_VREG_RD		BIT(0)
+#define ADI_VREG_WR		BIT(1)
+#define ADI_VREG_RW		(ADI_VREG_RD | ADI_VREG_WR)
+
+/* Translation of one guest visible vreg to its physical CSR, built once
+ * at ADI init so trapped accesses only need a table lookup.
+ * pre_write may veto the write by returning an error; post_write runs
+ * after the value has reached the device.
+ */
+struct adi_vreg_entry {
+	u32 pos;
+	u32 offset;
+	u32 flags;
+	int (*pre_write)(struct adf_adi_ep *adi, void __iomem *base,
+			 u32 offset, u32 val);
+	int (*post_write)(struct adf_adi_ep *adi, void __iomem *base,
+			  u32 offset, u32 val);
+};
+
 struct adi_priv_data {
 	struct adf_bar *etr_bar;
 	struct adf_bar *misc_bar;
 	struct adi_mmio_info etr_mmap;
+	struct adi_vreg_entry vregs[ADI_VREG_TABLE_SIZE];
 };
 
 struct msi_msg;
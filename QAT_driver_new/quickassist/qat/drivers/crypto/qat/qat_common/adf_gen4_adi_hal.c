@@ -21,8 +21,132 @@
 	(ADF_RING_BUNDLE_SIZE_GEN4 * (bank)) + \
 	(ofs))
 
+/* Collision free index of the ADF_VQAT_* vregs into adi_priv_data.vregs:
+ * bit 0 picks R0/R1, bits 1-3 the 64 byte register group and bit 4 the
+ * 0x1000 config window. Aliasing positions are rejected by comparing the
+ * stored vreg position.
+ */
+#define GEN4_ADI_VREG_SLOT(pos) \
+	((((((pos) >> 6) & 0x7) | (((pos) >> 9) & 0x8)) << 1) | \
+	(((pos) >> 2) & 0x1))
+
 static int hal_rp_set_pasid(struct adf_adi_ep *adi, int pasid);
 
+static int gen4_adi_rpresetctl_pre_write(struct adf_adi_ep *adi,
+					 void __iomem *base, u32 offset,
+					 u32 val)
+{
+	u32 req = ADF_GET_RPRESETCTL_VALUE(val);
+
+	/* TODO: we need to translate guest pasid value to host pasid
+	 * value when rpresetctl register is enabled for pasid level
+	 * reset
+	 */
+	if (req == PASID_LEVEL_RESET) {
+		dev_dbg(&GET_DEV(adi->parent),
+			"%s: unsupported pasid level reset\n", __func__);
+		return -EINVAL;
+	}
+
+	if (adi->reset_complete) {
+		if (req == RING_LEVEL_RESET)
+			adi->reset_complete = false;
+		return 0;
+	}
+
+	return req == RING_LEVEL_ABORT ? 0 : -EINVAL;
+}
+
+static int gen4_adi_rpresetsts_pre_write(struct adf_adi_ep *adi,
+					 void __iomem *base, u32 offset,
+					 u32 val)
+{
+	/* Assume rp reset complete when rpresetsts register
+	 * bit#0 is set and write rpresetsts register bit#0 as 1
+	 */
+	if (ADF_CSR_RD(base, offset) & ADF_WQM_CSR_RPRESETSTS_MASK &&
+	    val == ADF_WQM_CSR_RPRESETSTS_MASK)
+		adi->reset_complete = true;
+
+	return 0;
+}
+
+static int gen4_adi_rpresetsts_post_write(struct adf_adi_ep *adi,
+					  void __iomem *base, u32 offset,
+					  u32 val)
+{
+	u32 pasid_val;
+
+	/* After rpresetsts bit#0 is set, restore pasid value */
+	pasid_val = ADF_CSR_RD(base, ADF_WQM_CSR_PASIDCTL(adi->bank_idx));
+	if (!ADF_GET_PASIDCTL_PASID_VALUE(pasid_val) && adi->pasid > 0)
+		if (hal_rp_set_pasid(adi, adi->pasid))
+			return -EINVAL;
+
+	return 0;
+}
+
+static int gen4_adi_vreg_map(struct adi_priv_data *priv, u32 pos, u32 offset,
+			     u32 flags,
+			     int (*pre_write)(struct adf_adi_ep *,
+					      void __iomem *, u32, u32),
+			     int (*post_write)(struct adf_adi_ep *,
+					       void __iomem *, u32, u32))
+{
+	struct adi_vreg_entry *vreg = &priv->vregs[GEN4_ADI_VREG_SLOT(pos)];
+
+	if (WARN_ON(vreg->flags))
+		return -EEXIST;
+
+	vreg->pos = pos;
+	vreg->offset = offset;
+	vreg->flags = flags;
+	vreg->pre_write = pre_write;
+	vreg->post_write = post_write;
+
+	return 0;
+}
+
+static int gen4_adi_vreg_init(struct adi_priv_data *priv, u32 bank)
+{
+	static const struct {
+		u32 pos;
+		u32 csr;
+	} ring_vregs[] = {
+		{ ADF_VQAT_R0_CONFIG, ADF_RING_CSR_RING_CONFIG_GEN4 },
+		{ ADF_VQAT_R1_CONFIG, ADF_RING_CSR_RING_CONFIG_GEN4 + 4 },
+		{ ADF_VQAT_R0_LBASE, ADF_RING_CSR_RING_LBASE_GEN4 },
+		{ ADF_VQAT_R1_LBASE, ADF_RING_CSR_RING_LBASE_GEN4 + 4 },
+		{ ADF_VQAT_R0_UBASE, ADF_RING_CSR_RING_UBASE_GEN4 },
+		{ ADF_VQAT_R1_UBASE, ADF_RING_CSR_RING_UBASE_GEN4 + 4 },
+		{ ADF_VQAT_R0_HEAD, ADF_RING_CSR_RING_HEAD },
+		{ ADF_VQAT_R1_HEAD, ADF_RING_CSR_RING_HEAD + 4 },
+		{ ADF_VQAT_R0_TAIL, ADF_RING_CSR_RING_TAIL },
+		{ ADF_VQAT_R1_TAIL, ADF_RING_CSR_RING_TAIL + 4 },
+	};
+	int i, ret;
+
+	for (i = 0; i < ARRAY_SIZE(ring_vregs); i++) {
+		ret = gen4_adi_vreg_map(priv, ring_vregs[i].pos,
+					GEN4_CSR_OFFSET(bank,
+							ring_vregs[i].csr),
+					ADI_VREG_RW, NULL, NULL);
+		if (ret)
+			return ret;
+	}
+
+	ret = gen4_adi_vreg_map(priv, ADF_VQAT_RPRESETCTL,
+				ADF_WQM_CSR_RPRESETCTL(bank), ADI_VREG_RW,
+				gen4_adi_rpresetctl_pre_write, NULL);
+	if (ret)
+		return ret;
+
+	return gen4_adi_vreg_map(priv, ADF_VQAT_RPRESETSTS,
+				 ADF_WQM_CSR_RPRESETSTS(bank), ADI_VREG_RW,
+				 gen4_adi_rpresetsts_pre_write,
+				 gen4_adi_rpresetsts_post_write);
+}
+
 static int hal_rp_init(struct adf_adi_ep *adi)
 {
 	struct adf_accel_dev *accel_dev = NULL;
@@ -88,6 +212,11 @@ static int hal_rp_init(struct adf_adi_ep *adi)
 	if (!priv)
 		return -ENOMEM;
 
+	if (gen4_adi_vreg_init(priv, adi->bank_idx)) {
+		kfree(priv);
+		return -EFAULT;
+	}
+
 	adi->hw_priv = priv;
 	priv->etr_bar = etr_bar;
 	priv->misc_bar = misc_bar;
@@ -335,135 +464,50 @@ static int hal_rp_get_pasid(struct adf_adi_ep *adi)
 static int gen4_adi_mmio_rw32(struct adf_adi_ep *adi, u64 pos,
 			      void *buf, unsigned int len, bool is_write)
 {
-	struct adf_accel_dev *accel_dev;
+	const struct adi_vreg_entry *vreg;
 	struct adi_priv_data *priv;
 	void __iomem *base_addr;
-	u32 offset = 0;
-	u32 pasid_val;
+	u32 val;
+	int ret;
 
 	if (!adi || !adi->parent || !adi->hw_priv || !buf)
 		return -EINVAL;
 
-	accel_dev = adi->parent;
-	priv = adi->hw_priv;
-
-	dev_dbg(&GET_DEV(accel_dev),
-		"%s: ETR %s %d bytes at vreg offset@0x%llx\n",
-		__func__, is_write ? "write" : "read", len, pos);
-
 	if (len != 4)
 		return -EINVAL;
 
+	priv = adi->hw_priv;
 	if (!priv->etr_bar || !priv->etr_bar->virt_addr)
 		return -EINVAL;
 
-	base_addr = priv->etr_bar->virt_addr;
-	switch (pos) {
-	case ADF_VQAT_R0_CONFIG:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_CONFIG_GEN4);
-		break;
-	case ADF_VQAT_R1_CONFIG:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_CONFIG_GEN4 + 4);
-		break;
-	case ADF_VQAT_R0_LBASE:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_LBASE_GEN4);
-		break;
-	case ADF_VQAT_R1_LBASE:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_LBASE_GEN4 + 4);
-		break;
-	case ADF_VQAT_R0_UBASE:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_UBASE_GEN4);
-		break;
-	case ADF_VQAT_R1_UBASE:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_UBASE_GEN4 + 4);
-		break;
-	case ADF_VQAT_R0_HEAD:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_HEAD);
-		break;
-	case ADF_VQAT_R1_HEAD:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_HEAD + 4);
-		break;
-	case ADF_VQAT_R0_TAIL:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_TAIL);
-		break;
-	case ADF_VQAT_R1_TAIL:
-		offset = GEN4_CSR_OFFSET(adi->bank_idx,
-					 ADF_RING_CSR_RING_TAIL + 4);
-		break;
-	case ADF_VQAT_RPRESETCTL:
-		offset = ADF_WQM_CSR_RPRESETCTL(adi->bank_idx);
-
-		/* TODO: we need to translate guest pasid value to host pasid
-		 * value when rpresetctl register is enabled for pasid level
-		 * reset
-		 */
-		if (is_write) {
-			if (ADF_GET_RPRESETCTL_VALUE(*(u32 *)buf) ==
-			    PASID_LEVEL_RESET) {
-				dev_dbg(&GET_DEV(accel_dev),
-					"%s: unsupported pasid level reset\n",
-					__func__);
-				return -EINVAL;
-			}
-
-			if (adi->reset_complete) {
-				if (ADF_GET_RPRESETCTL_VALUE(*(u32 *)buf) ==
-				    RING_LEVEL_RESET)
-					adi->reset_complete = false;
-			} else {
-				if (ADF_GET_RPRESETCTL_VALUE(*(u32 *)buf) ==
-				    RING_LEVEL_ABORT)
-					break;
-				return -EINVAL;
-			}
-		}
-		break;
-	case ADF_VQAT_RPRESETSTS:
-		offset = ADF_WQM_CSR_RPRESETSTS(adi->bank_idx);
-
-		/* Assume rp reset complete when rpresetsts register
-		 * bit#0 is set and write rpresetsts register bit#0 as 1
-		 */
-		if (is_write) {
-			if (ADF_CSR_RD(base_addr, offset) &
-			    ADF_WQM_CSR_RPRESETSTS_MASK &&
-			    *(u32 *)buf == ADF_WQM_CSR_RPRESETSTS_MASK)
-				adi->reset_complete = true;
-		}
-		break;
-	default:
-		dev_dbg(&GET_DEV(accel_dev),
+	vreg = &priv->vregs[GEN4_ADI_VREG_SLOT(pos)];
+	if (vreg->pos != pos ||
+	    !(vreg->flags & (is_write ? ADI_VREG_WR : ADI_VREG_RD))) {
+		dev_dbg(&GET_DEV(adi->parent),
 			"%s: unsupported register access on adi %d\n",
 			__func__, adi->adi_idx);
 		return -EINVAL;
 	}
 
-	dev_dbg(&GET_DEV(accel_dev),
-		"%s: base_addr = %llx, translated offset = 0x%x\n",
-		__func__, (u64)base_addr, offset);
+	base_addr = priv->etr_bar->virt_addr;
+	if (!is_write) {
+		*(u32 *)buf = ADF_CSR_RD(base_addr, vreg->offset);
+		return (int)len;
+	}
 
-	if (is_write)
-		ADF_CSR_WR(base_addr, offset, *(u32 *)buf);
-	else
-		*(u32 *)buf = ADF_CSR_RD(base_addr, offset);
+	val = *(u32 *)buf;
+	if (vreg->pre_write) {
+		ret = vreg->pre_write(adi, base_addr, vreg->offset, val);
+		if (ret)
+			return ret;
+	}
 
-	/* After rpresetsts bit#0 is set, restore pasid value */
-	if (is_write && pos == ADF_VQAT_RPRESETSTS) {
-		pasid_val = ADF_CSR_RD(base_addr,
-				       ADF_WQM_CSR_PASIDCTL(adi->bank_idx));
+	ADF_CSR_WR(base_addr, vreg->offset, val);
 
-		if (!ADF_GET_PASIDCTL_PASID_VALUE(pasid_val) && adi->pasid > 0)
-			if (hal_rp_set_pasid(adi, adi->pasid))
-				return -EINVAL;
+	if (vreg->post_write) {
+		ret = vreg->post_write(adi, base_addr, vreg->offset, val);
+		if (ret)
+			return ret;
 	}
 
 	return (int)len;
@@ -825,6 +825,7 @@ dev_get_user_page(struct file *fp, uint32_t cmd, unsigned long arg)
     struct page *page;
     int errno = 0;
     void *phy_addr = NULL;
+    uint64_t hpage_size = 0;
     user_page_info_t user_mem_info = {0};
     user_proc_mem_list_t *list = NULL;
 
@@ -862,7 +863,10 @@ dev_get_user_page(struct file *fp, uint32_t cmd, unsigned long arg)
     {
        if (PageHuge(page))
        {
-           if (user_mem_info.size != PMD_SIZE)
+           /* Both 2M and 1G pages are mapped whole, from their start */
+           hpage_size = PAGE_SIZE << compound_order(compound_head(page));
+           if (user_mem_info.size != hpage_size ||
+               user_mem_info.virt_addr & (hpage_size - 1))
            {
                mm_err("%s:%d dev_get_user_page: user_mem_info.size is not "
                       "equal to hugepage_size, ret=%d\n",
@@ -197,6 +197,66 @@ void qaeMemFreeNUMA(void **ptr);
  ****************************************************************************/
 void qaeMemFreeNonZeroNUMA(void **ptr);
 
+/**
+ *****************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemAllocBatch
+ *
+ * @brief
+ *      Allocates n objects of contiguous and pinned memory in a single
+ *      allocation. Applicable for user space only.
+ *
+ * @description
+ *      The objects are laid out one after the other, in the order of
+ *      sizes, each aligned to phys_alignment_byte. They are physically
+ *      contiguous, so related objects share cache lines and pages, and
+ *      the allocator is entered once for the whole batch.
+ *
+ * @param[out] ptrs  - array receiving the address of each object
+ * @param[in]  sizes - size in bytes of each object, none may be zero
+ * @param[in]  n     - number of objects
+ * @param[in]  node  - NUMA node
+ * @param[in]  phys_alignment_byte - alignment of each object, a power of
+ *                                   2 supported by qaeMemAllocNUMA
+ *
+ * @retval 0 on success, -EINVAL for invalid parameters or -ENOMEM if the
+ *         memory cannot be allocated
+ *
+ * @pre
+ *      none
+ * @post
+ *      the objects are allocated, they must be freed together with
+ *      qaeMemFreeBatch
+ *
+ ****************************************************************************/
+int qaeMemAllocBatch(void **ptrs,
+                     const size_t *sizes,
+                     unsigned int n,
+                     int node,
+                     size_t phys_alignment_byte);
+
+/**
+ *****************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemFreeBatch
+ *
+ * @brief
+ *      Frees the objects allocated by qaeMemAllocBatch function.
+ *      Applicable for user space only.
+ *
+ * @param[in] ptrs - array filled by qaeMemAllocBatch
+ * @param[in] n    - number of objects of the batch
+ *
+ * @retval none
+ *
+ * @pre
+ *      ptrs holds the objects of a single call to qaeMemAllocBatch
+ * @post
+ *      memory is freed and the pointers are set to NULL
+ *
+ ****************************************************************************/
+void qaeMemFreeBatch(void **ptrs, unsigned int n);
+
 /**
  *****************************************************************************
  * @ingroup CommonMemoryDriver
@@ -299,6 +359,268 @@ int qaeUnregisterDevice(int fd);
  *
  ****************************************************************************/
 void qaeAtFork(void);
+
+/*! Number of buckets of the allocation size histogram. Bucket 0 counts the
+ * requests of up to 1 KB, bucket i those of more than 2^(9+i) and up to
+ * 2^(10+i) bytes. */
+#define QAE_MEM_STATS_HIST_BUCKETS (20)
+
+/**
+ *****************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      Process wide memory accounting
+ *
+ * @description
+ *      Bytes are accounted at the granularity they are reserved in, i.e.
+ *      rounded up to the 1 KB unit of the slab bitmap, to the size class
+ *      or to the size of a large slab.
+ *
+ ****************************************************************************/
+typedef struct qae_mem_stats_s
+{
+    uint64_t numAllocs;
+    /**< Successful allocations */
+    uint64_t numFrees;
+    /**< Successful frees */
+    uint64_t numFailedAllocs;
+    /**< Calls to qaeMemAllocNUMA that returned NULL */
+    uint64_t bytesInUse;
+    /**< Bytes allocated and not freed yet */
+    uint64_t numSlabs;
+    /**< Slabs of pinned memory currently mapped */
+    uint64_t slabBytes;
+    /**< Bytes of pinned memory currently mapped */
+    uint64_t sizeHistogram[QAE_MEM_STATS_HIST_BUCKETS];
+    /**< Successful allocations by requested size */
+} qae_mem_stats_t;
+
+/**
+ *****************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      Memory accounting of one thread
+ *
+ * @description
+ *      Memory freed by another thread than the one which allocated it is
+ *      accounted to the freeing thread, so only the sum over all threads
+ *      gives the memory in use.
+ *
+ ****************************************************************************/
+typedef struct qae_mem_thread_stats_s
+{
+    uint64_t threadId;
+    /**< Kernel thread id */
+    uint64_t numAllocs;
+    /**< Successful allocations made by the thread */
+    uint64_t numFrees;
+    /**< Successful frees made by the thread */
+    uint64_t bytesAllocated;
+    /**< Bytes allocated by the thread */
+    uint64_t bytesFreed;
+    /**< Bytes freed by the thread */
+} qae_mem_thread_stats_t;
+
+/*! Slab carved by the bitmap allocator */
+#define QAE_MEM_SLAB_BITMAP (0)
+/*! Unused slab kept for reuse */
+#define QAE_MEM_SLAB_CACHED (1)
+/*! Slab holding a single large allocation */
+#define QAE_MEM_SLAB_LARGE (2)
+/*! Slab dedicated to a size class */
+#define QAE_MEM_SLAB_SIZE_CLASS (3)
+
+/**
+ *****************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      Occupancy of one slab
+ *
+ * @description
+ *      freeBytes and largestFreeRun are only computed for the slabs of the
+ *      bitmap allocator. The largest free run is the biggest allocation the
+ *      slab can still serve, the further it is below freeBytes the more
+ *      fragmented the slab is.
+ *
+ ****************************************************************************/
+typedef struct qae_mem_slab_stats_s
+{
+    uint64_t virtAddr;
+    /**< Virtual address of the slab */
+    uint64_t size;
+    /**< Size of the slab in bytes */
+    int32_t node;
+    /**< NUMA node of the slab */
+    uint32_t type;
+    /**< One of the QAE_MEM_SLAB_ values */
+    uint32_t allocations;
+    /**< Number of allocations carved from the slab */
+    uint32_t reserved;
+    uint64_t freeBytes;
+    /**< Bytes of the slab not allocated */
+    uint64_t largestFreeRun;
+    /**< Largest contiguous free area of the slab in bytes */
+} qae_mem_slab_stats_t;
+
+/**
+ *****************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      Live allocations sampled at one call site
+ *
+ ****************************************************************************/
+typedef struct qae_mem_site_stats_s
+{
+    uint64_t caller;
+    /**< Return address of the call to qaeMemAllocNUMA, to be resolved with
+     * addr2line or dladdr */
+    uint64_t liveSamples;
+    /**< Sampled allocations made at the call site and not freed yet */
+    uint64_t liveBytes;
+    /**< Requested bytes of the live sampled allocations */
+} qae_mem_site_stats_t;
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemGetStats
+ *
+ * @brief
+ *      Returns the process wide memory accounting.
+ *
+ * @description
+ *      The counters of the threads are read without stopping them, so the
+ *      result is a consistent snapshot only when no allocation is in
+ *      flight.
+ *
+ * @param[out] pStats - accounting of the process
+ *
+ * @retval 0 on success, -EINVAL if pStats is NULL
+ *
+ ****************************************************************************/
+int qaeMemGetStats(qae_mem_stats_t *pStats);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemGetThreadStats
+ *
+ * @brief
+ *      Returns the memory accounting of the live threads which used the
+ *      allocator.
+ *
+ * @param[out] pStats   - array receiving one entry per thread
+ * @param[in]  maxStats - number of entries of pStats
+ *
+ * @retval number of entries written, or -EINVAL if pStats is NULL
+ *
+ ****************************************************************************/
+int qaeMemGetThreadStats(qae_mem_thread_stats_t *pStats,
+                         unsigned int maxStats);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemGetSlabStats
+ *
+ * @brief
+ *      Returns the occupancy of the slabs of pinned memory.
+ *
+ * @description
+ *      When the library is built with ICP_THREAD_SPECIFIC_USDM the slabs
+ *      are owned by threads and only those of the calling thread are
+ *      returned.
+ *
+ * @param[out] pStats   - array receiving one entry per slab
+ * @param[in]  maxStats - number of entries of pStats
+ *
+ * @retval number of entries written, or a negative errno value
+ *
+ ****************************************************************************/
+int qaeMemGetSlabStats(qae_mem_slab_stats_t *pStats, unsigned int maxStats);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemSetSampleRate
+ *
+ * @brief
+ *      Starts or stops recording the call site of one allocation in every
+ *      rate allocations of each thread.
+ *
+ * @description
+ *      Sampled allocations are forgotten when they are freed, so the sites
+ *      left after a long run are where the leaks come from. Up to a few
+ *      thousand allocations are tracked at once, further samples are
+ *      dropped. Stopping the sampling keeps the allocations tracked so
+ *      far.
+ *
+ * @param[in] rate - sampling period, 0 stops the sampling
+ *
+ * @retval none
+ *
+ ****************************************************************************/
+void qaeMemSetSampleRate(unsigned int rate);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemGetSampledSites
+ *
+ * @brief
+ *      Returns the live sampled allocations grouped by call site, the sites
+ *      holding the most bytes first.
+ *
+ * @param[out] pSites   - array receiving one entry per call site
+ * @param[in]  maxSites - number of entries of pSites
+ *
+ * @retval number of entries written, or a negative errno value
+ *
+ ****************************************************************************/
+int qaeMemGetSampledSites(qae_mem_site_stats_t *pSites,
+                          unsigned int maxSites);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemDumpStats
+ *
+ * @brief
+ *      Prints the memory accounting, a summary of the slabs and the call
+ *      sites holding the most sampled memory to stdout.
+ *
+ * @retval none
+ *
+ ****************************************************************************/
+void qaeMemDumpStats(void);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemStartStatsDump
+ *
+ * @brief
+ *      Starts a thread calling qaeMemDumpStats every period seconds, until
+ *      qaeMemStopStatsDump is called.
+ *
+ * @param[in] period - seconds between two dumps, must not be 0
+ *
+ * @retval 0 on success, -EINVAL for a zero period, -EBUSY if the periodic
+ *         dump is already running, -ENOTSUP without thread support or
+ *         another negative errno value if the thread cannot be created
+ *
+ ****************************************************************************/
+int qaeMemStartStatsDump(unsigned int period);
+
+/**
+ ***************************************************************************
+ * @ingroup CommonMemoryDriver
+ *      qaeMemStopStatsDump
+ *
+ * @brief
+ *      Stops the periodic dump started by qaeMemStartStatsDump and waits
+ *      for its thread to exit.
+ *
+ * @retval none
+ *
+ ****************************************************************************/
+void qaeMemStopStatsDump(void);
 #endif
 
 #ifdef __cplusplus
@@ -73,6 +73,8 @@
 
 #include "qae_mem_lib_utils.h"
 #include "qae_mem_utils_common.h"
+#include "qae_mem_size_class.h"
+#include "qae_mem_stats.h"
 
 /* Maximum supported alignment is 4M. */
 #define QAE_MAX_PHYS_ALIGN (0x400000ULL)
@@ -175,6 +177,13 @@ void *qaePhysToVirtNUMA(uint64_t physAddress)
             break;
         }
     }
+    for (slab = __qae_pUserClassListHead; NULL == ret && slab != NULL;
+         slab = slab->pNext_user)
+    {
+        offset = (uintptr_t)physAddress - (uintptr_t)slab->phy_addr;
+        if (offset < slab->size)
+            ret = (void *)((uintptr_t)slab->virt_addr + offset);
+    }
 
     status = mem_mutex_unlock(&mutex);
     if (status)
@@ -250,6 +259,52 @@ fork_exit:
     return;
 }
 
+int qaeMemGetSlabStats(qae_mem_slab_stats_t *pStats, unsigned int maxStats)
+{
+    unsigned int count = 0;
+    int ret = 0;
+
+    if (NULL == pStats)
+    {
+        CMD_ERROR("%s:%d Invalid stats pointer\n", __func__, __LINE__);
+        return -EINVAL;
+    }
+
+    ret = mem_mutex_lock(&mutex);
+    if (unlikely(ret))
+    {
+        CMD_ERROR(
+            "%s:%d Error(%d) on thread mutex lock \n", __func__, __LINE__, ret);
+        return -EIO;
+    }
+
+    count = __qae_stats_slab_list(
+        __qae_pUserMemListHead, QAE_MEM_SLAB_BITMAP, pStats, count, maxStats);
+    count = __qae_stats_slab_list(
+        __qae_pUserCacheHead, QAE_MEM_SLAB_CACHED, pStats, count, maxStats);
+    count = __qae_stats_slab_list(__qae_pUserLargeMemListHead,
+                                  QAE_MEM_SLAB_LARGE,
+                                  pStats,
+                                  count,
+                                  maxStats);
+    count = __qae_stats_slab_list(__qae_pUserClassListHead,
+                                  QAE_MEM_SLAB_SIZE_CLASS,
+                                  pStats,
+                                  count,
+                                  maxStats);
+
+    ret = mem_mutex_unlock(&mutex);
+    if (unlikely(ret))
+    {
+        CMD_ERROR("%s:%d Error(%d) on thread mutex unlock\n",
+                  __func__,
+                  __LINE__,
+                  ret);
+        return -EIO;
+    }
+    return (int)count;
+}
+
 API_LOCAL
 void __qae_free_slab(const int fd, dev_mem_info_t *slab)
 {
@@ -259,11 +314,16 @@ void __qae_free_slab(const int fd, dev_mem_info_t *slab)
     del_slab_from_hash(slab);
 
     memcpy(&memInfo, slab, sizeof(dev_mem_info_t));
-    /* Need to disconnect from orignal chain */
-    ret = qae_munmap(memInfo.virt_addr, memInfo.size);
-    if (ret)
+    /* Slabs carved from a 1G huge page stay mapped with the page */
+    if (!__qae_hugepage_in_region(memInfo.virt_addr))
     {
-        CMD_ERROR("%s:%d munmap failed, ret = %d\n", __func__, __LINE__, ret);
+        /* Need to disconnect from orignal chain */
+        ret = qae_munmap(memInfo.virt_addr, memInfo.size);
+        if (ret)
+        {
+            CMD_ERROR(
+                "%s:%d munmap failed, ret = %d\n", __func__, __LINE__, ret);
+        }
     }
     if (LARGE == memInfo.type)
     {
@@ -314,6 +374,7 @@ void __qae_ResetControl(void)
 {
     /* Reset all control structures. */
     free_page_table_fptr(&g_page_table);
+    __qae_v2p_invalidate();
     memset(&g_page_table, 0, sizeof(g_page_table));
     memset(&g_slab_list, 0, sizeof(g_slab_list));
     g_cache_size = 0;
@@ -324,6 +385,8 @@ void __qae_ResetControl(void)
     __qae_pUserMemListTail = NULL;
     __qae_pUserLargeMemListHead = NULL;
     __qae_pUserLargeMemListTail = NULL;
+    __qae_sc_reset();
+    __qae_stats_reset();
 }
 
 int32_t qaeMemInit()
@@ -395,9 +458,12 @@ void qaeMemDestroy(void)
 
     /* release all control buffers */
     free_page_table_fptr(&g_page_table);
+    __qae_v2p_invalidate();
     __qae_reset_cache(g_fd);
     __qae_destroyList(g_fd, __qae_pUserMemListHead);
     __qae_destroyList(g_fd, __qae_pUserLargeMemListHead);
+    __qae_destroyList(g_fd, __qae_pUserClassListHead);
+    __qae_sc_reset();
 
     __qae_pUserCacheHead = NULL;
     __qae_pUserCacheTail = NULL;
@@ -436,15 +502,27 @@ void *__qae_alloc_addr(size_t size,
     if (0 != __qae_open())
         return NULL;
 
+    /* Only 1G huge pages provide allocations above QAE_MAX_ALLOC_SIZE */
+    if (size > QAE_MAX_ALLOC_SIZE && !__qae_hugepage_1g_enabled())
+    {
+#ifdef USE_VFIO_MAX_ALLOC_SIZE
+        CMD_ERROR(
+            "%s:%d Size cannot exceed 64M for vfio\n", __func__, __LINE__);
+#else
+        CMD_ERROR("%s:%d Size cannot exceed 4M for uio\n", __func__, __LINE__);
+#endif
+        return NULL;
+    }
+
     if (requested_pages > QAE_NUM_PAGES_PER_ALLOC * QAE_PAGE_SIZE / UNIT_SIZE ||
         phys_alignment_byte >= QAE_NUM_PAGES_PER_ALLOC * QAE_PAGE_SIZE)
     {
         mem_type = LARGE;
-        /* Huge page and Large memory are mutually exclusive
-         * Since Large slabs are NOT 2 MB aligned, but huge
-         * pages are always 2 MB aligned.
+        /* Large slabs need physically contiguous huge pages, which
+         * only 1G huge pages provide: 2M huge pages are mapped one
+         * by one.
          */
-        if (__qae_hugepage_enabled())
+        if (__qae_hugepage_enabled() && !__qae_hugepage_1g_enabled())
             return NULL;
         size = MAX(size, phys_alignment_byte);
         allocate_pages = div_round_up(size, UNIT_SIZE);
@@ -485,6 +563,7 @@ void *__qae_alloc_addr(size_t size,
                                  __qae_pUserLargeMemListHead,
                                  __qae_pUserLargeMemListTail,
                                  _user);
+        __qae_stats_alloc(p_ctrl_blk->size);
 
         pVirtAddress = p_ctrl_blk->virt_addr;
     }
@@ -526,6 +605,7 @@ void *qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte)
 {
     void *pVirtAddress = NULL;
     int ret = 0;
+    int sc = -1;
 
     if (!size)
     {
@@ -533,14 +613,9 @@ void *qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte)
         return NULL;
     }
 
-    if (size > QAE_MAX_ALLOC_SIZE)
+    if (size > QAE_MAX_HUGEPAGE_ALLOC_SIZE)
     {
-#ifdef USE_VFIO_MAX_ALLOC_SIZE
-        CMD_ERROR(
-            "%s:%d Size cannot exceed 64M for vfio\n", __func__, __LINE__);
-#else
-        CMD_ERROR("%s:%d Size cannot exceed 4M for uio\n", __func__, __LINE__);
-#endif
+        CMD_ERROR("%s:%d Size cannot exceed 512M\n", __func__, __LINE__);
         return NULL;
     }
 
@@ -556,6 +631,15 @@ void *qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte)
         return NULL;
     }
 
+    /* Small allocations are served from the thread cache without locking */
+    sc = __qae_sc_class(size, node, phys_alignment_byte);
+    if (sc >= 0)
+    {
+        pVirtAddress = __qae_sc_alloc(sc, node);
+        if (NULL != pVirtAddress)
+            goto alloc_exit;
+    }
+
     ret = mem_mutex_lock(&mutex);
     if (unlikely(ret))
     {
@@ -563,10 +647,13 @@ void *qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte)
                   __func__,
                   __LINE__,
                   strerror(ret));
-        return NULL;
+        goto alloc_exit;
     }
 
-    pVirtAddress = __qae_alloc_addr(size, node, phys_alignment_byte);
+    if (sc >= 0 && 0 == __qae_open())
+        pVirtAddress = __qae_sc_refill(g_fd, sc, node);
+    if (NULL == pVirtAddress)
+        pVirtAddress = __qae_alloc_addr(size, node, phys_alignment_byte);
 
     ret = mem_mutex_unlock(&mutex);
     if (unlikely(ret))
@@ -577,6 +664,9 @@ void *qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte)
                   strerror(ret));
         return NULL;
     }
+
+alloc_exit:
+    __qae_stats_request(pVirtAddress, size, __builtin_return_address(0));
     return pVirtAddress;
 }
 
@@ -631,6 +721,7 @@ void __qae_free_addr(void **p_va, bool secure_free)
                                  __qae_pUserLargeMemListHead,
                                  __qae_pUserLargeMemListTail,
                                  _user);
+        __qae_stats_free(p_ctrl_blk->size);
         __qae_free_slab(g_fd, p_ctrl_blk);
     }
     *p_va = NULL;
@@ -658,6 +749,12 @@ void __qae_memFreeNUMA(void **ptr, bool secure_free)
             "%s:%d Address to be freed cannot be NULL \n", __func__, __LINE__);
         return;
     }
+    __qae_stats_release(*ptr);
+    if (__qae_sc_free(*ptr, secure_free))
+    {
+        *ptr = NULL;
+        return;
+    }
     ret = mem_mutex_lock(&mutex);
     if (ret)
     {
@@ -88,15 +88,26 @@ int __qae_hugepage_iommu_unmap(const int fd, const dev_mem_info_t *memInfo);
 API_LOCAL
 dev_mem_info_t *__qae_hugepage_alloc_slab(const int fd,
                                           const size_t size,
+                                          const size_t alignment,
                                           const int node,
                                           enum slabType type);
 
 API_LOCAL
 void __qae_hugepage_free_slab(const dev_mem_info_t *memInfo);
 
+API_LOCAL
+int __qae_hugepage_in_region(const void *virt_addr);
+
+API_LOCAL
+void __qae_hugepage_region_free_slab(const int fd,
+                                     const dev_mem_info_t *memInfo);
+
 API_LOCAL
 int __qae_init_hugepages(const int fd);
 
 API_LOCAL
 int __qae_hugepage_enabled(void);
+
+API_LOCAL
+int __qae_hugepage_1g_enabled(void);
 #endif
@@ -100,6 +100,7 @@
 #include "qae_mem_utils_common.h"
 #include "qae_mem_multi_thread.h"
 #include "qae_mem_hugepage_utils.h"
+#include "qae_mem_stats.h"
 #include <sys/syscall.h>
 
 /* Check for process pid caching availibility */
@@ -209,6 +210,40 @@ void qaeAtFork()
     return;
 }
 
+int qaeMemGetSlabStats(qae_mem_slab_stats_t *pStats, unsigned int maxStats)
+{
+    qae_mem_info_t *tls_ptr = NULL;
+    unsigned int count = 0;
+
+    if (NULL == pStats)
+    {
+        CMD_ERROR("%s:%d Invalid stats pointer\n", __func__, __LINE__);
+        return -EINVAL;
+    }
+
+    /* Slabs are owned by threads, only those of the caller are reported */
+    tls_ptr = (qae_mem_info_t *)pthread_getspecific(qae_key);
+    if (NULL == tls_ptr)
+        return 0;
+
+    count = __qae_stats_slab_list(tls_ptr->pUserMemListHead,
+                                  QAE_MEM_SLAB_BITMAP,
+                                  pStats,
+                                  count,
+                                  maxStats);
+    count = __qae_stats_slab_list(tls_ptr->pUserCacheHead,
+                                  QAE_MEM_SLAB_CACHED,
+                                  pStats,
+                                  count,
+                                  maxStats);
+    count = __qae_stats_slab_list(tls_ptr->pUserLargeMemListHead,
+                                  QAE_MEM_SLAB_LARGE,
+                                  pStats,
+                                  count,
+                                  maxStats);
+    return (int)count;
+}
+
 API_LOCAL
 void __qae_free_slab(const int fd,
                      dev_mem_info_t *slab,
@@ -323,6 +358,7 @@ int32_t qaeMemInit()
         return -ENOENT;
     }
     free_page_table_fptr(&g_page_table);
+    __qae_v2p_invalidate();
     memset(&g_page_table, 0, sizeof(g_page_table));
 
 #ifdef CACHE_PID
@@ -364,6 +400,8 @@ int32_t qaeMemInit()
         close(g_fd);
         return -EIO;
     }
+    /* Cached translations may have the wrong page size */
+    __qae_v2p_invalidate();
     return status;
 }
 
@@ -399,6 +437,7 @@ void qaeMemDestroy(void)
     qae_mem_info_t *tls_ptr = NULL;
 
     free_page_table_fptr(&g_page_table);
+    __qae_v2p_invalidate();
 #ifdef CACHE_PID
     if (cache_pid != NULL)
     {
@@ -531,6 +570,7 @@ void *__qae_alloc_addr(size_t size,
                                  tls_ptr->pUserLargeMemListHead,
                                  tls_ptr->pUserLargeMemListTail,
                                  _user);
+        __qae_stats_alloc(p_ctrl_blk->size);
 
         pVirtAddress = p_ctrl_blk->virt_addr;
     }
@@ -596,15 +636,16 @@ void *qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte)
         return NULL;
     }
 
-    if (0 != qaeMemInit())
-        return NULL;
-
-    if (!qae_mem_inited)
+    if (0 == qaeMemInit())
     {
-        qae_mem_init_t();
-    }
+        if (!qae_mem_inited)
+        {
+            qae_mem_init_t();
+        }
 
-    pVirtAddress = __qae_alloc_addr(size, node, phys_alignment_byte);
+        pVirtAddress = __qae_alloc_addr(size, node, phys_alignment_byte);
+    }
+    __qae_stats_request(pVirtAddress, size, __builtin_return_address(0));
     return pVirtAddress;
 }
 
@@ -666,6 +707,7 @@ void __qae_free_addr(void **p_va, bool secure_free)
                                  tls_ptr->pUserLargeMemListHead,
                                  tls_ptr->pUserLargeMemListTail,
                                  _user);
+        __qae_stats_free(p_ctrl_blk->size);
         __qae_free_slab(g_fd, p_ctrl_blk, tls_ptr);
     }
     *p_va = NULL;
@@ -692,6 +734,7 @@ void __qae_memFreeNUMA(void **ptr, bool secure_free)
             "%s:%d Address to be freed cannot be NULL \n", __func__, __LINE__);
         return;
     }
+    __qae_stats_release(*ptr);
     __qae_free_addr(ptr, secure_free);
 
     return;
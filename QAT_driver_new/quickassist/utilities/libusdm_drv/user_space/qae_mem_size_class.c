@@ -0,0 +1,530 @@
+/***************************************************************************
+ *
+ * This file is provided under a dual BSD/GPLv2 license.  When using or
+ *   redistributing this file, you may do so under either license.
+ * 
+ *   GPL LICENSE SUMMARY
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ * 
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of version 2 of the GNU General Public License as
+ *   published by the Free Software Foundation.
+ * 
+ *   This program is distributed in the hope that it will be useful, but
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   General Public License for more details.
+ * 
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ *   The full GNU General Public License is included in this distribution
+ *   in the file called LICENSE.GPL.
+ * 
+ *   Contact Information:
+ *   Intel Corporation
+ * 
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+/**
+ ****************************************************************************
+ * @file qae_mem_size_class.c
+ *
+ * This file provides the size class front end of the Linux user space
+ * memory allocator.
+ *
+ * Allocations up to 256 KB are rounded up to a power of two size class.
+ * Every class owns dedicated slabs which are carved into objects of the
+ * class size, the first object of a slab holding the slab descriptor.
+ * Each thread caches objects per class in two chains: the objects it
+ * freed and the objects it carved or took from the return stack of the
+ * class. Allocation and free only touch the thread cache in the common
+ * case, so they are O(1) and do not take the allocator lock.
+ *
+ * Objects freed by a thread go to its own cache whichever thread
+ * allocated them. Once a thread holds QAE_SC_CACHE_BYTES of freed objects
+ * of a class they are pushed as a single chain on the lock-free return
+ * stack of the class, from which any thread takes the whole stack when its
+ * cache is empty. Only whole chains are pushed and whole stacks taken, so
+ * the stack is not exposed to the ABA problem. The lock is only taken to
+ * carve a new batch of objects.
+ *
+ * The class of an object is found from its address with a second page
+ * table, tagging every page of the class slabs with the class and NUMA
+ * node slot. The class slabs are kept until qaeMemDestroy().
+ *
+ ***************************************************************************/
+
+#include "qae_mem_lib_utils.h"
+#include "qae_mem_size_class.h"
+#include "qae_mem_stats.h"
+
+/* Tag of the pages of a class slab: node slot in bits 4-7, class + 1 in
+ * bits 0-3, so a tag is never zero */
+#define QAE_SC_TAG(slot, sc) ((uint64_t)(((slot) << 4) | ((sc) + 1)))
+#define QAE_SC_TAG_CLASS(tag) ((int)((tag)&0xF) - 1)
+#define QAE_SC_TAG_SLOT(tag) ((int)((tag) >> 4))
+
+#define QAE_SC_OBJ_SIZE(sc) ((size_t)1 << ((sc) + QAE_SC_MIN_SHIFT))
+
+/* Chain of free objects linked through their first word */
+typedef struct
+{
+    void *head;
+    void *tail;
+    size_t count;
+} qae_sc_chain_t;
+
+/* Per-thread cache */
+typedef struct
+{
+    /* Objects freed by this thread */
+    qae_sc_chain_t freed[QAE_SC_NUM_NODES][QAE_SC_NUM_CLASSES];
+    /* Objects carved or taken from a return stack */
+    void *taken[QAE_SC_NUM_NODES][QAE_SC_NUM_CLASSES];
+    /* Objects of an older generation are no longer valid */
+    uint32_t generation;
+} qae_sc_cache_t;
+
+/* Part of the current slab of a class not carved yet */
+typedef struct
+{
+    uint8_t *next;
+    uint8_t *end;
+} qae_sc_carve_t;
+
+API_LOCAL dev_mem_info_t *__qae_pUserClassListHead = NULL;
+API_LOCAL dev_mem_info_t *__qae_pUserClassListTail = NULL;
+
+#ifdef __CLANG_FORMAT__
+/* clang-format off */
+#endif
+
+/* Page table holding the tag of every page of the class slabs */
+STATIC page_table_t g_sc_page_table = {{{0}}};
+
+#ifdef __CLANG_FORMAT__
+/* clang-format on */
+#endif
+
+/* Return stacks of the objects given back by the threads */
+STATIC void *volatile g_sc_return[QAE_SC_NUM_NODES][QAE_SC_NUM_CLASSES];
+/* Carving state, protected by the allocator lock */
+STATIC qae_sc_carve_t g_sc_carve[QAE_SC_NUM_NODES][QAE_SC_NUM_CLASSES];
+/* Incremented each time all the objects are forgotten */
+STATIC volatile uint32_t g_sc_generation = 1;
+
+static __thread qae_sc_cache_t qae_sc_cache;
+
+#ifdef MADV_WIPEONFORK
+/* Page cleared by the kernel in a forked child, holds the owner pid */
+STATIC volatile pid_t *g_sc_guard = NULL;
+#else
+STATIC pid_t g_sc_pid = 0;
+#endif
+
+#ifndef ICP_WITHOUT_THREAD
+STATIC pthread_key_t g_sc_key;
+static pthread_once_t g_sc_key_once = PTHREAD_ONCE_INIT;
+static __thread int qae_sc_registered = 0;
+#endif
+
+static inline void *sc_next(void *obj)
+{
+    return *(void **)obj;
+}
+
+static inline size_t sc_batch(const int sc)
+{
+    return MAX(QAE_SC_CACHE_BYTES / QAE_SC_OBJ_SIZE(sc), 2);
+}
+
+/* sc_forked function
+ * Returns non zero when the class state belongs to another process, i.e.
+ * in a forked child whose class slabs are not mapped, or before the
+ * first refill.
+ */
+static inline int sc_forked(void)
+{
+#ifdef MADV_WIPEONFORK
+    return (NULL == g_sc_guard) || (0 == *g_sc_guard);
+#else
+    return g_sc_pid != getpid();
+#endif
+}
+
+static int sc_arm_guard(void)
+{
+#ifdef MADV_WIPEONFORK
+    const int page_size = getpagesize();
+    void *page = NULL;
+
+    if (NULL == g_sc_guard)
+    {
+        page = qae_mmap(NULL,
+                        page_size,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANON,
+                        -1,
+                        0);
+        if (MAP_FAILED == page)
+        {
+            CMD_ERROR(
+                "%s:%d Unable to mmap fork guard \n", __func__, __LINE__);
+            return -ENOMEM;
+        }
+        if (qae_madvise(page, page_size, MADV_WIPEONFORK))
+        {
+            CMD_ERROR(
+                "%s:%d Unable to update page properties\n", __func__, __LINE__);
+            qae_munmap(page, page_size);
+            return -ENOMEM;
+        }
+        g_sc_guard = page;
+    }
+    *g_sc_guard = getpid();
+#else
+    g_sc_pid = getpid();
+#endif
+    return 0;
+}
+
+static inline void sc_push_return(const int slot,
+                                  const int sc,
+                                  void *head,
+                                  void *tail)
+{
+    void *old = NULL;
+
+    do
+    {
+        old = g_sc_return[slot][sc];
+        *(void **)tail = old;
+    } while (!__sync_bool_compare_and_swap(&g_sc_return[slot][sc], old, head));
+}
+
+#ifndef ICP_WITHOUT_THREAD
+/* sc_thread_exit function
+ * Gives the cache of an exiting thread back to the return stacks.
+ */
+static void sc_thread_exit(void *arg)
+{
+    qae_sc_cache_t *cache = (qae_sc_cache_t *)arg;
+    void *tail = NULL;
+    int slot = 0;
+    int sc = 0;
+
+    if (sc_forked() || cache->generation != g_sc_generation)
+        return;
+
+    for (slot = 0; slot < QAE_SC_NUM_NODES; slot++)
+    {
+        for (sc = 0; sc < QAE_SC_NUM_CLASSES; sc++)
+        {
+            qae_sc_chain_t *chain = &cache->freed[slot][sc];
+
+            if (NULL != chain->head)
+                sc_push_return(slot, sc, chain->head, chain->tail);
+
+            if (NULL != cache->taken[slot][sc])
+            {
+                tail = cache->taken[slot][sc];
+                while (NULL != sc_next(tail))
+                    tail = sc_next(tail);
+                sc_push_return(slot, sc, cache->taken[slot][sc], tail);
+            }
+        }
+    }
+    memset(cache, 0, sizeof(qae_sc_cache_t));
+}
+
+static void sc_make_key(void)
+{
+    pthread_key_create(&g_sc_key, sc_thread_exit);
+}
+#endif
+
+static inline qae_sc_cache_t *sc_get_cache(void)
+{
+    qae_sc_cache_t *cache = &qae_sc_cache;
+
+    if (unlikely(cache->generation != g_sc_generation))
+    {
+        memset(cache, 0, sizeof(qae_sc_cache_t));
+        cache->generation = g_sc_generation;
+#ifndef ICP_WITHOUT_THREAD
+        if (!qae_sc_registered)
+        {
+            pthread_once(&g_sc_key_once, sc_make_key);
+            pthread_setspecific(g_sc_key, cache);
+            qae_sc_registered = 1;
+        }
+#endif
+    }
+    return cache;
+}
+
+/* sc_new_slab function
+ * Allocates a slab for a class and tags its pages. Must be called with
+ * the allocator lock held.
+ */
+static int sc_new_slab(const int fd,
+                       const int sc,
+                       const int node,
+                       qae_sc_carve_t *carve)
+{
+    const size_t obj_size = QAE_SC_OBJ_SIZE(sc);
+    const uint64_t tag = QAE_SC_TAG(node + 1, sc);
+    const enum slabType type = __qae_hugepage_enabled() ? HUGE_PAGE : SMALL;
+    dev_mem_info_t *slab = NULL;
+    uintptr_t virt = 0;
+    size_t offset = 0;
+
+    slab = __qae_alloc_slab(fd, QAE_SC_SLAB_SIZE, obj_size, node, type);
+    if (NULL == slab)
+        return -ENOMEM;
+
+    /* Objects are aligned to their size only if the slab is */
+    if (slab->phy_addr & (obj_size - 1))
+    {
+        CMD_ERROR("%s:%d Slab physical address %llx not aligned to %zu\n",
+                  __func__,
+                  __LINE__,
+                  (unsigned long long)slab->phy_addr,
+                  obj_size);
+        __qae_free_slab(fd, slab);
+        return -EFAULT;
+    }
+
+    virt = (uintptr_t)slab->virt_addr;
+    for (offset = 0; offset < slab->size; offset += PAGE_SIZE)
+    {
+        store_addr(&g_sc_page_table, virt + offset, tag);
+        if (tag != load_key(&g_sc_page_table, (void *)(virt + offset)))
+            break;
+    }
+    if (offset < slab->size)
+    {
+        CMD_ERROR("%s:%d Unable to tag size class slab\n", __func__, __LINE__);
+        while (offset)
+        {
+            offset -= PAGE_SIZE;
+            store_addr(&g_sc_page_table, virt + offset, 0);
+        }
+        __qae_free_slab(fd, slab);
+        return -ENOMEM;
+    }
+
+    store_mmap_range(&g_page_table,
+                     slab->virt_addr,
+                     slab->phy_addr,
+                     slab->size,
+                     __qae_hugepage_enabled());
+
+    ADD_ELEMENT_TO_HEAD_LIST(
+        slab, __qae_pUserClassListHead, __qae_pUserClassListTail, _user);
+
+    /* The first object holds the slab descriptor */
+    carve->next = (uint8_t *)slab->virt_addr + obj_size;
+    carve->end = (uint8_t *)slab->virt_addr + slab->size;
+    return 0;
+}
+
+API_LOCAL
+int __qae_sc_class(const size_t size, const int node, const size_t align)
+{
+    const size_t needed = MAX(size, align);
+    int shift = QAE_SC_MIN_SHIFT;
+
+    if (node < NUMA_ANY_NODE || node >= QAE_SC_NUM_NODES - 1)
+        return -1;
+
+    /* A slab must hold at least three objects besides its descriptor */
+    if (needed > ((size_t)1 << QAE_SC_MAX_SHIFT) ||
+        needed > QAE_SC_SLAB_SIZE / 4)
+        return -1;
+
+    while (((size_t)1 << shift) < needed)
+        shift++;
+
+    return shift - QAE_SC_MIN_SHIFT;
+}
+
+API_LOCAL
+void *__qae_sc_alloc(const int sc, const int node)
+{
+    const int slot = node + 1;
+    qae_sc_cache_t *cache = NULL;
+    qae_sc_chain_t *chain = NULL;
+    void *obj = NULL;
+
+    if (unlikely(sc_forked()))
+        return NULL;
+
+    cache = sc_get_cache();
+    chain = &cache->freed[slot][sc];
+    if (NULL != chain->head)
+    {
+        obj = chain->head;
+        chain->head = sc_next(obj);
+        if (NULL == chain->head)
+            chain->tail = NULL;
+        chain->count--;
+    }
+    else
+    {
+        if (NULL == cache->taken[slot][sc])
+            cache->taken[slot][sc] =
+                __sync_lock_test_and_set(&g_sc_return[slot][sc], NULL);
+
+        obj = cache->taken[slot][sc];
+        if (NULL == obj)
+            return NULL;
+        cache->taken[slot][sc] = sc_next(obj);
+    }
+
+    *(void **)obj = NULL;
+    __qae_stats_alloc(QAE_SC_OBJ_SIZE(sc));
+    return obj;
+}
+
+API_LOCAL
+void *__qae_sc_refill(const int fd, const int sc, const int node)
+{
+    const int slot = node + 1;
+    const size_t obj_size = QAE_SC_OBJ_SIZE(sc);
+    qae_sc_carve_t *carve = &g_sc_carve[slot][sc];
+    qae_sc_cache_t *cache = NULL;
+    size_t batch = sc_batch(sc);
+    void *head = NULL;
+    void **link = &head;
+
+    if (sc_forked())
+    {
+        __qae_sc_reset();
+        if (sc_arm_guard())
+            return NULL;
+    }
+    cache = sc_get_cache();
+
+    if (carve->next == carve->end)
+    {
+        if (sc_new_slab(fd, sc, node, carve))
+            return NULL;
+    }
+
+    while (batch-- && carve->next < carve->end)
+    {
+        *link = carve->next;
+        link = (void **)carve->next;
+        carve->next += obj_size;
+    }
+    *link = cache->taken[slot][sc];
+
+    cache->taken[slot][sc] = sc_next(head);
+    *(void **)head = NULL;
+    __qae_stats_alloc(obj_size);
+    return head;
+}
+
+API_LOCAL
+bool __qae_sc_free(void *ptr, bool secure_free)
+{
+    qae_sc_cache_t *cache = NULL;
+    qae_sc_chain_t *chain = NULL;
+    uint64_t tag = 0;
+    size_t obj_size = 0;
+    int slot = 0;
+    int sc = 0;
+
+    if (unlikely(sc_forked()))
+        return false;
+
+    tag = load_key(&g_sc_page_table, ptr);
+    if (0 == tag)
+        return false;
+
+    sc = QAE_SC_TAG_CLASS(tag);
+    slot = QAE_SC_TAG_SLOT(tag);
+    obj_size = QAE_SC_OBJ_SIZE(sc);
+
+    if ((uintptr_t)ptr & (MIN(obj_size, PAGE_SIZE) - 1))
+    {
+        CMD_ERROR("%s:%d Address (%p) is not the start of a %zu bytes "
+                  "block\n",
+                  __func__,
+                  __LINE__,
+                  ptr,
+                  obj_size);
+        return true;
+    }
+
+    if (secure_free)
+    {
+#ifndef ICP_DISABLE_SECURE_MEM_FREE
+        qae_memzero_explicit(ptr, obj_size);
+#endif
+    }
+    __qae_stats_free(obj_size);
+
+    cache = sc_get_cache();
+    chain = &cache->freed[slot][sc];
+    *(void **)ptr = chain->head;
+    if (NULL == chain->head)
+        chain->tail = ptr;
+    chain->head = ptr;
+
+    if (++chain->count >= sc_batch(sc))
+    {
+        sc_push_return(slot, sc, chain->head, chain->tail);
+        chain->head = NULL;
+        chain->tail = NULL;
+        chain->count = 0;
+    }
+    return true;
+}
+
+API_LOCAL
+void __qae_sc_reset(void)
+{
+    free_page_table(&g_sc_page_table);
+    memset((void *)g_sc_return, 0, sizeof(g_sc_return));
+    memset(g_sc_carve, 0, sizeof(g_sc_carve));
+    __qae_pUserClassListHead = NULL;
+    __qae_pUserClassListTail = NULL;
+    g_sc_generation++;
+}
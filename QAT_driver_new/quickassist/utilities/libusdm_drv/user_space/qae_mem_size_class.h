@@ -0,0 +1,136 @@
+/***************************************************************************
+ *
+ * This file is provided under a dual BSD/GPLv2 license.  When using or
+ *   redistributing this file, you may do so under either license.
+ * 
+ *   GPL LICENSE SUMMARY
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ * 
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of version 2 of the GNU General Public License as
+ *   published by the Free Software Foundation.
+ * 
+ *   This program is distributed in the hope that it will be useful, but
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   General Public License for more details.
+ * 
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ *   The full GNU General Public License is included in this distribution
+ *   in the file called LICENSE.GPL.
+ * 
+ *   Contact Information:
+ *   Intel Corporation
+ * 
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+/**
+ ****************************************************************************
+ * @file qae_mem_size_class.h
+ *
+ * This file provides the size class front end of the Linux user space
+ * memory allocator. Small allocations are rounded up to a power of two
+ * size class and served from per-thread caches without taking the
+ * allocator lock. Each class is carved from dedicated slabs, so an object
+ * is always aligned to its size and its class can be found from its
+ * address alone.
+ *
+ ***************************************************************************/
+
+#ifndef QAE_MEM_SIZE_CLASS_H
+#define QAE_MEM_SIZE_CLASS_H
+
+#include <stdbool.h>
+#include "qae_mem.h"
+#include "qae_mem_utils.h"
+#include "qae_mem_user_utils.h"
+
+/* Smallest size class is 1 KB, the allocation unit of the bitmap */
+#define QAE_SC_MIN_SHIFT (10)
+/* Largest size class is 256 KB, larger sizes use the bitmap allocator */
+#define QAE_SC_MAX_SHIFT (18)
+#define QAE_SC_NUM_CLASSES (QAE_SC_MAX_SHIFT - QAE_SC_MIN_SHIFT + 1)
+/* Slots for NUMA_ANY_NODE and nodes 0 to QAE_SC_NUM_NODES - 2 */
+#define QAE_SC_NUM_NODES (8)
+/* Bytes a thread keeps per class before returning objects */
+#define QAE_SC_CACHE_BYTES (0x40000)
+/* Size of a slab dedicated to one size class */
+#define QAE_SC_SLAB_SIZE (QAE_NUM_PAGES_PER_ALLOC * QAE_PAGE_SIZE)
+
+/* List of the slabs dedicated to size classes */
+extern dev_mem_info_t *__qae_pUserClassListHead;
+extern dev_mem_info_t *__qae_pUserClassListTail;
+
+/* __qae_sc_class function
+ * Returns the size class serving an allocation or -1 when the allocation
+ * has to go to the bitmap allocator.
+ */
+API_LOCAL
+int __qae_sc_class(const size_t size, const int node, const size_t align);
+
+/* __qae_sc_alloc function
+ * Takes an object from the thread cache or from the return stack of the
+ * class. Does not take the allocator lock, returns NULL when both are
+ * empty.
+ */
+API_LOCAL
+void *__qae_sc_alloc(const int sc, const int node);
+
+/* __qae_sc_refill function
+ * Carves a batch of objects into the thread cache and returns one of
+ * them. Must be called with the allocator lock held.
+ */
+API_LOCAL
+void *__qae_sc_refill(const int fd, const int sc, const int node);
+
+/* __qae_sc_free function
+ * Returns true when the address belongs to a size class, in which case
+ * the object is put into the thread cache.
+ */
+API_LOCAL
+bool __qae_sc_free(void *ptr, bool secure_free);
+
+/* __qae_sc_reset function
+ * Forgets all size class objects. The slabs themselves are on
+ * __qae_pUserClassListHead. Must be called with the allocator lock held.
+ */
+API_LOCAL
+void __qae_sc_reset(void);
+
+#endif /* QAE_MEM_SIZE_CLASS_H */
@@ -0,0 +1,731 @@
+/***************************************************************************
+ *
+ * This file is provided under a dual BSD/GPLv2 license.  When using or
+ *   redistributing this file, you may do so under either license.
+ * 
+ *   GPL LICENSE SUMMARY
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ * 
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of version 2 of the GNU General Public License as
+ *   published by the Free Software Foundation.
+ * 
+ *   This program is distributed in the hope that it will be useful, but
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   General Public License for more details.
+ * 
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ *   The full GNU General Public License is included in this distribution
+ *   in the file called LICENSE.GPL.
+ * 
+ *   Contact Information:
+ *   Intel Corporation
+ * 
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+/**
+ ****************************************************************************
+ * @file qae_mem_stats.c
+ *
+ * This file provides the memory accounting of the Linux user space
+ * memory allocator.
+ *
+ * Each thread counts its allocations and frees in a thread local block,
+ * so the accounting adds no shared write to the allocation path. The
+ * blocks are linked on a list read by the query functions, the block of an
+ * exiting thread is folded into the retired counters. Slabs are mapped
+ * rarely and counted with atomic operations.
+ *
+ * Call sites are sampled in an open addressing table keyed by the address
+ * of the allocation. Samples are inserted and removed under the stats
+ * lock, frees look the table up without it and only while some allocation
+ * is sampled.
+ *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/syscall.h>
+#ifndef ICP_WITHOUT_THREAD
+#include <pthread.h>
+#endif
+#include "qae_mem_stats.h"
+
+/* Address of a sample slot whose allocation has been freed */
+#define QAE_STATS_TOMBSTONE ((void *)1)
+/* Call sites printed by qaeMemDumpStats */
+#define QAE_STATS_DUMP_SITES (10)
+/* Granularity of the sleep of the periodic dump, in milliseconds */
+#define QAE_STATS_DUMP_TICK_MS (100)
+
+/* Accounting of a thread */
+typedef struct qae_stats_thread_s
+{
+    uint64_t numAllocs;
+    uint64_t numFrees;
+    uint64_t numFailedAllocs;
+    uint64_t bytesAllocated;
+    uint64_t bytesFreed;
+    uint64_t sizeHistogram[QAE_MEM_STATS_HIST_BUCKETS];
+    /* Allocations left before the next sample */
+    uint32_t sampleCountdown;
+    /* Accounting of an older generation belongs to another process */
+    uint32_t generation;
+    uint64_t threadId;
+    struct qae_stats_thread_s *pPrev;
+    struct qae_stats_thread_s *pNext;
+} qae_stats_thread_t;
+
+/* Sampled allocation */
+typedef struct
+{
+    void *volatile ptr;
+    void *caller;
+    size_t size;
+} qae_stats_sample_t;
+
+API_LOCAL volatile uint32_t __qae_stats_live_samples = 0;
+
+/* Threads which used the allocator, protected by the stats lock */
+STATIC qae_stats_thread_t *g_stats_threads = NULL;
+STATIC qae_stats_thread_t *g_stats_threads_tail = NULL;
+/* Accounting of the threads which exited, protected by the stats lock */
+STATIC qae_stats_thread_t g_stats_retired;
+STATIC volatile uint64_t g_stats_num_slabs = 0;
+STATIC volatile uint64_t g_stats_slab_bytes = 0;
+STATIC volatile uint32_t g_stats_generation = 1;
+STATIC volatile uint32_t g_stats_sample_rate = 0;
+STATIC qae_stats_sample_t g_stats_samples[QAE_STATS_SAMPLE_SLOTS];
+
+static __thread qae_stats_thread_t qae_stats_self;
+/* Set once the thread has exited, its accounting is retired */
+static __thread int qae_stats_exited = 0;
+
+#ifndef ICP_WITHOUT_THREAD
+STATIC pthread_mutex_t g_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+STATIC pthread_key_t g_stats_key;
+static pthread_once_t g_stats_key_once = PTHREAD_ONCE_INIT;
+static __thread int qae_stats_registered = 0;
+/* Periodic dump */
+STATIC pthread_t g_stats_dump_thread;
+STATIC volatile int g_stats_dump_running = 0;
+STATIC unsigned int g_stats_dump_period = 0;
+#endif
+
+static inline void stats_lock(void)
+{
+    int ret = mem_mutex_lock(&g_stats_mutex);
+
+    if (unlikely(ret))
+        CMD_ERROR(
+            "%s:%d Error(%d) on stats mutex lock\n", __func__, __LINE__, ret);
+}
+
+static inline void stats_unlock(void)
+{
+    int ret = mem_mutex_unlock(&g_stats_mutex);
+
+    if (unlikely(ret))
+        CMD_ERROR(
+            "%s:%d Error(%d) on stats mutex unlock\n", __func__, __LINE__, ret);
+}
+
+/* stats_fold function
+ * Adds the counters of a thread to total.
+ */
+static void stats_fold(qae_stats_thread_t *total,
+                       const qae_stats_thread_t *thread)
+{
+    int i = 0;
+
+    total->numAllocs += thread->numAllocs;
+    total->numFrees += thread->numFrees;
+    total->numFailedAllocs += thread->numFailedAllocs;
+    total->bytesAllocated += thread->bytesAllocated;
+    total->bytesFreed += thread->bytesFreed;
+    for (i = 0; i < QAE_MEM_STATS_HIST_BUCKETS; i++)
+        total->sizeHistogram[i] += thread->sizeHistogram[i];
+}
+
+#ifndef ICP_WITHOUT_THREAD
+/* stats_thread_exit function
+ * Retires the accounting of an exiting thread.
+ */
+static void stats_thread_exit(void *arg)
+{
+    qae_stats_thread_t *self = (qae_stats_thread_t *)arg;
+
+    stats_lock();
+    if (self->generation == g_stats_generation)
+    {
+        stats_fold(&g_stats_retired, self);
+        REMOVE_ELEMENT_FROM_LIST(
+            self, g_stats_threads, g_stats_threads_tail, );
+    }
+    self->generation = 0;
+    qae_stats_exited = 1;
+    stats_unlock();
+}
+
+static void stats_make_key(void)
+{
+    pthread_key_create(&g_stats_key, stats_thread_exit);
+}
+#endif
+
+/* stats_get_self function
+ * Returns the accounting of the calling thread, registering it on first
+ * use. Once the thread has exited the retired counters are returned, the
+ * caller must then hold the stats lock.
+ */
+static inline qae_stats_thread_t *stats_get_self(bool *retired)
+{
+    qae_stats_thread_t *self = &qae_stats_self;
+
+    *retired = false;
+    if (self->generation == g_stats_generation)
+        return self;
+
+    stats_lock();
+    if (qae_stats_exited)
+    {
+        /* Accounted under the lock, released by stats_put_self */
+        *retired = true;
+        return &g_stats_retired;
+    }
+    memset(self, 0, sizeof(qae_stats_thread_t));
+    self->generation = g_stats_generation;
+    self->threadId = syscall(__NR_gettid);
+    ADD_ELEMENT_TO_HEAD_LIST(self, g_stats_threads, g_stats_threads_tail, );
+    stats_unlock();
+#ifndef ICP_WITHOUT_THREAD
+    if (!qae_stats_registered)
+    {
+        pthread_once(&g_stats_key_once, stats_make_key);
+        pthread_setspecific(g_stats_key, self);
+        qae_stats_registered = 1;
+    }
+#endif
+    return self;
+}
+
+static inline void stats_put_self(const bool retired)
+{
+    if (unlikely(retired))
+        stats_unlock();
+}
+
+/* stats_bucket function
+ * Returns the histogram bucket of a requested size.
+ */
+static inline int stats_bucket(const size_t size)
+{
+    int bucket = 0;
+
+    if (size <= UNIT_SIZE)
+        return 0;
+    /* Rounded up log2 of the size, 1 KB being bucket 0 */
+    bucket = QWORD_WIDTH - __builtin_clzll((uint64_t)size - 1) - 10;
+    return MIN(bucket, QAE_MEM_STATS_HIST_BUCKETS - 1);
+}
+
+static inline size_t stats_hash(const void *ptr)
+{
+    /* Allocations are at least UNIT_SIZE aligned */
+    const uint64_t key = (uintptr_t)ptr / UNIT_SIZE;
+
+    return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) &
+           (QAE_STATS_SAMPLE_SLOTS - 1);
+}
+
+/* stats_sample function
+ * Records the call site of an allocation, the sample is dropped when no
+ * slot is free within QAE_STATS_SAMPLE_PROBES slots.
+ */
+static void stats_sample(void *ptr, const size_t size, void *caller)
+{
+    size_t slot = stats_hash(ptr);
+    qae_stats_sample_t *sample = NULL;
+    int i = 0;
+
+    stats_lock();
+    for (i = 0; i < QAE_STATS_SAMPLE_PROBES; i++)
+    {
+        sample = &g_stats_samples[slot];
+        if (NULL == sample->ptr || QAE_STATS_TOMBSTONE == sample->ptr)
+        {
+            sample->caller = caller;
+            sample->size = size;
+            /* Publish the sample to the lockless lookups */
+            __atomic_store_n(&sample->ptr, ptr, __ATOMIC_RELEASE);
+            __sync_add_and_fetch(&__qae_stats_live_samples, 1);
+            break;
+        }
+        slot = (slot + 1) & (QAE_STATS_SAMPLE_SLOTS - 1);
+    }
+    stats_unlock();
+}
+
+API_LOCAL
+void __qae_stats_alloc(const size_t bytes)
+{
+    bool retired = false;
+    qae_stats_thread_t *self = stats_get_self(&retired);
+
+    self->numAllocs++;
+    self->bytesAllocated += bytes;
+    stats_put_self(retired);
+}
+
+API_LOCAL
+void __qae_stats_free(const size_t bytes)
+{
+    bool retired = false;
+    qae_stats_thread_t *self = stats_get_self(&retired);
+
+    self->numFrees++;
+    self->bytesFreed += bytes;
+    stats_put_self(retired);
+}
+
+API_LOCAL
+void __qae_stats_request(void *ptr, const size_t size, void *caller)
+{
+    const uint32_t rate = g_stats_sample_rate;
+    bool retired = false;
+    qae_stats_thread_t *self = stats_get_self(&retired);
+    bool sample = false;
+
+    if (NULL == ptr)
+    {
+        self->numFailedAllocs++;
+        stats_put_self(retired);
+        return;
+    }
+    self->sizeHistogram[stats_bucket(size)]++;
+
+    if (0 != rate && !retired)
+    {
+        /* The countdown restarts whenever the rate is lowered */
+        if (0 == self->sampleCountdown || self->sampleCountdown > rate)
+            self->sampleCountdown = rate;
+        if (0 == --self->sampleCountdown)
+        {
+            self->sampleCountdown = rate;
+            sample = true;
+        }
+    }
+    stats_put_self(retired);
+
+    if (sample)
+        stats_sample(ptr, size, caller);
+}
+
+API_LOCAL
+void __qae_stats_forget(void *ptr)
+{
+    size_t slot = stats_hash(ptr);
+    qae_stats_sample_t *sample = NULL;
+    void *cur = NULL;
+    int i = 0;
+
+    for (i = 0; i < QAE_STATS_SAMPLE_PROBES; i++)
+    {
+        sample = &g_stats_samples[slot];
+        cur = __atomic_load_n(&sample->ptr, __ATOMIC_ACQUIRE);
+        if (NULL == cur)
+            return;
+        if (cur == ptr)
+            break;
+        slot = (slot + 1) & (QAE_STATS_SAMPLE_SLOTS - 1);
+    }
+    if (QAE_STATS_SAMPLE_PROBES == i)
+        return;
+
+    stats_lock();
+    if (sample->ptr == ptr)
+    {
+        sample->ptr = QAE_STATS_TOMBSTONE;
+        /* Once nothing is sampled the tombstones can go */
+        if (0 == __sync_sub_and_fetch(&__qae_stats_live_samples, 1))
+            memset(g_stats_samples, 0, sizeof(g_stats_samples));
+    }
+    stats_unlock();
+}
+
+API_LOCAL
+void __qae_stats_slab(const size_t size, const bool add)
+{
+    if (add)
+    {
+        __sync_add_and_fetch(&g_stats_num_slabs, 1);
+        __sync_add_and_fetch(&g_stats_slab_bytes, size);
+    }
+    else
+    {
+        __sync_sub_and_fetch(&g_stats_num_slabs, 1);
+        __sync_sub_and_fetch(&g_stats_slab_bytes, size);
+    }
+}
+
+/* stats_slab_info function
+ * Fills the occupancy of a slab.
+ */
+static void stats_slab_info(dev_mem_info_t *slab,
+                            const uint32_t type,
+                            qae_mem_slab_stats_t *pStats)
+{
+    const block_ctrl_t *ctrl = (block_ctrl_t *)slab;
+    size_t free_units = 0;
+    size_t run = 0;
+    size_t largest = 0;
+    size_t i = 0;
+
+    memset(pStats, 0, sizeof(qae_mem_slab_stats_t));
+    pStats->virtAddr = (uintptr_t)slab->virt_addr;
+    pStats->size = slab->size;
+    pStats->node = (int32_t)slab->nodeId;
+    pStats->type = type;
+    pStats->allocations = slab->allocations;
+
+    if (QAE_MEM_SLAB_BITMAP != type)
+        return;
+
+    for (i = 0; i < BITMAP_LEN * QWORD_WIDTH; i++)
+    {
+        if (ctrl->bitmap[i / QWORD_WIDTH] & (1ULL << (i % QWORD_WIDTH)))
+        {
+            run = 0;
+            continue;
+        }
+        free_units++;
+        if (++run > largest)
+            largest = run;
+    }
+    pStats->freeBytes = free_units * UNIT_SIZE;
+    pStats->largestFreeRun = largest * UNIT_SIZE;
+}
+
+API_LOCAL
+unsigned int __qae_stats_slab_list(dev_mem_info_t *pList,
+                                   const uint32_t type,
+                                   qae_mem_slab_stats_t *pStats,
+                                   unsigned int count,
+                                   const unsigned int maxStats)
+{
+    for (; NULL != pList && count < maxStats; pList = pList->pNext_user)
+        stats_slab_info(pList, type, &pStats[count++]);
+    return count;
+}
+
+API_LOCAL
+void __qae_stats_reset(void)
+{
+    stats_lock();
+    g_stats_threads = NULL;
+    g_stats_threads_tail = NULL;
+    memset(&g_stats_retired, 0, sizeof(g_stats_retired));
+    memset(g_stats_samples, 0, sizeof(g_stats_samples));
+    __qae_stats_live_samples = 0;
+    g_stats_num_slabs = 0;
+    g_stats_slab_bytes = 0;
+    g_stats_generation++;
+    stats_unlock();
+}
+
+int qaeMemGetStats(qae_mem_stats_t *pStats)
+{
+    qae_stats_thread_t total;
+    qae_stats_thread_t *thread = NULL;
+
+    if (NULL == pStats)
+    {
+        CMD_ERROR("%s:%d Invalid stats pointer\n", __func__, __LINE__);
+        return -EINVAL;
+    }
+
+    stats_lock();
+    memcpy(&total, &g_stats_retired, sizeof(total));
+    for (thread = g_stats_threads; NULL != thread; thread = thread->pNext)
+        stats_fold(&total, thread);
+    stats_unlock();
+
+    pStats->numAllocs = total.numAllocs;
+    pStats->numFrees = total.numFrees;
+    pStats->numFailedAllocs = total.numFailedAllocs;
+    /* The threads are read while running, a free may be seen before the
+     * allocation it releases */
+    pStats->bytesInUse = total.bytesAllocated > total.bytesFreed
+                             ? total.bytesAllocated - total.bytesFreed
+                             : 0;
+    pStats->numSlabs = g_stats_num_slabs;
+    pStats->slabBytes = g_stats_slab_bytes;
+    memcpy(pStats->sizeHistogram,
+           total.sizeHistogram,
+           sizeof(pStats->sizeHistogram));
+    return 0;
+}
+
+int qaeMemGetThreadStats(qae_mem_thread_stats_t *pStats,
+                         unsigned int maxStats)
+{
+    qae_stats_thread_t *thread = NULL;
+    unsigned int count = 0;
+
+    if (NULL == pStats)
+    {
+        CMD_ERROR("%s:%d Invalid stats pointer\n", __func__, __LINE__);
+        return -EINVAL;
+    }
+
+    stats_lock();
+    for (thread = g_stats_threads; NULL != thread && count < maxStats;
+         thread = thread->pNext, count++)
+    {
+        pStats[count].threadId = thread->threadId;
+        pStats[count].numAllocs = thread->numAllocs;
+        pStats[count].numFrees = thread->numFrees;
+        pStats[count].bytesAllocated = thread->bytesAllocated;
+        pStats[count].bytesFreed = thread->bytesFreed;
+    }
+    stats_unlock();
+    return (int)count;
+}
+
+void qaeMemSetSampleRate(unsigned int rate)
+{
+    g_stats_sample_rate = rate;
+}
+
+int qaeMemGetSampledSites(qae_mem_site_stats_t *pSites,
+                          unsigned int maxSites)
+{
+    qae_mem_site_stats_t site;
+    qae_stats_sample_t *sample = NULL;
+    unsigned int count = 0;
+    unsigned int i = 0;
+    unsigned int j = 0;
+
+    if (NULL == pSites)
+    {
+        CMD_ERROR("%s:%d Invalid sites pointer\n", __func__, __LINE__);
+        return -EINVAL;
+    }
+
+    stats_lock();
+    for (i = 0; i < QAE_STATS_SAMPLE_SLOTS; i++)
+    {
+        sample = &g_stats_samples[i];
+        if (NULL == sample->ptr || QAE_STATS_TOMBSTONE == sample->ptr)
+            continue;
+
+        for (j = 0; j < count; j++)
+        {
+            if (pSites[j].caller == (uintptr_t)sample->caller)
+                break;
+        }
+        if (j == count)
+        {
+            /* Sites beyond maxSites are not reported */
+            if (count == maxSites)
+                continue;
+            pSites[count].caller = (uintptr_t)sample->caller;
+            pSites[count].liveSamples = 0;
+            pSites[count].liveBytes = 0;
+            count++;
+        }
+        pSites[j].liveSamples++;
+        pSites[j].liveBytes += sample->size;
+    }
+    stats_unlock();
+
+    /* Sort by decreasing live bytes */
+    for (i = 1; i < count; i++)
+    {
+        site = pSites[i];
+        for (j = i; j > 0 && pSites[j - 1].liveBytes < site.liveBytes; j--)
+            pSites[j] = pSites[j - 1];
+        pSites[j] = site;
+    }
+    return (int)count;
+}
+
+void qaeMemDumpStats(void)
+{
+    qae_mem_site_stats_t sites[QAE_STATS_DUMP_SITES];
+    qae_mem_slab_stats_t *slabs = NULL;
+    qae_mem_stats_t stats;
+    uint64_t free_bytes = 0;
+    uint64_t largest = 0;
+    int num_bitmap = 0;
+    int num = 0;
+    int i = 0;
+
+    if (qaeMemGetStats(&stats))
+        return;
+
+    printf("USDM memory: %llu bytes in use, %llu allocations, %llu frees, "
+           "%llu failed allocations\n",
+           (unsigned long long)stats.bytesInUse,
+           (unsigned long long)stats.numAllocs,
+           (unsigned long long)stats.numFrees,
+           (unsigned long long)stats.numFailedAllocs);
+    printf("USDM slabs: %llu slabs holding %llu bytes\n",
+           (unsigned long long)stats.numSlabs,
+           (unsigned long long)stats.slabBytes);
+
+    /* A few more entries for the slabs mapped meanwhile */
+    slabs = malloc((stats.numSlabs + 16) * sizeof(qae_mem_slab_stats_t));
+    if (NULL != slabs)
+    {
+        num = qaeMemGetSlabStats(slabs, stats.numSlabs + 16);
+        for (i = 0; i < num; i++)
+        {
+            if (QAE_MEM_SLAB_BITMAP != slabs[i].type)
+                continue;
+            num_bitmap++;
+            free_bytes += slabs[i].freeBytes;
+            largest = MAX(largest, slabs[i].largestFreeRun);
+        }
+        free(slabs);
+        printf("USDM bitmap slabs: %d slabs, %llu bytes free, largest free "
+               "run %llu bytes\n",
+               num_bitmap,
+               (unsigned long long)free_bytes,
+               (unsigned long long)largest);
+    }
+
+    printf("USDM allocation sizes:");
+    for (i = 0; i < QAE_MEM_STATS_HIST_BUCKETS; i++)
+    {
+        if (stats.sizeHistogram[i])
+            printf(" <=%lluK:%llu",
+                   1ULL << i,
+                   (unsigned long long)stats.sizeHistogram[i]);
+    }
+    printf("\n");
+
+    num = qaeMemGetSampledSites(sites, QAE_STATS_DUMP_SITES);
+    for (i = 0; i < num; i++)
+    {
+        printf("USDM site %p: %llu live samples, %llu bytes\n",
+               (void *)(uintptr_t)sites[i].caller,
+               (unsigned long long)sites[i].liveSamples,
+               (unsigned long long)sites[i].liveBytes);
+    }
+    fflush(stdout);
+}
+
+#ifndef ICP_WITHOUT_THREAD
+static void *stats_dump_thread(void *arg)
+{
+    const struct timespec tick = {0, QAE_STATS_DUMP_TICK_MS * 1000000L};
+    unsigned int elapsed = 0;
+
+    (void)arg;
+    while (g_stats_dump_running)
+    {
+        nanosleep(&tick, NULL);
+        elapsed += QAE_STATS_DUMP_TICK_MS;
+        if (elapsed >= g_stats_dump_period * 1000)
+        {
+            qaeMemDumpStats();
+            elapsed = 0;
+        }
+    }
+    return NULL;
+}
+#endif
+
+int qaeMemStartStatsDump(unsigned int period)
+{
+#ifndef ICP_WITHOUT_THREAD
+    int ret = 0;
+
+    if (0 == period)
+    {
+        CMD_ERROR("%s:%d Dump period cannot be zero\n", __func__, __LINE__);
+        return -EINVAL;
+    }
+
+    stats_lock();
+    if (g_stats_dump_running)
+    {
+        stats_unlock();
+        return -EBUSY;
+    }
+    g_stats_dump_period = period;
+    g_stats_dump_running = 1;
+    ret = pthread_create(&g_stats_dump_thread, NULL, stats_dump_thread, NULL);
+    if (ret)
+    {
+        CMD_ERROR("%s:%d Unable to create dump thread, ret = %d\n",
+                  __func__,
+                  __LINE__,
+                  ret);
+        g_stats_dump_running = 0;
+    }
+    stats_unlock();
+    return -ret;
+#else
+    (void)period;
+    return -ENOTSUP;
+#endif
+}
+
+void qaeMemStopStatsDump(void)
+{
+#ifndef ICP_WITHOUT_THREAD
+    int running = 0;
+
+    stats_lock();
+    running = g_stats_dump_running;
+    g_stats_dump_running = 0;
+    stats_unlock();
+
+    if (running)
+        pthread_join(g_stats_dump_thread, NULL);
+#endif
+}
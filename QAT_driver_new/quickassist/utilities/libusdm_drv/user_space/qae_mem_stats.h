@@ -0,0 +1,149 @@
+/***************************************************************************
+ *
+ * This file is provided under a dual BSD/GPLv2 license.  When using or
+ *   redistributing this file, you may do so under either license.
+ * 
+ *   GPL LICENSE SUMMARY
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ * 
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of version 2 of the GNU General Public License as
+ *   published by the Free Software Foundation.
+ * 
+ *   This program is distributed in the hope that it will be useful, but
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   General Public License for more details.
+ * 
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ *   The full GNU General Public License is included in this distribution
+ *   in the file called LICENSE.GPL.
+ * 
+ *   Contact Information:
+ *   Intel Corporation
+ * 
+ *   BSD LICENSE
+ * 
+ *   Copyright(c) 2007-2023 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ * 
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ * 
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ * 
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * 
+ *  version: QAT20.L.1.2.30-00078
+ *
+ ***************************************************************************/
+/**
+ ****************************************************************************
+ * @file qae_mem_stats.h
+ *
+ * This file provides the memory accounting of the Linux user space
+ * memory allocator. The allocator reports every block it reserves and
+ * releases, every slab it maps and unmaps and every request it serves.
+ *
+ ***************************************************************************/
+
+#ifndef QAE_MEM_STATS_H
+#define QAE_MEM_STATS_H
+
+#include <stdbool.h>
+#include "qae_mem.h"
+#include "qae_mem_utils.h"
+#include "qae_mem_user_utils.h"
+
+/* Number of sampled allocations tracked at once, a power of two */
+#define QAE_STATS_SAMPLE_SLOTS (4096)
+/* Slots probed to insert or find a sampled allocation */
+#define QAE_STATS_SAMPLE_PROBES (64)
+
+/* Number of sampled allocations not freed yet */
+extern volatile uint32_t __qae_stats_live_samples;
+
+/* __qae_stats_alloc function
+ * Accounts bytes reserved for an allocation to the calling thread.
+ */
+API_LOCAL
+void __qae_stats_alloc(const size_t bytes);
+
+/* __qae_stats_free function
+ * Accounts bytes released by a free to the calling thread.
+ */
+API_LOCAL
+void __qae_stats_free(const size_t bytes);
+
+/* __qae_stats_request function
+ * Accounts a call to qaeMemAllocNUMA, ptr being its result, and samples
+ * its call site.
+ */
+API_LOCAL
+void __qae_stats_request(void *ptr, const size_t size, void *caller);
+
+/* __qae_stats_forget function
+ * Forgets a sampled allocation. Call it through __qae_stats_release.
+ */
+API_LOCAL
+void __qae_stats_forget(void *ptr);
+
+/* __qae_stats_slab function
+ * Accounts a slab of size bytes mapped (add) or unmapped.
+ */
+API_LOCAL
+void __qae_stats_slab(const size_t size, const bool add);
+
+/* __qae_stats_slab_list function
+ * Fills the occupancy of the slabs of a list from pStats[count], parsing
+ * the bitmap of the slabs of the bitmap allocator. Returns the updated
+ * count, at most maxStats.
+ */
+API_LOCAL
+unsigned int __qae_stats_slab_list(dev_mem_info_t *pList,
+                                   const uint32_t type,
+                                   qae_mem_slab_stats_t *pStats,
+                                   unsigned int count,
+                                   const unsigned int maxStats);
+
+/* __qae_stats_reset function
+ * Forgets all the accounting, in a forked child. Must be called with the
+ * allocator lock held.
+ */
+API_LOCAL
+void __qae_stats_reset(void);
+
+/* __qae_stats_release function
+ * Forgets ptr if it is a sampled allocation, at the cost of a single read
+ * when nothing is sampled.
+ */
+static inline void __qae_stats_release(void *ptr)
+{
+    if (unlikely(0 != __qae_stats_live_samples))
+        __qae_stats_forget(ptr);
+}
+
+#endif /* QAE_MEM_STATS_H */
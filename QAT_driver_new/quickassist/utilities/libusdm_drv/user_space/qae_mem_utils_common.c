@@ -90,10 +90,33 @@
 #include "qae_mem_utils.h"
 #include "qae_mem_user_utils.h"
 #include "qae_mem_utils_common.h"
+#include "qae_mem_stats.h"
 
 
 load_addr_fptr_t load_addr_fptr = load_addr;
 
+/* Cached translation of one page */
+typedef struct
+{
+    uint64_t page;
+    /* Virtual page number */
+    uint64_t phys;
+    /* Physical address of the page, 0 for an unused entry */
+} v2p_entry_t;
+
+/* Direct mapped per-thread address translation cache */
+typedef struct
+{
+    uint32_t generation;
+    uint32_t shift;
+    /* Page size shift of the cached translations */
+    v2p_entry_t entry[QAE_V2P_CACHE_SIZE];
+} v2p_cache_t;
+
+API_LOCAL volatile uint32_t __qae_v2p_generation = 0;
+
+static __thread v2p_cache_t v2p_cache;
+
 const uint64_t __qae_bitmask[65] = {
     0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000003ULL,
     0x0000000000000007ULL, 0x000000000000000fULL, 0x000000000000001fULL,
@@ -235,6 +258,7 @@ void *__qae_mem_alloc(block_ctrl_t *block_ctrl, size_t size, size_t align)
              * with blocks_required length in bitmap
              */
             set_bitmap(bitmap, first_block, blocks_required);
+            __qae_stats_alloc(blocks_required * UNIT_SIZE);
             break;
         }
         else
@@ -344,6 +368,7 @@ bool __qae_mem_free(block_ctrl_t *block_ctrl, void *block, bool secure_free)
     block_ctrl->sizes[first_block] = 0;
     /* clear bitmap from bitmap position (0<->BITMAP_LEN*64 - 1) for length*/
     clear_bitmap(bitmap, first_block, length);
+    __qae_stats_free(length * UNIT_SIZE);
 
     if (secure_free)
     {
@@ -376,10 +401,43 @@ void qaeMemFree(void **ptr)
     *ptr = NULL;
 }
 
-/*translate a virtual address to a physical address */
+/* translate a virtual address to a physical address
+ * A per-thread direct mapped cache of page translations, hugepage sized
+ * when hugepages are in use, avoids walking the page table for buffers
+ * translated repeatedly. The cache is flushed when the translation
+ * generation changes, i.e. after a slab has been freed or the hugepage
+ * mode has been set. The page size is only read on a flush so a hit costs
+ * a single thread local lookup.
+ */
 uint64_t qaeVirtToPhysNUMA(void *pVirtAddress)
 {
-    return load_addr_fptr(&g_page_table, pVirtAddress);
+    v2p_cache_t *cache = &v2p_cache;
+    const uint32_t generation = __qae_v2p_generation;
+    uint64_t offset_mask = 0;
+    uint64_t page = 0;
+    v2p_entry_t *entry = NULL;
+    uint64_t phys = 0;
+
+    if (unlikely(cache->generation != generation || 0 == cache->shift))
+    {
+        memset(cache->entry, 0, sizeof(cache->entry));
+        cache->generation = generation;
+        cache->shift = __qae_hugepage_enabled() ? HUGEPAGE_SHIFT : PAGE_SHIFT;
+    }
+
+    offset_mask = (1ULL << cache->shift) - 1;
+    page = (uintptr_t)pVirtAddress >> cache->shift;
+    entry = &cache->entry[page & (QAE_V2P_CACHE_SIZE - 1)];
+    if (entry->page == page && 0 != entry->phys)
+        return entry->phys | ((uintptr_t)pVirtAddress & offset_mask);
+
+    phys = load_addr_fptr(&g_page_table, pVirtAddress);
+    if (0 != phys)
+    {
+        entry->page = page;
+        entry->phys = phys & ~offset_mask;
+    }
+    return phys;
 }
 
 void qaeMemFreeNUMA(void **ptr)
@@ -393,3 +451,83 @@ void qaeMemFreeNonZeroNUMA(void **ptr)
     __qae_memFreeNUMA(ptr, false);
     return;
 }
+
+/* A batch is a single allocation carved into the objects, the first
+ * object being at its start. Freeing the batch frees that allocation.
+ */
+int qaeMemAllocBatch(void **ptrs,
+                     const size_t *sizes,
+                     unsigned int n,
+                     int node,
+                     size_t phys_alignment_byte)
+{
+    uint8_t *base = NULL;
+    size_t total = 0;
+    unsigned int i = 0;
+
+    if (NULL == ptrs || NULL == sizes || 0 == n)
+    {
+        CMD_ERROR("%s:%d Invalid batch parameters \n", __func__, __LINE__);
+        return -EINVAL;
+    }
+    if (!phys_alignment_byte ||
+        (phys_alignment_byte & (phys_alignment_byte - 1)))
+    {
+        CMD_ERROR("%s:%d Invalid alignment parameter %zu \n",
+                  __func__,
+                  __LINE__,
+                  phys_alignment_byte);
+        return -EINVAL;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (0 == sizes[i] || sizes[i] > QAE_MAX_HUGEPAGE_ALLOC_SIZE)
+        {
+            CMD_ERROR("%s:%d Invalid size %zu of object %u \n",
+                      __func__,
+                      __LINE__,
+                      sizes[i],
+                      i);
+            return -EINVAL;
+        }
+        total = round_up(total, phys_alignment_byte) + sizes[i];
+        /* Checked each time so that the sum cannot wrap */
+        if (total > QAE_MAX_HUGEPAGE_ALLOC_SIZE)
+        {
+            CMD_ERROR("%s:%d Batch size exceeds %llu \n",
+                      __func__,
+                      __LINE__,
+                      QAE_MAX_HUGEPAGE_ALLOC_SIZE);
+            return -EINVAL;
+        }
+    }
+
+    base = qaeMemAllocNUMA(total, node, phys_alignment_byte);
+    if (NULL == base)
+        return -ENOMEM;
+
+    total = 0;
+    for (i = 0; i < n; i++)
+    {
+        total = round_up(total, phys_alignment_byte);
+        ptrs[i] = base + total;
+        total += sizes[i];
+    }
+    return 0;
+}
+
+void qaeMemFreeBatch(void **ptrs, unsigned int n)
+{
+    unsigned int i = 0;
+
+    if (NULL == ptrs || 0 == n)
+    {
+        CMD_ERROR("%s:%d Invalid batch parameters \n", __func__, __LINE__);
+        return;
+    }
+
+    __qae_memFreeNUMA(&ptrs[0], true);
+    for (i = 1; i < n; i++)
+        ptrs[i] = NULL;
+}
@@ -100,6 +100,12 @@
 /* Maximum supported allocation is 4M. */
 #define QAE_MAX_ALLOC_SIZE (0x400000ULL)
 
+/* Larger allocations, up to 512M, are carved from 1G huge pages. */
+#define QAE_MAX_HUGEPAGE_ALLOC_SIZE (0x20000000ULL)
+
+/* Number of entries of the per-thread address translation cache */
+#define QAE_V2P_CACHE_SIZE (64)
+
 typedef struct
 {
     dev_mem_info_t *head;
@@ -112,6 +118,9 @@ extern const uint64_t __qae_bitmask[65];
 extern int g_fd;
 extern uint32_t normalAllocations_g;
 
+/* Incremented whenever a translation may have become stale */
+extern volatile uint32_t __qae_v2p_generation;
+
 extern free_page_table_fptr_t free_page_table_fptr;
 extern load_addr_fptr_t load_addr_fptr;
 extern load_key_fptr_t load_key_fptr;
@@ -135,6 +144,15 @@ void __qae_free_addr(void **p_va, bool secure_free);
 API_LOCAL
 void __qae_memFreeNUMA(void **ptr, bool secure_free);
 
+/* __qae_v2p_invalidate function
+ * Invalidates the address translation caches of all the threads.
+ * Must be called when a slab is unmapped or the page table is reset.
+ */
+static inline void __qae_v2p_invalidate(void)
+{
+    __sync_fetch_and_add(&__qae_v2p_generation, 1);
+}
+
 static inline size_t div_round_up(const size_t n, const size_t d)
 {
     return (n + d - 1) / d;
@@ -88,16 +88,39 @@ void __qae_set_loadaddr_fptr(load_addr_fptr_t fp);
 API_LOCAL
 void __qae_set_loadkey_fptr(load_key_fptr_t fp);
 
+/*
+ *  Fills a memory zone with 0 in a way the compiler can not elide.
+ *  With GCC compatible compilers the libc memset is used, which uses vector
+ *  stores and switches to non-temporal stores for blocks larger than the
+ *  cache, followed by a barrier telling the compiler that the zeroed memory
+ *  is still read. Otherwise the memory is cleared one word at a time
+ *  through a volatile pointer.
+ */
 static inline void *qae_memzero(void *const ptr, const size_t count)
 {
-    uint32_t lim = 0;
+#ifdef __GNUC__
+    memset(ptr, 0, count);
+    __asm__ __volatile__("" : : "r"(ptr) : "memory");
+    return ptr;
+#else
+    size_t lim = 0;
     volatile unsigned char *volatile dstPtr = ptr;
 
+    if (0 == ((uintptr_t)ptr % sizeof(uint64_t)))
+    {
+        volatile uint64_t *volatile qwordPtr = ptr;
+
+        for (; lim + sizeof(uint64_t) <= count; lim += sizeof(uint64_t))
+        {
+            qwordPtr[lim / sizeof(uint64_t)] = 0;
+        }
+    }
     while (lim < count)
     {
         dstPtr[lim++] = '\0';
     }
     return (void *)dstPtr;
+#endif
 }
 
 /*
@@ -112,7 +135,7 @@ static inline void *qae_memzero_explicit(void *const ptr, const size_t count)
     }
 #ifdef __STDC_LIB_EXT1__
     errno_t result =
-        memset_s(ptr, sizeof(ptr), 0, count); /* Supported on C11 standard */
+        memset_s(ptr, count, 0, count); /* Supported on C11 standard */
     if (result != 0)
     {
         return NULL;
@@ -90,6 +90,9 @@
 #define HUGEPAGE_SHIFT (21)
 #define HUGEPAGE_MASK (~(HUGEPAGE_SIZE - 1))
 
+#define HUGEPAGE_1G_SIZE (0x40000000ULL)
+#define HUGEPAGE_1G_SHIFT (30)
+
 typedef struct
 {
     uint64_t offset : 12;
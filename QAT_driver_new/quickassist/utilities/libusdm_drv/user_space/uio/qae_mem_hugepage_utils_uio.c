@@ -88,8 +88,36 @@
 #define HUGEPAGE_FILE_DIR "/dev/hugepages/qat/usdm.XXXXXX"
 #define HUGEPAGE_FILE_LEN (sizeof(HUGEPAGE_FILE_DIR))
 
+/* Number of 2M slabs in a 1G huge page */
+#define HUGEPAGE_1G_SLABS (HUGEPAGE_1G_SIZE / HUGEPAGE_SIZE)
+/* Maximum number of 1G huge pages mapped by a process */
+#define HUGEPAGE_1G_MAX_REGIONS (64)
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT (26)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (HUGEPAGE_1G_SHIFT << MAP_HUGE_SHIFT)
+#endif
+
+/*
+ * A 1G huge page carved into 2M slabs. Runs of slabs back LARGE
+ * allocations, which 2M huge pages can not provide contiguously.
+ */
+typedef struct hugepage_region_s
+{
+    void *virt_addr; /* NULL when the entry is unused */
+    uint64_t phy_addr;
+    int hpg_fd; /* Held open until the region is unmapped */
+    int node;
+    uint32_t used; /* Number of slabs in use */
+    uint64_t bitmap[HUGEPAGE_1G_SLABS / QWORD_WIDTH];
+} hugepage_region_t;
+
 static bool g_hugepages_enabled = false;
 static size_t g_num_hugepages = 0;
+static bool g_hugepages_1g_enabled = false;
+static hugepage_region_t g_hpg_regions[HUGEPAGE_1G_MAX_REGIONS];
 
 /*
  * Get physical address of mapped hugepage virtual address in the current
@@ -119,28 +147,23 @@ uint64_t __qae_hugepage_virt2phy(const int fd,
     return user_pages.phy_addr;
 }
 
-API_LOCAL
-void *__qae_hugepage_mmap_phy_addr(const size_t len)
+/*
+ * Map len bytes of huge pages through a temporary file of the hugetlbfs
+ * mount. The file descriptor is returned in hpg_fd and must stay open for
+ * as long as the mapping, see __qae_hugepage_mmap_phy_addr.
+ */
+static void *hugepage_mmap_file(const size_t len, const int flags, int *hpg_fd)
 {
     void *addr = NULL;
-    int ret = 0;
-    int hpg_fd;
     char hpg_fname[HUGEPAGE_FILE_LEN];
     mode_t f_umask;
 
-    /*
-     * for every mapped huge page there will be a separate file descriptor
-     * created from a temporary file, we should NOT close fd explicitly, it
-     * will be reclaimed by the OS when the process gets terminated, and
-     * meanwhile the huge page binding to the fd will be released, this could
-     * guarantee the memory cleanup order between user buffers and ETR.
-     */
     snprintf(hpg_fname, sizeof(HUGEPAGE_FILE_DIR), "%s", HUGEPAGE_FILE_DIR);
     f_umask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
-    hpg_fd = qae_mkstemp(hpg_fname);
+    *hpg_fd = qae_mkstemp(hpg_fname);
     umask(f_umask);
 
-    if (hpg_fd < 0)
+    if (*hpg_fd < 0)
     {
         CMD_ERROR("%s:%d mkstemp(%s) for hpg_fd failed with errno: %d\n",
                   __func__,
@@ -155,8 +178,9 @@ void *__qae_hugepage_mmap_phy_addr(const size_t len)
     addr = qae_mmap(NULL,
                     len,
                     PROT_READ | PROT_WRITE,
-                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_HUGETLB,
-                    hpg_fd,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_HUGETLB |
+                        flags,
+                    *hpg_fd,
                     0);
 
     if (MAP_FAILED == addr)
@@ -166,18 +190,39 @@ void *__qae_hugepage_mmap_phy_addr(const size_t len)
                   __LINE__,
                   hpg_fname,
                   errno);
-        close(hpg_fd);
+        close(*hpg_fd);
+        *hpg_fd = -1;
         return NULL;
     }
 
+    return addr;
+}
+
+API_LOCAL
+void *__qae_hugepage_mmap_phy_addr(const size_t len)
+{
+    void *addr = NULL;
+    int ret = 0;
+    int hpg_fd;
+
+    /*
+     * for every mapped huge page there will be a separate file descriptor
+     * created from a temporary file, we should NOT close fd explicitly, it
+     * will be reclaimed by the OS when the process gets terminated, and
+     * meanwhile the huge page binding to the fd will be released, this could
+     * guarantee the memory cleanup order between user buffers and ETR.
+     */
+    addr = hugepage_mmap_file(len, 0, &hpg_fd);
+    if (NULL == addr)
+        return NULL;
+
     ret = qae_madvise(addr, len, MADV_DONTFORK);
     if (0 != ret)
     {
         munmap(addr, len);
-        CMD_ERROR("%s:%d qae_madvise(%s) for hpg_fd failed with errno:%d\n",
+        CMD_ERROR("%s:%d qae_madvise for hpg_fd failed with errno:%d\n",
                   __func__,
                   __LINE__,
-                  hpg_fname,
                   errno);
         close(hpg_fd);
         return NULL;
@@ -187,14 +232,262 @@ void *__qae_hugepage_mmap_phy_addr(const size_t len)
     return addr;
 }
 
+static hugepage_region_t *hugepage_find_region(const void *virt_addr)
+{
+    size_t i;
+
+    for (i = 0; i < HUGEPAGE_1G_MAX_REGIONS; i++)
+    {
+        hugepage_region_t *region = &g_hpg_regions[i];
+
+        if (region->virt_addr &&
+            (uintptr_t)virt_addr - (uintptr_t)region->virt_addr <
+                HUGEPAGE_1G_SIZE)
+            return region;
+    }
+    return NULL;
+}
+
+static inline bool region_slab_used(const hugepage_region_t *region,
+                                    const size_t index)
+{
+    return region->bitmap[index / QWORD_WIDTH] &
+           (1ULL << (index % QWORD_WIDTH));
+}
+
+static void region_mark(hugepage_region_t *region,
+                        const size_t first,
+                        const size_t count,
+                        const bool used)
+{
+    size_t i;
+
+    for (i = first; i < first + count; i++)
+    {
+        if (used)
+            region->bitmap[i / QWORD_WIDTH] |= 1ULL << (i % QWORD_WIDTH);
+        else
+            region->bitmap[i / QWORD_WIDTH] &= ~(1ULL << (i % QWORD_WIDTH));
+    }
+    if (used)
+        region->used += count;
+    else
+        region->used -= count;
+}
+
+/*
+ * Find a run of free slabs starting on a multiple of step.
+ * Returns the index of the first slab or -1.
+ */
+static long region_find_run(const hugepage_region_t *region,
+                            const size_t count,
+                            const size_t step)
+{
+    size_t first;
+    size_t i;
+
+    if (HUGEPAGE_1G_SLABS - region->used < count)
+        return -1;
+
+    for (first = 0; first + count <= HUGEPAGE_1G_SLABS; first += step)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (region_slab_used(region, first + i))
+                break;
+        }
+        if (i == count)
+            return first;
+    }
+    return -1;
+}
+
+static hugepage_region_t *hugepage_map_region(const int fd, const int node)
+{
+    hugepage_region_t *region = NULL;
+    void *addr = NULL;
+    int hpg_fd = -1;
+    size_t i;
+
+    if (g_num_hugepages < HUGEPAGE_1G_SLABS)
+        return NULL;
+
+    for (i = 0; i < HUGEPAGE_1G_MAX_REGIONS && NULL == region; i++)
+    {
+        if (NULL == g_hpg_regions[i].virt_addr)
+            region = &g_hpg_regions[i];
+    }
+    if (NULL == region)
+        return NULL;
+
+    /* Bound to a hugetlbfs file like the 2M slabs, so the rings carved
+     * from the region are released in the same order at exit */
+    addr = hugepage_mmap_file(HUGEPAGE_1G_SIZE, MAP_HUGE_1GB, &hpg_fd);
+    if (NULL == addr)
+    {
+        /* No 1G pages are reserved, keep to 2M pages from now on */
+        CMD_DEBUG("%s:%d 1G huge page not available\n", __func__, __LINE__);
+        g_hugepages_1g_enabled = false;
+        return NULL;
+    }
+
+    if (qae_madvise(addr, HUGEPAGE_1G_SIZE, MADV_DONTFORK))
+    {
+        CMD_ERROR("%s:%d qae_madvise for 1G huge page failed with errno:%d\n",
+                  __func__,
+                  __LINE__,
+                  errno);
+        munmap(addr, HUGEPAGE_1G_SIZE);
+        close(hpg_fd);
+        return NULL;
+    }
+
+    region->phy_addr = __qae_hugepage_virt2phy(fd, addr, HUGEPAGE_1G_SIZE);
+    if (!region->phy_addr)
+    {
+        /* The memory driver only maps 2M pages */
+        CMD_ERROR("%s:%d virt2phy on 1G huge page failed\n",
+                  __func__,
+                  __LINE__);
+        munmap(addr, HUGEPAGE_1G_SIZE);
+        close(hpg_fd);
+        g_hugepages_1g_enabled = false;
+        return NULL;
+    }
+    region->virt_addr = addr;
+    region->hpg_fd = hpg_fd;
+    region->node = node;
+    region->used = 0;
+    memset(region->bitmap, 0, sizeof(region->bitmap));
+    g_num_hugepages -= HUGEPAGE_1G_SLABS;
+
+    return region;
+}
+
+static void hugepage_unmap_region(const int fd, hugepage_region_t *region)
+{
+    dev_mem_info_t memInfo = {0};
+
+    memInfo.phy_addr = region->phy_addr;
+    memInfo.size = HUGEPAGE_1G_SIZE;
+    __qae_hugepage_iommu_unmap(fd, &memInfo);
+    munmap(region->virt_addr, HUGEPAGE_1G_SIZE);
+    close(region->hpg_fd);
+    g_num_hugepages += HUGEPAGE_1G_SLABS;
+    memset(region, 0, sizeof(*region));
+}
+
+static dev_mem_info_t *hugepage_region_alloc_slab(const int fd,
+                                                  const size_t size,
+                                                  const size_t alignment,
+                                                  const int node,
+                                                  enum slabType type)
+{
+    const size_t count = (size + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE;
+    const size_t step =
+        alignment > HUGEPAGE_SIZE ? alignment / HUGEPAGE_SIZE : 1;
+    hugepage_region_t *region = NULL;
+    dev_mem_info_t *slab = NULL;
+    long first = -1;
+    size_t i;
+
+    for (i = 0; i < HUGEPAGE_1G_MAX_REGIONS && first < 0; i++)
+    {
+        region = &g_hpg_regions[i];
+        if (region->virt_addr && node == region->node)
+            first = region_find_run(region, count, step);
+    }
+    if (first < 0)
+    {
+        region = hugepage_map_region(fd, node);
+        if (NULL == region)
+            return NULL;
+        first = region_find_run(region, count, step);
+        if (first < 0)
+        {
+            hugepage_unmap_region(fd, region);
+            return NULL;
+        }
+    }
+
+    if (LARGE == type)
+    {
+        /* The control block of a large slab lives outside of it */
+        slab = qae_mmap(NULL,
+                        getpagesize(),
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1,
+                        0);
+        if (MAP_FAILED == slab)
+        {
+            CMD_ERROR("%s:%d mmap of large slab control block failed\n",
+                      __func__,
+                      __LINE__);
+            if (!region->used)
+                hugepage_unmap_region(fd, region);
+            return NULL;
+        }
+    }
+    else
+    {
+        slab = (dev_mem_info_t *)((uint8_t *)region->virt_addr +
+                                  first * HUGEPAGE_SIZE);
+    }
+
+    region_mark(region, first, count, true);
+    slab->nodeId = node;
+    slab->size = count * HUGEPAGE_SIZE;
+    slab->type = type;
+    slab->hpg_fd = -1;
+    slab->virt_addr = (uint8_t *)region->virt_addr + first * HUGEPAGE_SIZE;
+    slab->phy_addr = region->phy_addr + first * HUGEPAGE_SIZE;
+
+    return slab;
+}
+
+API_LOCAL
+int __qae_hugepage_in_region(const void *virt_addr)
+{
+    return NULL != hugepage_find_region(virt_addr);
+}
+
+API_LOCAL
+void __qae_hugepage_region_free_slab(const int fd,
+                                     const dev_mem_info_t *memInfo)
+{
+    hugepage_region_t *region = hugepage_find_region(memInfo->virt_addr);
+    size_t first;
+
+    if (NULL == region)
+        return;
+
+    first = ((uintptr_t)memInfo->virt_addr - (uintptr_t)region->virt_addr) /
+            HUGEPAGE_SIZE;
+    region_mark(region, first, memInfo->size / HUGEPAGE_SIZE, false);
+    if (!region->used)
+        hugepage_unmap_region(fd, region);
+}
+
 API_LOCAL
 dev_mem_info_t *__qae_hugepage_alloc_slab(const int fd,
                                           const size_t size,
+                                          const size_t alignment,
                                           const int node,
                                           enum slabType type)
 {
     dev_mem_info_t *slab = NULL;
 
+    if (g_hugepages_1g_enabled)
+    {
+        slab = hugepage_region_alloc_slab(fd, size, alignment, node, type);
+        if (slab)
+            return slab;
+    }
+    /* 2M huge pages can not back slabs larger than a page */
+    if (LARGE == type)
+        return NULL;
+
     if (!g_num_hugepages)
     {
         CMD_ERROR("%s:%d mmap: exceeded max huge pages allocations for this "
@@ -280,6 +573,9 @@ int __qae_init_hugepages(const int fd)
         g_num_hugepages = 0;
         ret = -EIO;
     }
+    /* 1G pages of a parent process are not inherited */
+    memset(g_hpg_regions, 0, sizeof(g_hpg_regions));
+    g_hugepages_1g_enabled = false;
     if (g_num_hugepages > 0)
     {
         __qae_set_free_page_table_fptr(free_page_table_hpg);
@@ -287,6 +583,11 @@ int __qae_init_hugepages(const int fd)
         __qae_set_loadkey_fptr(load_key_hpg);
 
         g_hugepages_enabled = true;
+#ifndef ICP_THREAD_SPECIFIC_USDM
+        /* Regions are shared by all threads, so they are only used by
+         * the allocator serialised by the global mutex */
+        g_hugepages_1g_enabled = g_num_hugepages >= HUGEPAGE_1G_SLABS;
+#endif
     }
     else
     {
@@ -307,3 +608,9 @@ int __qae_hugepage_enabled()
 {
     return g_hugepages_enabled;
 }
+
+API_LOCAL
+int __qae_hugepage_1g_enabled()
+{
+    return g_hugepages_1g_enabled;
+}
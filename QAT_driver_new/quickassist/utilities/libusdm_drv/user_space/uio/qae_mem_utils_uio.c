@@ -77,6 +77,7 @@
 #else
 #include "qae_mem_lib_utils.h"
 #endif
+#include "qae_mem_stats.h"
 /**************************************************************************
                                    macro
 **************************************************************************/
@@ -128,7 +129,14 @@ static inline void ioctl_free_slab(const int fd, dev_mem_info_t *memInfo)
 API_LOCAL
 void __qae_finish_free_slab(const int fd, dev_mem_info_t *slab)
 {
-    if (HUGE_PAGE == slab->type)
+    __qae_v2p_invalidate();
+    __qae_stats_slab(slab->size, false);
+
+    if (__qae_hugepage_in_region(slab->virt_addr))
+    {
+        __qae_hugepage_region_free_slab(fd, slab);
+    }
+    else if (HUGE_PAGE == slab->type)
     {
         __qae_hugepage_free_slab(slab);
         __qae_hugepage_iommu_unmap(fd, slab);
@@ -213,6 +221,8 @@ static inline int qaeOpenFd(void)
 
         if (__qae_init_hugepages(g_fd))
             return -EIO;
+        /* Cached translations may have the wrong page size */
+        __qae_v2p_invalidate();
     }
     return 0;
 }
@@ -372,9 +382,9 @@ dev_mem_info_t *__qae_alloc_slab(const int fd,
 {
     dev_mem_info_t *slab = NULL;
 
-    if (HUGE_PAGE == type)
+    if (HUGE_PAGE == type || (LARGE == type && __qae_hugepage_enabled()))
     {
-        slab = __qae_hugepage_alloc_slab(fd, size, node, type);
+        slab = __qae_hugepage_alloc_slab(fd, size, alignment, node, type);
     }
     else
     {
@@ -383,7 +393,10 @@ dev_mem_info_t *__qae_alloc_slab(const int fd,
 
     /* Store a slab into the hash table for a fast lookup. */
     if (slab)
+    {
         add_slab_to_hash(slab);
+        __qae_stats_slab(slab->size, true);
+    }
 
     return slab;
 }
@@ -483,9 +496,9 @@ dev_mem_info_t *__qae_alloc_slab(const int fd,
 {
     dev_mem_info_t *slab = NULL;
 
-    if (HUGE_PAGE == type)
+    if (HUGE_PAGE == type || (LARGE == type && __qae_hugepage_enabled()))
     {
-        slab = __qae_hugepage_alloc_slab(fd, size, node, type);
+        slab = __qae_hugepage_alloc_slab(fd, size, alignment, node, type);
     }
     else
     {
@@ -494,7 +507,10 @@ dev_mem_info_t *__qae_alloc_slab(const int fd,
 
     /* Store a slab into the hash table for a fast lookup. */
     if (slab)
+    {
         add_slab_to_hash(slab, tls_ptr);
+        __qae_stats_slab(slab->size, true);
+    }
 
     return slab;
 }